@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gstnvarguscamera_ring.h"
+
+#include <chrono>
+
+NvArgusBufferRing *
+NvArgusBufferRing::create (unsigned int count, const NvArgusBufferRingOps &ops)
+{
+  NvArgusBufferRing *ring = new NvArgusBufferRing (ops);
+
+  ring->m_slots.resize (count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    Slot &slot = ring->m_slots[i];
+
+    slot.ring = ring;
+    slot.index = i;
+    slot.fd = -1;
+    slot.state = SLOT_FREE;
+    slot.surface = ops.alloc (ops.user_data, i, &slot.fd);
+    if (!slot.surface)
+    {
+      delete ring;
+      return NULL;
+    }
+    ring->m_free.push_back (i);
+  }
+
+  return ring;
+}
+
+NvArgusBufferRing::NvArgusBufferRing (const NvArgusBufferRingOps &ops)
+  : m_ops (ops)
+  , m_outstanding (0)
+  , m_lent (0)
+  , m_shutdown (false)
+{
+  m_stats.lent = 0;
+  m_stats.returned = 0;
+  m_stats.stalls = 0;
+  m_stats.stallTimeUs = 0;
+  m_stats.maxLent = 0;
+}
+
+NvArgusBufferRing::~NvArgusBufferRing ()
+{
+  for (size_t i = 0; i < m_slots.size (); i++)
+  {
+    if (m_slots[i].surface)
+      m_ops.free (m_slots[i].surface);
+  }
+}
+
+int
+NvArgusBufferRing::acquire (uint64_t timeoutUs)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  const std::chrono::steady_clock::time_point deadline = start +
+      std::chrono::microseconds (timeoutUs);
+  bool waited = false;
+
+  while (m_free.empty () && !m_shutdown)
+  {
+    waited = true;
+    if (m_cond.wait_until (lock, deadline) == std::cv_status::timeout)
+      break;
+  }
+
+  if (waited)
+  {
+    m_stats.stalls++;
+    m_stats.stallTimeUs += std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now () - start).count ();
+  }
+  if (m_free.empty () || m_shutdown)
+    return -1;
+
+  int index = m_free.back ();
+  m_free.pop_back ();
+  m_slots[index].state = SLOT_PRODUCING;
+  m_outstanding++;
+
+  return index;
+}
+
+bool
+NvArgusBufferRing::recycle (Slot *slot, SlotState expected)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  if (slot->state != expected)
+    return false;
+
+  if (expected == SLOT_LENT)
+  {
+    m_lent--;
+    m_stats.returned++;
+  }
+  slot->state = SLOT_FREE;
+  m_free.push_back (slot->index);
+  m_outstanding--;
+  m_cond.notify_one ();
+
+  return m_shutdown && m_outstanding == 0;
+}
+
+void
+NvArgusBufferRing::cancel (int index)
+{
+  if (recycle (&m_slots[index], SLOT_PRODUCING))
+    delete this;
+}
+
+void *
+NvArgusBufferRing::lend (int index)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Slot &slot = m_slots[index];
+
+  if (slot.state != SLOT_PRODUCING)
+    return NULL;
+
+  slot.state = SLOT_LENT;
+  m_lent++;
+  m_stats.lent++;
+  if (m_lent > m_stats.maxLent)
+    m_stats.maxLent = m_lent;
+
+  return &slot;
+}
+
+void
+NvArgusBufferRing::release (void *releaseData)
+{
+  Slot *slot = (Slot *) releaseData;
+  NvArgusBufferRing *ring = slot->ring;
+
+  if (ring->recycle (slot, SLOT_LENT))
+    delete ring;
+}
+
+void
+NvArgusBufferRing::shutdown ()
+{
+  bool destroy;
+
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_shutdown = true;
+    m_cond.notify_all ();
+    destroy = (m_outstanding == 0);
+  }
+
+  if (destroy)
+    delete this;
+}
+
+void *
+NvArgusBufferRing::getSurface (int index) const
+{
+  return m_slots[index].surface;
+}
+
+int
+NvArgusBufferRing::getFd (int index) const
+{
+  return m_slots[index].fd;
+}
+
+unsigned int
+NvArgusBufferRing::getCount () const
+{
+  return m_slots.size ();
+}
+
+NvArgusBufferRingStats
+NvArgusBufferRing::getStats ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  return m_stats;
+}
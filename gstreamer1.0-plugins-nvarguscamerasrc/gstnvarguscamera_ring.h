@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSTNVARGUSCAMERA_RING_H_
+#define GSTNVARGUSCAMERA_RING_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ * Allocates and frees the surfaces of an NvArgusBufferRing.
+ *
+ * The element backs the surfaces with NvBufSurface; anything with a dmabuf
+ * style fd can be used, which lets the ring be exercised without a camera.
+ */
+typedef struct NvArgusBufferRingOps
+{
+  /** Allocates surface 'index' and returns it, with its fd in *fd. NULL on failure. */
+  void *(*alloc) (void *user_data, unsigned int index, int *fd);
+  /** Frees a surface. Can run after the element is gone, so it gets no user data. */
+  void (*free) (void *surface);
+  /** Passed to alloc. */
+  void *user_data;
+} NvArgusBufferRingOps;
+
+/**
+ * Counters of an NvArgusBufferRing.
+ */
+typedef struct NvArgusBufferRingStats
+{
+  /** Surfaces handed downstream. */
+  uint64_t lent;
+  /** Lent surfaces that downstream has released. */
+  uint64_t returned;
+  /** acquire() calls that had to wait for downstream to release a surface. */
+  uint64_t stalls;
+  /** Time spent in those waits, in microseconds. */
+  uint64_t stallTimeUs;
+  /** Largest number of surfaces held downstream at once. */
+  unsigned int maxLent;
+} NvArgusBufferRingStats;
+
+/**
+ * Fixed set of surfaces that the Argus consumer thread fills and lends
+ * downstream in passthrough mode.
+ *
+ * The producer acquire()s a free surface, fills it and lend()s it; the data
+ * returned by lend() is given to the GstBuffer wrapping the surface, whose
+ * destroy notify is release(). A surface is reused only once downstream has
+ * released it, so the ring is what paces the producer.
+ *
+ * shutdown() gives up the element's reference. The ring, and its surfaces,
+ * are freed when the last lent surface comes back, which may be after the
+ * element has stopped.
+ */
+class NvArgusBufferRing
+{
+public:
+  /**
+   * Allocates a ring of 'count' surfaces. Returns NULL if an allocation fails.
+   */
+  static NvArgusBufferRing *create (unsigned int count, const NvArgusBufferRingOps &ops);
+
+  /**
+   * Takes a free surface for the producer, waiting up to 'timeoutUs' for
+   * downstream to release one. Returns its index, or -1 on timeout or
+   * after shutdown().
+   */
+  int acquire (uint64_t timeoutUs);
+
+  /**
+   * Returns an acquired surface that could not be filled.
+   */
+  void cancel (int index);
+
+  /**
+   * Marks an acquired surface as held downstream.
+   *
+   * @return Data for release() once the buffer wrapping the surface is freed.
+   */
+  void *lend (int index);
+
+  /**
+   * Returns a lent surface to the ring. Matches GDestroyNotify.
+   */
+  static void release (void *releaseData);
+
+  /**
+   * Wakes the producer and drops the element's reference. The ring must not
+   * be used by the element afterwards.
+   */
+  void shutdown ();
+
+  void *getSurface (int index) const;
+  int getFd (int index) const;
+  unsigned int getCount () const;
+  NvArgusBufferRingStats getStats ();
+
+private:
+  enum SlotState
+  {
+    SLOT_FREE,
+    SLOT_PRODUCING,
+    SLOT_LENT,
+  };
+
+  struct Slot
+  {
+    NvArgusBufferRing *ring;
+    int index;
+    void *surface;
+    int fd;
+    SlotState state;
+  };
+
+  explicit NvArgusBufferRing (const NvArgusBufferRingOps &ops);
+  ~NvArgusBufferRing ();
+
+  /** Puts a slot back on the free list; true if the ring must now be deleted. */
+  bool recycle (Slot *slot, SlotState expected);
+
+  NvArgusBufferRingOps m_ops;
+  std::vector<Slot> m_slots;
+  std::vector<int> m_free;
+  unsigned int m_outstanding;   ///< slots acquired or lent
+  unsigned int m_lent;
+  bool m_shutdown;
+  NvArgusBufferRingStats m_stats;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+};
+
+#endif /* GSTNVARGUSCAMERA_RING_H_ */
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gstnvarguscamera_streams.h"
+
+#include <math.h>
+#include <string.h>
+
+NvArgusStreamSet::NvArgusStreamSet (unsigned int maxStreams)
+  : m_maxStreams (maxStreams)
+  , m_nextId (0)
+  , m_started (false)
+{
+}
+
+NvArgusStreamSet::~NvArgusStreamSet ()
+{
+}
+
+NvArgusStreamSet::Stream *
+NvArgusStreamSet::find (int id)
+{
+  for (size_t i = 0; i < m_streams.size (); i++)
+  {
+    if (m_streams[i].id == id)
+      return &m_streams[i];
+  }
+  return NULL;
+}
+
+int
+NvArgusStreamSet::addStream ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream stream;
+
+  if (m_started || m_streams.size () >= m_maxStreams)
+    return -1;
+
+  memset (&stream, 0, sizeof (stream));
+  stream.id = m_nextId++;
+  stream.decimation = 1;
+  m_streams.push_back (stream);
+
+  return stream.id;
+}
+
+bool
+NvArgusStreamSet::removeStream (int id)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  if (m_started)
+    return false;
+
+  for (size_t i = 0; i < m_streams.size (); i++)
+  {
+    if (m_streams[i].id == id)
+    {
+      m_streams.erase (m_streams.begin () + i);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+NvArgusStreamSet::configure (int id, unsigned int width, unsigned int height,
+    int fps_n, int fps_d)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream *stream = find (id);
+
+  if (m_started || !stream || width == 0 || height == 0 || fps_n < 0 || fps_d <= 0)
+    return false;
+
+  stream->configured = true;
+  stream->width = width;
+  stream->height = height;
+  stream->fps_n = fps_n;
+  stream->fps_d = fps_d;
+
+  return true;
+}
+
+void
+NvArgusStreamSet::unconfigure ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  if (m_started)
+    return;
+
+  for (size_t i = 0; i < m_streams.size (); i++)
+    m_streams[i].configured = false;
+}
+
+bool
+NvArgusStreamSet::isConfigured ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  for (size_t i = 0; i < m_streams.size (); i++)
+  {
+    if (!m_streams[i].configured)
+      return false;
+  }
+  return true;
+}
+
+bool
+NvArgusStreamSet::start (NvArgusStreamProvider *provider, int fps_n, int fps_d)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  const double sensorFps = (fps_n > 0 && fps_d > 0) ? (double) fps_n / fps_d : 0.0;
+  bool ok = true;
+
+  if (m_started)
+    return false;
+
+  for (size_t i = 0; ok && i < m_streams.size (); i++)
+  {
+    Stream &stream = m_streams[i];
+
+    memset (&stream.stats, 0, sizeof (stream.stats));
+    stream.stream = NULL;
+    if (!stream.configured)
+      continue;
+
+    stream.decimation = 1;
+    if (sensorFps > 0.0 && stream.fps_n > 0)
+    {
+      const double ratio = sensorFps * stream.fps_d / stream.fps_n;
+      stream.decimation = ratio > 1.0 ? (unsigned int) lround (ratio) : 1;
+    }
+
+    stream.stream = provider->createStream (stream.width, stream.height);
+    if (!stream.stream)
+      ok = false;
+    else if (!provider->enableStream (stream.stream))
+    {
+      provider->destroyStream (stream.stream);
+      stream.stream = NULL;
+      ok = false;
+    }
+  }
+
+  if (!ok)
+  {
+    for (size_t i = 0; i < m_streams.size (); i++)
+    {
+      if (m_streams[i].stream)
+      {
+        provider->destroyStream (m_streams[i].stream);
+        m_streams[i].stream = NULL;
+      }
+    }
+    return false;
+  }
+
+  m_started = true;
+  return true;
+}
+
+void
+NvArgusStreamSet::stop (NvArgusStreamProvider *provider)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  for (size_t i = 0; i < m_streams.size (); i++)
+  {
+    if (m_streams[i].stream && provider)
+      provider->destroyStream (m_streams[i].stream);
+    m_streams[i].stream = NULL;
+  }
+  m_started = false;
+}
+
+std::vector<int>
+NvArgusStreamSet::getStartedIds ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  std::vector<int> ids;
+
+  for (size_t i = 0; i < m_streams.size (); i++)
+  {
+    if (m_streams[i].stream)
+      ids.push_back (m_streams[i].id);
+  }
+  return ids;
+}
+
+void *
+NvArgusStreamSet::getStream (int id)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream *stream = find (id);
+
+  return stream ? stream->stream : NULL;
+}
+
+unsigned int
+NvArgusStreamSet::getDecimation (int id)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream *stream = find (id);
+
+  return stream ? stream->decimation : 1;
+}
+
+bool
+NvArgusStreamSet::onFrame (int id)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream *stream = find (id);
+
+  if (!stream)
+    return false;
+
+  /* The first frame is delivered, then one in every 'decimation' */
+  if (stream->stats.captured++ % stream->decimation != 0)
+  {
+    stream->stats.decimated++;
+    return false;
+  }
+  stream->stats.delivered++;
+  return true;
+}
+
+void
+NvArgusStreamSet::onDrop (int id)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream *stream = find (id);
+
+  if (stream)
+  {
+    stream->stats.delivered--;
+    stream->stats.dropped++;
+  }
+}
+
+NvArgusStreamStats
+NvArgusStreamSet::getStats (int id)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  Stream *stream = find (id);
+  NvArgusStreamStats stats;
+
+  memset (&stats, 0, sizeof (stats));
+  if (stream)
+    stats = stream->stats;
+  return stats;
+}
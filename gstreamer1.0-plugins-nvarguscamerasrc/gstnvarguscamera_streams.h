@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GSTNVARGUSCAMERA_STREAMS_H_
+#define GSTNVARGUSCAMERA_STREAMS_H_
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+/**
+ * Creates the Argus output streams behind NvArgusStreamSet.
+ *
+ * The element implements it over its CaptureSession and Request; a fake
+ * provider lets the stream set be exercised without a camera.
+ */
+class NvArgusStreamProvider
+{
+public:
+  virtual ~NvArgusStreamProvider () {}
+
+  /** Creates an output stream of the session. Returns NULL on failure. */
+  virtual void *createStream (unsigned int width, unsigned int height) = 0;
+  /** Enables a stream in the capture request shared by all the streams. */
+  virtual bool enableStream (void *stream) = 0;
+  /** Disables a stream in the request and destroys it. */
+  virtual void destroyStream (void *stream) = 0;
+};
+
+/**
+ * Counters of one stream of an NvArgusStreamSet.
+ */
+typedef struct NvArgusStreamStats
+{
+  /** Frames acquired from the output stream. */
+  uint64_t captured;
+  /** Frames delivered to the pad. */
+  uint64_t delivered;
+  /** Frames skipped to reach the pad frame rate. */
+  uint64_t decimated;
+  /** Frames dropped because downstream held every buffer of the pad. */
+  uint64_t dropped;
+} NvArgusStreamStats;
+
+/**
+ * Output streams of the nvarguscamerasrc request pads.
+ *
+ * Each request pad adds a stream, configured with the caps negotiated on
+ * the pad. start() creates an Argus output stream per configured pad and
+ * enables it in the request that also feeds the always pad, so the ISP
+ * writes every resolution from one capture. A pad negotiated at a lower
+ * frame rate than the sensor gets every Nth frame of its stream.
+ *
+ * Pads can be added, removed and configured only while the set is stopped.
+ */
+class NvArgusStreamSet
+{
+public:
+  explicit NvArgusStreamSet (unsigned int maxStreams);
+  ~NvArgusStreamSet ();
+
+  /**
+   * Adds a stream. Returns its id, or -1 if the set is full or started.
+   */
+  int addStream ();
+
+  /**
+   * Removes a stream. Returns false if the set is started.
+   */
+  bool removeStream (int id);
+
+  /**
+   * Sets the resolution and frame rate negotiated on the pad of a stream.
+   * fps_n == 0 means the pad takes every frame.
+   */
+  bool configure (int id, unsigned int width, unsigned int height, int fps_n, int fps_d);
+
+  /** Forgets the negotiated configurations, for the next negotiation. */
+  void unconfigure ();
+
+  /** True if every stream of the set has been configured. */
+  bool isConfigured ();
+
+  /**
+   * Creates and enables the output streams of the configured pads, for a
+   * sensor running at fps_n/fps_d. On failure, the streams created so far
+   * are destroyed.
+   */
+  bool start (NvArgusStreamProvider *provider, int fps_n, int fps_d);
+
+  /**
+   * Destroys the output streams. A NULL provider only forgets them, for
+   * when the session that owned them is already gone.
+   */
+  void stop (NvArgusStreamProvider *provider);
+
+  /** Ids of the streams that have an output stream, in the order created. */
+  std::vector<int> getStartedIds ();
+
+  /** Output stream of a started stream, NULL otherwise. */
+  void *getStream (int id);
+
+  /** Capture frames per delivered frame of a started stream. */
+  unsigned int getDecimation (int id);
+
+  /**
+   * Counts a frame acquired from the stream. Returns true if it must be
+   * delivered to the pad, false if decimation skips it.
+   */
+  bool onFrame (int id);
+
+  /** Counts a frame that could not be delivered. */
+  void onDrop (int id);
+
+  NvArgusStreamStats getStats (int id);
+
+private:
+  struct Stream
+  {
+    int id;
+    bool configured;
+    unsigned int width;
+    unsigned int height;
+    int fps_n;
+    int fps_d;
+    void *stream;
+    unsigned int decimation;
+    NvArgusStreamStats stats;
+  };
+
+  Stream *find (int id);
+
+  unsigned int m_maxStreams;
+  int m_nextId;
+  bool m_started;
+  std::vector<Stream> m_streams;
+  std::mutex m_mutex;
+};
+
+#endif /* GSTNVARGUSCAMERA_STREAMS_H_ */
@@ -33,6 +33,15 @@
  * nvarguscamerasrc !
  * "video/x-raw(memory:NVMM), width=640, height=480, format=NV12, framerate=30/1" !
  * nvoverlaysink -e -v
+ *
+ * A request pad adds an output stream of its own size and rate:
+ *
+ * gst-launch-1.0
+ * nvarguscamerasrc name=cam
+ * cam.src ! "video/x-raw(memory:NVMM), width=1920, height=1080, framerate=30/1" !
+ * nvv4l2h264enc ! h264parse ! matroskamux ! filesink location=out.mkv
+ * cam.aux_src_0 ! "video/x-raw(memory:NVMM), width=640, height=480, framerate=10/1" !
+ * nvoverlaysink -e
  */
 
 #ifdef HAVE_CONFIG_H
@@ -49,6 +58,7 @@
 #include <EGLStream/NV/ImageNativeBuffer.h>
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <math.h>
 
 #include <pthread.h>
@@ -83,6 +93,7 @@ static const int DEFAULT_FPS        = 30;
 static const uint64_t TIMEOUT_FIVE_SECONDS  = 50000000000;
 static const uint64_t WAIT_FOR_EVENT_TIMEOUT = 5000000000;
 static const uint64_t ACQUIRE_FRAME_TIMEOUT = 50000000000;
+static const uint64_t AUX_ACQUIRE_FRAME_TIMEOUT = 100000000;
 
 #ifdef __cplusplus
 extern "C"
@@ -295,6 +306,100 @@ private:
   UniqueObj<FrameConsumer> m_consumer;
 };
 
+/* Feeds a request pad. Frames are acquired as soon as they are produced,
+ * so a slow pad never holds back the request shared with the other pads. */
+class AuxStreamConsumer : public ArgusSamples::ThreadArgus
+{
+public:
+  explicit AuxStreamConsumer(OutputStream* stream, GstNvArgusAuxPad *aux) :
+      m_stream(stream),
+      m_aux(aux),
+      m_connected(false)
+  {
+  }
+  ~AuxStreamConsumer()
+  {
+  }
+
+private:
+  /** @name Thread methods */
+  /**@{*/
+  virtual bool threadInitialize(GstNvArgusCameraSrc *);
+  virtual bool threadExecute(GstNvArgusCameraSrc *);
+  virtual bool threadShutdown(GstNvArgusCameraSrc *);
+  /**@}*/
+
+  OutputStream* m_stream;
+  GstNvArgusAuxPad *m_aux;
+  bool m_connected;
+  UniqueObj<FrameConsumer> m_consumer;
+};
+
+/* Creates the output streams of the request pads in the capture session of
+ * the always pad, and enables them in its request. */
+class ArgusStreamProvider : public NvArgusStreamProvider
+{
+public:
+  ArgusStreamProvider(ICaptureSession *session, IRequest *request) :
+      m_session(session),
+      m_request(request)
+  {
+  }
+
+  virtual void *createStream(unsigned int width, unsigned int height)
+  {
+    UniqueObj<OutputStreamSettings> settings(
+        m_session->createOutputStreamSettings(STREAM_TYPE_EGL));
+    IEGLOutputStreamSettings *iSettings = interface_cast<IEGLOutputStreamSettings>(settings);
+    if (!iSettings)
+      return NULL;
+
+    iSettings->setPixelFormat(PIXEL_FMT_YCbCr_420_888);
+    iSettings->setResolution(Size2D<uint32_t>(width, height));
+    return m_session->createOutputStream(settings.get());
+  }
+
+  virtual bool enableStream(void *stream)
+  {
+    return m_request->enableOutputStream(static_cast<OutputStream*>(stream)) == STATUS_OK;
+  }
+
+  virtual void destroyStream(void *stream)
+  {
+    m_request->disableOutputStream(static_cast<OutputStream*>(stream));
+    static_cast<OutputStream*>(stream)->destroy();
+  }
+
+private:
+  ICaptureSession *m_session;
+  IRequest *m_request;
+};
+
+/* Stops the consumers of the request pads and then their output streams
+ * when execute() returns, including on its error paths. */
+class AuxStreamsGuard
+{
+public:
+  AuxStreamsGuard(NvArgusStreamSet *streams, NvArgusStreamProvider *provider,
+                  vector< unique_ptr<AuxStreamConsumer> > &consumers) :
+      m_streams(streams),
+      m_provider(provider),
+      m_consumers(consumers)
+  {
+  }
+  ~AuxStreamsGuard()
+  {
+    // The consumers are joined before the streams they read are destroyed.
+    m_consumers.clear();
+    m_streams->stop(m_provider);
+  }
+
+private:
+  NvArgusStreamSet *m_streams;
+  NvArgusStreamProvider *m_provider;
+  vector< unique_ptr<AuxStreamConsumer> > &m_consumers;
+};
+
 const char* getStatusString(Argus::Status status)
 {
     switch (status)
@@ -650,7 +755,25 @@ bool StreamConsumer::threadExecute(GstNvArgusCameraSrc *src)
       if (!iNativeBuffer)
         ORIGINATE_ERROR("IImageNativeBuffer not supported by Image.");
 
-      if (src->frameInfo->fd < 0)
+      gint slot = -1;
+      if (src->ring)
+      {
+        // Passthrough: fill a ring surface, which goes downstream without a transform.
+        while (slot < 0 && !src->stop_requested && !src->timeout_complete)
+          slot = src->ring->acquire(G_USEC_PER_SEC);
+        if (slot < 0)
+        {
+          CONSUMER_PRINT("Leaving main loop at no passthrough buffer returned\n\n");
+          break;
+        }
+        if (iNativeBuffer->copyToNvBuffer(src->ring->getFd(slot)) != STATUS_OK)
+        {
+          src->ring->cancel(slot);
+          src->argus_in_error = TRUE;
+          ORIGINATE_ERROR("IImageNativeBuffer not supported by Image.");
+        }
+      }
+      else if (src->frameInfo->fd < 0)
       {
         src->frameInfo->fd = iNativeBuffer->createNvBuffer(streamSize,
                 NVBUF_COLOR_FORMAT_YUV420,
@@ -680,6 +803,20 @@ bool StreamConsumer::threadExecute(GstNvArgusCameraSrc *src)
                    static_cast<unsigned long long>(millisec_timestamp));
       }
 
+      if (src->ring)
+      {
+        // The surface returns to the ring when downstream frees the buffer.
+        GstBuffer *buffer = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_NO_SHARE,
+            src->ring->getSurface(slot), sizeof(NvBufSurface), 0, sizeof(NvBufSurface),
+            src->ring->lend(slot), NvArgusBufferRing::release);
+
+        g_mutex_lock (&src->nvmm_buffers_queue_lock);
+        g_queue_push_tail (src->nvmm_buffers, buffer);
+        g_cond_signal (&src->nvmm_buffers_queue_cond);
+        g_mutex_unlock (&src->nvmm_buffers_queue_lock);
+        continue;
+      }
+
       src->frameInfo->frameNum = iFrame->getNumber();
       src->frameInfo->frameTime = iFrame->getTime();
 
@@ -700,7 +837,7 @@ bool StreamConsumer::threadExecute(GstNvArgusCameraSrc *src)
     }
   }
 
-  if (src->frameInfo->fd)
+  if (!src->ring && src->frameInfo->fd)
   {
     if (src->frameInfo->fd == -1) {
       ORIGINATE_ERROR("Failed to make frame, argus status: %d\n", ret_status);
@@ -736,6 +873,93 @@ bool StreamConsumer::threadShutdown(GstNvArgusCameraSrc *src)
   return true;
 }
 
+bool AuxStreamConsumer::threadInitialize(GstNvArgusCameraSrc *src)
+{
+  // Create the FrameConsumer.
+  m_consumer = UniqueObj<FrameConsumer>(FrameConsumer::create(m_stream));
+  if (!m_consumer)
+    ORIGINATE_ERROR("Failed to create FrameConsumer for request pad %d", m_aux->id);
+
+  return true;
+}
+
+bool AuxStreamConsumer::threadExecute(GstNvArgusCameraSrc *src)
+{
+  IEGLOutputStream *iStream = interface_cast<IEGLOutputStream>(m_stream);
+  IFrameConsumer *iFrameConsumer = interface_cast<IFrameConsumer>(m_consumer);
+  Argus::Status status = STATUS_OK;
+
+  if (!m_connected)
+  {
+    if (iStream->waitUntilConnected() != STATUS_OK)
+      ORIGINATE_ERROR("Stream of request pad %d failed to connect.", m_aux->id);
+    m_connected = true;
+  }
+
+  // A short timeout, so that shutdown is seen while the session is idle.
+  UniqueObj<Frame> frame(iFrameConsumer->acquireFrame(AUX_ACQUIRE_FRAME_TIMEOUT, &status));
+  if (!frame)
+  {
+    if (status != STATUS_TIMEOUT)
+      PROPAGATE_ERROR(requestShutdown());
+    return true;
+  }
+
+  if (!src->aux_streams->onFrame(m_aux->id))
+    return true;
+
+  IFrame *iFrame = interface_cast<IFrame>(frame);
+  if (!iFrame)
+    ORIGINATE_ERROR("Failed to get IFrame interface.");
+
+  NV::IImageNativeBuffer *iNativeBuffer =
+    interface_cast<NV::IImageNativeBuffer>(iFrame->getImage());
+  if (!iNativeBuffer)
+    ORIGINATE_ERROR("IImageNativeBuffer not supported by Image.");
+
+  // Drop the frame rather than wait when downstream holds every buffer.
+  gint slot = m_aux->ring->acquire(0);
+  if (slot < 0)
+  {
+    src->aux_streams->onDrop(m_aux->id);
+    return true;
+  }
+  if (iNativeBuffer->copyToNvBuffer(m_aux->ring->getFd(slot)) != STATUS_OK)
+  {
+    m_aux->ring->cancel(slot);
+    ORIGINATE_ERROR("Failed to copy the frame of request pad %d", m_aux->id);
+  }
+
+  GstBuffer *buffer = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_NO_SHARE,
+      m_aux->ring->getSurface(slot), sizeof(NvBufSurface), 0, sizeof(NvBufSurface),
+      m_aux->ring->lend(slot), NvArgusBufferRing::release);
+
+  // Same running time stamp as the always pad gets from do-timestamp.
+  GstClock *clock = gst_element_get_clock (GST_ELEMENT (src));
+  if (clock)
+  {
+    GstClockTime now = gst_clock_get_time (clock);
+    GstClockTime base_time = gst_element_get_base_time (GST_ELEMENT (src));
+    if (now >= base_time)
+      GST_BUFFER_PTS (buffer) = now - base_time;
+    gst_object_unref (clock);
+  }
+  if (m_aux->fps_n > 0)
+    GST_BUFFER_DURATION (buffer) = gst_util_uint64_scale_int (GST_SECOND, m_aux->fps_d, m_aux->fps_n);
+
+  g_mutex_lock (&m_aux->lock);
+  g_queue_push_tail (m_aux->buffers, buffer);
+  g_cond_signal (&m_aux->cond);
+  g_mutex_unlock (&m_aux->lock);
+
+  return true;
+}
+
+bool AuxStreamConsumer::threadShutdown(GstNvArgusCameraSrc *src)
+{
+  return true;
+}
+
 static pthread_mutex_t M_STREAM_SETUP_MUTEX = PTHREAD_MUTEX_INITIALIZER;
 
 static bool execute(int32_t cameraIndex,
@@ -1180,6 +1404,48 @@ static bool execute(int32_t cameraIndex,
     src->aeRegionPropSet = FALSE;
   }
 
+  // Request pads get output streams of their own, enabled in the same request.
+  ArgusStreamProvider auxProvider(iCaptureSession, iRequest);
+  vector< unique_ptr<AuxStreamConsumer> > auxConsumers;
+  {
+    std::unique_lock<std::mutex> g_lck(g_mtx);
+
+    if (!src->aux_streams->start(&auxProvider, src->fps_n ? src->fps_n : DEFAULT_FPS,
+                                 src->fps_n ? src->fps_d : 1)) {
+      pthread_mutex_unlock(&M_STREAM_SETUP_MUTEX);
+      ORIGINATE_ERROR("Failed to create the output streams of the request pads");
+    }
+  }
+  AuxStreamsGuard auxGuard(src->aux_streams, &auxProvider, auxConsumers);
+
+  vector<int> auxIds = src->aux_streams->getStartedIds();
+  for (index = 0; index < auxIds.size(); index++)
+  {
+    GstNvArgusAuxPad *aux = NULL;
+
+    g_mutex_lock (&src->aux_lock);
+    for (GList *l = src->aux_pads; l; l = l->next)
+    {
+      if (((GstNvArgusAuxPad *) l->data)->id == auxIds[index])
+        aux = (GstNvArgusAuxPad *) l->data;
+    }
+    g_mutex_unlock (&src->aux_lock);
+
+    if (!aux) {
+      pthread_mutex_unlock(&M_STREAM_SETUP_MUTEX);
+      ORIGINATE_ERROR("Request pad %d was released during setup", auxIds[index]);
+    }
+
+    GST_ARGUS_PRINT("Request pad %d: %d x %d, 1 of every %u frames\n", aux->id,
+                    aux->width, aux->height, src->aux_streams->getDecimation(aux->id));
+    auxConsumers.push_back(unique_ptr<AuxStreamConsumer>(new AuxStreamConsumer(
+        static_cast<OutputStream*>(src->aux_streams->getStream(aux->id)), aux)));
+    if (!auxConsumers.back()->initialize(src) || !auxConsumers.back()->waitRunning()) {
+      pthread_mutex_unlock(&M_STREAM_SETUP_MUTEX);
+      ORIGINATE_ERROR("Failed to start the consumer of request pad %d", aux->id);
+    }
+  }
+
   GST_ARGUS_PRINT("Setup Complete, Starting captures for %d seconds\n", secToRun);
 
   GST_ARGUS_PRINT("Starting repeat capture requests.\n");
@@ -1233,6 +1499,11 @@ static bool execute(int32_t cameraIndex,
   // Wait for the consumer thread to complete.
   PROPAGATE_ERROR(consumerThread.shutdown());
 
+  for (index = 0; index < auxConsumers.size(); index++)
+    PROPAGATE_ERROR(auxConsumers[index]->shutdown());
+  auxConsumers.clear();
+  src->aux_streams->stop(&auxProvider);
+
   if (src->queue.get() !=  NULL)
   {
     g_mutex_lock(&src->queue_lock);
@@ -1289,7 +1560,8 @@ enum
   PROP_EXPOSURE_COMPENSATION,
   PROP_AE_LOCK,
   PROP_AE_REGION,
-  PROP_AWB_LOCK
+  PROP_AWB_LOCK,
+  PROP_PASSTHROUGH
 };
 
 typedef struct AuxiliaryData {
@@ -1327,6 +1599,13 @@ static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
   GST_STATIC_CAPS (CAPTURE_CAPS)
   );
 
+/* Request pads are passthrough only, so they take NVMM NV12 */
+static GstStaticPadTemplate aux_src_factory = GST_STATIC_PAD_TEMPLATE ("aux_src_%u",
+  GST_PAD_SRC,
+  GST_PAD_REQUEST,
+  GST_STATIC_CAPS (CAPTURE_CAPS)
+  );
+
 typedef struct _GstNVArgusMemory GstNVArgusMemory;
 typedef struct _GstNVArgusMemoryAllocator GstNVArgusMemoryAllocator;
 typedef struct _GstNVArgusMemoryAllocatorClass GstNVArgusMemoryAllocatorClass;
@@ -1496,6 +1775,356 @@ static GstCaps * gst_nv_argus_camera_fixate (GstBaseSrc *src, GstCaps *caps)
   return caps;
 }
 
+typedef struct
+{
+  GstNvArgusCameraSrc *src;
+  gint width;
+  gint height;
+} NvArgusSurfaceSize;
+
+static void *
+gst_nv_argus_camera_alloc_surface (void *user_data, unsigned int index, int *fd)
+{
+  NvArgusSurfaceSize *size = (NvArgusSurfaceSize *) user_data;
+  GstNvArgusCameraSrc *src = size->src;
+  NvBufSurfaceAllocateParams input_params = {{0}};
+  NvBufSurface *nvbuf_surf = NULL;
+
+  /* Same layout as the pool buffers the transform path fills */
+  input_params.params.width = size->width;
+  input_params.params.height = size->height;
+  input_params.params.layout = NVBUF_LAYOUT_PITCH;
+  input_params.params.colorFormat = NVBUF_COLOR_FORMAT_NV12;
+  input_params.params.memType = NVBUF_MEM_SURFACE_ARRAY;
+  input_params.memtag = NvBufSurfaceTag_CAMERA;
+
+  if (NvBufSurfaceAllocate (&nvbuf_surf, 1, &input_params) != 0) {
+    GST_ERROR_OBJECT (src, "NvBufSurfaceAllocate Failed for passthrough buffer %u", index);
+    return NULL;
+  }
+  nvbuf_surf->numFilled = 1;
+  *fd = nvbuf_surf->surfaceList[0].bufferDesc;
+
+  return nvbuf_surf;
+}
+
+static void
+gst_nv_argus_camera_free_surface (void *surface)
+{
+  if (NvBufSurfaceDestroy ((NvBufSurface *) surface) != 0)
+    GST_ERROR ("%s: NvBufSurfaceDestroy Failed \n", __func__);
+}
+
+static NvArgusBufferRing *
+gst_nv_argus_camera_create_ring (GstNvArgusCameraSrc *src, gint width, gint height)
+{
+  NvArgusSurfaceSize size = { src, width, height };
+  NvArgusBufferRingOps ops;
+
+  ops.alloc = gst_nv_argus_camera_alloc_surface;
+  ops.free = gst_nv_argus_camera_free_surface;
+  ops.user_data = &size;
+  /* Downstream holds these for as long as it would have held pool buffers */
+  return NvArgusBufferRing::create (MAX_BUFFERS, ops);
+}
+
+/* Argus copies each frame into an NvBuffer of the negotiated size anyway,
+ * so when downstream takes NVMM NV12 that buffer can be pushed as it is and
+ * the NvBufSurfTransform into a pool buffer is skipped. */
+static gboolean
+gst_nv_argus_camera_can_passthrough (GstNvArgusCameraSrc *src, GstCaps *caps,
+    GstVideoInfo *info)
+{
+  GstCapsFeatures *features = gst_caps_get_features (caps, 0);
+
+  if (!src->passthrough)
+    return FALSE;
+  if (!features || !gst_caps_features_contains (features, "memory:NVMM"))
+    return FALSE;
+
+  return GST_VIDEO_INFO_FORMAT (info) == GST_VIDEO_FORMAT_NV12 &&
+      (gint) GST_VIDEO_INFO_WIDTH (info) == src->width &&
+      (gint) GST_VIDEO_INFO_HEIGHT (info) == src->height;
+}
+
+/* Drops the frames of a request pad and its buffers, once its stream stopped */
+static void
+gst_nv_argus_camera_aux_reset (GstNvArgusAuxPad *aux)
+{
+  g_mutex_lock (&aux->lock);
+  while (!g_queue_is_empty (aux->buffers))
+    gst_buffer_unref ((GstBuffer *) g_queue_pop_head (aux->buffers));
+  if (aux->ring)
+  {
+    /* Buffers still held downstream free the ring when they are released */
+    aux->ring->shutdown ();
+    aux->ring = NULL;
+  }
+  aux->negotiated = FALSE;
+  g_mutex_unlock (&aux->lock);
+}
+
+static void
+gst_nv_argus_camera_aux_free (GstNvArgusAuxPad *aux)
+{
+  gst_nv_argus_camera_aux_reset (aux);
+  g_queue_free (aux->buffers);
+  g_mutex_clear (&aux->lock);
+  g_cond_clear (&aux->cond);
+  g_slice_free (GstNvArgusAuxPad, aux);
+}
+
+static gboolean
+gst_nv_argus_camera_aux_negotiate (GstNvArgusAuxPad *aux)
+{
+  GstNvArgusCameraSrc *src = aux->src;
+  GstStructure *structure;
+  NvArgusBufferRing *ring;
+  GstVideoInfo info;
+  GstSegment segment;
+  GstCaps *templ, *caps;
+  gchar *stream_id;
+
+  templ = gst_pad_get_pad_template_caps (aux->pad);
+  caps = gst_pad_peer_query_caps (aux->pad, templ);
+  gst_caps_unref (templ);
+  if (gst_caps_is_empty (caps))
+  {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  /* Same defaults as the always pad */
+  caps = gst_caps_truncate (caps);
+  structure = gst_caps_get_structure (caps, 0);
+  gst_structure_fixate_field_nearest_int (structure, "width", 1920);
+  gst_structure_fixate_field_nearest_int (structure, "height", 1080);
+  gst_structure_fixate_field_nearest_fraction (structure, "framerate", 30, 1);
+  caps = gst_caps_fixate (caps);
+
+  if (!gst_video_info_from_caps (&info, caps))
+  {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+  GST_DEBUG_OBJECT (aux->pad, "Negotiated %" GST_PTR_FORMAT, caps);
+
+  ring = gst_nv_argus_camera_create_ring (src, info.width, info.height);
+  if (!ring)
+  {
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  g_mutex_lock (&aux->lock);
+  aux->ring = ring;
+  aux->width = info.width;
+  aux->height = info.height;
+  aux->fps_n = info.fps_n;
+  aux->fps_d = info.fps_d;
+  g_mutex_unlock (&aux->lock);
+
+  /* Fails once the capture session has started */
+  if (!src->aux_streams->configure (aux->id, info.width, info.height, info.fps_n, info.fps_d))
+  {
+    GST_ERROR_OBJECT (aux->pad, "Negotiated after the capture session started");
+    gst_nv_argus_camera_aux_reset (aux);
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  stream_id = gst_pad_create_stream_id (aux->pad, GST_ELEMENT (src), GST_PAD_NAME (aux->pad));
+  gst_pad_push_event (aux->pad, gst_event_new_stream_start (stream_id));
+  g_free (stream_id);
+  gst_pad_set_caps (aux->pad, caps);
+  gst_caps_unref (caps);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (aux->pad, gst_event_new_segment (&segment));
+
+  g_mutex_lock (&aux->lock);
+  aux->negotiated = TRUE;
+  g_mutex_unlock (&aux->lock);
+
+  g_mutex_lock (&src->aux_lock);
+  g_cond_broadcast (&src->aux_cond);
+  g_mutex_unlock (&src->aux_lock);
+
+  return TRUE;
+}
+
+static void
+gst_nv_argus_camera_aux_loop (GstNvArgusAuxPad *aux)
+{
+  GstNvArgusCameraSrc *src = aux->src;
+  gboolean negotiate;
+  GstBuffer *buffer;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&aux->lock);
+  negotiate = !aux->negotiated && !aux->flushing && !aux->eos;
+  g_mutex_unlock (&aux->lock);
+
+  if (negotiate && !gst_nv_argus_camera_aux_negotiate (aux))
+  {
+    GST_ELEMENT_ERROR (src, CORE, NEGOTIATION, (NULL),
+        ("Request pad %s failed to negotiate", GST_PAD_NAME (aux->pad)));
+    gst_pad_pause_task (aux->pad);
+    return;
+  }
+
+  g_mutex_lock (&aux->lock);
+  while (g_queue_is_empty (aux->buffers) && !aux->flushing && !aux->eos)
+    g_cond_wait (&aux->cond, &aux->lock);
+  if (aux->flushing)
+  {
+    g_mutex_unlock (&aux->lock);
+    gst_pad_pause_task (aux->pad);
+    return;
+  }
+  buffer = (GstBuffer *) g_queue_pop_head (aux->buffers);
+  g_mutex_unlock (&aux->lock);
+
+  if (!buffer)
+  {
+    /* The capture session ended with the queue drained */
+    gst_pad_push_event (aux->pad, gst_event_new_eos ());
+    gst_pad_pause_task (aux->pad);
+    return;
+  }
+
+  ret = gst_pad_push (aux->pad, buffer);
+  if (ret == GST_FLOW_OK || ret == GST_FLOW_NOT_LINKED)
+    return;
+
+  GST_DEBUG_OBJECT (aux->pad, "Pausing task, reason %s", gst_flow_get_name (ret));
+  if (ret < GST_FLOW_EOS)
+  {
+    GST_ELEMENT_FLOW_ERROR (src, ret);
+    gst_pad_push_event (aux->pad, gst_event_new_eos ());
+  }
+  gst_pad_pause_task (aux->pad);
+}
+
+static gboolean
+gst_nv_argus_camera_aux_activate_mode (GstPad *pad, GstObject *parent,
+    GstPadMode mode, gboolean active)
+{
+  GstNvArgusAuxPad *aux = (GstNvArgusAuxPad *) gst_pad_get_element_private (pad);
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  g_mutex_lock (&aux->lock);
+  aux->flushing = !active;
+  if (active)
+    aux->eos = FALSE;
+  g_cond_signal (&aux->cond);
+  g_mutex_unlock (&aux->lock);
+
+  if (active)
+    return gst_pad_start_task (pad, (GstTaskFunction) gst_nv_argus_camera_aux_loop, aux, NULL);
+
+  if (!gst_pad_stop_task (pad))
+    return FALSE;
+
+  g_mutex_lock (&aux->lock);
+  while (!g_queue_is_empty (aux->buffers))
+    gst_buffer_unref ((GstBuffer *) g_queue_pop_head (aux->buffers));
+  g_mutex_unlock (&aux->lock);
+
+  return TRUE;
+}
+
+static gboolean
+gst_nv_argus_camera_aux_query (GstPad *pad, GstObject *parent, GstQuery *query)
+{
+  GstNvArgusAuxPad *aux = (GstNvArgusAuxPad *) gst_pad_get_element_private (pad);
+
+  if (GST_QUERY_TYPE (query) == GST_QUERY_LATENCY)
+  {
+    GstClockTime min_latency = 0;
+
+    /* Live, with a frame of the pad as the minimum latency */
+    g_mutex_lock (&aux->lock);
+    if (aux->fps_n > 0)
+      min_latency = gst_util_uint64_scale_int (GST_SECOND, aux->fps_d, aux->fps_n);
+    g_mutex_unlock (&aux->lock);
+
+    gst_query_set_latency (query, TRUE, min_latency, GST_CLOCK_TIME_NONE);
+    return TRUE;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static GstPad *
+gst_nv_argus_camera_request_new_pad (GstElement *element, GstPadTemplate *templ,
+    const gchar *name, const GstCaps *caps)
+{
+  GstNvArgusCameraSrc *src = GST_NVARGUSCAMERASRC (element);
+  GstNvArgusAuxPad *aux;
+  gchar *pad_name;
+  gint id;
+
+  /* The output streams are created with the capture session */
+  id = src->aux_streams->addStream ();
+  if (id < 0)
+  {
+    GST_ERROR_OBJECT (src, "Request pads are added before capture starts, up to %d",
+        NVARGUSCAM_MAX_REQUEST_PADS);
+    return NULL;
+  }
+
+  aux = g_slice_new0 (GstNvArgusAuxPad);
+  aux->src = src;
+  aux->id = id;
+  aux->buffers = g_queue_new ();
+  g_mutex_init (&aux->lock);
+  g_cond_init (&aux->cond);
+
+  pad_name = name ? g_strdup (name) : g_strdup_printf ("aux_src_%d", id);
+  aux->pad = gst_pad_new_from_template (templ, pad_name);
+  g_free (pad_name);
+
+  gst_pad_set_element_private (aux->pad, aux);
+  gst_pad_set_activatemode_function (aux->pad,
+      GST_DEBUG_FUNCPTR (gst_nv_argus_camera_aux_activate_mode));
+  gst_pad_set_query_function (aux->pad, GST_DEBUG_FUNCPTR (gst_nv_argus_camera_aux_query));
+
+  g_mutex_lock (&src->aux_lock);
+  src->aux_pads = g_list_append (src->aux_pads, aux);
+  g_mutex_unlock (&src->aux_lock);
+
+  gst_element_add_pad (element, aux->pad);
+
+  return aux->pad;
+}
+
+static void
+gst_nv_argus_camera_release_pad (GstElement *element, GstPad *pad)
+{
+  GstNvArgusCameraSrc *src = GST_NVARGUSCAMERASRC (element);
+  GstNvArgusAuxPad *aux = (GstNvArgusAuxPad *) gst_pad_get_element_private (pad);
+  gboolean removed;
+
+  gst_pad_set_active (pad, FALSE);
+
+  /* A running stream is removed by stop(), when the session is gone */
+  g_mutex_lock (&src->aux_lock);
+  removed = src->aux_streams->removeStream (aux->id);
+  if (removed)
+    src->aux_pads = g_list_remove (src->aux_pads, aux);
+  else
+    aux->released = TRUE;
+  g_cond_broadcast (&src->aux_cond);
+  g_mutex_unlock (&src->aux_lock);
+
+  gst_element_remove_pad (element, pad);
+
+  if (removed)
+    gst_nv_argus_camera_aux_free (aux);
+}
+
 static gboolean gst_nv_argus_camera_set_caps (GstBaseSrc *base, GstCaps *caps)
 {
   GstVideoInfo info;
@@ -1530,20 +2159,46 @@ static gboolean gst_nv_argus_camera_set_caps (GstBaseSrc *base, GstCaps *caps)
     gst_object_unref (src->pool);
     src->pool = NULL;
   }
-  src->pool = gst_nvds_buffer_pool_new();
-  GstStructure *config = gst_buffer_pool_get_config (src->pool);
-  gst_buffer_pool_config_set_params (config, src->outcaps, sizeof(NvBufSurface), MIN_BUFFERS, MAX_BUFFERS);
-  gst_structure_set (config,
-        "memtype", G_TYPE_UINT, NVBUF_MEM_DEFAULT,
-        "memtag", G_TYPE_UINT, NvBufSurfaceTag_CAMERA,
-        "gpu-id", G_TYPE_UINT, 0,
-        "batch-size", G_TYPE_UINT, 1, NULL);
-  gst_buffer_pool_set_config (src->pool, config);
   src->argus_buffers = g_queue_new ();
   src->nvmm_buffers = g_queue_new ();
-  gst_buffer_pool_set_active (src->pool, TRUE);
 
-  src->consumer_thread = g_thread_new ("consumer_thread", consumer_thread, src);
+  if (!src->ring && gst_nv_argus_camera_can_passthrough (src, caps, &info))
+  {
+    src->ring = gst_nv_argus_camera_create_ring (src, src->width, src->height);
+    if (!src->ring)
+      GST_WARNING_OBJECT (src, "Passthrough buffers unavailable, using NvBufSurfTransform");
+  }
+  GST_INFO_OBJECT (src, "Output %s", src->ring ? "passthrough" : "through NvBufSurfTransform");
+
+  if (!src->ring)
+  {
+    src->pool = gst_nvds_buffer_pool_new();
+    GstStructure *config = gst_buffer_pool_get_config (src->pool);
+    gst_buffer_pool_config_set_params (config, src->outcaps, sizeof(NvBufSurface), MIN_BUFFERS, MAX_BUFFERS);
+    gst_structure_set (config,
+          "memtype", G_TYPE_UINT, NVBUF_MEM_DEFAULT,
+          "memtag", G_TYPE_UINT, NvBufSurfaceTag_CAMERA,
+          "gpu-id", G_TYPE_UINT, 0,
+          "batch-size", G_TYPE_UINT, 1, NULL);
+    gst_buffer_pool_set_config (src->pool, config);
+    gst_buffer_pool_set_active (src->pool, TRUE);
+
+    src->consumer_thread = g_thread_new ("consumer_thread", consumer_thread, src);
+  }
+
+  /* The request pads negotiate from their tasks, and their output streams
+   * are created along with the one of this pad */
+  g_mutex_lock (&src->aux_lock);
+  while (!src->aux_streams->isConfigured ())
+  {
+    gint64 until = g_get_monotonic_time () + G_TIME_SPAN_SECOND;
+    if (!g_cond_wait_until (&src->aux_cond, &src->aux_lock, until))
+    {
+      GST_WARNING_OBJECT (src, "Request pads not negotiated, starting without them");
+      break;
+    }
+  }
+  g_mutex_unlock (&src->aux_lock);
 
   src->argus_thread = g_thread_new ("argus_thread", argus_thread, src);
 
@@ -1613,13 +2268,58 @@ static gboolean gst_nv_argus_camera_stop (GstBaseSrc * src_base)
     gst_object_unref (src->pool);
     src->pool = NULL;
   }
-  g_thread_join(src->consumer_thread);
+  if (src->consumer_thread)
+  {
+    g_thread_join(src->consumer_thread);
+    src->consumer_thread = NULL;
+  }
 
     while (!g_queue_is_empty (src->nvmm_buffers)) {
     buf = (GstBuffer *) g_queue_pop_head (src->nvmm_buffers);
     gst_buffer_unref (buf);
   }
 
+  if (src->ring)
+  {
+    NvArgusBufferRingStats stats = src->ring->getStats ();
+    /* The transform would have read the Argus buffer and written a pool buffer */
+    gdouble frame_mb = 2.0 * src->width * src->height * 3 / 2 / (1024 * 1024);
+
+    GST_ARGUS_PRINT("Passthrough: %llu frames, %.1f MB of copy traffic saved per frame (%.1f MB/s at %d/%d fps), "
+        "producer waited %llu times (%llu ms) for downstream, up to %u of %u buffers held\n",
+        (unsigned long long) stats.lent, frame_mb,
+        src->fps_d ? frame_mb * src->fps_n / src->fps_d : 0.0, src->fps_n, src->fps_d,
+        (unsigned long long) stats.stalls, (unsigned long long) stats.stallTimeUs / 1000,
+        stats.maxLent, src->ring->getCount ());
+    /* Buffers still held downstream free the ring when they are released */
+    src->ring->shutdown ();
+    src->ring = NULL;
+  }
+
+  g_mutex_lock (&src->aux_lock);
+  for (GList *l = src->aux_pads; l; )
+  {
+    GstNvArgusAuxPad *aux = (GstNvArgusAuxPad *) l->data;
+    NvArgusStreamStats stats = src->aux_streams->getStats (aux->id);
+    GList *next = l->next;
+
+    if (stats.captured)
+      GST_ARGUS_PRINT("Request pad %d: %llu frames captured, %llu delivered, %llu skipped for %d/%d fps, "
+          "%llu dropped with every buffer held downstream\n", aux->id,
+          (unsigned long long) stats.captured, (unsigned long long) stats.delivered,
+          (unsigned long long) stats.decimated, aux->fps_n, aux->fps_d,
+          (unsigned long long) stats.dropped);
+    gst_nv_argus_camera_aux_reset (aux);
+    if (aux->released && src->aux_streams->removeStream (aux->id))
+    {
+      src->aux_pads = g_list_delete_link (src->aux_pads, l);
+      gst_nv_argus_camera_aux_free (aux);
+    }
+    l = next;
+  }
+  src->aux_streams->unconfigure ();
+  g_mutex_unlock (&src->aux_lock);
+
   g_queue_free(src->argus_buffers);
   g_queue_free(src->nvmm_buffers);
   return TRUE;
@@ -1666,6 +2366,20 @@ static gpointer argus_thread (gpointer src_base)
 
   src->stop_requested = TRUE;
 
+  /* Streams of a failed session are gone with it; the request pads push EOS */
+  src->aux_streams->stop (NULL);
+  g_mutex_lock (&src->aux_lock);
+  for (GList *l = src->aux_pads; l; l = l->next)
+  {
+    GstNvArgusAuxPad *aux = (GstNvArgusAuxPad *) l->data;
+
+    g_mutex_lock (&aux->lock);
+    aux->eos = TRUE;
+    g_cond_signal (&aux->cond);
+    g_mutex_unlock (&aux->lock);
+  }
+  g_mutex_unlock (&src->aux_lock);
+
   g_mutex_lock (&src->argus_buffers_queue_lock);
   g_cond_signal (&src->argus_buffers_queue_cond);
   g_mutex_unlock (&src->argus_buffers_queue_lock);
@@ -2010,6 +2724,9 @@ gst_nv_argus_camera_src_class_init (GstNvArgusCameraSrcClass * klass)
   base_src_class->unlock = GST_DEBUG_FUNCPTR (gst_nv_argus_camera_unlock);
   base_src_class->unlock_stop = GST_DEBUG_FUNCPTR (gst_nv_argus_camera_unlock_stop);
 
+  gstelement_class->request_new_pad = GST_DEBUG_FUNCPTR (gst_nv_argus_camera_request_new_pad);
+  gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_nv_argus_camera_release_pad);
+
   g_object_class_install_property (gobject_class, PROP_WHITE_BALANCE,
       g_param_spec_enum ("wbmode", "white balance mode",
           "White balance affects the color temperature of the photo",
@@ -2127,6 +2844,11 @@ gst_nv_argus_camera_src_class_init (GstNvArgusCameraSrcClass * klass)
           "set or unset the auto white balance lock",
           FALSE, (GParamFlags) G_PARAM_READWRITE));
 
+  g_object_class_install_property (gobject_class, PROP_PASSTHROUGH,
+      g_param_spec_boolean ("passthrough", "Passthrough",
+          "Push the Argus buffers without NvBufSurfTransform when the output is NVMM NV12",
+          NVARGUSCAM_DEFAULT_PASSTHROUGH, (GParamFlags) G_PARAM_READWRITE));
+
   gst_element_class_set_details_simple(gstelement_class,
     "NvArgusCameraSrc",
     "Video/Capture",
@@ -2135,6 +2857,8 @@ gst_nv_argus_camera_src_class_init (GstNvArgusCameraSrcClass * klass)
 
   gst_element_class_add_pad_template (gstelement_class,
       gst_static_pad_template_get (&src_factory));
+  gst_element_class_add_pad_template (gstelement_class,
+      gst_static_pad_template_get (&aux_src_factory));
 }
 
 /* initialize the new element
@@ -2168,6 +2892,12 @@ gst_nv_argus_camera_src_init (GstNvArgusCameraSrc * src)
   src->controls.AeAntibandingMode = NVARGUSCAM_DEFAULT_AEANTIBANDING_MODE;
   src->controls.AeLock = NVARGUSCAM_DEFAULT_AE_LOCK;
   src->controls.AwbLock = NVARGUSCAM_DEFAULT_AWB_LOCK;
+  src->passthrough = NVARGUSCAM_DEFAULT_PASSTHROUGH;
+  src->ring = NULL;
+  src->aux_pads = NULL;
+  src->aux_streams = new NvArgusStreamSet (NVARGUSCAM_MAX_REQUEST_PADS);
+  g_mutex_init (&src->aux_lock);
+  g_cond_init (&src->aux_cond);
 
   g_mutex_init (&src->argus_buffers_queue_lock);
   g_cond_init (&src->argus_buffers_queue_cond);
@@ -2204,6 +2934,11 @@ static void gst_nv_argus_camera_src_finalize (GObject *object)
   g_mutex_clear (&src->eos_lock);
   g_cond_clear (&src->eos_cond);
   g_mutex_clear(&src->queue_lock);
+  g_list_free_full (src->aux_pads, (GDestroyNotify) gst_nv_argus_camera_aux_free);
+  src->aux_pads = NULL;
+  delete src->aux_streams;
+  g_mutex_clear (&src->aux_lock);
+  g_cond_clear (&src->aux_cond);
   if(src->exposureTimeString) {
     g_free (src->exposureTimeString);
     src->exposureTimeString = NULL;
@@ -2338,6 +3073,9 @@ gst_nv_argus_camera_src_set_property (GObject * object, guint prop_id,
       src->controls.AwbLock = g_value_get_boolean (value);
       src->awbLockPropSet = TRUE;
       break;
+    case PROP_PASSTHROUGH:
+      src->passthrough = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2409,6 +3147,9 @@ gst_nv_argus_camera_src_get_property (GObject * object, guint prop_id,
     case PROP_AWB_LOCK:
       g_value_set_boolean (value, src->controls.AwbLock);
       break;
+    case PROP_PASSTHROUGH:
+      g_value_set_boolean (value, src->passthrough);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
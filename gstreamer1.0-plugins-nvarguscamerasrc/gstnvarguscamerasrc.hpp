@@ -36,6 +36,8 @@
 #include "nvbufsurface.h"
 #include "nvbufsurftransform.h"
 #include "gstnvarguscamera_utils.h"
+#include "gstnvarguscamera_ring.h"
+#include "gstnvarguscamera_streams.h"
 #include "gstnvdsbufferpool.h"
 
 G_BEGIN_DECLS
@@ -68,11 +70,14 @@ G_BEGIN_DECLS
 #define NVARGUSCAM_DEFAULT_EXP_COMPENSATION          0.0
 #define NVARGUSCAM_DEFAULT_AE_LOCK                   FALSE
 #define NVARGUSCAM_DEFAULT_AWB_LOCK                  FALSE
+#define NVARGUSCAM_DEFAULT_PASSTHROUGH               TRUE
+#define NVARGUSCAM_MAX_REQUEST_PADS                  3
 
 typedef struct _GstNvArgusCameraSrc      GstNvArgusCameraSrc;
 typedef struct _GstNvArgusCameraSrcClass GstNvArgusCameraSrcClass;
 
 typedef struct _GstNvArgusCameraSrcBuffer GstNvArgusCameraSrcBuffer;
+typedef struct _GstNvArgusAuxPad GstNvArgusAuxPad;
 
 typedef struct NvArgusCameraRangeRec
 {
@@ -108,6 +113,32 @@ struct _GstNvArgusCameraSrcBuffer
   NvBufSurface *surf;
 };
 
+/* Request pad, fed by its own output stream of the capture session */
+struct _GstNvArgusAuxPad
+{
+  GstNvArgusCameraSrc *src;
+  GstPad *pad;
+  /* Stream of the pad in GstNvArgusCameraSrc::aux_streams */
+  gint id;
+  /* Released while its stream runs, freed by stop(); under aux_lock */
+  gboolean released;
+
+  /* The rest is under lock */
+  GMutex lock;
+  GCond cond;
+  gboolean negotiated;
+  gboolean flushing;
+  gboolean eos;
+
+  gint width;
+  gint height;
+  gint fps_n;
+  gint fps_d;
+
+  NvArgusBufferRing *ring;
+  GQueue *buffers;
+};
+
 typedef struct NvArgusFrameInfo
 {
   gint fd;
@@ -155,6 +186,16 @@ struct _GstNvArgusCameraSrc
 
   NvBufSurfTransformParams transform_params;
 
+  /* Passthrough: Argus fills ring surfaces that go downstream as they are */
+  gboolean passthrough;
+  NvArgusBufferRing *ring;
+
+  /* Request pads, negotiated before the capture session starts */
+  GList *aux_pads;
+  NvArgusStreamSet *aux_streams;
+  GMutex aux_lock;
+  GCond aux_cond;
+
   GQueue *argus_buffers;
   GMutex argus_buffers_queue_lock;
   GCond argus_buffers_queue_cond;
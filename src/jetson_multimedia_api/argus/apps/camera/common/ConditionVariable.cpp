@@ -25,9 +25,13 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <errno.h>
+#include <time.h>
+
 #include "ConditionVariable.h"
 #include "Mutex.h"
 #include "Error.h"
+#include "Util.h"
 
 namespace ArgusSamples
 {
@@ -46,7 +50,18 @@ bool ConditionVariable::initialize()
 {
     if (!m_initialized)
     {
-        if (pthread_cond_init(&m_cond, NULL) != 0)
+        // timed waits use CLOCK_MONOTONIC so that wall clock steps don't affect the timeouts
+        pthread_condattr_t attr;
+        if (pthread_condattr_init(&attr) != 0)
+            ORIGINATE_ERROR("Failed to initialize condition variable attributes");
+        if (pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) != 0)
+        {
+            pthread_condattr_destroy(&attr);
+            ORIGINATE_ERROR("Failed to set the condition variable clock");
+        }
+        const int result = pthread_cond_init(&m_cond, &attr);
+        pthread_condattr_destroy(&attr);
+        if (result != 0)
             ORIGINATE_ERROR("Failed to initialize condition variable");
         m_initialized = true;
     }
@@ -96,4 +111,38 @@ bool ConditionVariable::wait(const Mutex& mutex) const
     return true;
 }
 
+bool ConditionVariable::timedWait(const Mutex& mutex, const TimeValue& timeout,
+    bool *timedOut) const
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+
+    if (timedOut)
+        *timedOut = false;
+
+    if (timeout == TimeValue::infinite())
+        return wait(mutex);
+
+    // the condition variable uses CLOCK_MONOTONIC, see initialize()
+    struct timespec deadline;
+    if (clock_gettime(CLOCK_MONOTONIC, &deadline) != 0)
+        ORIGINATE_ERROR("clock_gettime failed");
+
+    const TimeValue::NSecType nsec = deadline.tv_nsec + timeout.toNSec();
+    deadline.tv_sec += nsec / 1000000000;
+    deadline.tv_nsec = nsec % 1000000000;
+
+    const int result = pthread_cond_timedwait(&m_cond, mutex.getPThreadMutex(), &deadline);
+    if (result == ETIMEDOUT)
+    {
+        if (timedOut)
+            *timedOut = true;
+    }
+    else if (result != 0)
+    {
+        ORIGINATE_ERROR("pthread_cond_timedwait failed");
+    }
+    return true;
+}
+
 }; // namespace ArgusSamples
@@ -35,6 +35,7 @@ namespace ArgusSamples
 {
 
 class Mutex;
+class TimeValue;
 
 /**
  * Conditional
@@ -75,6 +76,16 @@ public:
      */
     bool wait(const Mutex& mutex) const;
 
+    /**
+     * Wait on the condition variable until signalled or until the timeout expired.  This method
+     * is declared @c const for convenience.
+     * @param [in] mutex The mutex that will be released while waiting.
+     * @param [in] timeout Relative timeout measured with CLOCK_MONOTONIC, TimeValue::infinite()
+     *                     to wait without timeout.
+     * @param [out] timedOut Optional, set if the timeout expired.
+     */
+    bool timedWait(const Mutex& mutex, const TimeValue& timeout, bool *timedOut = NULL) const;
+
 private:
     bool m_initialized;
     /**
@@ -27,6 +27,7 @@
  */
 
 #include <sys/time.h>
+#include <time.h>
 #include <stddef.h>
 #include <cerrno>
 
@@ -41,12 +42,13 @@ namespace ArgusSamples
 
 TimeValue getCurrentTime()
 {
-    struct timeval val;
+    // the times are only used for intervals and pacing, don't let wall clock steps affect them
+    struct timespec val;
 
-    gettimeofday(&val, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &val);
 
     return
-        TimeValue::fromUSec(val.tv_usec) +
+        TimeValue::fromNSec(static_cast<TimeValue::NSecType>(val.tv_nsec)) +
         TimeValue::fromSec(static_cast<TimeValue::SecType>(val.tv_sec));
 }
 
@@ -193,7 +193,7 @@ private:
 };
 
 /*!
- * Get the current time.
+ * Get the current time of CLOCK_MONOTONIC.
  */
 TimeValue getCurrentTime();
 
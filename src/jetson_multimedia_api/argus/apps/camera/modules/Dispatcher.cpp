@@ -953,6 +953,8 @@ Dispatcher::Dispatcher()
     , m_stillFileType(new ValidatorEnum<StillFileType>(
         s_stillFileTypes, sizeof(s_stillFileTypes) / sizeof(s_stillFileTypes[0])),
         STILL_FILE_TYPE_JPG)
+    , m_stillZsl(false)
+    , m_stillZslFrames(new ValidatorRange<uint32_t>(1, 8), 4)
     , m_videoFormat(new ValidatorEnum<VideoPipeline::VideoFormat>(
         s_videoFormats, sizeof(s_videoFormats) / sizeof(s_videoFormats[0])),
         VideoPipeline::VIDEO_FORMAT_H265)
@@ -303,6 +303,8 @@ public:
 
     // still settings
     Value<StillFileType> m_stillFileType;    ///< the still image file format
+    Value<bool> m_stillZsl;                  ///< zero shutter lag still capture
+    Value<uint32_t> m_stillZslFrames;        ///< recent frames held for zero shutter lag capture
 
     // video settings
     Value<VideoPipeline::VideoFormat> m_videoFormat;    ///< the video format
@@ -30,6 +30,7 @@
 #include "Dispatcher.h"
 #include "Util.h"
 #include "PerfTracker.h"
+#include "Composer.h"
 
 #include <Argus/Ext/InternalFrameCount.h>
 
@@ -97,6 +98,9 @@ bool EventThread::threadExecute()
                     PROPAGATE_ERROR(m_sessionPerfTracker->onEvent(
                         SESSION_EVENT_REQUEST_LATENCY, latency.toMSec()));
 
+                    // the frame is presented to the preview stream, wake up the composer
+                    PROPAGATE_ERROR(Composer::getInstance().signalNewFrame(latency));
+
                     // AF
                     std::vector< Argus::AcRegion > regions;
                     std::vector<float> sharpnessScore;
@@ -0,0 +1,1077 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define FUSION_SIMD
+#elif defined(__x86_64__)
+#include <emmintrin.h>
+#define FUSION_SIMD
+#endif
+
+#include "ExposureFusion.h"
+#include "Error.h"
+
+namespace ArgusSamples
+{
+
+/// floats in front of and behind the scratch rows, filled by mirroring
+static const uint32_t PAD = 8;
+
+/// passes with less output samples than this are run by the calling thread only
+static const uint64_t MIN_PARALLEL_SAMPLES = 16 * 1024;
+
+#if defined(__aarch64__)
+
+typedef float32x4_t vfloat;
+
+static inline vfloat vLoad(const float *p) { return vld1q_f32(p); }
+static inline void vStore(float *p, vfloat v) { vst1q_f32(p, v); }
+static inline vfloat vSet(float f) { return vdupq_n_f32(f); }
+static inline vfloat vAdd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+static inline vfloat vSub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+static inline vfloat vMul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+static inline vfloat vDiv(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+static inline vfloat vMin(vfloat a, vfloat b) { return vminq_f32(a, b); }
+static inline vfloat vMax(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+static inline vfloat vAbs(vfloat a) { return vabsq_f32(a); }
+
+static inline void vLoadDeinterleave(const float *p, vfloat *even, vfloat *odd)
+{
+    float32x4x2_t v = vld2q_f32(p);
+    *even = v.val[0];
+    *odd = v.val[1];
+}
+
+static inline void vStoreInterleave(float *p, vfloat even, vfloat odd)
+{
+    float32x4x2_t v;
+    v.val[0] = even;
+    v.val[1] = odd;
+    vst2q_f32(p, v);
+}
+
+static inline vfloat vLoadU8(const uint8_t *p)
+{
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    const uint16x8_t h = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(word)));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(h)));
+}
+
+/// stores 4 samples, which have to be clamped to [0, 255] and rounded already
+static inline void vStoreU8(uint8_t *p, vfloat v)
+{
+    const uint16x4_t h = vmovn_u32(vcvtq_u32_f32(v));
+    const uint8x8_t b = vmovn_u16(vcombine_u16(h, h));
+    const uint32_t word = vget_lane_u32(vreinterpret_u32_u8(b), 0);
+    memcpy(p, &word, sizeof(word));
+}
+
+#elif defined(__x86_64__)
+
+typedef __m128 vfloat;
+
+static inline vfloat vLoad(const float *p) { return _mm_loadu_ps(p); }
+static inline void vStore(float *p, vfloat v) { _mm_storeu_ps(p, v); }
+static inline vfloat vSet(float f) { return _mm_set1_ps(f); }
+static inline vfloat vAdd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vSub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vMul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vDiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vfloat vMin(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+static inline vfloat vMax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+static inline vfloat vAbs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+static inline void vLoadDeinterleave(const float *p, vfloat *even, vfloat *odd)
+{
+    const __m128 a = _mm_loadu_ps(p);
+    const __m128 b = _mm_loadu_ps(p + 4);
+    *even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    *odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static inline void vStoreInterleave(float *p, vfloat even, vfloat odd)
+{
+    _mm_storeu_ps(p, _mm_unpacklo_ps(even, odd));
+    _mm_storeu_ps(p + 4, _mm_unpackhi_ps(even, odd));
+}
+
+static inline vfloat vLoadU8(const uint8_t *p)
+{
+    int32_t word;
+    memcpy(&word, p, sizeof(word));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_cvtsi32_si128(word);
+    v = _mm_unpacklo_epi8(v, zero);
+    v = _mm_unpacklo_epi16(v, zero);
+    return _mm_cvtepi32_ps(v);
+}
+
+/// stores 4 samples, which have to be clamped to [0, 255] and rounded already
+static inline void vStoreU8(uint8_t *p, vfloat v)
+{
+    __m128i i = _mm_cvttps_epi32(v);
+    i = _mm_packs_epi32(i, i);
+    i = _mm_packus_epi16(i, i);
+    const int32_t word = _mm_cvtsi128_si32(i);
+    memcpy(p, &word, sizeof(word));
+}
+
+#endif // __x86_64__
+
+static uint64_t getTime()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Mirror a row or column index at the borders of [0, n), without repeating the border sample.
+ */
+static inline int32_t mirror(int32_t i, int32_t n)
+{
+    if (i < 0)
+        i = -i;
+    if (i >= n)
+        i = 2 * n - 2 - i;
+    return std::min(std::max(i, 0), n - 1);
+}
+
+/**
+ * Fill the PAD samples in front of and behind a row by mirroring.
+ */
+static inline void padRow(float *row, int32_t n)
+{
+    for (int32_t i = 1; i <= static_cast<int32_t>(PAD); ++i)
+    {
+        row[-i] = row[mirror(-i, n)];
+        row[n - 1 + i] = row[mirror(n - 1 + i, n)];
+    }
+}
+
+static inline float *rowOf(const ExposureFusion::FloatPlane &plane, uint32_t y)
+{
+    return plane.data + static_cast<size_t>(y) * plane.pitch;
+}
+
+static inline uint8_t toU8(float value)
+{
+    return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 255.0f) + 0.5f);
+}
+
+/**
+ * Runs the bands of the passes of a fusion.
+ */
+class ExposureFusion::Worker : public Thread
+{
+public:
+    Worker(ExposureFusion *fusion, uint32_t index)
+        : m_fusion(fusion)
+        , m_index(index)
+        , m_generation(0)
+    {
+    }
+
+protected:
+    virtual bool threadInitialize()
+    {
+        return true;
+    }
+
+    virtual bool threadExecute()
+    {
+        bool done = false;
+
+        PROPAGATE_ERROR(m_fusion->workerExecute(m_index, &m_generation, &done));
+        if (done)
+            PROPAGATE_ERROR(requestShutdown());
+
+        return true;
+    }
+
+    virtual bool threadShutdown()
+    {
+        return true;
+    }
+
+private:
+    ExposureFusion *m_fusion;
+    uint32_t m_index;
+    uint32_t m_generation;
+};
+
+ExposureFusion::ExposureFusion()
+    : m_initialized(false)
+#if defined(FUSION_SIMD)
+    , m_simd(true)
+#else
+    , m_simd(false)
+#endif
+    , m_width(0)
+    , m_height(0)
+    , m_numImages(0)
+    , m_levels(0)
+    , m_numThreads(0)
+    , m_images(NULL)
+    , m_output(NULL)
+    , m_ops(NULL)
+    , m_generation(0)
+    , m_pending(0)
+    , m_stopping(false)
+{
+}
+
+ExposureFusion::~ExposureFusion()
+{
+    shutdown();
+}
+
+void ExposureFusion::setSimd(bool enable)
+{
+#if defined(FUSION_SIMD)
+    m_simd = enable;
+#endif
+}
+
+bool ExposureFusion::allocPlane(FloatPlane *plane, uint32_t width, uint32_t height)
+{
+    // rows start 16 byte aligned
+    const uint32_t pitch = (width + 3) & ~3;
+    void *data = NULL;
+
+    if (posix_memalign(&data, 16, static_cast<size_t>(pitch) * height * sizeof(float)) != 0)
+        ORIGINATE_ERROR("Out of memory");
+
+    plane->data = static_cast<float*>(data);
+    plane->width = width;
+    plane->height = height;
+    plane->pitch = pitch;
+
+    return true;
+}
+
+void ExposureFusion::freePlane(FloatPlane *plane)
+{
+    free(plane->data);
+    *plane = FloatPlane();
+}
+
+bool ExposureFusion::initialize(uint32_t width, uint32_t height, uint32_t numImages,
+    const Params &params, uint32_t numThreads)
+{
+    if (m_initialized)
+        return true;
+
+    if ((width < 8) || (height < 8) || (width & 1) || (height & 1))
+        ORIGINATE_ERROR("Unsupported image size %ux%u", width, height);
+    if (numImages < 2)
+        ORIGINATE_ERROR("At least two images are needed");
+    if (params.sigma <= 0.0f)
+        ORIGINATE_ERROR("Invalid sigma %f", params.sigma);
+
+    uint32_t levels = params.levels;
+    if (levels == 0)
+    {
+        // stop when the short side of the top level is 16 samples or less
+        levels = 1;
+        for (uint32_t size = std::min(width, height); size > 16; size = (size + 1) / 2)
+            ++levels;
+    }
+    if ((levels < 2) || (levels > 16))
+        ORIGINATE_ERROR("Invalid number of levels %u", levels);
+
+    if (numThreads == 0)
+        numThreads = std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+
+    m_initialized = true;
+    m_width = width;
+    m_height = height;
+    m_numImages = numImages;
+    m_levels = levels;
+    m_numThreads = numThreads;
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        const float offset = i / 255.0f - 0.5f;
+        m_exposednessLut[i] = expf(-(offset * offset) / (2.0f * params.sigma * params.sigma));
+    }
+
+    // allocate the planes, chroma has one level less than luma
+    m_weights.resize(numImages);
+    for (uint32_t i = 0; i < numImages; ++i)
+        PROPAGATE_ERROR(allocPlane(&m_weights[i], width, height));
+
+    m_weightPyr.resize(levels);
+    m_lumaPyr.resize(levels);
+    m_lumaBlend.resize(levels);
+    m_cbPyr.resize(levels - 1);
+    m_crPyr.resize(levels - 1);
+    m_cbBlend.resize(levels - 1);
+    m_crBlend.resize(levels - 1);
+    uint32_t levelWidth = width;
+    uint32_t levelHeight = height;
+    for (uint32_t level = 0; level < levels; ++level)
+    {
+        if (level > 0)
+        {
+            PROPAGATE_ERROR(allocPlane(&m_weightPyr[level], levelWidth, levelHeight));
+            PROPAGATE_ERROR(allocPlane(&m_cbPyr[level - 1], levelWidth, levelHeight));
+            PROPAGATE_ERROR(allocPlane(&m_crPyr[level - 1], levelWidth, levelHeight));
+            PROPAGATE_ERROR(allocPlane(&m_cbBlend[level - 1], levelWidth, levelHeight));
+            PROPAGATE_ERROR(allocPlane(&m_crBlend[level - 1], levelWidth, levelHeight));
+        }
+        PROPAGATE_ERROR(allocPlane(&m_lumaPyr[level], levelWidth, levelHeight));
+        PROPAGATE_ERROR(allocPlane(&m_lumaBlend[level], levelWidth, levelHeight));
+
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+
+    // two padded rows per thread
+    m_scratch.resize(numThreads, NULL);
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        m_scratch[i] = new float[2 * (width + 3 * PAD)];
+        if (!m_scratch[i])
+            ORIGINATE_ERROR("Out of memory");
+    }
+
+    PROPAGATE_ERROR(m_mutex.initialize());
+    PROPAGATE_ERROR(m_workCond.initialize());
+    PROPAGATE_ERROR(m_doneCond.initialize());
+
+    m_stopping = false;
+    m_generation = 0;
+    for (uint32_t i = 1; i < numThreads; ++i)
+    {
+        Worker *worker = new Worker(this, i);
+        if (!worker)
+            ORIGINATE_ERROR("Out of memory");
+        m_workers.push_back(worker);
+
+        worker->setThreadRole("fusion");
+        PROPAGATE_ERROR(worker->initialize());
+        PROPAGATE_ERROR(worker->waitRunning());
+    }
+
+    return true;
+}
+
+bool ExposureFusion::shutdown()
+{
+    if (!m_initialized)
+        return true;
+
+    if (!m_workers.empty())
+    {
+        {
+            ScopedMutex sm(m_mutex);
+            PROPAGATE_ERROR_CONTINUE(sm.expectLocked());
+
+            m_stopping = true;
+            PROPAGATE_ERROR_CONTINUE(m_workCond.broadcast());
+        }
+
+        for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+        {
+            PROPAGATE_ERROR_CONTINUE((*it)->shutdown());
+            delete *it;
+        }
+        m_workers.clear();
+    }
+
+    PROPAGATE_ERROR_CONTINUE(m_doneCond.shutdown());
+    PROPAGATE_ERROR_CONTINUE(m_workCond.shutdown());
+    PROPAGATE_ERROR_CONTINUE(m_mutex.shutdown());
+
+    for (std::vector<float*>::iterator it = m_scratch.begin(); it != m_scratch.end(); ++it)
+        delete [] *it;
+    m_scratch.clear();
+
+    std::vector<FloatPlane> *planes[] =
+    {
+        &m_weights, &m_weightPyr, &m_lumaPyr, &m_cbPyr, &m_crPyr,
+        &m_lumaBlend, &m_cbBlend, &m_crBlend
+    };
+    for (uint32_t i = 0; i < sizeof(planes) / sizeof(planes[0]); ++i)
+    {
+        for (std::vector<FloatPlane>::iterator it = planes[i]->begin(); it != planes[i]->end();
+             ++it)
+        {
+            freePlane(&*it);
+        }
+        planes[i]->clear();
+    }
+
+    m_initialized = false;
+
+    return true;
+}
+
+bool ExposureFusion::workerExecute(uint32_t index, uint32_t *generation, bool *done)
+{
+    const std::vector<Op> *ops = NULL;
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        while (!m_stopping && (m_generation == *generation))
+            PROPAGATE_ERROR(m_workCond.wait(m_mutex));
+
+        if (m_stopping)
+        {
+            *done = true;
+            return true;
+        }
+
+        *generation = m_generation;
+        ops = m_ops;
+    }
+
+    runBand(*ops, index, m_numThreads, m_scratch[index]);
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        if (--m_pending == 0)
+            PROPAGATE_ERROR(m_doneCond.broadcast());
+    }
+
+    return true;
+}
+
+bool ExposureFusion::runPass(const std::vector<Op> &ops)
+{
+    uint64_t samples = 0;
+    for (std::vector<Op>::const_iterator it = ops.begin(); it != ops.end(); ++it)
+        samples += static_cast<uint64_t>(it->dst->width) * it->dst->height;
+
+    // waking up the workers costs more than small passes take, the bands are independent so
+    // the result does not depend on how the pass is split
+    if (m_workers.empty() || (samples < MIN_PARALLEL_SAMPLES))
+    {
+        runBand(ops, 0, 1, m_scratch[0]);
+        return true;
+    }
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        m_ops = &ops;
+        m_pending = static_cast<uint32_t>(m_workers.size());
+        ++m_generation;
+        PROPAGATE_ERROR(m_workCond.broadcast());
+    }
+
+    runBand(ops, 0, m_numThreads, m_scratch[0]);
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        while (m_pending != 0)
+            PROPAGATE_ERROR(m_doneCond.wait(m_mutex));
+    }
+
+    return true;
+}
+
+void ExposureFusion::runBand(const std::vector<Op> &ops, uint32_t band, uint32_t numBands,
+    float *scratch)
+{
+    for (std::vector<Op>::const_iterator it = ops.begin(); it != ops.end(); ++it)
+    {
+        const uint64_t rows = it->dst->height;
+        const uint32_t y0 = static_cast<uint32_t>(rows * band / numBands);
+        const uint32_t y1 = static_cast<uint32_t>(rows * (band + 1) / numBands);
+
+        if (y0 == y1)
+            continue;
+
+        switch (it->type)
+        {
+        case OP_WEIGHTS:
+            weightRows(y0, y1, scratch);
+            break;
+        case OP_LOAD_LUMA:
+            loadLumaRows(m_images[it->image].luma, *it->dst, y0, y1);
+            break;
+        case OP_LOAD_CHROMA:
+            loadChromaRows(m_images[it->image].chroma, y0, y1);
+            break;
+        case OP_REDUCE:
+            reduceRows(*it->src, *it->dst, y0, y1, scratch);
+            break;
+        case OP_ACCUMULATE:
+        case OP_ACCUMULATE_TOP:
+        case OP_EXPAND_ADD:
+            accumulateRows(*it, y0, y1, scratch);
+            break;
+        case OP_STORE_LUMA:
+            storeLumaRows(m_output->luma, y0, y1);
+            break;
+        case OP_STORE_CHROMA:
+            storeChromaRows(m_output->chroma, y0, y1);
+            break;
+        }
+    }
+}
+
+void ExposureFusion::weightRows(uint32_t y0, uint32_t y1, float *scratch) const
+{
+    const int32_t width = m_width;
+    float *sum = scratch + PAD;
+    float *saturation = sum + m_width + 3 * PAD;
+
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        for (uint32_t image = 0; image < m_numImages; ++image)
+        {
+            const Plane &luma = m_images[image].luma;
+            const Plane &chroma = m_images[image].chroma;
+            const uint8_t *cur = luma.data + static_cast<size_t>(y) * luma.pitch;
+            const uint8_t *up = luma.data +
+                static_cast<size_t>(mirror(static_cast<int32_t>(y) - 1, m_height)) * luma.pitch;
+            const uint8_t *down = luma.data +
+                static_cast<size_t>(mirror(y + 1, m_height)) * luma.pitch;
+            const uint8_t *cbcr = chroma.data + static_cast<size_t>(y / 2) * chroma.pitch;
+            float *weight = rowOf(m_weights[image], y);
+
+            // saturation, floored at one code value
+            for (int32_t x = 0; x < width / 2; ++x)
+            {
+                saturation[x] = static_cast<float>(abs(cbcr[2 * x] - 128) +
+                    abs(cbcr[2 * x + 1] - 128) + 1) * (1.0f / 255.0f);
+            }
+
+            // well-exposedness
+            for (int32_t x = 0; x < width; ++x)
+                weight[x] = m_exposednessLut[cur[x]] * saturation[x >> 1];
+
+            // contrast, floored at one code value, the borders are mirrored
+            int32_t x = 0;
+            for (int32_t pass = 0; pass < 2; ++pass)
+            {
+                const int32_t end = (pass == 0) ? 1 : width;
+                for (; x < end; ++x)
+                {
+                    const int32_t laplacian = 4 * cur[x] - up[x] - down[x] -
+                        cur[mirror(x - 1, width)] - cur[mirror(x + 1, width)];
+                    const float contrast =
+                        (static_cast<float>(abs(laplacian)) + 1.0f) * (1.0f / 255.0f);
+
+                    weight[x] *= contrast;
+                    sum[x] = (image == 0) ? weight[x] : sum[x] + weight[x];
+                }
+#if defined(FUSION_SIMD)
+                if ((pass == 0) && m_simd)
+                {
+                    const vfloat four = vSet(4.0f);
+                    const vfloat one = vSet(1.0f);
+                    const vfloat scale = vSet(1.0f / 255.0f);
+                    for (; x + 4 < width; x += 4)
+                    {
+                        const vfloat laplacian = vSub(vSub(vSub(vSub(
+                            vMul(four, vLoadU8(cur + x)), vLoadU8(up + x)), vLoadU8(down + x)),
+                            vLoadU8(cur + x - 1)), vLoadU8(cur + x + 1));
+                        const vfloat contrast = vMul(vAdd(vAbs(laplacian), one), scale);
+                        const vfloat w = vMul(vLoad(weight + x), contrast);
+
+                        vStore(weight + x, w);
+                        vStore(sum + x, (image == 0) ? w : vAdd(vLoad(sum + x), w));
+                    }
+                }
+#endif
+            }
+        }
+
+        // normalize
+        int32_t x = 0;
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            const vfloat one = vSet(1.0f);
+            for (; x + 4 <= width; x += 4)
+                vStore(sum + x, vDiv(one, vLoad(sum + x)));
+        }
+#endif
+        for (; x < width; ++x)
+            sum[x] = 1.0f / sum[x];
+
+        for (uint32_t image = 0; image < m_numImages; ++image)
+        {
+            float *weight = rowOf(m_weights[image], y);
+
+            x = 0;
+#if defined(FUSION_SIMD)
+            if (m_simd)
+            {
+                for (; x + 4 <= width; x += 4)
+                    vStore(weight + x, vMul(vLoad(weight + x), vLoad(sum + x)));
+            }
+#endif
+            for (; x < width; ++x)
+                weight[x] *= sum[x];
+        }
+    }
+}
+
+void ExposureFusion::loadLumaRows(const Plane &src, const FloatPlane &dst, uint32_t y0,
+    uint32_t y1) const
+{
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        const uint8_t *in = src.data + static_cast<size_t>(y) * src.pitch;
+        float *out = rowOf(dst, y);
+
+        uint32_t x = 0;
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            for (; x + 4 <= dst.width; x += 4)
+                vStore(out + x, vLoadU8(in + x));
+        }
+#endif
+        for (; x < dst.width; ++x)
+            out[x] = in[x];
+    }
+}
+
+void ExposureFusion::loadChromaRows(const Plane &src, uint32_t y0, uint32_t y1) const
+{
+    const FloatPlane &cb = m_cbPyr[0];
+    const FloatPlane &cr = m_crPyr[0];
+
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        const uint8_t *in = src.data + static_cast<size_t>(y) * src.pitch;
+        float *outCb = rowOf(cb, y);
+        float *outCr = rowOf(cr, y);
+
+        for (uint32_t x = 0; x < cb.width; ++x)
+        {
+            outCb[x] = in[2 * x];
+            outCr[x] = in[2 * x + 1];
+        }
+    }
+}
+
+void ExposureFusion::reduceRows(const FloatPlane &src, const FloatPlane &dst, uint32_t y0,
+    uint32_t y1, float *scratch) const
+{
+    // separable 1 4 6 4 1 binomial filter
+    float *tmp = scratch + PAD;
+
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        const float *r0 = rowOf(src, mirror(2 * static_cast<int32_t>(y) - 2, src.height));
+        const float *r1 = rowOf(src, mirror(2 * static_cast<int32_t>(y) - 1, src.height));
+        const float *r2 = rowOf(src, mirror(2 * static_cast<int32_t>(y), src.height));
+        const float *r3 = rowOf(src, mirror(2 * static_cast<int32_t>(y) + 1, src.height));
+        const float *r4 = rowOf(src, mirror(2 * static_cast<int32_t>(y) + 2, src.height));
+
+        uint32_t x = 0;
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            const vfloat four = vSet(4.0f);
+            const vfloat six = vSet(6.0f);
+            const vfloat scale = vSet(1.0f / 16.0f);
+            for (; x + 4 <= src.width; x += 4)
+            {
+                const vfloat v = vAdd(vAdd(vAdd(vLoad(r0 + x), vLoad(r4 + x)),
+                    vMul(four, vAdd(vLoad(r1 + x), vLoad(r3 + x)))), vMul(six, vLoad(r2 + x)));
+                vStore(tmp + x, vMul(v, scale));
+            }
+        }
+#endif
+        for (; x < src.width; ++x)
+        {
+            tmp[x] = (((r0[x] + r4[x]) + 4.0f * (r1[x] + r3[x])) + 6.0f * r2[x]) *
+                (1.0f / 16.0f);
+        }
+        padRow(tmp, src.width);
+
+        float *out = rowOf(dst, y);
+        x = 0;
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            const vfloat four = vSet(4.0f);
+            const vfloat six = vSet(6.0f);
+            const vfloat scale = vSet(1.0f / 16.0f);
+            for (; x + 4 <= dst.width; x += 4)
+            {
+                vfloat e0, o0, e1, o1, e2, o2;
+                vLoadDeinterleave(tmp + 2 * x - 2, &e0, &o0);
+                vLoadDeinterleave(tmp + 2 * x, &e1, &o1);
+                vLoadDeinterleave(tmp + 2 * x + 2, &e2, &o2);
+                const vfloat v = vAdd(vAdd(vAdd(e0, e2), vMul(four, vAdd(o0, o1))),
+                    vMul(six, e1));
+                vStore(out + x, vMul(v, scale));
+            }
+        }
+#endif
+        for (; x < dst.width; ++x)
+        {
+            const float *p = tmp + 2 * x;
+            out[x] = (((p[-2] + p[2]) + 4.0f * (p[-1] + p[1])) + 6.0f * p[0]) * (1.0f / 16.0f);
+        }
+    }
+}
+
+void ExposureFusion::expandRow(const FloatPlane &coarse, uint32_t y, uint32_t width, float *out,
+    float *scratch) const
+{
+    // upsampling with the reduce filter, even output samples are 1 6 1 / 8 of the coarse
+    // samples, odd ones 4 4 / 8
+    float *tmp = scratch + PAD;
+    const int32_t i = y / 2;
+    const float *r0 = rowOf(coarse, mirror(i - 1, coarse.height));
+    const float *r1 = rowOf(coarse, i);
+    const float *r2 = rowOf(coarse, mirror(i + 1, coarse.height));
+
+    uint32_t x = 0;
+    if ((y & 1) == 0)
+    {
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            const vfloat six = vSet(6.0f);
+            const vfloat scale = vSet(1.0f / 8.0f);
+            for (; x + 4 <= coarse.width; x += 4)
+            {
+                vStore(tmp + x, vMul(vAdd(vAdd(vLoad(r0 + x), vLoad(r2 + x)),
+                    vMul(six, vLoad(r1 + x))), scale));
+            }
+        }
+#endif
+        for (; x < coarse.width; ++x)
+            tmp[x] = ((r0[x] + r2[x]) + 6.0f * r1[x]) * (1.0f / 8.0f);
+    }
+    else
+    {
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            const vfloat half = vSet(0.5f);
+            for (; x + 4 <= coarse.width; x += 4)
+                vStore(tmp + x, vMul(vAdd(vLoad(r1 + x), vLoad(r2 + x)), half));
+        }
+#endif
+        for (; x < coarse.width; ++x)
+            tmp[x] = (r1[x] + r2[x]) * 0.5f;
+    }
+    padRow(tmp, coarse.width);
+
+    // 'out' is padded, writing one sample more for odd widths is fine
+    x = 0;
+#if defined(FUSION_SIMD)
+    if (m_simd)
+    {
+        const vfloat six = vSet(6.0f);
+        const vfloat eighth = vSet(1.0f / 8.0f);
+        const vfloat half = vSet(0.5f);
+        for (; x + 4 <= coarse.width; x += 4)
+        {
+            const vfloat left = vLoad(tmp + x - 1);
+            const vfloat center = vLoad(tmp + x);
+            const vfloat right = vLoad(tmp + x + 1);
+            vStoreInterleave(out + 2 * x,
+                vMul(vAdd(vAdd(left, right), vMul(six, center)), eighth),
+                vMul(vAdd(center, right), half));
+        }
+    }
+#endif
+    for (; 2 * x < width; ++x)
+    {
+        const float *p = tmp + x;
+        out[2 * x] = ((p[-1] + p[1]) + 6.0f * p[0]) * (1.0f / 8.0f);
+        out[2 * x + 1] = (p[0] + p[1]) * 0.5f;
+    }
+}
+
+void ExposureFusion::accumulateRows(const Op &op, uint32_t y0, uint32_t y1, float *scratch) const
+{
+    const FloatPlane &dst = *op.dst;
+    float *expanded = scratch + (m_width + 3 * PAD) + PAD;
+
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        float *out = rowOf(dst, y);
+        const float *src = op.src ? rowOf(*op.src, y) : NULL;
+        const float *weight = op.weight ? rowOf(*op.weight, y) : NULL;
+
+        if (op.coarse)
+            expandRow(*op.coarse, y, dst.width, expanded, scratch);
+
+        uint32_t x = 0;
+        switch (op.type)
+        {
+        case OP_ACCUMULATE:
+#if defined(FUSION_SIMD)
+            if (m_simd)
+            {
+                for (; x + 4 <= dst.width; x += 4)
+                {
+                    const vfloat v = vMul(vLoad(weight + x),
+                        vSub(vLoad(src + x), vLoad(expanded + x)));
+                    vStore(out + x, op.assign ? v : vAdd(vLoad(out + x), v));
+                }
+            }
+#endif
+            for (; x < dst.width; ++x)
+            {
+                const float v = weight[x] * (src[x] - expanded[x]);
+                out[x] = op.assign ? v : out[x] + v;
+            }
+            break;
+        case OP_ACCUMULATE_TOP:
+#if defined(FUSION_SIMD)
+            if (m_simd)
+            {
+                for (; x + 4 <= dst.width; x += 4)
+                {
+                    const vfloat v = vMul(vLoad(weight + x), vLoad(src + x));
+                    vStore(out + x, op.assign ? v : vAdd(vLoad(out + x), v));
+                }
+            }
+#endif
+            for (; x < dst.width; ++x)
+            {
+                const float v = weight[x] * src[x];
+                out[x] = op.assign ? v : out[x] + v;
+            }
+            break;
+        default:
+#if defined(FUSION_SIMD)
+            if (m_simd)
+            {
+                for (; x + 4 <= dst.width; x += 4)
+                    vStore(out + x, vAdd(vLoad(out + x), vLoad(expanded + x)));
+            }
+#endif
+            for (; x < dst.width; ++x)
+                out[x] += expanded[x];
+            break;
+        }
+    }
+}
+
+void ExposureFusion::storeLumaRows(const Plane &dst, uint32_t y0, uint32_t y1) const
+{
+    const FloatPlane &src = m_lumaBlend[0];
+
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        const float *in = rowOf(src, y);
+        uint8_t *out = dst.data + static_cast<size_t>(y) * dst.pitch;
+
+        uint32_t x = 0;
+#if defined(FUSION_SIMD)
+        if (m_simd)
+        {
+            const vfloat zero = vSet(0.0f);
+            const vfloat max = vSet(255.0f);
+            const vfloat half = vSet(0.5f);
+            for (; x + 4 <= src.width; x += 4)
+                vStoreU8(out + x, vAdd(vMin(vMax(vLoad(in + x), zero), max), half));
+        }
+#endif
+        for (; x < src.width; ++x)
+            out[x] = toU8(in[x]);
+    }
+}
+
+void ExposureFusion::storeChromaRows(const Plane &dst, uint32_t y0, uint32_t y1) const
+{
+    const FloatPlane &cb = m_cbBlend[0];
+    const FloatPlane &cr = m_crBlend[0];
+
+    for (uint32_t y = y0; y < y1; ++y)
+    {
+        const float *inCb = rowOf(cb, y);
+        const float *inCr = rowOf(cr, y);
+        uint8_t *out = dst.data + static_cast<size_t>(y) * dst.pitch;
+
+        for (uint32_t x = 0; x < cb.width; ++x)
+        {
+            out[2 * x] = toU8(inCb[x]);
+            out[2 * x + 1] = toU8(inCr[x]);
+        }
+    }
+}
+
+bool ExposureFusion::fuse(const Image *images, const Image &output, Timings *timings)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+
+    m_images = images;
+    m_output = &output;
+
+    const uint32_t levels = m_levels;
+    std::vector<Op> ops;
+    ops.reserve(8);
+
+    const uint64_t startTime = getTime();
+
+    ops.push_back(makeOp(OP_WEIGHTS, &m_weights[0]));
+    PROPAGATE_ERROR(runPass(ops));
+
+    const uint64_t weightsTime = getTime();
+
+    // Build the pyramids of one image after the other and add them to the blended pyramids.
+    // Chroma level 'l' has the size of luma level 'l + 1' and uses the weights of that level.
+    // The passes interleave the levels such that each one only reads what earlier passes wrote.
+    for (uint32_t image = 0; image < m_numImages; ++image)
+    {
+        const bool assign = (image == 0);
+        FloatPlane *weight[16];
+        weight[0] = &m_weights[image];
+        for (uint32_t level = 1; level < levels; ++level)
+            weight[level] = &m_weightPyr[level];
+
+        ops.clear();
+        ops.push_back(makeOp(OP_LOAD_LUMA, &m_lumaPyr[0]));
+        ops.push_back(makeOp(OP_LOAD_CHROMA, &m_cbPyr[0]));
+        ops[0].image = ops[1].image = image;
+        PROPAGATE_ERROR(runPass(ops));
+
+        for (uint32_t level = 0; level + 1 < levels; ++level)
+        {
+            ops.clear();
+            ops.push_back(makeOp(OP_REDUCE, &m_lumaPyr[level + 1], &m_lumaPyr[level]));
+            ops.push_back(makeOp(OP_REDUCE, weight[level + 1], weight[level]));
+            if (level >= 1)
+            {
+                ops.push_back(makeOp(OP_REDUCE, &m_cbPyr[level], &m_cbPyr[level - 1]));
+                ops.push_back(makeOp(OP_REDUCE, &m_crPyr[level], &m_crPyr[level - 1]));
+                ops.push_back(makeOp(OP_ACCUMULATE, &m_lumaBlend[level - 1],
+                    &m_lumaPyr[level - 1], &m_lumaPyr[level], weight[level - 1], assign));
+            }
+            if (level >= 2)
+            {
+                ops.push_back(makeOp(OP_ACCUMULATE, &m_cbBlend[level - 2], &m_cbPyr[level - 2],
+                    &m_cbPyr[level - 1], weight[level - 1], assign));
+                ops.push_back(makeOp(OP_ACCUMULATE, &m_crBlend[level - 2], &m_crPyr[level - 2],
+                    &m_crPyr[level - 1], weight[level - 1], assign));
+            }
+            PROPAGATE_ERROR(runPass(ops));
+        }
+
+        // the remaining levels of both pyramids
+        ops.clear();
+        ops.push_back(makeOp(OP_ACCUMULATE, &m_lumaBlend[levels - 2], &m_lumaPyr[levels - 2],
+            &m_lumaPyr[levels - 1], weight[levels - 2], assign));
+        ops.push_back(makeOp(OP_ACCUMULATE_TOP, &m_lumaBlend[levels - 1], &m_lumaPyr[levels - 1],
+            NULL, weight[levels - 1], assign));
+        if (levels >= 3)
+        {
+            ops.push_back(makeOp(OP_ACCUMULATE, &m_cbBlend[levels - 3], &m_cbPyr[levels - 3],
+                &m_cbPyr[levels - 2], weight[levels - 2], assign));
+            ops.push_back(makeOp(OP_ACCUMULATE, &m_crBlend[levels - 3], &m_crPyr[levels - 3],
+                &m_crPyr[levels - 2], weight[levels - 2], assign));
+        }
+        ops.push_back(makeOp(OP_ACCUMULATE_TOP, &m_cbBlend[levels - 2], &m_cbPyr[levels - 2],
+            NULL, weight[levels - 1], assign));
+        ops.push_back(makeOp(OP_ACCUMULATE_TOP, &m_crBlend[levels - 2], &m_crPyr[levels - 2],
+            NULL, weight[levels - 1], assign));
+        PROPAGATE_ERROR(runPass(ops));
+    }
+
+    const uint64_t pyramidTime = getTime();
+
+    // collapse, chroma level 'l - 1' together with luma level 'l'
+    for (uint32_t level = levels - 1; level-- > 0;)
+    {
+        ops.clear();
+        ops.push_back(makeOp(OP_EXPAND_ADD, &m_lumaBlend[level], NULL, &m_lumaBlend[level + 1]));
+        if (level >= 1)
+        {
+            ops.push_back(makeOp(OP_EXPAND_ADD, &m_cbBlend[level - 1], NULL,
+                &m_cbBlend[level]));
+            ops.push_back(makeOp(OP_EXPAND_ADD, &m_crBlend[level - 1], NULL,
+                &m_crBlend[level]));
+        }
+        PROPAGATE_ERROR(runPass(ops));
+    }
+
+    ops.clear();
+    ops.push_back(makeOp(OP_STORE_LUMA, &m_lumaBlend[0]));
+    ops.push_back(makeOp(OP_STORE_CHROMA, &m_cbBlend[0]));
+    PROPAGATE_ERROR(runPass(ops));
+
+    const uint64_t endTime = getTime();
+
+    if (timings)
+    {
+        timings->weights = weightsTime - startTime;
+        timings->pyramid = pyramidTime - weightsTime;
+        timings->collapse = endTime - pyramidTime;
+        timings->total = endTime - startTime;
+    }
+
+    m_images = NULL;
+    m_output = NULL;
+
+    return true;
+}
+
+/* static */ ExposureFusion::Op ExposureFusion::makeOp(OpType type, FloatPlane *dst,
+    const FloatPlane *src, const FloatPlane *coarse, const FloatPlane *weight, bool assign)
+{
+    Op op;
+
+    op.type = type;
+    op.src = src;
+    op.coarse = coarse;
+    op.weight = weight;
+    op.dst = dst;
+    op.image = 0;
+    op.assign = assign;
+
+    return op;
+}
+
+}; // namespace ArgusSamples
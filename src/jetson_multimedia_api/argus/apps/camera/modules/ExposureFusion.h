@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EXPOSURE_FUSION_H
+#define EXPOSURE_FUSION_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "ConditionVariable.h"
+#include "Mutex.h"
+#include "Thread.h"
+
+namespace ArgusSamples
+{
+
+/**
+ * Merges a burst of differently exposed NV12 images into one well exposed image (exposure
+ * fusion, Mertens et al.).
+ *
+ * Each pixel of each image is weighted by its contrast (absolute luma Laplacian), saturation
+ * (chroma magnitude) and well-exposedness (luma closeness to mid grey). The contrast and
+ * saturation are floored at one code value so that flat grey areas are still weighted by their
+ * exposure. The weights are normalized per pixel, the Laplacian pyramids of the images are
+ * blended with the Gaussian pyramids of the weights and the blended pyramid is collapsed. Chroma
+ * is blended at half resolution with the weight pyramid starting at its second level.
+ *
+ * Every pass of the pipeline is split into row bands which are processed by worker threads, and
+ * the inner loops use SSE2 on x86_64 and NEON on aarch64.
+ */
+class ExposureFusion
+{
+public:
+    /**
+     * A plane of 8 bit samples
+     */
+    struct Plane
+    {
+        uint8_t *data;
+        uint32_t pitch;                 ///< in bytes
+    };
+
+    /**
+     * NV12 image
+     */
+    struct Image
+    {
+        Plane luma;
+        Plane chroma;                   ///< interleaved Cb/Cr at half resolution
+    };
+
+    /**
+     * Fusion parameters
+     */
+    struct Params
+    {
+        Params()
+            : levels(0)
+            , sigma(0.2f)
+        {
+        }
+
+        uint32_t levels;                ///< luma pyramid levels, 0 selects them from the size
+        float sigma;                    ///< width of the well-exposedness curve, normalized luma
+    };
+
+    /**
+     * Time spent in the stages of a fusion, in nanoseconds
+     */
+    struct Timings
+    {
+        Timings()
+            : weights(0)
+            , pyramid(0)
+            , collapse(0)
+            , total(0)
+        {
+        }
+
+        uint64_t weights;               ///< computing and normalizing the weights
+        uint64_t pyramid;               ///< building and blending the pyramids
+        uint64_t collapse;              ///< collapsing the blended pyramid and storing the image
+        uint64_t total;
+    };
+
+    ExposureFusion();
+    ~ExposureFusion();
+
+    /**
+     * Allocate the buffers and start the worker threads.
+     *
+     * @param width [in] image width, has to be even
+     * @param height [in] image height, has to be even
+     * @param numImages [in] images per burst, at least 2
+     * @param params [in] fusion parameters
+     * @param numThreads [in] threads working on a fusion including the calling thread, 0 uses
+     *                        one per online CPU
+     */
+    bool initialize(uint32_t width, uint32_t height, uint32_t numImages,
+        const Params &params = Params(), uint32_t numThreads = 0);
+
+    /**
+     * Stop the worker threads and free the buffers.
+     */
+    bool shutdown();
+
+    /**
+     * Fuse a burst.
+     *
+     * @param images [in] 'numImages' input images
+     * @param output [in] output image
+     * @param timings [out] optional, time spent in the stages
+     */
+    bool fuse(const Image *images, const Image &output, Timings *timings = NULL);
+
+    /**
+     * Enable or disable the SIMD code paths, for benchmarking. They are enabled by default if
+     * available.
+     */
+    void setSimd(bool enable);
+
+    /**
+     * @returns the number of threads working on a fusion
+     */
+    uint32_t getNumThreads() const
+    {
+        return m_numThreads;
+    }
+
+    /**
+     * @returns the number of luma pyramid levels
+     */
+    uint32_t getLevels() const
+    {
+        return m_levels;
+    }
+
+    /**
+     * A plane of float samples
+     */
+    struct FloatPlane
+    {
+        FloatPlane()
+            : data(NULL)
+            , width(0)
+            , height(0)
+            , pitch(0)
+        {
+        }
+
+        float *data;
+        uint32_t width;
+        uint32_t height;
+        uint32_t pitch;                 ///< in floats
+    };
+
+private:
+    class Worker;
+
+    /**
+     * Operations a pass is made of, each is split into row bands of its output
+     */
+    enum OpType
+    {
+        OP_WEIGHTS,                     ///< compute the normalized weights of all images
+        OP_LOAD_LUMA,                   ///< convert the luma of an image to float
+        OP_LOAD_CHROMA,                 ///< convert and split the chroma of an image
+        OP_REDUCE,                      ///< blur and decimate 'src' into 'dst'
+        OP_ACCUMULATE,                  ///< dst += weight * (src - expand(coarse))
+        OP_ACCUMULATE_TOP,              ///< dst += weight * src
+        OP_EXPAND_ADD,                  ///< dst += expand(coarse)
+        OP_STORE_LUMA,                  ///< convert the collapsed luma to the output image
+        OP_STORE_CHROMA                 ///< convert and interleave the collapsed chroma
+    };
+
+    struct Op
+    {
+        OpType type;
+        const FloatPlane *src;
+        const FloatPlane *coarse;
+        const FloatPlane *weight;
+        FloatPlane *dst;
+        uint32_t image;                 ///< image index for the load operations
+        bool assign;                    ///< OP_ACCUMULATE*: overwrite 'dst' instead of adding
+    };
+
+    bool m_initialized;
+    bool m_simd;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_numImages;
+    uint32_t m_levels;                  ///< luma levels, chroma has one less
+    uint32_t m_numThreads;
+
+    float m_exposednessLut[256];
+
+    std::vector<FloatPlane> m_weights;      ///< per image, full resolution, normalized
+    std::vector<FloatPlane> m_weightPyr;    ///< weight pyramid levels 1.., level 0 is m_weights
+    std::vector<FloatPlane> m_lumaPyr;      ///< Gaussian pyramid of the current image
+    std::vector<FloatPlane> m_cbPyr;
+    std::vector<FloatPlane> m_crPyr;
+    std::vector<FloatPlane> m_lumaBlend;    ///< blended Laplacian pyramids
+    std::vector<FloatPlane> m_cbBlend;
+    std::vector<FloatPlane> m_crBlend;
+    std::vector<float*> m_scratch;          ///< one row buffer per thread
+
+    // state of the current fusion, set before a pass is run
+    const Image *m_images;
+    const Image *m_output;
+
+    // pass dispatching
+    Mutex m_mutex;
+    ConditionVariable m_workCond;       ///< signaled when a pass starts or on shutdown
+    ConditionVariable m_doneCond;       ///< signaled when the workers finished a pass
+    std::vector<Worker*> m_workers;
+    const std::vector<Op> *m_ops;       ///< operations of the current pass
+    uint32_t m_generation;              ///< incremented for each pass
+    uint32_t m_pending;                 ///< workers still busy with the current pass
+    bool m_stopping;
+
+    static Op makeOp(OpType type, FloatPlane *dst, const FloatPlane *src = NULL,
+        const FloatPlane *coarse = NULL, const FloatPlane *weight = NULL, bool assign = false);
+
+    bool allocPlane(FloatPlane *plane, uint32_t width, uint32_t height);
+    void freePlane(FloatPlane *plane);
+
+    /**
+     * Run the operations of a pass on all threads and wait for them.
+     */
+    bool runPass(const std::vector<Op> &ops);
+
+    /**
+     * Run band 'band' of 'numBands' of each operation.
+     */
+    void runBand(const std::vector<Op> &ops, uint32_t band, uint32_t numBands, float *scratch);
+
+    /**
+     * Called by the worker threads, waits for a pass and runs its band.
+     *
+     * @param index [in] worker index, the calling thread of fuse() has index 0
+     * @param generation [in/out] the last pass the worker ran
+     * @param done [out] set if shutdown had been requested
+     */
+    bool workerExecute(uint32_t index, uint32_t *generation, bool *done);
+
+    void weightRows(uint32_t y0, uint32_t y1, float *scratch) const;
+    void loadLumaRows(const Plane &src, const FloatPlane &dst, uint32_t y0, uint32_t y1) const;
+    void loadChromaRows(const Plane &src, uint32_t y0, uint32_t y1) const;
+    void reduceRows(const FloatPlane &src, const FloatPlane &dst, uint32_t y0, uint32_t y1,
+        float *scratch) const;
+    void expandRow(const FloatPlane &coarse, uint32_t y, uint32_t width, float *out,
+        float *scratch) const;
+    void accumulateRows(const Op &op, uint32_t y0, uint32_t y1, float *scratch) const;
+    void storeLumaRows(const Plane &dst, uint32_t y0, uint32_t y1) const;
+    void storeChromaRows(const Plane &dst, uint32_t y0, uint32_t y1) const;
+
+    /**
+     * Hide copy constructor and assignment operator
+     */
+    ExposureFusion(const ExposureFusion&);
+    ExposureFusion& operator=(const ExposureFusion&);
+};
+
+}; // namespace ArgusSamples
+
+#endif // EXPOSURE_FUSION_H
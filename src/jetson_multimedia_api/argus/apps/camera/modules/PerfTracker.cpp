@@ -124,6 +124,111 @@ bool PerfTracker::onEvent(GlobalEvent event)
     return true;
 }
 
+bool PerfTracker::onComposerStats(const RenderScheduler::Stats &stats,
+    const TimeValue &interval, const TimeValue &cpuTime)
+{
+    if (!Dispatcher::getInstance().m_kpi)
+        return true;
+
+    const float seconds = static_cast<float>(interval.toUSec()) / 1e6f;
+    if (seconds <= 0.0f)
+        return true;
+
+    printf("PerfTracker: composer cpu %.2f%%, %.1f wakeups/s, %u frames, %u updates coalesced, "
+        "refresh %.2f ms\n",
+        static_cast<float>(cpuTime.toUSec()) / 1e4f / seconds,
+        static_cast<float>(stats.wakeups) / seconds,
+        stats.framesRendered, stats.framesCoalesced,
+        static_cast<float>(stats.refreshPeriod.toUSec()) / 1000.0f);
+    if (stats.framesRendered > 1)
+    {
+        printf("PerfTracker: composer pacing jitter %.3f ms average, max %.3f ms\n",
+            static_cast<float>(stats.jitterSum.toUSec()) / 1000.0f / (stats.framesRendered - 1),
+            static_cast<float>(stats.jitterMax.toUSec()) / 1000.0f);
+    }
+    if (stats.latencyCount)
+    {
+        printf("PerfTracker: capture to swap latency %" PRIu64 " ms average, min %" PRIu64
+            " max %" PRIu64 "\n",
+            stats.latencySum.toMSec() / stats.latencyCount,
+            stats.latencyMin.toMSec(), stats.latencyMax.toMSec());
+    }
+
+    return true;
+}
+
+bool PerfTracker::onStillCaptureStats(const char *mode, const ZslCapture::Stats &stats)
+{
+    if (!Dispatcher::getInstance().m_kpi)
+        return true;
+
+    printf("PerfTracker: %s still %u shots, %u written, %u failed\n", mode, stats.shots,
+        stats.written, stats.failed);
+    if (stats.shutterToFrame.count)
+    {
+        printf("PerfTracker: %s still shutter to frame %.3f ms average, min %.3f max %.3f, "
+            "frame offset %.3f ms average, max %.3f\n", mode,
+            static_cast<float>(stats.shutterToFrame.average()) / 1e6f,
+            static_cast<float>(stats.shutterToFrame.min) / 1e6f,
+            static_cast<float>(stats.shutterToFrame.max) / 1e6f,
+            static_cast<float>(stats.frameOffset.average()) / 1e6f,
+            static_cast<float>(stats.frameOffset.max) / 1e6f);
+    }
+    if (stats.shutterToFile.count)
+    {
+        printf("PerfTracker: %s still shutter to file %.3f ms average, min %.3f max %.3f\n",
+            mode,
+            static_cast<float>(stats.shutterToFile.average()) / 1e6f,
+            static_cast<float>(stats.shutterToFile.min) / 1e6f,
+            static_cast<float>(stats.shutterToFile.max) / 1e6f);
+    }
+
+    return true;
+}
+
+bool PerfTracker::onFusionStats(const ExposureFusion::Timings &timings, uint32_t fused,
+    uint32_t overBudget, const TimeValue &interval)
+{
+    if (!Dispatcher::getInstance().m_kpi)
+        return true;
+
+    const float seconds = static_cast<float>(interval.toUSec()) / 1e6f;
+    if ((seconds <= 0.0f) || (fused == 0))
+        return true;
+
+    printf("PerfTracker: exposure fusion %.1f bursts/s, %u over budget, weights %.3f ms, "
+        "pyramid %.3f ms, collapse %.3f ms, total %.3f ms average\n",
+        static_cast<float>(fused) / seconds, overBudget,
+        static_cast<float>(timings.weights) / 1e6f / fused,
+        static_cast<float>(timings.pyramid) / 1e6f / fused,
+        static_cast<float>(timings.collapse) / 1e6f / fused,
+        static_cast<float>(timings.total) / 1e6f / fused);
+
+    return true;
+}
+
+bool PerfTracker::onPreviewSwitchStats(const char *mode, const WarmSwitch::Stats &stats)
+{
+    if (!Dispatcher::getInstance().m_kpi)
+        return true;
+
+    printf("PerfTracker: %s preview switch %u switches, %u completed, %u failed, "
+        "%" PRIu64 " frames shown, %" PRIu64 " hidden\n", mode, stats.switches, stats.completed,
+        stats.failed, stats.shown, stats.hidden);
+    if (stats.switchToFrame.count)
+    {
+        printf("PerfTracker: %s preview switch to first frame %.3f ms average, min %.3f max %.3f, "
+            "switch call %.3f ms average, max %.3f\n", mode,
+            static_cast<float>(stats.switchToFrame.average()) / 1e6f,
+            static_cast<float>(stats.switchToFrame.min) / 1e6f,
+            static_cast<float>(stats.switchToFrame.max) / 1e6f,
+            static_cast<float>(stats.switchCall.average()) / 1e6f,
+            static_cast<float>(stats.switchCall.max) / 1e6f);
+    }
+
+    return true;
+}
+
 SessionPerfTracker::SessionPerfTracker()
     : m_id(PerfTracker::getInstance().getNewSessionID())
     , m_session(NULL)
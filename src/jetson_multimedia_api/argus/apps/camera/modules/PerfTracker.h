@@ -34,6 +34,10 @@
 #include "Util.h" // for TimeValue
 #include "Ordered.h"
 #include "UniquePointer.h"
+#include "RenderScheduler.h"
+#include "ExposureFusion.h"
+#include "WarmSwitch.h"
+#include "ZslCapture.h"
 
 namespace Argus { class CaptureSession; }
 
@@ -70,6 +74,43 @@ public:
      */
     bool onEvent(GlobalEvent event);
 
+    /**
+     * Report the composer statistics of an interval.
+     *
+     * @param stats [in] render scheduler statistics of the interval
+     * @param interval [in] length of the interval
+     * @param cpuTime [in] CPU time used by the composer thread in the interval
+     */
+    bool onComposerStats(const RenderScheduler::Stats &stats, const TimeValue &interval,
+        const TimeValue &cpuTime);
+
+    /**
+     * Report the still capture statistics.
+     *
+     * @param mode [in] capture mode
+     * @param stats [in] still capture statistics
+     */
+    bool onStillCaptureStats(const char *mode, const ZslCapture::Stats &stats);
+
+    /**
+     * Report the exposure fusion statistics of an interval.
+     *
+     * @param timings [in] sum of the stage timings of the fusions in the interval
+     * @param fused [in] bursts fused in the interval
+     * @param overBudget [in] fusions which took longer than capturing a burst
+     * @param interval [in] length of the interval
+     */
+    bool onFusionStats(const ExposureFusion::Timings &timings, uint32_t fused,
+        uint32_t overBudget, const TimeValue &interval);
+
+    /**
+     * Report the preview switch statistics.
+     *
+     * @param mode [in] switch mode
+     * @param stats [in] preview switch statistics
+     */
+    bool onPreviewSwitchStats(const char *mode, const WarmSwitch::Stats &stats);
+
     /**
      * @returns the point in time when the app had been started
      */
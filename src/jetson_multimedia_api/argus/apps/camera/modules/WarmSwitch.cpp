@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "WarmSwitch.h"
+#include "Error.h"
+
+namespace ArgusSamples
+{
+
+WarmSwitch::WarmSwitch()
+    : m_initialized(false)
+    , m_warm(false)
+    , m_active(0)
+    , m_switching(false)
+    , m_pending(false)
+    , m_switchTime(0)
+{
+}
+
+WarmSwitch::~WarmSwitch()
+{
+    shutdown();
+}
+
+bool WarmSwitch::initialize(const std::vector<IWarmSource*> &sources, uint32_t active, bool warm)
+{
+    if (m_initialized)
+        return true;
+
+    if (sources.empty())
+        ORIGINATE_ERROR("No sources");
+    if (active >= sources.size())
+        ORIGINATE_ERROR("Invalid source index %u", active);
+    for (std::vector<IWarmSource*>::const_iterator it = sources.begin(); it != sources.end(); ++it)
+    {
+        if (!*it)
+            ORIGINATE_ERROR("Invalid source");
+    }
+
+    PROPAGATE_ERROR(m_switchMutex.initialize());
+    PROPAGATE_ERROR(m_mutex.initialize());
+    PROPAGATE_ERROR(m_cond.initialize());
+
+    m_sources = sources;
+    m_prepared.assign(sources.size(), false);
+    m_warm = warm;
+
+    // in warm mode all sources are capturing before the first one is shown
+    bool ok = true;
+    for (uint32_t index = 0; ok && (index < m_sources.size()); ++index)
+    {
+        if (warm || (index == active))
+            ok = prepareSource(index);
+    }
+    if (ok && !m_sources[active]->setPreview(true))
+    {
+        REPORT_ERROR("Failed to show source %u", active);
+        ok = false;
+    }
+    if (!ok)
+    {
+        for (uint32_t index = 0; index < m_sources.size(); ++index)
+            PROPAGATE_ERROR_CONTINUE(releaseSource(index));
+        m_sources.clear();
+        m_prepared.clear();
+        ORIGINATE_ERROR("Failed to prepare the sources");
+    }
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    m_active = active;
+    m_switching = false;
+    // wait for the first frame but don't count the start as a switch
+    m_pending = true;
+    m_switchTime = 0;
+    m_stats = Stats();
+    m_initialized = true;
+
+    return true;
+}
+
+bool WarmSwitch::shutdown()
+{
+    if (!m_initialized)
+        return true;
+
+    {
+        ScopedMutex ss(m_switchMutex);
+        PROPAGATE_ERROR_CONTINUE(ss.expectLocked());
+
+        uint32_t active = 0;
+        {
+            ScopedMutex sm(m_mutex);
+            PROPAGATE_ERROR_CONTINUE(sm.expectLocked());
+
+            // frames reported from now on are dropped, wake up waiters
+            m_initialized = false;
+            m_pending = false;
+            active = m_active;
+            PROPAGATE_ERROR_CONTINUE(m_cond.broadcast());
+        }
+
+        PROPAGATE_ERROR_CONTINUE(m_sources[active]->setPreview(false));
+        for (uint32_t index = 0; index < m_sources.size(); ++index)
+            PROPAGATE_ERROR_CONTINUE(releaseSource(index));
+
+        m_sources.clear();
+        m_prepared.clear();
+    }
+
+    PROPAGATE_ERROR_CONTINUE(m_cond.shutdown());
+    PROPAGATE_ERROR_CONTINUE(m_mutex.shutdown());
+    PROPAGATE_ERROR_CONTINUE(m_switchMutex.shutdown());
+
+    return true;
+}
+
+bool WarmSwitch::prepareSource(uint32_t index)
+{
+    if (m_prepared[index])
+        return true;
+
+    if (!m_sources[index]->prepare())
+    {
+        // clean up what had been created
+        PROPAGATE_ERROR_CONTINUE(m_sources[index]->release());
+        ORIGINATE_ERROR("Failed to prepare source %u", index);
+    }
+    m_prepared[index] = true;
+
+    return true;
+}
+
+bool WarmSwitch::releaseSource(uint32_t index)
+{
+    if (!m_prepared[index])
+        return true;
+
+    m_prepared[index] = false;
+    PROPAGATE_ERROR(m_sources[index]->release());
+
+    return true;
+}
+
+bool WarmSwitch::switchTo(uint32_t index)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+    if (index >= m_sources.size())
+        ORIGINATE_ERROR("Invalid source index %u", index);
+
+    ScopedMutex ss(m_switchMutex);
+    PROPAGATE_ERROR(ss.expectLocked());
+
+    const uint64_t switchTime = getTime();
+    uint32_t previous = 0;
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        if (index == m_active)
+            return true;
+
+        // no source is shown while the preview is redirected
+        previous = m_active;
+        m_switching = true;
+        m_pending = false;
+        m_stats.switches++;
+    }
+
+    // hide the old source, in cold mode it is replaced by the new one, in warm mode it keeps
+    // capturing and the new one is already running
+    bool ok = m_sources[previous]->setPreview(false);
+    if (ok && !m_warm)
+    {
+        PROPAGATE_ERROR_CONTINUE(releaseSource(previous));
+        ok = prepareSource(index);
+    }
+    if (ok)
+        ok = m_sources[index]->setPreview(true);
+
+    if (!ok)
+    {
+        // show the old source again
+        if (!m_warm)
+        {
+            PROPAGATE_ERROR_CONTINUE(releaseSource(index));
+            PROPAGATE_ERROR_CONTINUE(prepareSource(previous));
+        }
+        PROPAGATE_ERROR_CONTINUE(m_sources[previous]->setPreview(true));
+    }
+
+    const uint64_t now = getTime();
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    m_stats.switchCall.add(now - switchTime);
+    m_switching = false;
+    if (!ok)
+    {
+        m_stats.failed++;
+        PROPAGATE_ERROR(m_cond.broadcast());
+        ORIGINATE_ERROR("Failed to switch to source %u", index);
+    }
+
+    // from now on frames of the new source are shown, the first one completes the switch
+    m_active = index;
+    m_pending = true;
+    m_switchTime = switchTime;
+
+    return true;
+}
+
+bool WarmSwitch::onFrame(uint32_t index, uint64_t timestamp, bool *show)
+{
+    const uint64_t now = getTime();
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    const bool shown = m_initialized && !m_switching && (index == m_active);
+
+    if (show)
+        *show = shown;
+
+    if (!m_initialized)
+        return true;
+
+    if (!shown)
+    {
+        m_stats.hidden++;
+        return true;
+    }
+
+    m_stats.shown++;
+    if (m_pending)
+    {
+        if (m_switchTime != 0)
+        {
+            m_stats.completed++;
+            m_stats.switchToFrame.add((now > m_switchTime) ? (now - m_switchTime) : 0);
+            if (timestamp != 0)
+                m_stats.firstFrameAge.add((now > timestamp) ? (now - timestamp) : 0);
+        }
+        m_pending = false;
+        PROPAGATE_ERROR(m_cond.broadcast());
+    }
+
+    return true;
+}
+
+bool WarmSwitch::waitSwitched(const TimeValue &timeout, bool *switched)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+    if (!switched)
+        ORIGINATE_ERROR("Invalid argument");
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    const uint64_t deadline = getTime() + timeout.toNSec();
+    while ((m_pending || m_switching) && m_initialized)
+    {
+        const uint64_t now = getTime();
+        if (now >= deadline)
+            break;
+
+        bool timedOut = false;
+        PROPAGATE_ERROR(m_cond.timedWait(m_mutex, TimeValue::fromNSec(deadline - now),
+            &timedOut));
+        if (timedOut)
+            break;
+    }
+
+    *switched = !m_pending && !m_switching && m_initialized;
+
+    return true;
+}
+
+bool WarmSwitch::getActive(uint32_t *index)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+    if (!index)
+        ORIGINATE_ERROR("Invalid argument");
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    *index = m_active;
+
+    return true;
+}
+
+bool WarmSwitch::getStats(Stats *stats, bool reset)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+    if (!stats)
+        ORIGINATE_ERROR("Invalid argument");
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    *stats = m_stats;
+    if (reset)
+        m_stats = Stats();
+
+    return true;
+}
+
+}; // namespace ArgusSamples
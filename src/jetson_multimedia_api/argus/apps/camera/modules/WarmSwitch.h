@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WARM_SWITCH_H
+#define WARM_SWITCH_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "ConditionVariable.h"
+#include "LatencyStats.h"
+#include "Mutex.h"
+#include "Util.h"
+
+namespace ArgusSamples
+{
+
+/**
+ * A camera source which can be switched to the preview, e.g. a capture session with its request
+ * and preview output stream.
+ */
+class IWarmSource
+{
+public:
+    virtual ~IWarmSource() {}
+
+    /**
+     * Create the objects of the source and start capturing, the frames are not shown yet.
+     */
+    virtual bool prepare() = 0;
+
+    /**
+     * Route the frames of the source to the preview or away from it.
+     *
+     * @param active [in] if set the frames are shown
+     */
+    virtual bool setPreview(bool active) = 0;
+
+    /**
+     * Stop capturing and destroy the objects of the source. Also called if prepare() failed.
+     */
+    virtual bool release() = 0;
+};
+
+/**
+ * Switches the preview between camera sources. In warm mode all sources are prepared up front
+ * and keep capturing, a switch only redirects the preview to the frames of another source. In
+ * cold mode only the shown source is prepared, a switch releases it and prepares the new one.
+ *
+ * The frame path reports each delivered frame with onFrame(). The time from a switch until the
+ * first frame of the new source had been delivered is the switch latency seen by the user.
+ */
+class WarmSwitch
+{
+public:
+    typedef LatencyStats Latency;
+
+    /**
+     * Statistics
+     */
+    struct Stats
+    {
+        Stats()
+            : switches(0)
+            , completed(0)
+            , failed(0)
+            , shown(0)
+            , hidden(0)
+        {
+        }
+
+        uint32_t switches;          ///< switches requested
+        uint32_t completed;         ///< switches which delivered a frame of the new source
+        uint32_t failed;            ///< switches where the new source failed to prepare
+        uint64_t shown;             ///< frames of the shown source
+        uint64_t hidden;            ///< frames of the other sources
+        Latency switchCall;         ///< time spent in switchTo()
+        Latency switchToFrame;      ///< from the switch until the first frame of the new source
+        Latency firstFrameAge;      ///< from the capture of that frame until it had been delivered
+    };
+
+    WarmSwitch();
+    ~WarmSwitch();
+
+    /**
+     * Prepare the sources and show one of them. The sources are not owned by WarmSwitch and have
+     * to exist until shutdown() returned.
+     *
+     * @param sources [in] the sources to switch between
+     * @param active [in] index of the source shown first
+     * @param warm [in] if set all sources are prepared and kept capturing, else only the shown one
+     */
+    bool initialize(const std::vector<IWarmSource*> &sources, uint32_t active, bool warm);
+
+    /**
+     * Hide the shown source and release all prepared sources.
+     */
+    bool shutdown();
+
+    /**
+     * Show another source. Returns once the preview had been redirected, the first frame of the
+     * new source is reported by onFrame(), see waitSwitched(). A switch to the shown source does
+     * nothing.
+     *
+     * @param index [in] index of the source to show
+     */
+    bool switchTo(uint32_t index);
+
+    /**
+     * Report a frame delivered by a source. Can be called from any thread, but not from within
+     * the IWarmSource methods.
+     *
+     * @param index [in] index of the source
+     * @param timestamp [in] sensor timestamp of the frame in nanoseconds, in the CLOCK_MONOTONIC
+     *                       time base, 0 if not known
+     * @param show [out] optional, set if the frame is from the shown source
+     */
+    bool onFrame(uint32_t index, uint64_t timestamp, bool *show = NULL);
+
+    /**
+     * Wait until the last switch delivered a frame of the new source.
+     *
+     * @param timeout [in] the longest time to wait
+     * @param switched [out] set if the frame arrived, cleared on timeout
+     */
+    bool waitSwitched(const TimeValue &timeout, bool *switched);
+
+    /**
+     * @returns the number of sources
+     */
+    uint32_t getSourceCount() const
+    {
+        return static_cast<uint32_t>(m_sources.size());
+    }
+
+    /**
+     * Get the index of the shown source.
+     *
+     * @param index [out] index of the shown source
+     */
+    bool getActive(uint32_t *index);
+
+    /**
+     * Get the statistics.
+     *
+     * @param stats [out] statistics
+     * @param reset [in] if set the statistics are reset
+     */
+    bool getStats(Stats *stats, bool reset = false);
+
+    /**
+     * @returns the current CLOCK_MONOTONIC time in nanoseconds, the time base of the frame
+     * timestamps
+     */
+    static uint64_t getTime()
+    {
+        return getMonotonicTime();
+    }
+
+private:
+    bool m_initialized;
+    bool m_warm;
+    std::vector<IWarmSource*> m_sources;
+    std::vector<bool> m_prepared;       ///< set for the sources which are capturing
+
+    /**
+     * Serializes switches. The sources are called with this lock held and without holding
+     * m_mutex so that onFrame() is not blocked by a slow switch.
+     */
+    Mutex m_switchMutex;
+
+    Mutex m_mutex;                      ///< protects the members below
+    ConditionVariable m_cond;           ///< broadcast when a switch delivered its first frame
+    uint32_t m_active;                  ///< index of the shown source
+    bool m_switching;                   ///< set while the preview is redirected
+    bool m_pending;                     ///< set until the first frame of the shown source
+    uint64_t m_switchTime;              ///< time of the last switch, 0 for the first source
+    Stats m_stats;
+
+    /**
+     * Prepare a source, the source is released if this fails.
+     */
+    bool prepareSource(uint32_t index);
+
+    /**
+     * Release a prepared source.
+     */
+    bool releaseSource(uint32_t index);
+
+    /**
+     * Hide copy constructor and assignment operator
+     */
+    WarmSwitch(const WarmSwitch&);
+    WarmSwitch& operator=(const WarmSwitch&);
+};
+
+}; // namespace ArgusSamples
+
+#endif // WARM_SWITCH_H
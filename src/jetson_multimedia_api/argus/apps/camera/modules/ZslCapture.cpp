@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ZslCapture.h"
+#include "Error.h"
+
+namespace ArgusSamples
+{
+
+// frames used to measure the offset between the frame and the CLOCK_MONOTONIC time base, the
+// smallest difference of these filters the scheduling delays and follows a slow clock drift
+static const size_t CLOCK_OFFSET_FRAMES = 32;
+
+/**
+ * Encodes and writes the shots.
+ */
+class ZslCapture::Writer : public Thread
+{
+public:
+    explicit Writer(ZslCapture *zslCapture)
+        : m_zslCapture(zslCapture)
+    {
+    }
+
+protected:
+    virtual bool threadInitialize()
+    {
+        return true;
+    }
+
+    virtual bool threadExecute()
+    {
+        bool done = false;
+
+        PROPAGATE_ERROR(m_zslCapture->writeNext(&done));
+        if (done)
+            PROPAGATE_ERROR(requestShutdown());
+
+        return true;
+    }
+
+    virtual bool threadShutdown()
+    {
+        return true;
+    }
+
+private:
+    ZslCapture *m_zslCapture;
+};
+
+ZslCapture::ZslCapture()
+    : m_initialized(false)
+    , m_stopping(false)
+    , m_writing(false)
+    , m_ringSize(0)
+    , m_clockOffset(0)
+{
+}
+
+ZslCapture::~ZslCapture()
+{
+    shutdown();
+}
+
+bool ZslCapture::initialize(uint32_t ringSize, const TimeValue &maxWait)
+{
+    if (m_initialized)
+        return true;
+
+    if (ringSize == 0)
+        ORIGINATE_ERROR("The ring needs to hold at least one frame");
+
+    PROPAGATE_ERROR(m_mutex.initialize());
+    PROPAGATE_ERROR(m_cond.initialize());
+
+    m_ringSize = ringSize;
+    m_maxWait = maxWait;
+    m_stopping = false;
+    m_writing = false;
+    m_clockOffsets.clear();
+    m_clockOffset = 0;
+    m_stats = Stats();
+
+    m_writer.reset(new Writer(this));
+    if (!m_writer)
+        ORIGINATE_ERROR("Out of memory");
+
+    m_writer->setThreadRole("stillwriter");
+    PROPAGATE_ERROR(m_writer->initialize());
+    PROPAGATE_ERROR(m_writer->waitRunning());
+
+    m_initialized = true;
+
+    return true;
+}
+
+bool ZslCapture::shutdown()
+{
+    if (!m_initialized)
+        return true;
+
+    // the writer thread writes the pending shots and then exits
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR_CONTINUE(sm.expectLocked());
+
+        m_stopping = true;
+        PROPAGATE_ERROR_CONTINUE(m_cond.broadcast());
+    }
+
+    PROPAGATE_ERROR_CONTINUE(m_writer->shutdown());
+    m_writer.reset();
+
+    // shots are only left if the writer thread failed
+    while (!m_shots.empty())
+    {
+        delete m_shots.front().frame;
+        m_shots.pop_front();
+    }
+    while (!m_ring.empty())
+    {
+        delete m_ring.front().frame;
+        m_ring.pop_front();
+    }
+
+    PROPAGATE_ERROR_CONTINUE(m_cond.shutdown());
+    PROPAGATE_ERROR_CONTINUE(m_mutex.shutdown());
+
+    m_initialized = false;
+
+    return true;
+}
+
+bool ZslCapture::pushFrame(IZslFrame *frame)
+{
+    UniquePointer<IZslFrame> newFrame(frame);
+    // the oldest frame is released outside of the lock, this returns its buffer to the stream
+    UniquePointer<IZslFrame> oldFrame;
+
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+    if (!frame)
+        ORIGINATE_ERROR("Invalid frame");
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        if (m_ring.size() == m_ringSize)
+        {
+            oldFrame.reset(m_ring.front().frame);
+            m_ring.pop_front();
+        }
+
+        Entry entry;
+        entry.frame = newFrame.release();
+        entry.timestamp = entry.frame->getTimestamp();
+        entry.arrivalTime = getTime();
+        m_ring.push_back(entry);
+
+        // the time bases differ, e.g. sensor timestamps don't use CLOCK_MONOTONIC
+        if (m_clockOffsets.size() == CLOCK_OFFSET_FRAMES)
+            m_clockOffsets.pop_front();
+        m_clockOffsets.push_back(static_cast<int64_t>(entry.arrivalTime - entry.timestamp));
+        m_clockOffset = m_clockOffsets.front();
+        for (std::deque<int64_t>::const_iterator it = m_clockOffsets.begin();
+             it != m_clockOffsets.end(); ++it)
+        {
+            if (*it < m_clockOffset)
+                m_clockOffset = *it;
+        }
+
+        PROPAGATE_ERROR(m_cond.broadcast());
+    }
+
+    return true;
+}
+
+bool ZslCapture::shutter(uint64_t shutterTime, const char *fileName, StillFileType fileType,
+    uint64_t *frameTime)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    m_stats.shots++;
+
+    // A frame captured after the press may be closer than the last frame of the ring. That frame
+    // is at most as far after the press as the last frame is before it, wait until it had been
+    // delivered or can't be closer anymore.
+    const uint64_t maxDeadline = shutterTime + m_maxWait.toNSec();
+    while (m_ring.empty() || (getFrameTime(m_ring.back()) < shutterTime))
+    {
+        uint64_t deadline = maxDeadline;
+        if (!m_ring.empty())
+        {
+            // delivery delay beyond the smallest one, which is part of the frame time
+            uint64_t deliveryLatency = 0;
+            for (std::deque<Entry>::const_iterator it = m_ring.begin(); it != m_ring.end(); ++it)
+            {
+                const uint64_t frameTime = getFrameTime(*it);
+                if ((it->arrivalTime > frameTime) &&
+                    (it->arrivalTime - frameTime > deliveryLatency))
+                {
+                    deliveryLatency = it->arrivalTime - frameTime;
+                }
+            }
+            const uint64_t closerUntil =
+                2 * shutterTime - getFrameTime(m_ring.back()) + deliveryLatency;
+            if (closerUntil < deadline)
+                deadline = closerUntil;
+        }
+
+        const uint64_t now = getTime();
+        if (m_stopping || (now >= deadline))
+            break;
+
+        bool timedOut = false;
+        PROPAGATE_ERROR(m_cond.timedWait(m_mutex, TimeValue::fromNSec(deadline - now),
+            &timedOut));
+        if (timedOut)
+            break;
+    }
+
+    if (m_ring.empty())
+    {
+        m_stats.failed++;
+        ORIGINATE_ERROR("No frame available");
+    }
+
+    // pick the closest frame, on a tie the earlier one
+    std::deque<Entry>::iterator closest = m_ring.end();
+    uint64_t closestOffset = 0;
+    for (std::deque<Entry>::iterator it = m_ring.begin(); it != m_ring.end(); ++it)
+    {
+        const uint64_t frameTime = getFrameTime(*it);
+        const uint64_t offset = (frameTime > shutterTime) ?
+            (frameTime - shutterTime) : (shutterTime - frameTime);
+        if ((closest == m_ring.end()) || (offset < closestOffset))
+        {
+            closest = it;
+            closestOffset = offset;
+        }
+    }
+
+    // the frame leaves the ring, it is released by the writer thread
+    Shot shot;
+    const uint64_t closestTime = getFrameTime(*closest);
+    shot.frame = closest->frame;
+    shot.fileName = fileName;
+    shot.fileType = fileType;
+    shot.shutterTime = shutterTime;
+    m_ring.erase(closest);
+    m_shots.push_back(shot);
+
+    if (frameTime)
+        *frameTime = closestTime;
+
+    const uint64_t now = getTime();
+    m_stats.shutterToFrame.add((now > shutterTime) ? (now - shutterTime) : 0);
+    m_stats.frameOffset.add(closestOffset);
+
+    PROPAGATE_ERROR(m_cond.broadcast());
+
+    return true;
+}
+
+bool ZslCapture::writeNext(bool *done)
+{
+    Shot shot;
+
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        while (m_shots.empty() && !m_stopping)
+            PROPAGATE_ERROR(m_cond.wait(m_mutex));
+
+        if (m_shots.empty())
+        {
+            *done = true;
+            return true;
+        }
+
+        shot = m_shots.front();
+        m_shots.pop_front();
+        m_writing = true;
+    }
+
+    // encode and write without holding the lock so that frames can be added to the ring and
+    // further shots can be taken
+    const bool written = shot.frame->write(shot.fileName.c_str(), shot.fileType);
+    delete shot.frame;
+    const uint64_t now = getTime();
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    if (written)
+    {
+        m_stats.written++;
+        m_stats.shutterToFile.add((now > shot.shutterTime) ? (now - shot.shutterTime) : 0);
+    }
+    else
+    {
+        m_stats.failed++;
+        REPORT_ERROR("Failed to write '%s'", shot.fileName.c_str());
+    }
+    m_writing = false;
+
+    PROPAGATE_ERROR(m_cond.broadcast());
+
+    return true;
+}
+
+bool ZslCapture::waitIdle()
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    while (!m_shots.empty() || m_writing)
+        PROPAGATE_ERROR(m_cond.wait(m_mutex));
+
+    return true;
+}
+
+bool ZslCapture::getStats(Stats *stats, bool reset)
+{
+    if (!m_initialized)
+        ORIGINATE_ERROR("Not initialized");
+    if (!stats)
+        ORIGINATE_ERROR("Invalid argument");
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    *stats = m_stats;
+    if (reset)
+        m_stats = Stats();
+
+    return true;
+}
+
+}; // namespace ArgusSamples
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ZSL_CAPTURE_H
+#define ZSL_CAPTURE_H
+
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+
+#include "ConditionVariable.h"
+#include "LatencyStats.h"
+#include "Mutex.h"
+#include "Thread.h"
+#include "UniquePointer.h"
+#include "Util.h"
+
+namespace ArgusSamples
+{
+
+/**
+ * A frame held by ZslCapture.
+ */
+class IZslFrame
+{
+public:
+    virtual ~IZslFrame() {}
+
+    /**
+     * @returns the timestamp of the frame in nanoseconds, e.g. the sensor timestamp. The time base
+     * can differ from the one of getTime(), only the distance between frames is used.
+     */
+    virtual uint64_t getTimestamp() const = 0;
+
+    /**
+     * Encode the frame and write it to a file. Called on the writer thread.
+     *
+     * @param fileName [in] file name
+     * @param fileType [in] file type
+     */
+    virtual bool write(const char *fileName, StillFileType fileType) = 0;
+};
+
+/**
+ * Zero shutter lag still capture. A persistent stream feeds the most recent frames into a
+ * small ring, a shutter press takes the frame whose timestamp is closest to the press out of the
+ * ring and a writer thread encodes and writes it to a file while the next shots are taken.
+ *
+ * The frame timestamps are moved to the CLOCK_MONOTONIC time base of the shutter press with the
+ * smallest difference between the arrival time and the timestamp of the recent frames. A frame is
+ * therefore placed at the earliest time it could have been delivered.
+ */
+class ZslCapture
+{
+public:
+    typedef LatencyStats Latency;
+
+    /**
+     * Statistics
+     */
+    struct Stats
+    {
+        Stats()
+            : shots(0)
+            , written(0)
+            , failed(0)
+        {
+        }
+
+        uint32_t shots;             ///< shutter presses
+        uint32_t written;           ///< files written
+        uint32_t failed;            ///< shots without a frame or with a failed write
+        Latency shutterToFrame;     ///< from the shutter press until the frame had been picked
+        Latency shutterToFile;      ///< from the shutter press until the file had been written
+        Latency frameOffset;        ///< distance of the picked frame from the shutter press
+    };
+
+    ZslCapture();
+    ~ZslCapture();
+
+    /**
+     * Start the writer thread.
+     *
+     * @param ringSize [in] number of recent frames to hold
+     * @param maxWait [in] the longest time a shutter press waits for a frame, this bounds the
+     *                     shutter lag if the stream stalls
+     */
+    bool initialize(uint32_t ringSize, const TimeValue &maxWait);
+
+    /**
+     * Write the pending shots, stop the writer thread and release the frames of the ring.
+     */
+    bool shutdown();
+
+    /**
+     * Add a frame to the ring, the oldest frame is released if the ring is full. Frames have to
+     * be pushed in capture order. Ownership of the frame is passed to ZslCapture, also on
+     * failure.
+     *
+     * @param frame [in] frame
+     */
+    bool pushFrame(IZslFrame *frame);
+
+    /**
+     * Take a shot. Picks the frame closest to the shutter press and queues it for writing. If no
+     * frame captured at or after the press is in the ring yet, one may still be delivered that is
+     * closer than the last frame. Waits for it as long as a closer frame can arrive, judged by the
+     * delivery latency of the frames in the ring, but not longer than 'maxWait'. Returns once the
+     * frame had been picked, the file is written asynchronously.
+     *
+     * @param shutterTime [in] time of the shutter press, see getTime()
+     * @param fileName [in] file name
+     * @param fileType [in] file type
+     * @param frameTime [out] optional, time of the picked frame in the time base of getTime()
+     */
+    bool shutter(uint64_t shutterTime, const char *fileName, StillFileType fileType,
+        uint64_t *frameTime = NULL);
+
+    /**
+     * Wait until all queued shots had been written.
+     */
+    bool waitIdle();
+
+    /**
+     * Get the statistics.
+     *
+     * @param stats [out] statistics
+     * @param reset [in] if set the statistics are reset
+     */
+    bool getStats(Stats *stats, bool reset = false);
+
+    /**
+     * @returns the current CLOCK_MONOTONIC time in nanoseconds, the time base of the shutter
+     * press and of the frame timestamps
+     */
+    static uint64_t getTime()
+    {
+        return getMonotonicTime();
+    }
+
+private:
+    class Writer;
+
+    /**
+     * A frame in the ring
+     */
+    struct Entry
+    {
+        IZslFrame *frame;
+        uint64_t timestamp;             ///< frame timestamp, in the time base of the frame
+        uint64_t arrivalTime;           ///< time the frame had been pushed
+    };
+
+    /**
+     * A shot waiting to be written
+     */
+    struct Shot
+    {
+        IZslFrame *frame;
+        std::string fileName;
+        StillFileType fileType;
+        uint64_t shutterTime;
+    };
+
+    bool m_initialized;
+    bool m_stopping;                    ///< set when shutting down, no new shots are accepted
+    bool m_writing;                     ///< set while the writer thread writes a shot
+    uint32_t m_ringSize;
+    TimeValue m_maxWait;
+
+    Mutex m_mutex;                      ///< protects the members below
+    ConditionVariable m_cond;           ///< broadcast on new frames, shots and written files
+    std::deque<Entry> m_ring;           ///< recent frames, oldest first
+    std::deque<int64_t> m_clockOffsets; ///< arrival time minus timestamp of the recent frames
+    int64_t m_clockOffset;              ///< from the frame time base to the one of getTime()
+    std::deque<Shot> m_shots;           ///< shots waiting to be written
+    Stats m_stats;
+
+    UniquePointer<Writer> m_writer;
+
+    /**
+     * @returns the time of a frame of the ring in the time base of getTime()
+     */
+    uint64_t getFrameTime(const Entry &entry) const
+    {
+        return entry.timestamp + m_clockOffset;
+    }
+
+    /**
+     * Write the next shot, called by the writer thread.
+     *
+     * @param done [out] set if the queue is empty and shutdown had been requested
+     */
+    bool writeNext(bool *done);
+
+    /**
+     * Hide copy constructor and assignment operator
+     */
+    ZslCapture(const ZslCapture&);
+    ZslCapture& operator=(const ZslCapture&);
+};
+
+}; // namespace ArgusSamples
+
+#endif // ZSL_CAPTURE_H
@@ -26,17 +26,354 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#define GL_GLEXT_PROTOTYPES
+
+#include <GLES3/gl31.h>
+#include <GLES2/gl2ext.h>
+
 #include <sstream>
+#include <vector>
+
+#include <Argus/Argus.h>
+#include <EGLStream/EGLStream.h>
 
 #include "MultiExposure.h"
 #include "Composer.h"
 #include "Dispatcher.h"
+#include "EGLGlobal.h"
 #include "Error.h"
+#include "ExposureFusion.h"
+#include "GLContext.h"
+#include "PerfTracker.h"
+#include "Thread.h"
 #include "UniquePointer.h"
 
 namespace ArgusSamples
 {
 
+/**
+ * Acquires one frame of each exposure level, fuses them and renders the fused image to an EGL
+ * stream which is displayed by the composer.
+ */
+class ExposureFusionThread : public Thread
+{
+public:
+    ExposureFusionThread(const std::vector<Argus::OutputStream*> &streams,
+        const Argus::Size2D<uint32_t> &size)
+        : m_streams(streams)
+        , m_size(size)
+        , m_eglOutputSurface(EGL_NO_SURFACE)
+        , m_program(0)
+        , m_vbo(0)
+        , m_active(false)
+        , m_fused(0)
+        , m_overBudget(0)
+    {
+        m_textures[0] = m_textures[1] = 0;
+    }
+
+protected:
+    virtual bool threadInitialize()
+    {
+        Composer &composer = Composer::getInstance();
+        const uint32_t width = m_size.width();
+        const uint32_t height = m_size.height();
+
+        // the consumers need to be connected before the captures start
+        for (std::vector<Argus::OutputStream*>::iterator it = m_streams.begin();
+             it != m_streams.end(); ++it)
+        {
+            EGLStream::FrameConsumer *consumer = EGLStream::FrameConsumer::create(*it);
+            if (!consumer)
+                ORIGINATE_ERROR("Failed to create FrameConsumer");
+            m_consumers.push_back(consumer);
+        }
+        m_frames.assign(m_consumers.size(), NULL);
+        m_images.resize(m_consumers.size());
+
+        PROPAGATE_ERROR(m_fusion.initialize(width, height, m_consumers.size()));
+        m_output.resize(width * height * 3 / 2);
+
+        // create the EGL output stream and bind it to the composer
+        PROPAGATE_ERROR(m_eglOutputStream.create(composer.getEGLDisplay()));
+        CHECK_STREAM_STATE(m_eglOutputStream, CREATED);
+        PROPAGATE_ERROR(composer.bindStream(m_eglOutputStream.get()));
+        PROPAGATE_ERROR(composer.setStreamAspectRatio(m_eglOutputStream.get(),
+            (float)width / (float)height));
+        CHECK_STREAM_STATE(m_eglOutputStream, CONNECTING);
+
+        // create a EGL context and the output surface connected to the EGL output stream
+        PROPAGATE_ERROR(m_context.initialize(composer.getEGLDisplay()));
+        PROPAGATE_ERROR(m_context.createEGLStreamProducerSurface(&m_eglOutputSurface,
+            m_eglOutputStream.get(), width, height));
+        CHECK_STREAM_STATE(m_eglOutputStream, EMPTY);
+        PROPAGATE_ERROR(m_context.makeCurrent(m_eglOutputSurface));
+
+        // luma and interleaved chroma textures
+        glGenTextures(2, m_textures);
+        for (uint32_t plane = 0; plane < 2; ++plane)
+        {
+            if (m_textures[plane] == 0)
+                ORIGINATE_ERROR("Failed to create GL texture");
+            glBindTexture(GL_TEXTURE_2D, m_textures[plane]);
+            glTexStorage2D(GL_TEXTURE_2D, 1, (plane == 0) ? GL_R8 : GL_RG8, width >> plane,
+                height >> plane);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        static const char vtxSrc[] =
+            "#version 300 es\n"
+            "in layout(location = 0) vec2 vertex;\n"
+            "out vec2 vTexCoord;\n"
+            "void main() {\n"
+            "  gl_Position = vec4(vertex * 2.0 - 1.0, 0.0, 1.0);\n"
+            "  vTexCoord = vertex;\n"
+            "}\n";
+
+        // BT.601 limited range YUV to RGB
+        static const char yuvFrgSrc[] =
+            "#version 300 es\n"
+            "precision highp float;\n"
+            "uniform sampler2D lumaSampler;\n"
+            "uniform sampler2D chromaSampler;\n"
+            "in vec2 vTexCoord;\n"
+            "out vec4 fragColor;\n"
+            "void main() {\n"
+            "  float y = 1.164 * (texture(lumaSampler, vTexCoord).r - 0.0625);\n"
+            "  vec2 c = texture(chromaSampler, vTexCoord).rg - 0.5;\n"
+            "  fragColor = vec4(y + 1.596 * c.y, y - 0.391 * c.x - 0.813 * c.y,\n"
+            "    y + 2.018 * c.x, 1.0);\n"
+            "}\n";
+        PROPAGATE_ERROR(m_context.createProgram(vtxSrc, yuvFrgSrc, &m_program));
+        glUseProgram(m_program);
+        glUniform1i(glGetUniformLocation(m_program, "lumaSampler"), 0);
+        glUniform1i(glGetUniformLocation(m_program, "chromaSampler"), 1);
+
+        static const GLfloat vertices[] =
+        {
+             0.0f, 0.0f,
+             0.0f, 1.0f,
+             1.0f, 0.0f,
+             1.0f, 1.0f,
+        };
+        glGenBuffers(1, &m_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+        glEnableVertexAttribArray(0);
+
+        m_statsStartTime = getCurrentTime();
+
+        return true;
+    }
+
+    virtual bool threadExecute()
+    {
+        // Acquire the frame of each level, the burst is fused within the time it takes to
+        // capture the next one. The streams are mailboxes so a fusion which takes too long
+        // drops bursts instead of increasing the latency.
+        uint64_t budget = 0;
+        for (uint32_t index = 0; index < m_consumers.size(); ++index)
+        {
+            EGLStream::IFrameConsumer *iFrameConsumer =
+                Argus::interface_cast<EGLStream::IFrameConsumer>(m_consumers[index]);
+            if (!iFrameConsumer)
+                ORIGINATE_ERROR("Failed to get IFrameConsumer interface");
+
+            // use a time out to allow the thread to be shutdown even if there are no new frames
+            Argus::Status status = Argus::STATUS_OK;
+            m_frames[index] =
+                iFrameConsumer->acquireFrame(TimeValue::fromMSec(100).toNSec(), &status);
+            if (!m_frames[index])
+            {
+                releaseFrames();
+                if (status == Argus::STATUS_TIMEOUT)
+                    return true;
+                if (status == Argus::STATUS_DISCONNECTED)
+                    return requestShutdown();
+                ORIGINATE_ERROR("Failed to acquire frame");
+            }
+
+            PROPAGATE_ERROR(mapFrame(m_frames[index], &m_images[index], &budget));
+        }
+
+        ExposureFusion::Image output;
+        output.luma.data = &m_output[0];
+        output.luma.pitch = m_size.width();
+        output.chroma.data = &m_output[m_size.width() * m_size.height()];
+        output.chroma.pitch = m_size.width();
+
+        ExposureFusion::Timings timings;
+        const bool fused = m_fusion.fuse(&m_images[0], output, &timings);
+        releaseFrames();
+        PROPAGATE_ERROR(fused);
+
+        // upload and draw, the swap puts the image into the output EGL stream
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_textures[0]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_size.width(), m_size.height(), GL_RED,
+            GL_UNSIGNED_BYTE, output.luma.data);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, m_textures[1]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_size.width() / 2, m_size.height() / 2, GL_RG,
+            GL_UNSIGNED_BYTE, output.chroma.data);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        PROPAGATE_ERROR(m_context.swapBuffers(m_eglOutputSurface));
+
+        if (!m_active)
+        {
+            PROPAGATE_ERROR(Composer::getInstance().setStreamActive(m_eglOutputStream.get(),
+                true));
+            m_active = true;
+        }
+
+        m_timings.weights += timings.weights;
+        m_timings.pyramid += timings.pyramid;
+        m_timings.collapse += timings.collapse;
+        m_timings.total += timings.total;
+        ++m_fused;
+        if ((budget != 0) && (timings.total > budget))
+            ++m_overBudget;
+
+        // report the statistics once a second
+        const TimeValue now = getCurrentTime();
+        if (now < m_statsStartTime + TimeValue::fromSec(1.f))
+            return true;
+
+        PROPAGATE_ERROR(PerfTracker::getInstance().onFusionStats(m_timings, m_fused,
+            m_overBudget, now - m_statsStartTime));
+        m_timings = ExposureFusion::Timings();
+        m_fused = 0;
+        m_overBudget = 0;
+        m_statsStartTime = now;
+
+        return true;
+    }
+
+    virtual bool threadShutdown()
+    {
+        Composer &composer = Composer::getInstance();
+
+        releaseFrames();
+        for (std::vector<EGLStream::FrameConsumer*>::iterator it = m_consumers.begin();
+             it != m_consumers.end(); ++it)
+        {
+            (*it)->destroy();
+        }
+        m_consumers.clear();
+
+        if (m_active)
+        {
+            PROPAGATE_ERROR_CONTINUE(composer.setStreamActive(m_eglOutputStream.get(), false));
+            m_active = false;
+        }
+
+        if (m_eglOutputSurface != EGL_NO_SURFACE)
+        {
+            eglDestroySurface(composer.getEGLDisplay(), m_eglOutputSurface);
+            m_eglOutputSurface = EGL_NO_SURFACE;
+        }
+
+        if (m_eglOutputStream.get() != EGL_NO_STREAM_KHR)
+        {
+            // unbind the EGL output stream from the composer and destroy it
+            PROPAGATE_ERROR_CONTINUE(composer.unbindStream(m_eglOutputStream.get()));
+            PROPAGATE_ERROR_CONTINUE(m_eglOutputStream.destroy());
+        }
+
+        // free GL resources
+        glDeleteTextures(2, m_textures);
+        m_textures[0] = m_textures[1] = 0;
+        glDeleteProgram(m_program);
+        m_program = 0;
+        glDeleteBuffers(1, &m_vbo);
+        m_vbo = 0;
+
+        PROPAGATE_ERROR_CONTINUE(m_context.cleanup());
+        PROPAGATE_ERROR_CONTINUE(m_fusion.shutdown());
+
+        return true;
+    }
+
+private:
+    std::vector<Argus::OutputStream*> m_streams;
+    Argus::Size2D<uint32_t> m_size;
+    std::vector<EGLStream::FrameConsumer*> m_consumers;
+    std::vector<EGLStream::Frame*> m_frames;        ///< frames of the current burst
+    std::vector<ExposureFusion::Image> m_images;    ///< mapped frames of the current burst
+    std::vector<uint8_t> m_output;                  ///< fused NV12 image
+
+    ExposureFusion m_fusion;
+
+    GLContext m_context;
+    EGLSurface m_eglOutputSurface;
+    EGLStreamHolder m_eglOutputStream;
+    GLuint m_textures[2];
+    GLuint m_program;
+    GLuint m_vbo;
+    bool m_active;                      ///< set if the output stream is active in the composer
+
+    // statistics of the current interval
+    TimeValue m_statsStartTime;
+    ExposureFusion::Timings m_timings;
+    uint32_t m_fused;
+    uint32_t m_overBudget;
+
+    /**
+     * Map the planes of a frame and add its frame duration to the time budget.
+     */
+    bool mapFrame(EGLStream::Frame *frame, ExposureFusion::Image *image, uint64_t *budget)
+    {
+        EGLStream::IFrame *iFrame = Argus::interface_cast<EGLStream::IFrame>(frame);
+        if (!iFrame)
+            ORIGINATE_ERROR("Failed to get IFrame interface");
+
+        EGLStream::IImage *iImage = Argus::interface_cast<EGLStream::IImage>(iFrame->getImage());
+        EGLStream::IImage2D *iImage2D =
+            Argus::interface_cast<EGLStream::IImage2D>(iFrame->getImage());
+        if (!iImage || !iImage2D)
+            ORIGINATE_ERROR("Failed to get IImage interfaces");
+        if ((iImage->getBufferCount() != 2) || (iImage2D->getSize(0) != m_size))
+            ORIGINATE_ERROR("Unexpected image layout");
+
+        // the fusion only reads the inputs
+        image->luma.data = static_cast<uint8_t*>(const_cast<void*>(iImage->mapBuffer(0u)));
+        image->luma.pitch = iImage2D->getStride(0);
+        image->chroma.data = static_cast<uint8_t*>(const_cast<void*>(iImage->mapBuffer(1u)));
+        image->chroma.pitch = iImage2D->getStride(1);
+        if (!image->luma.data || !image->chroma.data)
+            ORIGINATE_ERROR("Failed to map the image");
+
+        EGLStream::IArgusCaptureMetadata *iArgusCaptureMetadata =
+            Argus::interface_cast<EGLStream::IArgusCaptureMetadata>(frame);
+        if (iArgusCaptureMetadata)
+        {
+            const Argus::ICaptureMetadata *iCaptureMetadata =
+                Argus::interface_cast<const Argus::ICaptureMetadata>(
+                    iArgusCaptureMetadata->getMetadata());
+            if (iCaptureMetadata)
+                *budget += iCaptureMetadata->getFrameDuration();
+        }
+
+        return true;
+    }
+
+    void releaseFrames()
+    {
+        for (std::vector<EGLStream::Frame*>::iterator it = m_frames.begin(); it != m_frames.end();
+             ++it)
+        {
+            if (*it)
+            {
+                (*it)->destroy();
+                *it = NULL;
+            }
+        }
+    }
+};
+
 TaskMultiExposure::TaskMultiExposure()
     : m_exposureStepsRange(3)
     , m_exposureSteps(new ValidatorRange<uint32_t>(&m_exposureStepsRange), 3)
@@ -45,6 +382,7 @@ TaskMultiExposure::TaskMultiExposure()
             Argus::Range<float>(-10.0f, 10.0f),
             Argus::Range<float>(-10.0f, 10.0f)),
         Argus::Range<float>(-2.0f, 2.0f))
+    , m_fusion(false)
     , m_initialized(false)
     , m_running(false)
     , m_wasRunning(false)
@@ -58,6 +396,7 @@ TaskMultiExposure::~TaskMultiExposure()
 }
 
 TaskMultiExposure::ExpLevel::ExpLevel()
+    : m_display(false)
 {
 }
 
@@ -66,7 +405,7 @@ TaskMultiExposure::ExpLevel::~ExpLevel()
     shutdown();
 }
 
-bool TaskMultiExposure::ExpLevel::initialize(float exposureCompensation)
+bool TaskMultiExposure::ExpLevel::initialize(float exposureCompensation, bool display)
 {
     Composer &composer = Composer::getInstance();
     Dispatcher &dispatcher = Dispatcher::getInstance();
@@ -92,20 +431,24 @@ bool TaskMultiExposure::ExpLevel::initialize(float exposureCompensation)
     if (iAutoControlSettings->setExposureCompensation(exposureCompensation) != Argus::STATUS_OK)
         ORIGINATE_ERROR("Failed to set exposure compensation");
 
-    // Create the preview stream
-    PROPAGATE_ERROR(dispatcher.createOutputStream(m_request.get(), false, m_outputStream));
+    // Create the preview stream, the fusion uses the frame durations of the metadata
+    PROPAGATE_ERROR(dispatcher.createOutputStream(m_request.get(), !display, m_outputStream));
 
     Argus::IEGLOutputStream *iEGLOutputStream =
         Argus::interface_cast<Argus::IEGLOutputStream>(m_outputStream.get());
     if (!iEGLOutputStream)
         ORIGINATE_ERROR("Failed to get IEGLOuptutStream interface");
 
-    // Bind the stream to the composer
-    PROPAGATE_ERROR(composer.bindStream(iEGLOutputStream->getEGLStream()));
+    if (display)
+    {
+        // Bind the stream to the composer
+        PROPAGATE_ERROR(composer.bindStream(iEGLOutputStream->getEGLStream()));
+        m_display = true;
 
-    const Argus::Size2D<uint32_t> streamSize = iEGLOutputStream->getResolution();
-    PROPAGATE_ERROR(composer.setStreamAspectRatio(iEGLOutputStream->getEGLStream(),
-        (float)streamSize.width() / (float)streamSize.height()));
+        const Argus::Size2D<uint32_t> streamSize = iEGLOutputStream->getResolution();
+        PROPAGATE_ERROR(composer.setStreamAspectRatio(iEGLOutputStream->getEGLStream(),
+            (float)streamSize.width() / (float)streamSize.height()));
+    }
 
     // Enable the output stream
     PROPAGATE_ERROR(dispatcher.enableOutputStream(m_request.get(), m_outputStream.get()));
@@ -135,7 +478,11 @@ bool TaskMultiExposure::ExpLevel::shutdown()
             iEGLOutputStream->disconnect();
 
             // unbind the EGL stream from the composer
-            PROPAGATE_ERROR_CONTINUE(composer.unbindStream(iEGLOutputStream->getEGLStream()));
+            if (m_display)
+            {
+                PROPAGATE_ERROR_CONTINUE(composer.unbindStream(iEGLOutputStream->getEGLStream()));
+                m_display = false;
+            }
 
             m_outputStream.reset();
         }
@@ -168,6 +515,8 @@ bool TaskMultiExposure::initialize()
         static_cast<IObserver::CallbackFunction>(&TaskMultiExposure::onParametersChanged)));
     PROPAGATE_ERROR(m_exposureSteps.registerObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiExposure::onParametersChanged)));
+    PROPAGATE_ERROR(m_fusion.registerObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskMultiExposure::onParametersChanged)));
     PROPAGATE_ERROR(dispatcher.m_captureYuvFormat.registerObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiExposure::restartStreams)));
 
@@ -184,6 +533,8 @@ bool TaskMultiExposure::shutdown()
 
     Dispatcher &dispatcher = Dispatcher::getInstance();
 
+    PROPAGATE_ERROR_CONTINUE(m_fusion.unregisterObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskMultiExposure::onParametersChanged)));
     PROPAGATE_ERROR_CONTINUE(m_exposureSteps.unregisterObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiExposure::onParametersChanged)));
     PROPAGATE_ERROR_CONTINUE(m_exposureRange.unregisterObserver(this,
@@ -298,6 +649,12 @@ bool TaskMultiExposure::start()
     if (m_running)
         return true;
 
+    Dispatcher &dispatcher = Dispatcher::getInstance();
+    const bool fusion = m_fusion.get();
+
+    if (fusion && (dispatcher.m_captureYuvFormat.get() != Argus::PIXEL_FMT_YCbCr_420_888))
+        ORIGINATE_ERROR("Exposure fusion needs the 8 bit YUV 420 capture format");
+
     if (m_expLevels.empty())
     {
         std::ostringstream message;
@@ -317,7 +674,7 @@ bool TaskMultiExposure::start()
                 (m_exposureRange.get().max() - m_exposureRange.get().min()) +
                 m_exposureRange.get().min();
 
-            PROPAGATE_ERROR(expLevel->initialize(exposureCompensation));
+            PROPAGATE_ERROR(expLevel->initialize(exposureCompensation, !fusion));
 
             m_expLevels.push_back(expLevel.release());
 
@@ -326,24 +683,48 @@ bool TaskMultiExposure::start()
             message << exposureCompensation << " ev";
         }
 
-        message << ". " << std::endl;
-        Dispatcher::getInstance().message(message.str().c_str());
+        message << ". ";
+        if (fusion)
+            message << "Fusing them into one image.";
+        message << std::endl;
+        dispatcher.message(message.str().c_str());
     }
 
     // activate the streams and populate the burst request array
     std::vector<const Argus::Request*> requests;
+    std::vector<Argus::OutputStream*> streams;
     Composer &composer = Composer::getInstance();
     for (std::list<ExpLevel*>::iterator it = m_expLevels.begin(); it != m_expLevels.end(); ++it)
     {
         ExpLevel *expLevel = *it;
-        PROPAGATE_ERROR(composer.setStreamActive(
-            Argus::interface_cast<Argus::IEGLOutputStream>
-                (expLevel->m_outputStream)->getEGLStream(), true));
+        if (expLevel->m_display)
+        {
+            PROPAGATE_ERROR(composer.setStreamActive(
+                Argus::interface_cast<Argus::IEGLOutputStream>
+                    (expLevel->m_outputStream)->getEGLStream(), true));
+        }
         requests.push_back(expLevel->m_request.get());
+        streams.push_back(expLevel->m_outputStream.get());
+    }
+
+    if (fusion)
+    {
+        Argus::IEGLOutputStream *iEGLOutputStream =
+            Argus::interface_cast<Argus::IEGLOutputStream>(streams.front());
+        if (!iEGLOutputStream)
+            ORIGINATE_ERROR("Failed to get IEGLOutputStream interface");
+
+        // the consumers need to be connected before the captures start
+        m_fusionThread.reset(new ExposureFusionThread(streams, iEGLOutputStream->getResolution()));
+        if (!m_fusionThread)
+            ORIGINATE_ERROR("Out of memory");
+        m_fusionThread->setThreadRole("fusionconsumer");
+        PROPAGATE_ERROR(m_fusionThread->initialize());
+        PROPAGATE_ERROR(m_fusionThread->waitRunning());
     }
 
     // start the repeating burst request for the preview
-    PROPAGATE_ERROR(Dispatcher::getInstance().startRepeatBurst(requests));
+    PROPAGATE_ERROR(dispatcher.startRepeatBurst(requests));
 
     m_running = true;
 
@@ -366,13 +747,22 @@ bool TaskMultiExposure::stop()
     for (std::list<ExpLevel*>::iterator it = m_expLevels.begin(); it != m_expLevels.end(); ++it)
     {
         ExpLevel *expLevel = *it;
-        PROPAGATE_ERROR(composer.setStreamActive(
-            Argus::interface_cast<Argus::IEGLOutputStream>
-                (expLevel->m_outputStream)->getEGLStream(), false));
+        if (expLevel->m_display)
+        {
+            PROPAGATE_ERROR(composer.setStreamActive(
+                Argus::interface_cast<Argus::IEGLOutputStream>
+                    (expLevel->m_outputStream)->getEGLStream(), false));
+        }
     }
 
     PROPAGATE_ERROR(dispatcher.waitForIdle());
 
+    if (m_fusionThread)
+    {
+        PROPAGATE_ERROR(m_fusionThread->shutdown());
+        m_fusionThread.reset();
+    }
+
     PROPAGATE_ERROR(shutdownExpLevels());
 
     m_running = false;
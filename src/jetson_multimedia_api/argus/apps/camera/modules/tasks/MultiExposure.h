@@ -37,12 +37,17 @@
 #include "Value.h"
 #include "IObserver.h"
 #include "TrackedUniqueObject.h"
+#include "UniquePointer.h"
 
 namespace ArgusSamples
 {
 
+class ExposureFusionThread;
+
 /**
- * This task captures multiple streams with different exposure compensation values.
+ * This task captures multiple streams with different exposure compensation values. The streams
+ * are displayed side by side, or in fusion mode (m_fusion) merged into one well exposed image
+ * which is displayed instead.
  */
 class TaskMultiExposure : public ITask, public IObserver
 {
@@ -67,6 +72,7 @@ public:
     Value<uint32_t> m_exposureSteps;    ///< steps within the exposure range
     Value<Argus::Range<float> > m_exposureRange;  ///< in eV, e.g. -1,2 results in exposures from
                                         /// -1 eV to +2 eV
+    Value<bool> m_fusion;               ///< fuse the exposures of each burst into one image
 
 private:
     bool m_initialized;                 ///< set if initialized
@@ -85,13 +91,21 @@ private:
         ~ExpLevel();
 
         bool shutdown();
-        bool initialize(float exposureCompensation);
+
+        /**
+         * @param exposureCompensation [in] exposure compensation in eV
+         * @param display [in] if set the stream is bound to the composer, else it is read by a
+         *                     consumer
+         */
+        bool initialize(float exposureCompensation, bool display);
 
         TrackedUniqueObj<Argus::Request> m_request; ///< Argus request
         Argus::UniqueObj<Argus::OutputStream> m_outputStream; ///< Argus output stream
+        bool m_display;                 ///< set if the stream is bound to the composer
     };
 
     std::list<ExpLevel*> m_expLevels;   ///< exposure level
+    UniquePointer<ExposureFusionThread> m_fusionThread; ///< fuses and displays the exposures
 
     /**
      * Callback when the device is opened/closed.
@@ -34,15 +34,89 @@
 #include "Error.h"
 #include "UniquePointer.h"
 #include "PerfTracker.h"
+#include "Validator.h"
 #include <algorithm>
 
 namespace ArgusSamples
 {
 
+// valid preview modes
+static const ValidatorEnum<TaskMultiSession::PreviewMode>::ValueStringPair s_previewModes[] =
+{
+    { TaskMultiSession::PREVIEW_MODE_ALL, "all" },
+    { TaskMultiSession::PREVIEW_MODE_COLD, "cold" },
+    { TaskMultiSession::PREVIEW_MODE_WARM, "warm" }
+};
+
+/**
+ * Passes the frames of the sessions rendered by the composer on to the warm switch. The sensor
+ * timestamp of the frames is not known at the composer.
+ */
+class TaskMultiSession::PreviewObserver : public Composer::IFrameObserver
+{
+public:
+    explicit PreviewObserver(WarmSwitch &warmSwitch)
+        : m_warmSwitch(warmSwitch)
+    {
+    }
+
+    bool initialize()
+    {
+        PROPAGATE_ERROR(m_mutex.initialize());
+        return true;
+    }
+
+    /**
+     * Set the preview stream of a session, EGL_NO_STREAM_KHR if the session has no stream.
+     */
+    bool setStream(uint32_t index, EGLStreamKHR eglStream)
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        if (index >= m_streams.size())
+            m_streams.resize(index + 1, EGL_NO_STREAM_KHR);
+        m_streams[index] = eglStream;
+
+        return true;
+    }
+
+    /** @name Composer::IFrameObserver methods */
+    /**@{*/
+    virtual bool onStreamFrame(EGLStreamKHR eglStream)
+    {
+        uint32_t index = 0;
+
+        {
+            ScopedMutex sm(m_mutex);
+            PROPAGATE_ERROR(sm.expectLocked());
+
+            while ((index < m_streams.size()) && (m_streams[index] != eglStream))
+                ++index;
+            if (index == m_streams.size())
+                return true;
+        }
+
+        PROPAGATE_ERROR(m_warmSwitch.onFrame(index, 0));
+
+        return true;
+    }
+    /**@}*/
+
+private:
+    WarmSwitch &m_warmSwitch;
+    Mutex m_mutex;                          ///< protects the stream array
+    std::vector<EGLStreamKHR> m_streams;    ///< preview stream of each session
+};
+
 TaskMultiSession::TaskMultiSession()
     : m_initialized(false)
     , m_running(false)
     , m_prevRunning(false)
+    , m_runningMode(PREVIEW_MODE_ALL)
+    , m_previewMode(new ValidatorEnum<PreviewMode>(
+        s_previewModes, sizeof(s_previewModes) / sizeof(s_previewModes[0])),
+        PREVIEW_MODE_ALL)
 {
 }
 
@@ -51,7 +125,11 @@ TaskMultiSession::~TaskMultiSession()
     shutdown();
 }
 
-TaskMultiSession::Session::Session()
+TaskMultiSession::Session::Session(uint32_t deviceIndex, uint32_t index,
+    PreviewObserver *previewObserver)
+    : m_deviceIndex(deviceIndex)
+    , m_index(index)
+    , m_previewObserver(previewObserver)
 {
 }
 
@@ -60,7 +138,7 @@ TaskMultiSession::Session::~Session()
     shutdown();
 }
 
-bool TaskMultiSession::Session::initialize(uint32_t deviceIndex)
+bool TaskMultiSession::Session::initialize()
 {
     // create the perf tracker
     m_perfTracker.reset(new SessionPerfTracker());
@@ -73,7 +151,7 @@ bool TaskMultiSession::Session::initialize(uint32_t deviceIndex)
     Dispatcher &dispatcher = Dispatcher::getInstance();
 
     // create the session using the current device index
-    PROPAGATE_ERROR(dispatcher.createSession(m_session, deviceIndex));
+    PROPAGATE_ERROR(dispatcher.createSession(m_session, m_deviceIndex));
     PROPAGATE_ERROR(m_perfTracker->setSession(m_session.get()));
 
     // create the request
@@ -100,6 +178,9 @@ bool TaskMultiSession::Session::initialize(uint32_t deviceIndex)
     // Enable the output stream
     PROPAGATE_ERROR(dispatcher.enableOutputStream(m_request.get(), m_outputStream.get()));
 
+    if (m_previewObserver)
+        PROPAGATE_ERROR(m_previewObserver->setStream(m_index, iEGLOutputStream->getEGLStream()));
+
     return true;
 }
 
@@ -111,6 +192,13 @@ bool TaskMultiSession::Session::start()
     PROPAGATE_ERROR(composer.setStreamActive(
         Argus::interface_cast<Argus::IEGLOutputStream>(m_outputStream)->getEGLStream(), true));
 
+    PROPAGATE_ERROR(startCapture());
+
+    return true;
+}
+
+bool TaskMultiSession::Session::startCapture()
+{
     // start the repeating burst request for the preview
     PROPAGATE_ERROR(m_perfTracker->onEvent(SESSION_EVENT_ISSUE_CAPTURE));
     PROPAGATE_ERROR(Dispatcher::getInstance().startRepeat(m_request.get(), m_session.get()));
@@ -136,6 +224,10 @@ bool TaskMultiSession::Session::stop()
 
 bool TaskMultiSession::Session::shutdown()
 {
+    // nothing to do if the session had not been initialized or is already shut down
+    if (!m_perfTracker)
+        return true;
+
     if (m_request)
     {
         Dispatcher &dispatcher = Dispatcher::getInstance();
@@ -152,6 +244,10 @@ bool TaskMultiSession::Session::shutdown()
             if (!iEGLOutputStream)
                 REPORT_ERROR("Failed to get IEGLOutputStream interface");
 
+            // the frames of the stream are not reported anymore
+            if (m_previewObserver)
+                PROPAGATE_ERROR_CONTINUE(m_previewObserver->setStream(m_index, EGL_NO_STREAM_KHR));
+
             // disconnect the EGL stream
             iEGLOutputStream->disconnect();
 
@@ -170,6 +266,40 @@ bool TaskMultiSession::Session::shutdown()
     // Destroy the session
     m_session.reset();
 
+    m_perfTracker.reset();
+
+    return true;
+}
+
+bool TaskMultiSession::Session::prepare()
+{
+    PROPAGATE_ERROR(initialize());
+    // capture without rendering, the frames are consumed by the composer
+    PROPAGATE_ERROR(startCapture());
+
+    return true;
+}
+
+bool TaskMultiSession::Session::setPreview(bool active)
+{
+    Argus::IEGLOutputStream *iEGLOutputStream =
+        Argus::interface_cast<Argus::IEGLOutputStream>(m_outputStream);
+    if (!iEGLOutputStream)
+        ORIGINATE_ERROR("Failed to get IEGLOutputStream interface");
+
+    PROPAGATE_ERROR(Composer::getInstance().setStreamActive(iEGLOutputStream->getEGLStream(),
+        active));
+
+    return true;
+}
+
+bool TaskMultiSession::Session::release()
+{
+    // also called if prepare() failed, only stop what had been created
+    if (m_session && m_outputStream)
+        PROPAGATE_ERROR_CONTINUE(stop());
+    PROPAGATE_ERROR(shutdown());
+
     return true;
 }
 
@@ -178,10 +308,17 @@ bool TaskMultiSession::initialize()
     if (m_initialized)
         return true;
 
+    m_previewObserver.reset(new PreviewObserver(m_warmSwitch));
+    if (!m_previewObserver)
+        ORIGINATE_ERROR("Out of memory");
+    PROPAGATE_ERROR(m_previewObserver->initialize());
+
     PROPAGATE_ERROR(Dispatcher::getInstance().m_sensorModeValid.registerObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiSession::onSensorModeValidChanged)));
     PROPAGATE_ERROR(Dispatcher::getInstance().m_outputSize.registerObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiSession::restartStreams)));
+    PROPAGATE_ERROR(m_previewMode.registerObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskMultiSession::restartStreams)));
 
     m_initialized = true;
 
@@ -196,16 +333,73 @@ bool TaskMultiSession::shutdown()
     // stop the preview
     PROPAGATE_ERROR(stop());
 
+    PROPAGATE_ERROR_CONTINUE(m_previewMode.unregisterObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskMultiSession::restartStreams)));
     PROPAGATE_ERROR_CONTINUE(Dispatcher::getInstance().m_outputSize.unregisterObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiSession::restartStreams)));
     PROPAGATE_ERROR_CONTINUE(Dispatcher::getInstance().m_sensorModeValid.unregisterObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskMultiSession::onSensorModeValidChanged)));
 
+    m_previewObserver.reset();
+
     m_initialized = false;
 
     return true;
 }
 
+bool TaskMultiSession::createSessions()
+{
+    Dispatcher &dispatcher = Dispatcher::getInstance();
+
+    const uint32_t deviceCount = dispatcher.getDeviceCount();
+
+    if (deviceCount == 0)
+        ORIGINATE_ERROR("No camera devices found");
+
+    std::vector<uint32_t> devices;
+
+    if (m_multiDevices.get().size() > 0)
+    {
+        // m_multiDevices will not be changed by UI
+        // it has special validation requirements, so validate m_multiDevices here
+        devices = m_multiDevices.get();
+        std::sort(devices.begin(), devices.end());
+
+        // compare with deviceCount
+        if (devices.back() >= deviceCount)
+            ORIGINATE_ERROR("index %u is out of range [0 - %u)", devices.back(), deviceCount);
+
+        // check no duplicate
+        std::vector<uint32_t>::iterator it = std::unique(devices.begin(), devices.end());
+        if (it != devices.end())
+            ORIGINATE_ERROR("duplicated indexes");
+    }
+    else
+    {
+        // use all available camera devices
+        for (uint32_t deviceIndex = 0; deviceIndex < deviceCount; ++deviceIndex)
+        {
+            devices.push_back(deviceIndex);
+        }
+    }
+
+    // create a session object for each device, the frames of the sessions are only reported if
+    // the preview is switched between them
+    PreviewObserver *previewObserver =
+        (m_runningMode == PREVIEW_MODE_ALL) ? NULL : m_previewObserver.get();
+    for (uint32_t index = 0; index < devices.size(); ++index)
+    {
+        UniquePointer<Session> session(new Session(devices[index], index, previewObserver));
+
+        if (!session)
+            ORIGINATE_ERROR("Out of memory");
+
+        m_sessions.push_back(session.release());
+    }
+
+    return true;
+}
+
 bool TaskMultiSession::shutdownSessions()
 {
     if (!m_sessions.empty())
@@ -228,61 +422,35 @@ bool TaskMultiSession::start()
     if (m_running)
         return true;
 
-    Dispatcher &dispatcher = Dispatcher::getInstance();
-
-    if (m_sessions.empty())
-    {
-        const uint32_t deviceCount = dispatcher.getDeviceCount();
+    m_runningMode = m_previewMode.get();
 
-        if (deviceCount == 0)
-            ORIGINATE_ERROR("No camera devices found");
-
-        std::vector<uint32_t> devices;
+    // the sessions report their frames depending on the preview mode, recreate them
+    PROPAGATE_ERROR(shutdownSessions());
+    PROPAGATE_ERROR(createSessions());
 
-        if (m_multiDevices.get().size() > 0)
-        {
-            // m_multiDevices will not be changed by UI
-            // it has special validation requirements, so validate m_multiDevices here
-            devices = m_multiDevices.get();
-            std::sort(devices.begin(), devices.end());
-
-            // compare with deviceCount
-            if (devices.back() >= deviceCount)
-                ORIGINATE_ERROR("index %u is out of range [0 - %u)", devices.back(), deviceCount);
-
-            // check no duplicate
-            std::vector<uint32_t>::iterator it = std::unique(devices.begin(), devices.end());
-            if (it != devices.end())
-                ORIGINATE_ERROR("duplicated indexes");
-        }
-        else
+    if (m_runningMode == PREVIEW_MODE_ALL)
+    {
+        // create a request and streams for each session
+        for (std::list<Session*>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
         {
-            // use all available camera devices
-            for (uint32_t deviceIndex = 0; deviceIndex < deviceCount; ++deviceIndex)
-            {
-                devices.push_back(deviceIndex);
-            }
+            Session *session = *it;
+            PROPAGATE_ERROR(session->initialize());
         }
 
-        // create a request and streams for each session
-        for (std::vector<uint32_t>::iterator it = devices.begin(); it != devices.end(); ++it)
+        // start the sessions
+        for (std::list<Session*>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
         {
-            UniquePointer<Session> session(new Session);
-
-            if (!session)
-                ORIGINATE_ERROR("Out of memory");
-
-            PROPAGATE_ERROR(session->initialize(*it));
-
-            m_sessions.push_back(session.release());
+            Session *session = *it;
+            PROPAGATE_ERROR(session->start());
         }
     }
-
-    // start the sessions
-    for (std::list<Session*>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
+    else
     {
-        Session *session = *it;
-        PROPAGATE_ERROR(session->start());
+        // show the first session, in warm mode the other sessions are prepared too and keep
+        // capturing so that a switch only redirects the composer to another stream
+        std::vector<IWarmSource*> sources(m_sessions.begin(), m_sessions.end());
+        PROPAGATE_ERROR(m_warmSwitch.initialize(sources, 0, m_runningMode == PREVIEW_MODE_WARM));
+        PROPAGATE_ERROR(Composer::getInstance().setFrameObserver(m_previewObserver.get()));
     }
 
     m_running = true;
@@ -295,10 +463,25 @@ bool TaskMultiSession::stop()
     if (!m_running)
         return true;
 
-    for (std::list<Session*>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
+    if (m_runningMode == PREVIEW_MODE_ALL)
     {
-        Session *session = *it;
-        PROPAGATE_ERROR(session->stop());
+        for (std::list<Session*>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it)
+        {
+            Session *session = *it;
+            PROPAGATE_ERROR(session->stop());
+        }
+    }
+    else
+    {
+        PROPAGATE_ERROR(Composer::getInstance().setFrameObserver(NULL));
+
+        WarmSwitch::Stats stats;
+        PROPAGATE_ERROR(m_warmSwitch.getStats(&stats));
+        PROPAGATE_ERROR(PerfTracker::getInstance().onPreviewSwitchStats(
+            (m_runningMode == PREVIEW_MODE_WARM) ? "warm" : "cold", stats));
+
+        // releases the prepared sessions
+        PROPAGATE_ERROR(m_warmSwitch.shutdown());
     }
 
     PROPAGATE_ERROR(shutdownSessions());
@@ -308,6 +491,27 @@ bool TaskMultiSession::stop()
     return true;
 }
 
+bool TaskMultiSession::switchPreview()
+{
+    if (!m_running)
+        ORIGINATE_ERROR("Not running");
+    if (m_runningMode == PREVIEW_MODE_ALL)
+        ORIGINATE_ERROR("All sessions are shown, select the 'cold' or 'warm' preview mode");
+
+    uint32_t active = 0;
+    PROPAGATE_ERROR(m_warmSwitch.getActive(&active));
+    const uint32_t next = (active + 1) % m_warmSwitch.getSourceCount();
+
+    PROPAGATE_ERROR(m_warmSwitch.switchTo(next));
+
+    std::list<Session*>::const_iterator it = m_sessions.begin();
+    std::advance(it, next);
+    PROPAGATE_ERROR(Dispatcher::getInstance().message("Preview switched to device %u\n",
+        (*it)->m_deviceIndex));
+
+    return true;
+}
+
 bool TaskMultiSession::onSensorModeValidChanged(const Observed &source)
 {
     const bool isTrue = static_cast<const Value<bool>&>(source).get();
@@ -39,6 +39,7 @@
 #include "IObserver.h"
 #include "TrackedUniqueObject.h"
 #include "Value.h"
+#include "WarmSwitch.h"
 
 namespace ArgusSamples
 {
@@ -46,7 +47,8 @@ namespace ArgusSamples
 class SessionPerfTracker;
 
 /**
- * This task creates one session for each available sensor
+ * This task creates one session for each available sensor. Either all sessions are rendered side
+ * by side or one session is rendered and the preview is switched between the sessions.
  */
 class TaskMultiSession : public ITask, public IObserver
 {
@@ -54,6 +56,16 @@ public:
     TaskMultiSession();
     virtual ~TaskMultiSession();
 
+    /**
+     * Preview modes
+     */
+    enum PreviewMode
+    {
+        PREVIEW_MODE_ALL,   ///< all sessions are rendered side by side
+        PREVIEW_MODE_COLD,  ///< one session is rendered, a switch recreates the session
+        PREVIEW_MODE_WARM   ///< one session is rendered, all sessions keep capturing
+    };
+
     /** @name ITask methods */
     /**@{*/
     virtual bool initialize();
@@ -62,35 +74,67 @@ public:
     virtual bool stop();
     /**@}*/
 
+    /**
+     * Switch the preview to the session of the next device.
+     */
+    bool switchPreview();
+
 private:
     bool m_initialized;                 ///< set if initialized
     bool m_running;                     ///< set if preview is running
     bool m_prevRunning;                 ///< set if was running before the sensorModeValid is set to false
 
+    class PreviewObserver;
+
     /**
      * For each device there is one session with a request. Each request outputs to a stream which
      * is rendered.
      */
-    class Session
+    class Session : public IWarmSource
     {
     public:
-        Session();
-        ~Session();
+        Session(uint32_t deviceIndex, uint32_t index, PreviewObserver *previewObserver);
+        virtual ~Session();
 
         bool shutdown();
         bool start();
         bool stop();
-        bool initialize(uint32_t deviceIndex);
+        bool initialize();
+
+        /** @name IWarmSource methods */
+        /**@{*/
+        virtual bool prepare();
+        virtual bool setPreview(bool active);
+        virtual bool release();
+        /**@}*/
+
+        const uint32_t m_deviceIndex;                           ///< camera device index
+        const uint32_t m_index;                                 ///< index of the session
+        PreviewObserver *m_previewObserver;                     ///< optional
 
         TrackedUniqueObj<Argus::CaptureSession> m_session;      ///< Argus session
         TrackedUniqueObj<Argus::Request> m_request;             ///< Argus request
         Argus::UniqueObj<Argus::OutputStream> m_outputStream;   ///< Argus output stream
 
         UniquePointer<SessionPerfTracker> m_perfTracker;
+
+    private:
+        /**
+         * Start the repeating request
+         */
+        bool startCapture();
     };
 
     std::list<Session*> m_sessions;
+    PreviewMode m_runningMode;                      ///< preview mode the sessions had been started in
 
+    WarmSwitch m_warmSwitch;                        ///< switches the preview between sessions
+    UniquePointer<PreviewObserver> m_previewObserver;   ///< reports the shown frames
+
+    /**
+     * Create a session for each selected device, the sessions are not initialized.
+     */
+    bool createSessions();
     bool shutdownSessions();
 
     /**
@@ -99,12 +143,13 @@ private:
     bool onSensorModeValidChanged(const Observed &source);
 
     /**
-     * Restart when output size changes
+     * Restart when output size or preview mode changes
      */
     bool restartStreams(const Observed &source);
 
 public:
-    Value<std::vector<uint32_t> > m_multiDevices;    ///< multiple devices
+    Value<std::vector<uint32_t> > m_multiDevices;   ///< multiple devices
+    Value<PreviewMode> m_previewMode;               ///< preview mode
 };
 
 }; // namespace ArgusSamples
@@ -36,10 +36,183 @@
 #include "Dispatcher.h"
 #include "Error.h"
 #include "PerfTracker.h"
+#include "Thread.h"
 
 namespace ArgusSamples
 {
 
+/**
+ * Write an image to a file.
+ *
+ * @param image [in] image
+ * @param fileType [in] file type
+ * @param fileName [in] file name
+ */
+static bool writeImage(EGLStream::Image *image, StillFileType fileType, const char *fileName)
+{
+    switch (fileType)
+    {
+        case STILL_FILE_TYPE_JPG:
+        {
+            // Get the JPEG interface.
+            EGLStream::IImageJPEG *iJPEG =
+                Argus::interface_cast<EGLStream::IImageJPEG>(image);
+            if (!iJPEG)
+                ORIGINATE_ERROR("Failed to get IImageJPEG interface.");
+
+            // Write a JPEG to disk.
+            if (iJPEG->writeJPEG(fileName) != Argus::STATUS_OK)
+                ORIGINATE_ERROR("Failed to write JPEG to '%s'\n", fileName);
+        }
+        break;
+
+        case STILL_FILE_TYPE_HEADERLESS:
+        {
+            // Get the HEADERLESS_FILE interface.
+            EGLStream::IImageHeaderlessFile *iHeaderlessFile =
+                Argus::interface_cast<EGLStream::IImageHeaderlessFile>(image);
+            if (!iHeaderlessFile)
+                ORIGINATE_ERROR("Failed to get IImageHeaderlessFile interface.");
+
+            // Write a headerless, unencoded image to disk.
+            if (iHeaderlessFile->writeHeaderlessFile(fileName) != Argus::STATUS_OK)
+                ORIGINATE_ERROR("Failed to write headerless raw image to '%s'\n", fileName);
+        }
+        break;
+
+        default:
+            ORIGINATE_ERROR("unknown still image file type");
+    }
+
+    PROPAGATE_ERROR(Dispatcher::getInstance().message("Captured a still image to '%s'\n",
+                                                      fileName));
+
+    return true;
+}
+
+/**
+ * A frame of the zero shutter lag still stream.
+ */
+class ZslFrame : public IZslFrame
+{
+public:
+    explicit ZslFrame(Argus::UniqueObj<EGLStream::Frame> &frame)
+        : m_frame(frame.release())
+        , m_timestamp(0)
+    {
+    }
+
+    bool initialize()
+    {
+        EGLStream::IFrame *iFrame = Argus::interface_cast<EGLStream::IFrame>(m_frame);
+        if (!iFrame)
+            ORIGINATE_ERROR("Failed to get IFrame interface.");
+
+        // prefer the sensor timestamp (start of the readout) if the frame has metadata
+        m_timestamp = iFrame->getTime();
+        EGLStream::IArgusCaptureMetadata *iArgusCaptureMetadata =
+            Argus::interface_cast<EGLStream::IArgusCaptureMetadata>(m_frame);
+        if (iArgusCaptureMetadata)
+        {
+            const Argus::ICaptureMetadata *iCaptureMetadata =
+                Argus::interface_cast<const Argus::ICaptureMetadata>(
+                    iArgusCaptureMetadata->getMetadata());
+            if (iCaptureMetadata)
+                m_timestamp = iCaptureMetadata->getSensorTimestamp();
+        }
+
+        return true;
+    }
+
+    virtual uint64_t getTimestamp() const
+    {
+        return m_timestamp;
+    }
+
+    virtual bool write(const char *fileName, StillFileType fileType)
+    {
+        EGLStream::IFrame *iFrame = Argus::interface_cast<EGLStream::IFrame>(m_frame);
+        if (!iFrame)
+            ORIGINATE_ERROR("Failed to get IFrame interface.");
+
+        EGLStream::Image *image = iFrame->getImage();
+        if (!image)
+            ORIGINATE_ERROR("Failed to get image.");
+
+        PROPAGATE_ERROR(writeImage(image, fileType, fileName));
+
+        return true;
+    }
+
+private:
+    Argus::UniqueObj<EGLStream::Frame> m_frame;
+    uint64_t m_timestamp;
+};
+
+/**
+ * Acquires the frames of the zero shutter lag still stream and adds them to the frame ring.
+ */
+class ZslConsumerThread : public Thread
+{
+public:
+    ZslConsumerThread(Argus::OutputStream *stream, ZslCapture *zsl)
+        : m_stream(stream)
+        , m_zsl(zsl)
+    {
+    }
+
+protected:
+    virtual bool threadInitialize()
+    {
+        m_consumer.reset(EGLStream::FrameConsumer::create(m_stream));
+        if (!m_consumer)
+            ORIGINATE_ERROR("Failed to create FrameConsumer");
+
+        return true;
+    }
+
+    virtual bool threadExecute()
+    {
+        EGLStream::IFrameConsumer *iFrameConsumer =
+            Argus::interface_cast<EGLStream::IFrameConsumer>(m_consumer);
+        if (!iFrameConsumer)
+            ORIGINATE_ERROR("Failed to get IFrameConsumer interface");
+
+        // use a time out to allow the thread to be shutdown even if there are no new frames
+        Argus::Status status = Argus::STATUS_OK;
+        Argus::UniqueObj<EGLStream::Frame> frame(
+            iFrameConsumer->acquireFrame(TimeValue::fromMSec(100).toNSec(), &status));
+        if (!frame)
+        {
+            if (status == Argus::STATUS_TIMEOUT)
+                return true;
+            if (status == Argus::STATUS_DISCONNECTED)
+                return requestShutdown();
+            ORIGINATE_ERROR("Failed to acquire frame");
+        }
+
+        UniquePointer<ZslFrame> zslFrame(new ZslFrame(frame));
+        if (!zslFrame)
+            ORIGINATE_ERROR("Out of memory");
+        PROPAGATE_ERROR(zslFrame->initialize());
+
+        PROPAGATE_ERROR(m_zsl->pushFrame(zslFrame.release()));
+
+        return true;
+    }
+
+    virtual bool threadShutdown()
+    {
+        m_consumer.reset();
+        return true;
+    }
+
+private:
+    Argus::OutputStream *m_stream;
+    ZslCapture *m_zsl;
+    Argus::UniqueObj<EGLStream::FrameConsumer> m_consumer;
+};
+
 TaskStillCapture::TaskStillCapture()
     : m_initialized(false)
     , m_running(false)
@@ -69,6 +242,10 @@ bool TaskStillCapture::initialize()
         static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
     PROPAGATE_ERROR(dispatcher.m_captureYuvFormat.registerObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
+    PROPAGATE_ERROR(dispatcher.m_stillZsl.registerObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
+    PROPAGATE_ERROR(dispatcher.m_stillZslFrames.registerObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
 
 
     m_perfTracker.reset(new SessionPerfTracker());
@@ -165,6 +342,25 @@ bool TaskStillCapture::start()
     // Enable the preview stream
     PROPAGATE_ERROR(dispatcher.enableOutputStream(m_previewRequest.get(), m_previewStream.get()));
 
+    if (dispatcher.m_stillZsl.get())
+    {
+        // Create the zero shutter lag still stream, it's captured with every preview request
+        PROPAGATE_ERROR(dispatcher.createOutputStream(m_previewRequest.get(), true, m_zslStream));
+        PROPAGATE_ERROR(dispatcher.enableOutputStream(m_previewRequest.get(), m_zslStream.get()));
+
+        // bound the shutter lag if the stream stalls
+        PROPAGATE_ERROR(m_zsl.initialize(dispatcher.m_stillZslFrames.get(),
+            TimeValue::fromMSec(200)));
+
+        // the consumer needs to be connected before the captures start
+        m_zslConsumer.reset(new ZslConsumerThread(m_zslStream.get(), &m_zsl));
+        if (!m_zslConsumer)
+            ORIGINATE_ERROR("Out of memory");
+        m_zslConsumer->setThreadRole("stillconsumer");
+        PROPAGATE_ERROR(m_zslConsumer->initialize());
+        PROPAGATE_ERROR(m_zslConsumer->waitRunning());
+    }
+
     // start the repeating request for the preview
     PROPAGATE_ERROR(m_perfTracker->onEvent(SESSION_EVENT_ISSUE_CAPTURE));
     PROPAGATE_ERROR(dispatcher.startRepeat(m_previewRequest.get()));
@@ -192,6 +388,28 @@ bool TaskStillCapture::stop()
     PROPAGATE_ERROR(dispatcher.waitForIdle());
     PROPAGATE_ERROR(m_perfTracker->onEvent(SESSION_EVENT_FLUSH_DONE));
 
+    if (m_zslStream)
+    {
+        // write the pending images and release the frames before the stream is destroyed
+        PROPAGATE_ERROR(m_zslConsumer->shutdown());
+        m_zslConsumer.reset();
+
+        ZslCapture::Stats stats;
+        PROPAGATE_ERROR(m_zsl.waitIdle());
+        PROPAGATE_ERROR(m_zsl.getStats(&stats));
+        PROPAGATE_ERROR(m_zsl.shutdown());
+        PROPAGATE_ERROR(PerfTracker::getInstance().onStillCaptureStats("zsl", stats));
+
+        PROPAGATE_ERROR(dispatcher.disableOutputStream(m_previewRequest.get(), m_zslStream.get()));
+        m_zslStream.reset();
+    }
+    if (m_stats.shots)
+    {
+        m_stats.failed = m_stats.shots - m_stats.written;
+        PROPAGATE_ERROR(PerfTracker::getInstance().onStillCaptureStats("per shot", m_stats));
+        m_stats = ZslCapture::Stats();
+    }
+
     // disable the output stream
     PROPAGATE_ERROR(dispatcher.disableOutputStream(m_previewRequest.get(), m_previewStream.get()));
 
@@ -219,6 +437,40 @@ bool TaskStillCapture::stop()
     return true;
 }
 
+bool TaskStillCapture::getFileName(const Argus::Size2D<uint32_t> &size,
+    StillFileType fileType, std::string *fileName) const
+{
+    Dispatcher &dispatcher = Dispatcher::getInstance();
+
+    // build the file name
+    std::ostringstream name;
+    name << dispatcher.m_outputPath.get();
+    if (dispatcher.m_outputPath.get() != "/dev/null")
+    {
+        switch (fileType)
+        {
+            case STILL_FILE_TYPE_JPG:
+                name << "/image" << std::setfill('0') << std::setw(4) <<
+                    m_captureIndex << ".jpg";
+                break;
+
+            case STILL_FILE_TYPE_HEADERLESS:
+                name << "/image_" <<
+                    size.width() << "x" << size.height() << "_" <<
+                    std::setfill('0') << std::setw(4) << m_captureIndex <<
+                    "." << dispatcher.m_captureYuvFormat.toString();
+                break;
+
+            default:
+                ORIGINATE_ERROR("unknown still image file type");
+        }
+    }
+
+    *fileName = name.str();
+
+    return true;
+}
+
 bool TaskStillCapture::execute()
 {
     if (!m_initialized)
@@ -226,6 +478,45 @@ bool TaskStillCapture::execute()
     if (!m_running)
         ORIGINATE_ERROR("Not running");
 
+    if (m_zslStream)
+        PROPAGATE_ERROR(executeZsl());
+    else
+        PROPAGATE_ERROR(executePerShot());
+
+    ++m_captureIndex;
+
+    return true;
+}
+
+bool TaskStillCapture::executeZsl()
+{
+    // the shutter press
+    const uint64_t shutterTime = ZslCapture::getTime();
+
+    Dispatcher &dispatcher = Dispatcher::getInstance();
+    const StillFileType fileType = dispatcher.m_stillFileType.get();
+
+    Argus::IEGLOutputStream *iEGLOutputStream =
+        Argus::interface_cast<Argus::IEGLOutputStream>(m_zslStream);
+    if (!iEGLOutputStream)
+        ORIGINATE_ERROR("Failed to get IEGLOutputStream interface");
+
+    std::string fileName;
+    PROPAGATE_ERROR(getFileName(iEGLOutputStream->getResolution(), fileType, &fileName));
+    PROPAGATE_ERROR(validateOutputPath(fileName.c_str()));
+
+    // pick the frame closest to the shutter press, the image is written asynchronously
+    PROPAGATE_ERROR(m_zsl.shutter(shutterTime, fileName.c_str(), fileType));
+
+    return true;
+}
+
+bool TaskStillCapture::executePerShot()
+{
+    // the shutter press
+    const uint64_t shutterTime = ZslCapture::getTime();
+    m_stats.shots++;
+
     Dispatcher &dispatcher = Dispatcher::getInstance();
 
     TrackedUniqueObj<Argus::Request> stillRequest;
@@ -253,6 +544,7 @@ bool TaskStillCapture::execute()
     Argus::UniqueObj<EGLStream::Frame> frame(iFrameConsumer->acquireFrame());
     if (!frame)
         ORIGINATE_ERROR("Failed to aquire frame");
+    m_stats.shutterToFrame.add(ZslCapture::getTime() - shutterTime);
 
     // Use the IFrame interface to provide access to the Image in the Frame.
     EGLStream::IFrame *iFrame = Argus::interface_cast<EGLStream::IFrame>(frame);
@@ -263,84 +555,24 @@ bool TaskStillCapture::execute()
     if (!image)
         ORIGINATE_ERROR("Failed to get image.");
 
-    switch (dispatcher.m_stillFileType.get())
-    {
-        case STILL_FILE_TYPE_JPG:
-        {
-            // Get the JPEG interface.
-            EGLStream::IImageJPEG *iJPEG =
-                Argus::interface_cast<EGLStream::IImageJPEG>(image);
-            if (!iJPEG)
-                ORIGINATE_ERROR("Failed to get IImageJPEG interface.");
+    const StillFileType fileType = dispatcher.m_stillFileType.get();
 
-            // build the file name
-            std::ostringstream fileName;
-            fileName << dispatcher.m_outputPath.get();
-            if (dispatcher.m_outputPath.get() != "/dev/null")
-                fileName << "/image" << std::setfill('0') << std::setw(4) <<
-                m_captureIndex << ".jpg";
+    // the image size is part of the headerless file name
+    Argus::Size2D<uint32_t> size(0, 0);
+    EGLStream::IImage2D *i2D =
+        Argus::interface_cast<EGLStream::IImage2D>(image);
+    if (i2D)
+        size = i2D->getSize();
+    else if (fileType == STILL_FILE_TYPE_HEADERLESS)
+        ORIGINATE_ERROR("Failed to get IImage2D interface.");
 
-            PROPAGATE_ERROR(validateOutputPath(fileName.str().c_str()));
+    std::string fileName;
+    PROPAGATE_ERROR(getFileName(size, fileType, &fileName));
+    PROPAGATE_ERROR(validateOutputPath(fileName.c_str()));
 
-            // Write a JPEG to disk.
-            if (iJPEG->writeJPEG(fileName.str().c_str()) == Argus::STATUS_OK)
-            {
-                PROPAGATE_ERROR(dispatcher.message("Captured a still image to '%s'\n",
-                                                   fileName.str().c_str()));
-            }
-            else
-            {
-                ORIGINATE_ERROR("Failed to write JPEG to '%s'\n", fileName.str().c_str());
-            }
-        }
-        break;
-
-        case STILL_FILE_TYPE_HEADERLESS:
-        {
-            // Get the HEADERLESS_FILE interface.
-            EGLStream::IImageHeaderlessFile *iHeaderlessFile =
-                Argus::interface_cast<EGLStream::IImageHeaderlessFile>(image);
-            if (!iHeaderlessFile)
-                ORIGINATE_ERROR("Failed to get IImageHeaderlessFile interface.");
-
-            EGLStream::IImage2D *i2D =
-                Argus::interface_cast<EGLStream::IImage2D>(image);
-            if (!i2D)
-                ORIGINATE_ERROR("Failed to get IImage2D interface.");
-            const Argus::Size2D<uint32_t> size = i2D->getSize();
-
-            // build the file name
-            std::ostringstream fileName;
-            fileName << dispatcher.m_outputPath.get();
-            if (dispatcher.m_outputPath.get() != "/dev/null")
-            {
-                fileName << "/image_" <<
-                    size.width() << "x" << size.height() << "_" <<
-                    std::setfill('0') << std::setw(4) << m_captureIndex <<
-                    "." << dispatcher.m_captureYuvFormat.toString();
-            }
-
-            PROPAGATE_ERROR(validateOutputPath(fileName.str().c_str()));
-
-            // Write a headerless, unencoded image to disk.
-            if (iHeaderlessFile->writeHeaderlessFile(fileName.str().c_str()) == Argus::STATUS_OK)
-            {
-                PROPAGATE_ERROR(dispatcher.message("Captured a still image to '%s'\n",
-                                                   fileName.str().c_str()));
-            }
-            else
-            {
-                ORIGINATE_ERROR("Failed to write headerless raw image to '%s'\n",
-                                fileName.str().c_str());
-            }
-        }
-        break;
-
-        default:
-            ORIGINATE_ERROR("unknown still image file type");
-    }
-
-    ++m_captureIndex;
+    PROPAGATE_ERROR(writeImage(image, fileType, fileName.c_str()));
+    m_stats.written++;
+    m_stats.shutterToFile.add(ZslCapture::getTime() - shutterTime);
 
     // release the frame.
     frame.reset();
@@ -379,6 +611,10 @@ bool TaskStillCapture::shutdown()
         static_cast<IObserver::CallbackFunction>(&TaskStillCapture::onDeviceOpenChanged)));
     PROPAGATE_ERROR_CONTINUE(dispatcher.m_captureYuvFormat.unregisterObserver(this,
         static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
+    PROPAGATE_ERROR_CONTINUE(dispatcher.m_stillZsl.unregisterObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
+    PROPAGATE_ERROR_CONTINUE(dispatcher.m_stillZslFrames.unregisterObserver(this,
+        static_cast<IObserver::CallbackFunction>(&TaskStillCapture::restartStreams)));
 
     m_initialized = false;
 
@@ -36,14 +36,19 @@
 #include "UniquePointer.h"
 #include "IObserver.h"
 #include "TrackedUniqueObject.h"
+#include "ZslCapture.h"
 
 namespace ArgusSamples
 {
 
 class SessionPerfTracker;
+class ZslConsumerThread;
 
 /**
- * This task captures still images
+ * This task captures still images. By default a still stream is created and a capture is issued
+ * for each image. In zero shutter lag mode (Dispatcher::m_stillZsl) a full resolution still
+ * stream is captured together with the preview, the most recent frames are held and the frame
+ * closest to the shutter press is written asynchronously.
  */
 class TaskStillCapture : public ITask, public IObserver
 {
@@ -74,6 +79,31 @@ private:
     TrackedUniqueObj<Argus::Request> m_previewRequest;      ///< Argus preview request
     Argus::UniqueObj<Argus::OutputStream> m_previewStream;  ///< Argus preview stream
 
+    Argus::UniqueObj<Argus::OutputStream> m_zslStream;      ///< zero shutter lag still stream
+    UniquePointer<ZslConsumerThread> m_zslConsumer;         ///< feeds the ZSL frame ring
+    ZslCapture m_zsl;                   ///< zero shutter lag frame ring and writer
+    ZslCapture::Stats m_stats;          ///< statistics of the per shot captures
+
+    /**
+     * Capture one image with a per shot still stream and request.
+     */
+    bool executePerShot();
+
+    /**
+     * Capture one image from the zero shutter lag frame ring.
+     */
+    bool executeZsl();
+
+    /**
+     * Build the file name of the next image.
+     *
+     * @param size [in] image size
+     * @param fileType [in] file type
+     * @param fileName [out] file name
+     */
+    bool getFileName(const Argus::Size2D<uint32_t> &size, StillFileType fileType,
+        std::string *fileName) const;
+
     /**
      * Callback when the device is opened/closed.
      */
@@ -32,6 +32,9 @@
 #include <GLES2/gl2ext.h>
 
 #include <math.h>
+#include <time.h>
+
+#include <algorithm>
 
 #include "Error.h"
 #include "UniquePointer.h"
@@ -45,6 +48,18 @@
 namespace ArgusSamples
 {
 
+/**
+ * @returns the CPU time used by the calling thread in ns
+ */
+static uint64_t getThreadCpuTime()
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
 Composer::Composer()
     : m_initialized(false)
     , m_program(0)
@@ -52,6 +67,9 @@ Composer::Composer()
     , m_windowWidth(0)
     , m_windowHeight(0)
     , m_windowAspectRatio(1.0f)
+    , m_streamsChanged(false)
+    , m_frameObserver(NULL)
+    , m_statsStartCpu(0)
 {
 }
 
@@ -92,6 +110,8 @@ bool Composer::initialize()
     PROPAGATE_ERROR(m_display.initialize(window.getEGLNativeDisplay()));
 
     PROPAGATE_ERROR(m_mutex.initialize());
+    PROPAGATE_ERROR(m_observerMutex.initialize());
+    PROPAGATE_ERROR(m_wakeup.initialize());
 
     // initialize the window size
     PROPAGATE_ERROR(onResize(window.getWidth(), window.getHeight()));
@@ -114,18 +134,36 @@ bool Composer::shutdown()
 
     PROPAGATE_ERROR_CONTINUE(Window::getInstance().unregisterObserver(this));
 
-    // request shutdown of the thread
+    // request shutdown of the thread and wake it up
     PROPAGATE_ERROR_CONTINUE(Thread::requestShutdown());
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR_CONTINUE(sm.expectLocked());
+        PROPAGATE_ERROR_CONTINUE(m_wakeup.broadcast());
+    }
 
     PROPAGATE_ERROR_CONTINUE(Thread::shutdown());
 
     PROPAGATE_ERROR_CONTINUE(m_display.cleanup());
 
+    PROPAGATE_ERROR_CONTINUE(m_wakeup.shutdown());
+    PROPAGATE_ERROR_CONTINUE(m_observerMutex.shutdown());
+
     m_initialized = false;
 
     return true;
 }
 
+bool Composer::setFrameObserver(IFrameObserver *observer)
+{
+    ScopedMutex sm(m_observerMutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    m_frameObserver = observer;
+
+    return true;
+}
+
 bool Composer::bindStream(EGLStreamKHR eglStream)
 {
     if (eglStream == EGL_NO_STREAM_KHR)
@@ -143,6 +181,10 @@ bool Composer::bindStream(EGLStreamKHR eglStream)
         PROPAGATE_ERROR(sm.expectLocked());
 
         m_streams.push_back(Stream(streamConsumer.get()));
+
+        // the composer thread connects the consumer
+        m_streamsChanged = true;
+        PROPAGATE_ERROR(m_wakeup.broadcast());
     }
 
     // wait until the stream is connected
@@ -164,6 +206,8 @@ bool Composer::unbindStream(EGLStreamKHR eglStream)
         {
             // set the shutdown flag, the composer thread will do the actual shutdown
             it->m_shutdown = true;
+            m_streamsChanged = true;
+            PROPAGATE_ERROR(m_wakeup.broadcast());
             return true;
         }
     }
@@ -183,6 +227,8 @@ bool Composer::setStreamActive(EGLStreamKHR eglStream, bool active)
        if (it->m_consumer->isEGLStream(eglStream))
        {
             it->m_active = active;
+            m_streamsChanged = true;
+            PROPAGATE_ERROR(m_wakeup.broadcast());
             return true;
         }
     }
@@ -211,6 +257,40 @@ bool Composer::setStreamAspectRatio(EGLStreamKHR eglStream, float aspectRatio)
     return true;
 }
 
+bool Composer::setStreamLatestFrameWins(EGLStreamKHR eglStream, bool latestFrameWins)
+{
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    for (StreamList::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+    {
+       if (it->m_consumer->isEGLStream(eglStream))
+       {
+            PROPAGATE_ERROR(it->m_consumer->setLatestFrameWins(latestFrameWins));
+            return true;
+        }
+    }
+
+    ORIGINATE_ERROR("Stream was not bound");
+
+    return true;
+}
+
+bool Composer::signalNewFrame(const TimeValue &captureLatency)
+{
+    if (!m_initialized)
+        return true;
+
+    ScopedMutex sm(m_mutex);
+    PROPAGATE_ERROR(sm.expectLocked());
+
+    // the composer thread recalculates its wakeup time
+    m_scheduler.onFrameSignalled(getCurrentTime(), captureLatency);
+    PROPAGATE_ERROR(m_wakeup.broadcast());
+
+    return true;
+}
+
 bool Composer::onResize(uint32_t width, uint32_t height)
 {
     m_windowWidth = width;
@@ -271,6 +351,14 @@ bool Composer::threadInitialize()
     if (eglSwapInterval(m_display.get(), 1) != EGL_TRUE)
         ORIGINATE_ERROR("Failed to set the swap interval");
 
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+        m_scheduler.reset();
+    }
+    m_statsStartTime = getCurrentTime();
+    m_statsStartCpu = getThreadCpuTime();
+
     return true;
 }
 
@@ -334,11 +422,69 @@ bool Composer::renderStreams(uint32_t activeStreams)
 
     PROPAGATE_ERROR(m_context.swapBuffers());
 
+    {
+        // with a swap interval of one the swap returns at the vsync
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+        m_scheduler.onSwap(getCurrentTime());
+    }
+
     PROPAGATE_ERROR(PerfTracker::getInstance().onEvent(GLOBAL_EVENT_DISPLAY));
 
     return true;
 }
 
+bool Composer::waitForWork()
+{
+    // called with m_mutex locked
+    while (!m_doShutdown && !m_streamsChanged)
+    {
+        const TimeValue now = getCurrentTime();
+        const TimeValue wakeupTime = m_scheduler.getWakeupTime(now,
+            static_cast<uint32_t>(m_streams.size()));
+
+        if (wakeupTime <= now)
+            break;
+
+        // wake up at least once per second to report statistics
+        TimeValue timeout = wakeupTime - now;
+        if (timeout > TimeValue::fromSec(1.f))
+            timeout = TimeValue::fromSec(1.f);
+
+        bool timedOut = false;
+        PROPAGATE_ERROR(m_wakeup.timedWait(m_mutex, timeout, &timedOut));
+        if (timedOut && (wakeupTime > getCurrentTime()))
+            return true;
+    }
+    m_streamsChanged = false;
+
+    return true;
+}
+
+bool Composer::reportStats()
+{
+    const TimeValue now = getCurrentTime();
+
+    if (now < m_statsStartTime + TimeValue::fromSec(1.f))
+        return true;
+
+    RenderScheduler::Stats stats;
+    {
+        ScopedMutex sm(m_mutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+        stats = m_scheduler.getStats();
+    }
+
+    const uint64_t cpuTime = getThreadCpuTime();
+    PROPAGATE_ERROR(PerfTracker::getInstance().onComposerStats(stats, now - m_statsStartTime,
+        TimeValue::fromNSec(cpuTime - m_statsStartCpu)));
+
+    m_statsStartTime = now;
+    m_statsStartCpu = cpuTime;
+
+    return true;
+}
+
 bool Composer::threadExecute()
 {
     bool render = false;
@@ -348,12 +494,17 @@ bool Composer::threadExecute()
         ScopedMutex sm(m_mutex);
         PROPAGATE_ERROR(sm.expectLocked());
 
-        if (m_streams.size() == 0)
+        // sleep until the latch point before the next vsync or until woken up
+        PROPAGATE_ERROR(waitForWork());
+        if (m_doShutdown)
             return true;
 
+        uint32_t newFrames = 0;
+
         // first iterate through the streams and check if there are streams which should be shutdown
         // also count the active streams
-        for (StreamList::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+        StreamList::iterator it = m_streams.begin();
+        while (it != m_streams.end())
         {
             if (it->m_shutdown)
             {
@@ -375,20 +526,45 @@ bool Composer::threadExecute()
                 ++activeStreams;
                 // if a new frame is available we need to render
                 if (acquiredNewFrame)
-                    render = true;
+                {
+                    ++newFrames;
+
+                    const EGLStreamKHR eglStream = it->m_consumer->getEGLStream();
+                    if (std::find(m_newFrameStreams.begin(), m_newFrameStreams.end(),
+                        eglStream) == m_newFrameStreams.end())
+                    {
+                        m_newFrameStreams.push_back(eglStream);
+                    }
+                }
             }
+            ++it;
         }
+
+        // all new frames are rendered in one frame
+        render = m_scheduler.onLatch(getCurrentTime(), newFrames);
     }
 
     if (render)
     {
         PROPAGATE_ERROR(renderStreams(activeStreams));
+
+        // tell the frame observer which streams had been rendered with a new frame, this is done
+        // without holding m_mutex so that the observer can't stall the stream updates
+        ScopedMutex sm(m_observerMutex);
+        PROPAGATE_ERROR(sm.expectLocked());
+
+        if (m_frameObserver)
+        {
+            for (std::vector<EGLStreamKHR>::const_iterator it = m_newFrameStreams.begin();
+                 it != m_newFrameStreams.end(); ++it)
+            {
+                PROPAGATE_ERROR(m_frameObserver->onStreamFrame(*it));
+            }
+        }
+        m_newFrameStreams.clear();
     }
-    else
-    {
-        // wait some time and then check again if new frames are available
-        usleep(1000);
-    }
+
+    PROPAGATE_ERROR(reportStats());
 
     return true;
 }
@@ -32,10 +32,13 @@
 #include "EGLGlobal.h"
 
 #include <list>
+#include <vector>
 
 #include "Window.h"
 #include "Thread.h"
 #include "Mutex.h"
+#include "ConditionVariable.h"
+#include "RenderScheduler.h"
 
 #include "GLContext.h"
 
@@ -47,6 +50,11 @@ class StreamConsumer;
 /**
  * The composer is used to render multiple EGL streams into the windows. The streams are arranged
  * into a regular grid.
+ *
+ * The composer thread sleeps until a producer signals a new frame, the bound streams change, or
+ * the RenderScheduler latch point before the next vsync is reached. All frames which arrived
+ * since the last swap are rendered in one frame. Without frame signals the streams are checked
+ * once per vsync.
  */
 class Composer : public Thread, public Window::IResizeObserver
 {
@@ -61,6 +69,31 @@ public:
      */
     bool shutdown();
 
+    /**
+     * Observer for the frames shown by the composer.
+     */
+    class IFrameObserver
+    {
+    public:
+        virtual ~IFrameObserver() {}
+
+        /**
+         * Called on the composer thread when a new frame of an active stream had been rendered.
+         * Must not call back into the composer.
+         *
+         * @param eglStream [in] the stream the frame had been acquired from
+         */
+        virtual bool onStreamFrame(EGLStreamKHR eglStream) = 0;
+    };
+
+    /**
+     * Set the frame observer, this replaces the previous observer. Once this returned the
+     * previous observer is not called anymore.
+     *
+     * @param observer [in] the frame observer, NULL to remove it
+     */
+    bool setFrameObserver(IFrameObserver *observer);
+
     /**
      * Bind an EGL stream. A bound and active stream is rendered. Newly bound streams are inactive.
      *
@@ -91,6 +124,24 @@ public:
      */
     bool setStreamAspectRatio(EGLStreamKHR eglStream, float aspectRatio);
 
+    /**
+     * Set latest frame wins for the stream. If set, frames queued by a FIFO mode producer are
+     * skipped and only the newest frame is rendered.
+     *
+     * @param eglStream [in]
+     * @param latestFrameWins [in]
+     */
+    bool setStreamLatestFrameWins(EGLStreamKHR eglStream, bool latestFrameWins);
+
+    /**
+     * Signal that a producer presented a new frame. The frame is rendered at the next vsync
+     * together with the frames of other streams arriving until then. This can be called from
+     * any thread.
+     *
+     * @param captureLatency [in] time between capture and presenting the frame, if known
+     */
+    bool signalNewFrame(const TimeValue &captureLatency = TimeValue());
+
     /**
      * Get the EGL display
      */
@@ -125,6 +176,8 @@ private:
     /**@}*/
 
     bool renderStreams(uint32_t activeStreams);
+    bool waitForWork();
+    bool reportStats();
 
     bool m_initialized;         ///< set if initialized
 
@@ -137,7 +190,17 @@ private:
     uint32_t m_windowHeight;    ///< window height
     float m_windowAspectRatio;  ///< window aspect ratio
 
-    Mutex m_mutex;              ///< to protect access to the stream array
+    Mutex m_mutex;              ///< to protect access to the stream array and the scheduler
+    ConditionVariable m_wakeup; ///< wakes up the composer thread
+    bool m_streamsChanged;      ///< set if the streams changed and have to be checked at once
+    RenderScheduler m_scheduler;///< decides when to render
+
+    Mutex m_observerMutex;      ///< to protect access to the frame observer
+    IFrameObserver *m_frameObserver;    ///< frame observer
+    std::vector<EGLStreamKHR> m_newFrameStreams; ///< active streams with frames not rendered yet
+
+    TimeValue m_statsStartTime; ///< start of the statistics interval
+    uint64_t m_statsStartCpu;   ///< composer thread CPU time at start of the interval, in ns
 
     /**
      * Each bound EGL stream has a stream consumer and can be active or inactive.
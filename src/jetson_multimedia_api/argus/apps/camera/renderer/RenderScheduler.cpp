@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RenderScheduler.h"
+
+namespace ArgusSamples
+{
+
+// vsync period assumed until swaps have been measured
+static const TimeValue DEFAULT_REFRESH_PERIOD = TimeValue::fromUSec(16667);
+// start rendering this long before the vsync
+static const TimeValue DEFAULT_LATCH_MARGIN = TimeValue::fromUSec(3000);
+// a producer which did not signal for this long is considered not to signal
+static const TimeValue SIGNAL_TIMEOUT = TimeValue::fromMSec(1000);
+// while producers signal, still check the streams at this interval
+static const TimeValue SIGNAL_IDLE_CHECK = TimeValue::fromMSec(100);
+
+RenderScheduler::Stats::Stats()
+    : framesRendered(0)
+    , framesCoalesced(0)
+    , wakeups(0)
+    , latencyMin(TimeValue::infinite())
+    , latencyCount(0)
+{
+}
+
+RenderScheduler::RenderScheduler()
+    : m_nominalPeriod(DEFAULT_REFRESH_PERIOD)
+    , m_period(DEFAULT_REFRESH_PERIOD)
+    , m_latchMargin(DEFAULT_LATCH_MARGIN)
+{
+}
+
+void RenderScheduler::reset()
+{
+    m_period = m_nominalPeriod;
+    m_lastVsync = TimeValue();
+    m_lastLatch = TimeValue();
+    m_lastSignal = TimeValue();
+    m_pendingSignals.clear();
+    m_latchedSignals.clear();
+    m_stats = Stats();
+}
+
+void RenderScheduler::setRefreshPeriod(const TimeValue &period)
+{
+    m_nominalPeriod = period;
+    m_period = period;
+}
+
+void RenderScheduler::setLatchMargin(const TimeValue &margin)
+{
+    m_latchMargin = margin;
+}
+
+void RenderScheduler::onFrameSignalled(const TimeValue &now, const TimeValue &captureLatency)
+{
+    Signal signal;
+
+    signal.time = now;
+    signal.captureLatency = captureLatency;
+
+    // bound the number of signals kept if frames are not rendered
+    if (m_pendingSignals.size() < 64)
+        m_pendingSignals.push_back(signal);
+    m_lastSignal = now;
+}
+
+bool RenderScheduler::hasFrameSignals(const TimeValue &now) const
+{
+    return (m_lastSignal != TimeValue()) && (now < m_lastSignal + SIGNAL_TIMEOUT);
+}
+
+TimeValue RenderScheduler::getLatchTime(const TimeValue &now) const
+{
+    // the vsync phase is not known before the first swap, check once per nominal period
+    if ((m_lastVsync == TimeValue()) || (now < m_lastVsync))
+    {
+        if ((m_lastLatch == TimeValue()) || (now < m_lastLatch))
+            return now;
+        const TimeValue latchTime = m_lastLatch + m_period;
+        return (latchTime > now) ? latchTime : now;
+    }
+
+    // the first vsync which can still be reached when starting to render now
+    const uint64_t period = m_period.toNSec();
+    const uint64_t sinceVsync = (now + m_latchMargin - m_lastVsync).toNSec();
+    const uint64_t vsyncs = (sinceVsync + period - 1) / period;
+    const TimeValue vsync = m_lastVsync + TimeValue::fromNSec(vsyncs * period);
+
+    if (vsync < now + m_latchMargin)
+        return now;
+    return vsync - m_latchMargin;
+}
+
+TimeValue RenderScheduler::getWakeupTime(const TimeValue &now, uint32_t streams) const
+{
+    if (streams == 0)
+        return TimeValue::infinite();
+
+    // frames had been signalled, render them all at the next vsync
+    if (!m_pendingSignals.empty())
+        return getLatchTime(now);
+
+    // the producers signal new frames, the stream check is only a fallback
+    if (hasFrameSignals(now))
+        return now + SIGNAL_IDLE_CHECK;
+
+    // no signals, check the streams once per vsync
+    return getLatchTime(now);
+}
+
+bool RenderScheduler::onLatch(const TimeValue &now, uint32_t newFrames)
+{
+    m_stats.wakeups++;
+    m_lastLatch = now;
+
+    // if the signalled frames did not reach the streams yet keep the signals pending
+    if (newFrames == 0)
+        return false;
+
+    m_stats.framesCoalesced += newFrames - 1;
+    m_latchedSignals.insert(m_latchedSignals.end(), m_pendingSignals.begin(),
+        m_pendingSignals.end());
+    m_pendingSignals.clear();
+
+    return true;
+}
+
+void RenderScheduler::onSwap(const TimeValue &swapTime)
+{
+    m_stats.framesRendered++;
+
+    for (std::vector<Signal>::const_iterator it = m_latchedSignals.begin();
+         it != m_latchedSignals.end(); ++it)
+    {
+        if (swapTime < it->time)
+            continue;
+
+        const TimeValue latency = it->captureLatency + (swapTime - it->time);
+        m_stats.latencySum = m_stats.latencySum + latency;
+        if (latency < m_stats.latencyMin)
+            m_stats.latencyMin = latency;
+        if (latency > m_stats.latencyMax)
+            m_stats.latencyMax = latency;
+        m_stats.latencyCount++;
+    }
+    m_latchedSignals.clear();
+
+    if ((m_lastVsync != TimeValue()) && (swapTime > m_lastVsync))
+    {
+        const int64_t period = m_period.toNSec();
+        const int64_t interval = (swapTime - m_lastVsync).toNSec();
+        const int64_t vsyncs = (interval + period / 2) / period;
+
+        // distance from the vsync grid
+        int64_t jitter = interval - vsyncs * period;
+        if (jitter < 0)
+            jitter = -jitter;
+        m_stats.jitterSum = m_stats.jitterSum + TimeValue::fromNSec(jitter);
+        if (TimeValue::fromNSec(jitter) > m_stats.jitterMax)
+            m_stats.jitterMax = TimeValue::fromNSec(jitter);
+
+        // follow the display rate with swaps of one vsync interval
+        if ((vsyncs == 1) && (jitter < period / 4))
+            m_period = TimeValue::fromNSec(period + (interval - period) / 8);
+    }
+    m_lastVsync = swapTime;
+}
+
+RenderScheduler::Stats RenderScheduler::getStats()
+{
+    Stats stats = m_stats;
+
+    stats.refreshPeriod = m_period;
+    m_stats = Stats();
+
+    return stats;
+}
+
+}; // namespace ArgusSamples
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "Util.h" // for TimeValue
+
+namespace ArgusSamples
+{
+
+/**
+ * Decides when the composer latches new stream frames and renders. It holds no EGL or GL state
+ * and gets all times passed in, so it can be driven by simulated streams and a simulated display.
+ *
+ * New frames are not rendered as they arrive. They are collected until the latch point shortly
+ * before the next predicted vsync, where all of them are rendered in one frame. The vsync period
+ * and phase are learned from the times buffer swaps return, with a swap interval of one a swap
+ * returns at a vsync.
+ */
+class RenderScheduler
+{
+public:
+    /**
+     * Frame pacing and latency statistics, accumulated since the last call to getStats().
+     */
+    struct Stats
+    {
+        Stats();
+
+        uint32_t framesRendered;    ///< frames rendered
+        uint32_t framesCoalesced;   ///< stream updates merged into a frame with other updates
+        uint32_t wakeups;           ///< composer wakeups
+        TimeValue refreshPeriod;    ///< current vsync period estimate
+        TimeValue jitterSum;        ///< sum of the swap distances from the vsync grid
+        TimeValue jitterMax;        ///< maximum swap distance from the vsync grid
+        TimeValue latencySum;       ///< sum of capture to swap latencies
+        TimeValue latencyMin;       ///< minimum capture to swap latency
+        TimeValue latencyMax;       ///< maximum capture to swap latency
+        uint32_t latencyCount;      ///< number of latencies measured
+    };
+
+    RenderScheduler();
+
+    /**
+     * Forget the learned vsync timing and all pending frames.
+     */
+    void reset();
+
+    /**
+     * Set the nominal vsync period used until the period has been measured.
+     */
+    void setRefreshPeriod(const TimeValue &period);
+
+    /**
+     * Set how long before the predicted vsync frames are latched and rendering starts.
+     */
+    void setLatchMargin(const TimeValue &margin);
+
+    /**
+     * A producer signalled a new frame.
+     *
+     * @param now [in] current time
+     * @param captureLatency [in] time between capture and signalling, zero if unknown
+     */
+    void onFrameSignalled(const TimeValue &now, const TimeValue &captureLatency);
+
+    /**
+     * @returns true if a producer signalled a frame recently. If not, new frames can only be found
+     * by checking the streams and the composer has to check them once per vsync.
+     */
+    bool hasFrameSignals(const TimeValue &now) const;
+
+    /**
+     * @returns the time the composer should wake up to latch frames. TimeValue::infinite() if
+     * there is nothing to wait for but signals.
+     *
+     * @param now [in] current time
+     * @param streams [in] number of active streams
+     */
+    TimeValue getWakeupTime(const TimeValue &now, uint32_t streams) const;
+
+    /**
+     * The composer woke up and checked the streams.
+     *
+     * @param now [in] current time
+     * @param newFrames [in] number of streams with a new frame
+     * @returns true if a frame should be rendered now
+     */
+    bool onLatch(const TimeValue &now, uint32_t newFrames);
+
+    /**
+     * The rendered frame had been swapped.
+     *
+     * @param swapTime [in] the time the swap returned
+     */
+    void onSwap(const TimeValue &swapTime);
+
+    /**
+     * Get the statistics and restart accumulating.
+     */
+    Stats getStats();
+
+private:
+    TimeValue getLatchTime(const TimeValue &now) const;
+
+    /**
+     * A frame signal, kept until the frame is shown
+     */
+    struct Signal
+    {
+        TimeValue time;             ///< time of the signal
+        TimeValue captureLatency;   ///< time between capture and the signal
+    };
+
+    TimeValue m_nominalPeriod;  ///< period used until measured
+    TimeValue m_period;         ///< estimated vsync period
+    TimeValue m_lastVsync;      ///< time of the last swap, on the vsync grid
+    TimeValue m_lastLatch;      ///< time of the last latch
+    TimeValue m_latchMargin;    ///< latch this long before the vsync
+    TimeValue m_lastSignal;     ///< time of the last frame signal
+
+    std::vector<Signal> m_pendingSignals;   ///< signals since the last latch with new frames
+    std::vector<Signal> m_latchedSignals;   ///< signals shown by the next swap
+
+    Stats m_stats;
+};
+
+}; // namespace ArgusSamples
+
+#endif // RENDER_SCHEDULER_H
@@ -47,6 +47,8 @@ StreamConsumer::StreamConsumer(EGLStreamKHR eglStream)
     , m_streamState(EGL_NONE)
     , m_streamTexture(0)
     , m_aspectRatio(1.0f)
+    , m_latestFrameWins(false)
+    , m_skippedFrames(0)
 {
 }
 
@@ -113,6 +115,12 @@ float StreamConsumer::getStreamAspectRatio() const
     return m_aspectRatio;
 }
 
+bool StreamConsumer::setLatestFrameWins(bool latestFrameWins)
+{
+    m_latestFrameWins = latestFrameWins;
+    return true;
+}
+
 bool StreamConsumer::acquire(bool *acquiredNewFrame)
 {
     if (!m_initialized)
@@ -145,6 +153,19 @@ bool StreamConsumer::acquire(bool *acquiredNewFrame)
         {
             if (acquiredNewFrame)
                 *acquiredNewFrame = true;
+
+            // drop older queued frames until the newest one is acquired
+            while (m_latestFrameWins)
+            {
+                EGLint state = EGL_NONE;
+                if (!eglQueryStreamKHR(display, m_eglStream, EGL_STREAM_STATE_KHR, &state))
+                    ORIGINATE_ERROR("eglQueryStreamKHR failed (error 0x%04x)", eglGetError());
+                if (state != EGL_STREAM_STATE_NEW_FRAME_AVAILABLE_KHR)
+                    break;
+                if (!eglStreamConsumerAcquireKHR(display, m_eglStream))
+                    break;
+                ++m_skippedFrames;
+            }
         }
     }
     else if ((m_streamState == EGL_NONE) ||
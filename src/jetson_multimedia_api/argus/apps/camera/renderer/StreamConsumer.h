@@ -32,6 +32,8 @@
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 
+#include <stdint.h>
+
 namespace ArgusSamples
 {
 
@@ -48,11 +50,34 @@ public:
     bool shutdown();
 
     bool isEGLStream(EGLStreamKHR eglStream) const;
+
+    /**
+     * @returns the EGL stream the consumer is connected to
+     */
+    EGLStreamKHR getEGLStream() const
+    {
+        return m_eglStream;
+    }
+
     uint32_t getStreamTextureID() const;
 
     bool setStreamAspectRatio(float aspectRatio);
     float getStreamAspectRatio() const;
 
+    /**
+     * If set, acquire() skips to the newest frame when the producer queued several frames (FIFO
+     * mode streams).
+     */
+    bool setLatestFrameWins(bool latestFrameWins);
+
+    /**
+     * @returns the number of frames skipped because of latest frame wins
+     */
+    uint64_t getSkippedFrames() const
+    {
+        return m_skippedFrames;
+    }
+
     /**
      * @returns the cached stream state
      */
@@ -74,6 +99,8 @@ private:
     EGLint m_streamState;       ///< cached stream state
     uint32_t m_streamTexture;
     float m_aspectRatio;        ///< aspect ration of the images transported by the stream
+    bool m_latestFrameWins;     ///< if set skip to the newest frame on acquire
+    uint64_t m_skippedFrames;   ///< frames skipped because of latest frame wins
 
     /**
      * Hide default constructor
@@ -36,6 +36,7 @@
 #include <list>
 
 #include "Error.h"
+#include "NvThreadPolicy.h"
 #include "UniquePointer.h"
 #include "Window.h"
 #include "Value.h"
@@ -354,7 +355,12 @@ int main(int argc, char **argv)
 
     ArgusSamples::CameraApp cameraApp(basename(argv[0]));
 
-    if (!cameraApp.run(argc, argv))
+    bool success = cameraApp.run(argc, argv);
+
+    if (NvThreadPolicy::getInstance().isConfigured())
+        NvThreadPolicy::getInstance().printPolicy();
+
+    if (!success)
          return EXIT_FAILURE;
 
     return EXIT_SUCCESS;
@@ -108,6 +108,15 @@ bool AppModuleCapture::initialize(Options &options)
     PROPAGATE_ERROR(options.addOption(
         createValueOption("stillfiletype", 0, "FORMAT",
             "set image file type.", Dispatcher::getInstance().m_stillFileType)));
+    PROPAGATE_ERROR(options.addOption(
+        createValueOption("zsl", 0, "0 or 1",
+            "zero shutter lag, hold the most recent frames and save the one closest to the "
+            "capture, images are written in the background.",
+            Dispatcher::getInstance().m_stillZsl, "1")));
+    PROPAGATE_ERROR(options.addOption(
+        createValueOption("zslframes", 0, "COUNT",
+            "number of recent frames held in zero shutter lag mode.",
+            Dispatcher::getInstance().m_stillZslFrames)));
 
     m_initialized = true;
 
@@ -59,6 +59,10 @@ bool AppModuleMultiExposure::initialize(Options &options)
     PROPAGATE_ERROR(options.addOption(
         createValueOption("exposuresteps", 0, "COUNT", "sample the exposure range at COUNT steps.",
             m_multiExposure.m_exposureSteps)));
+    PROPAGATE_ERROR(options.addOption(
+        createValueOption("fusion", 0, "0 or 1",
+            "fuse the exposures into one image instead of showing them side by side.",
+            m_multiExposure.m_fusion, "1")));
 
     m_initialized = true;
 
@@ -110,6 +114,7 @@ bool AppModuleMultiExposure::start(Window::IGuiMenuBar *iGuiMenuBar,
 
         CREATE_GUI_ELEMENT("Exposure Range", m_multiExposure.m_exposureRange);
         CREATE_GUI_ELEMENT("Exposure Steps", m_multiExposure.m_exposureSteps);
+        CREATE_GUI_ELEMENT("Exposure Fusion", m_multiExposure.m_fusion);
 
 #undef CREATE_GUI_ELEMENT
 
@@ -38,6 +38,7 @@ namespace ArgusSamples
 
 AppModuleMultiSession::AppModuleMultiSession()
     : m_initialized(false)
+    , m_running(false)
 {
 }
 
@@ -56,6 +57,12 @@ bool AppModuleMultiSession::initialize(Options &options)
     PROPAGATE_ERROR(options.addOption(
         createValueOption("multidevices", 0, "INDEX", "select multiple camera devices with INDEX.",
             m_multiSession.m_multiDevices)));
+    PROPAGATE_ERROR(options.addOption(
+        createValueOption("preview", 0, "MODE",
+            "'all' renders all devices side by side, 'cold' and 'warm' render one device, press "
+            "'n' to switch to the next one. In 'warm' mode all devices keep capturing so that "
+            "switching does not recreate the session.",
+            m_multiSession.m_previewMode)));
 
     m_initialized = true;
 
@@ -67,6 +74,8 @@ bool AppModuleMultiSession::shutdown()
     if (!m_initialized)
         return true;
 
+    PROPAGATE_ERROR_CONTINUE(stop());
+
     PROPAGATE_ERROR_CONTINUE(m_multiSession.shutdown());
 
     m_initialized = false;
@@ -76,13 +85,42 @@ bool AppModuleMultiSession::shutdown()
 bool AppModuleMultiSession::start(Window::IGuiMenuBar *iGuiMenuBar,
     Window::IGuiContainer *iGuiContainerConfig)
 {
+    if (m_running)
+        return true;
+
+    // register key observer
+    PROPAGATE_ERROR(Window::getInstance().registerObserver(this));
+
     PROPAGATE_ERROR(m_multiSession.start());
+
+    m_running = true;
+
     return true;
 }
 
 bool AppModuleMultiSession::stop()
 {
+    if (!m_running)
+        return true;
+
     PROPAGATE_ERROR(m_multiSession.stop());
+
+    // unregister key observer
+    PROPAGATE_ERROR(Window::getInstance().unregisterObserver(this));
+
+    m_running = false;
+
+    return true;
+}
+
+bool AppModuleMultiSession::onKey(const Key &key)
+{
+    if ((key == Key("n")) &&
+        (m_multiSession.m_previewMode.get() != TaskMultiSession::PREVIEW_MODE_ALL))
+    {
+        PROPAGATE_ERROR(m_multiSession.switchPreview());
+    }
+
     return true;
 }
 
@@ -39,7 +39,7 @@ namespace ArgusSamples
  * The multi session app module adds functionality for adding multiple sessions where
  * each session uses a different sensor.
  */
-class AppModuleMultiSession : public IAppModule
+class AppModuleMultiSession : public IAppModule, public Window::IKeyObserver
 {
 public:
     AppModuleMultiSession();
@@ -56,7 +56,13 @@ public:
 
 private:
     bool m_initialized;                 ///< set if initialized
+    bool m_running;                     ///< set if running
     TaskMultiSession m_multiSession;    ///< multi session task
+
+    /** @name IKeyObserver methods */
+    /**@{*/
+    virtual bool onKey(const Key &key);
+    /**@}*/
 };
 
 }; // namespace ArgusSamples
@@ -41,7 +41,11 @@ find_library(ARGUS_LIBRARY NAMES nvargus
 find_library(ARGUS_LIBRARY_MULTIPROCESS NAMES nvargus_socketclient
              HINTS /usr/lib/${CMAKE_LIBRARY_ARCHITECTURE}/tegra)
 
-if (DISABLE_MULTIPROCESS)
+if (ARGUS_REPLAY)
+# Software camera from samples/utils/replay, for hosts without libnvargus
+set(ARGUS_LIBRARY argusreplay)
+set(ARGUS_LIBRARIES argusreplay)
+elseif (DISABLE_MULTIPROCESS)
 set(ARGUS_LIBRARIES ${ARGUS_LIBRARY})
 else()
 set(ARGUS_LIBRARIES ${ARGUS_LIBRARY_MULTIPROCESS})
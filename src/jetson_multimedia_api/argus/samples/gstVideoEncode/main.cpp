@@ -33,9 +33,10 @@
 #include "ArgusHelpers.h"
 #include "CommonOptions.h"
 #include "Error.h"
+#include "NvThreadPolicy.h"
 #include "PreviewConsumer.h"
+#include "SegmentUploader.h"
 #include <string>
-#include <queue>
 
 namespace ArgusSamples
 {
@@ -81,6 +82,8 @@ public:
         , m_remoteAddress("")
         , m_remoteUsername("")
         , m_remotePath("~/")
+        , m_uploadStreams(2)
+        , m_uploadRetries(8)
         , m_keepLocalFiles(false)
         , m_partSize(0)
     {
@@ -127,6 +130,14 @@ public:
         addOption(createValueOption
             ("remotepath", 0, "PATH", "Path on the remote server where the files will be copied.",
              m_remotePath));
+        addOption(createValueOption
+            ("uploadstreams", 0, "COUNT", "Number of parts which are copied in parallel over the "
+             "SSH connection.",
+             m_uploadStreams));
+        addOption(createValueOption
+            ("uploadretries", 0, "COUNT", "Number of attempts to send a part before giving up and "
+             "keeping it locally.",
+             m_uploadRetries));
         addOption(createValueOption
             ("keeplocal", 0, "FLAG", "When remote copies are enabled, this flag will specify "
              "whether or not the local copy should be deleted after being copied.",
@@ -139,8 +150,9 @@ public:
                        "and can optionally write the output stream to multiple file parts using\n"
                        "a maximum file size. These parts can then be optionally copied to a\n"
                        "remote server, and then kept or deleted from the local device.\n"
+                       "Parts are copied over SSH while they are being written.\n"
                        "For example, the following will indefinitely record video in 100MB chunks\n"
-                       "that will be written to the local path '/argusLocal/' before being copied\n"
+                       "that will be written to the local path '/argusLocal/' while being copied\n"
                        "to 192.168.1.1:/argusRemote/ using the 'argus' username. The local files\n"
                        "will also be preserved using --keeplocal\n\n"
                        "  argus_gstvideoencode -t0 \\\n"
@@ -164,6 +176,8 @@ public:
     const std::string& address() const { return m_remoteAddress.get(); }
     const std::string& username() const { return m_remoteUsername.get(); }
     const std::string& remotePath() const { return m_remotePath.get(); }
+    uint32_t uploadStreams() const { return m_uploadStreams.get(); }
+    uint32_t uploadRetries() const { return m_uploadRetries.get(); }
     bool keepLocalFiles() const { return m_keepLocalFiles.get(); }
     uint64_t partSize() const { return m_partSize.get() * 1024 * 1024; }
     bool isRemoteDestination() const { return m_remoteAddress.get() != ""; }
@@ -181,81 +195,12 @@ protected:
     Value<std::string> m_remoteAddress;
     Value<std::string> m_remoteUsername;
     Value<std::string> m_remotePath;
+    Value<uint32_t> m_uploadStreams;
+    Value<uint32_t> m_uploadRetries;
     Value<bool> m_keepLocalFiles;
     Value<uint32_t> m_partSize;
 };
 
-/**
- * Utility thread to copy files to a remote server using scp.
- * This class is only used when the --remoteaddress option is provided for remote file writes.
- */
-class FileTransferThread : public Thread
-{
-public:
-    FileTransferThread(const GstVideoEncodeSampleOptions& options)
-        : m_options(options)
-    {
-    }
-
-    /**
-     * Queues a file to be transfered to the remote destination.
-     * If the keepLocalFiles option is false, the source file is deleted after the copy.
-     */
-    void sendFile(const std::string& fileName)
-    {
-        m_queue.push(fileName);
-    }
-
-private:
-    virtual bool threadInitialize() { return true; }
-    virtual bool threadShutdown() { return true; }
-
-    virtual bool threadExecute()
-    {
-        while (!m_doShutdown && m_queue.size() == 0)
-            sleep(1);
-
-        if (m_queue.size() > 0)
-        {
-            // Copy file to server.
-            const char* filename = m_queue.front().c_str();
-            std::string cmd = std::string("scp ") + filename + " " + m_options.username() +
-                              "@" + m_options.address() + ":" + m_options.remotePath() +
-                              " > /dev/null";
-            if (system(cmd.c_str()))
-            {
-                printf("Failed to copy %s to %s\n", filename, m_options.address().c_str());
-                return false;
-            }
-            else
-            {
-                printf("Copied %s to %s:%s  (source file is being %s)\n",
-                       filename, m_options.address().c_str(),
-                       m_options.remotePath().c_str(),
-                       (m_options.keepLocalFiles() ? "kept" : "deleted"));
-            }
-
-            if (!m_options.keepLocalFiles())
-            {
-                // Delete file.
-                cmd = std::string("rm ") + filename;
-                if (system(cmd.c_str()))
-                {
-                    printf("Failed to delete %s\n", filename);
-                }
-            }
-
-            m_queue.pop();
-        }
-
-        return true;
-    }
-
-    const GstVideoEncodeSampleOptions& m_options;
-    std::queue< std::string > m_queue;
-};
-
-
 /**
  * Class to initialize and control GStreamer video encoding from an EGLStream.
  */
@@ -267,7 +212,8 @@ public:
         , m_state(GST_STATE_NULL)
         , m_pipeline(NULL)
         , m_videoEncoder(NULL)
-        , m_fileTransferThread(NULL)
+        , m_uploader(NULL)
+        , m_currentSegmentId(0)
         , m_currentPartNumber(0)
         , m_currentPartFile(NULL)
         , m_totalBytesWritten(0)
@@ -294,13 +240,15 @@ public:
             ORIGINATE_ERROR("Resolution > 4k requires encoder to be H265\n");
         }
 
-        // If we're outputting to a remote destination, allocate/start the FileTransferThread.
+        // If we're outputting to a remote destination, allocate/start the SegmentUploader.
         if (m_options.isRemoteDestination())
         {
-            m_fileTransferThread = new FileTransferThread(m_options);
-            if (!m_fileTransferThread)
-                ORIGINATE_ERROR("Failed to create FileTransferThread");
-            PROPAGATE_ERROR(m_fileTransferThread->initialize());
+            m_uploader = new SegmentUploader(m_options.address(), m_options.username(),
+                                             m_options.remotePath(), m_options.uploadStreams(),
+                                             m_options.uploadRetries(), m_options.keepLocalFiles());
+            if (!m_uploader)
+                ORIGINATE_ERROR("Failed to create SegmentUploader");
+            PROPAGATE_ERROR(m_uploader->initialize());
         }
 
         // Initialize GStreamer.
@@ -504,12 +452,26 @@ public:
             gst_object_unref(GST_OBJECT(m_pipeline));
         m_pipeline = NULL;
 
-        if (m_fileTransferThread)
+        // Close the last part. Without parts the muxed file is only complete now.
+        if (m_currentPartFile)
         {
-            m_fileTransferThread->sendFile(m_currentPartName);
-            m_fileTransferThread->shutdown();
-            delete m_fileTransferThread;
-            m_fileTransferThread = NULL;
+            int64_t partBytesWritten = ftell(m_currentPartFile);
+            fclose(m_currentPartFile);
+            m_currentPartFile = NULL;
+            if (m_uploader)
+                m_uploader->finishSegment(m_currentSegmentId, partBytesWritten);
+        }
+        else if (m_uploader && m_options.partSize() == 0 && !m_currentPartName.empty())
+        {
+            m_uploader->sendFile(m_currentPartName);
+        }
+
+        if (m_uploader)
+        {
+            m_uploader->shutdown();
+            m_uploader->printStats();
+            delete m_uploader;
+            m_uploader = NULL;
         }
     }
 
@@ -598,10 +560,10 @@ public:
                 printf("Finished part %s (%ld bytes)\n",
                        m_currentPartName.c_str(), partBytesWritten);
 
-                // If we have a file transfer thread, send the file to the remote destination.
-                if (m_fileTransferThread)
+                // The uploader has been sending the part while it was written, let it finish.
+                if (m_uploader)
                 {
-                    m_fileTransferThread->sendFile(m_currentPartName);
+                    m_uploader->finishSegment(m_currentSegmentId, partBytesWritten);
                 }
             }
         }
@@ -619,13 +581,18 @@ public:
                 printf("File open failed\n");
                 return (GstPadProbeReturn)(0);
             }
+            if (m_uploader)
+                m_currentSegmentId = m_uploader->beginSegment(m_currentPartName);
         }
 
         // Write to file.
         if (fwrite(map.data, writeSize, 1, m_currentPartFile) != 1)
         {
+            int64_t partBytesWritten = ftell(m_currentPartFile);
             fclose(m_currentPartFile);
             m_currentPartFile = NULL;
+            if (m_uploader)
+                m_uploader->finishSegment(m_currentSegmentId, partBytesWritten);
             printf("Write to file %s failed!\n", m_currentPartName.c_str());
             return (GstPadProbeReturn)(0);
         }
@@ -633,6 +600,10 @@ public:
         {
             m_totalBytesWritten += writeSize;
 
+            // Hand the new data to the uploader right away instead of when the part is closed.
+            if (m_uploader && fflush(m_currentPartFile) == 0)
+                m_uploader->segmentProgress(m_currentSegmentId, ftell(m_currentPartFile));
+
             time_t now = time(0);
             if (difftime(now, m_lastPrintTime) >= 1)
             {
@@ -666,7 +637,8 @@ protected:
     GstElement *m_pipeline;
     GstElement *m_videoEncoder;
 
-    FileTransferThread *m_fileTransferThread;
+    SegmentUploader *m_uploader;
+    uint32_t m_currentSegmentId;
     uint32_t m_currentPartNumber;
     std::string m_currentPartName;
     FILE *m_currentPartFile;
@@ -886,7 +858,12 @@ int main(int argc, char** argv)
     if (options.requestedExit())
         return EXIT_SUCCESS;
 
-    if (!ArgusSamples::execute(options))
+    bool success = ArgusSamples::execute(options);
+
+    if (NvThreadPolicy::getInstance().isConfigured())
+        NvThreadPolicy::getInstance().printPolicy();
+
+    if (!success)
         return EXIT_FAILURE;
 
     printf("Done.\n");
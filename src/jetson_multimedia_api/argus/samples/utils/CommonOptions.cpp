@@ -28,6 +28,7 @@
 
 #include "CommonOptions.h"
 #include "ArgusHelpers.h"
+#include "NvThreadPolicy.h"
 
 namespace ArgusSamples
 {
@@ -58,6 +59,14 @@ CommonOptions::CommonOptions(const char *programName, uint32_t optionEnables)
     addOption(Option("listdevices", 'l', "",
             Option::TYPE_ACTION,
             "List all available CameraDevices, then exit", listCameraDevices, this));
+    addOption(Option("threadpolicy", 0, "SPEC",
+            Option::TYPE_ACTION,
+            "Thread placement and scheduling policy per role, e.g.\n"
+            "\t\t'argus:cpus=2-3;render:cpus=4,policy=fifo,priority=50'.\n"
+            "\t\t@FILE reads one role per line from FILE.", setThreadPolicy, this));
+    addOption(Option("mlock", 0, "",
+            Option::TYPE_ACTION,
+            "Lock process memory to avoid page faults", lockMemory, this));
 
     if (m_optionEnables & Option_D_CameraDevice)
     {
@@ -126,6 +135,33 @@ bool CommonOptions::parse(const int argc, char * const *argv)
     return results;
 }
 
+/* static */
+bool CommonOptions::setThreadPolicy(void *userPtr, const char *optArg)
+{
+    NvThreadPolicy &policy = NvThreadPolicy::getInstance();
+
+    if (optArg[0] == '@')
+    {
+        if (policy.loadConfigFile(optArg + 1) != 0)
+            ORIGINATE_ERROR("Failed to load thread policy file '%s'", optArg + 1);
+    }
+    else if (policy.loadConfig(optArg) != 0)
+    {
+        ORIGINATE_ERROR("Invalid thread policy '%s'", optArg);
+    }
+
+    return true;
+}
+
+/* static */
+bool CommonOptions::lockMemory(void *userPtr, const char *optArg)
+{
+    if (NvThreadPolicy::getInstance().lockMemory() != 0)
+        ORIGINATE_ERROR("Failed to lock process memory");
+
+    return true;
+}
+
 /* static */
 bool CommonOptions::listCameraDevices(void *userPtr, const char *optArg)
 {
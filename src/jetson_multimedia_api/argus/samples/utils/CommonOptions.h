@@ -134,6 +134,12 @@ protected:
     // Callback for '-l' option to list available CameraDevices then exit.
     static bool listCameraDevices(void *userPtr, const char *optArg);
 
+    // Callback for '--threadpolicy' option to configure NvThreadPolicy.
+    static bool setThreadPolicy(void *userPtr, const char *optArg);
+
+    // Callback for '--mlock' option to lock the process memory.
+    static bool lockMemory(void *userPtr, const char *optArg);
+
     uint32_t m_optionEnables;
     Value<uint32_t> m_cameraDeviceIndex;
     Value<uint32_t> m_sensorModeIndex;
@@ -28,10 +28,12 @@
 
 #include <assert.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 #include "GLContext.h"
 #include "EGLGlobal.h"
 #include "Error.h"
+#include "NvOverlay.h"
 
 #include "Courier16x24.h"
 
@@ -50,6 +52,18 @@ GLContext::GLContext()
     , m_textTexture(0)
     , m_textHeight(16.0f/480.0f) // Default to 16 pixels high for 480 pixel high windows.
     , m_textRelativeWidth(1.0f)
+    , m_textColorUniform(-1)
+    , m_textBackgroundUniform(-1)
+    , m_overlayProgram(0)
+    , m_overlayVertexArray(0)
+    , m_overlayBuffer(0)
+    , m_overlayScaleUniform(-1)
+    , m_overlayBufferSize(0)
+    , m_overlayVertexCount(0)
+    , m_overlaySource(NULL)
+    , m_overlayGeneration(0)
+    , m_overlayWidth(0)
+    , m_overlayHeight(0)
 {
     m_textColor[0] = m_textColor[1] = m_textColor[2] = m_textColor[3] = 1.0f;
     m_textBackground[0] = m_textBackground[1] = m_textBackground[2] = m_textBackground[3] = 0.0f;
@@ -357,21 +371,54 @@ bool GLContext::linkProgram(GLuint program)
     return true;
 }
 
+// Font texture constants.
+static const GLint fontTextureWidth = 256;
+static const GLint fontTextureHeight = 144;
+static const GLint fontColumns = 16;
+static const GLint fontRows = 6;
+static const char fontFirstChar = ' ';
+
+NvOverlayFont GLContext::getTextFont()
+{
+    NvOverlayFont font;
+
+    font.pixels = courier16x24;
+    font.width = fontTextureWidth;
+    font.height = fontTextureHeight;
+    font.columns = fontColumns;
+    font.rows = fontRows;
+    font.first_char = fontFirstChar;
+    return font;
+}
+
+bool GLContext::initializeFontTexture()
+{
+    if (m_textTexture)
+        return true;
+
+    GLint activeTexture;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    glActiveTexture(GL_TEXTURE15);
+    glGenTextures(1, &m_textTexture);
+    glBindTexture(GL_TEXTURE_2D, m_textTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, fontTextureWidth, fontTextureHeight, 0,
+                 GL_RED, GL_UNSIGNED_BYTE, courier16x24);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(activeTexture);
+
+    return true;
+}
+
 bool GLContext::renderText(const char* text)
 {
-    // Font texture constants.
-    const unsigned char* fontPixels = courier16x24;
-    const GLint fontTextureWidth = 256;
-    const GLint fontTextureHeight = 144;
-    const GLfloat fontWidth = 1.0f / 16.0f;
-    const GLfloat fontHeight = 1.0f / 6.0f;
+    const GLfloat fontWidth = 1.0f / fontColumns;
+    const GLfloat fontHeight = 1.0f / fontRows;
     const GLfloat fontAspect = 16.0f / 24.0f;
     const GLfloat fontSpacing = fontWidth / 32.0f;
 
-    // Static vertex attrib arrays.
-    static GLfloat verts[8];
-    static GLfloat texCoords[8];
-
     EGLContext currentContext = eglGetCurrentContext();
     if (currentContext != m_context)
         ORIGINATE_ERROR("Context not current");
@@ -408,31 +455,20 @@ bool GLContext::renderText(const char* text)
         PROPAGATE_ERROR(createProgram(vtxSrc, frgSrc, &m_textProgram));
         glUseProgram(m_textProgram);
         glUniform1i(glGetUniformLocation(m_textProgram, "texSampler"), 15);
+        m_textColorUniform = glGetUniformLocation(m_textProgram, "color");
+        m_textBackgroundUniform = glGetUniformLocation(m_textProgram, "background");
 
-        glVertexAttribPointer(14, 2, GL_FLOAT, GL_FALSE, 0, verts);
-        glVertexAttribPointer(15, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
         glEnableVertexAttribArray(14);
         glEnableVertexAttribArray(15);
 
-        GLint activeTexture;
-        glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
-        glActiveTexture(GL_TEXTURE15);
-        glGenTextures(1, &m_textTexture);
-        glBindTexture(GL_TEXTURE_2D, m_textTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, fontTextureWidth, fontTextureHeight, 0,
-                     GL_RED, GL_UNSIGNED_BYTE, fontPixels);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glActiveTexture(activeTexture);
+        PROPAGATE_ERROR(initializeFontTexture());
     }
 
     glUseProgram(m_textProgram);
 
     // Set the text color.
-    glUniform4fv(glGetUniformLocation(m_textProgram, "color"), 1, m_textColor);
-    glUniform4fv(glGetUniformLocation(m_textProgram, "background"), 1, m_textBackground);
+    glUniform4fv(m_textColorUniform, 1, m_textColor);
+    glUniform4fv(m_textBackgroundUniform, 1, m_textBackground);
 
     // Enable alpha blending.
     GLint blendEnable;
@@ -440,47 +476,57 @@ bool GLContext::renderText(const char* text)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Render the text.
+    // Build two triangles per character, rendered with a single draw.
     GLfloat &x = m_currentTextPosition[0];
     GLfloat &y = m_currentTextPosition[1];
     const GLfloat textHeight = m_textHeight;
     const GLfloat textWidth  = m_textHeight * m_textRelativeWidth * fontAspect;
+    m_textVertices.clear();
+    m_textCoords.clear();
     while (*text)
     {
+        if (*text == '\n')
+        {
+            x = m_userTextPosition[0];
+            y -= textHeight;
+            text++;
+            continue;
+        }
+
         // Set the vertex positions.
-        verts[0] = x + textWidth;
-        verts[1] = y - textHeight;
-        verts[2] = x + textWidth;
-        verts[3] = y;
-        verts[4] = x;
-        verts[5] = y - textHeight;
-        verts[6] = x;
-        verts[7] = y;
+        const GLfloat verts[12] =
+        {
+            x, y,  x, y - textHeight,  x + textWidth, y,
+            x + textWidth, y,  x, y - textHeight,  x + textWidth, y - textHeight
+        };
 
         // Set the texture coordinates.
         int col = *text % 16;
         int row = *text / 16 - 2;
-        texCoords[0] = fontWidth  * (col + 1) - fontSpacing;
-        texCoords[1] = fontHeight * (row + 1);
-        texCoords[2] = fontWidth  * (col + 1) - fontSpacing;
-        texCoords[3] = fontHeight * row;
-        texCoords[4] = fontWidth  * col + fontSpacing;
-        texCoords[5] = fontHeight * (row + 1);
-        texCoords[6] = fontWidth  * col + fontSpacing;
-        texCoords[7] = fontHeight * row;
-
-        // Render the character.
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-        // Advance character and/or line.
+        const GLfloat left = fontWidth * col + fontSpacing;
+        const GLfloat right = fontWidth * (col + 1) - fontSpacing;
+        const GLfloat top = fontHeight * row;
+        const GLfloat bottom = fontHeight * (row + 1);
+        const GLfloat texCoords[12] =
+        {
+            left, top,  left, bottom,  right, top,
+            right, top,  left, bottom,  right, bottom
+        };
+
+        m_textVertices.insert(m_textVertices.end(), verts, verts + 12);
+        m_textCoords.insert(m_textCoords.end(), texCoords, texCoords + 12);
+
+        // Advance character.
         x += textWidth;
         text++;
-        if (*text == '\n')
-        {
-            x = m_userTextPosition[0];
-            y -= textHeight;
-            text++;
-        }
+    }
+
+    // Render the text.
+    if (!m_textVertices.empty())
+    {
+        glVertexAttribPointer(14, 2, GL_FLOAT, GL_FALSE, 0, &m_textVertices[0]);
+        glVertexAttribPointer(15, 2, GL_FLOAT, GL_FALSE, 0, &m_textCoords[0]);
+        glDrawArrays(GL_TRIANGLES, 0, m_textVertices.size() / 2);
     }
 
     // Reset state.
@@ -502,6 +548,106 @@ void GLContext::renderTextf(const char* format, ...)
     va_end(argList);
 }
 
+bool GLContext::renderOverlay(NvOverlay &overlay)
+{
+    EGLContext currentContext = eglGetCurrentContext();
+    if (currentContext != m_context)
+        ORIGINATE_ERROR("Context not current");
+
+    // Initialize the shader, texture and vertex buffer on first use.
+    if (!m_overlayProgram)
+    {
+        static const char* vtxSrc =
+            "#version 300 es\n"
+            "in layout(location = 0) vec2 position;\n"
+            "in layout(location = 1) vec2 texCoord;\n"
+            "in layout(location = 2) vec4 color;\n"
+            "uniform vec2 scale;\n"
+            "out vec2 vTexCoord;\n"
+            "out vec4 vColor;\n"
+            "void main() {\n"
+            "  gl_Position = vec4(position * scale + vec2(-1.0, 1.0), 0.0, 1.0);\n"
+            "  vTexCoord = texCoord;\n"
+            "  vColor = color;\n"
+            "}\n";
+        static const char frgSrc[] =
+            "#version 300 es\n"
+            "precision mediump float;\n"
+            "uniform sampler2D texSampler;\n"
+            "in vec2 vTexCoord;\n"
+            "in vec4 vColor;\n"
+            "out vec4 fragColor;\n"
+            "void main() {\n"
+            "  float coverage = vTexCoord.x < 0.0 ? 1.0 : texture(texSampler, vTexCoord).r;\n"
+            "  fragColor = vec4(vColor.rgb, vColor.a * coverage);\n"
+            "}\n";
+        PROPAGATE_ERROR(createProgram(vtxSrc, frgSrc, &m_overlayProgram));
+        glUseProgram(m_overlayProgram);
+        glUniform1i(glGetUniformLocation(m_overlayProgram, "texSampler"), 15);
+        m_overlayScaleUniform = glGetUniformLocation(m_overlayProgram, "scale");
+
+        PROPAGATE_ERROR(initializeFontTexture());
+
+        const GLsizei stride = sizeof(NvOverlayVertex);
+        glGenVertexArrays(1, &m_overlayVertexArray);
+        glGenBuffers(1, &m_overlayBuffer);
+        glBindVertexArray(m_overlayVertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, m_overlayBuffer);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride,
+                              (const void *)offsetof(NvOverlayVertex, x));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+                              (const void *)offsetof(NvOverlayVertex, u));
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              (const void *)offsetof(NvOverlayVertex, color));
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    if (overlay.getWidth() == 0 || overlay.getHeight() == 0)
+        ORIGINATE_ERROR("Overlay frame has no size");
+
+    glUseProgram(m_overlayProgram);
+    glBindVertexArray(m_overlayVertexArray);
+
+    // Upload the vertices if the frame changed, orphaning the previous storage.
+    if (&overlay != m_overlaySource || overlay.getGeneration() != m_overlayGeneration)
+    {
+        const std::vector<NvOverlayVertex> &vertices = overlay.getVertices();
+        const GLsizeiptr size = vertices.size() * sizeof(NvOverlayVertex);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_overlayBuffer);
+        if (size > m_overlayBufferSize)
+            m_overlayBufferSize = size * 2;
+        glBufferData(GL_ARRAY_BUFFER, m_overlayBufferSize, NULL, GL_STREAM_DRAW);
+        if (size)
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, &vertices[0]);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_overlaySource = &overlay;
+        m_overlayGeneration = overlay.getGeneration();
+        m_overlayVertexCount = vertices.size();
+    }
+
+    // Map pixels from the top left corner to clip coordinates.
+    if (overlay.getWidth() != m_overlayWidth || overlay.getHeight() != m_overlayHeight)
+    {
+        m_overlayWidth = overlay.getWidth();
+        m_overlayHeight = overlay.getHeight();
+        glUniform2f(m_overlayScaleUniform, 2.0f / m_overlayWidth, -2.0f / m_overlayHeight);
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (m_overlayVertexCount)
+        glDrawArrays(GL_TRIANGLES, 0, m_overlayVertexCount);
+    glBindVertexArray(0);
+
+    return true;
+}
+
 void GLContext::setTextSize(float height, float relativeWidth)
 {
     m_textHeight = height;
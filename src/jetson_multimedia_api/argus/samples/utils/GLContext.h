@@ -36,9 +36,14 @@
 #include <GLES3/gl3.h>
 #include <GLES2/gl2ext.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <vector>
 
 #include "Window.h"
 
+class NvOverlay;
+struct NvOverlayFont;
+
 namespace ArgusSamples
 {
 
@@ -170,8 +175,29 @@ public:
      */
     void renderTextf(const char* format, ...);
 
+    /**
+     * Get the font used for text rendering, to build NvOverlay batches for renderOverlay().
+     */
+    static NvOverlayFont getTextFont();
+
+    /**
+     * Renders all the text and boxes of an NvOverlay frame with a single draw call.
+     * Overlay coordinates are pixels of the current viewport, whose size is passed to
+     * NvOverlay::begin(). The vertices are only uploaded when the frame differs from the
+     * one last rendered. Call it after NvOverlay::end().
+     * Note that overlay rendering uses the text texture in texture unit 15, and leaves the
+     * overlay program current, alpha blending enabled and vertex array object 0 bound.
+     * @param[in] overlay overlay to render.
+     */
+    bool renderOverlay(NvOverlay &overlay);
+
 private:
 
+    /**
+     * Create the font texture in texture unit 15, on first use.
+     */
+    bool initializeFontTexture();
+
     /**
      * Initialize
      */
@@ -209,6 +235,22 @@ private:
     float m_userTextPosition[2];
     float m_textHeight;
     float m_textRelativeWidth;
+    GLint m_textColorUniform;
+    GLint m_textBackgroundUniform;
+    std::vector<GLfloat> m_textVertices;
+    std::vector<GLfloat> m_textCoords;
+
+    /// Overlay rendering state.
+    GLuint m_overlayProgram;
+    GLuint m_overlayVertexArray;
+    GLuint m_overlayBuffer;
+    GLint m_overlayScaleUniform;
+    GLsizeiptr m_overlayBufferSize;
+    GLsizei m_overlayVertexCount;
+    const NvOverlay *m_overlaySource;
+    uint64_t m_overlayGeneration;
+    uint32_t m_overlayWidth;
+    uint32_t m_overlayHeight;
 };
 
 }; // namespace ArgusSamples
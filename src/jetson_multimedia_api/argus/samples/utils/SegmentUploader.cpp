@@ -0,0 +1,733 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SegmentUploader.h"
+#include "Error.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+extern char **environ;
+
+namespace ArgusSamples
+{
+
+#define UPLOADER_PRINT(...)     printf("UPLOADER: " __VA_ARGS__)
+
+// Size of the read buffers, i.e. the largest write to the transfer command.
+static const uint32_t CHUNK_SIZE = 256 * 1024;
+// First retry delay, doubled for every further attempt up to the maximum.
+static const useconds_t RETRY_DELAY_US = 100 * 1000;
+static const useconds_t MAX_RETRY_DELAY_US = 5 * 1000 * 1000;
+// A transfer command which does not take data for this long is considered stuck.
+static const time_t SEND_TIMEOUT_S = 10;
+// Time the remote host has to confirm a segment once all of it was sent.
+static const uint64_t CONFIRM_TIMEOUT_US = 30 * 1000 * 1000;
+// Longest confirmation, the size printed by 'wc -c'.
+static const size_t MAX_REPLY_LENGTH = 64;
+// Poll interval used by the threads to notice shutdown requests.
+static const int POLL_INTERVAL_MS = 100;
+
+// Options shared by the SSH master and transfer commands. Keepalives let a dead connection
+// fail the transfer instead of stalling it.
+static const char *const SSH_OPTIONS[] = {
+    "-o", "BatchMode=yes",
+    "-o", "ServerAliveInterval=5",
+    "-o", "ServerAliveCountMax=3",
+};
+
+static uint64_t getTimeUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool sendAll(int fd, const void *data, size_t size)
+{
+    const uint8_t *ptr = static_cast<const uint8_t*>(data);
+    while (size)
+    {
+        // The transfer command may exit early, don't let that raise SIGPIPE.
+        ssize_t ret = send(fd, ptr, size, MSG_NOSIGNAL);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        ptr += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+/**
+ * Read the output of the transfer command until it exits and parse the stored size.
+ */
+static bool readConfirmation(int fd, uint64_t *stored)
+{
+    std::string reply;
+    uint64_t deadline = getTimeUs() + CONFIRM_TIMEOUT_US;
+    while (getTimeUs() < deadline)
+    {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ret = poll(&pfd, 1, POLL_INTERVAL_MS);
+        if (ret < 0 && errno != EINTR)
+            return false;
+        if (ret <= 0)
+            continue;
+
+        char buffer[MAX_REPLY_LENGTH];
+        ssize_t size = read(fd, buffer, sizeof(buffer));
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size < 0)
+            return false;
+        if (size == 0)
+        {
+            char *end = NULL;
+            errno = 0;
+            *stored = strtoull(reply.c_str(), &end, 10);
+            return !reply.empty() && errno == 0 && end != reply.c_str() &&
+                   strspn(end, " \t\n") == strlen(end);
+        }
+        reply.append(buffer, size);
+        if (reply.size() > MAX_REPLY_LENGTH)
+            return false;
+    }
+    return false;
+}
+
+/**
+ * Start a command in its own process group, so that Ctrl-C on the sample does not kill
+ * the transfers which are still needed to send the last segment.
+ */
+static bool spawnCommand(const std::vector<std::string>& args, int stdinFd, int stdoutFd,
+                         pid_t *pid)
+{
+    std::vector<char*> argv;
+    for (size_t i = 0; i < args.size(); i++)
+        argv.push_back(const_cast<char*>(args[i].c_str()));
+    argv.push_back(NULL);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, stdinFd, STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, stdoutFd, STDOUT_FILENO);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    int ret = posix_spawnp(pid, argv[0], &actions, &attr, &argv[0], environ);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    if (ret != 0)
+    {
+        REPORT_ERROR("Failed to start %s (%s)", argv[0], strerror(ret));
+        return false;
+    }
+    return true;
+}
+
+static bool waitCommand(pid_t pid)
+{
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+            return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static std::string shellQuote(const std::string& str)
+{
+    std::string quoted("'");
+    for (size_t i = 0; i < str.size(); i++)
+    {
+        if (str[i] == '\'')
+            quoted += "'\\''";
+        else
+            quoted += str[i];
+    }
+    return quoted + "'";
+}
+
+static std::string baseName(const std::string& fileName)
+{
+    size_t slash = fileName.find_last_of('/');
+    return (slash == std::string::npos) ? fileName : fileName.substr(slash + 1);
+}
+
+/*******************************************************************************
+ * Uploader worker thread, runs one transfer command at a time.
+ ******************************************************************************/
+class SegmentUploader::Worker : public Thread
+{
+public:
+    explicit Worker(SegmentUploader& uploader)
+        : m_uploader(uploader)
+    {
+    }
+    ~Worker()
+    {
+        shutdown();
+    }
+
+private:
+    /** @name Thread methods */
+    /**@{*/
+    virtual bool threadInitialize();
+    virtual bool threadExecute();
+    virtual bool threadShutdown();
+    /**@}*/
+
+    bool uploadOnce(Segment *segment, uint64_t *busyUs);
+    bool sendSegment(Segment *segment, int fileFd, int fd, uint64_t *sent, uint64_t *busyUs);
+
+    SegmentUploader& m_uploader;
+    std::vector<uint8_t> m_buffer;
+};
+
+bool SegmentUploader::Worker::threadInitialize()
+{
+    m_buffer.resize(CHUNK_SIZE);
+    return true;
+}
+
+bool SegmentUploader::Worker::threadExecute()
+{
+    Segment *segment = m_uploader.takeSegment();
+    if (!segment)
+        return true;
+
+    bool ok = false;
+    uint64_t busyUs = 0;
+    uint32_t attempt = 0;
+    useconds_t delayUs = RETRY_DELAY_US;
+    while (!ok && attempt < m_uploader.m_maxRetries)
+    {
+        if (attempt++)
+        {
+            usleep(delayUs);
+            delayUs = std::min(delayUs * 2, MAX_RETRY_DELAY_US);
+        }
+
+        busyUs = 0;
+        ok = uploadOnce(segment, &busyUs);
+    }
+
+    m_uploader.completeSegment(segment, ok, busyUs, attempt);
+    return true;
+}
+
+bool SegmentUploader::Worker::threadShutdown()
+{
+    return true;
+}
+
+bool SegmentUploader::Worker::sendSegment(Segment *segment, int fileFd, int fd,
+                                          uint64_t *sent, uint64_t *busyUs)
+{
+    // Send the data as it is committed until the segment is finished.
+    uint64_t offset = 0;
+    uint64_t available = 0;
+    bool finished = false;
+    while (true)
+    {
+        m_uploader.waitForData(segment, offset, &available, &finished);
+
+        while (offset < available)
+        {
+            uint64_t start = getTimeUs();
+            uint32_t size = (uint32_t)std::min<uint64_t>(available - offset, CHUNK_SIZE);
+            ssize_t ret = pread(fileFd, &m_buffer[0], size, offset);
+            if (ret <= 0 || !sendAll(fd, &m_buffer[0], ret))
+                return false;
+            offset += ret;
+            *busyUs += getTimeUs() - start;
+        }
+
+        if (finished && offset >= available)
+            break;
+    }
+
+    *sent = offset;
+    return true;
+}
+
+bool SegmentUploader::Worker::uploadOnce(Segment *segment, uint64_t *busyUs)
+{
+    // The master connection may have dropped since the last segment.
+    m_uploader.startMaster();
+
+    // Written to '<name>.part' first, so that a complete file on the remote host is never
+    // mistaken for a partial one. The remote directory was quoted by the constructor.
+    std::string name = baseName(segment->fileName);
+    std::string partName = m_uploader.m_remotePath + shellQuote(name + ".part");
+    std::string fileName = m_uploader.m_remotePath + shellQuote(name);
+    std::vector<std::string> args;
+    m_uploader.getCommand("cat > " + partName + " && mv -f " + partName + " " + fileName +
+                          " && wc -c < " + fileName, &args);
+
+    int fileFd = open(segment->fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileFd < 0)
+        return false;
+
+    // The data goes through a socket rather than a pipe so that it can be sent without
+    // SIGPIPE and with a send timeout. All descriptors are close-on-exec, otherwise the
+    // commands of the other workers would inherit them and never see the end of their input.
+    int dataFds[2];
+    int replyFds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, dataFds) != 0)
+    {
+        close(fileFd);
+        return false;
+    }
+    if (pipe2(replyFds, O_CLOEXEC) != 0)
+    {
+        close(dataFds[0]);
+        close(dataFds[1]);
+        close(fileFd);
+        return false;
+    }
+
+    pid_t pid = -1;
+    bool ok = spawnCommand(args, dataFds[1], replyFds[1], &pid);
+    close(dataFds[1]);
+    close(replyFds[1]);
+
+    uint64_t sent = 0;
+    uint64_t stored = 0;
+    if (ok)
+    {
+        struct timeval tv;
+        tv.tv_sec = SEND_TIMEOUT_S;
+        tv.tv_usec = 0;
+        setsockopt(dataFds[0], SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+        ok = sendSegment(segment, fileFd, dataFds[0], &sent, busyUs);
+
+        // Closing the input ends 'cat', then wait for the remote host to confirm every byte.
+        close(dataFds[0]);
+        dataFds[0] = -1;
+        ok = ok && readConfirmation(replyFds[0], &stored) && (stored == sent);
+
+        if (!ok)
+            kill(pid, SIGKILL);
+        ok = waitCommand(pid) && ok;
+    }
+
+    if (dataFds[0] >= 0)
+        close(dataFds[0]);
+    close(replyFds[0]);
+    close(fileFd);
+    return ok;
+}
+
+/*******************************************************************************
+ * SegmentUploader
+ ******************************************************************************/
+SegmentUploader::SegmentUploader(const std::string& host, const std::string& username,
+                                 const std::string& remotePath, uint32_t maxStreams,
+                                 uint32_t maxRetries, bool keepLocalFiles)
+    : m_host(host)
+    , m_username(username)
+    , m_maxStreams(std::max(maxStreams, 1u))
+    , m_maxRetries(std::max(maxRetries, 1u))
+    , m_keepLocalFiles(keepLocalFiles)
+    , m_nextId(0)
+    , m_draining(false)
+    , m_masterPid(-1)
+{
+    // As with scp, a leading '~/' is the remote home directory. Everything else is quoted
+    // so that the path can't inject commands into the remote shell.
+    std::string path = remotePath.empty() ? std::string("~/") : remotePath;
+    if (path[path.size() - 1] != '/')
+        path += '/';
+    if (path.compare(0, 2, "~/") == 0)
+        m_remotePath = "~/" + shellQuote(path.substr(2));
+    else
+        m_remotePath = shellQuote(path);
+
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&m_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+SegmentUploader::~SegmentUploader()
+{
+    shutdown();
+
+    // Segments left behind if the workers were never started.
+    for (std::map<uint32_t, Segment*>::iterator it = m_segments.begin();
+         it != m_segments.end(); ++it)
+    {
+        delete it->second;
+    }
+
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_lock);
+}
+
+bool SegmentUploader::initialize()
+{
+    if (!m_workers.empty())
+        return true;
+
+    if (!m_host.empty())
+    {
+        // The control socket lives in a directory only this user can access.
+        char controlDir[] = "/tmp/argus_upload_XXXXXX";
+        if (!mkdtemp(controlDir))
+            ORIGINATE_ERROR("Failed to create the SSH control directory");
+        m_controlDir = controlDir;
+        startMaster();
+    }
+
+    for (uint32_t i = 0; i < m_maxStreams; i++)
+    {
+        Worker *worker = new Worker(*this);
+        m_workers.push_back(worker);
+        worker->setThreadRole("uploader");
+        PROPAGATE_ERROR(worker->initialize());
+    }
+
+    if (m_host.empty())
+        UPLOADER_PRINT("Copying to %s with %u stream(s)\n", m_remotePath.c_str(), m_maxStreams);
+    else
+        UPLOADER_PRINT("Copying to %s:%s with %u stream(s)\n",
+                       getDestination().c_str(), m_remotePath.c_str(), m_maxStreams);
+    return true;
+}
+
+bool SegmentUploader::shutdown()
+{
+    if (m_workers.empty())
+        return true;
+
+    // Everything still open is sent as it is, then wait for the queue to drain.
+    pthread_mutex_lock(&m_lock);
+    m_draining = true;
+    uint64_t now = getTimeUs();
+    for (std::map<uint32_t, Segment*>::iterator it = m_segments.begin();
+         it != m_segments.end(); ++it)
+    {
+        if (!it->second->finished)
+        {
+            it->second->finished = true;
+            it->second->finishUs = now;
+        }
+    }
+    pthread_cond_broadcast(&m_cond);
+    while (!m_segments.empty())
+        pthread_cond_wait(&m_cond, &m_lock);
+    pthread_mutex_unlock(&m_lock);
+
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        PROPAGATE_ERROR_CONTINUE(m_workers[i]->shutdown());
+        delete m_workers[i];
+    }
+    m_workers.clear();
+
+    stopMaster();
+    m_draining = false;
+    return true;
+}
+
+std::string SegmentUploader::getDestination() const
+{
+    return m_username.empty() ? m_host : m_username + "@" + m_host;
+}
+
+void SegmentUploader::getCommand(const std::string& remoteCommand,
+                                 std::vector<std::string> *argv)
+{
+    argv->clear();
+    if (m_host.empty())
+    {
+        argv->push_back("sh");
+        argv->push_back("-c");
+        argv->push_back(remoteCommand);
+        return;
+    }
+
+    // Use the master connection if it is up, otherwise ssh connects on its own.
+    argv->push_back("ssh");
+    argv->insert(argv->end(), SSH_OPTIONS,
+                 SSH_OPTIONS + sizeof(SSH_OPTIONS) / sizeof(SSH_OPTIONS[0]));
+    argv->push_back("-o");
+    argv->push_back("ControlMaster=no");
+    argv->push_back("-o");
+    argv->push_back("ControlPath=" + m_controlDir + "/master");
+    argv->push_back("--");
+    argv->push_back(getDestination());
+    argv->push_back(remoteCommand);
+}
+
+void SegmentUploader::startMaster()
+{
+    if (m_host.empty())
+        return;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_masterPid > 0 && waitpid(m_masterPid, NULL, WNOHANG) == m_masterPid)
+    {
+        UPLOADER_PRINT("SSH master connection to %s closed, reconnecting\n",
+                       getDestination().c_str());
+        m_masterPid = -1;
+    }
+    if (m_masterPid < 0)
+    {
+        std::vector<std::string> args;
+        args.push_back("ssh");
+        args.insert(args.end(), SSH_OPTIONS,
+                    SSH_OPTIONS + sizeof(SSH_OPTIONS) / sizeof(SSH_OPTIONS[0]));
+        args.push_back("-M");
+        args.push_back("-N");
+        args.push_back("-o");
+        args.push_back("ControlPersist=no");
+        args.push_back("-o");
+        args.push_back("ControlPath=" + m_controlDir + "/master");
+        args.push_back("--");
+        args.push_back(getDestination());
+
+        int nullFd = open("/dev/null", O_RDWR | O_CLOEXEC);
+        pid_t pid = -1;
+        if (nullFd >= 0 && spawnCommand(args, nullFd, nullFd, &pid))
+            m_masterPid = pid;
+        if (nullFd >= 0)
+            close(nullFd);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void SegmentUploader::stopMaster()
+{
+    pthread_mutex_lock(&m_lock);
+    if (m_masterPid > 0)
+    {
+        kill(m_masterPid, SIGTERM);
+        waitCommand(m_masterPid);
+    }
+    m_masterPid = -1;
+    pthread_mutex_unlock(&m_lock);
+
+    if (!m_controlDir.empty())
+    {
+        unlink((m_controlDir + "/master").c_str());
+        rmdir(m_controlDir.c_str());
+        m_controlDir.clear();
+    }
+}
+
+uint32_t SegmentUploader::beginSegment(const std::string& fileName)
+{
+    Segment *segment = new Segment;
+    segment->fileName = fileName;
+    segment->committed = 0;
+    segment->finished = false;
+    segment->finishUs = 0;
+
+    pthread_mutex_lock(&m_lock);
+    segment->id = m_nextId++;
+    m_segments[segment->id] = segment;
+    m_queue.push_back(segment);
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    return segment->id;
+}
+
+void SegmentUploader::segmentProgress(uint32_t id, uint64_t bytes)
+{
+    pthread_mutex_lock(&m_lock);
+    std::map<uint32_t, Segment*>::iterator it = m_segments.find(id);
+    if (it != m_segments.end() && !it->second->finished && bytes > it->second->committed)
+    {
+        it->second->committed = bytes;
+        pthread_cond_broadcast(&m_cond);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void SegmentUploader::finishSegment(uint32_t id, uint64_t size)
+{
+    pthread_mutex_lock(&m_lock);
+    std::map<uint32_t, Segment*>::iterator it = m_segments.find(id);
+    if (it != m_segments.end() && !it->second->finished)
+    {
+        it->second->committed = size;
+        it->second->finished = true;
+        it->second->finishUs = getTimeUs();
+        pthread_cond_broadcast(&m_cond);
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+void SegmentUploader::sendFile(const std::string& fileName)
+{
+    struct stat st;
+    if (stat(fileName.c_str(), &st) != 0)
+    {
+        REPORT_ERROR("Failed to stat %s", fileName.c_str());
+        return;
+    }
+    finishSegment(beginSegment(fileName), st.st_size);
+}
+
+SegmentUploader::Segment *SegmentUploader::takeSegment()
+{
+    Segment *segment = NULL;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_queue.empty())
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_nsec += POLL_INTERVAL_MS * 1000000;
+        if (ts.tv_nsec >= 1000000000)
+        {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&m_cond, &m_lock, &ts);
+    }
+    if (!m_queue.empty())
+    {
+        segment = m_queue.front();
+        m_queue.pop_front();
+    }
+    pthread_mutex_unlock(&m_lock);
+
+    return segment;
+}
+
+bool SegmentUploader::waitForData(Segment *segment, uint64_t offset,
+                                  uint64_t *available, bool *finished)
+{
+    pthread_mutex_lock(&m_lock);
+    while (segment->committed <= offset && !segment->finished)
+        pthread_cond_wait(&m_cond, &m_lock);
+    *available = segment->committed;
+    *finished = segment->finished;
+    pthread_mutex_unlock(&m_lock);
+
+    return true;
+}
+
+void SegmentUploader::completeSegment(Segment *segment, bool ok, uint64_t busyUs,
+                                      uint32_t attempts)
+{
+    uint64_t latencyUs = getTimeUs() - segment->finishUs;
+    uint64_t size = segment->committed;
+
+    pthread_mutex_lock(&m_lock);
+    m_stats.retries += attempts - 1;
+    if (ok)
+    {
+        m_stats.segments++;
+        m_stats.bytes += size;
+        m_stats.totalLatencyUs += latencyUs;
+        m_stats.maxLatencyUs = std::max(m_stats.maxLatencyUs, latencyUs);
+        m_stats.totalBusyUs += busyUs;
+    }
+    else
+    {
+        m_stats.failed++;
+    }
+    m_segments.erase(segment->id);
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+
+    if (ok)
+    {
+        UPLOADER_PRINT("Sent %s (%lu bytes, %.1f ms after close, %.1f MB/s, %u attempt(s))\n",
+                       segment->fileName.c_str(), size, latencyUs / 1000.0,
+                       busyUs ? (double)size / busyUs : 0.0, attempts);
+        if (!m_keepLocalFiles && unlink(segment->fileName.c_str()) != 0)
+            REPORT_ERROR("Failed to delete %s", segment->fileName.c_str());
+    }
+    else
+    {
+        REPORT_ERROR("Failed to copy %s after %u attempt(s), keeping the local file",
+                     segment->fileName.c_str(), attempts);
+    }
+
+    delete segment;
+}
+
+void SegmentUploader::getStats(SegmentUploadStats *stats) const
+{
+    pthread_mutex_lock(&m_lock);
+    *stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+}
+
+void SegmentUploader::printStats() const
+{
+    SegmentUploadStats stats;
+    getStats(&stats);
+
+    printf("----------- SegmentUploader -----------\n");
+    printf("Segments sent: %lu, failed: %lu, retries: %lu\n",
+           stats.segments, stats.failed, stats.retries);
+    printf("Bytes sent: %lu\n", stats.bytes);
+    if (stats.segments)
+    {
+        printf("Latency after close: avg %.1f ms, max %.1f ms\n",
+               stats.totalLatencyUs / 1000.0 / stats.segments, stats.maxLatencyUs / 1000.0);
+    }
+    if (stats.totalBusyUs)
+        printf("Send throughput: %.1f MB/s\n", (double)stats.bytes / stats.totalBusyUs);
+}
+
+} // namespace ArgusSamples
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEGMENT_UPLOADER_H
+#define SEGMENT_UPLOADER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Thread.h"
+
+namespace ArgusSamples
+{
+
+/**
+ * Upload statistics, accumulated over all segments.
+ */
+struct SegmentUploadStats
+{
+    uint64_t segments;          ///< segments confirmed by the remote host
+    uint64_t failed;            ///< segments given up after all retries
+    uint64_t retries;           ///< attempts repeated after a failure
+    uint64_t bytes;             ///< bytes confirmed by the remote host
+    uint64_t totalLatencyUs;    ///< sum of the time from finishSegment() to the confirmation
+    uint64_t maxLatencyUs;      ///< largest time from finishSegment() to the confirmation
+    uint64_t totalBusyUs;       ///< sum of the time spent reading and sending segment data
+};
+
+/*******************************************************************************
+ * Segment uploader:
+ *   Streams file segments to a remote host over SSH while they are being
+ *   written. All transfers share one SSH master connection, so a segment
+ *   costs a channel on that connection instead of a new handshake. The data
+ *   is piped into 'cat' on the remote host, which writes '<name>.part' and
+ *   renames it once complete, then reports the stored size. At most
+ *   'maxStreams' segments are in flight. A failed attempt is retried with
+ *   exponential backoff and restarts the segment from the beginning.
+ *
+ *   As with scp, passwordless SSH login must be configured for the remote
+ *   user. An empty host runs the commands with the local shell instead,
+ *   which lets the uploader be tested without an SSH server.
+ ******************************************************************************/
+class SegmentUploader
+{
+public:
+    /**
+     * @param host [in] host name or IP address of the remote host, empty for the local shell
+     * @param username [in] user on the remote host, empty for the SSH default
+     * @param remotePath [in] directory on the remote host the segments are copied to
+     * @param maxStreams [in] number of segments uploaded in parallel
+     * @param maxRetries [in] attempts per segment before it is given up
+     * @param keepLocalFiles [in] if false, a segment is deleted once the remote host confirmed it
+     */
+    SegmentUploader(const std::string& host, const std::string& username,
+                    const std::string& remotePath, uint32_t maxStreams,
+                    uint32_t maxRetries, bool keepLocalFiles);
+    ~SegmentUploader();
+
+    /**
+     * Start the SSH master connection and the worker threads.
+     */
+    bool initialize();
+
+    /**
+     * Wait until every queued segment is confirmed or given up, then stop the workers
+     * and the SSH master connection.
+     * Segments which were not finished are sent with the bytes committed so far.
+     */
+    bool shutdown();
+
+    /**
+     * Queue a segment which is about to be written. Data is sent as soon as it is committed
+     * with segmentProgress().
+     *
+     * @param fileName [in] local file, the remote host stores it under its base name
+     * @returns the segment ID passed to segmentProgress() and finishSegment()
+     */
+    uint32_t beginSegment(const std::string& fileName);
+
+    /**
+     * Report that the first 'bytes' bytes of the segment are on disk (i.e. flushed).
+     */
+    void segmentProgress(uint32_t id, uint64_t bytes);
+
+    /**
+     * Report that the segment is complete with 'size' bytes.
+     */
+    void finishSegment(uint32_t id, uint64_t size);
+
+    /**
+     * Queue a file which is already complete.
+     */
+    void sendFile(const std::string& fileName);
+
+    void getStats(SegmentUploadStats *stats) const;
+    void printStats() const;
+
+private:
+    struct Segment
+    {
+        uint32_t id;
+        std::string fileName;
+        uint64_t committed;     ///< bytes which may be read from the file
+        bool finished;          ///< 'committed' is the final size
+        uint64_t finishUs;      ///< time finishSegment() was called
+    };
+
+    class Worker;
+
+    Segment *takeSegment();
+    bool waitForData(Segment *segment, uint64_t offset, uint64_t *available, bool *finished);
+    void completeSegment(Segment *segment, bool ok, uint64_t busyUs, uint32_t attempts);
+
+    void startMaster();
+    void stopMaster();
+    void getCommand(const std::string& remoteCommand, std::vector<std::string> *argv);
+    std::string getDestination() const;
+
+    std::string m_host;
+    std::string m_username;
+    std::string m_remotePath;   ///< shell expression of the remote directory, ends with '/'
+    uint32_t m_maxStreams;
+    uint32_t m_maxRetries;
+    bool m_keepLocalFiles;
+
+    mutable pthread_mutex_t m_lock;
+    pthread_cond_t m_cond;      ///< signaled on any change of the segments below
+    std::deque<Segment*> m_queue;
+    std::map<uint32_t, Segment*> m_segments;  ///< queued and in-flight segments
+    uint32_t m_nextId;
+    bool m_draining;
+    SegmentUploadStats m_stats;
+
+    std::string m_controlDir;   ///< private directory holding the SSH control socket
+    pid_t m_masterPid;          ///< SSH master process, -1 if not running (guarded by m_lock)
+
+    std::vector<Worker*> m_workers;
+};
+
+} // namespace ArgusSamples
+
+#endif // SEGMENT_UPLOADER_H
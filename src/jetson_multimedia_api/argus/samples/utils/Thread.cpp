@@ -28,6 +28,7 @@
 
 #include "Thread.h"
 #include "Error.h"
+#include "NvThreadPolicy.h"
 
 namespace ArgusSamples
 {
@@ -35,6 +36,7 @@ namespace ArgusSamples
 Thread::Thread()
     : m_doShutdown(false)
     , m_threadID(0)
+    , m_threadRole("argus")
     , m_threadState(THREAD_INACTIVE)
 
 {
@@ -123,6 +125,8 @@ bool Thread::threadFunction()
 {
     m_threadState = THREAD_INITIALIZING;
 
+    NvThreadPolicy::getInstance().applyToCurrentThread(m_threadRole);
+
     PROPAGATE_ERROR(threadInitialize());
 
     m_threadState = THREAD_RUNNING;
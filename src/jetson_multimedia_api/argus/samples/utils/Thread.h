@@ -63,6 +63,17 @@ public:
      */
     bool waitRunning(useconds_t timeoutUs = 5 * 1000 * 1000);
 
+    /**
+     * Set the role used to look up the thread placement and scheduling policy
+     * (see NvThreadPolicy). Has to be called before initialize().
+     *
+     * @param role [in] role name, the string has to stay valid while the thread runs
+     */
+    void setThreadRole(const char *role)
+    {
+        m_threadRole = role;
+    }
+
  protected:
     virtual bool threadInitialize() = 0;
     virtual bool threadExecute() = 0;
@@ -81,6 +92,7 @@ public:
 
 private:
     pthread_t m_threadID;       ///< thread ID
+    const char *m_threadRole;   ///< role for the thread policy
 
     /**
      * Thread states
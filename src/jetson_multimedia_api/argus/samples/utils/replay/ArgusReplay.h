@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARGUS_REPLAY_H
+#define ARGUS_REPLAY_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include <Argus/Argus.h>
+
+namespace ArgusSamples
+{
+
+/**
+ * Software stand-in for libnvargus. Linking against libargusreplay instead of the Argus
+ * library provides Argus::CameraProvider::create() and EGLStream::FrameConsumer::create()
+ * implementations that play synthetic or recorded YUV frames into the application's
+ * consumers at the sensor frame rate, without a camera, a GPU or an EGL implementation.
+ *
+ * Only the subset of the API used by the FrameConsumer based samples is implemented:
+ * EGL output streams of PIXEL_FMT_YCbCr_420_888 or PIXEL_FMT_Y8, the source, auto control
+ * and stream settings of a Request, capture complete events and capture metadata with
+ * sensor timestamps, frame numbers and Bayer/RGB histograms. JPEG encoding, buffer streams,
+ * native buffers and GL preview consumers are not available.
+ *
+ * The producer models the EGLStream buffer pool. A FIFO stream stalls the capture when the
+ * consumer holds or has not yet acquired all buffers and a mailbox stream overwrites frames
+ * that were not acquired in time, so consumer backpressure and frame lifetime problems show
+ * up the same way they do with a real sensor.
+ */
+namespace Replay
+{
+
+/**
+ * Layout of the frames in a replay file.
+ */
+enum FileFormat
+{
+    FILE_FORMAT_NV12,   ///< Y plane followed by an interleaved CbCr plane
+    FILE_FORMAT_I420,   ///< Y plane followed by the Cb and Cr planes
+};
+
+/**
+ * Replay configuration. Options() reads its defaults from the environment so that unmodified
+ * samples can be configured without code changes:
+ *
+ *   ARGUS_REPLAY_FILE=<path>         raw frames to replay, a moving test pattern if unset
+ *   ARGUS_REPLAY_FORMAT=nv12|i420    layout of the file frames (nv12)
+ *   ARGUS_REPLAY_SIZE=<w>x<h>        sensor mode and file frame resolution (1920x1080)
+ *   ARGUS_REPLAY_FPS=<fps>           maximum sensor frame rate (30)
+ *   ARGUS_REPLAY_JITTER_US=<us>      maximum random delivery delay per frame (0)
+ *   ARGUS_REPLAY_DROP_EVERY=<n>      drop every nth sensor frame (0, never)
+ *   ARGUS_REPLAY_DROP_RATE=<p>       probability to drop a sensor frame (0.0)
+ *   ARGUS_REPLAY_SEED=<n>            seed for jitter and random drops (1)
+ *   ARGUS_REPLAY_DEVICES=<n>         number of camera devices (1)
+ *   ARGUS_REPLAY_STALL_MS=<ms>       report a producer stall after this time (1000)
+ *   ARGUS_REPLAY_STATS=1             print the statistics when the provider is destroyed
+ */
+struct Options
+{
+    Options();
+
+    std::string file;                   ///< Raw frames to replay, the test pattern if empty
+    FileFormat fileFormat;              ///< Layout of the file frames
+    Argus::Size2D<uint32_t> resolution; ///< Sensor mode resolution, also the file frame size
+    uint64_t frameDuration;             ///< Minimum sensor frame duration in nanoseconds
+    uint64_t jitter;                    ///< Maximum random delivery delay in nanoseconds
+    uint32_t dropInterval;              ///< Drop every nth sensor frame, 0 to disable
+    float dropRate;                     ///< Probability to drop a sensor frame
+    uint32_t seed;                      ///< Seed for the jitter and random drops
+    uint32_t numDevices;                ///< Number of camera devices
+    uint64_t stallWarning;              ///< Report producer stalls longer than this, in ns
+    bool printStats;                    ///< Print statistics when the provider is destroyed
+};
+
+/**
+ * Sets the options used by the next CameraProvider::create(). Must be called before the
+ * provider is created.
+ */
+void setOptions(const Options& options);
+
+/**
+ * Returns the options used by CameraProvider::create().
+ */
+Options getOptions();
+
+/**
+ * Replay statistics, accumulated over all sessions and streams. Times are in nanoseconds.
+ */
+struct Stats
+{
+    uint64_t captures;          ///< Sensor frames captured, including dropped ones
+    uint64_t dropped;           ///< Sensor frames dropped by injection
+    uint64_t delivered;         ///< Frames queued to output streams
+    uint64_t overwritten;       ///< Mailbox frames replaced before they were acquired
+    uint64_t unconsumed;        ///< Frames discarded because no consumer was connected
+    uint64_t stalls;            ///< Captures that waited for a free stream buffer
+    uint64_t stallTime;         ///< Total time the producer waited for free buffers
+    uint64_t acquired;          ///< Frames acquired by consumers
+    uint64_t queueTime;         ///< Total time from delivery until acquireFrame()
+    uint64_t holdTime;          ///< Total time from acquireFrame() until Frame::destroy()
+    uint64_t maxHoldTime;       ///< Longest time a consumer held a frame
+};
+
+/**
+ * Returns the statistics since the last resetStats().
+ */
+Stats getStats();
+
+/**
+ * Clears the statistics.
+ */
+void resetStats();
+
+/**
+ * Prints the statistics to stdout.
+ */
+void printStats();
+
+} // namespace Replay
+
+} // namespace ArgusSamples
+
+#endif // ARGUS_REPLAY_H
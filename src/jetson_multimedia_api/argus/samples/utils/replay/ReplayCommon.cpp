@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "ReplayInternal.h"
+
+namespace ArgusSamples
+{
+
+namespace Replay
+{
+
+static Mutex s_optionsMutex;
+static Options s_options;
+static bool s_optionsSet = false;
+
+static Mutex s_statsMutex;
+static Stats s_stats;
+
+static const char* getEnv(const char* name)
+{
+    const char* value = getenv(name);
+    return (value && *value) ? value : NULL;
+}
+
+Options::Options()
+    : fileFormat(FILE_FORMAT_NV12)
+    , resolution(1920, 1080)
+    , frameDuration(1000000000ull / 30)
+    , jitter(0)
+    , dropInterval(0)
+    , dropRate(0.0f)
+    , seed(1)
+    , numDevices(1)
+    , stallWarning(1000000000ull)
+    , printStats(false)
+{
+    const char* value;
+
+    if ((value = getEnv("ARGUS_REPLAY_FILE")))
+        file = value;
+    if ((value = getEnv("ARGUS_REPLAY_FORMAT")))
+    {
+        if (!strcasecmp(value, "i420"))
+            fileFormat = FILE_FORMAT_I420;
+        else if (strcasecmp(value, "nv12"))
+            REPLAY_LOG("Unknown ARGUS_REPLAY_FORMAT '%s', using nv12", value);
+    }
+    if ((value = getEnv("ARGUS_REPLAY_SIZE")))
+    {
+        uint32_t width, height;
+        if (sscanf(value, "%ux%u", &width, &height) == 2 && width >= 2 && height >= 2)
+            resolution = Argus::Size2D<uint32_t>(width & ~1u, height & ~1u);
+        else
+            REPLAY_LOG("Invalid ARGUS_REPLAY_SIZE '%s'", value);
+    }
+    if ((value = getEnv("ARGUS_REPLAY_FPS")))
+    {
+        float fps = atof(value);
+        if (fps > 0.0f)
+            frameDuration = (uint64_t)(1000000000.0 / fps);
+    }
+    if ((value = getEnv("ARGUS_REPLAY_JITTER_US")))
+        jitter = strtoull(value, NULL, 0) * 1000;
+    if ((value = getEnv("ARGUS_REPLAY_DROP_EVERY")))
+        dropInterval = strtoul(value, NULL, 0);
+    if ((value = getEnv("ARGUS_REPLAY_DROP_RATE")))
+        dropRate = atof(value);
+    if ((value = getEnv("ARGUS_REPLAY_SEED")))
+        seed = strtoul(value, NULL, 0);
+    if ((value = getEnv("ARGUS_REPLAY_DEVICES")))
+        numDevices = strtoul(value, NULL, 0);
+    if ((value = getEnv("ARGUS_REPLAY_STALL_MS")))
+        stallWarning = strtoull(value, NULL, 0) * 1000000;
+    if ((value = getEnv("ARGUS_REPLAY_STATS")))
+        printStats = atoi(value) != 0;
+}
+
+void setOptions(const Options& options)
+{
+    ScopedLock lock(s_optionsMutex);
+    s_options = options;
+    s_optionsSet = true;
+}
+
+Options getOptions()
+{
+    ScopedLock lock(s_optionsMutex);
+    if (!s_optionsSet)
+    {
+        s_options = Options();
+        s_optionsSet = true;
+    }
+    return s_options;
+}
+
+Stats getStats()
+{
+    ScopedLock lock(s_statsMutex);
+    return s_stats;
+}
+
+void resetStats()
+{
+    ScopedLock lock(s_statsMutex);
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void printStats()
+{
+    const Stats stats = getStats();
+
+    printf("Argus replay statistics:\n");
+    printf("  Sensor frames  : %" PRIu64 " (%" PRIu64 " dropped)\n", stats.captures, stats.dropped);
+    printf("  Delivered      : %" PRIu64 " (%" PRIu64 " overwritten, %" PRIu64 " without consumer)\n",
+           stats.delivered, stats.overwritten, stats.unconsumed);
+    printf("  Producer stalls: %" PRIu64 " (%.3f ms total)\n", stats.stalls, stats.stallTime / 1e6);
+    printf("  Acquired       : %" PRIu64 "\n", stats.acquired);
+    if (stats.acquired)
+    {
+        printf("  Avg queue time : %.3f ms\n", stats.queueTime / 1e6 / stats.acquired);
+        printf("  Avg hold time  : %.3f ms (max %.3f ms)\n",
+               stats.holdTime / 1e6 / stats.acquired, stats.maxHoldTime / 1e6);
+    }
+}
+
+void countStat(uint64_t Stats::*counter, uint64_t value)
+{
+    ScopedLock lock(s_statsMutex);
+    s_stats.*counter += value;
+}
+
+void holdStat(uint64_t holdTime)
+{
+    ScopedLock lock(s_statsMutex);
+    s_stats.holdTime += holdTime;
+    if (holdTime > s_stats.maxHoldTime)
+        s_stats.maxHoldTime = holdTime;
+}
+
+uint64_t getTimeNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+uint64_t getDeadline(uint64_t timeout)
+{
+    if (timeout == Argus::TIMEOUT_INFINITE)
+        return UINT64_MAX;
+
+    const uint64_t now = getTimeNs();
+    return (timeout > UINT64_MAX - now) ? UINT64_MAX : now + timeout;
+}
+
+Condition::Condition()
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&m_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+Condition::~Condition()
+{
+    pthread_cond_destroy(&m_cond);
+}
+
+bool Condition::waitUntil(Mutex& mutex, uint64_t deadline)
+{
+    if (deadline == UINT64_MAX)
+    {
+        pthread_cond_wait(&m_cond, &mutex.m_mutex);
+        return true;
+    }
+
+    struct timespec ts;
+    ts.tv_sec = deadline / 1000000000ull;
+    ts.tv_nsec = deadline % 1000000000ull;
+    return pthread_cond_timedwait(&m_cond, &mutex.m_mutex, &ts) != ETIMEDOUT;
+}
+
+void ImageData::allocate(const Argus::PixelFormat& format,
+                         const Argus::Size2D<uint32_t>& resolution)
+{
+    planeCount = (format == Argus::PIXEL_FMT_Y8) ? 1 : 2;
+    size[0] = resolution;
+    size[1] = Argus::Size2D<uint32_t>(resolution.width() / 2, resolution.height() / 2);
+
+    for (uint32_t i = 0; i < planeCount; i++)
+    {
+        const uint32_t rowBytes = (i == 0) ? size[i].width() : size[i].width() * 2;
+        stride[i] = (rowBytes + STRIDE_ALIGNMENT - 1) & ~(STRIDE_ALIGNMENT - 1);
+        data[i].assign((size_t)stride[i] * size[i].height(), 0);
+    }
+}
+
+FrameSource::FrameSource()
+    : m_fileFormat(FILE_FORMAT_NV12)
+    , m_file(NULL)
+    , m_fileFrames(0)
+    , m_sequence(0)
+    , m_loadedFrame(UINT64_MAX)
+{
+}
+
+FrameSource::~FrameSource()
+{
+    if (m_file)
+        fclose(m_file);
+}
+
+bool FrameSource::initialize(const Options& options)
+{
+    m_resolution = options.resolution;
+    m_fileFormat = options.fileFormat;
+
+    if (options.file.empty())
+        return true;
+
+    const uint64_t frameSize = (uint64_t)m_resolution.area() * 3 / 2;
+    struct stat st;
+
+    m_file = fopen(options.file.c_str(), "rb");
+    if (!m_file || fstat(fileno(m_file), &st) != 0)
+    {
+        REPLAY_LOG("Failed to open replay file %s: %s", options.file.c_str(), strerror(errno));
+        return false;
+    }
+
+    m_fileFrames = (uint64_t)st.st_size / frameSize;
+    if (m_fileFrames == 0)
+    {
+        REPLAY_LOG("Replay file %s holds no complete %ux%u frame", options.file.c_str(),
+                   m_resolution.width(), m_resolution.height());
+        return false;
+    }
+
+    m_luma.resize(m_resolution.area());
+    m_chroma.resize(m_resolution.area() / 2);
+    return true;
+}
+
+bool FrameSource::prepare(uint64_t sequence)
+{
+    m_sequence = sequence;
+    if (!m_file)
+        return true;
+
+    const uint64_t frame = sequence % m_fileFrames;
+    if (frame == m_loadedFrame)
+        return true;
+
+    const size_t lumaSize = m_luma.size();
+    const size_t chromaSize = m_chroma.size();
+
+    m_loadedFrame = UINT64_MAX;
+    if (fseeko(m_file, (off_t)(frame * (lumaSize + chromaSize)), SEEK_SET) != 0 ||
+        fread(m_luma.data(), 1, lumaSize, m_file) != lumaSize)
+    {
+        REPLAY_LOG("Failed to read replay frame %" PRIu64, frame);
+        return false;
+    }
+
+    if (m_fileFormat == FILE_FORMAT_NV12)
+    {
+        if (fread(m_chroma.data(), 1, chromaSize, m_file) != chromaSize)
+        {
+            REPLAY_LOG("Failed to read replay frame %" PRIu64, frame);
+            return false;
+        }
+    }
+    else
+    {
+        std::vector<uint8_t> planes(chromaSize);
+        if (fread(planes.data(), 1, chromaSize, m_file) != chromaSize)
+        {
+            REPLAY_LOG("Failed to read replay frame %" PRIu64, frame);
+            return false;
+        }
+        const size_t planeSize = chromaSize / 2;
+        for (size_t i = 0; i < planeSize; i++)
+        {
+            m_chroma[2 * i] = planes[i];
+            m_chroma[2 * i + 1] = planes[planeSize + i];
+        }
+    }
+
+    m_loadedFrame = frame;
+    return true;
+}
+
+/**
+ * The test pattern is a luma ramp scrolling one step per frame with a bright square moving
+ * across it, so dropped, repeated or reordered frames are visible in the output.
+ */
+uint8_t FrameSource::getPatternLuma(uint32_t x, uint32_t y) const
+{
+    const uint32_t width = m_resolution.width();
+    const uint32_t height = m_resolution.height();
+    const uint32_t box = height / 6 + 1;
+    const uint32_t boxX = (uint32_t)((m_sequence * (width / 90 + 1)) % (width - box + 1));
+    const uint32_t boxY = (height - box) / 2;
+
+    if (x >= boxX && x < boxX + box && y >= boxY && y < boxY + box)
+        return 235;
+    return 16 + (uint8_t)(((uint64_t)x * 219 / width + m_sequence * 4) % 219);
+}
+
+uint8_t FrameSource::getLuma(uint32_t x, uint32_t y) const
+{
+    if (m_file)
+        return m_luma[(size_t)y * m_resolution.width() + x];
+    return getPatternLuma(x, y);
+}
+
+void FrameSource::renderLuma(const uint8_t* lut, ImageData* image) const
+{
+    const uint32_t width = image->size[0].width();
+    const uint32_t height = image->size[0].height();
+    const uint32_t sensorWidth = m_resolution.width();
+    const uint32_t sensorHeight = m_resolution.height();
+    std::vector<uint32_t> columns(width);
+
+    for (uint32_t x = 0; x < width; x++)
+        columns[x] = (uint32_t)((uint64_t)x * sensorWidth / width);
+
+    if (m_file)
+    {
+        for (uint32_t y = 0; y < height; y++)
+        {
+            const uint8_t* src = &m_luma[(size_t)((uint64_t)y * sensorHeight / height) * sensorWidth];
+            uint8_t* dst = &image->data[0][(size_t)y * image->stride[0]];
+            for (uint32_t x = 0; x < width; x++)
+                dst[x] = lut[src[columns[x]]];
+        }
+        return;
+    }
+
+    // Pattern rows only differ inside the square; build the two row variants once.
+    const uint32_t box = sensorHeight / 6 + 1;
+    const uint32_t boxY = (sensorHeight - box) / 2;
+    std::vector<uint8_t> plainRow(width);
+    std::vector<uint8_t> boxRow(width);
+
+    for (uint32_t x = 0; x < width; x++)
+    {
+        plainRow[x] = lut[getPatternLuma(columns[x], 0)];
+        boxRow[x] = lut[getPatternLuma(columns[x], boxY)];
+    }
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint32_t sensorY = (uint32_t)((uint64_t)y * sensorHeight / height);
+        const bool inBox = sensorY >= boxY && sensorY < boxY + box;
+        memcpy(&image->data[0][(size_t)y * image->stride[0]],
+               inBox ? boxRow.data() : plainRow.data(), width);
+    }
+}
+
+void FrameSource::renderChroma(ImageData* image) const
+{
+    const uint32_t width = image->size[1].width();
+    const uint32_t height = image->size[1].height();
+    const uint32_t sensorWidth = m_resolution.width() / 2;
+    const uint32_t sensorHeight = m_resolution.height() / 2;
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint32_t sensorY = (uint32_t)((uint64_t)y * sensorHeight / height);
+        uint8_t* dst = &image->data[1][(size_t)y * image->stride[1]];
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            const uint32_t sensorX = (uint32_t)((uint64_t)x * sensorWidth / width);
+            if (m_file)
+            {
+                const uint8_t* src = &m_chroma[((size_t)sensorY * sensorWidth + sensorX) * 2];
+                dst[2 * x] = src[0];
+                dst[2 * x + 1] = src[1];
+            }
+            else
+            {
+                dst[2 * x] = 64 + (uint8_t)(sensorX * 128 / sensorWidth);
+                dst[2 * x + 1] = 64 + (uint8_t)(sensorY * 128 / sensorHeight);
+            }
+        }
+    }
+}
+
+static void buildBrightnessLut(float brightness, uint8_t* lut)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        const float value = i * brightness + 0.5f;
+        lut[i] = value >= 255.0f ? 255 : (uint8_t)value;
+    }
+}
+
+void FrameSource::render(float brightness, ImageData* image) const
+{
+    uint8_t lut[256];
+
+    buildBrightnessLut(brightness, lut);
+    renderLuma(lut, image);
+    if (image->planeCount > 1)
+        renderChroma(image);
+}
+
+void FrameSource::computeHistogram(float brightness, uint32_t binCount,
+                                   std::vector<uint32_t>* bins) const
+{
+    // Statistics are gathered on a subsampled grid, like the ISP statistics engine.
+    static const uint32_t GRID_WIDTH = 128;
+    static const uint32_t GRID_HEIGHT = 72;
+    uint8_t lut[256];
+
+    buildBrightnessLut(brightness, lut);
+    bins->assign(binCount, 0);
+
+    for (uint32_t gy = 0; gy < GRID_HEIGHT; gy++)
+    {
+        const uint32_t y = (uint32_t)((uint64_t)(2 * gy + 1) * m_resolution.height() /
+                                      (2 * GRID_HEIGHT));
+        for (uint32_t gx = 0; gx < GRID_WIDTH; gx++)
+        {
+            const uint32_t x = (uint32_t)((uint64_t)(2 * gx + 1) * m_resolution.width() /
+                                          (2 * GRID_WIDTH));
+            (*bins)[lut[getLuma(x, y)] * binCount / 256]++;
+        }
+    }
+}
+
+} // namespace Replay
+
+} // namespace ArgusSamples
@@ -0,0 +1,620 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARGUS_REPLAY_INTERNAL_H
+#define ARGUS_REPLAY_INTERNAL_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Argus/Argus.h>
+#include <EGLStream/EGLStream.h>
+
+#include "ArgusReplay.h"
+
+namespace ArgusSamples
+{
+
+namespace Replay
+{
+
+#define REPLAY_LOG(_str, ...) \
+    fprintf(stderr, "ArgusReplay: " _str "\n", ##__VA_ARGS__)
+
+/**
+ * Returns the CLOCK_MONOTONIC time in nanoseconds, the time base of the sensor timestamps.
+ */
+uint64_t getTimeNs();
+
+/**
+ * Converts an Argus relative timeout to an absolute getTimeNs() deadline.
+ */
+uint64_t getDeadline(uint64_t timeout);
+
+/**
+ * Adds 'value' to a statistics counter.
+ */
+void countStat(uint64_t Stats::*counter, uint64_t value = 1);
+
+/**
+ * Records the time a consumer held a frame.
+ */
+void holdStat(uint64_t holdTime);
+
+/**
+ * pthread mutex, and a scoped lock for it.
+ */
+class Mutex
+{
+public:
+    Mutex()             { pthread_mutex_init(&m_mutex, NULL); }
+    ~Mutex()            { pthread_mutex_destroy(&m_mutex); }
+    void lock()         { pthread_mutex_lock(&m_mutex); }
+    void unlock()       { pthread_mutex_unlock(&m_mutex); }
+
+private:
+    pthread_mutex_t m_mutex;
+    friend class Condition;
+};
+
+class ScopedLock
+{
+public:
+    explicit ScopedLock(Mutex& mutex) : m_mutex(mutex) { m_mutex.lock(); }
+    ~ScopedLock() { m_mutex.unlock(); }
+
+private:
+    Mutex& m_mutex;
+};
+
+/**
+ * Condition variable waiting on the CLOCK_MONOTONIC time base.
+ */
+class Condition
+{
+public:
+    Condition();
+    ~Condition();
+
+    void signal()       { pthread_cond_signal(&m_cond); }
+    void broadcast()    { pthread_cond_broadcast(&m_cond); }
+
+    /**
+     * Waits for a signal or until the absolute getTimeNs() 'deadline'.
+     * Returns false if the deadline passed.
+     */
+    bool waitUntil(Mutex& mutex, uint64_t deadline);
+
+private:
+    pthread_cond_t m_cond;
+};
+
+/**
+ * Small xorshift generator, so replays with the same seed produce the same frame timing
+ * and drops.
+ */
+class Random
+{
+public:
+    explicit Random(uint32_t seed) : m_state(seed ? seed : 1) {}
+
+    uint32_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    /// Returns a value in [0, 1)
+    float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+private:
+    uint32_t m_state;
+};
+
+/**
+ * Pixel storage of one stream buffer. YCbCr_420_888 is stored as NV12, Y8 as a single plane.
+ * Rows are padded to the hardware pitch alignment so consumers that ignore the stride
+ * are caught.
+ */
+struct ImageData
+{
+    static const uint32_t STRIDE_ALIGNMENT = 256;
+
+    ImageData() : planeCount(0) {}
+
+    void allocate(const Argus::PixelFormat& format, const Argus::Size2D<uint32_t>& resolution);
+
+    uint32_t planeCount;
+    Argus::Size2D<uint32_t> size[2];
+    uint32_t stride[2];
+    std::vector<uint8_t> data[2];
+};
+
+/**
+ * Generates the sensor frames, either a moving test pattern or the frames of a raw file.
+ */
+class FrameSource
+{
+public:
+    FrameSource();
+    ~FrameSource();
+
+    bool initialize(const Options& options);
+
+    /**
+     * Selects the sensor frame with the given sequence number for render() and
+     * computeHistogram(). Replay files loop when the end is reached.
+     */
+    bool prepare(uint64_t sequence);
+
+    /**
+     * Scales the current frame to the size of 'image' and applies the exposure 'brightness'.
+     */
+    void render(float brightness, ImageData* image) const;
+
+    /**
+     * Computes a luma histogram of the current frame.
+     */
+    void computeHistogram(float brightness, uint32_t binCount, std::vector<uint32_t>* bins) const;
+
+private:
+    uint8_t getPatternLuma(uint32_t x, uint32_t y) const;
+    uint8_t getLuma(uint32_t x, uint32_t y) const;
+    void renderLuma(const uint8_t* lut, ImageData* image) const;
+    void renderChroma(ImageData* image) const;
+
+    Argus::Size2D<uint32_t> m_resolution;
+    FileFormat m_fileFormat;
+    FILE* m_file;
+    uint64_t m_fileFrames;
+    uint64_t m_sequence;
+    uint64_t m_loadedFrame;
+    std::vector<uint8_t> m_luma;     ///< File frame Y plane
+    std::vector<uint8_t> m_chroma;   ///< File frame CbCr plane, interleaved
+};
+
+class ReplayCameraProvider;
+class ReplayCameraDevice;
+class StreamState;
+
+/**
+ * SensorMode of a replay device, the options resolution and frame rate.
+ */
+class ReplaySensorMode : public Argus::SensorMode, public Argus::ISensorMode
+{
+public:
+    explicit ReplaySensorMode(const Options& options);
+
+    virtual Argus::Interface* getInterface(const Argus::InterfaceID& interfaceId);
+
+    virtual Argus::Size2D<uint32_t> getResolution() const { return m_resolution; }
+    virtual Argus::Range<uint64_t> getExposureTimeRange() const { return m_exposureTimeRange; }
+    virtual Argus::Range<float> getHdrRatioRange() const { return Argus::Range<float>(1.0f); }
+    virtual Argus::Range<uint64_t> getFrameDurationRange() const { return m_frameDurationRange; }
+    virtual Argus::Range<float> getAnalogGainRange() const { return m_analogGainRange; }
+    virtual uint32_t getInputBitDepth() const { return 10; }
+    virtual uint32_t getOutputBitDepth() const { return 10; }
+    virtual Argus::SensorModeType getSensorModeType() const;
+    virtual Argus::BayerPhase getBayerPhase() const;
+    virtual bool isBufferFormatSupported(Argus::Buffer* buffer) const { return false; }
+
+private:
+    Argus::Size2D<uint32_t> m_resolution;
+    Argus::Range<uint64_t> m_exposureTimeRange;
+    Argus::Range<uint64_t> m_frameDurationRange;
+    Argus::Range<float> m_analogGainRange;
+};
+
+/**
+ * Source settings of a request, copied into the capture when it is submitted.
+ */
+struct SourceValues
+{
+    explicit SourceValues(ReplaySensorMode* mode);
+
+    Argus::SensorMode* sensorMode;
+    Argus::Range<uint64_t> exposureTimeRange;
+    Argus::Range<uint64_t> frameDurationRange;
+    Argus::Range<float> gainRange;
+    int32_t focusPosition;
+    int32_t aperturePosition;
+    float apertureMotorSpeed;
+    float apertureFNumber;
+    Argus::BayerTuple<float> opticalBlack;
+    bool opticalBlackEnable;
+};
+
+/**
+ * Auto control settings of a request, copied into the capture when it is submitted.
+ */
+struct AutoControlValues
+{
+    AutoControlValues();
+
+    Argus::AeAntibandingMode aeAntibandingMode;
+    bool aeLock;
+    std::vector<Argus::AcRegion> aeRegions;
+    Argus::Rectangle<uint32_t> bayerHistogramRegion;
+    bool awbLock;
+    Argus::AwbMode awbMode;
+    std::vector<Argus::AcRegion> awbRegions;
+    std::vector<Argus::AcRegion> afRegions;
+    Argus::BayerTuple<float> wbGains;
+    std::vector<float> colorCorrectionMatrix;
+    bool colorCorrectionMatrixEnable;
+    float colorSaturation;
+    bool colorSaturationEnable;
+    float colorSaturationBias;
+    float exposureCompensation;
+    std::vector<float> toneMapCurve[Argus::RGB_CHANNEL_COUNT];
+    bool toneMapCurveEnable;
+    Argus::Range<float> ispDigitalGainRange;
+};
+
+/**
+ * Per stream settings of a request.
+ */
+struct StreamValues
+{
+    StreamValues() : clipRect(0.0f, 0.0f, 1.0f, 1.0f), postProcessingEnable(true) {}
+
+    Argus::Rectangle<float> clipRect;
+    bool postProcessingEnable;
+};
+
+/**
+ * Snapshot of a request taken by capture() and repeat(), so the application may modify
+ * the request while captures are pending, as with the real implementation.
+ */
+struct RequestState
+{
+    RequestState() : source(NULL), clientData(0) {}
+
+    SourceValues source;
+    AutoControlValues autoControl;
+    uint32_t clientData;
+    std::vector<const Argus::OutputStream*> streams;
+    std::vector<std::shared_ptr<StreamState> > streamStates;
+    std::vector<StreamValues> streamValues;
+};
+
+class ReplaySourceSettings : public Argus::InterfaceProvider, public Argus::ISourceSettings
+{
+public:
+    explicit ReplaySourceSettings(SourceValues* values) : m_values(values) {}
+
+    virtual Argus::Interface* getInterface(const Argus::InterfaceID& interfaceId);
+
+    virtual Argus::Status setExposureTimeRange(const Argus::Range<uint64_t>& exposureTimeRange);
+    virtual Argus::Range<uint64_t> getExposureTimeRange() const;
+    virtual Argus::Status setFocusPosition(int32_t position);
+    virtual int32_t getFocusPosition() const;
+    virtual Argus::Status setAperturePosition(int32_t position);
+    virtual int32_t getAperturePosition() const;
+    virtual Argus::Status setApertureMotorSpeed(float speed);
+    virtual float getApertureMotorSpeed() const;
+    virtual Argus::Status setApertureFNumber(float fnumber);
+    virtual float getApertureFNumber() const;
+    virtual Argus::Status setFrameDurationRange(const Argus::Range<uint64_t>& frameDurationRange);
+    virtual Argus::Range<uint64_t> getFrameDurationRange() const;
+    virtual Argus::Status setGainRange(const Argus::Range<float>& gainRange);
+    virtual Argus::Range<float> getGainRange() const;
+    virtual Argus::Status setSensorMode(Argus::SensorMode* mode);
+    virtual Argus::SensorMode* getSensorMode() const;
+    virtual Argus::Status setOpticalBlack(const Argus::BayerTuple<float>& opticalBlackLevels);
+    virtual Argus::BayerTuple<float> getOpticalBlack() const;
+    virtual Argus::Status setOpticalBlackEnable(bool enable);
+    virtual bool getOpticalBlackEnable() const;
+
+private:
+    SourceValues* m_values;
+};
+
+class ReplayAutoControlSettings : public Argus::InterfaceProvider,
+                                  public Argus::IAutoControlSettings
+{
+public:
+    explicit ReplayAutoControlSettings(AutoControlValues* values) : m_values(values) {}
+
+    virtual Argus::Interface* getInterface(const Argus::InterfaceID& interfaceId);
+
+    virtual Argus::Status setAeAntibandingMode(const Argus::AeAntibandingMode& mode);
+    virtual Argus::AeAntibandingMode getAeAntibandingMode() const;
+    virtual Argus::Status setAeLock(bool lock);
+    virtual bool getAeLock() const;
+    virtual Argus::Status setAeRegions(const std::vector<Argus::AcRegion>& regions);
+    virtual Argus::Status getAeRegions(std::vector<Argus::AcRegion>* regions) const;
+    virtual Argus::Status setBayerHistogramRegion(const Argus::Rectangle<uint32_t>& region);
+    virtual Argus::Rectangle<uint32_t> getBayerHistogramRegion() const;
+    virtual Argus::Status setAwbLock(bool lock);
+    virtual bool getAwbLock() const;
+    virtual Argus::Status setAwbMode(const Argus::AwbMode& mode);
+    virtual Argus::AwbMode getAwbMode() const;
+    virtual Argus::Status setAwbRegions(const std::vector<Argus::AcRegion>& regions);
+    virtual Argus::Status getAwbRegions(std::vector<Argus::AcRegion>* regions) const;
+    virtual Argus::Status setAfRegions(const std::vector<Argus::AcRegion>& regions);
+    virtual Argus::Status getAfRegions(std::vector<Argus::AcRegion>* regions) const;
+    virtual Argus::Status setWbGains(const Argus::BayerTuple<float>& gains);
+    virtual Argus::BayerTuple<float> getWbGains() const;
+    virtual Argus::Size2D<uint32_t> getColorCorrectionMatrixSize() const;
+    virtual Argus::Status setColorCorrectionMatrix(const std::vector<float>& matrix);
+    virtual Argus::Status getColorCorrectionMatrix(std::vector<float>* matrix) const;
+    virtual Argus::Status setColorCorrectionMatrixEnable(bool enable);
+    virtual bool getColorCorrectionMatrixEnable() const;
+    virtual Argus::Status setColorSaturation(float saturation);
+    virtual float getColorSaturation() const;
+    virtual Argus::Status setColorSaturationEnable(bool enable);
+    virtual bool getColorSaturationEnable() const;
+    virtual Argus::Status setColorSaturationBias(float bias);
+    virtual float getColorSaturationBias() const;
+    virtual Argus::Status setExposureCompensation(float ev);
+    virtual float getExposureCompensation() const;
+    virtual uint32_t getToneMapCurveSize(Argus::RGBChannel channel) const;
+    virtual Argus::Status setToneMapCurve(Argus::RGBChannel channel,
+                                          const std::vector<float>& curve);
+    virtual Argus::Status getToneMapCurve(Argus::RGBChannel channel,
+                                          std::vector<float>* curve) const;
+    virtual Argus::Status setToneMapCurveEnable(bool enable);
+    virtual bool getToneMapCurveEnable() const;
+    virtual Argus::Status setIspDigitalGainRange(const Argus::Range<float>& gain);
+    virtual Argus::Range<float> getIspDigitalGainRange() const;
+
+private:
+    AutoControlValues* m_values;
+};
+
+class ReplayStreamSettings : public Argus::InterfaceProvider, public Argus::IStreamSettings
+{
+public:
+    ReplayStreamSettings() {}
+    virtual ~ReplayStreamSettings() {}
+
+    virtual Argus::Interface* getInterface(const Argus::InterfaceID& interfaceId);
+
+    virtual Argus::Status setSourceClipRect(const Argus::Rectangle<float>& clipRect);
+    virtual Argus::Rectangle<float> getSourceClipRect() const { return m_values.clipRect; }
+    virtual void setPostProcessingEnable(bool enable) { m_values.postProcessingEnable = enable; }
+    virtual bool getPostProcessingEnable() const { return m_values.postProcessingEnable; }
+
+    StreamValues m_values;
+};
+
+/**
+ * Capture request. The settings are plain values that the session snapshots on submission.
+ */
+class ReplayRequest : public Argus::Request, public Argus::IRequest
+{
+public:
+    explicit ReplayRequest(ReplaySensorMode* mode);
+    virtual ~ReplayRequest();
+
+    virtual Argus::Interface* getInterface(const Argus::InterfaceID& interfaceId);
+    virtual void destroy();
+
+    virtual Argus::Status enableOutputStream(Argus::OutputStream* stream);
+    virtual Argus::Status disableOutputStream(Argus::OutputStream* stream);
+    virtual Argus::Status clearOutputStreams();
+    virtual Argus::Status getOutputStreams(std::vector<Argus::OutputStream*>* streams) const;
+    virtual Argus::InterfaceProvider* getStreamSettings(const Argus::OutputStream* stream);
+    virtual Argus::InterfaceProvider* getAutoControlSettings(const Argus::AutoControlId acId = 0);
+    virtual Argus::InterfaceProvider* getSourceSettings() { return &m_sourceSettings; }
+    virtual Argus::Status setClientData(uint32_t data);
+    virtual uint32_t getClientData() const { return m_clientData; }
+    virtual Argus::Status setPixelFormatType(const Argus::PixelFormatType& pixelFormatType);
+    virtual Argus::PixelFormatType getPixelFormatType() const { return m_pixelFormatType; }
+    virtual Argus::Status setCVOutput(const Argus::CVOutput& cvOutput);
+    virtual Argus::CVOutput getCVOutput() const { return m_cvOutput; }
+    virtual Argus::Status setEnableIspStage(bool enableIspStage);
+    virtual bool getEnableIspStage() const { return m_enableIspStage; }
+
+    /**
+     * Copies the current settings and output streams into 'state'.
+     */
+    void snapshot(RequestState* state) const;
+
+private:
+    SourceValues m_sourceValues;
+    AutoControlValues m_autoControlValues;
+    ReplaySourceSettings m_sourceSettings;
+    ReplayAutoControlSettings m_autoControlSettings;
+    std::vector<Argus::OutputStream*> m_streams;
+    std::map<const Argus::OutputStream*, ReplayStreamSettings*> m_streamSettings;
+    uint32_t m_clientData;
+    Argus::PixelFormatType m_pixelFormatType;
+    Argus::CVOutput m_cvOutput;
+    bool m_enableIspStage;
+};
+
+/**
+ * A camera device of the replay provider.
+ */
+class ReplayCameraDevice : public Argus::CameraDevice, public Argus::ICameraProperties
+{
+public:
+    ReplayCameraDevice(const Options& options, uint32_t index);
+    virtual ~ReplayCameraDevice() {}
+
+    virtual Argus::Interface* getInterface(const Argus::InterfaceID& interfaceId);
+
+    virtual Argus::UUID getUUID() const { return m_uuid; }
+    virtual Argus::SensorPlacement getSensorPlacement() const;
+    virtual uint32_t getMaxAeRegions() const { return 64; }
+    virtual Argus::Size2D<uint32_t> getMinAeRegionSize() const;
+    virtual uint32_t getMaxAwbRegions() const { return 64; }
+    virtual uint32_t getMaxAfRegions() const { return 8; }
+    virtual Argus::Status getBasicSensorModes(std::vector<Argus::SensorMode*>* modes) const;
+    virtual Argus::Status getAllSensorModes(std::vector<Argus::SensorMode*>* modes) const;
+    virtual Argus::Status getAperturePositions(std::vector<int32_t>* positions) const;
+    virtual Argus::Status getAvailableApertureFNumbers(std::vector<float>* fnumbers) const;
+    virtual Argus::Range<int32_t> getFocusPositionRange() const;
+    virtual Argus::Range<int32_t> getAperturePositionRange() const;
+    virtual Argus::Range<float> getApertureMotorSpeedRange() const;
+    virtual Argus::Range<float> getIspDigitalGainRange() const;
+    virtual Argus::Range<float> getExposureCompensationRange() const;
+    virtual const std::string& getModelName() const { return m_modelName; }
+    virtual const std::string& getModuleString() const { return m_moduleString; }
+
+    ReplaySensorMode* getDefaultSensorMode() { return &m_sensorMode; }
+
+private:
+    Argus::UUID m_uuid;
+    ReplaySensorMode m_sensorMode;
+    std::string m_modelName;
+    std::string m_moduleString;
+};
+
+/**
+ * Creates the capture session object, implemented in ReplaySession.cpp.
+ */
+Argus::CaptureSession* createCaptureSession(const Options& options,
+                                            const std::vector<ReplayCameraDevice*>& devices,
+                                            Argus::Status* status);
+
+/**
+ * One buffer of a stream's pool.
+ */
+struct StreamBuffer
+{
+    StreamBuffer() : number(0), time(0), queueTime(0), acquireTime(0) {}
+
+    ImageData image;
+    uint64_t number;            ///< Capture id of the frame
+    uint64_t time;              ///< Sensor timestamp
+    uint64_t queueTime;         ///< getTimeNs() when the producer queued the frame
+    uint64_t acquireTime;       ///< getTimeNs() when the consumer acquired the frame
+    std::shared_ptr<Argus::CaptureMetadata> metadata;
+};
+
+/**
+ * Producer/consumer state of an output stream, the stand-in for the EGLStream. Shared by the
+ * OutputStream, its consumer and the frames the consumer holds so that the objects may be
+ * destroyed in any order.
+ */
+class StreamState : public std::enable_shared_from_this<StreamState>
+{
+public:
+    StreamState(const Argus::PixelFormat& format, const Argus::Size2D<uint32_t>& resolution,
+                const Argus::EGLStreamMode& mode, uint32_t fifoLength, bool metadataEnable,
+                uint64_t stallWarning);
+    ~StreamState();
+
+    const Argus::PixelFormat& getPixelFormat() const { return m_format; }
+    const Argus::Size2D<uint32_t>& getResolution() const { return m_resolution; }
+    bool getMetadataEnable() const { return m_metadataEnable; }
+
+    /**
+     * Returns a free buffer for the producer to render into. Waits for the consumer to
+     * release or acquire a buffer when none is free (a stall), unless the stream is a
+     * mailbox, in which case the oldest queued frame is replaced. Returns NULL if no
+     * consumer is connected, either side disconnects, or the capture is cancelled, which
+     * the session signals by changing 'generation' from 'expected' and calling interrupt().
+     */
+    StreamBuffer* dequeueBuffer(const std::atomic<uint32_t>& generation, uint32_t expected);
+
+    /**
+     * Queues a rendered buffer to the consumer.
+     */
+    void queueBuffer(StreamBuffer* buffer);
+
+    /**
+     * Wakes a producer waiting in dequeueBuffer().
+     */
+    void interrupt();
+
+    void disconnectProducer();
+
+    Argus::Status connectConsumer();
+    void disconnectConsumer();
+    Argus::Status waitUntilConnected(uint64_t timeout);
+
+    /**
+     * Returns the oldest queued frame, waiting up to 'timeout' nanoseconds for one.
+     */
+    StreamBuffer* acquireBuffer(uint64_t timeout, Argus::Status* status);
+
+    /**
+     * Returns an acquired frame to the free list.
+     */
+    void releaseBuffer(StreamBuffer* buffer);
+
+    /**
+     * The EGLStreamKHR handle of the stream, for FrameConsumer::create(EGLDisplay, EGLStreamKHR).
+     */
+    EGLStreamKHR getHandle() const;
+    static std::shared_ptr<StreamState> fromHandle(EGLStreamKHR handle);
+
+    /**
+     * Makes the stream reachable through fromHandle(), once owned by a shared_ptr.
+     */
+    void registerHandle();
+
+private:
+    Argus::PixelFormat m_format;
+    Argus::Size2D<uint32_t> m_resolution;
+    bool m_mailbox;
+    uint32_t m_fifoLength;
+    bool m_metadataEnable;
+    uint64_t m_stallWarning;
+
+    Mutex m_mutex;
+    Condition m_cond;
+    std::vector<StreamBuffer> m_buffers;
+    std::vector<StreamBuffer*> m_free;
+    std::deque<StreamBuffer*> m_queue;
+    uint32_t m_held;
+    bool m_consumerConnected;
+    bool m_producerConnected;
+};
+
+/**
+ * Returns the stream state of a replay OutputStream, NULL for any other object.
+ */
+std::shared_ptr<StreamState> getStreamState(const Argus::OutputStream* stream);
+
+/**
+ * Creates the output stream settings and output streams, implemented in ReplayStream.cpp.
+ */
+Argus::OutputStreamSettings* createOutputStreamSettings(ReplayCameraDevice* device,
+                                                        const Options& options);
+Argus::OutputStream* createOutputStream(const Argus::OutputStreamSettings* settings,
+                                        Argus::Status* status);
+
+} // namespace Replay
+
+} // namespace ArgusSamples
+
+#endif // ARGUS_REPLAY_INTERNAL_H
@@ -0,0 +1,816 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "ReplayInternal.h"
+
+namespace ArgusSamples
+{
+
+namespace Replay
+{
+
+using namespace Argus;
+using Argus::Status;
+
+/**
+ * The replay CameraProvider, a process wide singleton like the real one.
+ */
+class ReplayCameraProvider : public CameraProvider, public ICameraProvider
+{
+public:
+    explicit ReplayCameraProvider(const Options& options)
+        : m_options(options)
+        , m_version("Argus replay (" + std::string(options.file.empty() ? "test pattern" :
+                                                   options.file.c_str()) + ")")
+        , m_vendor("NVIDIA Corporation")
+    {
+        for (uint32_t i = 0; i < std::max(options.numDevices, 1u); i++)
+            m_devices.push_back(new ReplayCameraDevice(options, i));
+    }
+
+    virtual ~ReplayCameraProvider()
+    {
+        for (size_t i = 0; i < m_devices.size(); i++)
+            delete m_devices[i];
+    }
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_CAMERA_PROVIDER)
+            return static_cast<ICameraProvider*>(this);
+        return NULL;
+    }
+
+    virtual void destroy();
+
+    virtual const std::string& getVersion() const { return m_version; }
+    virtual const std::string& getVendor() const { return m_vendor; }
+    virtual bool supportsExtension(const ExtensionName& extension) const { return false; }
+
+    virtual Status getCameraDevices(std::vector<CameraDevice*>* devices) const
+    {
+        if (!devices)
+            return STATUS_INVALID_PARAMS;
+        devices->assign(m_devices.begin(), m_devices.end());
+        return STATUS_OK;
+    }
+
+    virtual CaptureSession* createCaptureSession(CameraDevice* device, Status* status)
+    {
+        return createCaptureSession(std::vector<CameraDevice*>(1, device), status);
+    }
+
+    virtual CaptureSession* createCaptureSession(const std::vector<CameraDevice*>& devices,
+                                                 Status* status)
+    {
+        std::vector<ReplayCameraDevice*> replayDevices;
+
+        for (size_t i = 0; i < devices.size(); i++)
+        {
+            std::vector<ReplayCameraDevice*>::const_iterator it =
+                std::find(m_devices.begin(), m_devices.end(), devices[i]);
+            if (it == m_devices.end())
+            {
+                if (status)
+                    *status = STATUS_INVALID_PARAMS;
+                return NULL;
+            }
+            replayDevices.push_back(*it);
+        }
+        if (replayDevices.empty())
+        {
+            if (status)
+                *status = STATUS_INVALID_PARAMS;
+            return NULL;
+        }
+
+        return Replay::createCaptureSession(m_options, replayDevices, status);
+    }
+
+private:
+    Options m_options;
+    std::string m_version;
+    std::string m_vendor;
+    std::vector<ReplayCameraDevice*> m_devices;
+};
+
+static Mutex s_providerMutex;
+static ReplayCameraProvider* s_provider = NULL;
+
+void ReplayCameraProvider::destroy()
+{
+    ScopedLock lock(s_providerMutex);
+
+    if (m_options.printStats)
+        printStats();
+    s_provider = NULL;
+    delete this;
+}
+
+ReplaySensorMode::ReplaySensorMode(const Options& options)
+    : m_resolution(options.resolution)
+    , m_exposureTimeRange(34000, std::max<uint64_t>(options.frameDuration, 34000))
+    , m_frameDurationRange(options.frameDuration, std::max<uint64_t>(options.frameDuration,
+                                                                     1000000000ull))
+    , m_analogGainRange(1.0f, 16.0f)
+{
+}
+
+Interface* ReplaySensorMode::getInterface(const InterfaceID& interfaceId)
+{
+    if (interfaceId == IID_SENSOR_MODE)
+        return static_cast<ISensorMode*>(this);
+    return NULL;
+}
+
+SensorModeType ReplaySensorMode::getSensorModeType() const
+{
+    return SENSOR_MODE_TYPE_BAYER;
+}
+
+BayerPhase ReplaySensorMode::getBayerPhase() const
+{
+    return BAYER_PHASE_RGGB;
+}
+
+ReplayCameraDevice::ReplayCameraDevice(const Options& options, uint32_t index)
+    : m_sensorMode(options)
+    , m_modelName("replay")
+{
+    char module[32];
+
+    snprintf(module, sizeof(module), "replay_%u", index);
+    m_moduleString = module;
+
+    memset(&m_uuid, 0, sizeof(m_uuid));
+    m_uuid.time_low = 0x52504c59;   // "RPLY"
+    m_uuid.node[5] = (uint8_t)index;
+}
+
+Interface* ReplayCameraDevice::getInterface(const InterfaceID& interfaceId)
+{
+    if (interfaceId == IID_CAMERA_PROPERTIES)
+        return static_cast<ICameraProperties*>(this);
+    return NULL;
+}
+
+SensorPlacement ReplayCameraDevice::getSensorPlacement() const
+{
+    return SENSOR_PLACEMENT_REAR_OR_BOTTOM_OR_BOTTOM_LEFT;
+}
+
+Size2D<uint32_t> ReplayCameraDevice::getMinAeRegionSize() const
+{
+    return Size2D<uint32_t>(64, 64);
+}
+
+Status ReplayCameraDevice::getBasicSensorModes(std::vector<SensorMode*>* modes) const
+{
+    return getAllSensorModes(modes);
+}
+
+Status ReplayCameraDevice::getAllSensorModes(std::vector<SensorMode*>* modes) const
+{
+    if (!modes)
+        return STATUS_INVALID_PARAMS;
+    modes->assign(1, const_cast<ReplaySensorMode*>(&m_sensorMode));
+    return STATUS_OK;
+}
+
+Status ReplayCameraDevice::getAperturePositions(std::vector<int32_t>* positions) const
+{
+    if (!positions)
+        return STATUS_INVALID_PARAMS;
+    positions->clear();
+    return STATUS_OK;
+}
+
+Status ReplayCameraDevice::getAvailableApertureFNumbers(std::vector<float>* fnumbers) const
+{
+    if (!fnumbers)
+        return STATUS_INVALID_PARAMS;
+    fnumbers->clear();
+    return STATUS_OK;
+}
+
+Range<int32_t> ReplayCameraDevice::getFocusPositionRange() const
+{
+    return Range<int32_t>(0);
+}
+
+Range<int32_t> ReplayCameraDevice::getAperturePositionRange() const
+{
+    return Range<int32_t>(0);
+}
+
+Range<float> ReplayCameraDevice::getApertureMotorSpeedRange() const
+{
+    return Range<float>(1.0f);
+}
+
+Range<float> ReplayCameraDevice::getIspDigitalGainRange() const
+{
+    return Range<float>(1.0f, 256.0f);
+}
+
+Range<float> ReplayCameraDevice::getExposureCompensationRange() const
+{
+    return Range<float>(-2.0f, 2.0f);
+}
+
+SourceValues::SourceValues(ReplaySensorMode* mode)
+    : sensorMode(mode)
+    , exposureTimeRange(mode ? mode->getExposureTimeRange() : Range<uint64_t>(0))
+    , frameDurationRange(mode ? mode->getFrameDurationRange() : Range<uint64_t>(0))
+    , gainRange(mode ? mode->getAnalogGainRange() : Range<float>(1.0f))
+    , focusPosition(0)
+    , aperturePosition(0)
+    , apertureMotorSpeed(1.0f)
+    , apertureFNumber(0.0f)
+    , opticalBlack(0.0f)
+    , opticalBlackEnable(false)
+{
+}
+
+AutoControlValues::AutoControlValues()
+    : aeAntibandingMode(AE_ANTIBANDING_MODE_AUTO)
+    , aeLock(false)
+    , bayerHistogramRegion(0, 0, 0, 0)
+    , awbLock(false)
+    , awbMode(AWB_MODE_AUTO)
+    , wbGains(1.0f)
+    , colorCorrectionMatrixEnable(false)
+    , colorSaturation(1.0f)
+    , colorSaturationEnable(false)
+    , colorSaturationBias(1.0f)
+    , exposureCompensation(0.0f)
+    , toneMapCurveEnable(false)
+    , ispDigitalGainRange(1.0f, 256.0f)
+{
+    static const float identity[] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+    colorCorrectionMatrix.assign(identity, identity + 9);
+}
+
+/*
+ * Settings validation follows the real implementation where it matters to applications:
+ * empty ranges are rejected, everything else is stored as is.
+ */
+#define RETURN_IF_EMPTY(_range) \
+    do { if ((_range).empty()) return STATUS_INVALID_PARAMS; } while (0)
+
+Interface* ReplaySourceSettings::getInterface(const InterfaceID& interfaceId)
+{
+    if (interfaceId == IID_SOURCE_SETTINGS)
+        return static_cast<ISourceSettings*>(this);
+    return NULL;
+}
+
+Status ReplaySourceSettings::setExposureTimeRange(const Range<uint64_t>& exposureTimeRange)
+{
+    RETURN_IF_EMPTY(exposureTimeRange);
+    m_values->exposureTimeRange = exposureTimeRange;
+    return STATUS_OK;
+}
+
+Range<uint64_t> ReplaySourceSettings::getExposureTimeRange() const
+{
+    return m_values->exposureTimeRange;
+}
+
+Status ReplaySourceSettings::setFocusPosition(int32_t position)
+{
+    m_values->focusPosition = position;
+    return STATUS_OK;
+}
+
+int32_t ReplaySourceSettings::getFocusPosition() const
+{
+    return m_values->focusPosition;
+}
+
+Status ReplaySourceSettings::setAperturePosition(int32_t position)
+{
+    m_values->aperturePosition = position;
+    return STATUS_OK;
+}
+
+int32_t ReplaySourceSettings::getAperturePosition() const
+{
+    return m_values->aperturePosition;
+}
+
+Status ReplaySourceSettings::setApertureMotorSpeed(float speed)
+{
+    m_values->apertureMotorSpeed = speed;
+    return STATUS_OK;
+}
+
+float ReplaySourceSettings::getApertureMotorSpeed() const
+{
+    return m_values->apertureMotorSpeed;
+}
+
+Status ReplaySourceSettings::setApertureFNumber(float fnumber)
+{
+    m_values->apertureFNumber = fnumber;
+    return STATUS_OK;
+}
+
+float ReplaySourceSettings::getApertureFNumber() const
+{
+    return m_values->apertureFNumber;
+}
+
+Status ReplaySourceSettings::setFrameDurationRange(const Range<uint64_t>& frameDurationRange)
+{
+    RETURN_IF_EMPTY(frameDurationRange);
+    m_values->frameDurationRange = frameDurationRange;
+    return STATUS_OK;
+}
+
+Range<uint64_t> ReplaySourceSettings::getFrameDurationRange() const
+{
+    return m_values->frameDurationRange;
+}
+
+Status ReplaySourceSettings::setGainRange(const Range<float>& gainRange)
+{
+    RETURN_IF_EMPTY(gainRange);
+    m_values->gainRange = gainRange;
+    return STATUS_OK;
+}
+
+Range<float> ReplaySourceSettings::getGainRange() const
+{
+    return m_values->gainRange;
+}
+
+Status ReplaySourceSettings::setSensorMode(SensorMode* mode)
+{
+    if (!mode)
+        return STATUS_INVALID_PARAMS;
+    m_values->sensorMode = mode;
+    return STATUS_OK;
+}
+
+SensorMode* ReplaySourceSettings::getSensorMode() const
+{
+    return m_values->sensorMode;
+}
+
+Status ReplaySourceSettings::setOpticalBlack(const BayerTuple<float>& opticalBlackLevels)
+{
+    m_values->opticalBlack = opticalBlackLevels;
+    return STATUS_OK;
+}
+
+BayerTuple<float> ReplaySourceSettings::getOpticalBlack() const
+{
+    return m_values->opticalBlack;
+}
+
+Status ReplaySourceSettings::setOpticalBlackEnable(bool enable)
+{
+    m_values->opticalBlackEnable = enable;
+    return STATUS_OK;
+}
+
+bool ReplaySourceSettings::getOpticalBlackEnable() const
+{
+    return m_values->opticalBlackEnable;
+}
+
+Interface* ReplayAutoControlSettings::getInterface(const InterfaceID& interfaceId)
+{
+    if (interfaceId == IID_AUTO_CONTROL_SETTINGS)
+        return static_cast<IAutoControlSettings*>(this);
+    return NULL;
+}
+
+Status ReplayAutoControlSettings::setAeAntibandingMode(const AeAntibandingMode& mode)
+{
+    m_values->aeAntibandingMode = mode;
+    return STATUS_OK;
+}
+
+AeAntibandingMode ReplayAutoControlSettings::getAeAntibandingMode() const
+{
+    return m_values->aeAntibandingMode;
+}
+
+Status ReplayAutoControlSettings::setAeLock(bool lock)
+{
+    m_values->aeLock = lock;
+    return STATUS_OK;
+}
+
+bool ReplayAutoControlSettings::getAeLock() const
+{
+    return m_values->aeLock;
+}
+
+Status ReplayAutoControlSettings::setAeRegions(const std::vector<AcRegion>& regions)
+{
+    m_values->aeRegions = regions;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::getAeRegions(std::vector<AcRegion>* regions) const
+{
+    if (!regions)
+        return STATUS_INVALID_PARAMS;
+    *regions = m_values->aeRegions;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::setBayerHistogramRegion(const Rectangle<uint32_t>& region)
+{
+    m_values->bayerHistogramRegion = region;
+    return STATUS_OK;
+}
+
+Rectangle<uint32_t> ReplayAutoControlSettings::getBayerHistogramRegion() const
+{
+    return m_values->bayerHistogramRegion;
+}
+
+Status ReplayAutoControlSettings::setAwbLock(bool lock)
+{
+    m_values->awbLock = lock;
+    return STATUS_OK;
+}
+
+bool ReplayAutoControlSettings::getAwbLock() const
+{
+    return m_values->awbLock;
+}
+
+Status ReplayAutoControlSettings::setAwbMode(const AwbMode& mode)
+{
+    m_values->awbMode = mode;
+    return STATUS_OK;
+}
+
+AwbMode ReplayAutoControlSettings::getAwbMode() const
+{
+    return m_values->awbMode;
+}
+
+Status ReplayAutoControlSettings::setAwbRegions(const std::vector<AcRegion>& regions)
+{
+    m_values->awbRegions = regions;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::getAwbRegions(std::vector<AcRegion>* regions) const
+{
+    if (!regions)
+        return STATUS_INVALID_PARAMS;
+    *regions = m_values->awbRegions;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::setAfRegions(const std::vector<AcRegion>& regions)
+{
+    m_values->afRegions = regions;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::getAfRegions(std::vector<AcRegion>* regions) const
+{
+    if (!regions)
+        return STATUS_INVALID_PARAMS;
+    *regions = m_values->afRegions;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::setWbGains(const BayerTuple<float>& gains)
+{
+    m_values->wbGains = gains;
+    return STATUS_OK;
+}
+
+BayerTuple<float> ReplayAutoControlSettings::getWbGains() const
+{
+    return m_values->wbGains;
+}
+
+Size2D<uint32_t> ReplayAutoControlSettings::getColorCorrectionMatrixSize() const
+{
+    return Size2D<uint32_t>(3, 3);
+}
+
+Status ReplayAutoControlSettings::setColorCorrectionMatrix(const std::vector<float>& matrix)
+{
+    if (matrix.size() != 9)
+        return STATUS_INVALID_PARAMS;
+    m_values->colorCorrectionMatrix = matrix;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::getColorCorrectionMatrix(std::vector<float>* matrix) const
+{
+    if (!matrix)
+        return STATUS_INVALID_PARAMS;
+    *matrix = m_values->colorCorrectionMatrix;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::setColorCorrectionMatrixEnable(bool enable)
+{
+    m_values->colorCorrectionMatrixEnable = enable;
+    return STATUS_OK;
+}
+
+bool ReplayAutoControlSettings::getColorCorrectionMatrixEnable() const
+{
+    return m_values->colorCorrectionMatrixEnable;
+}
+
+Status ReplayAutoControlSettings::setColorSaturation(float saturation)
+{
+    m_values->colorSaturation = saturation;
+    return STATUS_OK;
+}
+
+float ReplayAutoControlSettings::getColorSaturation() const
+{
+    return m_values->colorSaturation;
+}
+
+Status ReplayAutoControlSettings::setColorSaturationEnable(bool enable)
+{
+    m_values->colorSaturationEnable = enable;
+    return STATUS_OK;
+}
+
+bool ReplayAutoControlSettings::getColorSaturationEnable() const
+{
+    return m_values->colorSaturationEnable;
+}
+
+Status ReplayAutoControlSettings::setColorSaturationBias(float bias)
+{
+    m_values->colorSaturationBias = bias;
+    return STATUS_OK;
+}
+
+float ReplayAutoControlSettings::getColorSaturationBias() const
+{
+    return m_values->colorSaturationBias;
+}
+
+Status ReplayAutoControlSettings::setExposureCompensation(float ev)
+{
+    if (ev < -2.0f || ev > 2.0f)
+        return STATUS_INVALID_PARAMS;
+    m_values->exposureCompensation = ev;
+    return STATUS_OK;
+}
+
+float ReplayAutoControlSettings::getExposureCompensation() const
+{
+    return m_values->exposureCompensation;
+}
+
+uint32_t ReplayAutoControlSettings::getToneMapCurveSize(RGBChannel channel) const
+{
+    return 256;
+}
+
+Status ReplayAutoControlSettings::setToneMapCurve(RGBChannel channel,
+                                                  const std::vector<float>& curve)
+{
+    if (channel >= RGB_CHANNEL_COUNT || curve.size() != getToneMapCurveSize(channel))
+        return STATUS_INVALID_PARAMS;
+    m_values->toneMapCurve[channel] = curve;
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::getToneMapCurve(RGBChannel channel,
+                                                  std::vector<float>* curve) const
+{
+    if (channel >= RGB_CHANNEL_COUNT || !curve)
+        return STATUS_INVALID_PARAMS;
+    *curve = m_values->toneMapCurve[channel];
+    return STATUS_OK;
+}
+
+Status ReplayAutoControlSettings::setToneMapCurveEnable(bool enable)
+{
+    m_values->toneMapCurveEnable = enable;
+    return STATUS_OK;
+}
+
+bool ReplayAutoControlSettings::getToneMapCurveEnable() const
+{
+    return m_values->toneMapCurveEnable;
+}
+
+Status ReplayAutoControlSettings::setIspDigitalGainRange(const Range<float>& gain)
+{
+    RETURN_IF_EMPTY(gain);
+    m_values->ispDigitalGainRange = gain;
+    return STATUS_OK;
+}
+
+Range<float> ReplayAutoControlSettings::getIspDigitalGainRange() const
+{
+    return m_values->ispDigitalGainRange;
+}
+
+Interface* ReplayStreamSettings::getInterface(const InterfaceID& interfaceId)
+{
+    if (interfaceId == IID_STREAM_SETTINGS)
+        return static_cast<IStreamSettings*>(this);
+    return NULL;
+}
+
+Status ReplayStreamSettings::setSourceClipRect(const Rectangle<float>& clipRect)
+{
+    if (clipRect.left() < 0.0f || clipRect.top() < 0.0f ||
+        clipRect.right() > 1.0f || clipRect.bottom() > 1.0f ||
+        clipRect.width() <= 0.0f || clipRect.height() <= 0.0f)
+    {
+        return STATUS_INVALID_PARAMS;
+    }
+    m_values.clipRect = clipRect;
+    return STATUS_OK;
+}
+
+ReplayRequest::ReplayRequest(ReplaySensorMode* mode)
+    : m_sourceValues(mode)
+    , m_sourceSettings(&m_sourceValues)
+    , m_autoControlSettings(&m_autoControlValues)
+    , m_clientData(0)
+    , m_pixelFormatType(PixelFormatType_YuvOnly)
+    , m_cvOutput(CVOutput_None)
+    , m_enableIspStage(true)
+{
+}
+
+ReplayRequest::~ReplayRequest()
+{
+    clearOutputStreams();
+}
+
+Interface* ReplayRequest::getInterface(const InterfaceID& interfaceId)
+{
+    if (interfaceId == IID_REQUEST)
+        return static_cast<IRequest*>(this);
+    return NULL;
+}
+
+void ReplayRequest::destroy()
+{
+    delete this;
+}
+
+Status ReplayRequest::enableOutputStream(OutputStream* stream)
+{
+    if (!getStreamState(stream))
+        return STATUS_INVALID_PARAMS;
+    if (std::find(m_streams.begin(), m_streams.end(), stream) != m_streams.end())
+        return STATUS_OK;
+
+    m_streams.push_back(stream);
+    m_streamSettings[stream] = new ReplayStreamSettings();
+    return STATUS_OK;
+}
+
+Status ReplayRequest::disableOutputStream(OutputStream* stream)
+{
+    std::vector<OutputStream*>::iterator it = std::find(m_streams.begin(), m_streams.end(), stream);
+    if (it == m_streams.end())
+        return STATUS_INVALID_PARAMS;
+
+    m_streams.erase(it);
+    delete m_streamSettings[stream];
+    m_streamSettings.erase(stream);
+    return STATUS_OK;
+}
+
+Status ReplayRequest::clearOutputStreams()
+{
+    for (std::map<const OutputStream*, ReplayStreamSettings*>::iterator it =
+             m_streamSettings.begin(); it != m_streamSettings.end(); ++it)
+    {
+        delete it->second;
+    }
+    m_streamSettings.clear();
+    m_streams.clear();
+    return STATUS_OK;
+}
+
+Status ReplayRequest::getOutputStreams(std::vector<OutputStream*>* streams) const
+{
+    if (!streams)
+        return STATUS_INVALID_PARAMS;
+    *streams = m_streams;
+    return STATUS_OK;
+}
+
+InterfaceProvider* ReplayRequest::getStreamSettings(const OutputStream* stream)
+{
+    std::map<const OutputStream*, ReplayStreamSettings*>::iterator it =
+        m_streamSettings.find(stream);
+    return (it != m_streamSettings.end()) ? it->second : NULL;
+}
+
+InterfaceProvider* ReplayRequest::getAutoControlSettings(const AutoControlId acId)
+{
+    return (acId == 0) ? &m_autoControlSettings : NULL;
+}
+
+Status ReplayRequest::setClientData(uint32_t data)
+{
+    m_clientData = data;
+    return STATUS_OK;
+}
+
+Status ReplayRequest::setPixelFormatType(const PixelFormatType& pixelFormatType)
+{
+    m_pixelFormatType = pixelFormatType;
+    return STATUS_OK;
+}
+
+Status ReplayRequest::setCVOutput(const CVOutput& cvOutput)
+{
+    m_cvOutput = cvOutput;
+    return STATUS_OK;
+}
+
+Status ReplayRequest::setEnableIspStage(bool enableIspStage)
+{
+    m_enableIspStage = enableIspStage;
+    return STATUS_OK;
+}
+
+void ReplayRequest::snapshot(RequestState* state) const
+{
+    state->source = m_sourceValues;
+    state->autoControl = m_autoControlValues;
+    state->clientData = m_clientData;
+    state->streams.clear();
+    state->streamStates.clear();
+    state->streamValues.clear();
+
+    for (size_t i = 0; i < m_streams.size(); i++)
+    {
+        state->streams.push_back(m_streams[i]);
+        state->streamStates.push_back(getStreamState(m_streams[i]));
+        state->streamValues.push_back(m_streamSettings.find(m_streams[i])->second->m_values);
+    }
+}
+
+} // namespace Replay
+
+} // namespace ArgusSamples
+
+namespace Argus
+{
+
+/**
+ * Entry point replacing the one of libnvargus.
+ */
+CameraProvider* CameraProvider::create(Status* status)
+{
+    using namespace ArgusSamples::Replay;
+
+    ScopedLock lock(s_providerMutex);
+
+    if (!s_provider)
+        s_provider = new ReplayCameraProvider(getOptions());
+    if (status)
+        *status = STATUS_OK;
+    return s_provider;
+}
+
+} // namespace Argus
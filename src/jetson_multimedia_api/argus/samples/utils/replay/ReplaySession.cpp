@@ -0,0 +1,973 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "ReplayInternal.h"
+
+namespace ArgusSamples
+{
+
+namespace Replay
+{
+
+using namespace Argus;
+using Argus::Status;
+
+/// Exposure the simulated auto exposure aims for at exposure compensation 0.
+static const uint64_t REFERENCE_EXPOSURE = 10000000;
+
+/// Captures that may be queued with capture() before it blocks.
+static const uint32_t MAX_PENDING_CAPTURES = 8;
+
+/// Events kept per queue when the application does not call waitForEvents().
+static const size_t MAX_PENDING_EVENTS = 1024;
+
+static const uint32_t HISTOGRAM_BIN_COUNT = 256;
+
+template <typename T>
+static T clamp(T value, const Range<T>& range)
+{
+    return std::min(std::max(value, range.min()), range.max());
+}
+
+class ReplayBayerHistogram : public InterfaceProvider, public IBayerHistogram
+{
+public:
+    virtual ~ReplayBayerHistogram() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_BAYER_HISTOGRAM)
+            return static_cast<IBayerHistogram*>(this);
+        return NULL;
+    }
+
+    virtual uint32_t getBinCount() const { return m_bins.size(); }
+
+    virtual Status getHistogram(std::vector< BayerTuple<uint32_t> >* histogram) const
+    {
+        if (!histogram)
+            return STATUS_INVALID_PARAMS;
+        histogram->resize(m_bins.size());
+        for (size_t i = 0; i < m_bins.size(); i++)
+            (*histogram)[i] = BayerTuple<uint32_t>(m_bins[i]);
+        return STATUS_OK;
+    }
+
+    std::vector<uint32_t> m_bins;
+};
+
+class ReplayRGBHistogram : public InterfaceProvider, public IRGBHistogram
+{
+public:
+    explicit ReplayRGBHistogram(const std::vector<uint32_t>& bins) : m_bins(bins) {}
+    virtual ~ReplayRGBHistogram() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_RGB_HISTOGRAM)
+            return static_cast<IRGBHistogram*>(this);
+        return NULL;
+    }
+
+    virtual uint32_t getBinCount() const { return m_bins.size(); }
+
+    virtual Status getHistogram(std::vector< RGBTuple<uint32_t> >* histogram) const
+    {
+        if (!histogram)
+            return STATUS_INVALID_PARAMS;
+        histogram->resize(m_bins.size());
+        for (size_t i = 0; i < m_bins.size(); i++)
+            (*histogram)[i] = RGBTuple<uint32_t>(m_bins[i]);
+        return STATUS_OK;
+    }
+
+private:
+    const std::vector<uint32_t>& m_bins;
+};
+
+class ReplayStreamMetadata : public InterfaceProvider, public IStreamCaptureMetadata
+{
+public:
+    explicit ReplayStreamMetadata(const Rectangle<float>& clipRect) : m_clipRect(clipRect) {}
+    virtual ~ReplayStreamMetadata() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_STREAM_CAPTURE_METADATA)
+            return static_cast<IStreamCaptureMetadata*>(this);
+        return NULL;
+    }
+
+    virtual Rectangle<float> getSourceClipRect() const { return m_clipRect; }
+
+private:
+    Rectangle<float> m_clipRect;
+};
+
+/**
+ * Result of the simulated 3A for one capture.
+ */
+struct ExposureResult
+{
+    uint64_t exposureTime;
+    float analogGain;
+    float ispDigitalGain;
+    bool converged;
+
+    /// Linear brightness relative to the reference exposure.
+    float brightness() const
+    {
+        return (float)exposureTime * analogGain * ispDigitalGain / REFERENCE_EXPOSURE;
+    }
+};
+
+/**
+ * Capture metadata, shared by the capture complete event and the frames of the capture.
+ */
+class ReplayMetadata : public CaptureMetadata, public ICaptureMetadata
+{
+public:
+    ReplayMetadata(uint32_t captureId, const RequestState& request, uint64_t sensorTimestamp,
+                   uint64_t frameDuration, const ExposureResult& exposure)
+        : m_captureId(captureId)
+        , m_clientData(request.clientData)
+        , m_autoControl(request.autoControl)
+        , m_sensorTimestamp(sensorTimestamp)
+        , m_frameDuration(frameDuration)
+        , m_exposure(exposure)
+        , m_rgbHistogram(m_bayerHistogram.m_bins)
+    {
+        for (size_t i = 0; i < request.streams.size(); i++)
+        {
+            m_streamMetadata.push_back(std::make_pair(request.streams[i],
+                new ReplayStreamMetadata(request.streamValues[i].clipRect)));
+        }
+    }
+
+    virtual ~ReplayMetadata()
+    {
+        for (size_t i = 0; i < m_streamMetadata.size(); i++)
+            delete m_streamMetadata[i].second;
+    }
+
+    std::vector<uint32_t>* getHistogramBins() { return &m_bayerHistogram.m_bins; }
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_CAPTURE_METADATA)
+            return static_cast<ICaptureMetadata*>(this);
+        return NULL;
+    }
+
+    virtual uint32_t getCaptureId() const { return m_captureId; }
+    virtual uint32_t getClientData() const { return m_clientData; }
+
+    virtual InterfaceProvider* getStreamMetadata(const OutputStream* stream) const
+    {
+        for (size_t i = 0; i < m_streamMetadata.size(); i++)
+        {
+            if (m_streamMetadata[i].first == stream)
+                return m_streamMetadata[i].second;
+        }
+        return NULL;
+    }
+
+    virtual const InterfaceProvider* getBayerHistogram() const { return &m_bayerHistogram; }
+    virtual const InterfaceProvider* getRGBHistogram() const { return &m_rgbHistogram; }
+    virtual bool getAeLocked() const { return m_autoControl.aeLock; }
+
+    virtual Status getAeRegions(std::vector<AcRegion>* regions) const
+    {
+        if (!regions)
+            return STATUS_INVALID_PARAMS;
+        *regions = m_autoControl.aeRegions;
+        return STATUS_OK;
+    }
+
+    virtual Rectangle<uint32_t> getBayerHistogramRegion() const
+    {
+        return m_autoControl.bayerHistogramRegion;
+    }
+
+    virtual AeState getAeState() const
+    {
+        return m_exposure.converged ? AE_STATE_CONVERGED : AE_STATE_SEARCHING;
+    }
+
+    virtual AeFlickerState getFlickerState() const { return AE_FLICKER_NONE; }
+    virtual int32_t getAperturePosition() const { return 0; }
+    virtual int32_t getFocuserPosition() const { return 0; }
+    virtual uint32_t getAwbCct() const { return 5000; }
+
+    virtual BayerTuple<float> getAwbGains() const
+    {
+        if (m_autoControl.awbMode == AWB_MODE_MANUAL)
+            return m_autoControl.wbGains;
+        return BayerTuple<float>(1.8f, 1.0f, 1.0f, 1.6f);
+    }
+
+    virtual AwbMode getAwbMode() const { return m_autoControl.awbMode; }
+
+    virtual Status getAwbRegions(std::vector<AcRegion>* regions) const
+    {
+        if (!regions)
+            return STATUS_INVALID_PARAMS;
+        *regions = m_autoControl.awbRegions;
+        return STATUS_OK;
+    }
+
+    virtual Status getAfRegions(std::vector<AcRegion>* regions) const
+    {
+        if (!regions)
+            return STATUS_INVALID_PARAMS;
+        *regions = m_autoControl.afRegions;
+        return STATUS_OK;
+    }
+
+    virtual Status getSharpnessScore(std::vector<float>* values) const
+    {
+        if (!values)
+            return STATUS_INVALID_PARAMS;
+        values->assign(std::max<size_t>(m_autoControl.afRegions.size(), 1), 1.0f);
+        return STATUS_OK;
+    }
+
+    virtual AwbState getAwbState() const
+    {
+        return m_autoControl.awbLock ? AWB_STATE_LOCKED : AWB_STATE_CONVERGED;
+    }
+
+    virtual Status getAwbWbEstimate(std::vector<float>* estimate) const
+    {
+        if (!estimate)
+            return STATUS_INVALID_PARAMS;
+        const BayerTuple<float> gains = getAwbGains();
+        estimate->assign(1, gains.r());
+        estimate->push_back(gains.gEven());
+        estimate->push_back(gains.gOdd());
+        estimate->push_back(gains.b());
+        return STATUS_OK;
+    }
+
+    virtual bool getColorCorrectionMatrixEnable() const
+    {
+        return m_autoControl.colorCorrectionMatrixEnable;
+    }
+
+    virtual Status getColorCorrectionMatrix(std::vector<float>* ccMatrix) const
+    {
+        if (!ccMatrix)
+            return STATUS_INVALID_PARAMS;
+        *ccMatrix = m_autoControl.colorCorrectionMatrix;
+        return STATUS_OK;
+    }
+
+    virtual float getColorSaturation() const { return m_autoControl.colorSaturation; }
+    virtual uint64_t getFrameDuration() const { return m_frameDuration; }
+    virtual float getIspDigitalGain() const { return m_exposure.ispDigitalGain; }
+    virtual uint64_t getFrameReadoutTime() const { return m_frameDuration * 9 / 10; }
+
+    virtual float getSceneLux() const
+    {
+        return 250.0f * REFERENCE_EXPOSURE / m_exposure.exposureTime / m_exposure.analogGain;
+    }
+
+    virtual float getSensorAnalogGain() const { return m_exposure.analogGain; }
+    virtual uint64_t getSensorExposureTime() const { return m_exposure.exposureTime; }
+    virtual uint32_t getSensorSensitivity() const { return (uint32_t)(100 * m_exposure.analogGain); }
+    virtual uint64_t getSensorTimestamp() const { return m_sensorTimestamp; }
+    virtual bool getToneMapCurveEnabled() const { return m_autoControl.toneMapCurveEnable; }
+
+    virtual Status getToneMapCurve(RGBChannel channel, std::vector<float>* curve) const
+    {
+        if (channel >= RGB_CHANNEL_COUNT || !curve)
+            return STATUS_INVALID_PARAMS;
+        *curve = m_autoControl.toneMapCurve[channel];
+        return STATUS_OK;
+    }
+
+private:
+    uint32_t m_captureId;
+    uint32_t m_clientData;
+    AutoControlValues m_autoControl;
+    uint64_t m_sensorTimestamp;
+    uint64_t m_frameDuration;
+    ExposureResult m_exposure;
+    ReplayBayerHistogram m_bayerHistogram;
+    ReplayRGBHistogram m_rgbHistogram;
+    std::vector<std::pair<const OutputStream*, ReplayStreamMetadata*> > m_streamMetadata;
+};
+
+class ReplayEvent : public Event, public IEvent, public IEventCaptureComplete, public IEventError
+{
+public:
+    ReplayEvent(const EventType& type, uint64_t time, uint32_t captureId,
+                const std::shared_ptr<ReplayMetadata>& metadata, Status status)
+        : m_type(type)
+        , m_time(time)
+        , m_captureId(captureId)
+        , m_metadata(metadata)
+        , m_status(status)
+    {
+    }
+
+    virtual ~ReplayEvent() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_EVENT)
+            return static_cast<IEvent*>(this);
+        if (interfaceId == IID_EVENT_CAPTURE_COMPLETE && m_type == EVENT_TYPE_CAPTURE_COMPLETE)
+            return static_cast<IEventCaptureComplete*>(this);
+        if (interfaceId == IID_EVENT_ERROR && m_type == EVENT_TYPE_ERROR)
+            return static_cast<IEventError*>(this);
+        return NULL;
+    }
+
+    virtual EventType getEventType() const { return m_type; }
+    virtual uint64_t getTime() const { return m_time; }
+    virtual uint32_t getCaptureId() const { return m_captureId; }
+    virtual const CaptureMetadata* getMetadata() const { return m_metadata.get(); }
+    virtual Status getStatus() const { return m_status; }
+
+private:
+    EventType m_type;
+    uint64_t m_time;
+    uint32_t m_captureId;
+    std::shared_ptr<ReplayMetadata> m_metadata;
+    Status m_status;
+};
+
+class ReplayCaptureSession;
+
+class ReplayEventQueue : public EventQueue, public IEventQueue
+{
+public:
+    ReplayEventQueue(ReplayCaptureSession* session, const std::vector<EventType>& types)
+        : m_session(session)
+        , m_types(types)
+        , m_next(0)
+    {
+    }
+
+    virtual ~ReplayEventQueue() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_EVENT_QUEUE)
+            return static_cast<IEventQueue*>(this);
+        return NULL;
+    }
+
+    virtual void destroy();
+
+    virtual Status getEventTypes(std::vector<EventType>* types) const
+    {
+        if (!types)
+            return STATUS_INVALID_PARAMS;
+        *types = m_types;
+        return STATUS_OK;
+    }
+
+    virtual const Event* getNextEvent()
+    {
+        return (m_next < m_events.size()) ? m_events[m_next++].get() : NULL;
+    }
+
+    virtual uint32_t getSize() const { return m_events.size(); }
+
+    virtual const Event* getEvent(uint32_t index) const
+    {
+        return (index < m_events.size()) ? m_events[index].get() : NULL;
+    }
+
+    bool receives(const EventType& type) const
+    {
+        return std::find(m_types.begin(), m_types.end(), type) != m_types.end();
+    }
+
+    // Owned by the session mutex.
+    ReplayCaptureSession* m_session;
+    std::vector<std::shared_ptr<ReplayEvent> > m_pending;
+
+private:
+    std::vector<EventType> m_types;
+    std::vector<std::shared_ptr<ReplayEvent> > m_events;
+    size_t m_next;
+
+    friend class ReplayCaptureSession;
+};
+
+/**
+ * Capture session. A producer thread plays the submitted and repeating requests at the
+ * sensor frame rate and delivers the frames to the output streams of each request.
+ */
+class ReplayCaptureSession : public CaptureSession, public ICaptureSession, public IEventProvider
+{
+public:
+    ReplayCaptureSession(const Options& options, const std::vector<ReplayCameraDevice*>& devices)
+        : m_options(options)
+        , m_devices(devices)
+        , m_random(options.seed)
+        , m_thread(0)
+        , m_exit(false)
+        , m_busy(false)
+        , m_repeating(false)
+        , m_repeatIndex(0)
+        , m_repeatFirst(0)
+        , m_repeatLast(0)
+        , m_nextCaptureId(1)
+        , m_generation(0)
+        , m_sequence(0)
+        , m_lastTimestamp(0)
+    {
+        m_lastExposure.exposureTime = REFERENCE_EXPOSURE;
+        m_lastExposure.analogGain = 1.0f;
+        m_lastExposure.ispDigitalGain = 1.0f;
+        m_lastExposure.converged = true;
+    }
+
+    virtual ~ReplayCaptureSession() {}
+
+    bool initialize()
+    {
+        if (!m_source.initialize(m_options))
+            return false;
+        if (pthread_create(&m_thread, NULL, threadFunc, this) != 0)
+        {
+            REPLAY_LOG("Failed to create the capture thread");
+            return false;
+        }
+        return true;
+    }
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_CAPTURE_SESSION)
+            return static_cast<ICaptureSession*>(this);
+        if (interfaceId == IID_EVENT_PROVIDER)
+            return static_cast<IEventProvider*>(this);
+        return NULL;
+    }
+
+    virtual void destroy()
+    {
+        {
+            ScopedLock lock(m_mutex);
+            m_exit = true;
+            cancelLocked();
+            for (size_t i = 0; i < m_queues.size(); i++)
+                m_queues[i]->m_session = NULL;
+            m_queues.clear();
+        }
+        if (m_thread)
+            pthread_join(m_thread, NULL);
+        delete this;
+    }
+
+    virtual Status cancelRequests()
+    {
+        ScopedLock lock(m_mutex);
+        cancelLocked();
+        return STATUS_OK;
+    }
+
+    virtual uint32_t capture(const Request* request, uint64_t timeout, Status* status)
+    {
+        return captureBurst(std::vector<const Request*>(1, request), timeout, status);
+    }
+
+    virtual uint32_t captureBurst(const std::vector<const Request*>& requestList,
+                                  uint64_t timeout, Status* status)
+    {
+        std::vector<RequestState> states;
+
+        if (!snapshot(requestList, &states) || states.size() > MAX_PENDING_CAPTURES)
+        {
+            if (status)
+                *status = STATUS_INVALID_PARAMS;
+            return 0;
+        }
+
+        ScopedLock lock(m_mutex);
+        const uint64_t deadline = getDeadline(timeout);
+
+        while (m_pending.size() + states.size() > MAX_PENDING_CAPTURES)
+        {
+            if (!m_cond.waitUntil(m_mutex, deadline))
+            {
+                if (status)
+                    *status = STATUS_TIMEOUT;
+                return 0;
+            }
+        }
+
+        const uint32_t firstId = m_nextCaptureId;
+        for (size_t i = 0; i < states.size(); i++)
+            m_pending.push_back(std::make_pair(m_nextCaptureId++, states[i]));
+        m_cond.broadcast();
+
+        if (status)
+            *status = STATUS_OK;
+        return firstId;
+    }
+
+    virtual uint32_t maxBurstRequests() const { return MAX_PENDING_CAPTURES; }
+
+    virtual Request* createRequest(const CaptureIntent& intent, Status* status)
+    {
+        if (status)
+            *status = STATUS_OK;
+        return new ReplayRequest(m_devices[0]->getDefaultSensorMode());
+    }
+
+    virtual OutputStreamSettings* createOutputStreamSettings(const StreamType& type,
+                                                             Status* status)
+    {
+        if (type != STREAM_TYPE_EGL)
+        {
+            REPLAY_LOG("Only EGL output streams are supported");
+            if (status)
+                *status = STATUS_UNIMPLEMENTED;
+            return NULL;
+        }
+        if (status)
+            *status = STATUS_OK;
+        return Replay::createOutputStreamSettings(m_devices[0], m_options);
+    }
+
+    virtual OutputStream* createOutputStream(const OutputStreamSettings* settings, Status* status)
+    {
+        OutputStream* stream = Replay::createOutputStream(settings, status);
+        if (stream)
+        {
+            ScopedLock lock(m_mutex);
+            m_streams.push_back(getStreamState(stream));
+        }
+        return stream;
+    }
+
+    virtual bool isRepeating() const
+    {
+        ScopedLock lock(m_mutex);
+        return m_repeating;
+    }
+
+    virtual Status repeat(const Request* request)
+    {
+        return repeatBurst(std::vector<const Request*>(1, request));
+    }
+
+    virtual Status repeatBurst(const std::vector<const Request*>& requestList)
+    {
+        std::vector<RequestState> states;
+
+        if (!snapshot(requestList, &states) || states.empty())
+            return STATUS_INVALID_PARAMS;
+
+        ScopedLock lock(m_mutex);
+        m_repeat.swap(states);
+        m_repeatIndex = 0;
+        if (!m_repeating)
+            m_repeatFirst = m_repeatLast = 0;
+        m_repeating = true;
+        m_cond.broadcast();
+        return STATUS_OK;
+    }
+
+    virtual Range<uint32_t> stopRepeat()
+    {
+        ScopedLock lock(m_mutex);
+        m_repeating = false;
+        m_repeat.clear();
+        return Range<uint32_t>(m_repeatFirst, m_repeatLast);
+    }
+
+    virtual Status waitForIdle(uint64_t timeout) const
+    {
+        ScopedLock lock(m_mutex);
+        const uint64_t deadline = getDeadline(timeout);
+
+        while (m_busy || m_repeating || !m_pending.empty())
+        {
+            if (!m_cond.waitUntil(m_mutex, deadline))
+                return STATUS_TIMEOUT;
+        }
+        return STATUS_OK;
+    }
+
+    virtual Status getAvailableEventTypes(std::vector<EventType>* types) const
+    {
+        if (!types)
+            return STATUS_INVALID_PARAMS;
+        types->assign(1, EVENT_TYPE_ERROR);
+        types->push_back(EVENT_TYPE_CAPTURE_STARTED);
+        types->push_back(EVENT_TYPE_CAPTURE_COMPLETE);
+        return STATUS_OK;
+    }
+
+    virtual EventQueue* createEventQueue(const std::vector<EventType>& eventTypes, Status* status)
+    {
+        ScopedLock lock(m_mutex);
+        ReplayEventQueue* queue = new ReplayEventQueue(this, eventTypes);
+
+        m_queues.push_back(queue);
+        if (status)
+            *status = STATUS_OK;
+        return queue;
+    }
+
+    virtual Status waitForEvents(const std::vector<EventQueue*>& queues, uint64_t timeout)
+    {
+        std::vector<ReplayEventQueue*> replayQueues;
+
+        for (size_t i = 0; i < queues.size(); i++)
+        {
+            ReplayEventQueue* queue = dynamic_cast<ReplayEventQueue*>(queues[i]);
+            if (!queue || queue->m_session != this)
+                return STATUS_INVALID_PARAMS;
+            replayQueues.push_back(queue);
+        }
+
+        ScopedLock lock(m_mutex);
+        const uint64_t deadline = getDeadline(timeout);
+
+        while (!hasPendingEvents(replayQueues))
+        {
+            if (!m_eventCond.waitUntil(m_mutex, deadline))
+                break;
+        }
+
+        // Events returned by the previous call are discarded, as with libargus.
+        for (size_t i = 0; i < replayQueues.size(); i++)
+        {
+            replayQueues[i]->m_events.swap(replayQueues[i]->m_pending);
+            replayQueues[i]->m_pending.clear();
+            replayQueues[i]->m_next = 0;
+        }
+
+        return hasEvents(replayQueues) ? STATUS_OK : STATUS_TIMEOUT;
+    }
+
+    virtual Status waitForEvents(EventQueue* queue, uint64_t timeout)
+    {
+        return waitForEvents(std::vector<EventQueue*>(1, queue), timeout);
+    }
+
+    void removeEventQueue(ReplayEventQueue* queue)
+    {
+        ScopedLock lock(m_mutex);
+        m_queues.erase(std::remove(m_queues.begin(), m_queues.end(), queue), m_queues.end());
+    }
+
+private:
+    typedef std::pair<uint32_t, RequestState> Capture;
+
+    static void* threadFunc(void* arg)
+    {
+        static_cast<ReplayCaptureSession*>(arg)->threadExecute();
+        return NULL;
+    }
+
+    bool snapshot(const std::vector<const Request*>& requestList,
+                  std::vector<RequestState>* states) const
+    {
+        for (size_t i = 0; i < requestList.size(); i++)
+        {
+            const ReplayRequest* request = dynamic_cast<const ReplayRequest*>(requestList[i]);
+            if (!request)
+                return false;
+            states->push_back(RequestState());
+            request->snapshot(&states->back());
+        }
+        return true;
+    }
+
+    void cancelLocked()
+    {
+        m_pending.clear();
+        m_repeat.clear();
+        m_repeating = false;
+        m_generation++;
+        for (size_t i = 0; i < m_streams.size(); i++)
+        {
+            std::shared_ptr<StreamState> stream = m_streams[i].lock();
+            if (stream)
+                stream->interrupt();
+        }
+        m_cond.broadcast();
+    }
+
+    bool hasPendingEvents(const std::vector<ReplayEventQueue*>& queues) const
+    {
+        for (size_t i = 0; i < queues.size(); i++)
+        {
+            if (!queues[i]->m_pending.empty())
+                return true;
+        }
+        return false;
+    }
+
+    bool hasEvents(const std::vector<ReplayEventQueue*>& queues) const
+    {
+        for (size_t i = 0; i < queues.size(); i++)
+        {
+            if (!queues[i]->m_events.empty())
+                return true;
+        }
+        return false;
+    }
+
+    void postEventLocked(const std::shared_ptr<ReplayEvent>& event)
+    {
+        for (size_t i = 0; i < m_queues.size(); i++)
+        {
+            ReplayEventQueue* queue = m_queues[i];
+            if (!queue->receives(event->getEventType()))
+                continue;
+            if (queue->m_pending.size() >= MAX_PENDING_EVENTS)
+                queue->m_pending.erase(queue->m_pending.begin());
+            queue->m_pending.push_back(event);
+        }
+        m_eventCond.broadcast();
+    }
+
+    /**
+     * Simulated auto exposure: reach the reference exposure, scaled by the exposure
+     * compensation, using exposure time first, then analog gain, then ISP digital gain,
+     * each limited to the request's ranges.
+     */
+    ExposureResult computeExposure(const RequestState& request, uint64_t frameDuration)
+    {
+        if (request.autoControl.aeLock)
+            return m_lastExposure;
+
+        const double target = REFERENCE_EXPOSURE * pow(2.0, request.autoControl.exposureCompensation);
+        Range<uint64_t> exposureRange = request.source.exposureTimeRange;
+        ExposureResult result;
+
+        exposureRange.max() = std::min(exposureRange.max(), frameDuration);
+        exposureRange.min() = std::min(exposureRange.min(), exposureRange.max());
+
+        result.exposureTime = clamp((uint64_t)target, exposureRange);
+        result.analogGain = clamp((float)(target / result.exposureTime), request.source.gainRange);
+        result.ispDigitalGain = clamp((float)(target / result.exposureTime / result.analogGain),
+                                      request.autoControl.ispDigitalGainRange);
+        result.converged = fabs(result.exposureTime * result.analogGain *
+                                result.ispDigitalGain - target) < target * 0.01;
+        m_lastExposure = result;
+        return result;
+    }
+
+    void threadExecute()
+    {
+        m_mutex.lock();
+        while (true)
+        {
+            while (!m_exit && m_pending.empty() && !m_repeating)
+            {
+                if (m_busy)
+                {
+                    m_busy = false;
+                    m_cond.broadcast();
+                }
+                m_cond.waitUntil(m_mutex, UINT64_MAX);
+            }
+            if (m_exit)
+                break;
+
+            Capture capture;
+            if (!m_pending.empty())
+            {
+                capture = m_pending.front();
+                m_pending.pop_front();
+            }
+            else
+            {
+                capture = std::make_pair(m_nextCaptureId++,
+                                         m_repeat[m_repeatIndex++ % m_repeat.size()]);
+                if (!m_repeatFirst)
+                    m_repeatFirst = capture.first;
+                m_repeatLast = capture.first;
+            }
+            m_busy = true;
+            m_cond.broadcast();
+
+            // The sensor runs free while requests are available and restarts when idle.
+            const RequestState& request = capture.second;
+            const SensorMode* mode = request.source.sensorMode;
+            const uint64_t minDuration = mode ?
+                interface_cast<const ISensorMode>(mode)->getFrameDurationRange().min() :
+                m_options.frameDuration;
+            const uint64_t frameDuration = std::max(request.source.frameDurationRange.min(),
+                                                    minDuration);
+            const uint64_t now = getTimeNs();
+            const uint64_t timestamp = (m_lastTimestamp && m_lastTimestamp + frameDuration > now) ?
+                m_lastTimestamp + frameDuration : now;
+            const uint64_t jitter = m_options.jitter ?
+                (uint64_t)(m_random.uniform() * m_options.jitter) : 0;
+            const uint32_t generation = m_generation;
+
+            // Frames become available at the end of their readout.
+            const uint64_t deliveryTime = timestamp + frameDuration + jitter;
+            while (!m_exit && generation == m_generation &&
+                   m_cond.waitUntil(m_mutex, deliveryTime))
+            {
+            }
+            if (m_exit)
+                break;
+            if (generation != m_generation)
+                continue;
+
+            m_lastTimestamp = timestamp;
+            const uint64_t sequence = m_sequence++;
+            const bool drop =
+                (m_options.dropInterval && (sequence + 1) % m_options.dropInterval == 0) ||
+                (m_options.dropRate > 0.0f && m_random.uniform() < m_options.dropRate);
+            m_mutex.unlock();
+
+            executeCapture(capture.first, request, sequence, timestamp, frameDuration, drop,
+                           generation);
+
+            m_mutex.lock();
+        }
+        m_busy = false;
+        m_cond.broadcast();
+        m_mutex.unlock();
+    }
+
+    void executeCapture(uint32_t captureId, const RequestState& request, uint64_t sequence,
+                        uint64_t timestamp, uint64_t frameDuration, bool drop,
+                        uint32_t generation)
+    {
+        const ExposureResult exposure = computeExposure(request, frameDuration);
+        std::shared_ptr<ReplayMetadata> metadata =
+            std::make_shared<ReplayMetadata>(captureId, request, timestamp, frameDuration,
+                                             exposure);
+
+        {
+            ScopedLock lock(m_mutex);
+            postEventLocked(std::make_shared<ReplayEvent>(EVENT_TYPE_CAPTURE_STARTED, timestamp,
+                                                          captureId, metadata, STATUS_OK));
+        }
+
+        countStat(&Stats::captures);
+        const bool sourceOk = m_source.prepare(sequence);
+        m_source.computeHistogram(exposure.brightness(), HISTOGRAM_BIN_COUNT,
+                                  metadata->getHistogramBins());
+
+        if (drop || !sourceOk)
+        {
+            if (drop)
+                countStat(&Stats::dropped);
+        }
+        else
+        {
+            for (size_t i = 0; i < request.streamStates.size(); i++)
+            {
+                StreamState* stream = request.streamStates[i].get();
+                StreamBuffer* buffer = stream->dequeueBuffer(m_generation, generation);
+                if (!buffer)
+                    continue;
+
+                m_source.render(exposure.brightness(), &buffer->image);
+                buffer->number = captureId;
+                buffer->time = timestamp;
+                if (stream->getMetadataEnable())
+                    buffer->metadata = metadata;
+                stream->queueBuffer(buffer);
+            }
+        }
+
+        ScopedLock lock(m_mutex);
+        postEventLocked(std::make_shared<ReplayEvent>(
+            (drop || !sourceOk) ? EVENT_TYPE_ERROR : EVENT_TYPE_CAPTURE_COMPLETE, getTimeNs(),
+            captureId, metadata, sourceOk ? (drop ? STATUS_CANCELLED : STATUS_OK) :
+            STATUS_UNAVAILABLE));
+    }
+
+    const Options m_options;
+    std::vector<ReplayCameraDevice*> m_devices;
+    FrameSource m_source;
+    Random m_random;
+    ExposureResult m_lastExposure;
+
+    mutable Mutex m_mutex;
+    mutable Condition m_cond;
+    Condition m_eventCond;
+    pthread_t m_thread;
+    bool m_exit;
+    bool m_busy;
+
+    std::deque<Capture> m_pending;
+    std::vector<RequestState> m_repeat;
+    bool m_repeating;
+    size_t m_repeatIndex;
+    uint32_t m_repeatFirst;
+    uint32_t m_repeatLast;
+    uint32_t m_nextCaptureId;
+    std::atomic<uint32_t> m_generation;
+    uint64_t m_sequence;
+    uint64_t m_lastTimestamp;
+
+    std::vector<ReplayEventQueue*> m_queues;
+    std::vector<std::weak_ptr<StreamState> > m_streams;
+};
+
+void ReplayEventQueue::destroy()
+{
+    if (m_session)
+        m_session->removeEventQueue(this);
+    delete this;
+}
+
+CaptureSession* createCaptureSession(const Options& options,
+                                     const std::vector<ReplayCameraDevice*>& devices,
+                                     Status* status)
+{
+    ReplayCaptureSession* session = new ReplayCaptureSession(options, devices);
+
+    if (!session->initialize())
+    {
+        session->destroy();
+        if (status)
+            *status = STATUS_UNAVAILABLE;
+        return NULL;
+    }
+    if (status)
+        *status = STATUS_OK;
+    return session;
+}
+
+} // namespace Replay
+
+} // namespace ArgusSamples
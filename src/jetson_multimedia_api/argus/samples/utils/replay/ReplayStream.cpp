@@ -0,0 +1,683 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <inttypes.h>
+
+#include "ReplayInternal.h"
+
+namespace ArgusSamples
+{
+
+namespace Replay
+{
+
+using namespace Argus;
+using Argus::Status;
+
+static Mutex s_handleMutex;
+static std::map<EGLStreamKHR, std::weak_ptr<StreamState> > s_handles;
+
+StreamState::StreamState(const PixelFormat& format, const Size2D<uint32_t>& resolution,
+                         const EGLStreamMode& mode, uint32_t fifoLength, bool metadataEnable,
+                         uint64_t stallWarning)
+    : m_format(format)
+    , m_resolution(resolution)
+    , m_mailbox(mode == EGL_STREAM_MODE_MAILBOX)
+    , m_fifoLength(std::max(fifoLength, 1u))
+    , m_metadataEnable(metadataEnable)
+    , m_stallWarning(stallWarning)
+    , m_held(0)
+    , m_consumerConnected(false)
+    , m_producerConnected(true)
+{
+    // The queue plus one buffer being produced and one being consumed, as with an EGLStream.
+    const uint32_t count = (m_mailbox ? 1 : m_fifoLength) + 2;
+
+    m_buffers.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_buffers[i].image.allocate(format, resolution);
+        m_free.push_back(&m_buffers[i]);
+    }
+}
+
+StreamState::~StreamState()
+{
+    ScopedLock lock(s_handleMutex);
+    s_handles.erase(getHandle());
+}
+
+void StreamState::registerHandle()
+{
+    ScopedLock lock(s_handleMutex);
+    s_handles[getHandle()] = shared_from_this();
+}
+
+EGLStreamKHR StreamState::getHandle() const
+{
+    return (EGLStreamKHR)this;
+}
+
+std::shared_ptr<StreamState> StreamState::fromHandle(EGLStreamKHR handle)
+{
+    ScopedLock lock(s_handleMutex);
+    std::map<EGLStreamKHR, std::weak_ptr<StreamState> >::iterator it = s_handles.find(handle);
+    return (it != s_handles.end()) ? it->second.lock() : std::shared_ptr<StreamState>();
+}
+
+static void recycleBuffer(StreamBuffer* buffer, std::vector<StreamBuffer*>* freeList)
+{
+    buffer->metadata.reset();
+    freeList->push_back(buffer);
+}
+
+StreamBuffer* StreamState::dequeueBuffer(const std::atomic<uint32_t>& generation,
+                                         uint32_t expected)
+{
+    ScopedLock lock(m_mutex);
+    const uint64_t start = getTimeNs();
+    StreamBuffer* buffer = NULL;
+    bool stalled = false;
+    bool reported = false;
+
+    while (true)
+    {
+        if (!m_consumerConnected)
+        {
+            countStat(&Stats::unconsumed);
+            break;
+        }
+        if (!m_producerConnected || generation != expected)
+            break;
+
+        if (!m_free.empty() && (m_mailbox || m_queue.size() < m_fifoLength))
+        {
+            buffer = m_free.back();
+            m_free.pop_back();
+            break;
+        }
+        if (m_mailbox && !m_queue.empty())
+        {
+            // Every other buffer is held by the consumer, reuse the one it did not acquire.
+            buffer = m_queue.front();
+            m_queue.pop_front();
+            buffer->metadata.reset();
+            countStat(&Stats::overwritten);
+            break;
+        }
+
+        stalled = true;
+        if (!reported && getTimeNs() - start >= m_stallWarning)
+        {
+            REPLAY_LOG("Capture stalled for %" PRIu64 " ms on stream %p: the consumer holds "
+                       "%u of %zu buffers and has not acquired %zu queued frames",
+                       (getTimeNs() - start) / 1000000, this, m_held, m_buffers.size(),
+                       m_queue.size());
+            reported = true;
+        }
+        m_cond.waitUntil(m_mutex, reported ? UINT64_MAX : start + m_stallWarning);
+    }
+
+    if (stalled)
+    {
+        countStat(&Stats::stalls);
+        countStat(&Stats::stallTime, getTimeNs() - start);
+    }
+    return buffer;
+}
+
+void StreamState::queueBuffer(StreamBuffer* buffer)
+{
+    ScopedLock lock(m_mutex);
+
+    if (!m_consumerConnected)
+    {
+        recycleBuffer(buffer, &m_free);
+        countStat(&Stats::unconsumed);
+        return;
+    }
+
+    if (m_mailbox)
+    {
+        while (!m_queue.empty())
+        {
+            recycleBuffer(m_queue.front(), &m_free);
+            m_queue.pop_front();
+            countStat(&Stats::overwritten);
+        }
+    }
+
+    buffer->queueTime = getTimeNs();
+    m_queue.push_back(buffer);
+    countStat(&Stats::delivered);
+    m_cond.broadcast();
+}
+
+void StreamState::interrupt()
+{
+    ScopedLock lock(m_mutex);
+    m_cond.broadcast();
+}
+
+void StreamState::disconnectProducer()
+{
+    ScopedLock lock(m_mutex);
+    m_producerConnected = false;
+    m_cond.broadcast();
+}
+
+Status StreamState::connectConsumer()
+{
+    ScopedLock lock(m_mutex);
+
+    if (!m_producerConnected)
+        return STATUS_DISCONNECTED;
+    if (m_consumerConnected)
+        return STATUS_UNAVAILABLE;
+
+    m_consumerConnected = true;
+    m_cond.broadcast();
+    return STATUS_OK;
+}
+
+void StreamState::disconnectConsumer()
+{
+    ScopedLock lock(m_mutex);
+
+    m_consumerConnected = false;
+    while (!m_queue.empty())
+    {
+        recycleBuffer(m_queue.front(), &m_free);
+        m_queue.pop_front();
+    }
+    m_cond.broadcast();
+}
+
+Status StreamState::waitUntilConnected(uint64_t timeout)
+{
+    ScopedLock lock(m_mutex);
+    const uint64_t deadline = getDeadline(timeout);
+
+    while (!m_consumerConnected)
+    {
+        if (!m_producerConnected)
+            return STATUS_DISCONNECTED;
+        if (!m_cond.waitUntil(m_mutex, deadline))
+            return STATUS_TIMEOUT;
+    }
+    return STATUS_OK;
+}
+
+StreamBuffer* StreamState::acquireBuffer(uint64_t timeout, Status* status)
+{
+    ScopedLock lock(m_mutex);
+    const uint64_t deadline = getDeadline(timeout);
+
+    while (m_queue.empty())
+    {
+        if (!m_producerConnected)
+        {
+            if (status)
+                *status = STATUS_DISCONNECTED;
+            return NULL;
+        }
+        if (!m_cond.waitUntil(m_mutex, deadline) && m_queue.empty())
+        {
+            if (status)
+                *status = STATUS_TIMEOUT;
+            return NULL;
+        }
+    }
+
+    StreamBuffer* buffer = m_queue.front();
+    m_queue.pop_front();
+    m_held++;
+    buffer->acquireTime = getTimeNs();
+    countStat(&Stats::acquired);
+    countStat(&Stats::queueTime, buffer->acquireTime - buffer->queueTime);
+
+    // A FIFO producer may be waiting for the queue to drain.
+    m_cond.broadcast();
+
+    if (status)
+        *status = STATUS_OK;
+    return buffer;
+}
+
+void StreamState::releaseBuffer(StreamBuffer* buffer)
+{
+    ScopedLock lock(m_mutex);
+
+    m_held--;
+    holdStat(getTimeNs() - buffer->acquireTime);
+    recycleBuffer(buffer, &m_free);
+    m_cond.broadcast();
+}
+
+class ReplayOutputStreamSettings : public OutputStreamSettings, public IOutputStreamSettings,
+                                   public IEGLOutputStreamSettings
+{
+public:
+    ReplayOutputStreamSettings(ReplayCameraDevice* device, const Options& options)
+        : m_device(device)
+        , m_format(PIXEL_FMT_UNKNOWN)
+        , m_resolution(0, 0)
+        , m_exposureCount(1)
+        , m_display(EGL_NO_DISPLAY)
+        , m_mode(EGL_STREAM_MODE_MAILBOX)
+        , m_fifoLength(1)
+        , m_metadataEnable(false)
+        , m_stallWarning(options.stallWarning)
+    {
+    }
+
+    virtual ~ReplayOutputStreamSettings() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_OUTPUT_STREAM_SETTINGS)
+            return static_cast<IOutputStreamSettings*>(this);
+        if (interfaceId == IID_EGL_OUTPUT_STREAM_SETTINGS)
+            return static_cast<IEGLOutputStreamSettings*>(this);
+        return NULL;
+    }
+
+    virtual void destroy() { delete this; }
+
+    virtual Status setCameraDevice(CameraDevice* device)
+    {
+        ReplayCameraDevice* replayDevice = dynamic_cast<ReplayCameraDevice*>(device);
+        if (!replayDevice)
+            return STATUS_INVALID_PARAMS;
+        m_device = replayDevice;
+        return STATUS_OK;
+    }
+
+    virtual CameraDevice* getCameraDevice() const { return m_device; }
+
+    virtual Status setPixelFormat(const PixelFormat& format)
+    {
+        if (format != PIXEL_FMT_YCbCr_420_888 && format != PIXEL_FMT_Y8)
+        {
+            REPLAY_LOG("Pixel format %s is not supported", format.getName());
+            return STATUS_INVALID_PARAMS;
+        }
+        m_format = format;
+        return STATUS_OK;
+    }
+
+    virtual PixelFormat getPixelFormat() const { return m_format; }
+
+    virtual Status setResolution(const Size2D<uint32_t>& resolution)
+    {
+        if (resolution.width() < 2 || resolution.height() < 2)
+            return STATUS_INVALID_PARAMS;
+        m_resolution = Size2D<uint32_t>(resolution.width() & ~1u, resolution.height() & ~1u);
+        return STATUS_OK;
+    }
+
+    virtual Size2D<uint32_t> getResolution() const { return m_resolution; }
+
+    virtual Status setExposureCount(uint32_t exposureCount)
+    {
+        if (exposureCount != 1)
+            return STATUS_INVALID_PARAMS;
+        return STATUS_OK;
+    }
+
+    virtual uint32_t getExposureCount() const { return m_exposureCount; }
+
+    virtual Status setEGLDisplay(EGLDisplay eglDisplay)
+    {
+        m_display = eglDisplay;
+        return STATUS_OK;
+    }
+
+    virtual EGLDisplay getEGLDisplay() const { return m_display; }
+
+    virtual Status setMode(const EGLStreamMode& mode)
+    {
+        m_mode = mode;
+        return STATUS_OK;
+    }
+
+    virtual EGLStreamMode getMode() const { return m_mode; }
+
+    virtual Status setFifoLength(uint32_t fifoLength)
+    {
+        if (fifoLength == 0)
+            return STATUS_INVALID_PARAMS;
+        m_fifoLength = fifoLength;
+        return STATUS_OK;
+    }
+
+    virtual uint32_t getFifoLength() const { return m_fifoLength; }
+
+    virtual Status setMetadataEnable(bool metadataEnable)
+    {
+        m_metadataEnable = metadataEnable;
+        return STATUS_OK;
+    }
+
+    virtual bool getMetadataEnable() const { return m_metadataEnable; }
+
+    virtual bool supportsOutputStreamFormat(const SensorMode* sensorMode,
+                                            const PixelFormat& outputFormat) const
+    {
+        return outputFormat == PIXEL_FMT_YCbCr_420_888 || outputFormat == PIXEL_FMT_Y8;
+    }
+
+    uint64_t getStallWarning() const { return m_stallWarning; }
+
+private:
+    ReplayCameraDevice* m_device;
+    PixelFormat m_format;
+    Size2D<uint32_t> m_resolution;
+    uint32_t m_exposureCount;
+    EGLDisplay m_display;
+    EGLStreamMode m_mode;
+    uint32_t m_fifoLength;
+    bool m_metadataEnable;
+    uint64_t m_stallWarning;
+};
+
+class ReplayOutputStream : public OutputStream, public IEGLOutputStream
+{
+public:
+    ReplayOutputStream(const std::shared_ptr<StreamState>& state, EGLDisplay display)
+        : m_state(state)
+        , m_display(display)
+    {
+    }
+
+    virtual ~ReplayOutputStream() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == IID_EGL_OUTPUT_STREAM)
+            return static_cast<IEGLOutputStream*>(this);
+        return NULL;
+    }
+
+    virtual void destroy()
+    {
+        m_state->disconnectProducer();
+        delete this;
+    }
+
+    virtual Status waitUntilConnected(uint64_t timeout) const
+    {
+        return m_state->waitUntilConnected(timeout);
+    }
+
+    virtual void disconnect() { m_state->disconnectProducer(); }
+    virtual PixelFormat getPixelFormat() const { return m_state->getPixelFormat(); }
+    virtual Size2D<uint32_t> getResolution() const { return m_state->getResolution(); }
+    virtual EGLDisplay getEGLDisplay() const { return m_display; }
+    virtual EGLStreamKHR getEGLStream() const { return m_state->getHandle(); }
+
+    const std::shared_ptr<StreamState>& getState() const { return m_state; }
+
+private:
+    std::shared_ptr<StreamState> m_state;
+    EGLDisplay m_display;
+};
+
+std::shared_ptr<StreamState> getStreamState(const OutputStream* stream)
+{
+    const ReplayOutputStream* replayStream = dynamic_cast<const ReplayOutputStream*>(stream);
+    return replayStream ? replayStream->getState() : std::shared_ptr<StreamState>();
+}
+
+OutputStreamSettings* createOutputStreamSettings(ReplayCameraDevice* device,
+                                                 const Options& options)
+{
+    return new ReplayOutputStreamSettings(device, options);
+}
+
+OutputStream* createOutputStream(const OutputStreamSettings* settings, Status* status)
+{
+    const ReplayOutputStreamSettings* replaySettings =
+        dynamic_cast<const ReplayOutputStreamSettings*>(settings);
+
+    if (!replaySettings || replaySettings->getPixelFormat() == PIXEL_FMT_UNKNOWN ||
+        replaySettings->getResolution().area() == 0)
+    {
+        if (status)
+            *status = STATUS_INVALID_SETTINGS;
+        return NULL;
+    }
+
+    std::shared_ptr<StreamState> state = std::make_shared<StreamState>(
+        replaySettings->getPixelFormat(), replaySettings->getResolution(),
+        replaySettings->getMode(), replaySettings->getFifoLength(),
+        replaySettings->getMetadataEnable(), replaySettings->getStallWarning());
+    state->registerHandle();
+
+    if (status)
+        *status = STATUS_OK;
+    return new ReplayOutputStream(state, replaySettings->getEGLDisplay());
+}
+
+/**
+ * Image of an acquired frame, a view of the stream buffer.
+ */
+class ReplayImage : public EGLStream::Image, public EGLStream::IImage, public EGLStream::IImage2D,
+                    public EGLStream::IImageJPEG, public EGLStream::IImageHeaderlessFile
+{
+public:
+    explicit ReplayImage(StreamBuffer* buffer) : m_buffer(buffer) {}
+    virtual ~ReplayImage() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == EGLStream::IID_IMAGE)
+            return static_cast<EGLStream::IImage*>(this);
+        if (interfaceId == EGLStream::IID_IMAGE_2D)
+            return static_cast<EGLStream::IImage2D*>(this);
+        if (interfaceId == EGLStream::IID_IMAGE_JPEG)
+            return static_cast<EGLStream::IImageJPEG*>(this);
+        if (interfaceId == EGLStream::IID_IMAGE_HEADERLESS_FILE)
+            return static_cast<EGLStream::IImageHeaderlessFile*>(this);
+        return NULL;
+    }
+
+    virtual uint32_t getBufferCount() const { return m_buffer->image.planeCount; }
+
+    virtual uint64_t getBufferSize(uint32_t index) const
+    {
+        return (index < m_buffer->image.planeCount) ? m_buffer->image.data[index].size() : 0;
+    }
+
+    virtual const void* mapBuffer(uint32_t index, Status* status)
+    {
+        if (index >= m_buffer->image.planeCount)
+        {
+            if (status)
+                *status = STATUS_INVALID_PARAMS;
+            return NULL;
+        }
+        if (status)
+            *status = STATUS_OK;
+        return m_buffer->image.data[index].data();
+    }
+
+    virtual const void* mapBuffer(Status* status)
+    {
+        return mapBuffer(0, status);
+    }
+
+    virtual Size2D<uint32_t> getSize(uint32_t index) const
+    {
+        return (index < m_buffer->image.planeCount) ? m_buffer->image.size[index] :
+                                                      Size2D<uint32_t>(0, 0);
+    }
+
+    virtual uint32_t getStride(uint32_t index) const
+    {
+        return (index < m_buffer->image.planeCount) ? m_buffer->image.stride[index] : 0;
+    }
+
+    virtual Status writeJPEG(const char* path) const
+    {
+        REPLAY_LOG("JPEG encoding is not available, use IImageHeaderlessFile");
+        return STATUS_UNIMPLEMENTED;
+    }
+
+    virtual Status writeHeaderlessFile(const char* path) const
+    {
+        const ImageData& image = m_buffer->image;
+        FILE* file = fopen(path, "wb");
+
+        if (!file)
+            return STATUS_INVALID_PARAMS;
+
+        for (uint32_t i = 0; i < image.planeCount; i++)
+        {
+            const uint32_t rowBytes = (i == 0) ? image.size[i].width() : image.size[i].width() * 2;
+            for (uint32_t y = 0; y < image.size[i].height(); y++)
+            {
+                if (fwrite(&image.data[i][(size_t)y * image.stride[i]], 1, rowBytes, file) !=
+                    rowBytes)
+                {
+                    fclose(file);
+                    return STATUS_OUT_OF_MEMORY;
+                }
+            }
+        }
+
+        return (fclose(file) == 0) ? STATUS_OK : STATUS_OUT_OF_MEMORY;
+    }
+
+private:
+    StreamBuffer* m_buffer;
+};
+
+class ReplayFrame : public EGLStream::Frame, public EGLStream::IFrame,
+                    public EGLStream::IArgusCaptureMetadata
+{
+public:
+    ReplayFrame(const std::shared_ptr<StreamState>& state, StreamBuffer* buffer)
+        : m_state(state)
+        , m_buffer(buffer)
+        , m_image(buffer)
+    {
+    }
+
+    virtual ~ReplayFrame() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == EGLStream::IID_FRAME)
+            return static_cast<EGLStream::IFrame*>(this);
+        if (interfaceId == EGLStream::IID_ARGUS_CAPTURE_METADATA && m_buffer->metadata)
+            return static_cast<EGLStream::IArgusCaptureMetadata*>(this);
+        return NULL;
+    }
+
+    virtual void destroy()
+    {
+        m_state->releaseBuffer(m_buffer);
+        delete this;
+    }
+
+    virtual uint64_t getNumber() const { return m_buffer->number; }
+    virtual uint64_t getTime() const { return m_buffer->time; }
+    virtual EGLStream::Image* getImage() { return &m_image; }
+
+    virtual CaptureMetadata* getMetadata() const { return m_buffer->metadata.get(); }
+
+private:
+    std::shared_ptr<StreamState> m_state;
+    StreamBuffer* m_buffer;
+    ReplayImage m_image;
+};
+
+class ReplayFrameConsumer : public EGLStream::FrameConsumer, public EGLStream::IFrameConsumer
+{
+public:
+    explicit ReplayFrameConsumer(const std::shared_ptr<StreamState>& state) : m_state(state) {}
+    virtual ~ReplayFrameConsumer() {}
+
+    virtual Interface* getInterface(const InterfaceID& interfaceId)
+    {
+        if (interfaceId == EGLStream::IID_FRAME_CONSUMER)
+            return static_cast<EGLStream::IFrameConsumer*>(this);
+        return NULL;
+    }
+
+    virtual void destroy()
+    {
+        m_state->disconnectConsumer();
+        delete this;
+    }
+
+    virtual EGLStream::Frame* acquireFrame(uint64_t timeout, Status* status)
+    {
+        StreamBuffer* buffer = m_state->acquireBuffer(timeout, status);
+        return buffer ? new ReplayFrame(m_state, buffer) : NULL;
+    }
+
+private:
+    std::shared_ptr<StreamState> m_state;
+};
+
+static EGLStream::FrameConsumer* createFrameConsumer(const std::shared_ptr<StreamState>& state,
+                                                     Status* status)
+{
+    const Status result = state ? state->connectConsumer() : STATUS_INVALID_PARAMS;
+
+    if (status)
+        *status = result;
+    return (result == STATUS_OK) ? new ReplayFrameConsumer(state) : NULL;
+}
+
+} // namespace Replay
+
+} // namespace ArgusSamples
+
+namespace EGLStream
+{
+
+/**
+ * Entry points replacing the ones of libnvargus.
+ */
+FrameConsumer* FrameConsumer::create(Argus::OutputStream* outputStream, Argus::Status* status)
+{
+    using namespace ArgusSamples::Replay;
+    return createFrameConsumer(getStreamState(outputStream), status);
+}
+
+FrameConsumer* FrameConsumer::create(EGLDisplay eglDisplay, EGLStreamKHR eglStream,
+                                     Argus::Status* status)
+{
+    using namespace ArgusSamples::Replay;
+    return createFrameConsumer(StreamState::fromHandle(eglStream), status);
+}
+
+} // namespace EGLStream
@@ -25,8 +25,6 @@
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-
-
 /**
  * @file
  * <b>NVIDIA Multimedia API: Application Resource Profiling API</b>
@@ -36,11 +34,18 @@
 #ifndef __NV_PROFILER_H__
 #define __NV_PROFILER_H__
 
+#include <deque>
 #include <iostream>
+#include <map>
 #include <pthread.h>
 #include <stdint.h>
+#include <string>
 #include <sys/time.h>
+#include <sys/types.h>
 #include <time.h>
+#include <vector>
+
+class NvElement;
 
 /**
  *
@@ -55,10 +60,20 @@
  * Only one instance of NvApplicationProfiler object gets created for the application.
  * It can be accessed using getProfilerInstance().
  *
- * NvApplicationProfiler currently samples CPU usage and provides peak and average CPU
- * usage during the profiling duration. It requires that the CPU frequency be
- * constant over the entire duration. To force this, NvApplicationProfiler will start only
- * when the CPU governor is set to @b performance.
+ * NvApplicationProfiler samples the process CPU usage and provides peak and average
+ * CPU usage during the profiling duration. Each sampling period additionally records
+ * per-thread CPU time, run-queue wait time, context switches and page faults read
+ * from @c /proc/self/task, the resident (RSS) and proportional (PSS) memory of the
+ * process, and the frequency and utilization of every online CPU core. Threads are
+ * attributed to a role (DQ, renderer, TensorRT, ...) from their names.
+ *
+ * The profiler runs under any CPU governor. Conditions which make the measurements
+ * less reliable (a governor other than @b performance, CPU frequency changes, saturated
+ * cores or late samples) are reported through
+ * [noise_flags](@ref NvApplicationProfiler::NvAppProfilerData::noise_flags).
+ *
+ * The sampled time series, along with the throughput of elements registered with
+ * addElement(), can be exported with exportCSV() and exportJSON().
  *
  * @defgroup l4t_mm_nvapplicationprofiler_group  Application Resource Profiler API
  * @ingroup aa_framework_api_group
@@ -67,6 +82,36 @@
 class NvApplicationProfiler
 {
 public:
+    /**
+     * @defgroup Defines @c noise_flags values for the #NvAppProfilerData structure.
+     * @ingroup l4t_mm_nvapplicationprofiler_group
+     * @{
+     */
+    typedef int NoiseFlag;
+    static const NoiseFlag NOISE_NONE = 0;
+    /** CPU governor of at least one core is not @b performance. */
+    static const NoiseFlag NOISE_GOVERNOR = 1;
+    /** Frequency of at least one core changed during profiling. */
+    static const NoiseFlag NOISE_FREQ_CHANGED = 2;
+    /** At least one core was saturated during a sampling period. */
+    static const NoiseFlag NOISE_CPU_SATURATED = 4;
+    /** At least one sample was taken later than half a sampling interval. */
+    static const NoiseFlag NOISE_LATE_SAMPLE = 8;
+    /** @} */
+
+    /**
+     * Defines the role a thread is attributed to, based on its name.
+     */
+    typedef enum
+    {
+        THREAD_ROLE_OTHER = 0,  /**< Thread not matching any known role. */
+        THREAD_ROLE_DQ,         /**< V4L2 plane DQ/capture/output threads. */
+        THREAD_ROLE_RENDER,     /**< EGL/DRM renderer threads. */
+        THREAD_ROLE_TRT,        /**< TensorRT inference threads. */
+        THREAD_ROLE_POLL,       /**< Device poll threads. */
+        THREAD_ROLE_PROFILER,   /**< The profiling thread itself. */
+    } ThreadRole;
+
     /**
      * Holds the profiling data.
      */
@@ -80,12 +125,107 @@ public:
         float avg_cpu_usage;
         /** Number of cpu cores. */
         uint32_t num_cpu_cores;
-        /** Operating frequency of the cpu in MHz. */
+        /** Operating frequency of cpu0 in MHz when the profiler was created. */
         uint32_t cpu_freq_mhz;
+        /** Peak resident set size of the process, in KB. */
+        uint64_t peak_rss_kb;
+        /** Peak proportional set size of the process, in KB. 0 if unavailable. */
+        uint64_t peak_pss_kb;
+        /** Minor page faults taken during profiling. */
+        uint64_t minor_faults;
+        /** Major page faults taken during profiling. */
+        uint64_t major_faults;
+        /** Voluntary context switches of all threads during profiling. */
+        uint64_t voluntary_ctxt_switches;
+        /** Involuntary context switches of all threads during profiling. */
+        uint64_t involuntary_ctxt_switches;
+        /** Number of samples in the time series. */
+        uint64_t num_samples;
+        /** Bitmask of NoiseFlag values. Results may be noisy if non-zero. */
+        NoiseFlag noise_flags;
     } NvAppProfilerData;
 
+    /**
+     * Holds the measurements of one thread over one sampling period.
+     */
+    typedef struct
+    {
+        /** Kernel thread ID. */
+        pid_t tid;
+        /** Thread name as reported by the kernel. */
+        char name[16];
+        /** Role attributed from the thread name. */
+        ThreadRole role;
+        /** CPU usage of the thread, in percent of one core. */
+        float cpu_usage;
+        /** Time spent waiting on a run queue, in microseconds. */
+        uint64_t runqueue_wait_usec;
+        /** Voluntary context switches during the period. */
+        uint64_t voluntary_ctxt_switches;
+        /** Involuntary context switches during the period. */
+        uint64_t involuntary_ctxt_switches;
+        /** Minor page faults during the period. */
+        uint64_t minor_faults;
+        /** Major page faults during the period. */
+        uint64_t major_faults;
+        /** CPU core the thread last ran on. */
+        int32_t last_cpu;
+    } NvAppProfilerThreadSample;
+
+    /**
+     * Holds the measurements of one CPU core over one sampling period.
+     */
+    typedef struct
+    {
+        /** Current frequency in MHz, 0 if unavailable. */
+        uint32_t freq_mhz;
+        /** Utilization of the core by all processes, in percent. */
+        float utilization;
+    } NvAppProfilerCoreSample;
+
+    /**
+     * Holds the throughput of one registered element over one sampling period.
+     */
+    typedef struct
+    {
+        /** Units processed by the element during the period. */
+        uint64_t processed_units;
+        /** Processing rate of the element during the period. */
+        float fps;
+    } NvAppProfilerElementSample;
+
+    /**
+     * Holds one entry of the sampled time series.
+     */
+    typedef struct
+    {
+        /** Time since the profiler was started, in microseconds. */
+        uint64_t timestamp_usec;
+        /** CPU usage of the process, in percent of all cores. */
+        float cpu_usage;
+        /** Resident set size of the process, in KB. */
+        uint64_t rss_kb;
+        /** Proportional set size of the process, in KB. */
+        uint64_t pss_kb;
+        /** Minor page faults of the process during the period. */
+        uint64_t minor_faults;
+        /** Major page faults of the process during the period. */
+        uint64_t major_faults;
+        /** Bitmask of NoiseFlag values raised during the period. */
+        NoiseFlag noise_flags;
+        /** Per-thread measurements. */
+        std::vector<NvAppProfilerThreadSample> threads;
+        /** Per-core measurements, indexed by core number. */
+        std::vector<NvAppProfilerCoreSample> cores;
+        /** Per-element throughput, indexed in addElement() order. */
+        std::vector<NvAppProfilerElementSample> elements;
+    } NvAppProfilerSample;
+
     static const uint64_t DefaultSamplingInterval = 100;
 
+    /** Default maximum number of samples retained in the time series. */
+    static const uint32_t DefaultMaxSamples = 36000;
+
     /**
      * Gets a reference to the global #NvApplicationProfiler instance.
      *
@@ -96,19 +236,35 @@ public:
     /**
      * Starts the profiler with the specified sampling interval.
      *
-     * This method resets the internal profiler data measurements.
+     * This method resets the internal profiler data measurements and
+     * the sampled time series.
      *
      * Starting an already started profiler does nothing.
      *
      * @param[in] sampling_interval_ms Sampling interval in milliseconds.
+     * @param[in] max_samples Maximum number of samples retained in the time
+     *                        series. Oldest samples are dropped first.
      */
-    void start(uint32_t sampling_interval_ms);
+    void start(uint32_t sampling_interval_ms,
+            uint32_t max_samples = DefaultMaxSamples);
 
     /**
      * Stops the profiler.
      */
     void stop();
 
+    /**
+     * Registers an element whose throughput is recorded with every sample.
+     *
+     * Profiling must be enabled on the element for its throughput to be
+     * measured. The element must stay valid while the profiler is running
+     * and until the time series has been exported.
+     *
+     * @param[in] name Name under which the element is exported.
+     * @param[in] element Pointer to the element.
+     */
+    void addElement(const char *name, NvElement *element);
+
     /**
      * Prints the profiler data to an output stream.
      *
@@ -124,6 +280,40 @@ public:
      */
     void getProfilerData(NvAppProfilerData &data);
 
+    /**
+     * Gets a copy of the sampled time series.
+     *
+     * @param[out] samples Vector to be filled with the samples, oldest first.
+     */
+    void getSamples(std::vector<NvAppProfilerSample> &samples);
+
+    /**
+     * Exports the sampled time series as CSV.
+     *
+     * Each line holds one measurement as
+     * <tt>timestamp_usec,scope,name,metric,value</tt>, where scope is one of
+     * @c process, @c thread, @c core or @c element.
+     *
+     * @param[in] outstream Output stream to write to.
+     */
+    void exportCSV(std::ostream &outstream);
+
+    /**
+     * Exports the profiler data, the sampled time series and the summary of
+     * the registered elements' NvElementProfiler data as JSON.
+     *
+     * @param[in] outstream Output stream to write to.
+     */
+    void exportJSON(std::ostream &outstream);
+
+    /**
+     * Gets the name of a thread role.
+     *
+     * @param[in] role Role of the thread.
+     * @return Name of the role.
+     */
+    static const char *getThreadRoleName(ThreadRole role);
+
 private:
     /**
      * Method run by the background profiling thread.
@@ -138,6 +328,7 @@ private:
     bool running;  /**< Boolean flag indicating if profiling thread is running. */
     uint32_t sampling_interval; /**< Interval between two measurements,
                                      in milliseconds. */
+    uint32_t max_samples; /**< Maximum number of samples retained. */
 
     pthread_mutex_t thread_lock; /**< Lock for synchronized multithreaded
                                       access to NvApplicationProfiler::data */
@@ -146,7 +337,40 @@ private:
 
     uint32_t num_cpu_cores; /**< Number of CPU cores. */
     uint32_t cpu_freq; /**< Operating frequency of CPU cores in MHz. */
-    bool check_cpu_usage; /**< Flag indicating if cpu usage should be checked. */
+    NoiseFlag governor_noise; /**< NOISE_GOVERNOR if any governor is not performance. */
+
+    /**
+     * Holds cumulative counters of one thread (internal use only).
+     */
+    struct ThreadCounters
+    {
+        uint64_t cpu_time_nsec;
+        uint64_t runqueue_wait_nsec;
+        uint64_t voluntary_ctxt_switches;
+        uint64_t involuntary_ctxt_switches;
+        uint64_t minor_faults;
+        uint64_t major_faults;
+    };
+
+    /**
+     * Holds cumulative counters of one CPU core (internal use only).
+     */
+    struct CoreCounters
+    {
+        uint64_t busy;
+        uint64_t total;
+        uint32_t freq_mhz;
+    };
+
+    /**
+     * Holds a registered element (internal use only).
+     */
+    struct ElementEntry
+    {
+        std::string name;
+        NvElement *element;
+        uint64_t last_units;
+    };
 
     /**
      * Holds resource usage readings (internal use only).
@@ -177,14 +401,66 @@ private:
         /** Average CPU usage over the entire profiling duration. */
         float avg_cpu_usage;
 
+        /** Peak resident set size, in KB. */
+        uint64_t peak_rss_kb;
+        /** Peak proportional set size, in KB. */
+        uint64_t peak_pss_kb;
+        /** Page faults accumulated over all sampled periods. */
+        uint64_t minor_faults;
+        uint64_t major_faults;
+        /** Context switches accumulated over all sampled periods. */
+        uint64_t voluntary_ctxt_switches;
+        uint64_t involuntary_ctxt_switches;
+        /** Bitmask of NoiseFlag values raised since start. */
+        NoiseFlag noise_flags;
+
         /** Number of readings taken. */
         uint64_t num_readings;
     } data; /**< Internal structure to hold intermediate measurements. */
 
+    /** Cumulative counters of each thread at the latest reading. */
+    std::map<pid_t, ThreadCounters> thread_counters;
+    /** Cumulative counters of each core at the latest reading. */
+    std::vector<CoreCounters> core_counters;
+    /** Cumulative process page faults at the latest reading. */
+    uint64_t proc_minor_faults;
+    uint64_t proc_major_faults;
+    /** Registered elements. */
+    std::vector<ElementEntry> elements;
+    /** Sampled time series. */
+    std::deque<NvAppProfilerSample> samples;
+
     /**
      * Measures resource usage parameters.
+     *
+     * @param[in] lateness_usec Delay of this reading from its scheduled time.
+     */
+    void profile(uint64_t lateness_usec);
+
+    /**
+     * Reads the per-thread counters and fills the thread samples.
+     */
+    void sampleThreads(NvAppProfilerSample &sample, float interval_usec);
+
+    /**
+     * Reads the per-core counters and fills the core samples.
+     */
+    void sampleCores(NvAppProfilerSample &sample);
+
+    /**
+     * Reads the process memory usage and page faults.
+     */
+    void sampleMemory(NvAppProfilerSample &sample);
+
+    /**
+     * Reads the throughput of the registered elements.
+     */
+    void sampleElements(NvAppProfilerSample &sample, float interval_usec);
+
+    /**
+     * Resets the per-period counters to the current readings.
      */
-    void profile();
+    void resetCounters();
 
     /**
      * Default constructor used by getProfilerInstance.
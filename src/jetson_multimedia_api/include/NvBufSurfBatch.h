@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Batched Buffer Transform API</b>
+ *
+ * @b Description: This file declares the NvBufSurfBatch API.
+ */
+#ifndef __NV_BUF_SURF_BATCH_H__
+#define __NV_BUF_SURF_BATCH_H__
+
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+#include "NvBufSurface.h"
+
+/**
+ * @defgroup l4t_mm_nvbufsurfbatch_group Batched Buffer Transform API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/**
+ * Holds one transform of a batch.
+ */
+typedef struct
+{
+    /** FD of the source buffer. */
+    int src_fd;
+    /** FD of the destination buffer. */
+    int dst_fd;
+    /** Rectangles, flags, flip and filter, as for NvBufSurf::NvTransform(). */
+    NvBufSurf::NvCommonTransformParams params;
+} NvBufSurfBatchJob;
+
+/**
+ * Holds the backend calls used by an NvBufSurfBatch.
+ */
+typedef struct
+{
+    /**
+     * Resolves the FD of a buffer to its surface.
+     *
+     * @param[in] fd FD of the buffer.
+     * @param[out] surface Surface of the buffer, with one filled entry.
+     * @param[in] arg Argument of the calls.
+     * @return 0 for success, -1 otherwise.
+     */
+    int (*resolve)(int fd, NvBufSurface **surface, void *arg);
+    /**
+     * Transforms batched surfaces, as NvBufSurfTransformAsync().
+     *
+     * @param[in] src Source surfaces.
+     * @param[in] dst Destination surfaces, as many as @a src.
+     * @param[in] params Transform parameters, with one rectangle per surface.
+     * @param[out] sync_obj Completion of the transform, or NULL to return
+     *                      once the transform is complete. A backend may
+     *                      set it to NULL if it completed the transform.
+     * @param[in] arg Argument of the calls.
+     * @return 0 for success, an NvBufSurfTransform_Error otherwise.
+     */
+    int (*transform)(NvBufSurface *src, NvBufSurface *dst,
+                     NvBufSurfTransformParams *params,
+                     NvBufSurfTransformSyncObj_t *sync_obj, void *arg);
+    /**
+     * Waits for a completion returned by transform and destroys it.
+     *
+     * @return 0 for success, an NvBufSurfTransform_Error otherwise.
+     */
+    int (*wait)(NvBufSurfTransformSyncObj_t sync_obj, uint32_t timeout_ms,
+                void *arg);
+    /** Argument of the calls. */
+    void *arg;
+} NvBufSurfBatchOps;
+
+/**
+ * Holds the completion of a batch.
+ *
+ * A batch is submitted as one transform call per run of jobs sharing the
+ * same flags, flip, filter and memory types, so the fence may hold several
+ * completions. It is waited for as one with NvBufSurfBatch::wait().
+ */
+typedef struct
+{
+    /** Completions of the transform calls of the batch. */
+    std::vector<NvBufSurfTransformSyncObj_t> sync_objs;
+} NvBufSurfBatchFence;
+
+/**
+ * Holds the statistics of an NvBufSurfBatch.
+ */
+typedef struct
+{
+    /** Number of submit() calls. */
+    uint64_t num_submits;
+    /** Number of jobs submitted. */
+    uint64_t num_jobs;
+    /** Number of backend transform calls. */
+    uint64_t num_calls;
+    /** Number of FDs resolved by the backend. */
+    uint64_t num_lookups;
+    /** Number of FDs found in the surface cache. */
+    uint64_t num_cache_hits;
+    /** Total time spent in submit(), in microseconds. */
+    uint64_t submit_usec;
+    /** Total time spent in wait(), in microseconds. */
+    uint64_t wait_usec;
+} NvBufSurfBatchStats;
+
+/**
+ *
+ * Helper class submitting many buffer transforms at once.
+ *
+ * NvBufSurf::NvTransform() resolves the source and destination FDs on
+ * every call and submits a single transform. For many small crops or
+ * scales, for example one per stream of a multi-stream sample, the lookups
+ * and the per-call submission dominate. NvBufSurfBatch keeps the surfaces
+ * of the FDs it has seen, and submits runs of jobs that share the same
+ * transform flags, flip, filter and memory types as one batched transform
+ * call, with one rectangle pair per job.
+ *
+ * The backend calls are passed in: hardwareOps() uses NvBufSurfTransform,
+ * NvBufSurfCpuTransform transforms system memory buffers on the CPU.
+ *
+ * A buffer that is destroyed must be removed with forget() first, as its
+ * FD may be reused. An NvBufSurfBatch is used from one thread.
+ */
+class NvBufSurfBatch
+{
+public:
+    /**
+     * Creates a batch submitter.
+     *
+     * @param[in] name Name, used when printing statistics.
+     * @param[in] ops Backend calls.
+     * @param[in] max_batch_size Maximum number of jobs per transform call.
+     */
+    NvBufSurfBatch(const char *name, const NvBufSurfBatchOps &ops,
+                   uint32_t max_batch_size);
+
+    ~NvBufSurfBatch();
+
+    /**
+     * Submits transforms.
+     *
+     * All the FDs are resolved before anything is submitted, so an unknown
+     * FD fails the batch without side effects.
+     *
+     * @param[in] jobs Transforms.
+     * @param[in] count Number of transforms.
+     * @param[out] fence Completion of the batch, to be passed to wait(), or
+     *                   NULL to return once the transforms are complete.
+     *                   On failure it holds the calls already submitted,
+     *                   and must still be waited for.
+     * @return 0 for success, -1 otherwise.
+     */
+    int submit(const NvBufSurfBatchJob *jobs, uint32_t count,
+               NvBufSurfBatchFence *fence);
+
+    /**
+     * Waits for a batch and releases its completions.
+     *
+     * @param[in] fence Completion of the batch.
+     * @param[in] timeout_ms Maximum wait per transform call, in milliseconds.
+     * @return 0 for success, -1 otherwise.
+     */
+    int wait(NvBufSurfBatchFence *fence, uint32_t timeout_ms);
+
+    /**
+     * Removes a buffer from the surface cache.
+     *
+     * @param[in] fd FD of the buffer.
+     */
+    void forget(int fd);
+
+    /**
+     * Removes all the buffers from the surface cache.
+     */
+    void clearCache();
+
+    /**
+     * Gets the statistics.
+     *
+     * @param[out] stats Statistics.
+     */
+    void getStats(NvBufSurfBatchStats *stats);
+
+    /**
+     * Prints the statistics.
+     *
+     * @param[in] outstream Output stream.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+    /**
+     * Gets the backend calls using NvBufSurfaceFromFd() and
+     * NvBufSurfTransformAsync().
+     */
+    static NvBufSurfBatchOps hardwareOps();
+
+private:
+    const char *name;
+    NvBufSurfBatchOps ops;
+    uint32_t max_batch_size;
+
+    std::map<int, NvBufSurface *> surfaces;     /**< Surface cache, by FD. */
+
+    /* Scratch space of submit(), kept to avoid allocations per batch */
+    std::vector<NvBufSurface *> src_surfaces;
+    std::vector<NvBufSurface *> dst_surfaces;
+    std::vector<NvBufSurfaceParams> src_list;
+    std::vector<NvBufSurfaceParams> dst_list;
+    std::vector<NvBufSurfTransformRect> src_rects;
+    std::vector<NvBufSurfTransformRect> dst_rects;
+
+    NvBufSurfBatchStats stats;
+
+    NvBufSurface *lookup(int fd);
+    int submitRun(const NvBufSurfBatchJob *jobs, uint32_t first, uint32_t count,
+                  NvBufSurfBatchFence *fence);
+};
+
+/** @} */
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: CPU Buffer Transform API</b>
+ *
+ * @b Description: This file declares the NvBufSurfCpuTransform API.
+ */
+#ifndef __NV_BUF_SURF_CPU_TRANSFORM_H__
+#define __NV_BUF_SURF_CPU_TRANSFORM_H__
+
+#include <map>
+#include <stdint.h>
+
+#include "NvBufSurfBatch.h"
+
+/**
+ * @defgroup l4t_mm_nvbufsurfcputransform_group CPU Buffer Transform API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/**
+ *
+ * Portable reference backend for NvBufSurfBatch.
+ *
+ * Allocates pitch-linear NV12 and RGBA buffers in system memory and
+ * implements crop, scale (nearest or bilinear) and NV12/RGBA conversion
+ * (BT.601 limited range) on the CPU. Flips are not supported.
+ *
+ * It lets the batching be exercised and measured on a machine without
+ * the transform hardware. The per-call costs of the hardware path can be
+ * emulated with @a lookup_usec and @a call_usec, which are spent on every
+ * FD lookup and every transform call.
+ */
+class NvBufSurfCpuTransform
+{
+public:
+    /**
+     * Creates a backend without buffers.
+     *
+     * @param[in] lookup_usec Time spent per FD lookup, in microseconds.
+     * @param[in] call_usec Time spent per transform call, in microseconds.
+     */
+    NvBufSurfCpuTransform(uint32_t lookup_usec = 0, uint32_t call_usec = 0);
+
+    /**
+     * Destroys the backend and its buffers.
+     */
+    ~NvBufSurfCpuTransform();
+
+    /**
+     * Allocates buffers, as NvBufSurf::NvAllocate().
+     *
+     * Only NVBUF_COLOR_FORMAT_NV12 and NVBUF_COLOR_FORMAT_RGBA are
+     * supported; the layout and memory type are ignored.
+     *
+     * @param[in] allocateParams Size and color format of the buffers.
+     * @param[in] numBuffers Number of buffers.
+     * @param[out] fd FDs of the buffers.
+     * @return 0 for success, -1 otherwise.
+     */
+    int allocate(NvBufSurf::NvCommonAllocateParams *allocateParams,
+                 uint32_t numBuffers, int *fd);
+
+    /**
+     * Destroys a buffer.
+     *
+     * @return 0 for success, -1 otherwise.
+     */
+    int destroy(int fd);
+
+    /**
+     * Gets the surface of a buffer, with its planes mapped at
+     * mappedAddr.addr, without counting a lookup.
+     *
+     * @return The surface, or NULL for an unknown FD.
+     */
+    NvBufSurface *getSurface(int fd);
+
+    /**
+     * Gets the backend calls for NvBufSurfBatch.
+     */
+    NvBufSurfBatchOps getOps();
+
+    /**
+     * Transforms batched surfaces on the CPU.
+     *
+     * @return 0 for success, an NvBufSurfTransform_Error otherwise.
+     */
+    static int transform(NvBufSurface *src, NvBufSurface *dst,
+                         NvBufSurfTransformParams *params);
+
+private:
+    uint32_t lookup_usec;
+    uint32_t call_usec;
+    std::map<int, NvBufSurface *> buffers;
+    int next_fd;
+
+    static int resolveCall(int fd, NvBufSurface **surface, void *arg);
+    static int transformCall(NvBufSurface *src, NvBufSurface *dst,
+                             NvBufSurfTransformParams *params,
+                             NvBufSurfTransformSyncObj_t *sync_obj, void *arg);
+    static int waitCall(NvBufSurfTransformSyncObj_t sync_obj,
+                        uint32_t timeout_ms, void *arg);
+};
+
+/** @} */
+#endif
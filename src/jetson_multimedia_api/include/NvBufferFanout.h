@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Buffer Fan-out API</b>
+ *
+ * @b Description: This file declares the NvBufferFanout API.
+ */
+#ifndef __NV_BUFFER_FANOUT_H__
+#define __NV_BUFFER_FANOUT_H__
+
+#include <deque>
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvbufferfanout_group Buffer Fan-out API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/**
+ * Specifies what publish() does when a branch queue is full.
+ */
+typedef enum
+{
+    /** Wait until the branch consumes a buffer (back-pressure). */
+    NV_FANOUT_POLICY_BLOCK,
+    /** Skip the branch for this buffer. */
+    NV_FANOUT_POLICY_DROP
+} NvFanoutPolicy;
+
+/**
+ * Holds the statistics of an NvBufferFanout.
+ */
+typedef struct
+{
+    /** Number of buffers published. */
+    uint64_t num_published;
+    /** Number of buffers recycled. */
+    uint64_t num_recycled;
+    /** Maximum number of buffers published and not yet recycled. */
+    uint32_t max_in_flight;
+    /** Number of publish() calls that waited on a full branch queue. */
+    uint64_t num_full_waits;
+    /** Total time publish() waited on full branch queues, in microseconds. */
+    uint64_t full_wait_usec;
+} NvBufferFanoutStats;
+
+/**
+ * Holds the statistics of one branch of an NvBufferFanout.
+ */
+typedef struct
+{
+    /** Number of buffers delivered to the branch. */
+    uint64_t num_delivered;
+    /** Number of buffers dropped because the branch queue was full. */
+    uint64_t num_dropped;
+    /** Maximum number of buffers queued to the branch. */
+    uint32_t max_depth;
+    /** Time publish() waited on this branch, in microseconds. */
+    uint64_t full_wait_usec;
+} NvBufferFanoutBranchStats;
+
+/**
+ *
+ * Helper class for sharing the buffers of one producer, for example a
+ * decoder capture plane, between several consumers.
+ *
+ * Each published buffer index is queued to every branch and holds one
+ * reference per branch it was queued to. A branch takes buffers with
+ * acquire() and gives them back with release(); the recycle callback is
+ * called once the last reference is released, which is when the buffer
+ * can be queued back to the producer.
+ *
+ * Each branch queue is bounded. When it is full, publish() either waits for
+ * the branch (NV_FANOUT_POLICY_BLOCK), which slows the producer down to the
+ * slowest branch, or skips the branch for that buffer
+ * (NV_FANOUT_POLICY_DROP), so that a slow branch only loses frames itself.
+ *
+ * The class only deals with buffer indexes, so it can be driven by mocked
+ * planes.
+ */
+class NvBufferFanout
+{
+public:
+    /**
+     * Callback run when the last reference to a buffer is released. It is
+     * called without the internal lock held, from the thread that released
+     * the last reference.
+     *
+     * @param[in] index Index of the buffer.
+     * @param[in] arg Argument passed to the constructor.
+     */
+    typedef void (*RecycleCallback)(uint32_t index, void *arg);
+
+    /**
+     * Creates a buffer fan-out.
+     *
+     * @param[in] name Name of the fan-out, used when printing statistics.
+     * @param[in] num_buffers Number of buffer indexes that can be published.
+     * @param[in] recycle Recycle callback.
+     * @param[in] arg Argument passed to the recycle callback.
+     */
+    NvBufferFanout(const char *name, uint32_t num_buffers,
+                   RecycleCallback recycle, void *arg);
+
+    /**
+     * Destroys the fan-out. Buffers still in flight are not recycled.
+     */
+    ~NvBufferFanout();
+
+    /**
+     * Adds a branch. Branches must be added before the first publish().
+     *
+     * @param[in] name Name of the branch.
+     * @param[in] depth Maximum number of buffers queued to the branch.
+     * @param[in] policy Policy applied when the branch queue is full.
+     * @return Branch ID, or -1 on error.
+     */
+    int addBranch(const char *name, uint32_t depth, NvFanoutPolicy policy);
+
+    /**
+     * Gets the number of branches.
+     */
+    uint32_t getNumBranches();
+
+    /**
+     * Sets the number of buffer indexes, for example after the producer
+     * reallocated its buffers. No buffer may be in flight.
+     *
+     * @param[in] num_buffers Number of buffer indexes.
+     * @return 0 on success, -1 if buffers are in flight.
+     */
+    int setNumBuffers(uint32_t num_buffers);
+
+    /**
+     * Publishes a buffer to all the branches. If no branch takes the buffer,
+     * it is recycled before publish() returns.
+     *
+     * @param[in] index Index of the buffer.
+     * @return Number of branches the buffer was queued to, or -1 on error.
+     */
+    int publish(uint32_t index);
+
+    /**
+     * Takes the oldest buffer queued to a branch, waiting until one is
+     * available.
+     *
+     * @param[in] branch Branch ID.
+     * @param[out] index Index of the buffer.
+     * @return 0 on success, -1 if the fan-out is closed and the branch queue
+     *         is empty, or on abort.
+     */
+    int acquire(uint32_t branch, uint32_t &index);
+
+    /**
+     * Releases the reference of a branch to a buffer.
+     *
+     * @param[in] branch Branch ID.
+     * @param[in] index Index of the buffer.
+     * @return 0 on success, -1 if the buffer holds no reference.
+     */
+    int release(uint32_t branch, uint32_t index);
+
+    /**
+     * Marks the end of stream. acquire() fails once the branch queue is empty.
+     */
+    void close();
+
+    /**
+     * Wakes all waiting threads and makes publish() and acquire() fail.
+     */
+    void abort();
+
+    /**
+     * Waits until every published buffer has been recycled.
+     */
+    void waitIdle();
+
+    /**
+     * Gets the number of buffers published and not yet recycled.
+     */
+    uint32_t getNumInFlight();
+
+    /**
+     * Gets the fan-out statistics.
+     *
+     * @param[out] stats Statistics of the fan-out.
+     */
+    void getStats(NvBufferFanoutStats &stats);
+
+    /**
+     * Gets the statistics of a branch.
+     *
+     * @param[in] branch Branch ID.
+     * @param[out] stats Statistics of the branch.
+     * @return 0 on success, -1 if the branch does not exist.
+     */
+    int getBranchStats(uint32_t branch, NvBufferFanoutBranchStats &stats);
+
+    /**
+     * Prints the fan-out and branch statistics.
+     *
+     * @param[in] outstream Output stream to print to.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+private:
+    typedef struct
+    {
+        std::string name;
+        uint32_t depth;
+        NvFanoutPolicy policy;
+        std::deque<uint32_t> queue;
+        NvBufferFanoutBranchStats stats;
+    } Branch;
+
+    std::string name; /**< Name of the fan-out. */
+    RecycleCallback recycle; /**< Recycle callback. */
+    void *arg; /**< Argument passed to the recycle callback. */
+
+    pthread_mutex_t lock; /**< Lock for the queues, references and statistics. */
+    pthread_cond_t work_cond; /**< Signalled when a buffer is queued, on close and on abort. */
+    pthread_cond_t space_cond; /**< Signalled when a buffer is acquired or recycled. */
+    std::deque<Branch> branches; /**< Branches, indexed by branch ID. Stable across addBranch(). */
+    std::vector<uint32_t> refs; /**< References held on each buffer. */
+    uint32_t num_in_flight; /**< Buffers published and not yet recycled. */
+    bool closed; /**< Set by close(). */
+    bool aborted; /**< Set by abort(). */
+
+    NvBufferFanoutStats stats; /**< Fan-out statistics. */
+
+    /**
+     * Drops one reference, returns true if it was the last one.
+     * Called with the lock held.
+     */
+    bool unref(uint32_t index);
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvBufferFanout(const NvBufferFanout& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvBufferFanout const&);
+};
+
+/** @} */
+
+#endif
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Decoder Capture Buffer Pool API</b>
+ *
+ * @b Description: This file declares the NvDecoderCapturePool API.
+ */
+#ifndef __NV_DECODER_CAPTURE_POOL_H__
+#define __NV_DECODER_CAPTURE_POOL_H__
+
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvdecodercapturepool_group Decoder Capture Buffer Pool API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/**
+ * Holds the allocator calls used by an NvDecoderCapturePool.
+ */
+typedef struct
+{
+    /**
+     * Allocates @a count buffers.
+     *
+     * @param[in] width Width of the buffers, in pixels.
+     * @param[in] height Height of the buffers, in pixels.
+     * @param[in] format Format of the buffers, as passed to configure().
+     * @param[in] count Number of buffers.
+     * @param[out] fds FDs of the buffers.
+     * @param[in] arg Argument of the calls.
+     * @return 0 for success, -1 otherwise.
+     */
+    int (*allocate)(uint32_t width, uint32_t height, uint32_t format,
+                    uint32_t count, int *fds, void *arg);
+    /**
+     * Destroys a buffer returned by allocate.
+     *
+     * @return 0 for success, -1 otherwise.
+     */
+    int (*destroy)(int fd, void *arg);
+    /** Argument of the calls. */
+    void *arg;
+} NvDecoderCapturePoolOps;
+
+/**
+ * Holds the statistics of an NvDecoderCapturePool.
+ */
+typedef struct
+{
+    /** Number of configure() calls, one per resolution change. */
+    uint64_t num_configures;
+    /** Number of configure() calls served by the existing buffers. */
+    uint64_t num_reuses;
+    /** Number of configure() calls that only allocated more buffers. */
+    uint64_t num_grows;
+    /** Number of configure() calls that reallocated all the buffers. */
+    uint64_t num_reallocations;
+    /** Number of buffers allocated. */
+    uint64_t num_allocated;
+    /** Number of buffers destroyed. */
+    uint64_t num_destroyed;
+    /** Total time spent in configure(), in microseconds. */
+    uint64_t switch_usec;
+    /** Longest configure(), in microseconds. */
+    uint64_t max_switch_usec;
+} NvDecoderCapturePoolStats;
+
+/**
+ *
+ * Helper class keeping the capture plane buffers of a decoder across
+ * resolution changes.
+ *
+ * On a resolution change the decoder capture plane is released and set up
+ * again for the new format. Destroying and allocating the buffers each
+ * time stalls the stream for several frames. The pool allocates the
+ * buffers for a maximum resolution and, as long as the new format has the
+ * same buffer format and fits in them, hands the same buffers back; the
+ * new resolution is described by the crop of the capture plane. A stream
+ * larger than the buffers reallocates them at the larger size, and the
+ * buffers never shrink.
+ *
+ * The allocator calls are passed in, so that the policy can be tested
+ * without the hardware allocator. The pool is used from the thread that
+ * handles the resolution changes, after the capture plane has released
+ * its buffers.
+ */
+class NvDecoderCapturePool
+{
+public:
+    /**
+     * Creates an empty pool.
+     *
+     * @param[in] name Name of the pool, used when printing statistics.
+     * @param[in] ops Allocator calls.
+     * @param[in] max_width Width the buffers are allocated for at least,
+     *                      or 0 for the width of the stream.
+     * @param[in] max_height Height the buffers are allocated for at least,
+     *                       or 0 for the height of the stream.
+     * @param[in] max_buffers Maximum number of buffers.
+     */
+    NvDecoderCapturePool(const char *name, const NvDecoderCapturePoolOps &ops,
+                         uint32_t max_width, uint32_t max_height,
+                         uint32_t max_buffers);
+
+    /**
+     * Destroys the pool and its buffers.
+     */
+    ~NvDecoderCapturePool();
+
+    /**
+     * Provides @a count buffers for a stream of @a width x @a height.
+     *
+     * The buffers are reused if they have the same @a format and are at
+     * least as large as the stream; buffers are only added if @a count is
+     * larger than before. Otherwise all the buffers are destroyed and
+     * allocated again, at least as large as before.
+     *
+     * @param[in] width Width of the stream, in pixels.
+     * @param[in] height Height of the stream, in pixels.
+     * @param[in] format Buffer format, for example the color format and
+     *                   the layout, compared as an opaque value.
+     * @param[in] count Number of buffers.
+     * @return 0 for success, -1 otherwise; the pool is then empty.
+     */
+    int configure(uint32_t width, uint32_t height, uint32_t format,
+                  uint32_t count);
+
+    /**
+     * Gets the number of buffers of the last configure().
+     */
+    uint32_t getNumBuffers() { return num_buffers; }
+
+    /**
+     * Gets the FD of a buffer.
+     *
+     * @param[in] index Index of the buffer, below getNumBuffers().
+     * @return The FD, or -1 if @a index is out of range.
+     */
+    int getFd(uint32_t index);
+
+    /**
+     * Gets the width the buffers are allocated for.
+     */
+    uint32_t getBufferWidth() { return buffer_width; }
+
+    /**
+     * Gets the height the buffers are allocated for.
+     */
+    uint32_t getBufferHeight() { return buffer_height; }
+
+    /**
+     * Checks whether the buffers are larger than the stream of the last
+     * configure(). Such buffers can't be displayed as they are, only the
+     * stream rectangle of them is valid.
+     */
+    bool isPadded()
+    {
+        return buffer_width != stream_width || buffer_height != stream_height;
+    }
+
+    /**
+     * Destroys all the buffers.
+     */
+    void clear();
+
+    /**
+     * Gets the statistics of the pool.
+     *
+     * @param[out] stats Statistics.
+     */
+    void getStats(NvDecoderCapturePoolStats *stats);
+
+    /**
+     * Prints the statistics of the pool.
+     *
+     * @param[in] outstream Output stream.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+private:
+    const char *name;
+    NvDecoderCapturePoolOps ops;
+    uint32_t max_width;
+    uint32_t max_height;
+    uint32_t max_buffers;
+
+    std::vector<int> fds;       /**< Allocated buffers, a superset of the configured ones. */
+    uint32_t num_buffers;       /**< Buffers of the last configure(). */
+    uint32_t buffer_width;
+    uint32_t buffer_height;
+    uint32_t buffer_format;
+    uint32_t stream_width;      /**< Stream size of the last configure(). */
+    uint32_t stream_height;
+
+    NvDecoderCapturePoolStats stats;
+
+    int allocate(uint32_t count);
+};
+
+/** @} */
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: DRM Mailbox Presentation API</b>
+ *
+ * @b Description: This file declares the NvDrmMailbox and NvDrmAtomicPlane
+ * helpers used by the mailbox mode of NvDrmRenderer.
+ */
+#ifndef __NV_DRM_MAILBOX_H__
+#define __NV_DRM_MAILBOX_H__
+
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * @defgroup l4t_mm_nvdrmmailbox_group DRM Mailbox Presentation API
+ * @ingroup l4t_mm_nvdrmrenderer_group
+ * @{
+ */
+
+/**
+ * Holds the presentation statistics of an NvDrmMailbox.
+ */
+typedef struct
+{
+    /** Number of frames posted. */
+    uint64_t num_posted;
+    /** Number of frames scanned out. */
+    uint64_t num_displayed;
+    /** Number of frames superseded by a newer one before their flip. */
+    uint64_t num_skipped;
+    /** Number of flips that failed to commit. */
+    uint64_t num_failed;
+    /** Sum of the post-to-scanout latencies of the displayed frames, in microseconds. */
+    uint64_t latency_total_usec;
+    /** Lowest post-to-scanout latency, in microseconds. */
+    uint64_t latency_min_usec;
+    /** Highest post-to-scanout latency, in microseconds. */
+    uint64_t latency_max_usec;
+} NvDrmPresentStats;
+
+/**
+ *
+ * Helper class holding the frames of a mailbox presentation.
+ *
+ * At most one frame waits for a flip: posting a frame supersedes the one
+ * still waiting, which the producer gets back at once. The render thread
+ * takes the newest frame with beginFlip() when the previous flip is done,
+ * so that each vblank scans out the most recent frame and the latency never
+ * builds up to the depth of a queue.
+ *
+ * Frames are identified by an integer, such as a dmabuf FD, and time stamps
+ * are CLOCK_MONOTONIC microseconds, the clock of the DRM flip events.
+ */
+class NvDrmMailbox
+{
+public:
+    NvDrmMailbox();
+    ~NvDrmMailbox();
+
+    /**
+     * Posts a frame for the next flip.
+     *
+     * @param[in] buf Frame to display, >= 0.
+     * @param[in] post_usec Time of the post.
+     * @return The frame @a buf supersedes, which the caller can reuse at
+     *         once, or -1.
+     */
+    int post(int buf, uint64_t post_usec);
+
+    /**
+     * Waits until a frame can be flipped, or wake() is called.
+     *
+     * @param[in] timeout_ms Timeout in milliseconds.
+     * @return true if beginFlip() has a frame to return.
+     */
+    bool waitForFrame(uint32_t timeout_ms);
+
+    /**
+     * Wakes waitForFrame(), for example to stop the render thread.
+     */
+    void wake();
+
+    /**
+     * Takes the newest posted frame for a flip.
+     *
+     * @return The frame, or -1 if none is posted or a flip is in flight.
+     */
+    int beginFlip();
+
+    /**
+     * Ends a flip whose commit failed.
+     *
+     * @return The frame of the flip, which the caller gets back.
+     */
+    int abortFlip();
+
+    /**
+     * Ends the flip in flight when its flip-done event arrives.
+     *
+     * @param[in] flip_usec Scanout time from the flip-done event.
+     * @return The frame that left the screen, which the caller gets back,
+     *         or -1.
+     */
+    int endFlip(uint64_t flip_usec);
+
+    /**
+     * Checks whether a flip is in flight.
+     */
+    bool flipInFlight();
+
+    /**
+     * Checks whether a frame is posted and not flipped yet.
+     */
+    bool hasPending();
+
+    /**
+     * Removes the posted frame and the frame on screen, at teardown.
+     *
+     * @param[out] pending Posted frame, or -1.
+     * @param[out] displayed Frame on screen, or -1.
+     */
+    void drain(int *pending, int *displayed);
+
+    /**
+     * Gets the presentation statistics.
+     *
+     * @param[out] stats Statistics.
+     */
+    void getStats(NvDrmPresentStats *stats);
+
+    /**
+     * Prints the presentation statistics.
+     *
+     * @param[in] name Name printed with the statistics.
+     * @param[in] outstream Output stream.
+     */
+    void printStats(const char *name, std::ostream &outstream = std::cout);
+
+private:
+    pthread_mutex_t lock;       /**< Protects the members below. */
+    pthread_cond_t cond;        /**< Signalled on post() and wake(). */
+    bool woken;
+
+    int pending;                /**< Frame waiting for a flip, or -1. */
+    uint64_t pending_usec;
+    int flipping;               /**< Frame of the flip in flight, or -1. */
+    uint64_t flipping_usec;
+    int displayed;              /**< Frame on screen, or -1. */
+
+    NvDrmPresentStats stats;
+};
+
+/**
+ *
+ * Helper class flipping framebuffers on a plane with DRM atomic commits.
+ *
+ * Each flip is a non-blocking atomic commit of the plane state that
+ * requests a flip-done event, delivered through drmHandleEvent() to the
+ * page_flip_handler of the event context with the user data of the flip.
+ *
+ * Creating the helper enables DRM_CLIENT_CAP_ATOMIC on the device, which
+ * also exposes the primary and cursor planes to the legacy plane calls.
+ */
+class NvDrmAtomicPlane
+{
+public:
+    /**
+     * Finds a plane for a CRTC and its properties.
+     *
+     * The primary plane of the CRTC is preferred, then the first plane
+     * that can be used with it.
+     *
+     * @param[in] drm_fd FD of the DRM device.
+     * @param[in] crtc_id ID of the CRTC.
+     * @return The helper, or NULL if the device has no atomic support or
+     *         no usable plane.
+     */
+    static NvDrmAtomicPlane *create(int drm_fd, uint32_t crtc_id);
+
+    ~NvDrmAtomicPlane();
+
+    /**
+     * Commits a framebuffer on the plane.
+     *
+     * @param[in] fb_id Framebuffer to scan out.
+     * @param[in] src_w Width of the framebuffer, in pixels.
+     * @param[in] src_h Height of the framebuffer, in pixels.
+     * @param[in] crtc_w Width of the plane on the display, in pixels.
+     * @param[in] crtc_h Height of the plane on the display, in pixels.
+     * @param[in] user_data Passed to the flip-done event handler.
+     * @return 0 if the commit was queued, or -errno otherwise.
+     */
+    int flip(uint32_t fb_id, uint32_t src_w, uint32_t src_h,
+             uint32_t crtc_w, uint32_t crtc_h, void *user_data);
+
+    /**
+     * Gets the ID of the plane.
+     */
+    uint32_t getPlaneId() { return plane_id; }
+
+private:
+    NvDrmAtomicPlane();
+
+    int drm_fd;
+    uint32_t crtc_id;
+    uint32_t plane_id;
+
+    /** Property IDs of the plane, in the order of prop_names. */
+    uint32_t prop_ids[10];
+    static const char *prop_names[10];
+};
+
+/** @} */
+#endif
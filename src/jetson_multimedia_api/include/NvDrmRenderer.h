@@ -18,6 +18,7 @@
 #define __NV_DRM_RENDERER_H__
 
 #include "NvElement.h"
+#include "NvDrmMailbox.h"
 #include <stdint.h>
 #include <pthread.h>
 #include <queue>
@@ -54,6 +55,19 @@ typedef struct _NvDrmFB {
 } NvDrmFB;
 
 
+/**
+ * Specifies how NvDrmRenderer presents the enqueued buffers.
+ */
+typedef enum
+{
+    /** Every buffer is flipped, in order, paced by setFPS(). */
+    NvDrmPresentMode_Fifo,
+    /** Only the newest enqueued buffer is flipped at each vblank, with an
+        atomic commit. Superseded buffers are returned by dequeBuffer() at
+        once, so the latency stays within a frame or two of the display. */
+    NvDrmPresentMode_Mailbox,
+} NvDrmPresentMode;
+
 /**
  * @brief Helper class for rendering using LibDRM.
  *
@@ -125,6 +139,30 @@ public:
      */
     int setFPS(float fps);
 
+    /**
+     * Sets how the enqueued buffers are presented.
+     *
+     * Must be called before the first enqueBuffer(). The mailbox mode needs
+     * DRM atomic support; without it the renderer stays in FIFO mode.
+     * In mailbox mode the display refresh paces the flips and setFPS() has
+     * no effect. The framebuffer of each buffer is created on its first
+     * flip and kept until the renderer is destroyed, so the application
+     * must keep enqueuing the same buffers.
+     *
+     * @param[in] mode Presentation mode.
+     * @returns 0 for success, or -1 otherwise.
+     */
+    int setPresentMode(NvDrmPresentMode mode);
+
+    /**
+     * Gets the statistics of the mailbox mode: the buffers displayed and
+     * skipped, and their enqueue-to-scanout latency.
+     *
+     * @param[out] stats Statistics.
+     * @returns 0 for success, or -1 if the renderer is not in mailbox mode.
+     */
+    int getPresentStats(NvDrmPresentStats *stats);
+
     /**
      * Enables/disables DRM universal planes client caps,
      * such as @c DRM_CLIENT_CAP_UNIVERSAL_PLANES.
@@ -302,6 +340,11 @@ private:
     pthread_mutex_t dequeue_lock;    /**< Used for synchronization. */
     pthread_cond_t dequeue_cond;     /**< Used for synchronization. */
 
+    NvDrmPresentMode present_mode;  /**< Presentation mode. */
+    NvDrmMailbox *mailbox;          /**< Frames of the mailbox mode. */
+    NvDrmAtomicPlane *atomic_plane; /**< Plane flipped in mailbox mode. */
+    bool mailbox_eos;               /**< EOS enqueued in mailbox mode. */
+
     float fps;                      /**< Rendering rate in frames per second. */
     uint64_t render_time_sec;       /**< Seconds part of the time for which
                                          a frame should be displayed. */
@@ -340,6 +383,16 @@ private:
     static void * renderThread(void *arg);
     static void * renderThreadOrin(void *arg);
 
+    /**
+     * Function executed by the renderThread in mailbox mode.
+     *
+     * Flips the newest enqueued buffer whenever no flip is in flight and
+     * handles the flip-done events.
+     *
+     * \param[in] arg   A pointer to an NvDrmRenderer object.
+     */
+    static void * renderThreadMailbox(void *arg);
+
     /**
      * Callback function for DRM flip event.
      */
@@ -347,6 +400,24 @@ private:
     static void page_flip_handler(int fd, unsigned int frame,
                                   unsigned int sec, unsigned int usec, void *data);
 
+    /**
+     * Callback function for the flip-done event of a mailbox flip.
+     */
+    static void mailbox_flip_handler(int fd, unsigned int frame,
+                                     unsigned int sec, unsigned int usec, void *data);
+
+    /**
+     * Flips the newest enqueued buffer in mailbox mode.
+     *
+     * \return 0 if a flip was committed or nothing was pending, -1 otherwise.
+     */
+    int flipMailbox();
+
+    /**
+     * Returns a buffer to the dequeBuffer() queue.
+     */
+    void releaseBuffer(int fd);
+
     /**
      * Implements the logic of rendering a buffer
      * and waiting until the buffer render time.
@@ -355,6 +426,15 @@ private:
      */
     int renderInternal(int fd);
 
+    /**
+     * Creates a framebuffer for the buffer @a fd.
+     *
+     * \param[in] fd    FD of the buffer.
+     * \param[out] fb   ID of the framebuffer.
+     * \return 0 if successful, -1 otherwise.
+     */
+    int createFB(int fd, uint32_t *fb);
+
     /*
      *  Returns a DRM buffer_object handle.
      *
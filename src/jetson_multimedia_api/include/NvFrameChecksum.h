@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Frame Checksum API</b>
+ *
+ * @b Description: This file declares the NvFrameChecksum API.
+ */
+#ifndef __NV_FRAME_CHECKSUM_H__
+#define __NV_FRAME_CHECKSUM_H__
+
+#include <fstream>
+#include <pthread.h>
+#include <queue>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvframechecksum_group Frame Checksum API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/** Maximum number of planes hashed per frame. */
+#define NV_FRAME_CHECKSUM_MAX_PLANES 3
+
+/**
+ * Holds the checksums of one frame.
+ */
+typedef struct
+{
+    /** Index of the frame in output order. */
+    uint64_t frame;
+    /** Number of valid entries in @a crc. */
+    uint32_t num_planes;
+    /** CRC32C of the visible region of each plane. */
+    uint32_t crc[NV_FRAME_CHECKSUM_MAX_PLANES];
+} NvFrameChecksumEntry;
+
+/**
+ * Describes the planes of a buffer mapped for CPU reads.
+ */
+typedef struct
+{
+    /** Number of planes of the buffer. */
+    uint32_t num_planes;
+    /** Start of each plane. */
+    const uint8_t *data[NV_FRAME_CHECKSUM_MAX_PLANES];
+    /** Visible bytes per row of each plane. */
+    uint32_t row_bytes[NV_FRAME_CHECKSUM_MAX_PLANES];
+    /** Number of rows of each plane. */
+    uint32_t height[NV_FRAME_CHECKSUM_MAX_PLANES];
+    /** Bytes between the starts of two rows of each plane. */
+    uint32_t pitch[NV_FRAME_CHECKSUM_MAX_PLANES];
+} NvFrameChecksumPlanes;
+
+/**
+ * Holds the calls used by an NvFrameChecksum to read the pool buffers.
+ */
+typedef struct
+{
+    /**
+     * Maps a buffer for CPU reads. Called on the worker thread for every
+     * queued buffer; a buffer may stay mapped until unmap is called.
+     *
+     * @param[in] fd FD of the buffer.
+     * @param[out] planes Planes of the buffer.
+     * @param[in] arg Argument of the calls.
+     * @return 0 for success, -1 otherwise.
+     */
+    int (*map)(int fd, NvFrameChecksumPlanes *planes, void *arg);
+    /**
+     * Unmaps a buffer when clearBuffers() removes it from the pool.
+     */
+    void (*unmap)(int fd, void *arg);
+    /** Argument of the calls. */
+    void *arg;
+} NvFrameChecksumOps;
+
+/**
+ *
+ * Helper class for verifying decoded frames by checksum instead of writing
+ * raw YUV.
+ *
+ * For each frame, the CRC32C of the visible region of every plane is
+ * computed row by row, skipping the pitch padding. One line per frame is
+ * written to the checksum file:
+ * @code
+ * <frame> <crc plane 0> <crc plane 1> [<crc plane 2>]
+ * @endcode
+ * and, if a golden checksum file in the same format is given, every frame
+ * is compared with it as it is produced.
+ *
+ * Frames are hashed on a worker thread. The application registers a small
+ * pool of pitch-linear buffers with addBuffer(), takes a free one with
+ * getBuffer(), converts the decoded frame into it, and hands it over with
+ * queueBuffer(). The buffer returns to the pool once it has been hashed, so
+ * the capture loop only waits when the worker falls behind by the whole
+ * pool.
+ *
+ * processFrame() runs the same hashing and comparison synchronously on CPU
+ * pointers, which allows checking the core on synthetic frames. The pool
+ * buffers are mapped with the calls passed in, so that the pool can also
+ * be driven without the hardware buffers.
+ */
+class NvFrameChecksum
+{
+public:
+    /**
+     * Creates the checksum helper.
+     *
+     * @param[in] ops Calls mapping the pool buffers, see getSurfaceOps().
+     */
+    NvFrameChecksum(const NvFrameChecksumOps &ops);
+    ~NvFrameChecksum();
+
+    /**
+     * Gets the calls mapping NvBufSurface buffers, for a pool of buffers
+     * allocated with NvBufSurf::NvAllocate().
+     */
+    static NvFrameChecksumOps getSurfaceOps();
+
+    /**
+     * Opens the checksum files and starts the worker thread.
+     *
+     * @param[in] output_path Path of the checksum file to write, or NULL.
+     * @param[in] golden_path Path of the golden checksum file, or NULL.
+     * @return 0 on success, -1 otherwise.
+     */
+    int open(const char *output_path, const char *golden_path);
+
+    /**
+     * Waits for all queued frames, stops the worker thread, closes the files
+     * and prints a summary.
+     *
+     * @return 0 if no frame mismatched the golden checksums, -1 otherwise.
+     */
+    int close();
+
+    /**
+     * Adds a pitch-linear buffer to the pool. The buffer stays owned by the
+     * caller and has to outlive clearBuffers() or close().
+     *
+     * @param[in] dmabuf_fd FD of the buffer.
+     */
+    void addBuffer(int dmabuf_fd);
+
+    /**
+     * Waits for all queued frames and removes all buffers from the pool,
+     * for example before the buffers are reallocated on a resolution change.
+     */
+    void clearBuffers();
+
+    /**
+     * Gets a free buffer from the pool, waiting until the worker releases
+     * one if all of them are queued. A buffer which is not queued, for
+     * example because the conversion into it failed, is returned to the
+     * pool with addBuffer().
+     *
+     * @return FD of the buffer, or -1 if the pool is empty.
+     */
+    int getBuffer();
+
+    /**
+     * Queues a buffer obtained from getBuffer() for hashing. Frames are
+     * numbered in the order they are queued.
+     *
+     * @param[in] dmabuf_fd FD of the buffer.
+     * @param[in] num_planes Number of planes to hash.
+     * @return 0 on success, -1 otherwise.
+     */
+    int queueBuffer(int dmabuf_fd, uint32_t num_planes);
+
+    /**
+     * Waits until all queued frames have been hashed.
+     */
+    void waitIdle();
+
+    /**
+     * Hashes and checks one frame synchronously.
+     *
+     * @param[in] planes Start of each plane.
+     * @param[in] row_bytes Visible bytes per row of each plane.
+     * @param[in] height Number of rows of each plane.
+     * @param[in] pitch Bytes between the starts of two rows of each plane.
+     * @param[in] num_planes Number of planes.
+     * @param[out] entry Checksums of the frame, or NULL.
+     * @return 0 if the frame matches the golden checksums or no golden file
+     *         was given, -1 otherwise.
+     */
+    int processFrame(const uint8_t * const *planes, const uint32_t *row_bytes,
+                     const uint32_t *height, const uint32_t *pitch,
+                     uint32_t num_planes, NvFrameChecksumEntry *entry = NULL);
+
+    /**
+     * Gets the number of frames checked so far.
+     */
+    uint64_t getFrameCount();
+
+    /**
+     * Gets the number of frames that did not match the golden checksums.
+     */
+    uint64_t getMismatchCount();
+
+    /**
+     * Computes the CRC32C (Castagnoli) of a buffer. Uses the CRC32
+     * instructions of the CPU when available.
+     *
+     * @param[in] crc CRC of the preceding data, 0 for the first block.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of @a data in bytes.
+     * @return CRC32C of the data.
+     */
+    static uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+
+    /**
+     * Computes the CRC32C of the visible region of a plane.
+     *
+     * @param[in] data Start of the plane.
+     * @param[in] row_bytes Visible bytes per row.
+     * @param[in] height Number of rows.
+     * @param[in] pitch Bytes between the starts of two rows.
+     * @return CRC32C of the visible rows.
+     */
+    static uint32_t hashPlane(const uint8_t *data, uint32_t row_bytes,
+                              uint32_t height, uint32_t pitch);
+
+    /**
+     * Formats an entry as one line of a checksum file, without newline.
+     */
+    static std::string formatEntry(const NvFrameChecksumEntry &entry);
+
+    /**
+     * Parses one line of a checksum file.
+     *
+     * @return True if @a line holds an entry.
+     */
+    static bool parseEntry(const std::string &line, NvFrameChecksumEntry &entry);
+
+private:
+    /** Maximum number of mismatches reported individually. */
+    static const uint32_t MaxReportedMismatches = 10;
+
+    typedef struct
+    {
+        int fd;
+        uint32_t num_planes;
+    } Job;
+
+    NvFrameChecksumOps ops; /**< Calls mapping the pool buffers. */
+    pthread_mutex_t lock; /**< Lock for the pool, queue and results. */
+    pthread_cond_t cond; /**< Signalled when the pool or the queue change. */
+    pthread_t worker; /**< Worker thread hashing queued buffers. */
+    bool running; /**< True while the worker thread runs. */
+    bool stop; /**< Set to ask the worker thread to exit. */
+    uint32_t busy; /**< Number of jobs taken but not finished by the worker. */
+
+    std::vector<int> free_buffers; /**< Buffers available to getBuffer(). */
+    std::queue<Job> jobs; /**< Buffers waiting to be hashed. */
+
+    std::ofstream *output; /**< Checksum file, or NULL. */
+    std::vector<NvFrameChecksumEntry> golden; /**< Golden checksums. */
+    bool has_golden; /**< True if a golden file was loaded. */
+    uint64_t frame_count; /**< Number of frames hashed. */
+    uint64_t mismatch_count; /**< Number of mismatching frames. */
+
+    int hashBuffer(int dmabuf_fd, uint32_t num_planes);
+    int checkEntry(NvFrameChecksumEntry &entry);
+    static void *workerThread(void *arg);
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvFrameChecksum(const NvFrameChecksum& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvFrameChecksum const&);
+};
+
+/** @} */
+
+#endif
@@ -38,6 +38,10 @@
 
 #include <iostream>
 #include <sstream>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <type_traits>
 
 /**
  *
@@ -79,6 +83,38 @@ extern int log_level;
  */
 #define DEFAULT_LOG_LEVEL LOG_LEVEL_ERROR
 
+/**
+ * Specifies the synchronous logging backend. Messages are formatted and
+ * written to @c std::cerr on the calling thread. This is the default.
+ */
+#define LOG_BACKEND_SYNC   0
+/**
+ * Specifies the asynchronous text logging backend. The arguments of each
+ * message are recorded into per-thread lock-free ring buffers, and a
+ * background thread formats them and writes the messages to @c std::cerr,
+ * or to the log file.
+ */
+#define LOG_BACKEND_ASYNC  1
+/**
+ * Specifies the asynchronous binary logging backend. Messages are recorded
+ * like with #LOG_BACKEND_ASYNC but the recorded arguments are written as
+ * they are to the log file, to be formatted offline with
+ * NvLogDecodeBinary().
+ */
+#define LOG_BACKEND_BINARY 2
+
+/**
+ * Holds the current logging backend, one of the @c LOG_BACKEND_* values.
+ * Use NvLogSetBackend() to change it.
+ */
+extern int log_backend;
+
+/**
+ * Holds the highest level set for any component with NvLogSetComponentLevel(),
+ * or -1 if no component level is set.
+ */
+extern int log_component_max_level;
+
 /**
  * @cond
  */
@@ -87,10 +123,325 @@ extern int log_level;
 #define __LINE_NUM_STR__ xstringify(__LINE__)
 
 extern const char *log_level_name[];
+
+/**
+ * Holds the static description of a logging call site.
+ *
+ * One instance is created per call site by the logging macros; the rate
+ * limiting state is maintained by the asynchronous backends. The level is
+ * not part of the site, as it may differ from one call to the next.
+ */
+typedef struct
+{
+    const char *file;
+    int line;
+    uint32_t rate_window;
+    uint32_t rate_count;
+    uint32_t suppressed;
+} NvLogSite;
+
+/**
+ * Tags of the arguments recorded by NvLogArgs.
+ */
+enum
+{
+    NVLOG_ARG_SIGNED = 1,   /* size byte, value */
+    NVLOG_ARG_UNSIGNED,     /* size byte, value */
+    NVLOG_ARG_CHAR,         /* char */
+    NVLOG_ARG_BOOL,         /* uint8_t */
+    NVLOG_ARG_DOUBLE,       /* double */
+    NVLOG_ARG_POINTER,      /* uint64_t */
+    NVLOG_ARG_STRING,       /* uint16_t length, characters */
+    NVLOG_ARG_MANIP,        /* one of NVLOG_MANIP_* */
+};
+
+enum
+{
+    NVLOG_MANIP_DEC = 1,
+    NVLOG_MANIP_HEX,
+    NVLOG_MANIP_OCT,
+};
+
+/**
+ * Records the arguments of a message for the asynchronous backends.
+ *
+ * Numbers, strings and the dec/hex/oct manipulators are copied as tagged
+ * raw values into the ring record and formatted by the writer thread.
+ * Other types are formatted on the calling thread and recorded as a
+ * string. Arguments beyond the record size are dropped and the message
+ * is marked truncated.
+ */
+class NvLogArgs
+{
+public:
+    void reset(char *buf, size_t size)
+    {
+        start = pos = buf;
+        end = buf + size;
+        truncated = false;
+    }
+    size_t length() const { return pos - start; }
+    bool isTruncated() const { return truncated; }
+
+    NvLogArgs &operator<<(bool value)
+    {
+        uint8_t v = value;
+        return put(NVLOG_ARG_BOOL, &v, sizeof(v));
+    }
+    NvLogArgs &operator<<(char value) { return put(NVLOG_ARG_CHAR, &value, 1); }
+    NvLogArgs &operator<<(signed char value) { return *this << (char) value; }
+    NvLogArgs &operator<<(unsigned char value) { return *this << (char) value; }
+    NvLogArgs &operator<<(short value) { return putInt(value); }
+    NvLogArgs &operator<<(unsigned short value) { return putInt(value); }
+    NvLogArgs &operator<<(int value) { return putInt(value); }
+    NvLogArgs &operator<<(unsigned int value) { return putInt(value); }
+    NvLogArgs &operator<<(long value) { return putInt(value); }
+    NvLogArgs &operator<<(unsigned long value) { return putInt(value); }
+    NvLogArgs &operator<<(long long value) { return putInt(value); }
+    NvLogArgs &operator<<(unsigned long long value) { return putInt(value); }
+    NvLogArgs &operator<<(float value) { return *this << (double) value; }
+    NvLogArgs &operator<<(long double value) { return *this << (double) value; }
+    NvLogArgs &operator<<(double value)
+    {
+        return put(NVLOG_ARG_DOUBLE, &value, sizeof(value));
+    }
+    NvLogArgs &operator<<(const void *value)
+    {
+        uint64_t v = (uintptr_t) value;
+        return put(NVLOG_ARG_POINTER, &v, sizeof(v));
+    }
+    NvLogArgs &operator<<(const char *value)
+    {
+        return value ? putString(value, strlen(value)) : putString("(null)", 6);
+    }
+    NvLogArgs &operator<<(char *value) { return *this << (const char *) value; }
+    NvLogArgs &operator<<(const std::string &value)
+    {
+        return putString(value.data(), value.size());
+    }
+    NvLogArgs &operator<<(std::ios_base &(*manip)(std::ios_base &))
+    {
+        uint8_t id = 0;
+        if (manip == static_cast<std::ios_base &(*)(std::ios_base &)>(std::dec))
+            id = NVLOG_MANIP_DEC;
+        else if (manip == static_cast<std::ios_base &(*)(std::ios_base &)>(std::hex))
+            id = NVLOG_MANIP_HEX;
+        else if (manip == static_cast<std::ios_base &(*)(std::ios_base &)>(std::oct))
+            id = NVLOG_MANIP_OCT;
+        /* Other manipulators are ignored. */
+        return id ? put(NVLOG_ARG_MANIP, &id, sizeof(id)) : *this;
+    }
+    NvLogArgs &operator<<(std::ostream &(*manip)(std::ostream &))
+    {
+        /* Only std::endl adds output; std::flush and std::ends are ignored. */
+        if (manip == static_cast<std::ostream &(*)(std::ostream &)>(std::endl))
+            return *this << '\n';
+        return *this;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value, NvLogArgs &>::type
+    operator<<(T value)
+    {
+        return putInt(static_cast<typename std::underlying_type<T>::type>(value));
+    }
+    template <typename T>
+    typename std::enable_if<!std::is_enum<T>::value, NvLogArgs &>::type
+    operator<<(const T &value)
+    {
+        std::ostringstream ostr;
+        ostr << value;
+        return *this << ostr.str();
+    }
+
+private:
+    NvLogArgs &put(uint8_t tag, const void *value, size_t size)
+    {
+        if (truncated || (size_t) (end - pos) < size + 1)
+        {
+            truncated = true;
+            return *this;
+        }
+        *pos++ = tag;
+        memcpy(pos, value, size);
+        pos += size;
+        return *this;
+    }
+    template <typename T>
+    NvLogArgs &putInt(T value)
+    {
+        char buf[1 + sizeof(T)];
+        buf[0] = sizeof(T);
+        memcpy(buf + 1, &value, sizeof(T));
+        return put(std::is_signed<T>::value ? NVLOG_ARG_SIGNED : NVLOG_ARG_UNSIGNED,
+                buf, sizeof(buf));
+    }
+    NvLogArgs &putString(const char *value, size_t size)
+    {
+        size_t avail = (size_t) (end - pos);
+        uint16_t len;
+        if (truncated || avail < 1 + sizeof(len) + 1)
+        {
+            truncated = true;
+            return *this;
+        }
+        /* Keep as much of a long string as fits. */
+        if (size > avail - 1 - sizeof(len))
+        {
+            size = avail - 1 - sizeof(len);
+            truncated = true;
+        }
+        len = size;
+        *pos++ = NVLOG_ARG_STRING;
+        memcpy(pos, &len, sizeof(len));
+        pos += sizeof(len);
+        memcpy(pos, value, size);
+        pos += size;
+        return *this;
+    }
+
+    char *start;
+    char *pos;
+    char *end;
+    bool truncated;
+};
+
+int NvLogGetComponentLevel(const char *comp);
+NvLogArgs *NvLogBegin(NvLogSite *site, int level);
+void NvLogCommit();
+
+static inline bool
+nvlog_level_enabled(int level, const char *comp)
+{
+    if (log_component_max_level < 0 || !comp)
+        return level <= log_level;
+    return level <= NvLogGetComponentLevel(comp);
+}
+
+/* strerror_r() returns an int (XSI) or a char pointer (GNU) depending on
+ * the feature test macros in effect. */
+static inline const char *
+nvlog_strerror_result(int ret, const char *buf)
+{
+    return ret ? "Unknown error" : buf;
+}
+
+static inline const char *
+nvlog_strerror_result(const char *ret, const char *buf)
+{
+    return ret;
+}
+
+/* errno is saved before anything else runs: the asynchronous backends may
+ * allocate or take locks in NvLogBegin() and clobber it. */
+#define PRINT_COMP_SYS_MSG(level, comp, str1) \
+                              { \
+                                  int nvlog_errno = errno; \
+                                  char nvlog_errbuf[128]; \
+                                  PRINT_COMP_MSG(level, comp, str1 << ": " << \
+                                      nvlog_strerror_result(strerror_r(nvlog_errno, \
+                                          nvlog_errbuf, sizeof(nvlog_errbuf)), \
+                                          nvlog_errbuf)) \
+                              }
 /**
  * @endcond
  */
 
+/**
+ * Selects the logging backend.
+ *
+ * Switching away from an asynchronous backend flushes all pending messages.
+ * Messages logged while the backend is switching are written synchronously.
+ * The backend can also be selected by setting the @c NVLOG_BACKEND
+ * environment variable to @c sync, @c async or @c binary, and the log file
+ * with @c NVLOG_FILE.
+ *
+ * @param[in] backend One of the @c LOG_BACKEND_* values.
+ * @param[in] file_path Path of the log file. Required for
+ *                      #LOG_BACKEND_BINARY; @c std::cerr is used for
+ *                      #LOG_BACKEND_ASYNC if NULL.
+ * @return 0 on success, -1 otherwise.
+ */
+int NvLogSetBackend(int backend, const char *file_path = NULL);
+
+/**
+ * Sets the log level of one component, overriding @c log_level for the
+ * messages logged with the @c COMP_* and @c CAT_* macros of that component.
+ *
+ * Levels can also be set with the @c NVLOG_LEVELS environment variable,
+ * e.g. @c NVLOG_LEVELS=dec0=3,EglRenderer=0.
+ *
+ * @param[in] comp Name of the component (@c comp_name or @c CAT_NAME).
+ * @param[in] level One of the @c LOG_LEVEL_* values, or -1 to remove the
+ *                  override.
+ */
+void NvLogSetComponentLevel(const char *comp, int level);
+
+/**
+ * Limits the number of messages each call site may log per second with
+ * the asynchronous backends. Suppressed messages are counted and reported
+ * with the next message of the call site.
+ *
+ * Can also be set with the @c NVLOG_RATE_LIMIT environment variable.
+ *
+ * @param[in] msgs_per_sec Maximum messages per second, 0 for no limit.
+ */
+void NvLogSetRateLimit(uint32_t msgs_per_sec);
+
+/**
+ * Waits until all messages recorded so far by the asynchronous backends
+ * have been written out.
+ */
+void NvLogFlush();
+
+/**
+ * Gets the number of messages dropped because a per-thread ring buffer
+ * was full.
+ *
+ * @return Number of dropped messages.
+ */
+uint64_t NvLogGetDroppedCount();
+
+/**
+ * Decodes a log file written by #LOG_BACKEND_BINARY into text.
+ *
+ * @param[in] file_path Path of the binary log file.
+ * @param[in] outstream Output stream to write the decoded messages to.
+ * @return 0 on success, -1 if the file cannot be read or is malformed.
+ */
+int NvLogDecodeBinary(const char *file_path, std::ostream &outstream);
+
+/**
+ *
+ * Prints component-specific log messages.
+ *
+ * Behaves like PRINT_MSG(), with the level of @a comp checked against the
+ * level set with NvLogSetComponentLevel() if any.
+ *
+ * @param[in] level The Log level of the message.
+ * @param[in] comp The name of the component, or NULL.
+ * @param[in] str1 The NULL-terminated char array to print.
+ */
+#define PRINT_COMP_MSG(level, comp, str1) \
+                              if((level <= log_level || level <= log_component_max_level) && \
+                                  nvlog_level_enabled(level, comp)) { \
+                                  if (__atomic_load_n(&log_backend, __ATOMIC_RELAXED) == \
+                                          LOG_BACKEND_SYNC) { \
+                                      std::ostringstream ostr; \
+                                      ostr << "[" << log_level_name[level] << "] ("  << \
+                                      __FILE__ << ":" __LINE_NUM_STR__ ") " << \
+                                      str1 << std::endl; \
+                                      std::cerr << ostr.str(); \
+                                  } else { \
+                                      static NvLogSite nvlog_site = \
+                                          { __FILE__, __LINE__, 0, 0, 0 }; \
+                                      NvLogArgs *nvlog_args = NvLogBegin(&nvlog_site, level); \
+                                      if (nvlog_args) { \
+                                          *nvlog_args << str1; \
+                                          NvLogCommit(); \
+                                      } \
+                                  } \
+                              }
+
 /**
  *
  * Prints log messages.
@@ -101,16 +452,14 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE: LINE_NUM) Message
  *
+ * With the asynchronous backends the arguments of the message are
+ * recorded into a per-thread ring buffer, then formatted and written out
+ * by a background thread.
+ *
  * @param[in] level The Log level of the message.
  * @param[in] str1 The NULL-terminated char array to print.
  */
-#define PRINT_MSG(level, str1) if(level <= log_level) { \
-                                  std::ostringstream ostr; \
-                                  ostr << "[" << log_level_name[level] << "] ("  << \
-                                  __FILE__ << ":" __LINE_NUM_STR__ ") " << \
-                                  str1 << std::endl; \
-                                  std::cerr << ostr.str(); \
-                              }
+#define PRINT_MSG(level, str1) PRINT_COMP_MSG(level, (const char *) NULL, str1)
 
 /**
  * Prints a log message of level LOG_LEVEL_INFO.
@@ -124,7 +473,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE: LINE_NUM) <comp_name> <message_content>
  */
-#define COMP_INFO_MSG(str) INFO_MSG("<" << comp_name << "> " << str)
+#define COMP_INFO_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_INFO, comp_name, "<" << comp_name << "> " << str)
 /**
  * Prints a category-specific (Component type) system error log
  * message of level LOG_LEVEL_INFO. This is used by the components
@@ -133,7 +482,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE: LINE_NUM) <cat_name> <message_content>
  */
-#define CAT_INFO_MSG(str) INFO_MSG("<" CAT_NAME "> " << str)
+#define CAT_INFO_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_INFO, CAT_NAME, "<" CAT_NAME "> " << str)
 
 /**
  * Prints a log message of level LOG_LEVEL_ERROR.
@@ -147,7 +496,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <comp_name> <message_content>
  */
-#define COMP_ERROR_MSG(str) ERROR_MSG("<" << comp_name << "> " << str)
+#define COMP_ERROR_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_ERROR, comp_name, "<" << comp_name << "> " << str)
 /**
  * Prints a category-specific (Component type) log message of level
  * LOG_LEVEL_ERROR. This is used by the components internally and
@@ -156,13 +505,13 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <cat_name> <message_content>
  */
-#define CAT_ERROR_MSG(str) ERROR_MSG("<" CAT_NAME "> " << str)
+#define CAT_ERROR_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_ERROR, CAT_NAME, "<" CAT_NAME "> " << str)
 
 /**
  * Prints a system error log message of level LOG_LEVEL_ERROR with
  * the string description of the errno value appended.
  */
-#define SYS_ERROR_MSG(str) ERROR_MSG(str << ": " << strerror(errno))
+#define SYS_ERROR_MSG(str) PRINT_COMP_SYS_MSG(LOG_LEVEL_ERROR, (const char *) NULL, str)
 /**
  * Prints a component-specific system error log message of level
  * LOG_LEVEL_ERROR. This is used by the components internally and
@@ -171,7 +520,8 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <comp_name> <message_content>
  */
-#define COMP_SYS_ERROR_MSG(str) SYS_ERROR_MSG("<" << comp_name << "> " << str)
+#define COMP_SYS_ERROR_MSG(str) PRINT_COMP_SYS_MSG(LOG_LEVEL_ERROR, comp_name, \
+        "<" << comp_name << "> " << str)
 /**
  * Prints a category-specific (Component type) system error log
  * message of level LOG_LEVEL_ERROR. This is used by the components
@@ -180,7 +530,8 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <cat_name> <message_content>
  */
-#define CAT_SYS_ERROR_MSG(str) SYS_ERROR_MSG("<" CAT_NAME "> " << str)
+#define CAT_SYS_ERROR_MSG(str) PRINT_COMP_SYS_MSG(LOG_LEVEL_ERROR, CAT_NAME, \
+        "<" CAT_NAME "> " << str)
 
 /**
  * Prints a log message of level LOG_LEVEL_WARN.
@@ -194,7 +545,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <comp_name> <message_content>
  */
-#define COMP_WARN_MSG(str) WARN_MSG("<" << comp_name << "> :" << str)
+#define COMP_WARN_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_WARN, comp_name, "<" << comp_name << "> :" << str)
 /**
  * Print a category-specific (Component type) log message of level
  * LOG_LEVEL_WARN.
@@ -204,7 +555,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <cat_name> <message_content>
  */
-#define CAT_WARN_MSG(str) WARN_MSG("<" CAT_NAME "> " << str)
+#define CAT_WARN_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_WARN, CAT_NAME, "<" CAT_NAME "> " << str)
 
 /**
  * Prints a log message of level LOG_LEVEL_DEBUG.
@@ -218,7 +569,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <comp_name> <message_content>
  */
-#define COMP_DEBUG_MSG(str) DEBUG_MSG("<" << comp_name << "> :" << str)
+#define COMP_DEBUG_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_DEBUG, comp_name, "<" << comp_name << "> :" << str)
 /**
  * Prints a category-specific (Component type) log message of level
  * LOG_LEVEL_DEBUG. This is used by the components internally and
@@ -227,7 +578,7 @@ extern const char *log_level_name[];
  * Messages are in the following form:
  * [LEVEL] (FILE:LINE_NUM) <cat_name> <message_content>
  */
-#define CAT_DEBUG_MSG(str) DEBUG_MSG("<" CAT_NAME "> " << str)
+#define CAT_DEBUG_MSG(str) PRINT_COMP_MSG(LOG_LEVEL_DEBUG, CAT_NAME, "<" CAT_NAME "> " << str)
 
 #endif
 /** @} */
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Motion Activity API</b>
+ *
+ * @b Description: This file declares the NvMotionActivity API.
+ */
+#ifndef __NV_MOTION_ACTIVITY_H__
+#define __NV_MOTION_ACTIVITY_H__
+
+#include <fstream>
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvmotionactivity_group Motion Activity API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/** Magic number of a frame in a binary motion vector file ("NVMV"). */
+#define NV_MV_FRAME_MAGIC 0x564d564e
+
+/**
+ * Header of one frame in a binary motion vector file. It is followed by
+ * @a num_mvs 32-bit motion vector words, packed as the encoder MVInfo:
+ * mv_x in bits 0-15, mv_y in bits 16-29 and weight in bits 30-31, with
+ * mv_x and mv_y signed.
+ */
+typedef struct
+{
+    /** NV_MV_FRAME_MAGIC. */
+    uint32_t magic;
+    /** Frame number. */
+    uint32_t frame_num;
+    /** Number of blocks in a row. */
+    uint16_t blocks_x;
+    /** Number of block rows. */
+    uint16_t blocks_y;
+    /** Number of motion vector words following the header. */
+    uint32_t num_mvs;
+} NvMotionVectorFrameHeader;
+
+/**
+ * Holds a motion start or end event.
+ */
+typedef struct
+{
+    /** Frame number at which the state changed. */
+    uint32_t frame_num;
+    /** Region index (row major), or -1 for the whole frame. */
+    int32_t region;
+    /** True if motion started, false if it ended. */
+    bool motion;
+    /** Fraction of moving blocks in the region for this frame. */
+    float moving_fraction;
+} NvMotionEvent;
+
+/**
+ * Holds the statistics of an NvMotionActivity.
+ */
+typedef struct
+{
+    /** Frames pushed. */
+    uint64_t frames_pushed;
+    /** Frames dropped because the ring was full. */
+    uint64_t frames_dropped;
+    /** Frames analyzed. */
+    uint64_t frames_analyzed;
+    /** Motion events raised. */
+    uint64_t events;
+    /** Time spent analyzing, in microseconds. */
+    uint64_t analyze_usec;
+} NvMotionActivityStats;
+
+/**
+ *
+ * Helper class for motion analytics on the encoder motion vectors.
+ *
+ * The encoder reports one motion vector per block (16x16 for H.264, 32x32
+ * for H.265). push() copies the motion vectors of a frame into a fixed ring
+ * of binary frames, so that the encoder capture plane is only held for a
+ * memcpy; a worker thread writes the frames to an optional binary file and
+ * aggregates them into per-row and per-region activity maps. A region is in
+ * motion once the fraction of its blocks with a motion vector magnitude
+ * (|mv_x| + |mv_y|) above the threshold stays at or above the on fraction
+ * for a number of frames, and it is idle again once the fraction stays
+ * below the off fraction for a number of frames. The frame is in motion
+ * while any of its regions is. State changes are reported through the event
+ * callback.
+ *
+ * analyzeFrame() can also be called directly, for example to replay a
+ * binary motion vector file without an encoder.
+ */
+class NvMotionActivity
+{
+public:
+    /**
+     * Callback called on the worker thread for each motion event.
+     *
+     * @param[in] event Motion event.
+     * @param[in] arg Argument passed to setEventCallback().
+     */
+    typedef void (*EventCallback)(const NvMotionEvent &event, void *arg);
+
+    /**
+     * Creates a motion activity analyzer.
+     *
+     * @param[in] blocks_x Number of blocks in a row.
+     * @param[in] blocks_y Number of block rows.
+     * @param[in] regions_x Number of region columns.
+     * @param[in] regions_y Number of region rows.
+     * @param[in] ring_frames Number of frames the ring holds.
+     */
+    NvMotionActivity(uint32_t blocks_x, uint32_t blocks_y, uint32_t regions_x = 4,
+                     uint32_t regions_y = 4, uint32_t ring_frames = 8);
+
+    /**
+     * Stops the worker thread and closes the binary file.
+     */
+    ~NvMotionActivity();
+
+    /**
+     * Sets the motion thresholds.
+     *
+     * @param[in] mv_threshold Minimum |mv_x| + |mv_y| of a moving block.
+     * @param[in] on_fraction Fraction of moving blocks that starts motion.
+     * @param[in] off_fraction Fraction of moving blocks below which motion ends.
+     * @param[in] on_frames Frames at or above @a on_fraction to start motion.
+     * @param[in] off_frames Frames below @a off_fraction to end motion.
+     */
+    void setThresholds(uint32_t mv_threshold, float on_fraction, float off_fraction,
+                       uint32_t on_frames, uint32_t off_frames);
+
+    /**
+     * Sets the event callback. The default callback prints the events.
+     *
+     * @param[in] callback Event callback, or NULL for no events.
+     * @param[in] arg Argument passed to the callback.
+     */
+    void setEventCallback(EventCallback callback, void *arg);
+
+    /**
+     * Opens a binary file the pushed frames are written to.
+     *
+     * @param[in] path Path of the file.
+     * @return 0 on success, -1 otherwise.
+     */
+    int openExport(const char *path);
+
+    /**
+     * Starts the worker thread.
+     *
+     * @return 0 on success, -1 otherwise.
+     */
+    int start();
+
+    /**
+     * Copies the motion vectors of a frame into the ring. Never blocks; the
+     * frame is dropped if the ring is full. Must be called from a single
+     * producer thread.
+     *
+     * @param[in] frame_num Frame number.
+     * @param[in] mvs Motion vector words (MVInfo array).
+     * @param[in] num_mvs Number of motion vectors.
+     * @return 0 on success, -1 if the frame was dropped.
+     */
+    int push(uint32_t frame_num, const void *mvs, uint32_t num_mvs);
+
+    /**
+     * Analyzes the pushed frames and stops the worker thread.
+     */
+    void stop();
+
+    /**
+     * Analyzes a frame on the calling thread. Must not be mixed with push().
+     *
+     * @param[in] frame_num Frame number.
+     * @param[in] mvs Motion vector words (MVInfo array).
+     * @param[in] num_mvs Number of motion vectors.
+     */
+    void analyzeFrame(uint32_t frame_num, const uint32_t *mvs, uint32_t num_mvs);
+
+    /**
+     * Gets the moving block count of each block row of the last analyzed
+     * frame.
+     */
+    const std::vector<uint32_t> &getRowActivity() const
+    {
+        return row_moving;
+    }
+
+    /**
+     * Gets the moving block count of each region (row major) of the last
+     * analyzed frame.
+     */
+    const std::vector<uint32_t> &getRegionActivity() const
+    {
+        return region_moving;
+    }
+
+    /**
+     * Gets the motion state of each region (row major).
+     */
+    const std::vector<bool> &getRegionMotion() const
+    {
+        return region_motion;
+    }
+
+    /**
+     * Gets the analyzer statistics.
+     *
+     * @param[out] stats Statistics of the analyzer.
+     */
+    void getStats(NvMotionActivityStats &stats);
+
+    /**
+     * Prints the analyzer statistics.
+     *
+     * @param[in] outstream Output stream to print to.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+    /**
+     * Counts the moving blocks of a span of motion vectors. The loop has no
+     * branches and is vectorized by the compiler.
+     *
+     * @param[in] mvs Motion vector words.
+     * @param[in] count Number of motion vectors.
+     * @param[in] mv_threshold Minimum |mv_x| + |mv_y| of a moving block.
+     * @param[out] magnitude_sum Sum of |mv_x| + |mv_y| of the span.
+     * @return Number of moving blocks.
+     */
+    static uint32_t countMoving(const uint32_t *mvs, uint32_t count,
+                                uint32_t mv_threshold, uint32_t *magnitude_sum);
+
+    /**
+     * Reads the next frame of a binary motion vector file.
+     *
+     * @param[in] stream Input stream.
+     * @param[out] header Frame header.
+     * @param[out] mvs Motion vector words.
+     * @return 0 on success, -1 at the end of the file or on a corrupt frame.
+     */
+    static int readFrame(std::istream &stream, NvMotionVectorFrameHeader &header,
+                         std::vector<uint32_t> &mvs);
+
+private:
+    typedef struct
+    {
+        uint32_t count;         /**< Consecutive frames towards a state change. */
+        bool motion;            /**< Current state. */
+    } Hysteresis;
+
+    typedef struct
+    {
+        NvMotionVectorFrameHeader header;
+        std::vector<uint32_t> mvs;
+    } Slot;
+
+    uint32_t blocks_x; /**< Number of blocks in a row. */
+    uint32_t blocks_y; /**< Number of block rows. */
+    uint32_t regions_x; /**< Number of region columns. */
+    uint32_t regions_y; /**< Number of region rows. */
+
+    uint32_t mv_threshold; /**< Minimum magnitude of a moving block. */
+    float on_fraction; /**< Fraction of moving blocks that starts motion. */
+    float off_fraction; /**< Fraction of moving blocks below which motion ends. */
+    uint32_t on_frames; /**< Frames to start motion. */
+    uint32_t off_frames; /**< Frames to end motion. */
+
+    EventCallback event_callback; /**< Event callback. */
+    void *event_arg; /**< Argument of the event callback. */
+    std::ofstream *export_file; /**< Binary motion vector file. */
+
+    std::vector<uint32_t> region_col_start; /**< First block column of each region column. */
+    std::vector<uint32_t> region_blocks; /**< Number of blocks of each region. */
+    std::vector<uint32_t> row_moving; /**< Moving blocks per block row. */
+    std::vector<uint32_t> region_moving; /**< Moving blocks per region. */
+    std::vector<bool> region_motion; /**< Motion state per region. */
+    std::vector<Hysteresis> region_state; /**< Hysteresis per region. */
+    bool frame_motion; /**< True while any region is in motion. */
+
+    std::vector<Slot> ring; /**< Ring of pushed frames. */
+    uint32_t ring_head; /**< Index of the oldest frame in the ring. */
+    uint32_t ring_count; /**< Number of frames in the ring. */
+    pthread_mutex_t lock; /**< Lock for the ring and the statistics. */
+    pthread_cond_t cond; /**< Signalled when a frame is pushed or on stop. */
+    pthread_t worker; /**< Worker thread. */
+    bool running; /**< True between start() and stop(). */
+    bool stopping; /**< Set to ask the worker to exit. */
+
+    NvMotionActivityStats stats; /**< Analyzer statistics. */
+
+    bool updateHysteresis(Hysteresis &state, float moving_fraction);
+    void raiseEvent(uint32_t frame_num, int32_t region, bool motion, float moving_fraction);
+
+    static void *workerThread(void *arg);
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvMotionActivity(const NvMotionActivity& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvMotionActivity const&);
+};
+
+/** @} */
+
+#endif
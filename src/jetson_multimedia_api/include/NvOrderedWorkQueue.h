@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Ordered Work Queue API</b>
+ *
+ * @b Description: This file declares the NvOrderedWorkQueue API.
+ */
+#ifndef __NV_ORDERED_WORK_QUEUE_H__
+#define __NV_ORDERED_WORK_QUEUE_H__
+
+#include <deque>
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvorderedworkqueue_group Ordered Work Queue API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/**
+ * Holds the statistics of an NvOrderedWorkQueue.
+ */
+typedef struct
+{
+    /** Number of jobs pushed. */
+    uint64_t num_jobs;
+    /** Maximum number of jobs in flight. */
+    uint32_t max_depth;
+    /** Average number of jobs in flight seen by push(). */
+    float avg_depth;
+    /** Number of push() calls that waited because the queue was full. */
+    uint64_t num_full_waits;
+    /** Total time push() waited because the queue was full, in microseconds. */
+    uint64_t full_wait_usec;
+} NvOrderedWorkQueueStats;
+
+/**
+ *
+ * Helper class for moving post-processing off a latency-critical thread
+ * while preserving order.
+ *
+ * Jobs are pushed by a producer, for example a V4L2 DQ callback that copies
+ * the dequeued data so that the buffer can be queued back at once. A pool of
+ * worker threads runs the process callback on several jobs in parallel, and
+ * the commit callback is then called for each job strictly in push order and
+ * never concurrently. Order-dependent work (file writes, running checksums,
+ * printing) belongs in the commit callback; independent work (formatting,
+ * analysis) belongs in the process callback.
+ *
+ * The queue is bounded: push() blocks while @a capacity jobs are in flight,
+ * which limits memory use if the workers fall behind.
+ */
+class NvOrderedWorkQueue
+{
+public:
+    /**
+     * Callback run on a job by any worker, possibly in parallel with other
+     * jobs.
+     *
+     * @param[in] job Job passed to push().
+     * @param[in] arg Argument passed to the constructor.
+     */
+    typedef void (*ProcessCallback)(void *job, void *arg);
+
+    /**
+     * Callback run on each job in push order, one job at a time. It owns the
+     * job afterwards and is responsible for freeing it.
+     *
+     * @param[in] job Job passed to push().
+     * @param[in] arg Argument passed to the constructor.
+     */
+    typedef void (*CommitCallback)(void *job, void *arg);
+
+    /**
+     * Creates an ordered work queue. The workers are started by start().
+     *
+     * @param[in] name Name of the queue, used for the worker thread names.
+     * @param[in] num_workers Number of worker threads.
+     * @param[in] capacity Maximum number of jobs in flight.
+     * @param[in] process Process callback, or NULL.
+     * @param[in] commit Commit callback.
+     * @param[in] arg Argument passed to the callbacks.
+     */
+    NvOrderedWorkQueue(const char *name, uint32_t num_workers, uint32_t capacity,
+                       ProcessCallback process, CommitCallback commit, void *arg);
+
+    /**
+     * Stops the queue, committing the pending jobs.
+     */
+    ~NvOrderedWorkQueue();
+
+    /**
+     * Starts the worker threads.
+     *
+     * @return 0 on success, -1 otherwise.
+     */
+    int start();
+
+    /**
+     * Pushes a job, waiting while the queue is full.
+     *
+     * @param[in] job Job to process and commit.
+     * @return 0 on success, -1 if the queue is not running.
+     */
+    int push(void *job);
+
+    /**
+     * Waits until all pushed jobs have been committed.
+     */
+    void waitIdle();
+
+    /**
+     * Commits the pending jobs and stops the worker threads.
+     */
+    void stop();
+
+    /**
+     * Gets the queue statistics.
+     *
+     * @param[out] stats Statistics of the queue.
+     */
+    void getStats(NvOrderedWorkQueueStats &stats);
+
+    /**
+     * Prints the queue statistics.
+     *
+     * @param[in] outstream Output stream to print to.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+private:
+    typedef struct
+    {
+        void *job;
+        bool done;
+    } Entry;
+
+    std::string name; /**< Name of the queue. */
+    uint32_t num_workers; /**< Number of worker threads. */
+    uint32_t capacity; /**< Maximum number of jobs in flight. */
+    ProcessCallback process; /**< Process callback. */
+    CommitCallback commit; /**< Commit callback. */
+    void *arg; /**< Argument passed to the callbacks. */
+
+    pthread_mutex_t lock; /**< Lock for the entries and statistics. */
+    pthread_cond_t work_cond; /**< Signalled when a job is pushed or on stop. */
+    pthread_cond_t space_cond; /**< Signalled when a job is committed. */
+    std::vector<pthread_t> workers; /**< Worker threads. */
+    std::deque<Entry> entries; /**< Jobs in flight, oldest first. */
+    uint64_t head_seq; /**< Sequence number of the oldest job in flight. */
+    uint64_t claim_seq; /**< Sequence number of the next job to process. */
+    bool committing; /**< True while a worker commits jobs. */
+    bool running; /**< True between start() and stop(). */
+    bool stopping; /**< Set to ask the workers to exit. */
+
+    NvOrderedWorkQueueStats stats; /**< Queue statistics. */
+    uint64_t depth_sum; /**< Sum of the depths seen by push(). */
+
+    static void *workerThread(void *arg);
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvOrderedWorkQueue(const NvOrderedWorkQueue& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvOrderedWorkQueue const&);
+};
+
+/** @} */
+
+#endif
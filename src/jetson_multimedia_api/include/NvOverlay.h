@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Overlay API</b>
+ *
+ * @b Description: This file declares the NvOverlay API.
+ */
+#ifndef __NV_OVERLAY_H__
+#define __NV_OVERLAY_H__
+
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct NvBufSurface;
+struct NvBufSurfaceParams;
+
+/**
+ * @defgroup l4t_mm_nvoverlay_group Overlay API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/**
+ * Holds a bitmap font: an 8-bit coverage atlas of fixed size cells, one
+ * character per cell in ASCII order, left to right and top to bottom.
+ */
+typedef struct NvOverlayFont
+{
+    /** Coverage of the atlas, one byte per pixel, without padding. */
+    const uint8_t *pixels;
+    /** Width of the atlas, in pixels. */
+    uint32_t width;
+    /** Height of the atlas, in pixels. */
+    uint32_t height;
+    /** Number of cells per row. */
+    uint32_t columns;
+    /** Number of rows of cells. */
+    uint32_t rows;
+    /** Character of the first cell. */
+    uint8_t first_char;
+} NvOverlayFont;
+
+/**
+ * Holds a color; all values are normalized in [0, 1].
+ */
+typedef struct
+{
+    float r;
+    float g;
+    float b;
+    float a;
+} NvOverlayColor;
+
+/**
+ * Holds one quad of an overlay, in pixels from the top left corner.
+ */
+typedef struct
+{
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    /** Atlas coordinates of the corners, normalized; u0 < 0 for a solid quad. */
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+    /** RGBA color, 8 bits per component. */
+    uint8_t color[4];
+} NvOverlayQuad;
+
+/**
+ * Holds one vertex of an overlay, drawn as triangles.
+ */
+typedef struct
+{
+    /** Position, in pixels from the top left corner. */
+    float x;
+    float y;
+    /** Atlas coordinates; u < 0 for a solid quad. */
+    float u;
+    float v;
+    /** RGBA color, 8 bits per component. */
+    uint8_t color[4];
+} NvOverlayVertex;
+
+/**
+ * Holds the statistics of an NvOverlay.
+ */
+typedef struct
+{
+    /** Number of frames built. */
+    uint64_t num_frames;
+    /** Number of strings added. */
+    uint64_t num_texts;
+    /** Number of boxes added. */
+    uint64_t num_boxes;
+    /** Number of quads built. */
+    uint64_t num_quads;
+    /** Number of strings whose layout was cached. */
+    uint64_t layout_hits;
+    /** Number of strings laid out. */
+    uint64_t layout_misses;
+    /** Number of layouts evicted from the cache. */
+    uint64_t layout_evictions;
+    /** Number of frames that differ from the previous one. */
+    uint64_t num_changes;
+} NvOverlayStats;
+
+/**
+ *
+ * Helper class batching the text and boxes drawn over a frame.
+ *
+ * Drawing statistics and detection labels string by string costs one
+ * draw call per character, or one call per string and per box. NvOverlay
+ * instead collects all the text and boxes of a frame, between begin() and
+ * end(), into one list of quads that is drawn at once: as a single vertex
+ * buffer and draw call by ArgusSamples::GLContext::renderOverlay(), or
+ * blended into an NV12 or RGBA buffer on the CPU by composite().
+ *
+ * The glyph quads of a string are laid out once per string and size, and
+ * reused while the string is drawn, so unchanged labels are only
+ * translated. Layouts unused in a frame are evicted when the cache is
+ * over its limit. end() also tells whether the frame differs from the
+ * previous one, so an unchanged overlay need not be uploaded again.
+ *
+ * An NvOverlay is used from one thread.
+ */
+class NvOverlay
+{
+public:
+    /**
+     * Creates an overlay.
+     *
+     * @param[in] font Font of the text; the atlas must outlive the overlay.
+     * @param[in] max_layouts Number of string layouts kept.
+     */
+    NvOverlay(const NvOverlayFont &font, uint32_t max_layouts = 256);
+
+    /**
+     * Starts a frame, dropping the quads of the previous one.
+     *
+     * @param[in] width Width of the frame, in pixels.
+     * @param[in] height Height of the frame, in pixels.
+     */
+    void begin(uint32_t width, uint32_t height);
+
+    /**
+     * Adds a string. Lines are separated by '\\n'; characters outside the
+     * font are left blank.
+     *
+     * @param[in] x Left edge of the text, in pixels.
+     * @param[in] y Top edge of the text, in pixels.
+     * @param[in] size Height of a line, in pixels.
+     * @param[in] text String to draw.
+     * @param[in] color Color of the text.
+     * @param[in] background Color of the box behind each line, or NULL.
+     */
+    void addText(float x, float y, float size, const char *text,
+                 const NvOverlayColor &color, const NvOverlayColor *background = NULL);
+
+    /**
+     * Adds a box.
+     *
+     * @param[in] left Left edge of the box, in pixels.
+     * @param[in] top Top edge of the box, in pixels.
+     * @param[in] width Width of the box, in pixels.
+     * @param[in] height Height of the box, in pixels.
+     * @param[in] border Width of the outline, in pixels; 0 fills the box.
+     * @param[in] color Color of the box.
+     */
+    void addBox(float left, float top, float width, float height, float border,
+                const NvOverlayColor &color);
+
+    /**
+     * Ends a frame.
+     *
+     * @return True if the quads differ from the previous frame.
+     */
+    bool end();
+
+    /**
+     * Gets the width of the frame.
+     */
+    uint32_t getWidth();
+
+    /**
+     * Gets the height of the frame.
+     */
+    uint32_t getHeight();
+
+    /**
+     * Gets the quads of the frame, in drawing order.
+     */
+    const std::vector<NvOverlayQuad> &getQuads();
+
+    /**
+     * Gets the vertices of the frame: six per quad, drawn as triangles.
+     */
+    const std::vector<NvOverlayVertex> &getVertices();
+
+    /**
+     * Gets a number that changes whenever a frame differs from the
+     * previous one.
+     */
+    uint64_t getGeneration();
+
+    /**
+     * Blends the quads of the frame into a mapped buffer, with the
+     * sampling and blending of the GL path.
+     *
+     * The buffer must be NVBUF_COLOR_FORMAT_NV12 or NVBUF_COLOR_FORMAT_RGBA
+     * and mapped at mappedAddr.addr. Coordinates are in pixels of the
+     * buffer; the quads are clipped to it. NV12 chroma is blended with the
+     * average coverage of the four pixels of each sample.
+     *
+     * @param[in] surface Batched surface holding the buffer.
+     * @param[in] index Index of the buffer in the batch.
+     * @return 0 for success, -1 otherwise.
+     */
+    int composite(NvBufSurface *surface, uint32_t index = 0);
+
+    /**
+     * Gets the statistics.
+     *
+     * @param[out] stats Statistics.
+     */
+    void getStats(NvOverlayStats *stats);
+
+    /**
+     * Prints the statistics.
+     *
+     * @param[in] outstream Output stream.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+private:
+    /** Layout of a string: unit color quads relative to its top left corner. */
+    struct Layout
+    {
+        std::vector<NvOverlayQuad> glyphs;
+        std::vector<NvOverlayQuad> lines;
+        uint64_t last_used;
+    };
+    typedef std::pair<std::string, float> LayoutKey;
+
+    NvOverlayFont font;
+    uint32_t max_layouts;
+    uint32_t width;
+    uint32_t height;
+    std::vector<NvOverlayQuad> quads;
+    std::vector<NvOverlayQuad> previous;
+    std::vector<NvOverlayVertex> vertices;
+    bool vertices_valid;
+    uint64_t generation;
+    std::map<LayoutKey, Layout> layouts;
+    std::vector<uint8_t> coverage;
+    std::vector<uint32_t> xmap;
+    NvOverlayStats stats;
+
+    const Layout &getLayout(const char *text, float size);
+    void addQuad(const NvOverlayQuad &quad, float x, float y, const uint8_t *color);
+    void compositeQuad(const NvOverlayQuad &quad, NvBufSurfaceParams &params);
+    void mapColumns(const NvOverlayQuad &quad, int32_t x0, int32_t x1);
+    void rasterize(const NvOverlayQuad &quad, int32_t x0, int32_t x1, int32_t y,
+                   uint8_t *out);
+};
+
+/** @} */
+#endif
@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Inference Preprocessing API</b>
+ *
+ * @b Description: This file declares the NvPreprocess API.
+ */
+#ifndef __NV_PREPROCESS_H__
+#define __NV_PREPROCESS_H__
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvpreprocess_group Inference Preprocessing API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+#ifdef __CUDACC__
+#define NV_PREPROCESS_FUNC __host__ __device__ static inline
+#else
+#define NV_PREPROCESS_FUNC static inline
+#endif
+
+/** Bits of the fractional part of the bilinear weights. */
+#define NV_PREPROCESS_WEIGHT_BITS 11
+/** Bilinear weight of a full sample. */
+#define NV_PREPROCESS_WEIGHT_ONE (1 << NV_PREPROCESS_WEIGHT_BITS)
+
+/**
+ * Specifies the pixel format of the source image.
+ */
+typedef enum
+{
+    /** 8-bit R, G, B, A. */
+    NV_PREPROCESS_FORMAT_RGBA,
+    /** 8-bit B, G, R, A. */
+    NV_PREPROCESS_FORMAT_BGRA,
+    /** 8-bit R, G, B. */
+    NV_PREPROCESS_FORMAT_RGB,
+    /** 8-bit B, G, R. */
+    NV_PREPROCESS_FORMAT_BGR,
+} NvPreprocessFormat;
+
+/**
+ * Specifies how the crop is fitted into the tensor.
+ */
+typedef enum
+{
+    /** Scaled to the whole tensor, the aspect ratio is not kept. */
+    NV_PREPROCESS_RESIZE_STRETCH,
+    /** Aspect ratio kept, padded at the right or bottom. */
+    NV_PREPROCESS_RESIZE_LETTERBOX,
+    /** Aspect ratio kept, padded evenly on both sides. */
+    NV_PREPROCESS_RESIZE_LETTERBOX_CENTER,
+} NvPreprocessResize;
+
+/**
+ * Specifies the scaling filter.
+ */
+typedef enum
+{
+    NV_PREPROCESS_FILTER_NEAREST,
+    NV_PREPROCESS_FILTER_BILINEAR,
+} NvPreprocessFilter;
+
+/**
+ * Specifies the layout of the tensor.
+ */
+typedef enum
+{
+    /** Planar, one plane per channel. */
+    NV_PREPROCESS_LAYOUT_NCHW,
+    /** Interleaved channels. */
+    NV_PREPROCESS_LAYOUT_NHWC,
+} NvPreprocessLayout;
+
+/**
+ * Specifies the element type of the tensor.
+ */
+typedef enum
+{
+    NV_PREPROCESS_TYPE_FP32,
+    /** IEEE half precision, rounded to nearest even. */
+    NV_PREPROCESS_TYPE_FP16,
+    /** Rounded to nearest even and saturated to [-128, 127]. */
+    NV_PREPROCESS_TYPE_INT8,
+} NvPreprocessDataType;
+
+/**
+ * Holds the parameters of one preprocessing pass.
+ *
+ * Each tensor element is <tt>(v - mean[c]) * scale[c]</tt>, where @a v is
+ * the scaled 8-bit sample, or @a pad[c] outside the letterboxed image.
+ * @a mean, @a scale and @a pad are given in tensor channel order.
+ */
+typedef struct
+{
+    /** Width of the source image. */
+    uint32_t src_width;
+    /** Height of the source image. */
+    uint32_t src_height;
+    /** Bytes between the starts of two rows of the source image. */
+    uint32_t src_pitch;
+    /** Pixel format of the source image. */
+    NvPreprocessFormat src_format;
+    /** Crop of the source image; a zero width or height selects the whole image. */
+    uint32_t crop_left;
+    uint32_t crop_top;
+    uint32_t crop_width;
+    uint32_t crop_height;
+    /** Width of the tensor. */
+    uint32_t dst_width;
+    /** Height of the tensor. */
+    uint32_t dst_height;
+    /** Fitting of the crop into the tensor. */
+    NvPreprocessResize resize;
+    /** Scaling filter. */
+    NvPreprocessFilter filter;
+    /** True for B, G, R tensor channels, false for R, G, B. */
+    bool dst_bgr;
+    /** Layout of the tensor. */
+    NvPreprocessLayout layout;
+    /** Element type of the tensor. */
+    NvPreprocessDataType data_type;
+    /** Subtracted from the 8-bit samples. */
+    float mean[3];
+    /** Multiplied with the samples after subtracting @a mean. */
+    float scale[3];
+    /** 8-bit sample of the letterbox padding. */
+    uint8_t pad[3];
+} NvPreprocessParams;
+
+/**
+ * Holds the placement of the scaled crop in the tensor, and the crop
+ * resolved from the parameters.
+ */
+typedef struct
+{
+    uint32_t left;
+    uint32_t top;
+    uint32_t width;
+    uint32_t height;
+    uint32_t crop_left;
+    uint32_t crop_top;
+    uint32_t crop_width;
+    uint32_t crop_height;
+} NvPreprocessGeometry;
+
+/*
+ * The helpers below define the arithmetic of the preprocessing. The CUDA
+ * kernel and the CPU implementation both use them, so that their outputs
+ * are bit-exact: coordinates and bilinear weights are computed in integer,
+ * the bilinear filter is applied vertically then horizontally with
+ * rounding after each pass, and normalization is one subtraction and one
+ * multiplication in FP32.
+ */
+
+/** Bytes per pixel of a source format. */
+NV_PREPROCESS_FUNC uint32_t
+NvPreprocessBytesPerPixel(NvPreprocessFormat format)
+{
+    return (format == NV_PREPROCESS_FORMAT_RGBA || format == NV_PREPROCESS_FORMAT_BGRA) ? 4 : 3;
+}
+
+/** Source byte of tensor channel @a c. */
+NV_PREPROCESS_FUNC uint32_t
+NvPreprocessSourceChannel(NvPreprocessFormat format, bool dst_bgr, uint32_t c)
+{
+    bool src_bgr = (format == NV_PREPROCESS_FORMAT_BGRA || format == NV_PREPROCESS_FORMAT_BGR);
+
+    return (src_bgr == dst_bgr) ? c : 2 - c;
+}
+
+/** Bytes per element of a tensor type. */
+NV_PREPROCESS_FUNC uint32_t
+NvPreprocessElementSize(NvPreprocessDataType type)
+{
+    return type == NV_PREPROCESS_TYPE_FP32 ? 4 : (type == NV_PREPROCESS_TYPE_FP16 ? 2 : 1);
+}
+
+/**
+ * Validates the parameters and places the scaled crop in the tensor.
+ *
+ * @return 0 on success, -1 if the parameters are invalid.
+ */
+NV_PREPROCESS_FUNC int
+NvPreprocessGetGeometry(const NvPreprocessParams *params, NvPreprocessGeometry *geometry)
+{
+    uint64_t crop_w;
+    uint64_t crop_h;
+    uint64_t dst_w = params->dst_width;
+    uint64_t dst_h = params->dst_height;
+
+    if (params->src_width == 0 || params->src_height == 0 || dst_w == 0 || dst_h == 0 ||
+        params->src_pitch < params->src_width * NvPreprocessBytesPerPixel(params->src_format))
+        return -1;
+
+    geometry->crop_left = params->crop_left;
+    geometry->crop_top = params->crop_top;
+    geometry->crop_width = params->crop_width;
+    geometry->crop_height = params->crop_height;
+    if (params->crop_width == 0 || params->crop_height == 0)
+    {
+        geometry->crop_left = 0;
+        geometry->crop_top = 0;
+        geometry->crop_width = params->src_width;
+        geometry->crop_height = params->src_height;
+    }
+    if ((uint64_t) geometry->crop_left + geometry->crop_width > params->src_width ||
+        (uint64_t) geometry->crop_top + geometry->crop_height > params->src_height)
+        return -1;
+
+    crop_w = geometry->crop_width;
+    crop_h = geometry->crop_height;
+    geometry->left = 0;
+    geometry->top = 0;
+    geometry->width = (uint32_t) dst_w;
+    geometry->height = (uint32_t) dst_h;
+    if (params->resize == NV_PREPROCESS_RESIZE_STRETCH)
+        return 0;
+
+    if (crop_w * dst_h >= crop_h * dst_w)
+        geometry->height = (uint32_t) ((crop_h * dst_w + crop_w / 2) / crop_w);
+    else
+        geometry->width = (uint32_t) ((crop_w * dst_h + crop_h / 2) / crop_h);
+    if (geometry->width == 0)
+        geometry->width = 1;
+    if (geometry->height == 0)
+        geometry->height = 1;
+    if (params->resize == NV_PREPROCESS_RESIZE_LETTERBOX_CENTER)
+    {
+        geometry->left = (uint32_t) (dst_w - geometry->width) / 2;
+        geometry->top = (uint32_t) (dst_h - geometry->height) / 2;
+    }
+    return 0;
+}
+
+/**
+ * Maps a tensor coordinate to the nearest source coordinate, pixel centers
+ * aligned, relative to the crop.
+ */
+NV_PREPROCESS_FUNC uint32_t
+NvPreprocessMapNearest(uint32_t d, uint32_t dst_size, uint32_t src_size)
+{
+    return (uint32_t) (((2 * (uint64_t) d + 1) * src_size) / (2 * (uint64_t) dst_size));
+}
+
+/**
+ * Maps a tensor coordinate to the two source coordinates of the bilinear
+ * filter, relative to the crop, and the weight of the second one. Samples
+ * outside the crop are clamped to its edge.
+ */
+NV_PREPROCESS_FUNC void
+NvPreprocessMapLinear(uint32_t d, uint32_t dst_size, uint32_t src_size,
+                      uint32_t *i0, uint32_t *i1, uint32_t *weight)
+{
+    int64_t pos = (int64_t) (((2 * (uint64_t) d + 1) * src_size << NV_PREPROCESS_WEIGHT_BITS) /
+                             (2 * (uint64_t) dst_size)) - NV_PREPROCESS_WEIGHT_ONE / 2;
+    uint32_t index;
+
+    if (pos < 0)
+        pos = 0;
+    index = (uint32_t) (pos >> NV_PREPROCESS_WEIGHT_BITS);
+    if (index >= src_size - 1)
+    {
+        *i0 = src_size - 1;
+        *i1 = src_size - 1;
+        *weight = 0;
+        return;
+    }
+    *i0 = index;
+    *i1 = index + 1;
+    *weight = (uint32_t) (pos & (NV_PREPROCESS_WEIGHT_ONE - 1));
+}
+
+/**
+ * Vertical bilinear pass: blends two 8-bit samples into a 15-bit value.
+ */
+NV_PREPROCESS_FUNC uint32_t
+NvPreprocessLerpRows(uint32_t a, uint32_t b, uint32_t weight)
+{
+    return (a * (NV_PREPROCESS_WEIGHT_ONE - weight) + b * weight + 8) >> 4;
+}
+
+/**
+ * Horizontal bilinear pass: blends two values of the vertical pass into an
+ * 8-bit sample.
+ */
+NV_PREPROCESS_FUNC uint32_t
+NvPreprocessLerpColumns(uint32_t a, uint32_t b, uint32_t weight)
+{
+    return (a * (NV_PREPROCESS_WEIGHT_ONE - weight) + b * weight + (1 << 17)) >> 18;
+}
+
+/** Normalizes an 8-bit sample. */
+NV_PREPROCESS_FUNC float
+NvPreprocessNormalize(uint32_t v, float mean, float scale)
+{
+    return ((float) v - mean) * scale;
+}
+
+/** Converts to IEEE half precision, rounding to nearest even. */
+NV_PREPROCESS_FUNC uint16_t
+NvPreprocessFloatToHalf(float value)
+{
+    uint32_t bits;
+    uint32_t sign;
+    uint32_t mantissa;
+    int32_t exponent;
+    uint32_t half;
+
+    memcpy(&bits, &value, sizeof(bits));
+    sign = (bits >> 16) & 0x8000;
+    exponent = (int32_t) ((bits >> 23) & 0xff) - 127 + 15;
+    mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff)
+        return (uint16_t) (sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31)
+        return (uint16_t) (sign | 0x7c00);
+    if (exponent <= 0)
+    {
+        uint32_t shift;
+
+        if (exponent < -10)
+            return (uint16_t) sign;
+        mantissa |= 0x800000;
+        shift = (uint32_t) (14 - exponent);
+        half = mantissa >> shift;
+        if ((mantissa & ((1u << shift) - 1)) > (1u << (shift - 1)) ||
+            ((mantissa & ((1u << shift) - 1)) == (1u << (shift - 1)) && (half & 1)))
+            half++;
+        return (uint16_t) (sign | half);
+    }
+    half = ((uint32_t) exponent << 10) | (mantissa >> 13);
+    if ((mantissa & 0x1fff) > 0x1000 || ((mantissa & 0x1fff) == 0x1000 && (half & 1)))
+        half++;
+    return (uint16_t) (sign | half);
+}
+
+/** Quantizes to INT8, rounding to nearest even and saturating. */
+NV_PREPROCESS_FUNC int8_t
+NvPreprocessFloatToInt8(float value)
+{
+    float rounded = rintf(value);
+
+    if (rounded < -128.0f)
+        return -128;
+    if (rounded > 127.0f)
+        return 127;
+    return (int8_t) rounded;
+}
+
+/**
+ *
+ * Fused inference preprocessing on the CPU.
+ *
+ * Crops, scales, letterboxes, normalizes and converts an 8-bit RGB image
+ * into an NCHW or NHWC tensor of FP32, FP16 or INT8 in a single pass over
+ * the tensor. The output is bit-exact with preprocessImage() of the CUDA
+ * algorithms, so it serves as their reference and as the fallback on
+ * systems without a GPU.
+ *
+ * The tensor rows are split into bands processed in parallel by the
+ * calling thread and @a num_threads - 1 worker threads, with the role
+ * "preprocess" of NvThreadPolicy. The bilinear passes use SSE2 on x86-64
+ * and NEON on AArch64. Normalization and conversion are table lookups,
+ * since an 8-bit sample has only 256 values per channel.
+ *
+ * One instance processes one image at a time; use one instance per
+ * thread submitting images.
+ */
+class NvPreprocessCpu
+{
+public:
+    /**
+     * Creates the worker threads.
+     *
+     * @param[in] num_threads Number of threads processing an image,
+     *                        including the caller; 0 selects the number of
+     *                        online CPUs.
+     */
+    NvPreprocessCpu(uint32_t num_threads = 0);
+
+    /**
+     * Stops the worker threads.
+     */
+    ~NvPreprocessCpu();
+
+    /**
+     * Preprocesses one image.
+     *
+     * @param[in] params Parameters of the pass.
+     * @param[in] src Source image.
+     * @param[out] dst Tensor of dst_width * dst_height * 3 elements.
+     * @return 0 on success, -1 if the parameters are invalid.
+     */
+    int process(const NvPreprocessParams *params, const uint8_t *src, void *dst);
+
+    /**
+     * Enables or disables the SIMD paths, to compare them with the
+     * scalar code.
+     */
+    void setSimd(bool enable);
+
+    /**
+     * Gets the number of threads processing an image, including the caller.
+     */
+    uint32_t getNumThreads();
+
+private:
+    /** Scratch rows of one band. */
+    typedef struct
+    {
+        std::vector<uint16_t> rows; /**< Output of the vertical pass. */
+        std::vector<uint8_t> samples; /**< Tensor row of 8-bit samples. */
+    } Scratch;
+
+    uint32_t num_threads;
+    bool simd;
+    std::vector<pthread_t> workers;
+    std::vector<Scratch> scratch;
+
+    pthread_mutex_t lock; /**< Lock for the job state. */
+    pthread_cond_t cond; /**< Signalled when a job is posted or finished. */
+    uint64_t generation; /**< Incremented for every posted job. */
+    uint32_t pending; /**< Bands of the current job not finished. */
+    bool stop; /**< Set to ask the workers to exit. */
+
+    /* State of the current job, read by the workers */
+    const NvPreprocessParams *params;
+    NvPreprocessGeometry geometry;
+    const uint8_t *src;
+    void *dst;
+    std::vector<uint32_t> x0; /**< First source column of each tensor column. */
+    std::vector<uint32_t> x1; /**< Second source column of each tensor column. */
+    std::vector<uint32_t> wx; /**< Weight of the second column. */
+    float lut_fp32[3][256];
+    uint16_t lut_fp16[3][256];
+    int8_t lut_int8[3][256];
+
+    void prepare();
+    void processBand(uint32_t band);
+    void scaleRow(uint32_t y, Scratch &s);
+    template <typename T>
+    void storeRow(uint32_t y, const uint8_t *samples, const T lut[3][256]);
+    static void *workerThread(void *arg);
+
+    typedef struct
+    {
+        NvPreprocessCpu *owner;
+        uint32_t band;
+    } WorkerArg;
+    std::vector<WorkerArg> worker_args;
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvPreprocessCpu(const NvPreprocessCpu& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvPreprocessCpu const&);
+};
+
+/** @} */
+
+#endif
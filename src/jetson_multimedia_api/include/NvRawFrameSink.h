@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Raw Frame Sink API</b>
+ *
+ * @b Description: This file declares the NvRawFrameSink API.
+ */
+#ifndef __NV_RAW_FRAME_SINK_H__
+#define __NV_RAW_FRAME_SINK_H__
+
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <vector>
+
+/**
+ * @defgroup l4t_mm_nvrawframesink_group Raw Frame Sink API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+
+/** Maximum number of planes written per frame. */
+#define NV_RAW_FRAME_SINK_MAX_PLANES 4
+
+/**
+ * Holds the CPU mapping of a buffer.
+ */
+typedef struct
+{
+    /** Number of planes. */
+    uint32_t num_planes;
+    /** Start of each plane. */
+    uint8_t *planes[NV_RAW_FRAME_SINK_MAX_PLANES];
+    /** Visible bytes per row of each plane. */
+    uint32_t row_bytes[NV_RAW_FRAME_SINK_MAX_PLANES];
+    /** Number of rows of each plane. */
+    uint32_t height[NV_RAW_FRAME_SINK_MAX_PLANES];
+    /** Bytes between the starts of two rows of each plane. */
+    uint32_t pitch[NV_RAW_FRAME_SINK_MAX_PLANES];
+    /** Handle of the mapping, passed back to sync and unmap. */
+    void *handle;
+} NvRawFrameMapping;
+
+/**
+ * Holds the mapping calls used by an NvRawFrameSink.
+ */
+typedef struct
+{
+    /**
+     * Maps all the planes of a buffer for CPU reads.
+     *
+     * @param[in] fd FD of the buffer.
+     * @param[out] mapping Mapping of the buffer.
+     * @param[in] arg Argument of the calls.
+     * @return 0 for success, -1 otherwise.
+     */
+    int (*map)(int fd, NvRawFrameMapping *mapping, void *arg);
+    /**
+     * Makes the current content of a mapped buffer visible to the CPU,
+     * as NvBufSurfaceSyncForCpu().
+     *
+     * @return 0 for success, -1 otherwise.
+     */
+    int (*sync)(NvRawFrameMapping *mapping, void *arg);
+    /**
+     * Unmaps a buffer mapped by map.
+     */
+    void (*unmap)(NvRawFrameMapping *mapping, void *arg);
+    /** Argument of the calls. */
+    void *arg;
+} NvRawFrameSinkOps;
+
+/**
+ * Holds the statistics of an NvRawFrameSink.
+ */
+typedef struct
+{
+    /** Number of frames written. */
+    uint64_t num_frames;
+    /** Number of bytes written. */
+    uint64_t num_bytes;
+    /** Number of buffers mapped. */
+    uint64_t num_maps;
+    /** Number of write system calls. */
+    uint64_t num_writes;
+    /** Total time spent in writeFrame(), in microseconds. */
+    uint64_t write_usec;
+} NvRawFrameSinkStats;
+
+/**
+ *
+ * Helper class writing the visible region of decoded frames to a raw
+ * file.
+ *
+ * Mapping a buffer, syncing it and writing it row by row through a stream
+ * costs several calls per plane and one copy per row. NvRawFrameSink maps
+ * each buffer the first time it is written and keeps the mapping until
+ * forget() or close(), so a frame only costs a cache sync. All rows of all
+ * planes are then gathered into one vectored write, with contiguous rows
+ * merged into a single entry.
+ *
+ * With direct I/O, the rows are instead packed into an aligned staging
+ * buffer that is written with O_DIRECT in large blocks, bypassing the page
+ * cache. The final partial block is written without O_DIRECT on close().
+ * If the file system does not support O_DIRECT, buffered writes are used.
+ *
+ * The mapping calls are passed in: hardwareOps() uses NvBufSurfaceMap(),
+ * other implementations can map system memory to measure the write path
+ * without the hardware. A buffer that is destroyed must be removed with
+ * forget() first, as its FD may be reused. An NvRawFrameSink is used from
+ * one thread.
+ */
+class NvRawFrameSink
+{
+public:
+    /**
+     * Creates a sink.
+     *
+     * @param[in] ops Mapping calls.
+     */
+    NvRawFrameSink(const NvRawFrameSinkOps &ops);
+
+    /**
+     * Closes the sink if it is open.
+     */
+    ~NvRawFrameSink();
+
+    /**
+     * Creates or truncates the output file.
+     *
+     * @param[in] path Path of the output file.
+     * @param[in] direct True to write with O_DIRECT.
+     * @return 0 for success, -1 otherwise.
+     */
+    int open(const char *path, bool direct = false);
+
+    /**
+     * Writes the pending data, unmaps all buffers and closes the file.
+     *
+     * @return 0 for success, -1 otherwise.
+     */
+    int close();
+
+    /**
+     * Writes the visible region of all planes of a buffer.
+     *
+     * @param[in] fd FD of the buffer.
+     * @return 0 for success, -1 otherwise.
+     */
+    int writeFrame(int fd);
+
+    /**
+     * Unmaps a buffer, for example before it is destroyed.
+     *
+     * @param[in] fd FD of the buffer.
+     */
+    void forget(int fd);
+
+    /**
+     * Unmaps all buffers.
+     */
+    void clearCache();
+
+    /**
+     * Checks whether direct I/O is in use.
+     */
+    bool isDirect();
+
+    /**
+     * Gets the statistics.
+     *
+     * @param[out] stats Statistics.
+     */
+    void getStats(NvRawFrameSinkStats *stats);
+
+    /**
+     * Prints the statistics.
+     *
+     * @param[in] outstream Output stream.
+     */
+    void printStats(std::ostream &outstream = std::cout);
+
+    /**
+     * Gets the mapping calls using NvBufSurfaceMap() and
+     * NvBufSurfaceSyncForCpu().
+     */
+    static NvRawFrameSinkOps hardwareOps();
+
+private:
+    /** Alignment of the staging buffer, offsets and sizes for O_DIRECT. */
+    static const size_t DirectAlignment = 4096;
+    /** Size of the staging buffer for O_DIRECT. */
+    static const size_t DirectChunkSize = 4 << 20;
+
+    NvRawFrameSinkOps ops;
+    int fd;                 /**< Output file, or -1. */
+    bool direct;            /**< True while the file is opened with O_DIRECT. */
+
+    std::map<int, NvRawFrameMapping> mappings;  /**< Mapped buffers, by FD. */
+
+    /* Scratch space of writeFrame(), kept to avoid allocations per frame */
+    std::vector<struct iovec> iov;
+
+    uint8_t *staging;       /**< Aligned staging buffer for O_DIRECT. */
+    size_t staging_used;    /**< Bytes held in the staging buffer. */
+
+    NvRawFrameSinkStats stats;
+
+    NvRawFrameMapping *lookup(int buffer_fd);
+    int writeVectored();
+    int writeDirect();
+    int flushStaging();
+    int disableDirect();
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvRawFrameSink(const NvRawFrameSink& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvRawFrameSink const&);
+};
+
+/** @} */
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * <b>NVIDIA Multimedia API: Thread Placement and Scheduling Policy API</b>
+ *
+ * @b Description: This file declares the NvThreadPolicy API.
+ */
+#ifndef __NV_THREAD_POLICY_H__
+#define __NV_THREAD_POLICY_H__
+
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ *
+ * Helper class for placing threads on CPU cores and setting their
+ * scheduling policy by role.
+ *
+ * Threads created by the samples and by the framework classes (V4L2 plane DQ
+ * threads, renderer threads, TensorRT threads, poll threads, Argus sample
+ * threads) call applyToCurrentThread() with their role name when they start.
+ * If a policy is configured for that role, the thread is pinned to the
+ * configured CPU set and its scheduling class, real-time priority and nice
+ * value are set. Threads whose role has no policy are left unchanged.
+ *
+ * Policies are configured with a specification string of the form
+ * @code
+ * role:key=value,key=value;role:key=value,...
+ * @endcode
+ * where the keys are:
+ * - @c cpus: CPU list, e.g. @c 2-3,5
+ * - @c policy: @c other, @c fifo or @c rr
+ * - @c priority: real-time priority for @c fifo and @c rr
+ * - @c nice: nice value for @c other
+ *
+ * The role @c * matches any role without its own policy.
+ *
+ * The specification is read from the @c NV_THREAD_POLICY environment variable
+ * and, one role per line, from the file named by @c NV_THREAD_POLICY_FILE.
+ * Setting @c NV_THREAD_POLICY_MLOCK to 1 locks the process memory.
+ *
+ * Only one instance of NvThreadPolicy object gets created for the application.
+ * It can be accessed using getInstance().
+ *
+ * @defgroup l4t_mm_nvthreadpolicy_group  Thread Policy API
+ * @ingroup aa_framework_api_group
+ * @{
+ */
+class NvThreadPolicy
+{
+public:
+    /**
+     * Holds the policy of one role.
+     */
+    typedef struct
+    {
+        /** Name of the role, or "*" for the default policy. */
+        std::string role;
+        /** True if @a cpus is set. */
+        bool has_cpus;
+        /** CPU set to which threads of the role are pinned. */
+        cpu_set_t cpus;
+        /** Scheduling policy (SCHED_OTHER, SCHED_FIFO or SCHED_RR), -1 if unset. */
+        int sched_policy;
+        /** Real-time priority for SCHED_FIFO and SCHED_RR. */
+        int priority;
+        /** True if @a nice is set. */
+        bool has_nice;
+        /** Nice value for SCHED_OTHER. */
+        int nice;
+    } NvThreadRolePolicy;
+
+    /**
+     * Holds what was applied to one thread.
+     */
+    typedef struct
+    {
+        /** Kernel thread ID. */
+        pid_t tid;
+        /** Role requested by the thread. */
+        std::string role;
+        /** Role whose policy was applied. */
+        std::string policy_role;
+        /** CPU set the thread runs on after the policy was applied. */
+        cpu_set_t cpus;
+        /** Scheduling policy after the policy was applied. */
+        int sched_policy;
+        /** Real-time priority after the policy was applied. */
+        int priority;
+        /** Nice value after the policy was applied. */
+        int nice;
+        /** 0 if the whole policy was applied, otherwise the first errno. */
+        int error;
+    } NvThreadPolicyResult;
+
+    /**
+     * Gets a reference to the global #NvThreadPolicy instance.
+     *
+     * @return A reference to the global NvThreadPolicy instance.
+     */
+    static NvThreadPolicy& getInstance();
+
+    /**
+     * Adds role policies from a specification string. Policies of roles
+     * already configured are replaced.
+     *
+     * @param[in] spec Specification string.
+     * @return 0 on success, -1 if the specification is malformed.
+     */
+    int loadConfig(const char *spec);
+
+    /**
+     * Adds role policies from a file holding one role specification per
+     * line. Empty lines and lines starting with '#' are ignored.
+     *
+     * @param[in] path Path of the configuration file.
+     * @return 0 on success, -1 if the file cannot be read or is malformed.
+     */
+    int loadConfigFile(const char *path);
+
+    /**
+     * Removes all role policies.
+     */
+    void clear();
+
+    /**
+     * Checks whether any role policy is configured.
+     *
+     * @return True if at least one role policy is configured.
+     */
+    bool isConfigured();
+
+    /**
+     * Locks all current and future pages of the process in memory.
+     *
+     * @return 0 on success, -1 otherwise.
+     */
+    int lockMemory();
+
+    /**
+     * Gets the policy that applies to a role.
+     *
+     * @param[in] role Name of the role.
+     * @param[out] policy Policy of the role, or of "*" if the role has none.
+     * @return True if a policy applies to the role.
+     */
+    bool getRolePolicy(const char *role, NvThreadRolePolicy &policy);
+
+    /**
+     * Applies the policy of a role to the calling thread.
+     *
+     * Does nothing if no policy applies to the role. Failures (for example
+     * missing permissions for SCHED_FIFO) are reported and recorded, and the
+     * remaining settings are still applied.
+     *
+     * @param[in] role Name of the role of the calling thread.
+     * @return 0 on success or if no policy applies, -1 if any setting failed.
+     */
+    int applyToCurrentThread(const char *role);
+
+    /**
+     * Gets what was applied to each thread so far.
+     *
+     * Only the last application of each thread is kept, and at most
+     * the latest 256 threads are tracked.
+     *
+     * @param[out] results Vector to be filled with the results.
+     */
+    void getResults(std::vector<NvThreadPolicyResult> &results);
+
+    /**
+     * Prints the configured policies and what was applied to each thread.
+     *
+     * @param[in] outstream Output stream to print to.
+     */
+    void printPolicy(std::ostream &outstream = std::cout);
+
+private:
+    pthread_mutex_t lock; /**< Lock for the policies and results. */
+    std::vector<NvThreadRolePolicy> policies; /**< Configured role policies. */
+    std::vector<NvThreadPolicyResult> results; /**< Applied policies. */
+    bool memory_locked; /**< True if lockMemory() succeeded. */
+
+    /**
+     * Parses one role specification.
+     */
+    int parseRole(const std::string &spec, NvThreadRolePolicy &policy);
+
+    /**
+     * Default constructor used by getInstance. Reads the environment.
+     */
+    NvThreadPolicy();
+
+    /**
+     * Disallows copy constructor.
+     */
+    NvThreadPolicy(const NvThreadPolicy& that);
+    /**
+     * Disallows assignment.
+     */
+    void operator=(NvThreadPolicy const&);
+};
+
+/** @} */
+
+#endif
@@ -34,8 +34,11 @@
 #include <semaphore.h>
 
 #include "NvBufSurface.h"
+#include "NvFrameChecksum.h"
+#include "NvDecoderCapturePool.h"
 
 #define MAX_BUFFERS 32
+#define CHECKSUM_BUFFERS 4
 
 typedef struct
 {
@@ -76,6 +79,12 @@ typedef struct
     uint64_t timestampincr;
 
     bool stats;
+    char *stats_file_path;
+
+    char *checksum_file_path;
+    char *golden_checksum_path;
+    NvFrameChecksum *checksum;
+    int checksum_dma_fd[CHECKSUM_BUFFERS];
 
     int  stress_test;
     bool enable_metadata;
@@ -102,6 +111,10 @@ typedef struct
     int dst_dma_fd;
     int dmabuff_fd[MAX_BUFFERS];
     int numCapBuffers;
+    NvDecoderCapturePool *capture_pool; // Keeps the capture buffers across resolution changes
+    uint32_t max_cap_width;
+    uint32_t max_cap_height;
+    bool capture_padded; // Capture buffers larger than the stream
     int loop_count;
     int max_perf;
     int extra_cap_plane_buffer;
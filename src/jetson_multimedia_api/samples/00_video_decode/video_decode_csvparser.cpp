@@ -64,6 +64,9 @@ print_help(void)
             "\t--dbg-level <level>  Sets the debug level [Values 0-3]\n\n"
             "\t--stats              Report profiling data for the app\n\n"
             "\tNOTE: this should not be used alongside -o option as it decreases the FPS value shown in --stats\n"
+            "\t--stats-file <file>  Export the profiling time series with --stats (JSON if <file> ends in .json, CSV otherwise)\n\n"
+            "\t--frame-checksum <file>  Write one CRC32C per plane of each decoded frame to <file> instead of raw YUV\n"
+            "\t--golden-checksum <file> Compare each decoded frame against the checksums in <file>\n\n"
             "\t--disable-rendering  Disable rendering\n"
             "\t--max-perf           Enable maximum Performance \n"
             "\tNOTE: this should be set only for platform T194 or above\n"
@@ -96,6 +99,8 @@ print_help(void)
             "\t-v4l2-memory-cap-plane <num>       Specify memory type to be used on Capture Plane [1 = V4L2_MEMORY_MMAP, 2 = V4L2_MEMORY_DMABUF], Default = V4L2_MEMORY_DMABUF\n\n"
             "\t-s <loop-count>      Stress test [Default = 1]\n\n"
             "\t-extra_cap_plane_buffer <num>      Specify extra capture plane buffers (Default=1, MAX=32) to be allocated\n"
+            "\t-max_cap_width <width>             Allocate the capture plane buffers at least this wide, so that they are\n"
+            "\t-max_cap_height <height>           reused across resolution changes up to this size [Default = video size]\n"
             ;
 }
 
@@ -181,6 +186,30 @@ parse_csv_args(context_t * ctx, int argc, char *argv[])
         {
             ctx->stats = true;
         }
+        else if (!strcmp(arg, "--stats-file"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->stats_file_path = strdup(*argp);
+            CSV_PARSE_CHECK_ERROR(!ctx->stats_file_path,
+                                  "Stats file not specified");
+        }
+        else if (!strcmp(arg, "--frame-checksum"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->checksum_file_path = strdup(*argp);
+            CSV_PARSE_CHECK_ERROR(!ctx->checksum_file_path,
+                                  "Checksum file not specified");
+        }
+        else if (!strcmp(arg, "--golden-checksum"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->golden_checksum_path = strdup(*argp);
+            CSV_PARSE_CHECK_ERROR(!ctx->golden_checksum_path,
+                                  "Golden checksum file not specified");
+        }
         else if (!strcmp(arg, "--disable-rendering"))
         {
             ctx->disable_rendering = true;
@@ -286,6 +315,18 @@ parse_csv_args(context_t * ctx, int argc, char *argv[])
             CSV_PARSE_CHECK_ERROR((ctx->extra_cap_plane_buffer < 1 || ctx->extra_cap_plane_buffer > 32),
                                     "extra capture plane buffer should be greater than 0 & less than 33");
         }
+        else if(!strcmp(arg, "-max_cap_width"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->max_cap_width = atoi(*argp);
+        }
+        else if(!strcmp(arg, "-max_cap_height"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->max_cap_height = atoi(*argp);
+        }
         else if (!strcmp(arg, "-sf"))
         {
             argp++;
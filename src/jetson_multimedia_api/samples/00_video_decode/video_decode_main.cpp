@@ -27,6 +27,7 @@
  */
 
 #include "NvApplicationProfiler.h"
+#include "NvThreadPolicy.h"
 #include "NvUtils.h"
 #include <errno.h>
 #include <fstream>
@@ -405,6 +406,42 @@ report_metadata(context_t *ctx, v4l2_ctrl_videodec_outputbuf_metadata *metadata)
     }
 }
 
+/**
+  * Capture pool allocator: format packs the layout above the color format.
+  */
+static int
+capture_pool_allocate(uint32_t width, uint32_t height, uint32_t format,
+                      uint32_t count, int *fds, void *arg)
+{
+    NvBufSurf::NvCommonAllocateParams params;
+
+    params.memType = NVBUF_MEM_SURFACE_ARRAY;
+    params.width = width;
+    params.height = height;
+    params.layout = (NvBufSurfaceLayout) (format >> 16);
+    params.colorFormat = (NvBufSurfaceColorFormat) (format & 0xffff);
+    params.memtag = NvBufSurfaceTag_VIDEO_DEC;
+
+    return NvBufSurf::NvAllocate(&params, count, fds);
+}
+
+static int
+capture_pool_destroy(int fd, void *arg)
+{
+    return NvBufSurf::NvDestroy(fd);
+}
+
+/**
+  * Whether --stats renders the capture buffers as they are. Pooled buffers
+  * larger than the stream would show their padding, so those are rendered
+  * from the transform to dst_dma_fd instead.
+  */
+static bool
+render_capture_directly(context_t *ctx)
+{
+    return ctx->stats && !ctx->capture_padded;
+}
+
 /**
   * Query and Set Capture plane.
   *
@@ -473,6 +510,25 @@ query_and_set_capture(context_t * ctx)
     ret = NvBufSurf::NvAllocate(&params, 1, &ctx->dst_dma_fd);
     TEST_ERROR(ret == -1, "create dmabuf failed", error);
 
+    if (ctx->checksum)
+    {
+        /* Reallocate the checksum buffers once the pending frames are hashed. */
+        ctx->checksum->clearBuffers();
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+        {
+            if (ctx->checksum_dma_fd[index] != -1)
+            {
+                ret = NvBufSurf::NvDestroy(ctx->checksum_dma_fd[index]);
+                ctx->checksum_dma_fd[index] = -1;
+                TEST_ERROR(ret < 0, "Error: Error in BufferDestroy", error);
+            }
+        }
+        ret = NvBufSurf::NvAllocate(&params, CHECKSUM_BUFFERS, ctx->checksum_dma_fd);
+        TEST_ERROR(ret == -1, "create checksum dmabuf failed", error);
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+            ctx->checksum->addBuffer(ctx->checksum_dma_fd[index]);
+    }
+
     if (!ctx->disable_rendering)
     {
         /* Destroy the old instance of renderer as resolution might have changed. */
@@ -516,19 +572,10 @@ query_and_set_capture(context_t * ctx)
         ctx->renderer->setFPS(ctx->fps);
     }
 
-    /* deinitPlane unmaps the buffers and calls REQBUFS with count 0 */
+    /* deinitPlane unmaps the buffers and calls REQBUFS with count 0.
+       The DMABUF buffers stay in the capture pool, which reuses them
+       below if the new resolution fits. */
     dec->capture_plane.deinitPlane();
-    if(ctx->capture_plane_mem_type == V4L2_MEMORY_DMABUF)
-    {
-        for(int index = 0 ; index < ctx->numCapBuffers ; index++)
-        {
-            if(ctx->dmabuff_fd[index] != 0)
-            {
-                ret = NvBufSurf::NvDestroy(ctx->dmabuff_fd[index]);
-                TEST_ERROR(ret < 0, "Error: Error in BufferDestroy", error);
-            }
-        }
-    }
 
     /* Not necessary to call VIDIOC_S_FMT on decoder capture plane.
        But decoder setCapturePlaneFormat function updates the class variables */
@@ -633,9 +680,26 @@ query_and_set_capture(context_t * ctx)
 
         capParams.colorFormat = pix_format;
 
-        ret = NvBufSurf::NvAllocate(&capParams, ctx->numCapBuffers, ctx->dmabuff_fd);
+        if (!ctx->capture_pool)
+        {
+            NvDecoderCapturePoolOps ops;
+
+            ops.allocate = capture_pool_allocate;
+            ops.destroy = capture_pool_destroy;
+            ops.arg = ctx;
+            ctx->capture_pool = new NvDecoderCapturePool("dec0", ops,
+                    ctx->max_cap_width, ctx->max_cap_height, MAX_BUFFERS);
+        }
 
+        /* Buffers larger than the crop are fine: the transform only reads
+           the display rectangle, and --stats renders padded buffers
+           through it. */
+        ret = ctx->capture_pool->configure(capParams.width, capParams.height,
+                (capParams.layout << 16) | capParams.colorFormat, ctx->numCapBuffers);
         TEST_ERROR(ret < 0, "Failed to create buffers", error);
+        for (int index = 0; index < ctx->numCapBuffers; index++)
+            ctx->dmabuff_fd[index] = ctx->capture_pool->getFd(index);
+        ctx->capture_padded = ctx->capture_pool->isPadded();
         /* Request buffers on decoder capture plane.
            Refer ioctl VIDIOC_REQBUFS */
         ret = dec->capture_plane.reqbufs(V4L2_MEMORY_DMABUF,ctx->numCapBuffers);
@@ -689,6 +753,8 @@ static void *decoder_pollthread_fcn(void *arg)
 
     cout << "Starting Device Poll Thread " << endl;
 
+    NvThreadPolicy::getInstance().applyToCurrentThread("poll");
+
     memset(&devicepoll, 0, sizeof(v4l2_ctrl_video_device_poll));
 
     /* Wait here until you are signalled to issue the Poll call.
@@ -831,7 +897,7 @@ dec_capture_loop_fcn(void *arg)
                   v4l2_buf.timestamp.tv_sec << "s" << v4l2_buf.timestamp.tv_usec << "us]" << endl;
             }
 
-            if (!ctx->disable_rendering && ctx->stats)
+            if (!ctx->disable_rendering && render_capture_directly(ctx))
             {
                 /* EglRenderer requires the fd of the 0th plane to render the buffer. */
                 if(ctx->capture_plane_mem_type == V4L2_MEMORY_DMABUF)
@@ -839,7 +905,7 @@ dec_capture_loop_fcn(void *arg)
                 ctx->renderer->render(dec_buffer->planes[0].fd);
             }
 
-            if (ctx->out_file || (!ctx->disable_rendering && !ctx->stats))
+            if (ctx->out_file || ctx->checksum || (!ctx->disable_rendering && !render_capture_directly(ctx)))
             {
                 /* Clip & Stitch can be done by adjusting rectangle. */
                 NvBufSurf::NvCommonTransformParams transform_params;
@@ -856,12 +922,43 @@ dec_capture_loop_fcn(void *arg)
                 transform_params.filter = NvBufSurfTransformInter_Nearest;
                 if(ctx->capture_plane_mem_type == V4L2_MEMORY_DMABUF)
                     dec_buffer->planes[0].fd = ctx->dmabuff_fd[v4l2_buf.index];
+
+                if (ctx->checksum)
+                {
+                    /* Convert into a free checksum buffer, which is hashed on
+                       the checksum thread while decoding continues. */
+                    int checksum_fd = ctx->checksum->getBuffer();
+                    if (checksum_fd < 0)
+                    {
+                        cerr << "No checksum buffer available" << endl;
+                        ret = -1;
+                        break;
+                    }
+                    ret = NvBufSurf::NvTransform(&transform_params, dec_buffer->planes[0].fd, checksum_fd);
+                    if (ret == -1)
+                    {
+                        ctx->checksum->addBuffer(checksum_fd);
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
+                    ret = ctx->checksum->queueBuffer(checksum_fd, ctx->out_pixfmt == 2 ? 3 : 2);
+                    if (ret == -1)
+                    {
+                        ctx->checksum->addBuffer(checksum_fd);
+                        cerr << "Error queueing checksum buffer" << endl;
+                        break;
+                    }
+                }
+
                 /* Perform Blocklinear to PitchLinear conversion. */
-                ret = NvBufSurf::NvTransform(&transform_params, dec_buffer->planes[0].fd, ctx->dst_dma_fd);
-                if (ret == -1)
+                if (ctx->out_file || (!ctx->disable_rendering && !render_capture_directly(ctx)))
                 {
-                    cerr << "Transform failed" << endl;
-                    break;
+                    ret = NvBufSurf::NvTransform(&transform_params, dec_buffer->planes[0].fd, ctx->dst_dma_fd);
+                    if (ret == -1)
+                    {
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
                 }
 
                 /* Write raw video frame to file. */
@@ -876,7 +973,7 @@ dec_capture_loop_fcn(void *arg)
                     }
                 }
 
-                if (!ctx->stats && !ctx->disable_rendering)
+                if (!render_capture_directly(ctx) && !ctx->disable_rendering)
                 {
                     ctx->renderer->render(ctx->dst_dma_fd);
                 }
@@ -941,6 +1038,8 @@ set_defaults(context_t * ctx)
     ctx->file_count = 1;
     ctx->dec_fps = 30;
     ctx->dst_dma_fd = -1;
+    for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+        ctx->checksum_dma_fd[index] = -1;
     ctx->bLoop = false;
     ctx->bQueue = false;
     ctx->loop_count = 0;
@@ -1211,7 +1310,7 @@ check_capture_buffers:
                   v4l2_capture_buf.timestamp.tv_sec << "s" << v4l2_capture_buf.timestamp.tv_usec << "us]" << endl;
             }
 
-            if (!ctx.disable_rendering && ctx.stats)
+            if (!ctx.disable_rendering && render_capture_directly(&ctx))
             {
                 /* Rendering the buffer.
                    NOTE: EglRenderer requires the fd of the 0th plane to render the buffer. */
@@ -1228,7 +1327,7 @@ check_capture_buffers:
             }
 
             /* Get the decoded buffer data dumped to file. */
-            if (ctx.out_file || (!ctx.disable_rendering && !ctx.stats))
+            if (ctx.out_file || ctx.checksum || (!ctx.disable_rendering && !render_capture_directly(&ctx)))
             {
                 NvBufSurf::NvCommonTransformParams transform_params;
                 transform_params.src_top = 0;
@@ -1245,12 +1344,43 @@ check_capture_buffers:
 
                 if(ctx.capture_plane_mem_type == V4L2_MEMORY_DMABUF)
                     capture_buffer->planes[0].fd = ctx.dmabuff_fd[v4l2_capture_buf.index];
+
+                if (ctx.checksum)
+                {
+                    /* Convert into a free checksum buffer, which is hashed on
+                       the checksum thread while decoding continues. */
+                    int checksum_fd = ctx.checksum->getBuffer();
+                    if (checksum_fd < 0)
+                    {
+                        cerr << "No checksum buffer available" << endl;
+                        ret = -1;
+                        break;
+                    }
+                    ret = NvBufSurf::NvTransform(&transform_params, capture_buffer->planes[0].fd, checksum_fd);
+                    if (ret == -1)
+                    {
+                        ctx.checksum->addBuffer(checksum_fd);
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
+                    ret = ctx.checksum->queueBuffer(checksum_fd, ctx.out_pixfmt == 2 ? 3 : 2);
+                    if (ret == -1)
+                    {
+                        ctx.checksum->addBuffer(checksum_fd);
+                        cerr << "Error queueing checksum buffer" << endl;
+                        break;
+                    }
+                }
+
                 /* Perform Blocklinear to PitchLinear conversion. */
-                ret = NvBufSurf::NvTransform(&transform_params, capture_buffer->planes[0].fd, ctx.dst_dma_fd);
-                if (ret == -1)
+                if (ctx.out_file || (!ctx.disable_rendering && !render_capture_directly(&ctx)))
                 {
-                    cerr << "Transform failed" << endl;
-                    break;
+                    ret = NvBufSurf::NvTransform(&transform_params, capture_buffer->planes[0].fd, ctx.dst_dma_fd);
+                    if (ret == -1)
+                    {
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
                 }
                 /* Write raw video frame to file. */
                 if (!ctx.stats && ctx.out_file)
@@ -1266,7 +1396,7 @@ check_capture_buffers:
                 }
 
                 /* Rendering the buffer. */
-                if (!ctx.stats && !ctx.disable_rendering)
+                if (!render_capture_directly(&ctx) && !ctx.disable_rendering)
                 {
                     ctx.renderer->render(ctx.dst_dma_fd);
                 }
@@ -1495,11 +1625,22 @@ decode_proc(context_t& ctx, int argc, char *argv[])
                    cleanup);
     }
 
+    /* Start the checksum thread; its buffers are allocated with the
+       capture plane. */
+    if (ctx.checksum_file_path || ctx.golden_checksum_path)
+    {
+        ctx.checksum = new NvFrameChecksum(NvFrameChecksum::getSurfaceOps());
+        TEST_ERROR(ctx.checksum->open(ctx.checksum_file_path,
+                   ctx.golden_checksum_path) < 0,
+                   "Error opening checksum files", cleanup);
+    }
+
     /* Enable profiling for decoder if stats are requested. */
     if (ctx.stats)
     {
         profiler.start(NvApplicationProfiler::DefaultSamplingInterval);
         ctx.dec->enableProfiling();
+        profiler.addElement("dec0", ctx.dec);
     }
 
     /* Subscribe to Resolution change event.
@@ -1783,27 +1924,50 @@ cleanup:
     {
         profiler.stop();
         ctx.dec->printProfilingStats(cout);
+        if (ctx.capture_pool)
+        {
+            ctx.capture_pool->printStats(cout);
+        }
         if (ctx.renderer)
         {
             ctx.renderer->printProfilingStats(cout);
         }
         profiler.printProfilerData(cout);
+        if (ctx.stats_file_path)
+        {
+            size_t len = strlen(ctx.stats_file_path);
+            ofstream stats_file(ctx.stats_file_path);
+
+            if (!stats_file.is_open())
+                cerr << "Error opening stats file" << endl;
+            else if (len > 5 && !strcmp(ctx.stats_file_path + len - 5, ".json"))
+                profiler.exportJSON(stats_file);
+            else
+                profiler.exportCSV(stats_file);
+        }
     }
 
-    if(ctx.capture_plane_mem_type == V4L2_MEMORY_DMABUF)
+    if (ctx.checksum)
     {
-        for(int index = 0 ; index < ctx.numCapBuffers ; index++)
+        /* Wait for the pending frames and report the golden comparison. */
+        if (ctx.checksum->close() < 0)
+        {
+            cerr << "Frame checksum verification failed" << endl;
+            error = 1;
+        }
+        delete ctx.checksum;
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
         {
-            if(ctx.dmabuff_fd[index] != 0)
+            if (ctx.checksum_dma_fd[index] != -1)
             {
-                ret = NvBufSurf::NvDestroy(ctx.dmabuff_fd[index]);
-                if(ret < 0)
-                {
-                    cerr << "Failed to Destroy NvBuffer" << endl;
-                }
+                NvBufSurf::NvDestroy(ctx.checksum_dma_fd[index]);
+                ctx.checksum_dma_fd[index] = -1;
             }
         }
     }
+
+    delete ctx.capture_pool;
+    ctx.capture_pool = NULL;
     if (ctx.dec && ctx.dec->isInError())
     {
         cerr << "Decoder is in error" << endl;
@@ -1841,6 +2005,9 @@ cleanup:
       free (ctx.in_file_path[i]);
     free (ctx.in_file_path);
     free(ctx.out_file_path);
+    free(ctx.stats_file_path);
+    free(ctx.checksum_file_path);
+    free(ctx.golden_checksum_path);
     if (!ctx.blocking_mode)
     {
         sem_destroy(&ctx.pollthread_sema);
@@ -1872,6 +2039,10 @@ main(int argc, char *argv[])
         iterator_num++;
     } while((ctx.stress_test != iterator_num) && ret == 0);
 
+    /* Report the thread policies applied during the run. */
+    if (NvThreadPolicy::getInstance().isConfigured())
+        NvThreadPolicy::getInstance().printPolicy();
+
     /* Report application run status on exit. */
     if (ret)
     {
@@ -33,6 +33,8 @@
 #include <semaphore.h>
 
 #include "NvBufSurface.h"
+#include "NvOrderedWorkQueue.h"
+#include "NvMotionActivity.h"
 
 #define CRC32_POLYNOMIAL  0xEDB88320L
 #define MAX_OUT_BUFFERS 32
@@ -143,6 +145,9 @@ typedef struct
     bool copy_timestamp;
     uint32_t start_ts;
     bool dump_mv;
+    char *mv_export_path;          /* Binary motion vector file */
+    bool motion_detect;            /* Motion events from the motion vectors */
+    NvMotionActivity *motion_activity;
     bool enableGDR;
     bool bGapsInFrameNumAllowed;
     bool bnoIframe;
@@ -172,6 +177,15 @@ typedef struct
     uint64_t timestampincr;
 
     bool stats;
+    uint32_t async_output_workers; /* Output worker threads, 0 to write on the DQ thread */
+    NvOrderedWorkQueue *output_queue;
+
+    uint64_t capture_bytes;
+    uint32_t capture_frames;
+    uint64_t capture_first_usec;
+    uint64_t capture_last_usec;
+    uint64_t capture_queued_sum;
+    uint32_t capture_queued_min;
 
     std::stringstream *runtime_params_str;
     uint32_t next_param_change_frame;
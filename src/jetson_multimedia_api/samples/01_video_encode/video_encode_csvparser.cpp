@@ -59,7 +59,9 @@ print_help(void)
             "OPTIONS:\n"
             "\t-h,--help             Prints this text\n"
             "\t--dbg-level <level>   Sets the debug level [Values 0-3]\n\n"
-            "\t--stats               Report profiling data for the app\n\n"
+            "\t--stats               Report profiling data for the app\n"
+            "\t--async-output <n>    Write encoded frames on <n> worker threads, in order,\n"
+            "\t                      off the capture plane DQ thread [Default = 0]\n\n"
             "\t-br <bitrate>         Bitrate [Default = 4000000]\n"
             "\t-pbr <peak_bitrate>   Peak bitrate [Default = 1.2*bitrate]\n\n"
             "NOTE: Peak bitrate takes effect in VBR more; must be >= bitrate\n\n"
@@ -106,7 +108,9 @@ print_help(void)
             "\t--blocking-mode <val> Set blocking mode, 0 is non-blocking, 1 for blocking (Default) \n\n"
             "\t--input-metadata      Enable encoder input metadata\n"
             "\t--copy-timestamp <st> Enable copy timestamp with start timestamp(st) in seconds\n"
-            "\t--mvdump              Dump encoded motion vectors\n\n"
+            "\t--mvdump              Dump encoded motion vectors\n"
+            "\t--mv-export <file>    Write encoded motion vectors to a binary file\n"
+            "\t--motion-detect       Report motion events from encoded motion vectors\n\n"
             "\t--eroi                Enable ROI [Default = disabled]\n\n"
             "\t-roi <roi_file_path>  Specify roi param file\n\n"
             "\t--erps                Enable External RPS [Default = disabled]\n\n"
@@ -451,6 +455,12 @@ parse_csv_args(context_t * ctx, int argc, char *argv[])
         {
             ctx->stats = true;
         }
+        else if (!strcmp(arg, "--async-output"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->async_output_workers = atoi(*argp);
+        }
         else if (!strcmp(arg, "--eroi"))
         {
             ctx->enableROI = true;
@@ -921,6 +931,16 @@ parse_csv_args(context_t * ctx, int argc, char *argv[])
         {
             ctx->dump_mv = true;
         }
+        else if (!strcmp(arg, "--mv-export"))
+        {
+            argp++;
+            CHECK_OPTION_VALUE(argp);
+            ctx->mv_export_path = strdup(*argp);
+        }
+        else if (!strcmp(arg, "--motion-detect"))
+        {
+            ctx->motion_detect = true;
+        }
         else if (!strcmp(arg, "--enc-cmd"))
         {
           ctx->b_use_enc_cmd = true;
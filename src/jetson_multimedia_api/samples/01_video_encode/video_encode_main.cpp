@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "NvThreadPolicy.h"
 #include "NvUtils.h"
 #include <fstream>
 #include <iostream>
@@ -49,6 +50,7 @@
 
 #define IS_DIGIT(c) (c >= '0' && c <= '9')
 #define MICROSECOND_UNIT 1000000
+#define ENC_OUTPUT_QUEUE_CAPACITY 32
 
 using namespace std;
 
@@ -168,21 +170,245 @@ void CloseCrc(Crc **phCrc)
 }
 
 /**
-  * Write encoded frame data.
+  * Encoded access unit and the data queried for it on the capture plane.
+  */
+typedef struct
+{
+    uint32_t frame_num;
+    uint32_t encoded_index;
+    uint8_t *data;
+    uint32_t size;
+    bool has_metadata;
+    v4l2_ctrl_videoenc_outputbuf_metadata metadata;
+    MVInfo *mv_info;
+    uint32_t num_mvs;
+    bool owns_data; // data and mv_info are copies owned by the job
+    string text;    // report printed when the job is committed
+} enc_output_job;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * MICROSECOND_UNIT + ts.tv_nsec / 1000;
+}
+
+static void
+free_output_job(enc_output_job *job)
+{
+    if (job->owns_data)
+    {
+        delete[] job->data;
+        delete[] (uint8_t *) job->mv_info;
+        delete job;
+    }
+}
+
+/**
+  * Writes the metadata and motion vector report of an access unit.
   *
-  * @param stream : output stream
-  * @param buffer : output nvbuffer
+  * @param ctx  : Encoder context
+  * @param job  : enc_output_job
+  * @param text : Stream to write the report to
   */
-static int
-write_encoder_output_frame(ofstream * stream, NvBuffer * buffer)
+static void
+write_output_report(context_t *ctx, enc_output_job *job, ostream &text)
 {
-    stream->write((char *) buffer->planes[0].data, buffer->planes[0].bytesused);
-    return 0;
+    v4l2_ctrl_videoenc_outputbuf_metadata &enc_metadata = job->metadata;
+
+    if (job->has_metadata)
+    {
+        if (ctx->bReconCrc && enc_metadata.bValidReconCRC) {
+            /* CRC for Recon frame */
+            text << "Frame: " << job->frame_num << endl;
+            text << "ReconFrame_Y_CRC " << enc_metadata.ReconFrame_Y_CRC <<
+                " ReconFrame_U_CRC " << enc_metadata.ReconFrame_U_CRC <<
+                " ReconFrame_V_CRC " << enc_metadata.ReconFrame_V_CRC <<
+                endl;
+        } else if (ctx->externalRPS && enc_metadata.bRPSFeedback_status) {
+            /* RPS Feedback */
+            text << "Frame: " << job->frame_num << endl;
+            text << "nCurrentRefFrameId " << enc_metadata.nCurrentRefFrameId <<
+                 " nActiveRefFrames " << enc_metadata.nActiveRefFrames << endl;
+
+            for (uint32_t i = 0; i < enc_metadata.nActiveRefFrames; i++)
+            {
+                text << "FrameId " << enc_metadata.RPSList[i].nFrameId <<
+                 " IdrFrame " <<  (int) enc_metadata.RPSList[i].bIdrFrame <<
+                 " LTRefFrame " <<  (int) enc_metadata.RPSList[i].bLTRefFrame <<
+                 " PictureOrderCnt " << enc_metadata.RPSList[i].nPictureOrderCnt <<
+                 " FrameNum " << enc_metadata.RPSList[i].nFrameNum <<
+                 " LTFrameIdx " <<  enc_metadata.RPSList[i].nLTRFrameIdx << endl;
+            }
+        } else if (ctx->externalRCHints) {
+            /* Rate Control Feedback */
+            text << "Frame: " << job->frame_num << endl;
+            text << "EncodedBits " << enc_metadata.EncodedFrameBits <<
+                " MinQP " << enc_metadata.FrameMinQP <<
+                " MaxQP " << enc_metadata.FrameMaxQP <<
+                endl;
+        } else {
+            text << "Frame " << job->frame_num <<
+                ": isKeyFrame=" << (int) enc_metadata.KeyFrame <<
+                " AvgQP=" << enc_metadata.AvgQP <<
+                " MinQP=" << enc_metadata.FrameMinQP <<
+                " MaxQP=" << enc_metadata.FrameMaxQP <<
+                " EncodedBits=" << enc_metadata.EncodedFrameBits <<
+                endl;
+        }
+    }
+    if (job->mv_info)
+    {
+        MVInfo *pInfo = job->mv_info;
+
+        text << "Frame " << job->frame_num << ": Num MVs=" << job->num_mvs << endl;
+
+        for (uint32_t i = 0; i < job->num_mvs; i++, pInfo++)
+        {
+            text << i << ": mv_x=" << pInfo->mv_x <<
+                " mv_y=" << pInfo->mv_y <<
+                " weight=" << pInfo->weight <<
+                endl;
+        }
+    }
+}
+
+/**
+  * Formats the report of an access unit into the job. Does not depend
+  * on other frames, so it may run on any output worker.
+  *
+  * @param job : enc_output_job
+  * @param arg : context pointer
+  */
+static void
+format_output_job(void *job_ptr, void *arg)
+{
+    context_t *ctx = (context_t *) arg;
+    enc_output_job *job = (enc_output_job *) job_ptr;
+
+    /* Most frames have nothing to report; skip the stream for them. */
+    if (job->has_metadata || job->mv_info)
+    {
+        ostringstream text;
+        write_output_report(ctx, job, text);
+        job->text = text.str();
+    }
+}
+
+/**
+  * Writes an access unit and its report. Must be called in encoding order.
+  *
+  * @param ctx : Encoder context
+  * @param job : enc_output_job
+  */
+static bool
+commit_output_job(context_t *ctx, enc_output_job *job)
+{
+    v4l2_ctrl_videoenc_outputbuf_metadata &enc_metadata = job->metadata;
+    uint32_t ReconRef_Y_CRC = 0;
+    uint32_t ReconRef_U_CRC = 0;
+    uint32_t ReconRef_V_CRC = 0;
+
+    /* Computing CRC with each frame */
+    if(ctx->pBitStreamCrc)
+        CalculateCrc (ctx->pBitStreamCrc, job->data, job->size);
+
+    if (!ctx->stats)
+        ctx->out_file->write((char *) job->data, job->size);
+
+    /* Accounting for the first frame as it is only sps+pps */
+    if (ctx->gdr_out_frame_number != 0xFFFFFFFF)
+        if ( (ctx->enableGDR) && (ctx->GDR_out_file_path) && (job->encoded_index >= ctx->gdr_out_frame_number+1))
+            ctx->gdr_out_file->write((char *) job->data, job->size);
+
+    /* Without output workers the report is written here directly. */
+    if (ctx->output_queue)
+        cout << job->text;
+    else
+        write_output_report(ctx, job, cout);
+
+    if (job->has_metadata && ctx->bReconCrc && enc_metadata.bValidReconCRC)
+    {
+        if (!ctx->recon_Ref_file->eof())
+        {
+            string recon_ref_YUV_data[4];
+
+            parse_csv_recon_file(ctx->recon_Ref_file, recon_ref_YUV_data);
+
+            ReconRef_Y_CRC = stoul(recon_ref_YUV_data[0]);
+            ReconRef_U_CRC = stoul(recon_ref_YUV_data[1]);
+            ReconRef_V_CRC = stoul(recon_ref_YUV_data[2]);
+        }
+
+        if ((ReconRef_Y_CRC != enc_metadata.ReconFrame_Y_CRC) ||
+            (ReconRef_U_CRC != enc_metadata.ReconFrame_U_CRC) ||
+            (ReconRef_V_CRC != enc_metadata.ReconFrame_V_CRC))
+        {
+            cout << "Recon CRC FAIL" << endl;
+            cout << "ReconRef_Y_CRC " << ReconRef_Y_CRC <<
+                " ReconRef_U_CRC " << ReconRef_U_CRC <<
+                " ReconRef_V_CRC " << ReconRef_V_CRC <<
+                endl;
+            abort(ctx);
+            return false;
+        }
+        cout << "Recon CRC PASS for frame : " << job->frame_num << endl;
+    }
+
+    return true;
+}
+
+/**
+  * Output worker commit callback, called in encoding order.
+  *
+  * @param job : enc_output_job
+  * @param arg : context pointer
+  */
+static void
+commit_output_job_callback(void *job, void *arg)
+{
+    context_t *ctx = (context_t *) arg;
+
+    if (!ctx->got_error)
+        commit_output_job(ctx, (enc_output_job *) job);
+    free_output_job((enc_output_job *) job);
+}
+
+/**
+  * Print encoder throughput and capture plane queue depth.
+  *
+  * @param ctx : Encoder context
+  */
+static void
+print_capture_stats(context_t *ctx)
+{
+    double seconds = (ctx->capture_last_usec - ctx->capture_first_usec) /
+        (double) MICROSECOND_UNIT;
+
+    cout << "----------- Encoder capture plane -----------" << endl;
+    cout << "Access units: " << ctx->capture_frames << ", bytes: " <<
+        ctx->capture_bytes << endl;
+    if (ctx->capture_frames > 1 && seconds > 0)
+        cout << "Throughput: " << (ctx->capture_frames - 1) / seconds << " fps, " <<
+            ctx->capture_bytes * 8 / seconds / 1000000 << " Mbps" << endl;
+    if (ctx->capture_frames)
+        cout << "Buffers queued after requeue: avg " <<
+            (double) ctx->capture_queued_sum / ctx->capture_frames <<
+            ", min " << ctx->capture_queued_min << " of " <<
+            ctx->enc->capture_plane.getNumBuffers() << endl;
+    cout << "---------------------------------------------" << endl;
 }
 
 /**
   * Encoder capture-plane deque buffer callback function.
   *
+  * Queries the per-frame metadata, which is only valid until the buffer is
+  * queued again. With --async-output the access unit is copied into the
+  * output work queue and the buffer is queued back at once; otherwise the
+  * access unit is written and reported before the buffer is queued back.
+  *
   * @param v4l2_buf      : v4l2 buffer
   * @param buffer        : NvBuffer
   * @param shared_buffer : shared NvBuffer
@@ -196,11 +422,11 @@ encoder_capture_plane_dq_callback(struct v4l2_buffer *v4l2_buf, NvBuffer * buffe
     NvVideoEncoder *enc = ctx->enc;
     pthread_setname_np(pthread_self(), "EncCapPlane");
     uint32_t frame_num = ctx->enc->capture_plane.getTotalDequeuedBuffers() - 1;
-    uint32_t ReconRef_Y_CRC = 0;
-    uint32_t ReconRef_U_CRC = 0;
-    uint32_t ReconRef_V_CRC = 0;
     static uint32_t num_encoded_frames = 1;
     struct v4l2_event ev;
+    enc_output_job local_job;
+    enc_output_job *job = &local_job;
+    uint32_t num_queued;
     int ret = 0;
 
     if (v4l2_buf == NULL)
@@ -230,115 +456,90 @@ encoder_capture_plane_dq_callback(struct v4l2_buffer *v4l2_buf, NvBuffer * buffe
         return false;
     }
 
-    /* Computing CRC with each frame */
-    if(ctx->pBitStreamCrc)
-        CalculateCrc (ctx->pBitStreamCrc, buffer->planes[0].data, buffer->planes[0].bytesused);
-
-    if (!ctx->stats)
-        write_encoder_output_frame(ctx->out_file, buffer);
-
-    /* Accounting for the first frame as it is only sps+pps */
-    if (ctx->gdr_out_frame_number != 0xFFFFFFFF)
-        if ( (ctx->enableGDR) && (ctx->GDR_out_file_path) && (num_encoded_frames >= ctx->gdr_out_frame_number+1))
-            write_encoder_output_frame(ctx->gdr_out_file, buffer);
-
-    num_encoded_frames++;
+    if (ctx->output_queue)
+        job = new enc_output_job;
+    job->frame_num = frame_num;
+    job->encoded_index = num_encoded_frames++;
+    job->size = buffer->planes[0].bytesused;
+    job->has_metadata = false;
+    job->mv_info = NULL;
+    job->num_mvs = 0;
+    job->owns_data = (ctx->output_queue != NULL);
+    if (job->owns_data)
+    {
+        job->data = new uint8_t[job->size];
+        memcpy(job->data, buffer->planes[0].data, job->size);
+    }
+    else
+    {
+        job->data = buffer->planes[0].data;
+    }
 
     if (ctx->report_metadata)
     {
-        v4l2_ctrl_videoenc_outputbuf_metadata enc_metadata;
+        v4l2_ctrl_videoenc_outputbuf_metadata &enc_metadata = job->metadata;
         if (ctx->enc->getMetadata(v4l2_buf->index, enc_metadata) == 0)
         {
-            if (ctx->bReconCrc && enc_metadata.bValidReconCRC) {
-                /* CRC for Recon frame */
-                cout << "Frame: " << frame_num << endl;
-                cout << "ReconFrame_Y_CRC " << enc_metadata.ReconFrame_Y_CRC <<
-                    " ReconFrame_U_CRC " << enc_metadata.ReconFrame_U_CRC <<
-                    " ReconFrame_V_CRC " << enc_metadata.ReconFrame_V_CRC <<
-                    endl;
-
-                if (!ctx->recon_Ref_file->eof())
-                {
-                    string recon_ref_YUV_data[4];
-
-                    parse_csv_recon_file(ctx->recon_Ref_file, recon_ref_YUV_data);
-
-                    ReconRef_Y_CRC = stoul(recon_ref_YUV_data[0]);
-                    ReconRef_U_CRC = stoul(recon_ref_YUV_data[1]);
-                    ReconRef_V_CRC = stoul(recon_ref_YUV_data[2]);
-                }
-
-                if ((ReconRef_Y_CRC != enc_metadata.ReconFrame_Y_CRC) ||
-                    (ReconRef_U_CRC != enc_metadata.ReconFrame_U_CRC) ||
-                    (ReconRef_V_CRC != enc_metadata.ReconFrame_V_CRC))
-                {
-                    cout << "Recon CRC FAIL" << endl;
-                    cout << "ReconRef_Y_CRC " << ReconRef_Y_CRC <<
-                        " ReconRef_U_CRC " << ReconRef_U_CRC <<
-                        " ReconRef_V_CRC " << ReconRef_V_CRC <<
-                        endl;
-                    abort(ctx);
-                    return false;
-                }
-                cout << "Recon CRC PASS for frame : " << frame_num << endl;
-            } else if (ctx->externalRPS && enc_metadata.bRPSFeedback_status) {
-                /* RPS Feedback */
+            job->has_metadata = true;
+            if (!(ctx->bReconCrc && enc_metadata.bValidReconCRC) &&
+                ctx->externalRPS && enc_metadata.bRPSFeedback_status)
+            {
+                /* Update RPS List */
                 ctx->rps_par.nActiveRefFrames = enc_metadata.nActiveRefFrames;
-                cout << "Frame: " << frame_num << endl;
-                cout << "nCurrentRefFrameId " << enc_metadata.nCurrentRefFrameId <<
-                     " nActiveRefFrames " << enc_metadata.nActiveRefFrames << endl;
-
                 for (uint32_t i = 0; i < enc_metadata.nActiveRefFrames; i++)
                 {
-                    /* Update RPS List */
                     ctx->rps_par.rps_list[i].nFrameId = enc_metadata.RPSList[i].nFrameId;
                     ctx->rps_par.rps_list[i].bLTRefFrame = enc_metadata.RPSList[i].bLTRefFrame;
-                    cout << "FrameId " << enc_metadata.RPSList[i].nFrameId <<
-                     " IdrFrame " <<  (int) enc_metadata.RPSList[i].bIdrFrame <<
-                     " LTRefFrame " <<  (int) enc_metadata.RPSList[i].bLTRefFrame <<
-                     " PictureOrderCnt " << enc_metadata.RPSList[i].nPictureOrderCnt <<
-                     " FrameNum " << enc_metadata.RPSList[i].nFrameNum <<
-                     " LTFrameIdx " <<  enc_metadata.RPSList[i].nLTRFrameIdx << endl;
                 }
-            } else if (ctx->externalRCHints) {
-                /* Rate Control Feedback */
-                cout << "Frame: " << frame_num << endl;
-                cout << "EncodedBits " << enc_metadata.EncodedFrameBits <<
-                    " MinQP " << enc_metadata.FrameMinQP <<
-                    " MaxQP " << enc_metadata.FrameMaxQP <<
-                    endl;
-            } else {
-                cout << "Frame " << frame_num <<
-                    ": isKeyFrame=" << (int) enc_metadata.KeyFrame <<
-                    " AvgQP=" << enc_metadata.AvgQP <<
-                    " MinQP=" << enc_metadata.FrameMinQP <<
-                    " MaxQP=" << enc_metadata.FrameMaxQP <<
-                    " EncodedBits=" << enc_metadata.EncodedFrameBits <<
-                    endl;
             }
         }
     }
-    if (ctx->dump_mv)
+    if (ctx->dump_mv || ctx->motion_activity)
     {
         /* Get motion vector parameters of the frames from encoder */
         v4l2_ctrl_videoenc_outputbuf_metadata_MV enc_mv_metadata;
         if (ctx->enc->getMotionVectors(v4l2_buf->index, enc_mv_metadata) == 0)
         {
-            uint32_t numMVs = enc_mv_metadata.bufSize / sizeof(MVInfo);
-            MVInfo *pInfo = enc_mv_metadata.pMVInfo;
+            uint32_t num_mvs = enc_mv_metadata.bufSize / sizeof(MVInfo);
 
-            cout << "Frame " << frame_num << ": Num MVs=" << numMVs << endl;
+            /* Copy into the motion activity ring, analyzed on its own thread */
+            if (ctx->motion_activity)
+                ctx->motion_activity->push(frame_num, enc_mv_metadata.pMVInfo, num_mvs);
 
-            for (uint32_t i = 0; i < numMVs; i++, pInfo++)
+            if (ctx->dump_mv)
             {
-                cout << i << ": mv_x=" << pInfo->mv_x <<
-                    " mv_y=" << pInfo->mv_y <<
-                    " weight=" << pInfo->weight <<
-                    endl;
+                job->num_mvs = num_mvs;
+                job->mv_info = enc_mv_metadata.pMVInfo;
+                if (job->owns_data)
+                {
+                    job->mv_info = (MVInfo *) new uint8_t[enc_mv_metadata.bufSize];
+                    memcpy(job->mv_info, enc_mv_metadata.pMVInfo, enc_mv_metadata.bufSize);
+                }
             }
         }
     }
 
+    ctx->capture_last_usec = get_time_usec();
+    if (ctx->capture_frames++ == 0)
+        ctx->capture_first_usec = ctx->capture_last_usec;
+    ctx->capture_bytes += job->size;
+
+    if (ctx->output_queue)
+    {
+        /* The output workers write and report the access unit in order. */
+        if (ctx->output_queue->push(job) < 0)
+        {
+            free_output_job(job);
+            abort(ctx);
+            return false;
+        }
+    }
+    else
+    {
+        if (!commit_output_job(ctx, job))
+            return false;
+    }
+
     if (ctx->blocking_mode && ctx->RPS_threeLayerSvc)
     {
         sem_post(&ctx->rps_par.sema);
@@ -352,6 +553,11 @@ encoder_capture_plane_dq_callback(struct v4l2_buffer *v4l2_buf, NvBuffer * buffe
         return false;
     }
 
+    num_queued = enc->capture_plane.getNumQueuedBuffers();
+    ctx->capture_queued_sum += num_queued;
+    if (ctx->capture_frames == 1 || num_queued < ctx->capture_queued_min)
+        ctx->capture_queued_min = num_queued;
+
     return true;
 }
 
@@ -563,6 +769,8 @@ set_defaults(context_t * ctx)
     ctx->input_metadata = false;
     ctx->sMaxQp = 51;
     ctx->stats = false;
+    ctx->async_output_workers = 0;
+    ctx->output_queue = NULL;
     ctx->stress_test = 1;
     ctx->output_memory_type = V4L2_MEMORY_DMABUF;
     ctx->cs = V4L2_COLORSPACE_SMPTE170M;
@@ -886,6 +1094,8 @@ static void *encoder_pollthread_fcn(void *arg)
 
     cout << "Starting Device Poll Thread " << endl;
 
+    NvThreadPolicy::getInstance().applyToCurrentThread("poll");
+
     memset(&devicepoll, 0, sizeof(v4l2_ctrl_video_device_poll));
 
     /* wait here until signalled to issue the Poll call.
@@ -1507,6 +1717,14 @@ encode_proc(context_t& ctx, int argc, char *argv[])
         TEST_ERROR(!ctx.hints_Param_file->is_open(), "Could not open hints param file", cleanup);
     }
 
+    if (ctx.async_output_workers)
+    {
+        /* Write and report encoded frames off the capture plane DQ thread */
+        ctx.output_queue = new NvOrderedWorkQueue("EncOut", ctx.async_output_workers,
+                ENC_OUTPUT_QUEUE_CAPACITY, format_output_job, commit_output_job_callback, &ctx);
+        TEST_ERROR(ctx.output_queue->start() < 0, "Could not start output work queue", cleanup);
+    }
+
     /* Create NvVideoEncoder object for blocking or non-blocking I/O mode. */
     if (ctx.blocking_mode)
     {
@@ -1827,13 +2045,31 @@ encode_proc(context_t& ctx, int argc, char *argv[])
         TEST_ERROR(ret < 0, "Error while setting encoder to max perf", cleanup);
     }
 
-    if (ctx.dump_mv)
+    if (ctx.dump_mv || ctx.mv_export_path || ctx.motion_detect)
     {
         /* Enable dumping of motion vectors report from encoder */
         ret = ctx.enc->enableMotionVectorReporting();
         TEST_ERROR(ret < 0, "Could not enable motion vector reporting", cleanup);
     }
 
+    if (ctx.mv_export_path || ctx.motion_detect)
+    {
+        /* One motion vector per 16x16 macroblock for H.264, 32x32 CTB for H.265 */
+        uint32_t block_size = (ctx.encoder_pixfmt == V4L2_PIX_FMT_H265) ? 32 : 16;
+
+        ctx.motion_activity = new NvMotionActivity((ctx.width + block_size - 1) / block_size,
+                (ctx.height + block_size - 1) / block_size);
+        if (!ctx.motion_detect)
+            ctx.motion_activity->setEventCallback(NULL, NULL);
+        if (ctx.mv_export_path)
+        {
+            ret = ctx.motion_activity->openExport(ctx.mv_export_path);
+            TEST_ERROR(ret < 0, "Could not open motion vector export file", cleanup);
+        }
+        ret = ctx.motion_activity->start();
+        TEST_ERROR(ret < 0, "Could not start motion activity thread", cleanup);
+    }
+
     if (ctx.bnoIframe) {
         ctx.iframe_interval = ((1<<31) + 1); /* TODO: how can we do this properly */
         ret = ctx.enc->setIFrameInterval(ctx.iframe_interval);
@@ -2273,6 +2509,23 @@ encode_proc(context_t& ctx, int argc, char *argv[])
     }
 
 cleanup:
+    if (ctx.output_queue)
+    {
+        /* Commit the encoded frames still in flight */
+        ctx.output_queue->stop();
+        if (ctx.stats)
+            ctx.output_queue->printStats(cout);
+    }
+    if (ctx.enc && (ctx.stats || ctx.output_queue))
+    {
+        print_capture_stats(&ctx);
+    }
+    if (ctx.motion_activity)
+    {
+        ctx.motion_activity->stop();
+        ctx.motion_activity->printStats(cout);
+    }
+
     if (ctx.enc && ctx.enc->isInError())
     {
         cerr << "Encoder is in error" << endl;
@@ -2344,6 +2597,8 @@ cleanup:
 
     /* Release encoder configuration specific resources. */
     delete ctx.enc;
+    delete ctx.output_queue;
+    delete ctx.motion_activity;
     delete ctx.in_file;
     delete ctx.out_file;
     delete ctx.roi_Param_file;
@@ -2361,6 +2616,7 @@ cleanup:
     free(ctx.hints_Param_file_path);
     free(ctx.GDR_Param_file_path);
     free(ctx.GDR_out_file_path);
+    free(ctx.mv_export_path);
     delete ctx.runtime_params_str;
 
     if (ctx.blocking_mode)
@@ -2400,6 +2656,10 @@ main(int argc, char *argv[])
         iterator_num++;
     } while((ctx.stress_test != iterator_num) && ret == 0);
 
+    /* Report the thread policies applied during the run. */
+    if (NvThreadPolicy::getInstance().isConfigured())
+        NvThreadPolicy::getInstance().printPolicy();
+
     /* Report application run status on exit. */
     if (ret)
     {
@@ -301,6 +301,30 @@ get_rect(context_t *ctx)
     }
 }
 
+/**
+  * Destroy the transform destination buffer, with its EGLImage and
+  * its cached CUDA registration.
+  */
+static int
+destroy_dst_buffer(context_t * ctx)
+{
+    NvBufSurface *nvbuf_surf = NULL;
+    int ret;
+
+    invalidateEGLImage(ctx->dst_dma_fd);
+    if (NvBufSurfaceFromFd(ctx->dst_dma_fd, (void**)(&nvbuf_surf)) == 0 &&
+        nvbuf_surf->surfaceList[0].mappedAddr.eglImage != NULL)
+    {
+        if (NvBufSurfaceUnMapEglImage(nvbuf_surf, 0) != 0)
+            cerr << "Unable to unmap EGL Image" << endl;
+    }
+    ctx->egl_image = NULL;
+
+    ret = NvBufSurf::NvDestroy(ctx->dst_dma_fd);
+    ctx->dst_dma_fd = -1;
+    return ret;
+}
+
 /**
   * Query and Set Capture plane.
   */
@@ -338,8 +362,7 @@ query_and_set_capture(context_t * ctx)
 
     if(ctx->dst_dma_fd != -1)
     {
-        ret = NvBufSurf::NvDestroy(ctx->dst_dma_fd);
-        ctx->dst_dma_fd = -1;
+        ret = destroy_dst_buffer(ctx);
         TEST_ERROR(ret < 0, "Error: Error in BufferDestroy", error);
     }
 
@@ -607,22 +630,10 @@ dec_capture_loop_fcn(void *arg)
             }
 
             /* Map EGLImage to CUDA buffer, and call CUDA kernel to
-               draw a 32x32 pixels black box on left-top of each frame */
-            HandleEGLImage(&ctx->egl_image);
-
-            /* Destroy EGLImage */
-            ret = NvBufSurfaceFromFd(ctx->dst_dma_fd, (void**)(&nvbuf_surf));
-            if (ret != 0)
-            {
-                cerr << "Unable to extract NvBufSurfaceFromFd" << endl;
-                break;
-            }
-            if (NvBufSurfaceUnMapEglImage(nvbuf_surf, 0) != 0)
-            {
-                cerr << "Unable to unmap EGL Image" << endl;
-                break;
-            }
-            ctx->egl_image = NULL;
+               draw a 32x32 pixels black box on left-top of each frame.
+               The EGLImage stays mapped and registered with CUDA until
+               the buffer is destroyed. */
+            HandleEGLImage(&ctx->egl_image, ctx->dst_dma_fd);
 
             if (ctx->enable_osd) {
                 get_rect(ctx);
@@ -924,8 +935,8 @@ cleanup:
 
     if(ctx.dst_dma_fd != -1)
     {
-        ret = NvBufSurf::NvDestroy(ctx.dst_dma_fd);
-        ctx.dst_dma_fd = -1;
+        printEGLImageStats();
+        ret = destroy_dst_buffer(&ctx);
         if(ret < 0)
         {
             cerr << "Error in BufferDestroy" << endl;
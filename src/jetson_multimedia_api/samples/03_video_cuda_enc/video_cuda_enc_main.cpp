@@ -106,18 +106,31 @@ render_rect(context_t *ctx, NvBuffer *buffer)
     }
 
     /* Map EGLImage to CUDA buffer, and call CUDA kernel to
-       draw a 32x32 pixels black box on left-top of each frame */
-    HandleEGLImage(&ctx->eglimg);
+       draw a 32x32 pixels black box on left-top of each frame.
+       The output plane buffers are reused, so their EGLImages stay
+       mapped and registered with CUDA until release_egl_images(). */
+    HandleEGLImage(&ctx->eglimg, buffer->planes[0].fd);
 
-    /* Destroy EGLImage */
-    if (NvBufSurfaceUnMapEglImage(nvbuf_surf, 0) != 0)
+    return 0;
+}
+
+/**
+ * Drops the CUDA registrations and EGLImages of the output plane buffers.
+ */
+static void
+release_egl_images(context_t *ctx)
+{
+    for (uint32_t i = 0; i < ctx->enc->output_plane.getNumBuffers(); i++)
     {
-        cerr << "Unable to unmap EGL Image" << endl;
-        return -1;
+        NvBuffer *buffer = ctx->enc->output_plane.getNthBuffer(i);
+        NvBufSurface *nvbuf_surf = NULL;
+
+        invalidateEGLImage(buffer->planes[0].fd);
+        if (NvBufSurfaceFromFd(buffer->planes[0].fd, (void**)(&nvbuf_surf)) == 0 &&
+            nvbuf_surf->surfaceList[0].mappedAddr.eglImage != NULL)
+            NvBufSurfaceUnMapEglImage(nvbuf_surf, 0);
     }
     ctx->eglimg = NULL;
-
-    return 0;
 }
 
 /**
@@ -442,6 +455,12 @@ cleanup:
         error = 1;
     }
 
+    if (ctx.enc)
+    {
+        printEGLImageStats();
+        release_egl_images(&ctx);
+    }
+
     delete ctx.enc;
     delete ctx.in_file;
     delete ctx.out_file;
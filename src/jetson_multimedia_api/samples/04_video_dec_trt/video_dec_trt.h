@@ -74,7 +74,6 @@ typedef struct
     char output_path[256];
     CUeglFrame* eglFramePtr;
     CUgraphicsResource* pResource;
-    cudaStream_t* pStream_conversion;
     EGLImageKHR* egl_imagePtr;
     map<int, CUeglFrame> dma_egl_map;
     ofstream fstream;
@@ -66,6 +66,8 @@ printHelp(void)
             "\t ONNX model:\n"
             "\t--trt-onnxmodel      set onnx model file name, only support dynamic batch(N=-1) onnx model\n"
             "\t--trt-mode           0 fp16 (if supported), 1 fp32, 2 int8\n"
+            "\t--trt-cache-dir <dir>  directory of the TRT engine cache [Default = trt_engine_cache], \"\" to disable\n"
+            "\t--trt-cache-size <MB>  size limit of the TRT engine cache, 0 for no limit [Default = 1024]\n"
             "\t--trt-enable-perf    1[default] to enable perf measurement, 0 otherwise\n";
 }
 
@@ -166,6 +168,16 @@ parseCsvArgs(AppDecContext *ctx, AppTRTContext *trt_ctx_wrap,
             argp++;
             trt_ctx_wrap->trt_ctx->setMode(atoi(*argp));
         }
+        else if (!strcmp(arg, "--trt-cache-dir"))
+        {
+            argp++;
+            trt_ctx_wrap->trt_ctx->setEngineCacheDir(*argp);
+        }
+        else if (!strcmp(arg, "--trt-cache-size"))
+        {
+            argp++;
+            trt_ctx_wrap->trt_ctx->setEngineCacheSize(strtoull(*argp, NULL, 10) * 1024 * 1024);
+        }
         else if (!strcmp(arg, "--trt-enable-perf"))
         {
             if (*(argp + 1) != NULL &&
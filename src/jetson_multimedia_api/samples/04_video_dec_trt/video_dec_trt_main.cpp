@@ -127,7 +127,6 @@ resChange(AppDecContext * ctx)
     int32_t min_dec_capture_buffers;
     int ret = 0;
     int error = 0;
-    cudaError_t cu_error;
     CUresult status;
     // Get capture plane format from the decoder. This may change after
     // an resolution change event
@@ -206,7 +205,7 @@ resChange(AppDecContext * ctx)
         }
 
         ctx->pResource[i] = NULL;
-        cudaFree(0);
+        bindCudaContext();
         status = cuGraphicsEGLRegisterImage(&(ctx->pResource[i]), ctx->egl_imagePtr[i],
             CU_GRAPHICS_MAP_RESOURCE_FLAGS_NONE);
         if (status != CUDA_SUCCESS)
@@ -224,10 +223,6 @@ resChange(AppDecContext * ctx)
 
         ctx->dma_egl_map.insert(pair<int, CUeglFrame>(*(ctx->dst_dma_fd + i), ctx->eglFramePtr[i]));
     }
-    ctx->pStream_conversion = new cudaStream_t;
-    cu_error = cudaStreamCreateWithFlags(ctx->pStream_conversion, cudaStreamNonBlocking);
-    if(cu_error != 0)
-        cout<<"create streame failed"<<endl;
     // Capture plane STREAMON
     ret = dec->capture_plane.setStreamStatus(true);
     TEST_ERROR(ret < 0, "Error in decoder capture plane streamon", error);
@@ -486,13 +481,46 @@ loadImageToCudaInput(char* file_name, TRT_Context* trtCtx, void* cuda_buf)
 #endif
 
 
+// Conversion of one decoded frame into the TRT input batch
+typedef struct
+{
+    CUeglFrame eglFrame;
+    int width;
+    int height;
+    COLOR_FORMAT color_format;
+    void *cuda_buf;
+    void *offsets;
+    void *scales;
+} ConversionJob;
+
+static void
+convertFrameJob(void *stream, void *user)
+{
+    ConversionJob *job = (ConversionJob *) user;
+    cudaStream_t cuda_stream = (cudaStream_t) stream;
+
+    convertEglFrameIntToFloat(&job->eglFrame, job->width, job->height,
+                    job->color_format, job->cuda_buf,
+                    job->offsets, job->scales, &cuda_stream);
+}
+
 static bool
 extractdmabuf(AppTRTContext *ctx)
 {
+    NvCudaExecutor &executor = getCudaExecutor();
     AppDecContext *dec_ctx;
     void *cuda_buf = ctx->trt_ctx->getBuffer(0);
     int batch_offset;
-    int dma_buf_fd;
+    int dma_buf_fd[MAX_CHANNEL];
+    ConversionJob conversion[MAX_CHANNEL];
+    NvCudaJob job[MAX_CHANNEL];
+    bool submitted = true;
+
+    for (int i = 0; i < ctx->dec_num; i ++)
+    {
+        dma_buf_fd[i] = -1;
+        job[i] = 0;
+    }
 
     for (int i = 0; i < ctx->dec_num; i ++)
     {
@@ -505,11 +533,11 @@ extractdmabuf(AppTRTContext *ctx)
         {
             pthread_cond_wait(&dec_ctx->filled_queue_cond, &dec_ctx->filled_queue_lock);
         }
-        dma_buf_fd = dec_ctx->dec_output_filled_queue->front();
+        dma_buf_fd[i] = dec_ctx->dec_output_filled_queue->front();
         dec_ctx->dec_output_filled_queue->pop();
         pthread_mutex_unlock(&dec_ctx->filled_queue_lock);
 
-        if( dma_buf_fd == -1)
+        if( dma_buf_fd[i] == -1)
         {
             ctx->bLastframe[i] = 1;
             continue;
@@ -519,27 +547,44 @@ extractdmabuf(AppTRTContext *ctx)
                         ctx->trt_ctx->getNetHeight() * ctx->trt_ctx->getChannel();
 
         // map eglimage into GPU address
-        CUeglFrame eglFrame = dec_ctx->dma_egl_map.find(dma_buf_fd)->second;
-        convertEglFrameIntToFloat(&eglFrame,
-                    ctx->trt_ctx->getNetWidth(),
-                    ctx->trt_ctx->getNetHeight(),
-                    (TRT_MODEL == GOOGLENET_THREE_CLASS || TRT_MODEL == RESNET_THREE_CLASS) ? COLOR_FORMAT_BGR : COLOR_FORMAT_RGB,
-                    (char *)cuda_buf + batch_offset * sizeof(float),
-                    ctx->trt_ctx->getOffsets(),
-                    ctx->trt_ctx->getScales(),
-                    dec_ctx->pStream_conversion);
-
-        pthread_mutex_lock(&dec_ctx->empty_queue_lock);
-        dec_ctx->dec_output_empty_queue->push(dma_buf_fd);
-        pthread_cond_broadcast(&dec_ctx->empty_queue_cond);
-        pthread_mutex_unlock(&dec_ctx->empty_queue_lock);
+        conversion[i].eglFrame = dec_ctx->dma_egl_map.find(dma_buf_fd[i])->second;
+        conversion[i].width = ctx->trt_ctx->getNetWidth();
+        conversion[i].height = ctx->trt_ctx->getNetHeight();
+        conversion[i].color_format =
+            (TRT_MODEL == GOOGLENET_THREE_CLASS || TRT_MODEL == RESNET_THREE_CLASS) ? COLOR_FORMAT_BGR : COLOR_FORMAT_RGB;
+        conversion[i].cuda_buf = (char *)cuda_buf + batch_offset * sizeof(float);
+        conversion[i].offsets = ctx->trt_ctx->getOffsets();
+        conversion[i].scales = ctx->trt_ctx->getScales();
+
+        // The conversions of the batch run concurrently on the shared streams
+        job[i] = executor.submit(convertFrameJob, &conversion[i], CUDA_PRIORITY_HIGH);
+        if (job[i] == 0)
+        {
+            cerr << "Failed to submit conversion" << endl;
+            submitted = false;
+            break;
+        }
     }
 
+    /* The decoder reuses a buffer once the GPU is done reading it, and
+    ** the batch is complete before inference starts. On a failed submit
+    ** the buffers dequeued so far still go back to the decoder.
+    */
     for (int i = 0; i < ctx->dec_num; i ++)
     {
-        cudaStreamSynchronize(*(dec_ctx->pStream_conversion));
+        if (dma_buf_fd[i] == -1)
+            continue;
+
+        if (job[i])
+            executor.wait(job[i]);
+
+        dec_ctx = ctx->dec_context[i];
+        pthread_mutex_lock(&dec_ctx->empty_queue_lock);
+        dec_ctx->dec_output_empty_queue->push(dma_buf_fd[i]);
+        pthread_cond_broadcast(&dec_ctx->empty_queue_cond);
+        pthread_mutex_unlock(&dec_ctx->empty_queue_lock);
     }
-    return true;
+    return submitted;
 }
 
 static bool
@@ -645,6 +690,7 @@ trtThread(void *arg)
         gettimeofday(&output_time, NULL);
     }
     cout<<"Inference Performance(ms per batch):"<<iInferDuration / frameNUM <<" Wait from decode takes(ms per batch):"<< iWaitDuration /(frameNUM -1)<<endl;
+    getCudaExecutor().printStats("Conversion");
     for(int batch_th = 0; batch_th < ctx->dec_num; batch_th++)
     {
         AppDecContext* dec_ctx = ctx->dec_context[batch_th];
@@ -873,8 +919,6 @@ exit_decode(AppDecContext* ctx)
 
         free_dma_bufsurface(ctx->dst_dma_fd +i);
     }
-    cudaStreamDestroy(*(ctx->pStream_conversion));
-    delete ctx->pStream_conversion;
     delete []ctx->dst_dma_fd;
     delete []ctx->eglFramePtr;
     delete []ctx->pResource;
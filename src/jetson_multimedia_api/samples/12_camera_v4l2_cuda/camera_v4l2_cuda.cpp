@@ -540,19 +540,18 @@ cuda_postprocess(context_t *ctx, int fd)
         /* Create EGLImage from dmabuf fd */
         if (-1 == NvBufSurfaceFromFd(fd, (void**)(&pSurf)))
             ERROR_RETURN("Failed to get NvBufSurface from FD");
-        NvBufSurfaceMapEglImage(pSurf, 0);
+        if (pSurf->surfaceList[0].mappedAddr.eglImage == NULL)
+            NvBufSurfaceMapEglImage(pSurf, 0);
         ctx->egl_image = pSurf->surfaceList[0].mappedAddr.eglImage;
         if (ctx->egl_image == NULL)
             ERROR_RETURN("Failed to map dmabuf fd (0x%X) to EGLImage",
                     ctx->render_dmabuf_fd);
 
         /* Pass this buffer hooked on this egl_image to CUDA for
-           CUDA processing - draw a rectangle on the frame */
-        HandleEGLImage(&ctx->egl_image);
-
-        /* Destroy EGLImage */
-        NvBufSurfaceUnMapEglImage(pSurf, 0);
-        ctx->egl_image = NULL;
+           CUDA processing - draw a rectangle on the frame. The render
+           buffer is reused, so its EGLImage stays mapped and registered
+           with CUDA until cleanup. */
+        HandleEGLImage(&ctx->egl_image, fd);
     }
 
     return true;
@@ -742,6 +741,18 @@ cleanup:
     if (ctx.cam_fd > 0)
         close(ctx.cam_fd);
 
+    if (ctx.egl_image != NULL)
+    {
+        NvBufSurface *pSurf = NULL;
+
+        /* Drop the CUDA registration before the EGLImage */
+        printEGLImageStats();
+        invalidateEGLImage(ctx.render_dmabuf_fd);
+        if (NvBufSurfaceFromFd(ctx.render_dmabuf_fd, (void**)(&pSurf)) == 0)
+            NvBufSurfaceUnMapEglImage(pSurf, 0);
+        ctx.egl_image = NULL;
+    }
+
     if (ctx.renderer != NULL)
         delete ctx.renderer;
 
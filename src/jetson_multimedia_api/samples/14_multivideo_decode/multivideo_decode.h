@@ -34,8 +34,11 @@
 #include <semaphore.h>
 
 #include "NvBufSurface.h"
+#include "NvFrameChecksum.h"
+#include "NvDecoderCapturePool.h"
 
 #define MAX_BUFFERS 32
+#define CHECKSUM_BUFFERS 4
 
 typedef struct
 {
@@ -50,6 +53,11 @@ typedef struct
     char *out_file_path;
     std::ofstream *out_file;
 
+    char *checksum_file_path;
+    char *golden_checksum_path;
+    NvFrameChecksum *checksum;
+    int checksum_dma_fd[CHECKSUM_BUFFERS];
+
     bool disable_rendering;
     bool fullscreen;
     uint32_t window_height;
@@ -101,6 +109,10 @@ typedef struct
     int dst_dma_fd;
     int dmabuff_fd[MAX_BUFFERS];
     int numCapBuffers;
+    NvDecoderCapturePool *capture_pool; // Keeps the capture buffers across resolution changes
+    uint32_t max_cap_width;
+    uint32_t max_cap_height;
+    bool capture_padded; // Capture buffers larger than the stream
     int loop_count;
     int blocking_mode; // Set to true if running in blocking mode
 } context_t;
@@ -58,6 +58,10 @@ print_help(void)
 {
     cerr << "\nmultivideo_decode num_files <number_of_files> <file_name1> <in-format1> -o <out_filename1> "
             "<file_name2> <in-format2> -o <out_filename2> --disable-rendering [options] \n\n"
+            "Per file options, given after <in-format>:\n"
+            "\t-o <out-file>              Write to output file\n"
+            "\t--frame-checksum <file>    Write one CRC32C per plane of each decoded frame to <file> instead of raw YUV\n"
+            "\t--golden-checksum <file>   Compare each decoded frame against the checksums in <file>\n\n"
             "Supported formats:\n"
             "\tVP9\n"
             "\tVP8\n"
@@ -100,6 +104,8 @@ print_help(void)
             "\t-v4l2-memory-out-plane <num>       Specify memory type to be used on Output Plane [1 = V4L2_MEMORY_MMAP, 2 = V4L2_MEMORY_USERPTR], Default = V4L2_MEMORY_MMAP\n\n"
             "\t-v4l2-memory-cap-plane <num>       Specify memory type to be used on Capture Plane [1 = V4L2_MEMORY_MMAP, 2 = V4L2_MEMORY_DMABUF], Default = V4L2_MEMORY_DMABUF\n\n"
             "\t-s <loop-count>      Stress test [Default = 1]\n\n"
+            "\t-max_cap_width <width>    Allocate the capture plane buffers at least this wide, so that they are\n"
+            "\t-max_cap_height <height>  reused across resolution changes up to this size [Default = video size]\n\n"
             ;
 }
 
@@ -197,21 +203,32 @@ parse_csv_args(context_t ** ctx, int argc, char *argv[], int num_files)
         argc--;
         CSV_PARSE_CHECK_ERROR((argc == 0),
                                   "--disable-rendering not specified");
-        if (!strcmp(arg, "-o"))
+        while (arg && (!strcmp(arg, "-o") || !strcmp(arg, "--frame-checksum") ||
+                       !strcmp(arg, "--golden-checksum")))
         {
             argp++;
             CHECK_OPTION_VALUE(argp);
-            ctx[i]->out_file_path = strdup(*argp);
-            CSV_PARSE_CHECK_ERROR(!ctx[i]->out_file_path,
-                                  "Output file not specified");
-        }
-        else
-        {
-            argp--;
-            argc++;
+            if (!strcmp(arg, "-o"))
+            {
+                ctx[i]->out_file_path = strdup(*argp);
+                CSV_PARSE_CHECK_ERROR(!ctx[i]->out_file_path,
+                                      "Output file not specified");
+            }
+            else if (!strcmp(arg, "--frame-checksum"))
+            {
+                ctx[i]->checksum_file_path = strdup(*argp);
+                CSV_PARSE_CHECK_ERROR(!ctx[i]->checksum_file_path,
+                                      "Checksum file not specified");
+            }
+            else
+            {
+                ctx[i]->golden_checksum_path = strdup(*argp);
+                CSV_PARSE_CHECK_ERROR(!ctx[i]->golden_checksum_path,
+                                      "Golden checksum file not specified");
+            }
+            arg = *(++argp);
+            argc--;
         }
-        argp++;
-        argc--;
     }
 
     argp--;
@@ -262,6 +279,20 @@ parse_csv_args(context_t ** ctx, int argc, char *argv[], int num_files)
                                       "Window width should be > 0");
                 CHECK_IF_LAST_LOOP(i, num_files, argp, 1);
             }
+            else if (!strcmp(arg, "-max_cap_width"))
+            {
+                argp++;
+                CHECK_OPTION_VALUE(argp);
+                ctx[i]->max_cap_width = atoi(*argp);
+                CHECK_IF_LAST_LOOP(i, num_files, argp, 1);
+            }
+            else if (!strcmp(arg, "-max_cap_height"))
+            {
+                argp++;
+                CHECK_OPTION_VALUE(argp);
+                ctx[i]->max_cap_height = atoi(*argp);
+                CHECK_IF_LAST_LOOP(i, num_files, argp, 1);
+            }
             else if (!strcmp(arg, "-wx"))
             {
                 argp++;
@@ -411,6 +411,42 @@ report_metadata(context_t *ctx, v4l2_ctrl_videodec_outputbuf_metadata *metadata)
     }
 }
 
+/**
+  * Capture pool allocator: format packs the layout above the color format.
+  */
+static int
+capture_pool_allocate(uint32_t width, uint32_t height, uint32_t format,
+                      uint32_t count, int *fds, void *arg)
+{
+    NvBufSurf::NvCommonAllocateParams params;
+
+    params.memType = NVBUF_MEM_SURFACE_ARRAY;
+    params.width = width;
+    params.height = height;
+    params.layout = (NvBufSurfaceLayout) (format >> 16);
+    params.colorFormat = (NvBufSurfaceColorFormat) (format & 0xffff);
+    params.memtag = NvBufSurfaceTag_VIDEO_DEC;
+
+    return NvBufSurf::NvAllocate(&params, count, fds);
+}
+
+static int
+capture_pool_destroy(int fd, void *arg)
+{
+    return NvBufSurf::NvDestroy(fd);
+}
+
+/**
+  * Whether --stats renders the capture buffers as they are. Pooled buffers
+  * larger than the stream would show their padding, so those are rendered
+  * from the transform to dst_dma_fd instead.
+  */
+static bool
+render_capture_directly(context_t *ctx)
+{
+    return ctx->stats && !ctx->capture_padded;
+}
+
 /**
   * Query and Set Capture plane.
   *
@@ -468,6 +504,25 @@ query_and_set_capture(context_t * ctx)
     ret = NvBufSurf::NvAllocate(&params, 1, &ctx->dst_dma_fd);
     TEST_ERROR(ret == -1, "create dmabuf failed", error);
 
+    if (ctx->checksum)
+    {
+        /* Reallocate the checksum buffers once the pending frames are hashed. */
+        ctx->checksum->clearBuffers();
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+        {
+            if (ctx->checksum_dma_fd[index] != -1)
+            {
+                ret = NvBufSurf::NvDestroy(ctx->checksum_dma_fd[index]);
+                ctx->checksum_dma_fd[index] = -1;
+                TEST_ERROR(ret < 0, "Error: Error in BufferDestroy", error);
+            }
+        }
+        ret = NvBufSurf::NvAllocate(&params, CHECKSUM_BUFFERS, ctx->checksum_dma_fd);
+        TEST_ERROR(ret == -1, "create checksum dmabuf failed", error);
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+            ctx->checksum->addBuffer(ctx->checksum_dma_fd[index]);
+    }
+
     if (!ctx->disable_rendering)
     {
         /* Destroy the old instance of renderer as resolution might have changed */
@@ -511,19 +566,10 @@ query_and_set_capture(context_t * ctx)
         ctx->renderer->setFPS(ctx->fps);
     }
 
-    /* deinitPlane unmaps the buffers and calls REQBUFS with count 0 */
+    /* deinitPlane unmaps the buffers and calls REQBUFS with count 0.
+       The DMABUF buffers stay in the capture pool, which reuses them
+       below if the new resolution fits. */
     dec->capture_plane.deinitPlane();
-    if(ctx->capture_plane_mem_type == V4L2_MEMORY_DMABUF)
-    {
-        for(int index = 0 ; index < ctx->numCapBuffers ; index++)
-        {
-            if(ctx->dmabuff_fd[index] != 0)
-            {
-                ret = NvBufSurf::NvDestroy(ctx->dmabuff_fd[index]);
-                TEST_ERROR(ret < 0, "Error: Error in BufferDestroy", error);
-            }
-        }
-    }
 
     /* Not necessary to call VIDIOC_S_FMT on decoder capture plane.
        But decoder setCapturePlaneFormat function updates the class variables */
@@ -613,8 +659,27 @@ query_and_set_capture(context_t * ctx)
         capParams.layout = NVBUF_LAYOUT_BLOCK_LINEAR;
         capParams.memtag = NvBufSurfaceTag_VIDEO_DEC;
         capParams.colorFormat = pix_format;
-        ret = NvBufSurf::NvAllocate(&capParams, ctx->numCapBuffers, ctx->dmabuff_fd);
+
+        if (!ctx->capture_pool)
+        {
+            NvDecoderCapturePoolOps ops;
+
+            ops.allocate = capture_pool_allocate;
+            ops.destroy = capture_pool_destroy;
+            ops.arg = ctx;
+            ctx->capture_pool = new NvDecoderCapturePool(ctx->in_file_path, ops,
+                    ctx->max_cap_width, ctx->max_cap_height, MAX_BUFFERS);
+        }
+
+        /* Buffers larger than the crop are fine: the transform only reads
+           the display rectangle, and --stats renders padded buffers
+           through it. */
+        ret = ctx->capture_pool->configure(capParams.width, capParams.height,
+                (capParams.layout << 16) | capParams.colorFormat, ctx->numCapBuffers);
         TEST_ERROR(ret < 0, "Failed to create buffers", error);
+        for (int index = 0; index < ctx->numCapBuffers; index++)
+            ctx->dmabuff_fd[index] = ctx->capture_pool->getFd(index);
+        ctx->capture_padded = ctx->capture_pool->isPadded();
 
         /* Request buffers on decoder capture plane.
            Refer ioctl VIDIOC_REQBUFS */
@@ -813,7 +878,7 @@ dec_capture_loop_fcn(void *arg)
                       v4l2_buf.timestamp.tv_usec << "us]" << endl;
             }
 
-            if (!ctx->disable_rendering && ctx->stats)
+            if (!ctx->disable_rendering && render_capture_directly(ctx))
             {
                 /* EglRenderer requires the fd of the 0th plane to render the buffer. */
                 if(ctx->capture_plane_mem_type == V4L2_MEMORY_DMABUF)
@@ -824,7 +889,7 @@ dec_capture_loop_fcn(void *arg)
              /* If we need to write to file or display the buffer, give
                the buffer to video converter output plane instead of
                returning the buffer back to decoder capture plane. */
-            if (ctx->out_file || (!ctx->disable_rendering && !ctx->stats))
+            if (ctx->out_file || ctx->checksum || (!ctx->disable_rendering && !render_capture_directly(ctx)))
             {
                 /* Clip & Stitch can be done by adjusting rectangle */
                 NvBufSurf::NvCommonTransformParams transform_params;
@@ -842,12 +907,43 @@ dec_capture_loop_fcn(void *arg)
 
                 if(ctx->capture_plane_mem_type == V4L2_MEMORY_DMABUF)
                     dec_buffer->planes[0].fd = ctx->dmabuff_fd[v4l2_buf.index];
+
+                if (ctx->checksum)
+                {
+                    /* Convert into a free checksum buffer, which is hashed on
+                       the checksum thread while decoding continues. */
+                    int checksum_fd = ctx->checksum->getBuffer();
+                    if (checksum_fd < 0)
+                    {
+                        cerr << "No checksum buffer available" << endl;
+                        ret = -1;
+                        break;
+                    }
+                    ret = NvBufSurf::NvTransform(&transform_params, dec_buffer->planes[0].fd, checksum_fd);
+                    if (ret == -1)
+                    {
+                        ctx->checksum->addBuffer(checksum_fd);
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
+                    ret = ctx->checksum->queueBuffer(checksum_fd, ctx->out_pixfmt == 2 ? 3 : 2);
+                    if (ret == -1)
+                    {
+                        ctx->checksum->addBuffer(checksum_fd);
+                        cerr << "Error queueing checksum buffer" << endl;
+                        break;
+                    }
+                }
+
                 /* Perform Blocklinear to PitchLinear conversion. */
-                ret = NvBufSurf::NvTransform(&transform_params, dec_buffer->planes[0].fd, ctx->dst_dma_fd);
-                if (ret == -1)
+                if (ctx->out_file || (!ctx->disable_rendering && !render_capture_directly(ctx)))
                 {
-                    cerr << "Transform failed" << endl;
-                    break;
+                    ret = NvBufSurf::NvTransform(&transform_params, dec_buffer->planes[0].fd, ctx->dst_dma_fd);
+                    if (ret == -1)
+                    {
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
                 }
 
                 /* Write raw video frame to file */
@@ -862,7 +958,7 @@ dec_capture_loop_fcn(void *arg)
                     }
                 }
 
-                if (!ctx->stats && !ctx->disable_rendering)
+                if (!render_capture_directly(ctx) && !ctx->disable_rendering)
                 {
                     ctx->renderer->render(ctx->dst_dma_fd);
                 }
@@ -935,6 +1031,8 @@ set_defaults(context_t ** ctx,fps_stats **stream_stats)
         ctx[i]->file_count = 1;
         ctx[i]->dec_fps = 30;
         ctx[i]->dst_dma_fd = -1;
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+            ctx[i]->checksum_dma_fd[index] = -1;
         ctx[i]->loop_count = 0;
         ctx[i]->blocking_mode = 1;
         pthread_mutex_init(&ctx[i]->queue_lock, NULL);
@@ -1169,7 +1267,7 @@ check_capture_buffers:
                       "us]" << endl;
             }
 
-            if (!ctx.disable_rendering && ctx.stats)
+            if (!ctx.disable_rendering && render_capture_directly(&ctx))
             {
                 /* Rendering the buffer.
                    NOTE: EglRenderer requires the fd of the 0th plane to render the buffer. */
@@ -1185,7 +1283,7 @@ check_capture_buffers:
             }
 
             /* Get the decoded buffer data dumped to file. */
-            if (ctx.out_file || (!ctx.disable_rendering && !ctx.stats))
+            if (ctx.out_file || ctx.checksum || (!ctx.disable_rendering && !render_capture_directly(&ctx)))
             {
                 NvBufSurf::NvCommonTransformParams transform_params;
                 transform_params.src_top = 0;
@@ -1202,12 +1300,43 @@ check_capture_buffers:
 
                 if(ctx.capture_plane_mem_type == V4L2_MEMORY_DMABUF)
                     capture_buffer->planes[0].fd = ctx.dmabuff_fd[v4l2_capture_buf.index];
+
+                if (ctx.checksum)
+                {
+                    /* Convert into a free checksum buffer, which is hashed on
+                       the checksum thread while decoding continues. */
+                    int checksum_fd = ctx.checksum->getBuffer();
+                    if (checksum_fd < 0)
+                    {
+                        cerr << "No checksum buffer available" << endl;
+                        ret = -1;
+                        break;
+                    }
+                    ret = NvBufSurf::NvTransform(&transform_params, capture_buffer->planes[0].fd, checksum_fd);
+                    if (ret == -1)
+                    {
+                        ctx.checksum->addBuffer(checksum_fd);
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
+                    ret = ctx.checksum->queueBuffer(checksum_fd, ctx.out_pixfmt == 2 ? 3 : 2);
+                    if (ret == -1)
+                    {
+                        ctx.checksum->addBuffer(checksum_fd);
+                        cerr << "Error queueing checksum buffer" << endl;
+                        break;
+                    }
+                }
+
                 /* Perform Blocklinear to PitchLinear conversion. */
-                ret = NvBufSurf::NvTransform(&transform_params, capture_buffer->planes[0].fd, ctx.dst_dma_fd);
-                if (ret == -1)
+                if (ctx.out_file || (!ctx.disable_rendering && !render_capture_directly(&ctx)))
                 {
-                    cerr << "Transform failed" << endl;
-                    break;
+                    ret = NvBufSurf::NvTransform(&transform_params, capture_buffer->planes[0].fd, ctx.dst_dma_fd);
+                    if (ret == -1)
+                    {
+                        cerr << "Transform failed" << endl;
+                        break;
+                    }
                 }
 
                 /* Write raw video frame to file */
@@ -1222,7 +1351,7 @@ check_capture_buffers:
                         dump_dmabuf(ctx.dst_dma_fd, 2, ctx.out_file);
                     }
                 }
-                if (!ctx.stats && !ctx.disable_rendering)
+                if (!render_capture_directly(&ctx) && !ctx.disable_rendering)
                 {
                     ctx.renderer->render(ctx.dst_dma_fd);
                 }
@@ -1488,6 +1617,16 @@ decode_proc(void * p_ctx)
                    cleanup);
     }
 
+    /* Start the checksum thread; its buffers are allocated with the
+       capture plane. */
+    if (ctx.checksum_file_path || ctx.golden_checksum_path)
+    {
+        ctx.checksum = new NvFrameChecksum(NvFrameChecksum::getSurfaceOps());
+        TEST_ERROR(ctx.checksum->open(ctx.checksum_file_path,
+                   ctx.golden_checksum_path) < 0,
+                   "Error opening checksum files", cleanup);
+    }
+
     /* Start stream processing on decoder output-plane.
        Refer ioctl VIDIOC_STREAMON */
     ret = ctx.dec->output_plane.setStreamStatus(true);
@@ -1674,22 +1813,34 @@ cleanup:
         {
             ctx.renderer->printProfilingStats(cout);
         }
+        if (ctx.capture_pool)
+        {
+            ctx.capture_pool->printStats(cout);
+        }
     }
 
-    if(ctx.capture_plane_mem_type == V4L2_MEMORY_DMABUF)
+    if (ctx.checksum)
     {
-        for(int index = 0 ; index < ctx.numCapBuffers ; index++)
+        /* Wait for the pending frames and report the golden comparison. */
+        cout << ctx.in_file_path << ": ";
+        if (ctx.checksum->close() < 0)
         {
-            if(ctx.dmabuff_fd[index] != 0)
+            cerr << "Frame checksum verification failed for " << ctx.in_file_path << endl;
+            error = 1;
+        }
+        delete ctx.checksum;
+        for (int index = 0; index < CHECKSUM_BUFFERS; index++)
+        {
+            if (ctx.checksum_dma_fd[index] != -1)
             {
-                ret = NvBufSurf::NvDestroy(ctx.dmabuff_fd[index]);
-                if(ret < 0)
-                {
-                    cerr << "Failed to Destroy NvBuffer" << endl;
-                }
+                NvBufSurf::NvDestroy(ctx.checksum_dma_fd[index]);
+                ctx.checksum_dma_fd[index] = -1;
             }
         }
     }
+
+    delete ctx.capture_pool;
+    ctx.capture_pool = NULL;
     if (ctx.dec && ctx.dec->isInError())
     {
         cerr << "Decoder is in error" << endl;
@@ -1722,6 +1873,8 @@ cleanup:
     delete[] nalu_parse_buffer;
     free (ctx.in_file_path);
     free (ctx.out_file_path);
+    free (ctx.checksum_file_path);
+    free (ctx.golden_checksum_path);
     if (!ctx.blocking_mode)
     {
         sem_destroy(&ctx.pollthread_sema);
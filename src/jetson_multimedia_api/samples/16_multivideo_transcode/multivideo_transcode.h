@@ -35,11 +35,15 @@
 #include <semaphore.h>
 
 #include "NvBufSurface.h"
+#include "NvBufferFanout.h"
 
 #define CRC32_POLYNOMIAL  0xEDB88320L
 #define MAX_BUFFERS 32
 #define NUM_ENCODER_OUTPUT_BUFFERS 6
 #define CHUNK_SIZE 4000000
+#define MAX_LADDER_RUNGS 8
+#define NUM_LADDER_BUFFERS 6
+#define DEFAULT_LADDER_DEPTH 2
 
 #define IVF_FILE_HDR_SIZE   32
 #define IVF_FRAME_HDR_SIZE  12
@@ -89,6 +93,27 @@ typedef struct CrcRec
     uint32_t CrcValue;
 }Crc;
 
+/**
+ * One rendition of the ABR ladder: a scaler and an encoder fed with the
+ * decoder capture buffers through the context's NvBufferFanout.
+ */
+typedef struct
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t bitrate;
+    NvFanoutPolicy policy;          /* Applied when the rung falls behind */
+    uint32_t branch_id;             /* NvBufferFanout branch of the rung */
+    NvVideoEncoder *enc;
+    std::ofstream *out_file;
+    int dmabuff_fd[MAX_BUFFERS];    /* Scaled buffers, encoder output plane */
+    uint32_t num_buffers;
+    uint64_t encoded_frames;
+    uint64_t encoded_bytes;
+    pthread_t scale_thread;
+    void *ctx;                      /* Parent context_t */
+} ladder_rung_t;
+
 typedef struct
 {
     NvVideoEncoder *enc;
@@ -189,6 +214,13 @@ typedef struct
     pthread_t dec_capture_loop;
     pthread_t transcode_thread;
     pthread_t buffer_refill;
+    uint32_t num_rungs; // ABR ladder renditions, 0 if ladder mode is disabled
+    ladder_rung_t rungs[MAX_LADDER_RUNGS];
+    uint32_t ladder_depth;
+    NvBufferFanout *fanout; // Shares the decoder capture buffers between rungs
+    bool ladder_started;
+    uint64_t ladder_timestamp[MAX_BUFFERS]; // Timestamp of each decoder buffer, in usec
+    uint64_t decoded_frames;
 } context_t;
 
 typedef struct
@@ -116,6 +116,15 @@ print_help(void)
             "\t-MaxQpP               Specify maximum Qp Value for P frame\n"
             "\t-MinQpB               Specify minimum Qp Value for B frame\n"
             "\t-MaxQpB               Specify maximum Qp Value for B frame\n\n"
+            "ABR LADDER OPTIONS:\n"
+            "\t--ladder <W>x<H>:<bitrate>[:drop][,<W>x<H>:<bitrate>[:drop]...]\n"
+            "\t                      Decode once and encode one rendition per rung, written to\n"
+            "\t                      <out-file>_<W>x<H>.<ext> [Default = disabled]\n"
+            "\t                      A rung that falls behind slows the decoder down, or with\n"
+            "\t                      :drop skips frames itself\n"
+            "\t--ladder-depth <num>  Decoded frames queued to each rung [Default = 2]\n"
+            "NOTE: Run the same input N times with num_files N to compare the ladder with\n"
+            "      N independent transcodes.\n\n"
             "NOTE: \n"
             "Supported Encoding profiles for H.264:\n"
             "\tbaseline\tmain\thigh\n"
@@ -448,6 +457,51 @@ get_h265_encoder_level(char *arg)
     return -1;
 }
 
+static int
+parse_ladder(context_t *ctx, char *arg)
+{
+    char *saveptr = NULL;
+    char *rung_str;
+
+    ctx->num_rungs = 0;
+    for (rung_str = strtok_r(arg, ",", &saveptr); rung_str;
+         rung_str = strtok_r(NULL, ",", &saveptr))
+    {
+        ladder_rung_t *rung;
+        int len = 0;
+
+        if (ctx->num_rungs == MAX_LADDER_RUNGS)
+        {
+            cerr << "Error: at most " << MAX_LADDER_RUNGS << " ladder rungs are supported" << endl;
+            return -1;
+        }
+        rung = &ctx->rungs[ctx->num_rungs];
+        if (sscanf(rung_str, "%ux%u:%u%n", &rung->width, &rung->height,
+                   &rung->bitrate, &len) != 3 || !rung->width || !rung->height ||
+            !rung->bitrate || (rung->width & 1) || (rung->height & 1))
+        {
+            cerr << "Error: invalid ladder rung " << rung_str << endl;
+            return -1;
+        }
+        if (!strcmp(rung_str + len, ":drop"))
+        {
+            rung->policy = NV_FANOUT_POLICY_DROP;
+        }
+        else if (rung_str[len] == '\0')
+        {
+            rung->policy = NV_FANOUT_POLICY_BLOCK;
+        }
+        else
+        {
+            cerr << "Error: invalid ladder rung policy " << rung_str + len << endl;
+            return -1;
+        }
+        ctx->num_rungs++;
+    }
+
+    return ctx->num_rungs ? 0 : -1;
+}
+
 static int32_t
 get_dbg_level(char *arg)
 {
@@ -928,6 +982,26 @@ parse_csv_args(context_t ** ctx, int argc, char *argv[], int num_files)
                 ctx[i]->poc_type = atoi(*argp);
                 CHECK_IF_LAST_LOOP(i, num_files, argp, 1);
             }
+            else if (!strcmp(arg, "--ladder"))
+            {
+                argp++;
+                CHECK_OPTION_VALUE(argp);
+                /* strtok_r modifies the string, parse a copy per instance. */
+                char *ladder_str = strdup(*argp);
+                int ladder_ret = parse_ladder(ctx[i], ladder_str);
+                free(ladder_str);
+                CSV_PARSE_CHECK_ERROR(ladder_ret < 0, "Invalid ladder " << *argp);
+                CHECK_IF_LAST_LOOP(i, num_files, argp, 1);
+            }
+            else if (!strcmp(arg, "--ladder-depth"))
+            {
+                argp++;
+                CHECK_OPTION_VALUE(argp);
+                ctx[i]->ladder_depth = atoi(*argp);
+                CSV_PARSE_CHECK_ERROR(ctx[i]->ladder_depth == 0 ||
+                    ctx[i]->ladder_depth > MAX_BUFFERS / 2, "Invalid ladder depth");
+                CHECK_IF_LAST_LOOP(i, num_files, argp, 1);
+            }
             else
             {
                 CSV_PARSE_CHECK_ERROR(ctx[i]->out_file_path, "Unknown option " << arg);
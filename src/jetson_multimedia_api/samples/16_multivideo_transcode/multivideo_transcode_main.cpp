@@ -52,7 +52,21 @@ static void
 abort(context_t *ctx)
 {
     ctx->got_error = true;
-    ctx->enc->abort();
+    if (ctx->enc)
+    {
+        ctx->enc->abort();
+    }
+    for (uint32_t r = 0; r < ctx->num_rungs; r++)
+    {
+        if (ctx->rungs[r].enc)
+        {
+            ctx->rungs[r].enc->abort();
+        }
+    }
+    if (ctx->fanout)
+    {
+        ctx->fanout->abort();
+    }
     ctx->dec->abort();
 }
 
@@ -797,7 +811,7 @@ set_defaults(context_t ** ctx, fps_stats **stream_stats, int files )
         ctx[i] = (context_t *) malloc(sizeof(context_t));
         stream_stats[i] = (fps_stats *)malloc(sizeof(fps_stats));
         memset(ctx[i], 0, sizeof(context_t));
-        memset(stream_stats[i], 0 , sizeof(stream_stats));
+        memset(stream_stats[i], 0 , sizeof(fps_stats));
         ctx[i]->thread_num = i;
         ctx[i]->in_file_path = NULL;
         ctx[i]->out_file_path = NULL;
@@ -844,6 +858,8 @@ set_defaults(context_t ** ctx, fps_stats **stream_stats, int files )
         ctx[i]->num_frames_to_encode = -1;
         ctx[i]->poc_type = 0;
         ctx[i]->stop_refill = 0;
+        ctx[i]->num_rungs = 0;
+        ctx[i]->ladder_depth = DEFAULT_LADDER_DEPTH;
     }
 }
 
@@ -933,139 +949,30 @@ buffer_refil(void *arg)
 }
 
 /**
-  * Query and Set Capture plane.
+  * Set the encoder formats and encoding parameters.
   *
-  * @param ctx : Transcoder context
+  * @param ctx     : Transcoder context
+  * @param enc     : Encoder to configure
+  * @param width   : Encoded width
+  * @param height  : Encoded height
+  * @param bitrate : Encoded bitrate
   */
-static void
-query_and_set_capture(context_t * ctx)
+static int
+set_encoder_params(context_t *ctx, NvVideoEncoder *enc, uint32_t width,
+                   uint32_t height, uint32_t bitrate)
 {
-    NvVideoDecoder *dec = ctx->dec;
-    NvVideoEncoder *enc = ctx->enc;
-    struct v4l2_format format;
-    struct v4l2_crop crop;
-    int32_t min_dec_capture_buffers;
     int ret = 0;
     int error = 0;
-    NvBufSurf::NvCommonAllocateParams cParams = {0};
-
-    /* Get capture plane format from the decoder.
-       This may change after resolution change event.
-       Refer ioctl VIDIOC_G_FMT */
-    ret = dec->capture_plane.getFormat(format);
-    TEST_ERROR(ret < 0,
-               "Error: Could not get format from decoder capture plane", error);
-
-     ret = dec->capture_plane.getCrop(crop);
-    TEST_ERROR(ret < 0,
-               "Error: Could not get crop from decoder capture plane", error);
-
-    cout << "Video Resolution: " << crop.c.width << "x" << crop.c.height;
-
-    /* deinitPlane unmaps the buffers and calls REQBUFS with count 0 */
-    dec->capture_plane.deinitPlane();
-
-    enc->output_plane.deinitPlane();
-
-    enc->capture_plane.deinitPlane();
-
-    ctx->height = crop.c.height;
-    ctx->width = crop.c.width;
-    ctx->raw_pixfmt = format.fmt.pix_mp.pixelformat;
-    /* Not necessary to call VIDIOC_S_FMT on decoder capture plane.
-       But decoder setCapturePlaneFormat function updates the class variables */
-    ret = dec->setCapturePlaneFormat(ctx->raw_pixfmt,
-                                     ctx->width,
-                                     ctx->height);
-    TEST_ERROR(ret < 0, "Error in setting decoder capture plane format", error);
-
-    /* Get the minimum buffers which have to be requested on the capture plane. */
-    ret = dec->getMinimumCapturePlaneBuffers(min_dec_capture_buffers);
-    TEST_ERROR(ret < 0,
-               "Error while getting value of minimum capture plane buffers",
-               error);
-
-    /* Request, Query and export decoder capture plane buffers.
-       Refer ioctl VIDIOC_REQBUFS, VIDIOC_QUERYBUF and VIDIOC_EXPBUF */
-    if (ctx->dec_capture_plane_mem_type == V4L2_MEMORY_DMABUF)
-    {
-        /* Set colorformats for relevant colorspaces. */
-        switch(format.fmt.pix_mp.colorspace)
-        {
-            case V4L2_COLORSPACE_SMPTE170M:
-                if (format.fmt.pix_mp.quantization == V4L2_QUANTIZATION_DEFAULT)
-                {
-                    cout << "Decoder colorspace ITU-R BT.601 with standard range luma (16-235)" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12;
-                }
-                else
-                {
-                    cout << "Decoder colorspace ITU-R BT.601 with extended range luma (0-255)" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_ER;
-                }
-                break;
-            case V4L2_COLORSPACE_REC709:
-                if (format.fmt.pix_mp.quantization == V4L2_QUANTIZATION_DEFAULT)
-                {
-                    cout << "Decoder colorspace ITU-R BT.709 with standard range luma (16-235)" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_709;
-                }
-                else
-                {
-                    cout << "Decoder colorspace ITU-R BT.709 with extended range luma (0-255)" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_709_ER;
-                }
-                break;
-            case V4L2_COLORSPACE_BT2020:
-                {
-                    cout << "Decoder colorspace ITU-R BT.2020" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_2020;
-                }
-                break;
-            default:
-                cout << "supported colorspace details not available, use default" << endl;
-                if (format.fmt.pix_mp.quantization == V4L2_QUANTIZATION_DEFAULT)
-                {
-                    cout << "Decoder colorspace ITU-R BT.601 with standard range luma (16-235)" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12;
-                }
-                else
-                {
-                    cout << "Decoder colorspace ITU-R BT.601 with extended range luma (0-255)" << endl;
-                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_ER;
-                }
-                break;
-        }
-
-        ctx->num_cap_buffers = min_dec_capture_buffers + ctx->extra_cap_plane_buffer;
-
-        /* Create decoder capture plane buffers. */
-        for (int index = 0; index < ctx->num_cap_buffers; index++)
-        {
-            cParams.width = ctx->width;
-            cParams.height = ctx->height;
-            cParams.layout = NVBUF_LAYOUT_BLOCK_LINEAR;
-            cParams.memType = NVBUF_MEM_SURFACE_ARRAY;
-            cParams.memtag = NvBufSurfaceTag_VIDEO_DEC;
-            ret = NvBufSurf::NvAllocate(&cParams, 1, &ctx->dmabuff_fd[index]);
-            TEST_ERROR(ret < 0, "Failed to create buffers", error);
-        }
-
-        /* Request buffers on decoder capture plane.
-           Refer ioctl VIDIOC_REQBUFS */
-        ret = dec->capture_plane.reqbufs(ctx->dec_capture_plane_mem_type, ctx->num_cap_buffers);
-            TEST_ERROR(ret, "Error in request buffers on capture plane", error);
-    }
 
-    ret = enc->setCapturePlaneFormat(ctx->encoder_pixfmt, ctx->width,
-                                         ctx->height, 2 * 1024 * 1024);
+    ret = enc->setCapturePlaneFormat(ctx->encoder_pixfmt, width,
+                                         height, 2 * 1024 * 1024);
     TEST_ERROR(ret < 0, "Could not set encoder capture plane format", error);
 
-    ret = enc->setOutputPlaneFormat(ctx->raw_pixfmt, ctx->width,
-                                      ctx->height);
+    ret = enc->setOutputPlaneFormat(ctx->raw_pixfmt, width,
+                                      height);
     TEST_ERROR(ret < 0, "Could not set encoder output plane format", error);
 
-    ret = enc->setBitrate(ctx->bitrate);
+    ret = enc->setBitrate(bitrate);
     TEST_ERROR(ret < 0, "Could not set encoder bitrate", error);
 
     if (ctx->encoder_pixfmt == V4L2_PIX_FMT_H264)
@@ -1111,9 +1018,9 @@ query_and_set_capture(context_t * ctx)
         if (ctx->ratecontrol == V4L2_MPEG_VIDEO_BITRATE_MODE_VBR)
         {
             uint32_t peak_bitrate;
-            if (ctx->peak_bitrate < ctx->bitrate)
+            if (ctx->peak_bitrate < bitrate)
             {
-                peak_bitrate = 1.2f * ctx->bitrate;
+                peak_bitrate = 1.2f * bitrate;
             }
             else
             {
@@ -1310,115 +1217,631 @@ query_and_set_capture(context_t * ctx)
     ret = enc->setFrameRate(ctx->fps_n, ctx->fps_d);
     TEST_ERROR(ret < 0, "Could not set framerate", error);
 
-    /*  Set encoder output plane */
-    ret = enc->output_plane.reqbufs(ctx->enc_output_memory_type, ctx->num_cap_buffers);
-    TEST_ERROR(ret < 0,"reqbufs failed for output plane V4L2_MEMORY_DMABUF", error);
-
-     ret = enc->capture_plane.setupPlane(ctx->enc_capture_memory_type, ctx->num_output_buffers,
-        true, false);
-    TEST_ERROR(ret < 0, "Could not setup capture plane", error);
-
-    /* Subscibe for End Of Stream event */
-    ret = enc->subscribeEvent(V4L2_EVENT_EOS,0,0);
-    TEST_ERROR(ret < 0, "Could not subscribe EOS event", error);
-
-    /* Decoder capture plane STREAMON.
-       Refer ioctl VIDIOC_STREAMON */
-
-    ret = dec->capture_plane.setStreamStatus(true);
-    TEST_ERROR(ret < 0, "Error in decoder capture plane streamon", error);
-
-     /* set encoder output plane STREAMON */
-    ret = enc->output_plane.setStreamStatus(true);
-    TEST_ERROR(ret < 0, "Error in output plane streamon", error);
-
-    /* set encoder capture plane STREAMON */
-    ret = enc->capture_plane.setStreamStatus(true);
-    TEST_ERROR(ret < 0, "Error in capture plane streamon", error);
+    return 0;
 
-    /* Set encoder capture plane dq thread callback for blocking io mode */
-    enc->capture_plane.setDQThreadCallback(encoder_capture_plane_dq_callback);
+error:
+    return -error;
+}
 
-    /* startDQThread starts a thread internally which calls the
-       encoder_capture_plane_dq_callback whenever a buffer is dequeued
-       on the plane */
-    enc->capture_plane.startDQThread(ctx);
+/**
+  * Queue a decoder capture buffer back once all the ladder rungs
+  * released it.
+  *
+  * @param index : Decoder capture buffer index
+  * @param arg   : Transcoder context
+  */
+static void
+ladder_recycle_callback(uint32_t index, void *arg)
+{
+    context_t *ctx = (context_t *) arg;
+    struct v4l2_buffer v4l2_buf;
+    struct v4l2_plane planes[MAX_PLANES];
 
-    pthread_create(&ctx->buffer_refill, NULL, buffer_refil, ctx);
+    memset(&v4l2_buf, 0, sizeof(v4l2_buf));
+    memset(planes, 0, sizeof(planes));
 
-    /* Enqueue all the empty encoder capture plane buffers. */
-    for (uint32_t i = 0; i < enc->capture_plane.getNumBuffers(); i++)
+    v4l2_buf.index = index;
+    v4l2_buf.m.planes = planes;
+    v4l2_buf.memory = ctx->dec_capture_plane_mem_type;
+    if (ctx->dec_capture_plane_mem_type == V4L2_MEMORY_DMABUF)
     {
-        struct v4l2_buffer v4l2_buf;
-        struct v4l2_plane planes[MAX_PLANES];
+        v4l2_buf.m.planes[0].m.fd = ctx->dmabuff_fd[index];
+    }
 
-        memset(&v4l2_buf, 0, sizeof(v4l2_buf));
-        memset(planes, 0, MAX_PLANES * sizeof(struct v4l2_plane));
+    if (ctx->dec->capture_plane.qBuffer(v4l2_buf, NULL) < 0)
+    {
+        cerr << "Error while queueing buffer at decoder capture plane" << endl;
+        abort(ctx);
+    }
+}
 
-        v4l2_buf.index = i;
-        v4l2_buf.m.planes = planes;
+/**
+  * Ladder rung encoder capture-plane deque buffer callback function.
+  *
+  * @param v4l2_buf      : v4l2 buffer
+  * @param buffer        : NvBuffer
+  * @param shared_buffer : shared NvBuffer
+  * @param arg           : ladder rung pointer
+  */
+static bool
+ladder_encoder_capture_plane_dq_callback(struct v4l2_buffer *v4l2_buf, NvBuffer * buffer,
+                                         NvBuffer * shared_buffer, void *arg)
+{
+    ladder_rung_t *rung = (ladder_rung_t *) arg;
+    context_t *ctx = (context_t *) rung->ctx;
 
-        ret = enc->capture_plane.qBuffer(v4l2_buf, NULL);
-        TEST_ERROR(ret < 0, "Error while queueing buffer at capture plane", error);
+    if (v4l2_buf == NULL)
+    {
+        cout << "Error while dequeing buffer from rung capture plane" << endl;
+        abort(ctx);
+        return false;
+    }
 
+    /* Received EOS from encoder. Stop dqthread. */
+    if (buffer->planes[0].bytesused == 0)
+    {
+        return false;
     }
 
-    /* Enqueue all the empty decoder capture plane buffers. */
-    for (uint32_t i = 0; i < dec->capture_plane.getNumBuffers(); i++)
+    if (!ctx->stats)
     {
-        struct v4l2_buffer v4l2_buf;
-        struct v4l2_plane planes[MAX_PLANES];
+        write_transcoder_output_frame(rung->out_file, buffer);
+    }
+    rung->encoded_frames++;
+    rung->encoded_bytes += buffer->planes[0].bytesused;
 
-        memset(&v4l2_buf, 0, sizeof(v4l2_buf));
-        memset(planes, 0, sizeof(planes));
+    if (rung->enc->capture_plane.qBuffer(*v4l2_buf, NULL) < 0)
+    {
+        cerr << "Error while Qing buffer at rung capture plane" << endl;
+        abort(ctx);
+        return false;
+    }
 
-        v4l2_buf.index = i;
-        v4l2_buf.m.planes = planes;
-        v4l2_buf.memory = ctx->dec_capture_plane_mem_type;
-        if (ctx->dec_capture_plane_mem_type == V4L2_MEMORY_DMABUF)
-        {
-            v4l2_buf.m.planes[0].m.fd = ctx->dmabuff_fd[i];
-        }
-        ret = dec->capture_plane.qBuffer(v4l2_buf, NULL);
-        TEST_ERROR(ret < 0, "Error Qing buffer at output plane", error);
+    return true;
+}
 
-    }
-    cout << "Query and set capture successful" << endl;
-    return;
+/**
+  * Get a free buffer of a ladder rung encoder output plane.
+  *
+  * @param rung       : Ladder rung
+  * @param num_queued : Number of buffers queued so far, updated
+  * @param v4l2_buf   : v4l2 buffer, planes must be set
+  */
+static int
+ladder_get_output_buffer(ladder_rung_t *rung, uint32_t &num_queued,
+                         struct v4l2_buffer &v4l2_buf)
+{
+    NvVideoEncoder *enc = rung->enc;
 
-error:
-    if (error)
+    /* Use each buffer once before dequeuing them from the encoder. */
+    if (num_queued < enc->output_plane.getNumBuffers())
     {
-        abort(ctx);
-        cerr << "Error in " << __func__ << endl;
+        v4l2_buf.index = num_queued++;
+        return 0;
     }
+
+    return enc->output_plane.dqBuffer(v4l2_buf, NULL, NULL, 10);
 }
 
 /**
-  * Decoder capture thread loop function.
+  * Ladder rung scaler thread function. Scales the decoder buffers
+  * delivered by the fan-out and queues them to the rung encoder.
   *
-  * @param args : pointer to transcoder
+  * @param arg : Ladder rung pointer
   */
 static void *
-dec_capture_loop_fcn(void *arg)
+ladder_scale_loop_fcn(void *arg)
 {
-    context_t *ctx = (context_t *) arg;
-    NvVideoDecoder *dec = ctx->dec;
-    NvVideoEncoder *enc = ctx->enc;
-    struct v4l2_event ev;
-    struct v4l2_buffer v4l2_buf;
-    struct v4l2_plane planes[MAX_PLANES];
-    NvBuffer *buffer;
-    NvBufSurface *nvbuf_surf = 0;
+    ladder_rung_t *rung = (ladder_rung_t *) arg;
+    context_t *ctx = (context_t *) rung->ctx;
+    NvVideoEncoder *enc = rung->enc;
+    NvBufSurf::NvCommonTransformParams transform_params = {0};
+    uint32_t num_queued = 0;
+    uint32_t index;
     int ret;
 
-    cout << "Starting decoder capture loop thread" << endl;
-    /* Need to wait for the first Resolution change event, so that
-       the decoder knows the stream resolution and can allocate appropriate
-       buffers when we call REQBUFS. */
-    do
+    transform_params.dst_width = rung->width;
+    transform_params.dst_height = rung->height;
+    transform_params.flag = NVBUFSURF_TRANSFORM_FILTER;
+    transform_params.flip = NvBufSurfTransform_None;
+    transform_params.filter = NvBufSurfTransformInter_Algo3;
+
+    while (!ctx->got_error && ctx->fanout->acquire(rung->branch_id, index) == 0)
     {
-        /* Refer ioctl VIDIOC_DQEVENT */
+        struct v4l2_buffer v4l2_buf;
+        struct v4l2_plane planes[MAX_PLANES];
+        NvBufSurface *nvbuf_surf = 0;
+        NvBuffer *buffer;
+
+        memset(&v4l2_buf, 0, sizeof(v4l2_buf));
+        memset(planes, 0, sizeof(planes));
+        v4l2_buf.m.planes = planes;
+
+        if (ladder_get_output_buffer(rung, num_queued, v4l2_buf) < 0)
+        {
+            ctx->fanout->release(rung->branch_id, index);
+            cerr << "Error while DQing buffer at rung output plane" << endl;
+            abort(ctx);
+            break;
+        }
+
+        /* The decoder buffer is recycled as soon as the last rung has
+           scaled it, before the encoders are done with the frame. */
+        transform_params.src_width = ctx->width;
+        transform_params.src_height = ctx->height;
+        ret = NvBufSurf::NvTransform(&transform_params, ctx->dmabuff_fd[index],
+                                     rung->dmabuff_fd[v4l2_buf.index]);
+        ctx->fanout->release(rung->branch_id, index);
+        if (ret < 0)
+        {
+            cerr << "Error while scaling decoder buffer" << endl;
+            abort(ctx);
+            break;
+        }
+
+        ret = NvBufSurfaceFromFd(rung->dmabuff_fd[v4l2_buf.index], (void**)(&nvbuf_surf));
+        if (ret < 0)
+        {
+            cerr << "Error while calling NvBufSurfaceFromFd" << endl;
+            abort(ctx);
+            break;
+        }
+
+        buffer = enc->output_plane.getNthBuffer(v4l2_buf.index);
+        v4l2_buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
+        for (uint32_t i = 0 ; i < buffer->n_planes ; i++)
+        {
+            buffer->planes[i].fd = rung->dmabuff_fd[v4l2_buf.index];
+            v4l2_buf.m.planes[i].m.fd = buffer->planes[i].fd;
+            buffer->planes[i].mem_offset = nvbuf_surf->surfaceList[0].planeParams.offset[i];
+            buffer->planes[i].bytesused = buffer->planes[i].fmt.stride * buffer->planes[i].fmt.height;
+            v4l2_buf.m.planes[i].bytesused = buffer->planes[i].bytesused;
+        }
+
+        if (ctx->copy_timestamp)
+        {
+            v4l2_buf.flags |= V4L2_BUF_FLAG_TIMESTAMP_COPY;
+            v4l2_buf.timestamp.tv_sec = ctx->ladder_timestamp[index] / (MICROSECOND_UNIT);
+            v4l2_buf.timestamp.tv_usec = ctx->ladder_timestamp[index] % (MICROSECOND_UNIT);
+        }
+
+        if (enc->output_plane.qBuffer(v4l2_buf, NULL) < 0)
+        {
+            cerr << "Error while queueing buffer at rung output plane" << endl;
+            abort(ctx);
+            break;
+        }
+    }
+
+    if (!ctx->got_error)
+    {
+        struct v4l2_buffer v4l2_buf;
+        struct v4l2_plane planes[MAX_PLANES];
+
+        memset(&v4l2_buf, 0, sizeof(v4l2_buf));
+        memset(planes, 0, sizeof(planes));
+        v4l2_buf.m.planes = planes;
+
+        /* Send size 0 buffer to encoder as EoS */
+        if (ladder_get_output_buffer(rung, num_queued, v4l2_buf) < 0 ||
+            enc->output_plane.qBuffer(v4l2_buf, NULL) < 0)
+        {
+            cerr << "Error while queueing EoS at rung output plane" << endl;
+            abort(ctx);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+  * Set up the ladder rung encoders and start their scaler threads.
+  * Only done once, a resolution change only affects the scaler input.
+  *
+  * @param ctx          : Transcoder context
+  * @param color_format : Color format of the decoder buffers
+  */
+static int
+setup_ladder(context_t *ctx, NvBufSurfaceColorFormat color_format)
+{
+    NvBufSurf::NvCommonAllocateParams cParams = {0};
+    int ret = 0;
+    int error = 0;
+
+    if (ctx->ladder_started)
+    {
+        return 0;
+    }
+
+    for (uint32_t r = 0; r < ctx->num_rungs; r++)
+    {
+        ladder_rung_t *rung = &ctx->rungs[r];
+        NvVideoEncoder *enc = rung->enc;
+        char thread_name[16];
+
+        ret = set_encoder_params(ctx, enc, rung->width, rung->height, rung->bitrate);
+        TEST_ERROR(ret < 0, "Error in setting rung encoder parameters", error);
+
+        cParams.width = rung->width;
+        cParams.height = rung->height;
+        cParams.colorFormat = color_format;
+        cParams.layout = NVBUF_LAYOUT_BLOCK_LINEAR;
+        cParams.memType = NVBUF_MEM_SURFACE_ARRAY;
+        cParams.memtag = NvBufSurfaceTag_VIDEO_CONVERT;
+        rung->num_buffers = NUM_LADDER_BUFFERS;
+        for (uint32_t i = 0; i < rung->num_buffers; i++)
+        {
+            ret = NvBufSurf::NvAllocate(&cParams, 1, &rung->dmabuff_fd[i]);
+            TEST_ERROR(ret < 0, "Failed to create rung buffers", error);
+        }
+
+        ret = enc->output_plane.reqbufs(V4L2_MEMORY_DMABUF, rung->num_buffers);
+        TEST_ERROR(ret < 0, "reqbufs failed for rung output plane", error);
+
+        ret = enc->capture_plane.setupPlane(V4L2_MEMORY_MMAP, ctx->num_output_buffers,
+                                            true, false);
+        TEST_ERROR(ret < 0, "Could not setup rung capture plane", error);
+
+        ret = enc->output_plane.setStreamStatus(true);
+        TEST_ERROR(ret < 0, "Error in rung output plane streamon", error);
+
+        ret = enc->capture_plane.setStreamStatus(true);
+        TEST_ERROR(ret < 0, "Error in rung capture plane streamon", error);
+
+        enc->capture_plane.setDQThreadCallback(ladder_encoder_capture_plane_dq_callback);
+        enc->capture_plane.startDQThread(rung);
+
+        /* Enqueue all the empty encoder capture plane buffers. */
+        for (uint32_t i = 0; i < enc->capture_plane.getNumBuffers(); i++)
+        {
+            struct v4l2_buffer v4l2_buf;
+            struct v4l2_plane planes[MAX_PLANES];
+
+            memset(&v4l2_buf, 0, sizeof(v4l2_buf));
+            memset(planes, 0, sizeof(planes));
+
+            v4l2_buf.index = i;
+            v4l2_buf.m.planes = planes;
+
+            ret = enc->capture_plane.qBuffer(v4l2_buf, NULL);
+            TEST_ERROR(ret < 0, "Error while queueing buffer at rung capture plane", error);
+        }
+
+        ret = pthread_create(&rung->scale_thread, NULL, ladder_scale_loop_fcn, rung);
+        TEST_ERROR(ret != 0, "Error creating rung scaler thread", error);
+        snprintf(thread_name, sizeof(thread_name), "LadderScale%u", r % 10);
+        pthread_setname_np(rung->scale_thread, thread_name);
+
+        cout << "Ladder rung " << r << ": " << rung->width << "x" << rung->height <<
+            " @ " << rung->bitrate << " bps" <<
+            (rung->policy == NV_FANOUT_POLICY_DROP ? ", drops frames when late" : "") << endl;
+    }
+    ctx->ladder_started = true;
+
+    return 0;
+
+error:
+    return -error;
+}
+
+/**
+  * Report the ladder throughput.
+  *
+  * @param ctx     : Transcoder context
+  * @param seconds : Transcode duration in seconds
+  */
+static void
+print_ladder_stats(context_t *ctx, double seconds)
+{
+    uint64_t total_frames = 0;
+
+    cout << "----------- Ladder instance " << ctx->thread_num << " -----------" << endl;
+    cout << "Decoded frames: " << ctx->decoded_frames << " in " << seconds <<
+        " s (" << (seconds > 0 ? ctx->decoded_frames / seconds : 0) << " fps)" << endl;
+    for (uint32_t r = 0; r < ctx->num_rungs; r++)
+    {
+        ladder_rung_t *rung = &ctx->rungs[r];
+
+        total_frames += rung->encoded_frames;
+        cout << "Rung " << r << " " << rung->width << "x" << rung->height <<
+            ": " << rung->encoded_frames << " frames, " <<
+            (seconds > 0 ? rung->encoded_frames / seconds : 0) << " fps, " <<
+            (seconds > 0 ? rung->encoded_bytes * 8 / seconds / 1000 : 0) << " kbps" << endl;
+    }
+    cout << "Total: " << total_frames << " encoded frames, " <<
+        (seconds > 0 ? total_frames / seconds : 0) << " fps from one decode" << endl;
+    cout << "Decodes saved against " << ctx->num_rungs << " independent transcodes: " <<
+        ctx->decoded_frames * (ctx->num_rungs - 1) << " frames" << endl;
+    ctx->fanout->printStats(cout);
+}
+
+/**
+  * Set up the encoder fed directly with the decoder capture buffers.
+  *
+  * @param ctx : Transcoder context
+  */
+static int
+setup_encoder(context_t *ctx)
+{
+    NvVideoEncoder *enc = ctx->enc;
+    int ret = 0;
+    int error = 0;
+
+    ret = set_encoder_params(ctx, enc, ctx->width, ctx->height, ctx->bitrate);
+    TEST_ERROR(ret < 0, "Error in setting encoder parameters", error);
+
+    /*  Set encoder output plane */
+    ret = enc->output_plane.reqbufs(ctx->enc_output_memory_type, ctx->num_cap_buffers);
+    TEST_ERROR(ret < 0,"reqbufs failed for output plane V4L2_MEMORY_DMABUF", error);
+
+     ret = enc->capture_plane.setupPlane(ctx->enc_capture_memory_type, ctx->num_output_buffers,
+        true, false);
+    TEST_ERROR(ret < 0, "Could not setup capture plane", error);
+
+    /* Subscibe for End Of Stream event */
+    ret = enc->subscribeEvent(V4L2_EVENT_EOS,0,0);
+    TEST_ERROR(ret < 0, "Could not subscribe EOS event", error);
+
+     /* set encoder output plane STREAMON */
+    ret = enc->output_plane.setStreamStatus(true);
+    TEST_ERROR(ret < 0, "Error in output plane streamon", error);
+
+    /* set encoder capture plane STREAMON */
+    ret = enc->capture_plane.setStreamStatus(true);
+    TEST_ERROR(ret < 0, "Error in capture plane streamon", error);
+
+    /* Set encoder capture plane dq thread callback for blocking io mode */
+    enc->capture_plane.setDQThreadCallback(encoder_capture_plane_dq_callback);
+
+    /* startDQThread starts a thread internally which calls the
+       encoder_capture_plane_dq_callback whenever a buffer is dequeued
+       on the plane */
+    enc->capture_plane.startDQThread(ctx);
+
+    pthread_create(&ctx->buffer_refill, NULL, buffer_refil, ctx);
+
+    /* Enqueue all the empty encoder capture plane buffers. */
+    for (uint32_t i = 0; i < enc->capture_plane.getNumBuffers(); i++)
+    {
+        struct v4l2_buffer v4l2_buf;
+        struct v4l2_plane planes[MAX_PLANES];
+
+        memset(&v4l2_buf, 0, sizeof(v4l2_buf));
+        memset(planes, 0, MAX_PLANES * sizeof(struct v4l2_plane));
+
+        v4l2_buf.index = i;
+        v4l2_buf.m.planes = planes;
+
+        ret = enc->capture_plane.qBuffer(v4l2_buf, NULL);
+        TEST_ERROR(ret < 0, "Error while queueing buffer at capture plane", error);
+
+    }
+
+    return 0;
+
+error:
+    return -error;
+}
+
+/**
+  * Query and Set Capture plane.
+  *
+  * @param ctx : Transcoder context
+  */
+static void
+query_and_set_capture(context_t * ctx)
+{
+    NvVideoDecoder *dec = ctx->dec;
+    NvVideoEncoder *enc = ctx->enc;
+    struct v4l2_format format;
+    struct v4l2_crop crop;
+    int32_t min_dec_capture_buffers;
+    int ret = 0;
+    int error = 0;
+    NvBufSurf::NvCommonAllocateParams cParams = {0};
+
+    /* Get capture plane format from the decoder.
+       This may change after resolution change event.
+       Refer ioctl VIDIOC_G_FMT */
+    ret = dec->capture_plane.getFormat(format);
+    TEST_ERROR(ret < 0,
+               "Error: Could not get format from decoder capture plane", error);
+
+     ret = dec->capture_plane.getCrop(crop);
+    TEST_ERROR(ret < 0,
+               "Error: Could not get crop from decoder capture plane", error);
+
+    cout << "Video Resolution: " << crop.c.width << "x" << crop.c.height;
+
+    if (ctx->fanout)
+    {
+        /* The rungs may still be scaling from the old decoder buffers. */
+        ctx->fanout->waitIdle();
+    }
+
+    /* deinitPlane unmaps the buffers and calls REQBUFS with count 0 */
+    dec->capture_plane.deinitPlane();
+
+    if (enc)
+    {
+        enc->output_plane.deinitPlane();
+
+        enc->capture_plane.deinitPlane();
+    }
+
+    ctx->height = crop.c.height;
+    ctx->width = crop.c.width;
+    ctx->raw_pixfmt = format.fmt.pix_mp.pixelformat;
+    /* Not necessary to call VIDIOC_S_FMT on decoder capture plane.
+       But decoder setCapturePlaneFormat function updates the class variables */
+    ret = dec->setCapturePlaneFormat(ctx->raw_pixfmt,
+                                     ctx->width,
+                                     ctx->height);
+    TEST_ERROR(ret < 0, "Error in setting decoder capture plane format", error);
+
+    /* Get the minimum buffers which have to be requested on the capture plane. */
+    ret = dec->getMinimumCapturePlaneBuffers(min_dec_capture_buffers);
+    TEST_ERROR(ret < 0,
+               "Error while getting value of minimum capture plane buffers",
+               error);
+
+    /* Request, Query and export decoder capture plane buffers.
+       Refer ioctl VIDIOC_REQBUFS, VIDIOC_QUERYBUF and VIDIOC_EXPBUF */
+    if (ctx->dec_capture_plane_mem_type == V4L2_MEMORY_DMABUF)
+    {
+        /* Set colorformats for relevant colorspaces. */
+        switch(format.fmt.pix_mp.colorspace)
+        {
+            case V4L2_COLORSPACE_SMPTE170M:
+                if (format.fmt.pix_mp.quantization == V4L2_QUANTIZATION_DEFAULT)
+                {
+                    cout << "Decoder colorspace ITU-R BT.601 with standard range luma (16-235)" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12;
+                }
+                else
+                {
+                    cout << "Decoder colorspace ITU-R BT.601 with extended range luma (0-255)" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_ER;
+                }
+                break;
+            case V4L2_COLORSPACE_REC709:
+                if (format.fmt.pix_mp.quantization == V4L2_QUANTIZATION_DEFAULT)
+                {
+                    cout << "Decoder colorspace ITU-R BT.709 with standard range luma (16-235)" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_709;
+                }
+                else
+                {
+                    cout << "Decoder colorspace ITU-R BT.709 with extended range luma (0-255)" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_709_ER;
+                }
+                break;
+            case V4L2_COLORSPACE_BT2020:
+                {
+                    cout << "Decoder colorspace ITU-R BT.2020" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_2020;
+                }
+                break;
+            default:
+                cout << "supported colorspace details not available, use default" << endl;
+                if (format.fmt.pix_mp.quantization == V4L2_QUANTIZATION_DEFAULT)
+                {
+                    cout << "Decoder colorspace ITU-R BT.601 with standard range luma (16-235)" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12;
+                }
+                else
+                {
+                    cout << "Decoder colorspace ITU-R BT.601 with extended range luma (0-255)" << endl;
+                    cParams.colorFormat = NVBUF_COLOR_FORMAT_NV12_ER;
+                }
+                break;
+        }
+
+        ctx->num_cap_buffers = min_dec_capture_buffers + ctx->extra_cap_plane_buffer;
+        if (ctx->fanout)
+        {
+            /* Cover the buffers queued to and being scaled by the rungs. */
+            ctx->num_cap_buffers += ctx->ladder_depth + 1;
+        }
+        TEST_ERROR(ctx->num_cap_buffers > MAX_BUFFERS,
+                   "Too many decoder capture plane buffers", error);
+
+        /* Create decoder capture plane buffers. */
+        for (int index = 0; index < ctx->num_cap_buffers; index++)
+        {
+            cParams.width = ctx->width;
+            cParams.height = ctx->height;
+            cParams.layout = NVBUF_LAYOUT_BLOCK_LINEAR;
+            cParams.memType = NVBUF_MEM_SURFACE_ARRAY;
+            cParams.memtag = NvBufSurfaceTag_VIDEO_DEC;
+            ret = NvBufSurf::NvAllocate(&cParams, 1, &ctx->dmabuff_fd[index]);
+            TEST_ERROR(ret < 0, "Failed to create buffers", error);
+        }
+
+        /* Request buffers on decoder capture plane.
+           Refer ioctl VIDIOC_REQBUFS */
+        ret = dec->capture_plane.reqbufs(ctx->dec_capture_plane_mem_type, ctx->num_cap_buffers);
+            TEST_ERROR(ret, "Error in request buffers on capture plane", error);
+    }
+
+    if (ctx->fanout)
+    {
+        /* In ladder mode each rung scales the decoder buffers into its own
+           encoder buffers, only the fan-out follows the decoder buffers. */
+        ret = ctx->fanout->setNumBuffers(ctx->num_cap_buffers);
+        TEST_ERROR(ret < 0, "Error in setting ladder fan-out buffers", error);
+
+        ret = setup_ladder(ctx, cParams.colorFormat);
+        TEST_ERROR(ret < 0, "Error in setting up ladder rungs", error);
+    }
+    else
+    {
+        ret = setup_encoder(ctx);
+        TEST_ERROR(ret < 0, "Error in setting up encoder", error);
+    }
+
+    /* Decoder capture plane STREAMON.
+       Refer ioctl VIDIOC_STREAMON */
+
+    ret = dec->capture_plane.setStreamStatus(true);
+    TEST_ERROR(ret < 0, "Error in decoder capture plane streamon", error);
+
+    /* Enqueue all the empty decoder capture plane buffers. */
+    for (uint32_t i = 0; i < dec->capture_plane.getNumBuffers(); i++)
+    {
+        struct v4l2_buffer v4l2_buf;
+        struct v4l2_plane planes[MAX_PLANES];
+
+        memset(&v4l2_buf, 0, sizeof(v4l2_buf));
+        memset(planes, 0, sizeof(planes));
+
+        v4l2_buf.index = i;
+        v4l2_buf.m.planes = planes;
+        v4l2_buf.memory = ctx->dec_capture_plane_mem_type;
+        if (ctx->dec_capture_plane_mem_type == V4L2_MEMORY_DMABUF)
+        {
+            v4l2_buf.m.planes[0].m.fd = ctx->dmabuff_fd[i];
+        }
+        ret = dec->capture_plane.qBuffer(v4l2_buf, NULL);
+        TEST_ERROR(ret < 0, "Error Qing buffer at output plane", error);
+
+    }
+    cout << "Query and set capture successful" << endl;
+    return;
+
+error:
+    if (error)
+    {
+        abort(ctx);
+        cerr << "Error in " << __func__ << endl;
+    }
+}
+
+/**
+  * Decoder capture thread loop function.
+  *
+  * @param args : pointer to transcoder
+  */
+static void *
+dec_capture_loop_fcn(void *arg)
+{
+    context_t *ctx = (context_t *) arg;
+    NvVideoDecoder *dec = ctx->dec;
+    NvVideoEncoder *enc = ctx->enc;
+    struct v4l2_event ev;
+    struct v4l2_buffer v4l2_buf;
+    struct v4l2_plane planes[MAX_PLANES];
+    NvBuffer *buffer;
+    NvBufSurface *nvbuf_surf = 0;
+    int ret;
+
+    cout << "Starting decoder capture loop thread" << endl;
+    /* Need to wait for the first Resolution change event, so that
+       the decoder knows the stream resolution and can allocate appropriate
+       buffers when we call REQBUFS. */
+    do
+    {
+        /* Refer ioctl VIDIOC_DQEVENT */
         ret = dec->dqEvent(ev, 50000);
         if (ret < 0)
         {
@@ -1495,6 +1918,25 @@ dec_capture_loop_fcn(void *arg)
                 }
             }
 
+            if (ctx->fanout)
+            {
+                /* Hand the buffer to all the ladder rungs, it is queued back
+                   by ladder_recycle_callback once the last one scaled it. */
+                if (ctx->copy_timestamp)
+                {
+                    ctx->timestamp += ctx->timestampincr;
+                    ctx->ladder_timestamp[v4l2_buf.index] = ctx->timestamp;
+                }
+                ctx->decoded_frames++;
+                if (ctx->fanout->publish(v4l2_buf.index) < 0)
+                {
+                    abort(ctx);
+                    cerr << "Error while publishing buffer to ladder rungs" << endl;
+                    break;
+                }
+                continue;
+            }
+
             buffer = enc->output_plane.getNthBuffer(v4l2_buf.index);
             v4l2_buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT_MPLANE;
 
@@ -1564,9 +2006,24 @@ dec_capture_loop_fcn(void *arg)
         }
     }
 
-    ctx->stop_refill=1;
+    if (ctx->fanout)
+    {
+        /* Let the rungs drain their queues and send EoS to their encoders. */
+        ctx->fanout->close();
+        for (uint32_t r = 0; r < ctx->num_rungs; r++)
+        {
+            if (ctx->rungs[r].scale_thread)
+            {
+                pthread_join(ctx->rungs[r].scale_thread, NULL);
+            }
+        }
+    }
+    else
+    {
+        ctx->stop_refill=1;
 
-    pthread_join(ctx->buffer_refill, NULL);
+        pthread_join(ctx->buffer_refill, NULL);
+    }
 
     cout << "Exiting decoder capture loop thread" << endl;
     return NULL;
@@ -1706,13 +2163,47 @@ transcode_proc(void * p_ctx)
 
     ctx.dec = NvVideoDecoder::createVideoDecoder("dec0");
 
-    ctx.enc = NvVideoEncoder::createVideoEncoder("enc0");
-
     ctx.in_file = new ifstream(ctx.in_file_path);
     TEST_ERROR(!ctx.in_file->is_open(), "Error opening input file", cleanup);
 
-    ctx.out_file = new ofstream(ctx.out_file_path);
-    TEST_ERROR(!ctx.out_file->is_open(), "Error opening output file", cleanup);
+    if (ctx.num_rungs)
+    {
+        /* ABR ladder: one decoder shared by one scaler and encoder per rung. */
+        ctx.fanout = new NvBufferFanout("Ladder", 0, ladder_recycle_callback, &ctx);
+        for (uint32_t r = 0; r < ctx.num_rungs; r++)
+        {
+            ladder_rung_t *rung = &ctx.rungs[r];
+            string enc_name = "enc" + to_string(r);
+            string rung_name = to_string(rung->width) + "x" + to_string(rung->height);
+            string out_path = ctx.out_file_path;
+            size_t ext = out_path.find_last_of('.');
+
+            /* Name the renditions <out-file>_<W>x<H>.<ext> */
+            if (ext == string::npos || out_path.find('/', ext) != string::npos)
+            {
+                ext = out_path.size();
+            }
+            out_path.insert(ext, "_" + rung_name);
+
+            rung->ctx = &ctx;
+            rung->enc = NvVideoEncoder::createVideoEncoder(enc_name.c_str());
+            TEST_ERROR(!rung->enc, "Could not create rung encoder", cleanup);
+
+            rung->out_file = new ofstream(out_path.c_str());
+            TEST_ERROR(!rung->out_file->is_open(), "Error opening rung output file", cleanup);
+
+            ret = ctx.fanout->addBranch(rung_name.c_str(), ctx.ladder_depth, rung->policy);
+            TEST_ERROR(ret < 0, "Could not add ladder branch", cleanup);
+            rung->branch_id = ret;
+        }
+    }
+    else
+    {
+        ctx.enc = NvVideoEncoder::createVideoEncoder("enc0");
+
+        ctx.out_file = new ofstream(ctx.out_file_path);
+        TEST_ERROR(!ctx.out_file->is_open(), "Error opening output file", cleanup);
+    }
 
     ret = ctx.dec->subscribeEvent(V4L2_EVENT_RESOLUTION_CHANGE, 0, 0);
     TEST_ERROR(ret < 0, "Could not subscribe to V4L2_EVENT_RESOLUTION_CHANGE",
@@ -1728,7 +2219,14 @@ transcode_proc(void * p_ctx)
     if (ctx.stats)
     {
         ctx.dec->enableProfiling();
-        ctx.enc->enableProfiling();
+        if (ctx.enc)
+        {
+            ctx.enc->enableProfiling();
+        }
+        for (uint32_t r = 0; r < ctx.num_rungs; r++)
+        {
+            ctx.rungs[r].enc->enableProfiling();
+        }
     }
 
     ret = ctx.dec->setOutputPlaneFormat(ctx.decoder_pixfmt, CHUNK_SIZE);
@@ -1804,11 +2302,6 @@ transcode_proc(void * p_ctx)
       ctx.timestampincr = (MICROSECOND_UNIT * 16) / ((uint32_t) (ctx.dec_fps * 16));
     }
 
-    if (ctx.stats)
-    {
-        ctx.enc->enableProfiling();
-    }
-
     /* Read encoded data and enqueue all the output plane buffers.
     Exit loop in case file read is complete. */
 
@@ -1939,7 +2432,23 @@ cleanup:
     if (ctx.blocking_mode && ctx.dec_capture_loop)
     {
         pthread_join(ctx.dec_capture_loop, NULL);
-        ctx.enc->capture_plane.waitForDQThread(-1);
+        if (ctx.enc)
+        {
+            ctx.enc->capture_plane.waitForDQThread(-1);
+        }
+        for (uint32_t r = 0; r < ctx.num_rungs; r++)
+        {
+            ctx.rungs[r].enc->capture_plane.waitForDQThread(-1);
+        }
+    }
+
+    if (ctx.fanout && ctx.ladder_started)
+    {
+        struct timespec end_time;
+
+        GET_TIME(&end_time);
+        print_ladder_stats(&ctx, TIMESPEC_DIFF_USEC(&end_time,
+            &stream_stats[ctx.thread_num]->start_time) / 1e9);
     }
 
     if (ctx.stats)
@@ -1951,10 +2460,21 @@ cleanup:
 
         cout << "Stats for instance " << ctx.thread_num << endl;
         ctx.dec->getProfilingData(dec_data);
-        ctx.enc->getProfilingData(enc_data);
-
         ctx.dec->printProfilingStats(cout);
-        ctx.enc->printProfilingStats(cout);
+        if (ctx.enc)
+        {
+            ctx.enc->getProfilingData(enc_data);
+            ctx.enc->printProfilingStats(cout);
+        }
+        else if (ctx.ladder_started)
+        {
+            /* Instance FPS is the FPS of the first rung. */
+            ctx.rungs[0].enc->getProfilingData(enc_data);
+            for (uint32_t r = 0; r < ctx.num_rungs; r++)
+            {
+                ctx.rungs[r].enc->printProfilingStats(cout);
+            }
+        }
         stream_stats[ctx.thread_num]->filename = strdup(ctx.in_file_path);
         stream_stats[ctx.thread_num]->enc_data = enc_data;
         stream_stats[ctx.thread_num]->dec_data = dec_data;
@@ -1966,6 +2486,14 @@ cleanup:
         cerr << "Encoder is in error" << endl;
         error = 1;
     }
+    for (uint32_t r = 0; r < ctx.num_rungs; r++)
+    {
+        if (ctx.rungs[r].enc && ctx.rungs[r].enc->isInError())
+        {
+            cerr << "Rung " << r << " encoder is in error" << endl;
+            error = 1;
+        }
+    }
     if (ctx.got_error)
     {
         error = 1;
@@ -2037,9 +2565,33 @@ cleanup:
 
     ctx.dec->capture_plane.deinitPlane();
 
-    ctx.enc->output_plane.deinitPlane();
+    if (ctx.enc)
+    {
+        ctx.enc->output_plane.deinitPlane();
+
+        ctx.enc->capture_plane.deinitPlane();
+    }
 
-    ctx.enc->capture_plane.deinitPlane();
+    for (uint32_t r = 0; r < ctx.num_rungs; r++)
+    {
+        ladder_rung_t *rung = &ctx.rungs[r];
+
+        if (rung->enc)
+        {
+            rung->enc->output_plane.deinitPlane();
+            rung->enc->capture_plane.deinitPlane();
+        }
+        for (uint32_t i = 0; i < rung->num_buffers; i++)
+        {
+            if (rung->dmabuff_fd[i] > 0 && NvBufSurf::NvDestroy(rung->dmabuff_fd[i]) < 0)
+            {
+                cerr << "Failed to Destroy rung NvBuffer" << endl;
+            }
+        }
+        delete rung->enc;
+        delete rung->out_file;
+    }
+    delete ctx.fanout;
 
     /* Release encoder configuration specific resources. */
     delete ctx.enc;
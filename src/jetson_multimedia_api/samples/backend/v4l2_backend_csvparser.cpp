@@ -68,6 +68,8 @@ print_help(void)
             "\t--trt-modelfile      set model file name\n"
             "\t--trt-proc-interval  set process interval, 1 frame will be process every trt-proc-interval\n"
             "\t--trt-mode           0 fp16 (if supported), 1 fp32, 2 int8\n"
+            "\t--trt-cache-dir <dir>  directory of the TRT engine cache [Default = trt_engine_cache], \"\" to disable\n"
+            "\t--trt-cache-size <MB>  size limit of the TRT engine cache, 0 for no limit [Default = 1024]\n"
             "\t--trt-dumpresult     1 to dump result, 0[default] otherwise\n"
             "\t--trt-enable-perf    1[default] to enable perf measurement, 0 otherwise\n"
 #else
@@ -196,6 +198,16 @@ parse_csv_args(context_t * ctx,
             argp++;
             trt_ctx->setMode(atoi(*argp));
         }
+        else if (!strcmp(arg, "--trt-cache-dir"))
+        {
+            argp++;
+            trt_ctx->setEngineCacheDir(*argp);
+        }
+        else if (!strcmp(arg, "--trt-cache-size"))
+        {
+            argp++;
+            trt_ctx->setEngineCacheSize(strtoull(*argp, NULL, 10) * 1024 * 1024);
+        }
         else if (!strcmp(arg, "--trt-proc-interval"))
         {
             argp++;
@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "NvThreadPolicy.h"
 #include "NvUtils.h"
 #include <errno.h>
 #include <fstream>
@@ -237,6 +238,8 @@ static void *render_thread(void* arg)
     temp_bbox.g_rect_num = 0;
     temp_bbox.g_rect = new NvOSD_RectParams[OSD_BUF_NUM];
 #endif
+
+    NvThreadPolicy::getInstance().applyToCurrentThread("render");
     while (1)
     {
         // waiting for buffer to come
@@ -1430,6 +1433,9 @@ cleanup:
 #ifdef ENABLE_TRT
     trt_ctx.tctx.destroyTrtContext();
 #endif
+    if (NvThreadPolicy::getInstance().isConfigured())
+        NvThreadPolicy::getInstance().printPolicy();
+
     // Terminate EGL display connection
     if (egl_display)
     {
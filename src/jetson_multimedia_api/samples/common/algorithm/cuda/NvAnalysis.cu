@@ -45,12 +45,16 @@ addLabelsKernel(int *pDevPtr, int pitch)
 }
 
 int
-addLabels(CUdeviceptr pDevPtr, int pitch)
+addLabels(CUdeviceptr pDevPtr, int pitch, void* pstream)
 {
     dim3 threadsPerBlock(BOX_W, BOX_H);
     dim3 blocks(1,1);
+    cudaStream_t stream = 0;
 
-    addLabelsKernel<<<blocks,threadsPerBlock>>>((int *)pDevPtr, pitch);
+    if (pstream != NULL)
+        stream = *(cudaStream_t*)pstream;
+
+    addLabelsKernel<<<blocks,threadsPerBlock, 0, stream>>>((int *)pDevPtr, pitch);
 
     return 0;
 }
@@ -110,7 +114,9 @@ int convertIntToFloat(CUdeviceptr pDevPtr,
                       void* cuda_buf, void* pstream)
 {
     dim3 threadsPerBlock(32, 32);
-    dim3 blocks(width/threadsPerBlock.x, height/threadsPerBlock.y);
+    // Round up, the kernels skip the threads outside the image
+    dim3 blocks((width + threadsPerBlock.x - 1) / threadsPerBlock.x,
+                (height + threadsPerBlock.y - 1) / threadsPerBlock.y);
     cudaStream_t stream;
     if (pstream!= NULL)
         stream = *(cudaStream_t*)pstream;
@@ -130,3 +136,99 @@ int convertIntToFloat(CUdeviceptr pDevPtr,
 
     return 0;
 }
+
+__global__ void
+preprocessKernel(const uint8_t *src, void *dst, NvPreprocessParams params,
+                NvPreprocessGeometry geometry)
+{
+    uint32_t x = blockIdx.x * blockDim.x + threadIdx.x;
+    uint32_t y = blockIdx.y * blockDim.y + threadIdx.y;
+    uint32_t v[3];
+
+    if (x >= params.dst_width || y >= params.dst_height)
+        return;
+
+    if (x < geometry.left || x >= geometry.left + geometry.width ||
+        y < geometry.top || y >= geometry.top + geometry.height)
+    {
+        for (int c = 0; c < 3; c++)
+            v[c] = params.pad[c];
+    }
+    else
+    {
+        uint32_t bpp = NvPreprocessBytesPerPixel(params.src_format);
+        uint32_t dx = x - geometry.left;
+        uint32_t dy = y - geometry.top;
+        const uint8_t *crop = src + geometry.crop_left * bpp;
+
+        if (params.filter != NV_PREPROCESS_FILTER_BILINEAR)
+        {
+            uint32_t sx = NvPreprocessMapNearest(dx, geometry.width, geometry.crop_width);
+            uint32_t sy = NvPreprocessMapNearest(dy, geometry.height, geometry.crop_height);
+            const uint8_t *px = crop + (size_t) (geometry.crop_top + sy) * params.src_pitch +
+                                sx * bpp;
+
+            for (int c = 0; c < 3; c++)
+                v[c] = px[NvPreprocessSourceChannel(params.src_format, params.dst_bgr, c)];
+        }
+        else
+        {
+            uint32_t x0, x1, wx;
+            uint32_t y0, y1, wy;
+
+            NvPreprocessMapLinear(dx, geometry.width, geometry.crop_width, &x0, &x1, &wx);
+            NvPreprocessMapLinear(dy, geometry.height, geometry.crop_height, &y0, &y1, &wy);
+            const uint8_t *row0 = crop + (size_t) (geometry.crop_top + y0) * params.src_pitch;
+            const uint8_t *row1 = crop + (size_t) (geometry.crop_top + y1) * params.src_pitch;
+
+            // Vertical pass then horizontal pass, as the CPU implementation
+            for (int c = 0; c < 3; c++)
+            {
+                uint32_t sc = NvPreprocessSourceChannel(params.src_format, params.dst_bgr, c);
+                uint32_t t0 = NvPreprocessLerpRows(row0[x0 * bpp + sc], row1[x0 * bpp + sc], wy);
+                uint32_t t1 = NvPreprocessLerpRows(row0[x1 * bpp + sc], row1[x1 * bpp + sc], wy);
+
+                v[c] = NvPreprocessLerpColumns(t0, t1, wx);
+            }
+        }
+    }
+
+    size_t pixel = (size_t) y * params.dst_width + x;
+    size_t plane = (size_t) params.dst_width * params.dst_height;
+
+    for (int c = 0; c < 3; c++)
+    {
+        float value = NvPreprocessNormalize(v[c], params.mean[c], params.scale[c]);
+        size_t index = (params.layout == NV_PREPROCESS_LAYOUT_NCHW) ?
+                       c * plane + pixel : pixel * 3 + c;
+
+        if (params.data_type == NV_PREPROCESS_TYPE_FP32)
+            ((float *) dst)[index] = value;
+        else if (params.data_type == NV_PREPROCESS_TYPE_FP16)
+            ((uint16_t *) dst)[index] = NvPreprocessFloatToHalf(value);
+        else
+            ((int8_t *) dst)[index] = NvPreprocessFloatToInt8(value);
+    }
+}
+
+int
+preprocessImage(CUdeviceptr pDevPtr, const NvPreprocessParams *params,
+                void* cuda_buf, void* pstream)
+{
+    NvPreprocessGeometry geometry;
+    cudaStream_t stream = 0;
+
+    if (params == NULL || NvPreprocessGetGeometry(params, &geometry) < 0)
+        return -1;
+    if (pstream != NULL)
+        stream = *(cudaStream_t*)pstream;
+
+    dim3 threadsPerBlock(32, 8);
+    dim3 blocks((params->dst_width + threadsPerBlock.x - 1) / threadsPerBlock.x,
+                (params->dst_height + threadsPerBlock.y - 1) / threadsPerBlock.y);
+
+    preprocessKernel<<<blocks, threadsPerBlock, 0, stream>>>((const uint8_t *)pDevPtr,
+            cuda_buf, *params, geometry);
+
+    return 0;
+}
@@ -34,7 +34,8 @@
 //interface to cuda kernel
 //@pDevPtr: ptr to buffer data
 //@pitch: stride per line
-int addLabels(CUdeviceptr pDevPtr, int pitch);
+//@pstream: ptr to the cudaStream_t to run on, NULL for the default stream
+int addLabels(CUdeviceptr pDevPtr, int pitch, void* pstream = NULL);
 
 int convertIntToFloat(CUdeviceptr pDevPtr,
                                 int width,
@@ -45,4 +46,14 @@ int convertIntToFloat(CUdeviceptr pDevPtr,
                                 void* scales,
                                 void* cuda_buf, void* pstream = NULL);
 
+//Fused crop, resize, letterbox, normalization and layout conversion in
+//one kernel, bit-exact with NvPreprocessCpu
+//@pDevPtr: ptr to the source image, params->src_pitch bytes per line
+//@params: preprocessing parameters
+//@cuda_buf: destination tensor
+//@pstream: ptr to the cudaStream_t to run on, NULL for the default stream
+//returns -1 if the parameters are invalid
+int preprocessImage(CUdeviceptr pDevPtr, const NvPreprocessParams *params,
+                    void* cuda_buf, void* pstream = NULL);
+
 #endif
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <time.h>
+
+#include "NvCpuStreams.h"
+
+static uint64_t
+getTimeUsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+NvCpuStreams::NvCpuStreams()
+    : running(0)
+    , max_running(0)
+{
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+NvCpuStreams::~NvCpuStreams()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+NvCudaExecutorOps
+NvCpuStreams::getOps()
+{
+    NvCudaExecutorOps ops;
+
+    ops.createStream = createStream;
+    ops.destroyStream = destroyStream;
+    ops.createEvent = createEvent;
+    ops.destroyEvent = destroyEvent;
+    ops.launch = launch;
+    ops.recordEvent = recordEvent;
+    ops.streamWaitEvent = streamWaitEvent;
+    ops.queryEvent = queryEvent;
+    ops.synchronizeEvent = synchronizeEvent;
+    ops.elapsedTime = elapsedTime;
+    ops.arg = this;
+    return ops;
+}
+
+uint32_t
+NvCpuStreams::getMaxConcurrency()
+{
+    uint32_t value;
+
+    pthread_mutex_lock(&lock);
+    value = max_running;
+    pthread_mutex_unlock(&lock);
+    return value;
+}
+
+// Called with the lock held
+void
+NvCpuStreams::push(Stream *stream, const Command &command)
+{
+    stream->queue.push_back(command);
+    pthread_cond_broadcast(&cond);
+}
+
+void *
+NvCpuStreams::streamThread(void *arg)
+{
+    Stream *stream = (Stream *) arg;
+    NvCpuStreams *self = stream->owner;
+
+    pthread_mutex_lock(&self->lock);
+    while (true)
+    {
+        if (stream->queue.empty())
+        {
+            if (stream->stop)
+                break;
+            pthread_cond_wait(&self->cond, &self->lock);
+            continue;
+        }
+
+        Command command = stream->queue.front();
+        if (command.type == Command::WAIT)
+        {
+            if (command.event->completed < command.generation)
+            {
+                pthread_cond_wait(&self->cond, &self->lock);
+                continue;
+            }
+        }
+        else if (command.type == Command::RECORD)
+        {
+            command.event->completed = command.generation;
+            command.event->time_usec = getTimeUsec();
+            pthread_cond_broadcast(&self->cond);
+        }
+        else
+        {
+            if (++self->running > self->max_running)
+                self->max_running = self->running;
+            pthread_mutex_unlock(&self->lock);
+            command.func(stream, command.user);
+            pthread_mutex_lock(&self->lock);
+            self->running--;
+        }
+        stream->queue.pop_front();
+    }
+    pthread_mutex_unlock(&self->lock);
+    return NULL;
+}
+
+void *
+NvCpuStreams::createStream(int priority, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Stream *stream = new Stream;
+
+    stream->owner = self;
+    stream->priority = priority;
+    stream->stop = false;
+    if (pthread_create(&stream->thread, NULL, streamThread, stream))
+    {
+        delete stream;
+        return NULL;
+    }
+    return stream;
+}
+
+void
+NvCpuStreams::destroyStream(void *handle, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Stream *stream = (Stream *) handle;
+
+    // The queued work is run first, as cudaStreamDestroy() does
+    pthread_mutex_lock(&self->lock);
+    stream->stop = true;
+    pthread_cond_broadcast(&self->cond);
+    pthread_mutex_unlock(&self->lock);
+
+    pthread_join(stream->thread, NULL);
+    delete stream;
+}
+
+void *
+NvCpuStreams::createEvent(void *arg)
+{
+    Event *event = new Event;
+
+    event->recorded = 0;
+    event->completed = 0;
+    event->time_usec = 0;
+    return event;
+}
+
+void
+NvCpuStreams::destroyEvent(void *event, void *arg)
+{
+    delete (Event *) event;
+}
+
+void
+NvCpuStreams::launch(void *stream, NvCudaJobFunc func, void *user, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Command command;
+
+    command.type = Command::RUN;
+    command.func = func;
+    command.user = user;
+    command.event = NULL;
+    command.generation = 0;
+
+    pthread_mutex_lock(&self->lock);
+    self->push((Stream *) stream, command);
+    pthread_mutex_unlock(&self->lock);
+}
+
+int
+NvCpuStreams::recordEvent(void *event, void *stream, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Command command;
+
+    command.type = Command::RECORD;
+    command.func = NULL;
+    command.user = NULL;
+    command.event = (Event *) event;
+
+    pthread_mutex_lock(&self->lock);
+    command.generation = ++command.event->recorded;
+    self->push((Stream *) stream, command);
+    pthread_mutex_unlock(&self->lock);
+    return 0;
+}
+
+int
+NvCpuStreams::streamWaitEvent(void *stream, void *event, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Command command;
+
+    command.type = Command::WAIT;
+    command.func = NULL;
+    command.user = NULL;
+    command.event = (Event *) event;
+
+    pthread_mutex_lock(&self->lock);
+    command.generation = command.event->recorded;
+    if (command.event->completed < command.generation)
+        self->push((Stream *) stream, command);
+    pthread_mutex_unlock(&self->lock);
+    return 0;
+}
+
+int
+NvCpuStreams::queryEvent(void *handle, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Event *event = (Event *) handle;
+    int done;
+
+    pthread_mutex_lock(&self->lock);
+    done = event->completed >= event->recorded;
+    pthread_mutex_unlock(&self->lock);
+    return done;
+}
+
+int
+NvCpuStreams::synchronizeEvent(void *handle, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    Event *event = (Event *) handle;
+
+    pthread_mutex_lock(&self->lock);
+    uint64_t generation = event->recorded;
+    while (event->completed < generation)
+        pthread_cond_wait(&self->cond, &self->lock);
+    pthread_mutex_unlock(&self->lock);
+    return 0;
+}
+
+float
+NvCpuStreams::elapsedTime(void *start, void *stop, void *arg)
+{
+    NvCpuStreams *self = (NvCpuStreams *) arg;
+    float msec;
+
+    pthread_mutex_lock(&self->lock);
+    msec = (((Event *) stop)->time_usec - ((Event *) start)->time_usec) / 1000.f;
+    pthread_mutex_unlock(&self->lock);
+    return msec;
+}
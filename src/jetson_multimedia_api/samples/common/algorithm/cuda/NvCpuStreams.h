@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __NVCPUSTREAMS_H
+#define __NVCPUSTREAMS_H
+
+#include <deque>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "NvCudaExecutor.h"
+
+// Streams and events of NvCudaExecutor implemented with CPU threads.
+//
+// Each stream is a thread running its queue in order. Events follow the
+// CUDA semantics: a record completes when the stream reaches it, a stream
+// waiting for an event waits for the record made before the wait call,
+// and an event never recorded counts as completed. The same job graph can
+// then be run and checked without a GPU. Priorities are kept for the
+// statistics; all the threads run at the same OS priority.
+class NvCpuStreams
+{
+public:
+    NvCpuStreams();
+
+    // The executors using the streams have to be destroyed first
+    ~NvCpuStreams();
+
+    NvCudaExecutorOps getOps();
+
+    // Largest number of jobs seen running at the same time
+    uint32_t getMaxConcurrency();
+
+private:
+    struct Event
+    {
+        uint64_t recorded;      // generation of the last record
+        uint64_t completed;     // generation of the last completed record
+        uint64_t time_usec;     // completion time of the last record
+    };
+
+    struct Command
+    {
+        enum { RUN, RECORD, WAIT } type;
+        NvCudaJobFunc func;
+        void *user;
+        Event *event;
+        uint64_t generation;
+    };
+
+    struct Stream
+    {
+        NvCpuStreams *owner;
+        int priority;
+        pthread_t thread;
+        std::deque<Command> queue;
+        bool stop;
+    };
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;        // broadcast on every queue or event change
+    uint32_t running;
+    uint32_t max_running;
+
+    void push(Stream *stream, const Command &command);
+    static void *streamThread(void *arg);
+
+    static void *createStream(int priority, void *arg);
+    static void destroyStream(void *stream, void *arg);
+    static void *createEvent(void *arg);
+    static void destroyEvent(void *event, void *arg);
+    static void launch(void *stream, NvCudaJobFunc func, void *user, void *arg);
+    static int recordEvent(void *event, void *stream, void *arg);
+    static int streamWaitEvent(void *stream, void *event, void *arg);
+    static int queryEvent(void *event, void *arg);
+    static int synchronizeEvent(void *event, void *arg);
+    static float elapsedTime(void *start, void *stop, void *arg);
+};
+
+#endif
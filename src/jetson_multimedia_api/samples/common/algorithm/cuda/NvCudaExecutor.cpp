@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "NvCudaExecutor.h"
+
+NvCudaExecutor::NvCudaExecutor(const NvCudaExecutorOps &ops, const int *priorities,
+        uint32_t num_levels, uint32_t streams_per_level)
+    : ops(ops)
+    , num_levels(num_levels)
+    , streams_per_level(streams_per_level)
+    , next_job(1)
+    , next_stream(0)
+{
+    pthread_mutex_init(&lock, NULL);
+
+    for (uint32_t level = 0; level < num_levels; level++)
+    {
+        for (uint32_t i = 0; i < streams_per_level; i++)
+        {
+            Stream stream;
+
+            stream.handle = ops.createStream(priorities[level], ops.arg);
+            if (stream.handle == NULL)
+            {
+                printf("Failed to create stream with priority %d\n", priorities[level]);
+                continue;
+            }
+            stream.level = level;
+            memset(&stream.stats, 0, sizeof(stream.stats));
+            stream.stats.priority = priorities[level];
+            streams.push_back(stream);
+        }
+    }
+}
+
+NvCudaExecutor::~NvCudaExecutor()
+{
+    waitAll();
+
+    pthread_mutex_lock(&lock);
+    for (uint32_t i = 0; i < streams.size(); i++)
+        retire(i);
+    for (std::map<NvCudaJob, Job>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+    {
+        ops.destroyEvent(it->second.start, ops.arg);
+        ops.destroyEvent(it->second.stop, ops.arg);
+    }
+    for (size_t i = 0; i < free_events.size(); i++)
+        ops.destroyEvent(free_events[i], ops.arg);
+    for (size_t i = 0; i < streams.size(); i++)
+        ops.destroyStream(streams[i].handle, ops.arg);
+    pthread_mutex_unlock(&lock);
+
+    pthread_mutex_destroy(&lock);
+}
+
+// Called with the lock held
+void *
+NvCudaExecutor::getEvent()
+{
+    void *event;
+
+    if (free_events.empty())
+        return ops.createEvent(ops.arg);
+    event = free_events.back();
+    free_events.pop_back();
+    return event;
+}
+
+// Called with the lock held. Jobs of a stream complete in order, so the
+// completed ones are at the front of its queue.
+void
+NvCudaExecutor::retire(uint32_t index)
+{
+    Stream &stream = streams[index];
+
+    while (!stream.pending.empty())
+    {
+        std::map<NvCudaJob, Job>::iterator it = jobs.find(stream.pending.front());
+        Job &job = it->second;
+        float msec;
+
+        if (job.waiters || ops.queryEvent(job.stop, ops.arg) != 1)
+            break;
+
+        msec = ops.elapsedTime(job.start, job.stop, ops.arg);
+        stream.stats.jobs++;
+        stream.stats.busy_msec += msec;
+        if (msec > stream.stats.max_msec)
+            stream.stats.max_msec = msec;
+
+        free_events.push_back(job.start);
+        free_events.push_back(job.stop);
+        jobs.erase(it);
+        stream.pending.pop_front();
+    }
+}
+
+// Called with the lock held
+uint32_t
+NvCudaExecutor::pickStream(uint32_t level, const NvCudaJob *deps, uint32_t num_deps)
+{
+    uint32_t best = streams.size();
+
+    // Chain after a dependency that is the last job of a stream of the level
+    for (uint32_t i = 0; i < num_deps; i++)
+    {
+        std::map<NvCudaJob, Job>::iterator it = jobs.find(deps[i]);
+
+        if (it == jobs.end())
+            continue;
+        Stream &stream = streams[it->second.stream];
+        if (stream.level == level && stream.pending.back() == deps[i])
+        {
+            stream.stats.chained++;
+            return it->second.stream;
+        }
+    }
+
+    // Otherwise the least loaded stream of the level, round robin on ties
+    for (uint32_t i = 0; i < streams.size(); i++)
+    {
+        uint32_t index = (next_stream + i) % streams.size();
+
+        if (streams[index].level != level)
+            continue;
+        retire(index);
+        if (best == streams.size() ||
+            streams[index].pending.size() < streams[best].pending.size())
+            best = index;
+    }
+    if (best < streams.size())
+        next_stream = best + 1;
+    return best;
+}
+
+NvCudaJob
+NvCudaExecutor::submitJob(NvCudaJobFunc func, void *user, uint32_t level,
+        const NvCudaJob *deps, uint32_t num_deps, uint32_t waiters)
+{
+    NvCudaJob id = 0;
+    uint32_t index;
+    Job job;
+
+    pthread_mutex_lock(&lock);
+
+    for (uint32_t i = 0; i < num_deps; i++)
+    {
+        if (deps[i] >= next_job)
+        {
+            printf("Unknown CUDA job %llu\n", (unsigned long long) deps[i]);
+            goto done;
+        }
+    }
+
+    index = pickStream(level, deps, num_deps);
+    if (func == NULL || index == streams.size())
+        goto done;
+
+    // Dependencies queued on the same stream complete first anyway
+    for (uint32_t i = 0; i < num_deps; i++)
+    {
+        std::map<NvCudaJob, Job>::iterator it = jobs.find(deps[i]);
+
+        if (it == jobs.end() || it->second.stream == index)
+            continue;
+        if (ops.streamWaitEvent(streams[index].handle, it->second.stop, ops.arg) < 0)
+            goto done;
+        streams[index].stats.event_waits++;
+    }
+
+    job.stream = index;
+    job.waiters = waiters;
+    job.start = getEvent();
+    job.stop = getEvent();
+    if (job.start == NULL || job.stop == NULL)
+    {
+        if (job.start)
+            free_events.push_back(job.start);
+        if (job.stop)
+            free_events.push_back(job.stop);
+        goto done;
+    }
+
+    ops.recordEvent(job.start, streams[index].handle, ops.arg);
+    ops.launch(streams[index].handle, func, user, ops.arg);
+    ops.recordEvent(job.stop, streams[index].handle, ops.arg);
+
+    id = next_job++;
+    jobs[id] = job;
+    streams[index].pending.push_back(id);
+
+done:
+    pthread_mutex_unlock(&lock);
+    return id;
+}
+
+NvCudaJob
+NvCudaExecutor::submit(NvCudaJobFunc func, void *user, uint32_t level,
+        const NvCudaJob *deps, uint32_t num_deps)
+{
+    return submitJob(func, user, level, deps, num_deps, 0);
+}
+
+// Waits for a job whose waiters count includes the caller
+int
+NvCudaExecutor::waitJob(NvCudaJob job, float *msec)
+{
+    std::map<NvCudaJob, Job>::iterator it;
+    void *stop;
+    int ret;
+
+    pthread_mutex_lock(&lock);
+    stop = jobs[job].stop;
+    pthread_mutex_unlock(&lock);
+
+    // The job is not retired while it has waiters, so stop stays valid
+    ret = ops.synchronizeEvent(stop, ops.arg);
+
+    pthread_mutex_lock(&lock);
+    it = jobs.find(job);
+    if (msec)
+        *msec = ret == 0 ? ops.elapsedTime(it->second.start, stop, ops.arg) : 0;
+    it->second.waiters--;
+    retire(it->second.stream);
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+int
+NvCudaExecutor::wait(NvCudaJob job, float *msec)
+{
+    std::map<NvCudaJob, Job>::iterator it;
+
+    if (msec)
+        *msec = 0;
+
+    pthread_mutex_lock(&lock);
+    it = jobs.find(job);
+    if (it == jobs.end())
+    {
+        pthread_mutex_unlock(&lock);
+        return job && job < next_job ? 0 : -1;
+    }
+    it->second.waiters++;
+    pthread_mutex_unlock(&lock);
+
+    return waitJob(job, msec);
+}
+
+int
+NvCudaExecutor::run(NvCudaJobFunc func, void *user, uint32_t level, float *msec)
+{
+    NvCudaJob job = submitJob(func, user, level, NULL, 0, 1);
+
+    if (msec)
+        *msec = 0;
+    if (job == 0)
+        return -1;
+    return waitJob(job, msec);
+}
+
+int
+NvCudaExecutor::waitAll()
+{
+    std::vector<NvCudaJob> pending;
+    int ret = 0;
+
+    pthread_mutex_lock(&lock);
+    for (std::map<NvCudaJob, Job>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+        pending.push_back(it->first);
+    pthread_mutex_unlock(&lock);
+
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        if (wait(pending[i]) < 0)
+            ret = -1;
+    }
+    return ret;
+}
+
+uint32_t
+NvCudaExecutor::getNumLevels()
+{
+    return num_levels;
+}
+
+uint32_t
+NvCudaExecutor::getNumStreams()
+{
+    return streams.size();
+}
+
+NvCudaStreamStats
+NvCudaExecutor::getStreamStats(uint32_t index)
+{
+    NvCudaStreamStats stats;
+
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_lock(&lock);
+    if (index < streams.size())
+    {
+        retire(index);
+        stats = streams[index].stats;
+    }
+    pthread_mutex_unlock(&lock);
+    return stats;
+}
+
+void
+NvCudaExecutor::printStats(const char *name)
+{
+    printf("----------- %s CUDA streams -----------\n", name);
+    for (uint32_t i = 0; i < getNumStreams(); i++)
+    {
+        NvCudaStreamStats stats = getStreamStats(i);
+
+        printf("Stream %u (priority %d): jobs %llu, chained %llu, event waits %llu",
+                i, stats.priority, (unsigned long long) stats.jobs,
+                (unsigned long long) stats.chained,
+                (unsigned long long) stats.event_waits);
+        if (stats.jobs)
+            printf(", average %.3f ms, max %.3f ms",
+                    stats.busy_msec / stats.jobs, stats.max_msec);
+        printf("\n");
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __NVCUDAEXECUTOR_H
+#define __NVCUDAEXECUTOR_H
+
+#include <deque>
+#include <map>
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+// Process-wide pool of prioritized streams with event-based dependencies.
+//
+// Work submitted on the legacy default stream serializes against every
+// other blocking stream of the context, so the frames of independent
+// decoders wait for each other on the GPU. The executor owns a fixed set
+// of non-blocking streams per priority level. Each job is queued on one of
+// them, after the jobs it depends on, and is timed with a pair of events.
+//
+// A job goes to the stream of its level that already ends with one of its
+// dependencies, so chains of jobs stay on one stream; otherwise it goes to
+// the least loaded stream of its level. Dependencies on other streams are
+// waited for on the GPU with an event, never on the host.
+//
+// The executor does not call CUDA itself; the stream and event calls are
+// passed in, so that the scheduling can be run on CPU threads by
+// NvCpuStreams and tested without a GPU.
+
+// Identifier of a submitted job, 0 for none
+typedef uint64_t NvCudaJob;
+
+// Queues the work of a job on stream, a stream created by createStream
+typedef void (*NvCudaJobFunc)(void *stream, void *user);
+
+// Stream and event calls used by the executor
+typedef struct
+{
+    // Creates a non-blocking stream, returns NULL on failure
+    void *(*createStream)(int priority, void *arg);
+    void (*destroyStream)(void *stream, void *arg);
+    // Creates a timing event, returns NULL on failure
+    void *(*createEvent)(void *arg);
+    void (*destroyEvent)(void *event, void *arg);
+    // Queues the work of a job; func may run later, on another thread
+    void (*launch)(void *stream, NvCudaJobFunc func, void *user, void *arg);
+    int (*recordEvent)(void *event, void *stream, void *arg);
+    // Makes the work queued next on stream wait for the last record of event
+    int (*streamWaitEvent)(void *stream, void *event, void *arg);
+    // Returns 1 if the last record of event completed, 0 if not, -1 on error
+    int (*queryEvent)(void *event, void *arg);
+    // Waits on the host for the last record of event
+    int (*synchronizeEvent)(void *event, void *arg);
+    // Milliseconds between two completed events
+    float (*elapsedTime)(void *start, void *stop, void *arg);
+    void *arg;
+} NvCudaExecutorOps;
+
+typedef struct
+{
+    int priority;               // backend priority of the stream
+    uint64_t jobs;              // jobs completed
+    uint64_t chained;           // jobs queued after a dependency on the stream
+    uint64_t event_waits;       // dependencies waited for on another stream
+    double busy_msec;           // total time of the completed jobs
+    float max_msec;             // longest job
+} NvCudaStreamStats;
+
+class NvCudaExecutor
+{
+public:
+    // Creates streams_per_level streams for each of the num_levels
+    // priorities, from the highest priority level 0 to the lowest
+    NvCudaExecutor(const NvCudaExecutorOps &ops, const int *priorities,
+                   uint32_t num_levels, uint32_t streams_per_level);
+
+    // Waits for all jobs and destroys the streams
+    ~NvCudaExecutor();
+
+    // Queues func on a stream of level, after the jobs in deps. Jobs that
+    // already completed and were waited for may be passed. user has to stay
+    // valid until the job completes. Returns 0 on failure.
+    NvCudaJob submit(NvCudaJobFunc func, void *user, uint32_t level,
+                     const NvCudaJob *deps = NULL, uint32_t num_deps = 0);
+
+    // Waits on the host for a job, and returns its time in msec if not NULL.
+    // A job that completed and was retired returns at once, with 0 msec.
+    int wait(NvCudaJob job, float *msec = NULL);
+
+    // Submits a job without dependencies and waits for it
+    int run(NvCudaJobFunc func, void *user, uint32_t level, float *msec = NULL);
+
+    // Waits for every job submitted so far
+    int waitAll();
+
+    uint32_t getNumLevels();
+
+    uint32_t getNumStreams();
+
+    // Statistics of stream index, streams_per_level streams per level
+    NvCudaStreamStats getStreamStats(uint32_t index);
+
+    void printStats(const char *name);
+
+private:
+    struct Job
+    {
+        uint32_t stream;
+        void *start;
+        void *stop;
+        uint32_t waiters;       // wait() calls on the job in progress
+    };
+
+    struct Stream
+    {
+        void *handle;
+        uint32_t level;
+        std::deque<NvCudaJob> pending;  // submitted jobs, in order
+        NvCudaStreamStats stats;
+    };
+
+    NvCudaExecutorOps ops;
+    uint32_t num_levels;
+    uint32_t streams_per_level;
+    std::vector<Stream> streams;
+    std::map<NvCudaJob, Job> jobs;      // jobs not retired yet
+    std::vector<void *> free_events;
+    NvCudaJob next_job;
+    uint32_t next_stream;               // round robin among equal loads
+    pthread_mutex_t lock;
+
+    void *getEvent();
+    NvCudaJob submitJob(NvCudaJobFunc func, void *user, uint32_t level,
+                        const NvCudaJob *deps, uint32_t num_deps, uint32_t waiters);
+    int waitJob(NvCudaJob job, float *msec);
+    void retire(uint32_t index);
+    uint32_t pickStream(uint32_t level, const NvCudaJob *deps, uint32_t num_deps);
+};
+
+#endif
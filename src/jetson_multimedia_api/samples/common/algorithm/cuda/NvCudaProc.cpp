@@ -27,6 +27,8 @@
  */
 
 #include <stdio.h>
+#include <pthread.h>
+#include <time.h>
 #include <cuda_runtime_api.h>
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
@@ -40,69 +42,393 @@
 #include "NvAnalysis.h"
 
 #include "NvCudaProc.h"
+#include "NvEglRegistrationCache.h"
 
-static void
-Handle_EGLImage(EGLImageKHR image);
+// Registrations kept per process; decoders and cameras use a few dozen buffers
+#define MAX_CACHED_EGL_IMAGES 64
 
-void
-HandleEGLImage(void *pEGLImage)
+// Streams per priority level of the shared executor
+#define CUDA_STREAMS_PER_LEVEL 4
+
+// CUDA registration of an EGLImage, with the events timing its work
+struct EglRegistration
 {
-    EGLImageKHR *pImage = (EGLImageKHR *)pEGLImage;
-    Handle_EGLImage(*pImage);
+    CUgraphicsResource resource;
+    CUeglFrame frame;
+    cudaEvent_t start;
+    cudaEvent_t stop;
+};
+
+// Per-frame statistics, over cached and uncached registrations
+static struct
+{
+    pthread_mutex_t lock;
+    uint64_t frames;
+    uint64_t uncached_registrations;
+    uint64_t uncached_register_usec;
+    double kernel_msec;
+    float max_kernel_msec;
+} proc_stats = { PTHREAD_MUTEX_INITIALIZER, 0, 0, 0, 0, 0 };
+
+// Work of one frame on a registered image, queued on pstream
+typedef void (*FrameFunc)(EglRegistration *reg, void *pstream, void *user);
+
+struct FrameJob
+{
+    FrameFunc func;
+    EglRegistration *reg;
+    void *user;
+};
+
+static pthread_once_t context_once = PTHREAD_ONCE_INIT;
+static CUcontext primary_context;
+
+static uint64_t
+getTimeUsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
 }
 
+static void
+retainPrimaryContext(void)
+{
+    CUdevice device;
+
+    if (cuInit(0) != CUDA_SUCCESS || cuDeviceGet(&device, 0) != CUDA_SUCCESS ||
+        cuDevicePrimaryCtxRetain(&primary_context, device) != CUDA_SUCCESS)
+    {
+        printf("Failed to retain the primary CUDA context\n");
+        primary_context = NULL;
+    }
+}
 
 /**
-  * Performs CUDA Operations on egl image.
-  *
-  * @param image : EGL image
+  * Makes the primary context current. The runtime API uses the same
+  * context, so streams and registrations are shared by all threads.
   */
+void
+bindCudaContext(void)
+{
+    pthread_once(&context_once, retainPrimaryContext);
+    if (primary_context)
+        cuCtxSetCurrent(primary_context);
+}
+
+static void *
+createCudaStream(int priority, void *arg)
+{
+    cudaStream_t stream;
+
+    if (cudaStreamCreateWithPriority(&stream, cudaStreamNonBlocking, priority) != cudaSuccess)
+        return NULL;
+    return stream;
+}
+
+static void
+destroyCudaStream(void *stream, void *arg)
+{
+    cudaStreamDestroy((cudaStream_t) stream);
+}
+
+static void *
+createCudaEvent(void *arg)
+{
+    cudaEvent_t event;
+
+    if (cudaEventCreate(&event) != cudaSuccess)
+        return NULL;
+    return event;
+}
+
+static void
+destroyCudaEvent(void *event, void *arg)
+{
+    cudaEventDestroy((cudaEvent_t) event);
+}
+
+// Kernels are queued on the stream from the submitting thread
 static void
-Handle_EGLImage(EGLImageKHR image)
+launchCudaJob(void *stream, NvCudaJobFunc func, void *user, void *arg)
+{
+    bindCudaContext();
+    func(stream, user);
+}
+
+static int
+recordCudaEvent(void *event, void *stream, void *arg)
+{
+    return cudaEventRecord((cudaEvent_t) event, (cudaStream_t) stream) == cudaSuccess ? 0 : -1;
+}
+
+static int
+streamWaitCudaEvent(void *stream, void *event, void *arg)
+{
+    return cudaStreamWaitEvent((cudaStream_t) stream, (cudaEvent_t) event, 0) ==
+        cudaSuccess ? 0 : -1;
+}
+
+static int
+queryCudaEvent(void *event, void *arg)
+{
+    cudaError_t status = cudaEventQuery((cudaEvent_t) event);
+
+    if (status == cudaErrorNotReady)
+        return 0;
+    return status == cudaSuccess ? 1 : -1;
+}
+
+static int
+synchronizeCudaEvent(void *event, void *arg)
+{
+    return cudaEventSynchronize((cudaEvent_t) event) == cudaSuccess ? 0 : -1;
+}
+
+static float
+cudaEventTime(void *start, void *stop, void *arg)
+{
+    float msec = 0;
+
+    cudaEventElapsedTime(&msec, (cudaEvent_t) start, (cudaEvent_t) stop);
+    return msec;
+}
+
+static NvCudaExecutor *
+createCudaExecutor(void)
+{
+    static const NvCudaExecutorOps ops = {
+        createCudaStream, destroyCudaStream, createCudaEvent, destroyCudaEvent,
+        launchCudaJob, recordCudaEvent, streamWaitCudaEvent, queryCudaEvent,
+        synchronizeCudaEvent, cudaEventTime, NULL
+    };
+    int least = 0, greatest = 0;
+
+    bindCudaContext();
+    cudaDeviceGetStreamPriorityRange(&least, &greatest);
+
+    int priorities[] = { greatest, least };
+    return new NvCudaExecutor(ops, priorities, 2, CUDA_STREAMS_PER_LEVEL);
+}
+
+// Never destroyed, the streams go away with the context at exit
+NvCudaExecutor&
+getCudaExecutor(void)
+{
+    static NvCudaExecutor *executor = createCudaExecutor();
+
+    return *executor;
+}
+
+static void *
+registerEGLImage(void *image, void *arg)
 {
     CUresult status;
-    CUeglFrame eglFrame;
-    CUgraphicsResource pResource = NULL;
+    EglRegistration *reg = new EglRegistration;
 
-    cudaFree(0);
-    status = cuGraphicsEGLRegisterImage(&pResource, image,
+    status = cuGraphicsEGLRegisterImage(&reg->resource, (EGLImageKHR) image,
                 CU_GRAPHICS_MAP_RESOURCE_FLAGS_NONE);
     if (status != CUDA_SUCCESS)
     {
         printf("cuGraphicsEGLRegisterImage failed: %d, cuda process stop\n",
                         status);
-        return;
+        delete reg;
+        return NULL;
     }
 
-    status = cuGraphicsResourceGetMappedEglFrame(&eglFrame, pResource, 0, 0);
+    // The mapped frame stays valid as long as the image is registered
+    status = cuGraphicsResourceGetMappedEglFrame(&reg->frame, reg->resource, 0, 0);
     if (status != CUDA_SUCCESS)
     {
         printf("cuGraphicsSubResourceGetMappedArray failed\n");
+        cuGraphicsUnregisterResource(reg->resource);
+        delete reg;
+        return NULL;
     }
 
-    status = cuCtxSynchronize();
+    cudaEventCreate(&reg->start);
+    cudaEventCreate(&reg->stop);
+    return reg;
+}
+
+static void
+unregisterEGLImage(void *handle, void *arg)
+{
+    EglRegistration *reg = (EglRegistration *) handle;
+    CUresult status;
+
+    // Work queued on the image has been waited for by finishEGLImage()
+    cudaEventDestroy(reg->start);
+    cudaEventDestroy(reg->stop);
+    status = cuGraphicsUnregisterResource(reg->resource);
     if (status != CUDA_SUCCESS)
     {
-        printf("cuCtxSynchronize failed\n");
+        printf("cuGraphicsEGLUnRegisterResource failed: %d\n", status);
     }
+    delete reg;
+}
 
-    if (eglFrame.frameType == CU_EGL_FRAME_TYPE_PITCH)
+static NvEglRegistrationCache&
+getEGLImageCache(void)
+{
+    static const NvEglRegistrationOps ops = { registerEGLImage, unregisterEGLImage, NULL };
+    static NvEglRegistrationCache cache(ops, MAX_CACHED_EGL_IMAGES);
+
+    return cache;
+}
+
+static EglRegistration *
+acquireEGLImage(EGLImageKHR image, int dmabuf_fd)
+{
+    EglRegistration *reg;
+    uint64_t start;
+
+    bindCudaContext();
+    if (dmabuf_fd >= 0)
+        return (EglRegistration *) getEGLImageCache().acquire(dmabuf_fd, image);
+
+    start = getTimeUsec();
+    reg = (EglRegistration *) registerEGLImage(image, NULL);
+    start = getTimeUsec() - start;
+
+    pthread_mutex_lock(&proc_stats.lock);
+    proc_stats.uncached_registrations++;
+    proc_stats.uncached_register_usec += start;
+    pthread_mutex_unlock(&proc_stats.lock);
+    return reg;
+}
+
+static void
+releaseEGLImage(EglRegistration *reg, int dmabuf_fd)
+{
+    if (dmabuf_fd >= 0)
+        getEGLImageCache().release(dmabuf_fd, reg);
+    else
+        unregisterEGLImage(reg, NULL);
+}
+
+static void
+recordFrameTime(float msec)
+{
+    pthread_mutex_lock(&proc_stats.lock);
+    proc_stats.frames++;
+    proc_stats.kernel_msec += msec;
+    if (msec > proc_stats.max_kernel_msec)
+        proc_stats.max_kernel_msec = msec;
+    pthread_mutex_unlock(&proc_stats.lock);
+}
+
+/**
+  * Waits for the work queued on the image since its start event, on
+  * that stream only, and records its time.
+  */
+static void
+finishEGLImage(EglRegistration *reg, cudaStream_t stream)
+{
+    float msec = 0;
+
+    cudaEventRecord(reg->stop, stream);
+    if (cudaEventSynchronize(reg->stop) != cudaSuccess)
     {
-        //Rect label in plan Y, you can replace this with any cuda algorithms.
-        addLabels((CUdeviceptr) eglFrame.frame.pPitch[0], eglFrame.pitch);
+        printf("cudaEventSynchronize failed\n");
+        return;
     }
+    cudaEventElapsedTime(&msec, reg->start, reg->stop);
+    recordFrameTime(msec);
+}
 
-    status = cuCtxSynchronize();
-    if (status != CUDA_SUCCESS)
+static void
+runFrameJob(void *stream, void *user)
+{
+    FrameJob *job = (FrameJob *) user;
+    cudaStream_t cuda_stream = (cudaStream_t) stream;
+
+    job->func(job->reg, &cuda_stream, job->user);
+}
+
+/**
+  * Runs the work of a frame on pstream, or as a job of the shared
+  * executor, and waits for it.
+  */
+static void
+processEGLImage(EglRegistration *reg, void *pstream, FrameFunc func, void *user)
+{
+    FrameJob job = { func, reg, user };
+    float msec;
+
+    if (pstream)
     {
-        printf("cuCtxSynchronize failed after memcpy\n");
+        cudaStream_t stream = *(cudaStream_t *)pstream;
+
+        cudaEventRecord(reg->start, stream);
+        func(reg, pstream, user);
+        finishEGLImage(reg, stream);
+        return;
     }
 
-    status = cuGraphicsUnregisterResource(pResource);
-    if (status != CUDA_SUCCESS)
+    if (getCudaExecutor().run(runFrameJob, &job, CUDA_PRIORITY_NORMAL, &msec) < 0)
     {
-        printf("cuGraphicsEGLUnRegisterResource failed: %d\n", status);
+        printf("CUDA job failed\n");
+        return;
     }
+    recordFrameTime(msec);
+}
+
+static void
+addLabelsFrame(EglRegistration *reg, void *pstream, void *user)
+{
+    //Rect label in plan Y, you can replace this with any cuda algorithms.
+    addLabels((CUdeviceptr) reg->frame.frame.pPitch[0], reg->frame.pitch, pstream);
+}
+
+/**
+  * Performs CUDA Operations on egl image.
+  *
+  * @param pEGLImage : EGL image
+  * @param dmabuf_fd : dmabuf fd of the image, -1 to not cache the registration
+  * @param pstream : cuda stream, NULL for a stream of the shared executor
+  */
+void
+HandleEGLImage(void *pEGLImage, int dmabuf_fd, void *pstream)
+{
+    EGLImageKHR *pImage = (EGLImageKHR *)pEGLImage;
+    EglRegistration *reg;
+
+    reg = acquireEGLImage(*pImage, dmabuf_fd);
+    if (reg == NULL)
+        return;
+
+    if (reg->frame.frameType == CU_EGL_FRAME_TYPE_PITCH)
+        processEGLImage(reg, pstream, addLabelsFrame, NULL);
+
+    releaseEGLImage(reg, dmabuf_fd);
+}
+
+struct FloatConversion
+{
+    int width;
+    int height;
+    COLOR_FORMAT color_format;
+    void *cuda_buf;
+    void *offsets;
+    void *scales;
+};
+
+static void
+convertFrame(EglRegistration *reg, void *pstream, void *user)
+{
+    FloatConversion *conv = (FloatConversion *) user;
+
+    // Using GPU to convert int buffer into float buffer.
+    convertIntToFloat((CUdeviceptr) reg->frame.frame.pPitch[0],
+                      conv->width,
+                      conv->height,
+                      reg->frame.pitch,
+                      conv->color_format,
+                      conv->offsets,
+                      conv->scales,
+                      conv->cuda_buf, pstream);
 }
 
 /**
@@ -113,63 +439,117 @@ Handle_EGLImage(EGLImageKHR image)
   * @param height: Image height
   * @param color_format: The input color format
   * @param cuda_buf: destnation cuda address
+  * @param dmabuf_fd: dmabuf fd of the image, -1 to not cache the registration
+  * @param pstream: cuda stream, NULL for a stream of the shared executor
   */
 void mapEGLImage2Float(void* pEGLImage, int width, int height,
                         COLOR_FORMAT color_format,
                         void* cuda_buf,
                         void* offsets,
-                        void* scales)
+                        void* scales,
+                        int dmabuf_fd,
+                        void* pstream)
 {
-    CUresult status;
-    CUeglFrame eglFrame;
-    CUgraphicsResource pResource = NULL;
     EGLImageKHR *pImage = (EGLImageKHR *)pEGLImage;
+    FloatConversion conv = { width, height, color_format, cuda_buf, offsets, scales };
+    EglRegistration *reg;
 
-    cudaFree(0);
-    status = cuGraphicsEGLRegisterImage(&pResource, *pImage,
-                CU_GRAPHICS_MAP_RESOURCE_FLAGS_NONE);
-    if (status != CUDA_SUCCESS)
-    {
-        printf("cuGraphicsEGLRegisterImage failed: %d, cuda process stop\n",
-                        status);
+    reg = acquireEGLImage(*pImage, dmabuf_fd);
+    if (reg == NULL)
         return;
-    }
 
-    status = cuGraphicsResourceGetMappedEglFrame(&eglFrame, pResource, 0, 0);
-    if (status != CUDA_SUCCESS)
-    {
-        printf("cuGraphicsSubResourceGetMappedArray failed\n");
-    }
+    if (reg->frame.frameType == CU_EGL_FRAME_TYPE_PITCH)
+        processEGLImage(reg, pstream, convertFrame, &conv);
 
-    status = cuCtxSynchronize();
-    if (status != CUDA_SUCCESS)
-    {
-        printf("cuCtxSynchronize failed\n");
-    }
+    releaseEGLImage(reg, dmabuf_fd);
+}
 
-    if (eglFrame.frameType == CU_EGL_FRAME_TYPE_PITCH)
-    {
-        // Using GPU to convert int buffer into float buffer.
-        convertIntToFloat((CUdeviceptr) eglFrame.frame.pPitch[0],
-                          width,
-                          height,
-                          eglFrame.pitch,
-                          color_format,
-                          offsets,
-                          scales,
-                          cuda_buf);
-    }
-    status = cuCtxSynchronize();
-    if (status != CUDA_SUCCESS)
-    {
-        printf("cuCtxSynchronize failed after memcpy\n");
-    }
+struct Preprocessing
+{
+    NvPreprocessParams params;
+    void *cuda_buf;
+    int ret;
+};
 
-    status = cuGraphicsUnregisterResource(pResource);
-    if (status != CUDA_SUCCESS)
-    {
-        printf("cuGraphicsEGLUnRegisterResource failed: %d\n", status);
-    }
+static void
+preprocessFrame(EglRegistration *reg, void *pstream, void *user)
+{
+    Preprocessing *pre = (Preprocessing *) user;
+
+    pre->params.src_pitch = reg->frame.pitch;
+    pre->ret = preprocessImage((CUdeviceptr) reg->frame.frame.pPitch[0],
+                               &pre->params, pre->cuda_buf, pstream);
+}
+
+/**
+  * Preprocesses an egl image into a tensor in one kernel.
+  *
+  * @param pEGLImage: EGL image
+  * @param params: preprocessing parameters, src_pitch is ignored
+  * @param cuda_buf: destination cuda address
+  * @param dmabuf_fd: dmabuf fd of the image, -1 to not cache the registration
+  * @param pstream: cuda stream, NULL for a stream of the shared executor
+  */
+int preprocessEGLImage(void* pEGLImage, const NvPreprocessParams* params,
+                        void* cuda_buf, int dmabuf_fd, void* pstream)
+{
+    EGLImageKHR *pImage = (EGLImageKHR *)pEGLImage;
+    Preprocessing pre;
+    EglRegistration *reg;
+
+    reg = acquireEGLImage(*pImage, dmabuf_fd);
+    if (reg == NULL)
+        return -1;
+
+    pre.params = *params;
+    pre.cuda_buf = cuda_buf;
+    pre.ret = -1;
+    if (reg->frame.frameType == CU_EGL_FRAME_TYPE_PITCH)
+        processEGLImage(reg, pstream, preprocessFrame, &pre);
+
+    releaseEGLImage(reg, dmabuf_fd);
+    return pre.ret;
+}
+
+void invalidateEGLImage(int dmabuf_fd)
+{
+    getEGLImageCache().invalidate(dmabuf_fd);
+}
+
+void clearEGLImageCache(void)
+{
+    getEGLImageCache().clear();
+}
+
+void printEGLImageStats(void)
+{
+    NvEglRegistrationStats stats = getEGLImageCache().getStats();
+    uint64_t registrations;
+    uint64_t register_usec;
+
+    pthread_mutex_lock(&proc_stats.lock);
+    registrations = stats.registrations + proc_stats.uncached_registrations;
+    register_usec = stats.register_usec + proc_stats.uncached_register_usec;
+
+    printf("----------- EGLImage CUDA statistics -----------\n");
+    printf("Frames processed: %llu\n", (unsigned long long) proc_stats.frames);
+    printf("Registrations: %llu (cached %llu, hits %llu, stale %llu, evicted %llu)\n",
+            (unsigned long long) registrations,
+            (unsigned long long) stats.registrations,
+            (unsigned long long) stats.hits,
+            (unsigned long long) stats.stale,
+            (unsigned long long) stats.evictions);
+    if (registrations)
+        printf("Average registration time: %.1f us\n",
+                (double) register_usec / registrations);
+    if (proc_stats.frames)
+        printf("GPU time per frame: average %.3f ms, max %.3f ms\n",
+                proc_stats.kernel_msec / proc_stats.frames,
+                proc_stats.max_kernel_msec);
+    printf("------------------------------------------------\n");
+    pthread_mutex_unlock(&proc_stats.lock);
+
+    getCudaExecutor().printStats("Shared");
 }
 
 void convertEglFrameIntToFloat(void* pEglFrame, int width, int height,
@@ -29,19 +29,56 @@
 #ifndef __NVCUDAPROC_H
 #define __NVCUDAPROC_H
 
+#include "NvCudaExecutor.h"
+#include "NvPreprocess.h"
+
 typedef enum {
     COLOR_FORMAT_RGB,
     COLOR_FORMAT_BGR,
 } COLOR_FORMAT;
 
-void HandleEGLImage(void* pEGLImage);
+// Priority levels of the shared executor
+#define CUDA_PRIORITY_HIGH 0
+#define CUDA_PRIORITY_NORMAL 1
+
+// Makes the primary CUDA context of the device current on the calling
+// thread. Every sample thread shares this one context.
+void bindCudaContext(void);
+
+// Executor shared by the process, with non-blocking streams at the highest
+// and at the default CUDA priority. Jobs queue their kernels from the
+// submitting thread.
+NvCudaExecutor& getCudaExecutor(void);
+
+// With dmabuf_fd set, the CUDA registration of the EGLImage is cached
+// until invalidateEGLImage(dmabuf_fd); otherwise it is registered for this
+// call only. The work is queued on the stream pointed to by pstream, or as
+// a job of getCudaExecutor(), and waited for with an event on that stream.
+void HandleEGLImage(void* pEGLImage, int dmabuf_fd = -1, void* pstream = NULL);
 
 void mapEGLImage2Float(void* pEGLImage, int width, int height, COLOR_FORMAT color_format,
                         void* cuda_buf, void* offsets,
-                        void* scales);
+                        void* scales, int dmabuf_fd = -1, void* pstream = NULL);
+
+// Runs the fused preprocessing of preprocessImage() on an EGLImage, with
+// the pitch of the mapped frame. Returns -1 if the image cannot be mapped
+// or the parameters are invalid.
+int preprocessEGLImage(void* pEGLImage, const NvPreprocessParams* params,
+                        void* cuda_buf, int dmabuf_fd = -1, void* pstream = NULL);
 
 void convertEglFrameIntToFloat(void* pEglFrame, int width, int height,
                         COLOR_FORMAT color_format, void* cuda_buf,void* offsets,
                         void* scales,  void* pstream);
 
+// Drops the cached registration of dmabuf_fd. Call it before unmapping the
+// EGLImage of the buffer or destroying the buffer.
+void invalidateEGLImage(int dmabuf_fd);
+
+// Drops every cached registration
+void clearEGLImageCache(void);
+
+// Prints the registration cache statistics, the per-frame timings and the
+// statistics of the shared executor
+void printEGLImageStats(void);
+
 #endif
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "NvEglRegistrationCache.h"
+
+static uint64_t
+getTimeUsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+NvEglRegistrationCache::NvEglRegistrationCache(const NvEglRegistrationOps &ops,
+        uint32_t max_entries)
+    : ops(ops)
+    , max_entries(max_entries)
+    , use_count(0)
+{
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&lock, NULL);
+}
+
+NvEglRegistrationCache::~NvEglRegistrationCache()
+{
+    clear();
+    pthread_mutex_destroy(&lock);
+}
+
+// Called with the lock held, on an entry without users
+void
+NvEglRegistrationCache::unregisterEntry(size_t i)
+{
+    ops.unregisterImage(entries[i].handle, ops.arg);
+    stats.unregistrations++;
+    entries[i] = entries.back();
+    entries.pop_back();
+}
+
+// Called with the lock held
+void
+NvEglRegistrationCache::evictIdle()
+{
+    while (entries.size() > max_entries)
+    {
+        size_t oldest = entries.size();
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].users == 0 &&
+                (oldest == entries.size() || entries[i].last_use < entries[oldest].last_use))
+                oldest = i;
+        }
+        if (oldest == entries.size())
+            break;
+        unregisterEntry(oldest);
+        stats.evictions++;
+    }
+}
+
+void *
+NvEglRegistrationCache::acquire(int fd, void *image)
+{
+    void *handle;
+    uint64_t start;
+    Entry entry;
+
+    pthread_mutex_lock(&lock);
+    stats.lookups++;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].fd != fd || entries[i].invalid)
+            continue;
+
+        if (entries[i].image == image)
+        {
+            entries[i].users++;
+            entries[i].last_use = ++use_count;
+            stats.hits++;
+            handle = entries[i].handle;
+            pthread_mutex_unlock(&lock);
+            return handle;
+        }
+
+        // The buffer was mapped to a new EGLImage without invalidate()
+        stats.stale++;
+        if (entries[i].users == 0)
+            unregisterEntry(i);
+        else
+            entries[i].invalid = true;
+        break;
+    }
+
+    // Registering can take milliseconds; other fds may be used meanwhile
+    pthread_mutex_unlock(&lock);
+    start = getTimeUsec();
+    handle = ops.registerImage(image, ops.arg);
+    start = getTimeUsec() - start;
+    pthread_mutex_lock(&lock);
+
+    stats.register_usec += start;
+    if (handle)
+    {
+        stats.registrations++;
+        entry.fd = fd;
+        entry.image = image;
+        entry.handle = handle;
+        entry.users = 1;
+        entry.last_use = ++use_count;
+        entry.invalid = false;
+        entries.push_back(entry);
+        evictIdle();
+    }
+    pthread_mutex_unlock(&lock);
+    return handle;
+}
+
+void
+NvEglRegistrationCache::release(int fd, void *handle)
+{
+    pthread_mutex_lock(&lock);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].fd == fd && entries[i].handle == handle)
+        {
+            if (--entries[i].users == 0)
+            {
+                if (entries[i].invalid)
+                    unregisterEntry(i);
+                else
+                    evictIdle();
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvEglRegistrationCache::invalidate(int fd)
+{
+    pthread_mutex_lock(&lock);
+    for (size_t i = 0; i < entries.size(); )
+    {
+        if (entries[i].fd != fd || entries[i].invalid)
+        {
+            i++;
+            continue;
+        }
+        stats.invalidations++;
+        if (entries[i].users == 0)
+        {
+            unregisterEntry(i);
+            continue;
+        }
+        entries[i].invalid = true;
+        i++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvEglRegistrationCache::clear()
+{
+    pthread_mutex_lock(&lock);
+    for (size_t i = 0; i < entries.size(); )
+    {
+        if (!entries[i].invalid)
+            stats.invalidations++;
+        if (entries[i].users == 0)
+        {
+            unregisterEntry(i);
+            continue;
+        }
+        entries[i].invalid = true;
+        i++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+uint32_t
+NvEglRegistrationCache::getNumEntries()
+{
+    uint32_t num;
+
+    pthread_mutex_lock(&lock);
+    num = entries.size();
+    pthread_mutex_unlock(&lock);
+    return num;
+}
+
+NvEglRegistrationStats
+NvEglRegistrationCache::getStats()
+{
+    NvEglRegistrationStats copy;
+
+    pthread_mutex_lock(&lock);
+    copy = stats;
+    pthread_mutex_unlock(&lock);
+    return copy;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __NVEGLREGISTRATIONCACHE_H
+#define __NVEGLREGISTRATIONCACHE_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+// Cache of the CUDA registrations of EGLImages, keyed by dmabuf fd.
+//
+// Decoders and cameras recycle a fixed set of buffers, so the EGLImage of
+// each buffer only needs to be registered with CUDA once. The owner of the
+// buffer calls invalidate() before unmapping its EGLImage or destroying it.
+//
+// The cache does not call CUDA itself; the driver calls are passed in, so
+// that the bookkeeping can be tested with a mocked driver.
+
+// Driver calls used by the cache
+typedef struct
+{
+    // Registers the EGLImage, returns a handle or NULL on failure
+    void *(*registerImage)(void *image, void *arg);
+    // Unregisters a handle returned by registerImage
+    void (*unregisterImage)(void *handle, void *arg);
+    void *arg;
+} NvEglRegistrationOps;
+
+typedef struct
+{
+    uint64_t lookups;           // acquire() calls
+    uint64_t hits;              // acquire() served by an existing registration
+    uint64_t registrations;
+    uint64_t unregistrations;
+    uint64_t invalidations;     // invalidate() of a registered fd
+    uint64_t stale;             // fd acquired with a different EGLImage
+    uint64_t evictions;         // registrations dropped over max_entries
+    uint64_t register_usec;     // time spent in registerImage
+} NvEglRegistrationStats;
+
+class NvEglRegistrationCache
+{
+public:
+    // Keeps at most max_entries idle registrations
+    NvEglRegistrationCache(const NvEglRegistrationOps &ops, uint32_t max_entries);
+
+    // Unregisters everything
+    ~NvEglRegistrationCache();
+
+    // Returns the registration of image, the EGLImage of dmabuf fd,
+    // registering it on first use. Each successful acquire() is followed
+    // by a release(). Returns NULL if the registration fails.
+    void *acquire(int fd, void *image);
+
+    void release(int fd, void *handle);
+
+    // Drops the registration of fd. It is unregistered now, or by the
+    // last release() if it is in use.
+    void invalidate(int fd);
+
+    // Invalidates every registration
+    void clear();
+
+    uint32_t getNumEntries();
+
+    NvEglRegistrationStats getStats();
+
+private:
+    struct Entry
+    {
+        int fd;
+        void *image;
+        void *handle;
+        uint32_t users;
+        uint64_t last_use;
+        bool invalid;           // unregistered by the last release()
+    };
+
+    NvEglRegistrationOps ops;
+    uint32_t max_entries;
+    uint64_t use_count;
+    std::vector<Entry> entries;
+    NvEglRegistrationStats stats;
+    pthread_mutex_t lock;
+
+    void unregisterEntry(size_t i);
+    void evictIdle();
+};
+
+#endif
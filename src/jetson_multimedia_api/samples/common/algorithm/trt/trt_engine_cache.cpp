@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "trt_engine_cache.h"
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+#define CACHE_MAGIC "TRTENGC1"
+#define CACHE_FILE_SUFFIX ".engine"
+#define CACHE_LOCK_SUFFIX ".lock"
+// Temporary files of writers that died, and locks of removed engines that
+// nobody holds, are removed after this time
+#define STALE_TMP_SECONDS 600
+
+static const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+struct CacheFileHeader
+{
+    char magic[8];
+    uint32_t key_size;
+    uint32_t reserved;
+    uint64_t payload_size;
+    uint64_t payload_hash;
+};
+
+static uint64_t
+fnv1a(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *) data;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static string
+toHex(uint64_t value)
+{
+    char str[17];
+
+    snprintf(str, sizeof(str), "%016llx", (unsigned long long) value);
+    return str;
+}
+
+static bool
+endsWith(const string &str, const string &suffix)
+{
+    return str.size() >= suffix.size() &&
+        str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Removes a lock file if no builder holds it. The file is unlinked while
+// locked, getOrBuild() retries when its lock got unlinked under it.
+static void
+removeUnheldLock(const string &file)
+{
+    int fd = open(file.c_str(), O_RDWR | O_CLOEXEC);
+
+    if (fd < 0)
+        return;
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0)
+        unlink(file.c_str());
+    close(fd);
+}
+
+// Checks that fd is still the file at path
+static bool
+isSameFile(int fd, const string &file)
+{
+    struct stat fd_st, file_st;
+
+    return fstat(fd, &fd_st) == 0 && stat(file.c_str(), &file_st) == 0 &&
+        fd_st.st_dev == file_st.st_dev && fd_st.st_ino == file_st.st_ino;
+}
+
+static bool
+writeAll(int fd, const void *data, size_t size)
+{
+    const char *p = (const char *) data;
+
+    while (size)
+    {
+        ssize_t ret = write(fd, p, size);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+static bool
+readAll(int fd, void *data, size_t size)
+{
+    char *p = (char *) data;
+
+    while (size)
+    {
+        ssize_t ret = read(fd, p, size);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        p += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+TRT_EngineCacheKey::TRT_EngineCacheKey()
+    : batch_size(0)
+    , mode(0)
+{
+}
+
+string
+TRT_EngineCacheKey::toString() const
+{
+    ostringstream str;
+
+    str << "model=" << model_hash << ";batch=" << batch_size <<
+        ";mode=" << mode << ";target=" << target <<
+        ";trt=" << trt_version << ";options=" << options;
+    return str.str();
+}
+
+string
+TRT_EngineCacheKey::fileName() const
+{
+    string key = toString();
+
+    return toHex(fnv1a(FNV_OFFSET, key.data(), key.size())) + CACHE_FILE_SUFFIX;
+}
+
+TRT_EngineCache::TRT_EngineCache(const string &dir, uint64_t max_bytes)
+    : dir(dir)
+    , max_bytes(max_bytes)
+{
+    memset(&stats, 0, sizeof(stats));
+
+    // Create the directory and its parents
+    for (size_t pos = dir.find('/', 1); ; pos = dir.find('/', pos + 1))
+    {
+        string sub = dir.substr(0, pos);
+        if (mkdir(sub.c_str(), 0755) < 0 && errno != EEXIST)
+        {
+            cerr << "Could not create engine cache directory " << sub << ": " <<
+                strerror(errno) << endl;
+            break;
+        }
+        if (pos == string::npos)
+            break;
+    }
+}
+
+string
+TRT_EngineCache::hashFiles(const vector<string> &paths)
+{
+    uint64_t hash = FNV_OFFSET;
+    vector<char> buf(1 << 20);
+
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        uint64_t file_size = 0;
+        int fd = open(paths[i].c_str(), O_RDONLY);
+
+        if (fd < 0)
+            return "";
+        while (true)
+        {
+            ssize_t ret = read(fd, buf.data(), buf.size());
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret < 0)
+            {
+                close(fd);
+                return "";
+            }
+            if (ret == 0)
+                break;
+            hash = fnv1a(hash, buf.data(), ret);
+            file_size += ret;
+        }
+        close(fd);
+        // Separate the files, so that moving bytes between them changes the hash
+        hash = fnv1a(hash, &file_size, sizeof(file_size));
+    }
+    return toHex(hash);
+}
+
+string
+TRT_EngineCache::path(const string &name) const
+{
+    return dir + "/" + name;
+}
+
+bool
+TRT_EngineCache::readEngine(const string &file, const TRT_EngineCacheKey &key,
+                            vector<char> &blob) const
+{
+    CacheFileHeader header;
+    string expected_key = key.toString();
+    string stored_key;
+    struct stat st;
+    bool ok = false;
+    int fd;
+
+    fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &st) == 0 &&
+        readAll(fd, &header, sizeof(header)) &&
+        memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+        header.key_size == expected_key.size() &&
+        (uint64_t) st.st_size == sizeof(header) + header.key_size + header.payload_size)
+    {
+        stored_key.resize(header.key_size);
+        blob.resize(header.payload_size);
+        ok = readAll(fd, &stored_key[0], header.key_size) &&
+            stored_key == expected_key &&
+            readAll(fd, blob.data(), blob.size()) &&
+            fnv1a(FNV_OFFSET, blob.data(), blob.size()) == header.payload_hash;
+    }
+    close(fd);
+
+    if (!ok)
+        blob.clear();
+    return ok;
+}
+
+bool
+TRT_EngineCache::load(const TRT_EngineCacheKey &key, vector<char> &blob)
+{
+    string file = path(key.fileName());
+
+    if (access(file.c_str(), F_OK) < 0)
+    {
+        stats.misses++;
+        return false;
+    }
+
+    if (!readEngine(file, key, blob))
+    {
+        // Truncated, corrupted or a different key with the same file name
+        cout << "Engine cache file " << file << " does not match, rebuilding" << endl;
+        unlink(file.c_str());
+        stats.invalid++;
+        return false;
+    }
+
+    // Mark the engine as recently used for eviction
+    utimensat(AT_FDCWD, file.c_str(), NULL, 0);
+    stats.hits++;
+    return true;
+}
+
+bool
+TRT_EngineCache::store(const TRT_EngineCacheKey &key, const vector<char> &blob)
+{
+    string name = key.fileName();
+    string key_str = key.toString();
+    string tmp = path("." + name + ".XXXXXX");
+    CacheFileHeader header;
+    bool ok;
+    int fd;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.key_size = key_str.size();
+    header.payload_size = blob.size();
+    header.payload_hash = fnv1a(FNV_OFFSET, blob.data(), blob.size());
+
+    fd = mkstemp(&tmp[0]);
+    if (fd < 0)
+    {
+        cerr << "Could not create engine cache file in " << dir << ": " <<
+            strerror(errno) << endl;
+        return false;
+    }
+
+    fchmod(fd, 0644);
+    ok = writeAll(fd, &header, sizeof(header)) &&
+        writeAll(fd, key_str.data(), key_str.size()) &&
+        writeAll(fd, blob.data(), blob.size()) &&
+        fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+
+    // rename() replaces the file atomically, a concurrent reader sees
+    // either the old or the new engine
+    if (!ok || rename(tmp.c_str(), path(name).c_str()) < 0)
+    {
+        cerr << "Could not write engine cache file " << path(name) << endl;
+        unlink(tmp.c_str());
+        return false;
+    }
+    stats.stores++;
+
+    if (max_bytes)
+        evict(max_bytes, name);
+    return true;
+}
+
+bool
+TRT_EngineCache::getOrBuild(const TRT_EngineCacheKey &key, vector<char> &blob,
+                            BuildFunc build, void *arg, bool *from_cache)
+{
+    string lock_file = path(key.fileName() + CACHE_LOCK_SUFFIX);
+    bool loaded = false;
+    bool ok;
+    int lock_fd;
+
+    if (load(key, blob))
+    {
+        if (from_cache)
+            *from_cache = true;
+        return true;
+    }
+
+    // Serialize builders of the same key. The lock is released when the
+    // file is closed, including when the process dies.
+    lock_fd = open(lock_file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    while (lock_fd >= 0)
+    {
+        while (flock(lock_fd, LOCK_EX) < 0 && errno == EINTR)
+            ;
+        if (isSameFile(lock_fd, lock_file))
+            break;
+        // evict() removed the lock file while we waited, lock the new one
+        close(lock_fd);
+        lock_fd = open(lock_file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    }
+    if (lock_fd >= 0)
+    {
+        // Another builder may have stored the engine while we waited
+        loaded = readEngine(path(key.fileName()), key, blob);
+        if (loaded)
+            stats.hits++;
+    }
+
+    ok = loaded;
+    if (!loaded)
+    {
+        ok = build(blob, arg) && !blob.empty();
+        if (ok)
+        {
+            stats.builds++;
+            store(key, blob);
+        }
+    }
+
+    if (lock_fd >= 0)
+        close(lock_fd);
+
+    if (from_cache)
+        *from_cache = loaded;
+    return ok;
+}
+
+void
+TRT_EngineCache::evict(uint64_t max_bytes, const string &keep)
+{
+    struct Entry
+    {
+        string name;
+        uint64_t size;
+        struct timespec mtime;
+    };
+    vector<Entry> entries;
+    uint64_t total = 0;
+    time_t now = time(NULL);
+    struct dirent *ent;
+    DIR *d;
+
+    d = opendir(dir.c_str());
+    if (!d)
+        return;
+    while ((ent = readdir(d)) != NULL)
+    {
+        string name = ent->d_name;
+        struct stat st;
+
+        if (stat(path(name).c_str(), &st) < 0 || !S_ISREG(st.st_mode))
+            continue;
+
+        if (now - st.st_mtime > STALE_TMP_SECONDS && name[0] == '.')
+        {
+            // Temporary file of a writer that died
+            unlink(path(name).c_str());
+            continue;
+        }
+        if (now - st.st_mtime > STALE_TMP_SECONDS &&
+            endsWith(name, CACHE_LOCK_SUFFIX) &&
+            access(path(name.substr(0, name.size() - strlen(CACHE_LOCK_SUFFIX))).c_str(), F_OK) < 0)
+        {
+            // Lock of a removed engine, unless a builder is using it
+            removeUnheldLock(path(name));
+            continue;
+        }
+        if (!endsWith(name, CACHE_FILE_SUFFIX) || name[0] == '.')
+            continue;
+
+        Entry entry = { name, (uint64_t) st.st_size, st.st_mtim };
+        entries.push_back(entry);
+        total += st.st_size;
+    }
+    closedir(d);
+
+    // Least recently used first
+    sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.mtime.tv_sec != b.mtime.tv_sec ? a.mtime.tv_sec < b.mtime.tv_sec :
+            a.mtime.tv_nsec < b.mtime.tv_nsec;
+    });
+
+    for (size_t i = 0; i < entries.size() && total > max_bytes; i++)
+    {
+        if (entries[i].name == keep)
+            continue;
+        // The lock file stays, a builder of the engine may be holding it
+        if (unlink(path(entries[i].name).c_str()) == 0)
+        {
+            total -= entries[i].size;
+            stats.evictions++;
+            cout << "Evicted engine cache file " << path(entries[i].name) << endl;
+        }
+    }
+}
+
+uint64_t
+TRT_EngineCache::getSize() const
+{
+    uint64_t total = 0;
+    struct dirent *ent;
+    DIR *d;
+
+    d = opendir(dir.c_str());
+    if (!d)
+        return 0;
+    while ((ent = readdir(d)) != NULL)
+    {
+        string name = ent->d_name;
+        struct stat st;
+
+        if (name[0] != '.' && endsWith(name, CACHE_FILE_SUFFIX) &&
+            stat(path(name).c_str(), &st) == 0)
+            total += st.st_size;
+    }
+    closedir(d);
+    return total;
+}
+
+const string&
+TRT_EngineCache::getDir() const
+{
+    return dir;
+}
+
+TRT_EngineCacheStats
+TRT_EngineCache::getStats() const
+{
+    return stats;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TRT_ENGINE_CACHE_H_
+#define TRT_ENGINE_CACHE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Engine cache for serialized TensorRT engines. It does not depend on
+// TensorRT, the engine is an opaque blob produced by a build callback.
+
+// Everything an engine depends on. Engines built with a different key
+// are rebuilt.
+struct TRT_EngineCacheKey
+{
+    std::string model_hash;   // hash of the model file(s), see hashFiles()
+    uint32_t batch_size;
+    int mode;                 // 0 fp16, 1 fp32, 2 int8
+    std::string target;       // "GPU:<name>:sm_<major><minor>" or "DLA<core>"
+    std::string trt_version;  // TensorRT version the engine was built with
+    std::string options;      // other build options, e.g. outputs, workspace
+
+    TRT_EngineCacheKey();
+
+    // Canonical text form, stored in the cache file and compared on load
+    std::string toString() const;
+
+    // Cache file name, derived from the hash of toString()
+    std::string fileName() const;
+};
+
+struct TRT_EngineCacheStats
+{
+    uint64_t hits;            // engines loaded from the cache
+    uint64_t misses;          // no engine in the cache
+    uint64_t invalid;         // cache file rejected on load (key or payload mismatch)
+    uint64_t builds;          // engines built by this process
+    uint64_t stores;          // engines written to the cache
+    uint64_t evictions;       // cache files removed to stay under the size limit
+};
+
+// An instance is used by one thread at a time. Threads and processes that
+// share a cache directory each use their own instance.
+class TRT_EngineCache
+{
+public:
+    // Builds a serialized engine into blob, returns false on failure
+    typedef bool (*BuildFunc)(std::vector<char> &blob, void *arg);
+
+    // dir is created if needed, max_bytes bounds the total size of the
+    // cache files; 0 disables eviction
+    TRT_EngineCache(const std::string &dir, uint64_t max_bytes);
+
+    // 64-bit FNV-1a hash of the concatenated contents of the files, as
+    // hex. Returns an empty string if a file cannot be read.
+    static std::string hashFiles(const std::vector<std::string> &paths);
+
+    // Loads the engine of key. A file that does not match the key or
+    // whose payload is corrupted is removed and false is returned.
+    bool load(const TRT_EngineCacheKey &key, std::vector<char> &blob);
+
+    // Stores the engine of key. The file is written under a temporary name
+    // and renamed, so readers never see a partial engine. Evicts the least
+    // recently used engines if the cache grows over its size limit.
+    bool store(const TRT_EngineCacheKey &key, const std::vector<char> &blob);
+
+    // Loads the engine of key, or builds and stores it. Concurrent callers
+    // with the same key, in this or other processes, wait for the first
+    // build instead of building again. from_cache is set if the engine was
+    // loaded rather than built.
+    bool getOrBuild(const TRT_EngineCacheKey &key, std::vector<char> &blob,
+                    BuildFunc build, void *arg, bool *from_cache = NULL);
+
+    // Removes the least recently used engines until the cache holds at
+    // most max_bytes, keeping the file named keep
+    void evict(uint64_t max_bytes, const std::string &keep = "");
+
+    // Total size of the cache files
+    uint64_t getSize() const;
+
+    const std::string& getDir() const;
+
+    TRT_EngineCacheStats getStats() const;
+
+private:
+    std::string dir;
+    uint64_t max_bytes;
+    TRT_EngineCacheStats stats;
+
+    std::string path(const std::string &name) const;
+    bool readEngine(const std::string &file, const TRT_EngineCacheKey &key,
+                    std::vector<char> &blob) const;
+};
+
+#endif
@@ -41,6 +41,8 @@
 static const int TIMING_ITERATIONS = 1;
 static const int NUM_BINDINGS = 3;
 static const int FILTER_NUM = 6;
+static const char *ENGINE_CACHE_DIR = "trt_engine_cache";
+static const uint64_t ENGINE_CACHE_SIZE = 1024ULL * 1024 * 1024;
 
 #define CHECK(status)                                   \
 {                                                       \
@@ -242,6 +244,18 @@ TRT_Context::setBatchSize(const uint32_t& batchsize)
     this->batch_size = batchsize;
 }
 
+void
+TRT_Context::setEngineCacheDir(const string& dir)
+{
+    this->engine_cache_dir = dir;
+}
+
+void
+TRT_Context::setEngineCacheSize(const uint64_t& max_bytes)
+{
+    this->engine_cache_size = max_bytes;
+}
+
 void
 TRT_Context::setDumpResult(const bool& dump_result)
 {
@@ -294,6 +308,8 @@ TRT_Context::TRT_Context()
     dump_result = 0;
     frame_num = 0;
     result_file = "result.txt";
+    engine_cache_dir = ENGINE_CACHE_DIR;
+    engine_cache_size = ENGINE_CACHE_SIZE;
     pLogger = new Logger;
     pProfiler = new Profiler;
 }
@@ -621,6 +637,72 @@ TRT_Context::setModelIndex(int index)
     assert(g_pModelNetAttr->WORKSPACE_SIZE > 0);
 }
 
+struct BuildEngineArgs
+{
+    TRT_Context *ctx;
+    const string& deployfile;
+    const string& modelfile;
+};
+
+TRT_EngineCacheKey
+TRT_Context::getEngineCacheKey(const string& deployfile,
+        const string& modelfile, bool isOnnxModel)
+{
+    TRT_EngineCacheKey key;
+    vector<string> model_files;
+    cudaDeviceProp prop;
+    ostringstream target;
+    ostringstream version;
+    ostringstream options;
+    int device = 0;
+
+    if (!isOnnxModel)
+        model_files.push_back(deployfile);
+    model_files.push_back(modelfile);
+    key.model_hash = TRT_EngineCache::hashFiles(model_files);
+    key.batch_size = batch_size;
+    key.mode = mode;
+
+    // Engines are built for the GPU only, DLA is not used by TRT_Context
+    CHECK(cudaGetDevice(&device));
+    CHECK(cudaGetDeviceProperties(&prop, device));
+    target<<"GPU:"<<prop.name<<":sm_"<<prop.major<<prop.minor;
+    key.target = target.str();
+
+    version<<NV_TENSORRT_MAJOR<<"."<<NV_TENSORRT_MINOR<<"."<<NV_TENSORRT_PATCH;
+    key.trt_version = version.str();
+
+    options<<(isOnnxModel ? "onnx" : "caffe")<<
+        ",outputs="<<g_pModelNetAttr->OUTPUT_BLOB_NAME<<"+"<<g_pModelNetAttr->OUTPUT_BBOX_NAME<<
+        ",workspace="<<g_pModelNetAttr->WORKSPACE_SIZE;
+    key.options = options.str();
+    return key;
+}
+
+bool
+TRT_Context::buildEngine(vector<char>& blob, void *arg)
+{
+    BuildEngineArgs *args = (BuildEngineArgs *) arg;
+    TRT_Context *ctx = args->ctx;
+
+    ctx->trtModelStream = nullptr;
+    if (ctx->is_onnx_model)
+    {
+        ctx->onnxToTRTModel(args->modelfile);
+    } else
+    {
+        ctx->caffeToTRTModel(args->deployfile, args->modelfile);
+    }
+    if (!ctx->trtModelStream)
+        return false;
+
+    const char *data = (const char *) ctx->trtModelStream->data();
+    blob.assign(data, data + ctx->trtModelStream->size());
+    delete ctx->trtModelStream;
+    ctx->trtModelStream = nullptr;
+    return true;
+}
+
 void
 TRT_Context::buildTrtContext(const string& deployfile,
         const string& modelfile, bool bUseCPUBuf, bool isOnnxModel)
@@ -631,42 +713,44 @@ TRT_Context::buildTrtContext(const string& deployfile,
         cout<<"parse net failed, exit!"<<endl;
         exit(0);
     }
-    ifstream trtModelFile("trtModel.cache");
-    if (trtModelFile.good())
-    {
-        // get cache file length
-        size_t size = 0;
-        size_t i = 0;
-
-        cout<<"Using cached TRT model" <<endl;
+    TRT_EngineCacheKey key = getEngineCacheKey(deployfile, modelfile, isOnnxModel);
+    TRT_EngineCache *cache = NULL;
+    BuildEngineArgs args = { this, deployfile, modelfile };
+    vector<char> blob;
+    bool from_cache = false;
 
-        // Get the length
-        trtModelFile.seekg(0, ios::end);
-        size = trtModelFile.tellg();
-        trtModelFile.seekg(0, ios::beg);
+    runtime = createInferRuntime(*pLogger);
 
-        char * buff = new char [size];
-        while (trtModelFile.get(buff[i])) i++;
-        trtModelFile.close();
-        runtime = createInferRuntime(*pLogger);
-        engine = runtime->deserializeCudaEngine((void *)buff, size, nullptr);
-    }
-    else
+    if (!engine_cache_dir.empty() && !key.model_hash.empty())
     {
-        if (isOnnxModel)
+        cache = new TRT_EngineCache(engine_cache_dir, engine_cache_size);
+        if (cache->getOrBuild(key, blob, buildEngine, &args, &from_cache))
         {
-            onnxToTRTModel(modelfile);
-        } else
+            cout<<(from_cache ? "Using cached TRT engine " : "Created TRT engine cache ")<<
+                cache->getDir()<<"/"<<key.fileName()<<endl;
+            engine = runtime->deserializeCudaEngine(blob.data(), blob.size(), nullptr);
+        }
+    }
+
+    if (!engine && (!cache || from_cache))
+    {
+        // No cache, or the cached engine can not be used with this runtime
+        if (from_cache)
+            cout<<"Cached TRT engine could not be deserialized, rebuilding"<<endl;
+        blob.clear();
+        if (buildEngine(blob, &args))
         {
-            caffeToTRTModel(deployfile, modelfile);
+            engine = runtime->deserializeCudaEngine(blob.data(), blob.size(), nullptr);
+            if (engine && cache)
+                cache->store(key, blob);
         }
-        cout<<"Create TRT model cache"<<endl;
-        ofstream trtModelFile("trtModel.cache");
-        trtModelFile.write((char *)trtModelStream->data(), trtModelStream->size());
-        trtModelFile.close();
-        runtime = createInferRuntime(*pLogger);
-        engine = runtime->deserializeCudaEngine(trtModelStream->data(), trtModelStream->size(), nullptr);
-        trtModelStream->destroy();
+    }
+    delete cache;
+
+    if (!engine)
+    {
+        cout<<"build TRT engine failed, exit!"<<endl;
+        exit(0);
     }
     context = engine->createExecutionContext();
     allocateMemory(bUseCPUBuf);
@@ -34,6 +34,7 @@
 #include "NvCaffeParser.h"
 #include "NvOnnxParser.h"
 #include <opencv2/objdetect/objdetect.hpp>
+#include "trt_engine_cache.h"
 using namespace nvinfer1;
 using namespace nvcaffeparser1;
 using namespace nvonnxparser;
@@ -86,6 +87,12 @@ public:
     int getFilterNum() const;
     void setFilterNum(const unsigned int& filter_num);
 
+    // Serialized engines are cached in dir, an empty dir disables the cache
+    void setEngineCacheDir(const string& dir);
+
+    // Total size of the engine cache in bytes, 0 for no limit
+    void setEngineCacheSize(const uint64_t& max_bytes);
+
     TRT_Context();
 
     void setModelIndex(int modelIndex);
@@ -126,6 +133,8 @@ private:
     bool enable_trt_profiler;
     bool is_onnx_model;
     IHostMemory *trtModelStream{nullptr};
+    string engine_cache_dir;
+    uint64_t engine_cache_size;
     vector<string> outputs;
     string result_file;
     Logger *pLogger;
@@ -213,6 +222,9 @@ private:
     void releaseMemory(bool bUseCPUBuf);
     void caffeToTRTModel(const string& deployfile, const string& modelfile);
     void onnxToTRTModel(const string& modelfile);
+    TRT_EngineCacheKey getEngineCacheKey(const string& deployfile,
+            const string& modelfile, bool isOnnxModel);
+    static bool buildEngine(vector<char>& blob, void *arg);
 };
 
 #endif
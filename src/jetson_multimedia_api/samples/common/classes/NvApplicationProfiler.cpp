@@ -27,27 +27,156 @@
  */
 
 #include "NvApplicationProfiler.h"
+#include "NvElement.h"
+#include <ctype.h>
+#include <dirent.h>
 #include <fstream>
 #include <sstream>
 #include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
-#define GOVERNOR_SYS_FILE "/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor"
-#define CPU_FREQ_FILE "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq"
+#define GOVERNOR_SYS_FILE "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_governor"
+#define CPU_FREQ_FILE "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq"
 #define REQUIRED_GOVERNOR "performance"
 
+/* A core busier than this over a sampling period is considered saturated. */
+#define CPU_SATURATION_PERCENT 95.0f
+
 #define TIMESPEC_DIFF_USEC(timespec1, timespec2) \
     (timespec1.tv_sec - timespec2.tv_sec) * 1000000.0 + \
     (timespec1.tv_nsec - timespec2.tv_nsec) / 1000.0
 
+#define COUNTER_DIFF(cur, prev) ((cur) > (prev) ? (cur) - (prev) : 0)
+
 using namespace std;
 
+static uint32_t
+read_cpu_freq_mhz(uint32_t cpu)
+{
+    char path[128];
+    uint64_t cpu_freq_khz = 0;
+
+    snprintf(path, sizeof(path), CPU_FREQ_FILE, cpu);
+    ifstream cpu_freq_file(path, std::ifstream::in);
+    cpu_freq_file >> cpu_freq_khz;
+    return cpu_freq_khz / 1000;
+}
+
+static bool
+read_proc_value(const char *path, const char *key, uint64_t &value)
+{
+    ifstream file(path, std::ifstream::in);
+    string line;
+    size_t key_len = strlen(key);
+
+    while (getline(file, line))
+    {
+        if (!line.compare(0, key_len, key))
+        {
+            value = strtoull(line.c_str() + key_len, NULL, 10);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Parses a /proc/<pid>/stat style file. The thread name is enclosed in
+ * parentheses and may contain spaces, so the fields are read from the
+ * last closing parenthesis onwards.
+ */
+static bool
+read_proc_stat(const char *path, char *name, size_t name_len,
+        uint64_t &minflt, uint64_t &majflt, uint64_t &ticks, int32_t &last_cpu)
+{
+    char buf[1024];
+    FILE *fp = fopen(path, "r");
+    size_t len;
+    char *open_paren, *close_paren;
+    unsigned long long fields[37];
+    char *pos;
+    int i;
+
+    if (!fp)
+        return false;
+    len = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    buf[len] = '\0';
+
+    open_paren = strchr(buf, '(');
+    close_paren = strrchr(buf, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren)
+        return false;
+
+    if (name)
+    {
+        len = close_paren - open_paren - 1;
+        if (len >= name_len)
+            len = name_len - 1;
+        memcpy(name, open_paren + 1, len);
+        name[len] = '\0';
+    }
+
+    /* fields[0] is the state (field 3 of proc(5)), skipped as a string. */
+    pos = close_paren + 2;
+    pos = strchr(pos, ' ');
+    for (i = 1; pos && i < 37; i++)
+    {
+        fields[i] = strtoull(pos, &pos, 10);
+    }
+    if (i < 37)
+        return false;
+
+    minflt = fields[7];
+    majflt = fields[9];
+    ticks = fields[11] + fields[12];
+    last_cpu = fields[36];
+    return true;
+}
+
+static NvApplicationProfiler::ThreadRole
+get_thread_role(const char *name)
+{
+    if (strstr(name, "Plane") || strstr(name, "DQ"))
+        return NvApplicationProfiler::THREAD_ROLE_DQ;
+    if (strstr(name, "Render"))
+        return NvApplicationProfiler::THREAD_ROLE_RENDER;
+    if (strstr(name, "TRT"))
+        return NvApplicationProfiler::THREAD_ROLE_TRT;
+    if (strstr(name, "Poll") || strstr(name, "poll"))
+        return NvApplicationProfiler::THREAD_ROLE_POLL;
+    if (!strcmp(name, "ProfilingThread"))
+        return NvApplicationProfiler::THREAD_ROLE_PROFILER;
+    return NvApplicationProfiler::THREAD_ROLE_OTHER;
+}
+
+const char *
+NvApplicationProfiler::getThreadRoleName(ThreadRole role)
+{
+    switch (role)
+    {
+        case THREAD_ROLE_DQ:
+            return "dq";
+        case THREAD_ROLE_RENDER:
+            return "render";
+        case THREAD_ROLE_TRT:
+            return "trt";
+        case THREAD_ROLE_POLL:
+            return "poll";
+        case THREAD_ROLE_PROFILER:
+            return "profiler";
+        default:
+            return "other";
+    }
+}
+
 NvApplicationProfiler::NvApplicationProfiler()
 {
-    char governor[64];
-    uint64_t cpu_freq_khz;
+    char path[128];
 
     memset(&data, 0, sizeof(data));
 
@@ -56,24 +185,34 @@ NvApplicationProfiler::NvApplicationProfiler()
     data.max_cpu_usage = 0;
     data.min_cpu_usage = 100;
     sampling_interval = DefaultSamplingInterval;
+    max_samples = DefaultMaxSamples;
+    proc_minor_faults = 0;
+    proc_major_faults = 0;
 
     profiling_thread = 0;
     pthread_mutex_init(&thread_lock, NULL);
-    check_cpu_usage = true;
 
-    ifstream cpu_governor_file(GOVERNOR_SYS_FILE, std::ifstream::in);
-    cpu_governor_file >> governor;
-    if (strcmp(governor, REQUIRED_GOVERNOR))
+    num_cpu_cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    governor_noise = NOISE_NONE;
+    for (uint32_t cpu = 0; cpu < num_cpu_cores; cpu++)
+    {
+        string governor;
+
+        snprintf(path, sizeof(path), GOVERNOR_SYS_FILE, cpu);
+        ifstream cpu_governor_file(path, std::ifstream::in);
+        if (!(cpu_governor_file >> governor))
+            continue;
+        if (governor != REQUIRED_GOVERNOR)
+            governor_noise = NOISE_GOVERNOR;
+    }
+    if (governor_noise)
     {
-        cerr << "Set governor to " REQUIRED_GOVERNOR " before enabling profiler"
+        cerr << "CPU governor is not " REQUIRED_GOVERNOR ", profiler results may be noisy"
             << endl;
-        check_cpu_usage = false;
     }
-    num_cpu_cores = sysconf(_SC_NPROCESSORS_ONLN);
 
-    ifstream cpu_freq_file(CPU_FREQ_FILE, std::ifstream::in);
-    cpu_freq_file >> cpu_freq_khz;
-    cpu_freq = cpu_freq_khz / 1000;
+    cpu_freq = read_cpu_freq_mhz(0);
 }
 
 NvApplicationProfiler&
@@ -84,7 +223,7 @@ NvApplicationProfiler::getProfilerInstance()
 }
 
 void
-NvApplicationProfiler::start(uint32_t sampling_interval_ms)
+NvApplicationProfiler::start(uint32_t sampling_interval_ms, uint32_t max_num_samples)
 {
 
     pthread_mutex_lock(&thread_lock);
@@ -95,26 +234,21 @@ NvApplicationProfiler::start(uint32_t sampling_interval_ms)
         return;
     }
 
-    if (!check_cpu_usage)
-    {
-        cerr << "Set governor to " REQUIRED_GOVERNOR " before enabling profiler"
-            << endl;
-        pthread_mutex_unlock(&thread_lock);
-        return;
-    }
-
     running = true;
     sampling_interval = sampling_interval_ms;
+    max_samples = max_num_samples;
 
     memset(&data, 0, sizeof(data));
+    data.min_cpu_usage = 100;
+    data.noise_flags = governor_noise;
+    samples.clear();
 
     gettimeofday(&data.start_time, NULL);
 
-    if (check_cpu_usage)
-    {
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &data.start_proc_cpu_clock_time);
-        clock_gettime(CLOCK_MONOTONIC, &data.start_cpu_clock_time);
-    }
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &data.start_proc_cpu_clock_time);
+    clock_gettime(CLOCK_MONOTONIC, &data.start_cpu_clock_time);
+
+    resetCounters();
 
     pthread_create(&profiling_thread, NULL, ProfilerThread, this);
     pthread_setname_np(profiling_thread, "ProfilingThread");
@@ -125,7 +259,15 @@ NvApplicationProfiler::start(uint32_t sampling_interval_ms)
 void
 NvApplicationProfiler::stop()
 {
+    pthread_mutex_lock(&thread_lock);
+    if (!running)
+    {
+        pthread_mutex_unlock(&thread_lock);
+        return;
+    }
     running = false;
+    pthread_mutex_unlock(&thread_lock);
+
     pthread_join(profiling_thread, NULL);
 
     pthread_mutex_lock(&thread_lock);
@@ -134,38 +276,297 @@ NvApplicationProfiler::stop()
 }
 
 void
-NvApplicationProfiler::profile()
+NvApplicationProfiler::addElement(const char *name, NvElement *element)
 {
-    if (check_cpu_usage)
-    {
-        struct timespec cur_proc_cpu_clock_time;
-        struct timespec cur_cpu_clock_time;
+    ElementEntry entry;
+    NvElementProfiler::NvElementProfilerData element_data;
 
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cur_proc_cpu_clock_time);
-        clock_gettime(CLOCK_MONOTONIC, &cur_cpu_clock_time);
+    element->getProfilingData(element_data);
+    entry.name = name;
+    entry.element = element;
+    entry.last_units = element_data.total_processed_units;
 
-        if (data.num_readings)
-        {
-            float proc_cpu_time = TIMESPEC_DIFF_USEC(cur_proc_cpu_clock_time,
-                    data.stop_proc_cpu_clock_time);
+    pthread_mutex_lock(&thread_lock);
+    elements.push_back(entry);
+    pthread_mutex_unlock(&thread_lock);
+}
 
-            float total_cpu_time = TIMESPEC_DIFF_USEC(cur_cpu_clock_time,
-                    data.stop_cpu_clock_time);
+void
+NvApplicationProfiler::resetCounters()
+{
+    NvAppProfilerSample sample;
+
+    thread_counters.clear();
+    core_counters.clear();
+    proc_minor_faults = 0;
+    proc_major_faults = 0;
+
+    /* Take baseline readings; the resulting deltas are discarded. */
+    sampleThreads(sample, 0);
+    sampleCores(sample);
+    sampleMemory(sample);
+    sampleElements(sample, 0);
+}
 
-            float cpu_usage = proc_cpu_time * 100 / total_cpu_time;
-            if (cpu_usage < data.min_cpu_usage && cpu_usage > 0)
-            {
-                data.min_cpu_usage = cpu_usage;
-            }
-            if (cpu_usage > data.max_cpu_usage)
+void
+NvApplicationProfiler::sampleThreads(NvAppProfilerSample &sample, float interval_usec)
+{
+    static const uint64_t nsec_per_tick = 1000000000ULL / sysconf(_SC_CLK_TCK);
+    map<pid_t, ThreadCounters> cur_counters;
+    DIR *task_dir;
+    struct dirent *entry;
+    char path[128];
+
+    task_dir = opendir("/proc/self/task");
+    if (!task_dir)
+        return;
+
+    while ((entry = readdir(task_dir)) != NULL)
+    {
+        NvAppProfilerThreadSample thread;
+        ThreadCounters counters;
+        uint64_t ticks;
+        pid_t tid = atoi(entry->d_name);
+
+        if (tid <= 0)
+            continue;
+
+        memset(&thread, 0, sizeof(thread));
+        memset(&counters, 0, sizeof(counters));
+        thread.tid = tid;
+
+        snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+        if (!read_proc_stat(path, thread.name, sizeof(thread.name),
+                    counters.minor_faults, counters.major_faults, ticks,
+                    thread.last_cpu))
+            continue;
+        counters.cpu_time_nsec = ticks * nsec_per_tick;
+
+        /* schedstat gives nanosecond run time and run-queue wait time,
+         * prefer it over the tick based stat values when available. */
+        snprintf(path, sizeof(path), "/proc/self/task/%d/schedstat", tid);
+        FILE *fp = fopen(path, "r");
+        if (fp)
+        {
+            unsigned long long run_nsec, wait_nsec;
+            if (fscanf(fp, "%llu %llu", &run_nsec, &wait_nsec) == 2)
             {
-                data.max_cpu_usage = cpu_usage;
+                counters.cpu_time_nsec = run_nsec;
+                counters.runqueue_wait_nsec = wait_nsec;
             }
+            fclose(fp);
+        }
+
+        snprintf(path, sizeof(path), "/proc/self/task/%d/status", tid);
+        read_proc_value(path, "voluntary_ctxt_switches:",
+                counters.voluntary_ctxt_switches);
+        read_proc_value(path, "nonvoluntary_ctxt_switches:",
+                counters.involuntary_ctxt_switches);
+
+        cur_counters[tid] = counters;
+
+        /* Threads created within this period are measured from their start. */
+        ThreadCounters prev;
+        memset(&prev, 0, sizeof(prev));
+        map<pid_t, ThreadCounters>::iterator it = thread_counters.find(tid);
+        if (it != thread_counters.end())
+            prev = it->second;
+
+        thread.role = get_thread_role(thread.name);
+        if (interval_usec > 0)
+        {
+            thread.cpu_usage = COUNTER_DIFF(counters.cpu_time_nsec,
+                    prev.cpu_time_nsec) / 10.0f / interval_usec;
+        }
+        thread.runqueue_wait_usec = COUNTER_DIFF(counters.runqueue_wait_nsec,
+                prev.runqueue_wait_nsec) / 1000;
+        thread.voluntary_ctxt_switches = COUNTER_DIFF(
+                counters.voluntary_ctxt_switches, prev.voluntary_ctxt_switches);
+        thread.involuntary_ctxt_switches = COUNTER_DIFF(
+                counters.involuntary_ctxt_switches, prev.involuntary_ctxt_switches);
+        thread.minor_faults = COUNTER_DIFF(counters.minor_faults,
+                prev.minor_faults);
+        thread.major_faults = COUNTER_DIFF(counters.major_faults,
+                prev.major_faults);
+
+        sample.threads.push_back(thread);
+    }
+    closedir(task_dir);
+
+    thread_counters.swap(cur_counters);
+}
+
+void
+NvApplicationProfiler::sampleCores(NvAppProfilerSample &sample)
+{
+    ifstream stat_file("/proc/stat", std::ifstream::in);
+    string line;
+
+    if (core_counters.size() != num_cpu_cores)
+    {
+        CoreCounters zero;
+        memset(&zero, 0, sizeof(zero));
+        core_counters.assign(num_cpu_cores, zero);
+    }
+    sample.cores.resize(num_cpu_cores);
+    for (uint32_t cpu = 0; cpu < num_cpu_cores; cpu++)
+    {
+        sample.cores[cpu].freq_mhz = read_cpu_freq_mhz(cpu);
+        sample.cores[cpu].utilization = 0;
+    }
+
+    while (getline(stat_file, line))
+    {
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0;
+        unsigned long long iowait = 0, irq = 0, softirq = 0, steal = 0;
+        uint32_t cpu;
+
+        if (line.compare(0, 3, "cpu") || line.size() < 4 || !isdigit(line[3]))
+            continue;
+        if (sscanf(line.c_str(), "cpu%u %llu %llu %llu %llu %llu %llu %llu %llu",
+                    &cpu, &user, &nice, &system, &idle, &iowait, &irq,
+                    &softirq, &steal) < 5 || cpu >= num_cpu_cores)
+            continue;
+
+        CoreCounters &prev = core_counters[cpu];
+        uint64_t total = user + nice + system + idle + iowait + irq + softirq + steal;
+        uint64_t busy = total - idle - iowait;
+        uint64_t total_diff = COUNTER_DIFF(total, prev.total);
+
+        if (total_diff)
+        {
+            sample.cores[cpu].utilization =
+                COUNTER_DIFF(busy, prev.busy) * 100.0f / total_diff;
+        }
+        if (prev.total && sample.cores[cpu].utilization >= CPU_SATURATION_PERCENT)
+            sample.noise_flags |= NOISE_CPU_SATURATED;
+        if (prev.freq_mhz && prev.freq_mhz != sample.cores[cpu].freq_mhz)
+            sample.noise_flags |= NOISE_FREQ_CHANGED;
+
+        prev.total = total;
+        prev.busy = busy;
+        prev.freq_mhz = sample.cores[cpu].freq_mhz;
+    }
+}
+
+void
+NvApplicationProfiler::sampleMemory(NvAppProfilerSample &sample)
+{
+    uint64_t minflt = 0, majflt = 0, ticks;
+    int32_t last_cpu;
+
+    read_proc_value("/proc/self/status", "VmRSS:", sample.rss_kb);
+    /* smaps_rollup is only available on kernels 4.14 and later. */
+    read_proc_value("/proc/self/smaps_rollup", "Pss:", sample.pss_kb);
+
+    if (read_proc_stat("/proc/self/stat", NULL, 0, minflt, majflt, ticks,
+                last_cpu))
+    {
+        sample.minor_faults = COUNTER_DIFF(minflt, proc_minor_faults);
+        sample.major_faults = COUNTER_DIFF(majflt, proc_major_faults);
+        proc_minor_faults = minflt;
+        proc_major_faults = majflt;
+    }
+}
+
+void
+NvApplicationProfiler::sampleElements(NvAppProfilerSample &sample, float interval_usec)
+{
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        NvElementProfiler::NvElementProfilerData element_data;
+        NvAppProfilerElementSample element;
+
+        elements[i].element->getProfilingData(element_data);
+        element.processed_units = COUNTER_DIFF(element_data.total_processed_units,
+                elements[i].last_units);
+        element.fps = interval_usec > 0 ?
+            element.processed_units * 1000000.0f / interval_usec : 0;
+        elements[i].last_units = element_data.total_processed_units;
+
+        sample.elements.push_back(element);
+    }
+}
+
+void
+NvApplicationProfiler::profile(uint64_t lateness_usec)
+{
+    struct timespec cur_proc_cpu_clock_time;
+    struct timespec cur_cpu_clock_time;
+    NvAppProfilerSample sample;
+    float total_cpu_time;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cur_proc_cpu_clock_time);
+    clock_gettime(CLOCK_MONOTONIC, &cur_cpu_clock_time);
+
+    sample.timestamp_usec = TIMESPEC_DIFF_USEC(cur_cpu_clock_time,
+            data.start_cpu_clock_time);
+    sample.cpu_usage = 0;
+    sample.rss_kb = 0;
+    sample.pss_kb = 0;
+    sample.minor_faults = 0;
+    sample.major_faults = 0;
+    sample.noise_flags = governor_noise;
+
+    if (data.num_readings)
+    {
+        total_cpu_time = TIMESPEC_DIFF_USEC(cur_cpu_clock_time,
+                data.stop_cpu_clock_time);
+    }
+    else
+    {
+        total_cpu_time = TIMESPEC_DIFF_USEC(cur_cpu_clock_time,
+                data.start_cpu_clock_time);
+    }
+
+    if (data.num_readings)
+    {
+        float proc_cpu_time = TIMESPEC_DIFF_USEC(cur_proc_cpu_clock_time,
+                data.stop_proc_cpu_clock_time);
+
+        float cpu_usage = proc_cpu_time * 100 / total_cpu_time;
+        if (cpu_usage < data.min_cpu_usage && cpu_usage > 0)
+        {
+            data.min_cpu_usage = cpu_usage;
+        }
+        if (cpu_usage > data.max_cpu_usage)
+        {
+            data.max_cpu_usage = cpu_usage;
         }
+        sample.cpu_usage = cpu_usage / num_cpu_cores;
+    }
+
+    data.stop_proc_cpu_clock_time = cur_proc_cpu_clock_time;
+    data.stop_cpu_clock_time = cur_cpu_clock_time;
+
+    if (lateness_usec > sampling_interval * 500ULL)
+        sample.noise_flags |= NOISE_LATE_SAMPLE;
 
-        data.stop_proc_cpu_clock_time = cur_proc_cpu_clock_time;
-        data.stop_cpu_clock_time = cur_cpu_clock_time;
+    sampleThreads(sample, total_cpu_time);
+    sampleCores(sample);
+    sampleMemory(sample);
+    sampleElements(sample, total_cpu_time);
+
+    if (sample.rss_kb > data.peak_rss_kb)
+        data.peak_rss_kb = sample.rss_kb;
+    if (sample.pss_kb > data.peak_pss_kb)
+        data.peak_pss_kb = sample.pss_kb;
+    data.minor_faults += sample.minor_faults;
+    data.major_faults += sample.major_faults;
+    for (size_t i = 0; i < sample.threads.size(); i++)
+    {
+        data.voluntary_ctxt_switches += sample.threads[i].voluntary_ctxt_switches;
+        data.involuntary_ctxt_switches += sample.threads[i].involuntary_ctxt_switches;
     }
+    data.noise_flags |= sample.noise_flags;
+
+    if (max_samples)
+    {
+        if (samples.size() >= max_samples)
+            samples.pop_front();
+        samples.push_back(sample);
+    }
+
     data.num_readings++;
 }
 
@@ -174,21 +575,29 @@ NvApplicationProfiler::ProfilerThread(void * data)
 {
     NvApplicationProfiler *profiler = (NvApplicationProfiler *) data;
     struct timespec next_profile_time;
-    struct timeval now;
+    struct timespec now;
+    pthread_condattr_t sleep_cond_attr;
     pthread_cond_t sleep_cond;
+    int64_t lateness_usec;
 
-    pthread_cond_init(&sleep_cond, NULL);
+    /* Pace on the monotonic clock so that wall-clock adjustments do not
+     * skew the sampling periods. */
+    pthread_condattr_init(&sleep_cond_attr);
+    pthread_condattr_setclock(&sleep_cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sleep_cond, &sleep_cond_attr);
+    pthread_condattr_destroy(&sleep_cond_attr);
 
-    gettimeofday(&now, NULL);
-    next_profile_time.tv_sec = now.tv_sec;
-    next_profile_time.tv_nsec = now.tv_usec * 1000L;
+    clock_gettime(CLOCK_MONOTONIC, &next_profile_time);
 
     pthread_mutex_lock(&profiler->thread_lock);
     while (profiler->running)
     {
         pthread_cond_timedwait(&sleep_cond, &profiler->thread_lock,
                 &next_profile_time);
-        profiler->profile();
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        lateness_usec = TIMESPEC_DIFF_USEC(now, next_profile_time);
+        profiler->profile(lateness_usec > 0 ? lateness_usec : 0);
 
         next_profile_time.tv_sec += profiler->sampling_interval / 1000;
         next_profile_time.tv_nsec += (profiler->sampling_interval % 1000) * 1000000L;
@@ -198,6 +607,8 @@ NvApplicationProfiler::ProfilerThread(void * data)
     }
     pthread_mutex_unlock(&profiler->thread_lock);
 
+    pthread_cond_destroy(&sleep_cond);
+
     return NULL;
 }
 
@@ -208,47 +619,281 @@ NvApplicationProfiler::getProfilerData(NvAppProfilerData &pdata)
 
     memset (&pdata, 0, sizeof(pdata));
 
-    if (check_cpu_usage)
-    {
-        float proc_cpu_time = TIMESPEC_DIFF_USEC(data.stop_proc_cpu_clock_time,
-                data.start_proc_cpu_clock_time);
+    float proc_cpu_time = TIMESPEC_DIFF_USEC(data.stop_proc_cpu_clock_time,
+            data.start_proc_cpu_clock_time);
 
-        float total_cpu_time = TIMESPEC_DIFF_USEC(data.stop_cpu_clock_time,
-                data.start_cpu_clock_time);
+    float total_cpu_time = TIMESPEC_DIFF_USEC(data.stop_cpu_clock_time,
+            data.start_cpu_clock_time);
 
-        pdata.peak_cpu_usage = data.max_cpu_usage / num_cpu_cores;
+    pdata.peak_cpu_usage = data.max_cpu_usage / num_cpu_cores;
+    if (total_cpu_time > 0)
         pdata.avg_cpu_usage = proc_cpu_time * 100 / total_cpu_time / num_cpu_cores;
 
-        pdata.total_time.tv_sec = data.stop_time.tv_sec - data.start_time.tv_sec;
-        pdata.total_time.tv_usec = data.stop_time.tv_usec - data.start_time.tv_usec;
-        if (pdata.total_time.tv_usec < 0)
-        {
-            pdata.total_time.tv_sec--;
-            pdata.total_time.tv_usec += 1000000;
-        }
-
-        pdata.num_cpu_cores = num_cpu_cores;
-        pdata.cpu_freq_mhz = cpu_freq;
+    pdata.total_time.tv_sec = data.stop_time.tv_sec - data.start_time.tv_sec;
+    pdata.total_time.tv_usec = data.stop_time.tv_usec - data.start_time.tv_usec;
+    if (pdata.total_time.tv_usec < 0)
+    {
+        pdata.total_time.tv_sec--;
+        pdata.total_time.tv_usec += 1000000;
     }
 
+    pdata.num_cpu_cores = num_cpu_cores;
+    pdata.cpu_freq_mhz = cpu_freq;
+    pdata.peak_rss_kb = data.peak_rss_kb;
+    pdata.peak_pss_kb = data.peak_pss_kb;
+    pdata.minor_faults = data.minor_faults;
+    pdata.major_faults = data.major_faults;
+    pdata.voluntary_ctxt_switches = data.voluntary_ctxt_switches;
+    pdata.involuntary_ctxt_switches = data.involuntary_ctxt_switches;
+    pdata.num_samples = samples.size();
+    pdata.noise_flags = data.noise_flags;
+
+    pthread_mutex_unlock(&thread_lock);
+}
+
+void
+NvApplicationProfiler::getSamples(std::vector<NvAppProfilerSample> &out_samples)
+{
+    pthread_mutex_lock(&thread_lock);
+    out_samples.assign(samples.begin(), samples.end());
     pthread_mutex_unlock(&thread_lock);
 }
+
 void
 NvApplicationProfiler::printProfilerData(std::ostream &outstream)
 {
     NvAppProfilerData data;
+    vector<NvAppProfilerSample> series;
+    map<string, float> thread_cpu;
+    map<string, uint64_t> thread_invol;
+
     getProfilerData(data);
+    getSamples(series);
+
+    /* Average the CPU usage of each thread over the whole time series. */
+    for (size_t i = 0; i < series.size(); i++)
+    {
+        for (size_t j = 0; j < series[i].threads.size(); j++)
+        {
+            const NvAppProfilerThreadSample &thread = series[i].threads[j];
+            thread_cpu[thread.name] += thread.cpu_usage / series.size();
+            thread_invol[thread.name] += thread.involuntary_ctxt_switches;
+        }
+    }
+
     outstream << "************************************" << endl;
     outstream << "Total Profiling Time = " <<
         (data.total_time.tv_sec + 0.000001 * data.total_time.tv_usec) <<
         " sec" << endl;
-    if (check_cpu_usage)
+    outstream << "Peak CPU Usage = " << data.peak_cpu_usage << "%" << endl;
+    outstream << "Avg CPU Usage = " << data.avg_cpu_usage << "%" << endl;
+    outstream << "Num. of Cores = " << data.num_cpu_cores << endl;
+    outstream << "CPU frequency = " << data.cpu_freq_mhz << "MHz" << endl;
+    outstream << "Peak RSS = " << data.peak_rss_kb << " KB" << endl;
+    if (data.peak_pss_kb)
+        outstream << "Peak PSS = " << data.peak_pss_kb << " KB" << endl;
+    outstream << "Page faults (minor/major) = " << data.minor_faults << "/" <<
+        data.major_faults << endl;
+    outstream << "Context switches (voluntary/involuntary) = " <<
+        data.voluntary_ctxt_switches << "/" << data.involuntary_ctxt_switches << endl;
+    for (map<string, float>::iterator it = thread_cpu.begin();
+            it != thread_cpu.end(); ++it)
     {
-        outstream << "Peak CPU Usage = " << data.peak_cpu_usage << "%" << endl;
-        outstream << "Avg CPU Usage = " << data.avg_cpu_usage << "%" << endl;
-        outstream << "Num. of Cores = " << data.num_cpu_cores << endl;
-        outstream << "CPU frequency = " << data.cpu_freq_mhz << "MHz" << endl;
+        outstream << "Thread " << it->first << " [" <<
+            getThreadRoleName(get_thread_role(it->first.c_str())) <<
+            "] Avg CPU = " << it->second << "%, involuntary switches = " <<
+            thread_invol[it->first] << endl;
+    }
+    if (data.noise_flags)
+    {
+        outstream << "WARNING: results may be noisy:";
+        if (data.noise_flags & NOISE_GOVERNOR)
+            outstream << " governor not " REQUIRED_GOVERNOR ";";
+        if (data.noise_flags & NOISE_FREQ_CHANGED)
+            outstream << " CPU frequency changed;";
+        if (data.noise_flags & NOISE_CPU_SATURATED)
+            outstream << " CPU core saturated;";
+        if (data.noise_flags & NOISE_LATE_SAMPLE)
+            outstream << " late samples;";
+        outstream << endl;
     }
     outstream << "************************************" << endl;
 }
 
+void
+NvApplicationProfiler::exportCSV(std::ostream &outstream)
+{
+    vector<NvAppProfilerSample> series;
+    vector<string> element_names;
+
+    getSamples(series);
+    pthread_mutex_lock(&thread_lock);
+    for (size_t i = 0; i < elements.size(); i++)
+        element_names.push_back(elements[i].name);
+    pthread_mutex_unlock(&thread_lock);
+
+    outstream << "timestamp_usec,scope,name,metric,value" << endl;
+    for (size_t i = 0; i < series.size(); i++)
+    {
+        const NvAppProfilerSample &s = series[i];
+        uint64_t ts = s.timestamp_usec;
+
+        outstream << ts << ",process,," << "cpu_usage," << s.cpu_usage << endl;
+        outstream << ts << ",process,," << "rss_kb," << s.rss_kb << endl;
+        outstream << ts << ",process,," << "pss_kb," << s.pss_kb << endl;
+        outstream << ts << ",process,," << "minor_faults," << s.minor_faults << endl;
+        outstream << ts << ",process,," << "major_faults," << s.major_faults << endl;
+        outstream << ts << ",process,," << "noise_flags," << s.noise_flags << endl;
+
+        for (size_t j = 0; j < s.threads.size(); j++)
+        {
+            const NvAppProfilerThreadSample &t = s.threads[j];
+            ostringstream name;
+            name << t.name << "/" << t.tid << "/" << getThreadRoleName(t.role);
+
+            outstream << ts << ",thread," << name.str() << ",cpu_usage," <<
+                t.cpu_usage << endl;
+            outstream << ts << ",thread," << name.str() << ",runqueue_wait_usec," <<
+                t.runqueue_wait_usec << endl;
+            outstream << ts << ",thread," << name.str() << ",voluntary_ctxt_switches," <<
+                t.voluntary_ctxt_switches << endl;
+            outstream << ts << ",thread," << name.str() << ",involuntary_ctxt_switches," <<
+                t.involuntary_ctxt_switches << endl;
+            outstream << ts << ",thread," << name.str() << ",minor_faults," <<
+                t.minor_faults << endl;
+            outstream << ts << ",thread," << name.str() << ",major_faults," <<
+                t.major_faults << endl;
+            outstream << ts << ",thread," << name.str() << ",last_cpu," <<
+                t.last_cpu << endl;
+        }
+
+        for (size_t j = 0; j < s.cores.size(); j++)
+        {
+            outstream << ts << ",core,cpu" << j << ",freq_mhz," <<
+                s.cores[j].freq_mhz << endl;
+            outstream << ts << ",core,cpu" << j << ",utilization," <<
+                s.cores[j].utilization << endl;
+        }
+
+        for (size_t j = 0; j < s.elements.size() && j < element_names.size(); j++)
+        {
+            outstream << ts << ",element," << element_names[j] <<
+                ",processed_units," << s.elements[j].processed_units << endl;
+            outstream << ts << ",element," << element_names[j] <<
+                ",fps," << s.elements[j].fps << endl;
+        }
+    }
+}
+
+static void
+json_string(std::ostream &outstream, const char *str)
+{
+    outstream << '"';
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            outstream << '\\' << *str;
+        else if ((unsigned char) *str < 0x20)
+            outstream << ' ';
+        else
+            outstream << *str;
+    }
+    outstream << '"';
+}
+
+void
+NvApplicationProfiler::exportJSON(std::ostream &outstream)
+{
+    NvAppProfilerData pdata;
+    vector<NvAppProfilerSample> series;
+    vector<ElementEntry> element_list;
+
+    getProfilerData(pdata);
+    getSamples(series);
+    pthread_mutex_lock(&thread_lock);
+    element_list = elements;
+    pthread_mutex_unlock(&thread_lock);
+
+    outstream << "{" << endl;
+    outstream << "\"summary\": {" <<
+        "\"total_time_usec\": " <<
+            (pdata.total_time.tv_sec * 1000000ULL + pdata.total_time.tv_usec) <<
+        ", \"peak_cpu_usage\": " << pdata.peak_cpu_usage <<
+        ", \"avg_cpu_usage\": " << pdata.avg_cpu_usage <<
+        ", \"num_cpu_cores\": " << pdata.num_cpu_cores <<
+        ", \"cpu_freq_mhz\": " << pdata.cpu_freq_mhz <<
+        ", \"peak_rss_kb\": " << pdata.peak_rss_kb <<
+        ", \"peak_pss_kb\": " << pdata.peak_pss_kb <<
+        ", \"minor_faults\": " << pdata.minor_faults <<
+        ", \"major_faults\": " << pdata.major_faults <<
+        ", \"voluntary_ctxt_switches\": " << pdata.voluntary_ctxt_switches <<
+        ", \"involuntary_ctxt_switches\": " << pdata.involuntary_ctxt_switches <<
+        ", \"noise_flags\": " << pdata.noise_flags << "}," << endl;
+
+    outstream << "\"elements\": [";
+    for (size_t i = 0; i < element_list.size(); i++)
+    {
+        NvElementProfiler::NvElementProfilerData edata;
+        element_list[i].element->getProfilingData(edata);
+
+        outstream << (i ? ", " : "") << "{\"name\": ";
+        json_string(outstream, element_list[i].name.c_str());
+        outstream << ", \"total_processed_units\": " << edata.total_processed_units <<
+            ", \"num_late_units\": " << edata.num_late_units <<
+            ", \"average_fps\": " << edata.average_fps <<
+            ", \"average_latency_usec\": " << edata.average_latency_usec <<
+            ", \"min_latency_usec\": " << edata.min_latency_usec <<
+            ", \"max_latency_usec\": " << edata.max_latency_usec << "}";
+    }
+    outstream << "]," << endl;
+
+    outstream << "\"samples\": [" << endl;
+    for (size_t i = 0; i < series.size(); i++)
+    {
+        const NvAppProfilerSample &s = series[i];
+
+        outstream << "{\"timestamp_usec\": " << s.timestamp_usec <<
+            ", \"cpu_usage\": " << s.cpu_usage <<
+            ", \"rss_kb\": " << s.rss_kb <<
+            ", \"pss_kb\": " << s.pss_kb <<
+            ", \"minor_faults\": " << s.minor_faults <<
+            ", \"major_faults\": " << s.major_faults <<
+            ", \"noise_flags\": " << s.noise_flags;
+
+        outstream << ", \"threads\": [";
+        for (size_t j = 0; j < s.threads.size(); j++)
+        {
+            const NvAppProfilerThreadSample &t = s.threads[j];
+            outstream << (j ? ", " : "") << "{\"tid\": " << t.tid << ", \"name\": ";
+            json_string(outstream, t.name);
+            outstream << ", \"role\": \"" << getThreadRoleName(t.role) << "\"" <<
+                ", \"cpu_usage\": " << t.cpu_usage <<
+                ", \"runqueue_wait_usec\": " << t.runqueue_wait_usec <<
+                ", \"voluntary_ctxt_switches\": " << t.voluntary_ctxt_switches <<
+                ", \"involuntary_ctxt_switches\": " << t.involuntary_ctxt_switches <<
+                ", \"minor_faults\": " << t.minor_faults <<
+                ", \"major_faults\": " << t.major_faults <<
+                ", \"last_cpu\": " << t.last_cpu << "}";
+        }
+        outstream << "]";
+
+        outstream << ", \"cores\": [";
+        for (size_t j = 0; j < s.cores.size(); j++)
+        {
+            outstream << (j ? ", " : "") << "{\"freq_mhz\": " << s.cores[j].freq_mhz <<
+                ", \"utilization\": " << s.cores[j].utilization << "}";
+        }
+        outstream << "]";
+
+        outstream << ", \"elements\": [";
+        for (size_t j = 0; j < s.elements.size(); j++)
+        {
+            outstream << (j ? ", " : "") << "{\"processed_units\": " <<
+                s.elements[j].processed_units << ", \"fps\": " <<
+                s.elements[j].fps << "}";
+        }
+        outstream << "]}" << (i + 1 < series.size() ? "," : "") << endl;
+    }
+    outstream << "]" << endl;
+    outstream << "}" << endl;
+}
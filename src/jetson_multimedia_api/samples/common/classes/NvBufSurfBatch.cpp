@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "NvBufSurfBatch.h"
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Jobs of one transform call have to agree on everything but the rectangles */
+static bool
+same_run(const NvBufSurfBatchJob &a, NvBufSurface *a_src, NvBufSurface *a_dst,
+         const NvBufSurfBatchJob &b, NvBufSurface *b_src, NvBufSurface *b_dst)
+{
+    return a.params.flag == b.params.flag &&
+           a.params.flip == b.params.flip &&
+           a.params.filter == b.params.filter &&
+           a_src->memType == b_src->memType &&
+           a_dst->memType == b_dst->memType;
+}
+
+NvBufSurfBatch::NvBufSurfBatch(const char *name, const NvBufSurfBatchOps &ops,
+                               uint32_t max_batch_size)
+    : name(name)
+    , ops(ops)
+    , max_batch_size(max_batch_size ? max_batch_size : 1)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+NvBufSurfBatch::~NvBufSurfBatch()
+{
+}
+
+NvBufSurface *
+NvBufSurfBatch::lookup(int fd)
+{
+    map<int, NvBufSurface *>::iterator it = surfaces.find(fd);
+    NvBufSurface *surface = NULL;
+
+    if (it != surfaces.end())
+    {
+        stats.num_cache_hits++;
+        return it->second;
+    }
+
+    stats.num_lookups++;
+    if (ops.resolve(fd, &surface, ops.arg) < 0 || surface == NULL ||
+        surface->numFilled < 1)
+        return NULL;
+    surfaces[fd] = surface;
+    return surface;
+}
+
+int
+NvBufSurfBatch::submitRun(const NvBufSurfBatchJob *jobs, uint32_t first,
+                          uint32_t count, NvBufSurfBatchFence *fence)
+{
+    NvBufSurface src_batch;
+    NvBufSurface dst_batch;
+    NvBufSurfTransformParams transform_params;
+    NvBufSurfTransformSyncObj_t sync_obj = NULL;
+    const NvBufSurf::NvCommonTransformParams &params = jobs[first].params;
+    int ret;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const NvBufSurf::NvCommonTransformParams &job = jobs[first + i].params;
+
+        src_list[i] = src_surfaces[first + i]->surfaceList[0];
+        dst_list[i] = dst_surfaces[first + i]->surfaceList[0];
+        src_rects[i].top = job.src_top;
+        src_rects[i].left = job.src_left;
+        src_rects[i].width = job.src_width;
+        src_rects[i].height = job.src_height;
+        dst_rects[i].top = job.dst_top;
+        dst_rects[i].left = job.dst_left;
+        dst_rects[i].width = job.dst_width;
+        dst_rects[i].height = job.dst_height;
+    }
+
+    /* Batched surfaces pointing at the entries of the single buffers */
+    src_batch = *src_surfaces[first];
+    src_batch.batchSize = count;
+    src_batch.numFilled = count;
+    src_batch.isContiguous = false;
+    src_batch.surfaceList = &src_list[0];
+    dst_batch = *dst_surfaces[first];
+    dst_batch.batchSize = count;
+    dst_batch.numFilled = count;
+    dst_batch.isContiguous = false;
+    dst_batch.surfaceList = &dst_list[0];
+
+    memset(&transform_params, 0, sizeof(transform_params));
+    transform_params.transform_flag = params.flag;
+    transform_params.transform_flip = params.flip;
+    transform_params.transform_filter = params.filter;
+    transform_params.src_rect = &src_rects[0];
+    transform_params.dst_rect = &dst_rects[0];
+
+    stats.num_calls++;
+    ret = ops.transform(&src_batch, &dst_batch, &transform_params,
+                        fence ? &sync_obj : NULL, ops.arg);
+    if (ret != 0)
+        return -1;
+    if (sync_obj)
+        fence->sync_objs.push_back(sync_obj);
+    return 0;
+}
+
+int
+NvBufSurfBatch::submit(const NvBufSurfBatchJob *jobs, uint32_t count,
+                       NvBufSurfBatchFence *fence)
+{
+    uint64_t start = get_time_usec();
+    int ret = 0;
+
+    if (jobs == NULL || count == 0)
+        return -1;
+
+    stats.num_submits++;
+    src_surfaces.resize(count);
+    dst_surfaces.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        src_surfaces[i] = lookup(jobs[i].src_fd);
+        dst_surfaces[i] = lookup(jobs[i].dst_fd);
+        if (!src_surfaces[i] || !dst_surfaces[i])
+        {
+            stats.submit_usec += get_time_usec() - start;
+            return -1;
+        }
+    }
+
+    if (src_list.size() < max_batch_size)
+    {
+        src_list.resize(max_batch_size);
+        dst_list.resize(max_batch_size);
+        src_rects.resize(max_batch_size);
+        dst_rects.resize(max_batch_size);
+    }
+
+    /* One transform call per run of compatible jobs */
+    for (uint32_t first = 0; first < count && ret == 0; )
+    {
+        uint32_t run = 1;
+
+        while (first + run < count && run < max_batch_size &&
+               same_run(jobs[first], src_surfaces[first], dst_surfaces[first],
+                        jobs[first + run], src_surfaces[first + run],
+                        dst_surfaces[first + run]))
+            run++;
+        ret = submitRun(jobs, first, run, fence);
+        stats.num_jobs += run;
+        first += run;
+    }
+
+    stats.submit_usec += get_time_usec() - start;
+    return ret;
+}
+
+int
+NvBufSurfBatch::wait(NvBufSurfBatchFence *fence, uint32_t timeout_ms)
+{
+    uint64_t start = get_time_usec();
+    int ret = 0;
+
+    if (fence == NULL)
+        return -1;
+
+    /* Release every completion, even after a failed one */
+    for (size_t i = 0; i < fence->sync_objs.size(); i++)
+    {
+        if (ops.wait(fence->sync_objs[i], timeout_ms, ops.arg) != 0)
+            ret = -1;
+    }
+    fence->sync_objs.clear();
+
+    stats.wait_usec += get_time_usec() - start;
+    return ret;
+}
+
+void
+NvBufSurfBatch::forget(int fd)
+{
+    surfaces.erase(fd);
+}
+
+void
+NvBufSurfBatch::clearCache()
+{
+    surfaces.clear();
+}
+
+void
+NvBufSurfBatch::getStats(NvBufSurfBatchStats *out)
+{
+    *out = stats;
+}
+
+void
+NvBufSurfBatch::printStats(ostream &outstream)
+{
+    outstream << "----------- " << name << " batch transform -----------" << endl;
+    outstream << "Batches: " << stats.num_submits <<
+        ", jobs: " << stats.num_jobs <<
+        ", transform calls: " << stats.num_calls << endl;
+    outstream << "FD lookups: " << stats.num_lookups <<
+        ", cache hits: " << stats.num_cache_hits << endl;
+    if (stats.num_jobs)
+        outstream << "Time per job: submit " <<
+            (double) stats.submit_usec / stats.num_jobs << " us, wait " <<
+            (double) stats.wait_usec / stats.num_jobs << " us" << endl;
+}
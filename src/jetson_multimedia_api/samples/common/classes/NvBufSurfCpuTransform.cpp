@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "NvBufSurfCpuTransform.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+using namespace std;
+
+#define PITCH_ALIGN 64
+#define FIRST_FD 0x10000
+
+static uint64_t
+get_time_nsec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Busy wait, usleep() cannot wait for a few microseconds */
+static void
+spend_usec(uint32_t usec)
+{
+    uint64_t end;
+
+    if (usec == 0)
+        return;
+    end = get_time_nsec() + (uint64_t) usec * 1000;
+    while (get_time_nsec() < end)
+        ;
+}
+
+static uint32_t
+align_up(uint32_t value, uint32_t align)
+{
+    return (value + align - 1) / align * align;
+}
+
+static uint8_t
+clamp_u8(int value)
+{
+    return (uint8_t) (value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/* Rectangle of the half resolution chroma plane covering a luma rectangle */
+static NvBufSurfTransformRect
+chroma_rect(const NvBufSurfTransformRect &rect)
+{
+    NvBufSurfTransformRect chroma;
+
+    chroma.left = rect.left / 2;
+    chroma.top = rect.top / 2;
+    chroma.width = (rect.left + rect.width + 1) / 2 - chroma.left;
+    chroma.height = (rect.top + rect.height + 1) / 2 - chroma.top;
+    return chroma;
+}
+
+/*
+ * Scales the source rectangle of a plane into the destination rectangle of
+ * another plane with the same number of interleaved channels. Sampling is
+ * at pixel centers; bilinear weights are 8 bit fixed point.
+ */
+static void
+scale_plane(const uint8_t *src, uint32_t src_pitch, const NvBufSurfTransformRect &sr,
+            uint8_t *dst, uint32_t dst_pitch, const NvBufSurfTransformRect &dr,
+            uint32_t channels, bool bilinear, vector<uint32_t> &xmap)
+{
+    xmap.resize(dr.width * 2);
+
+    if (!bilinear)
+    {
+        for (uint32_t x = 0; x < dr.width; x++)
+            xmap[x] = (sr.left + (uint32_t) (((2ULL * x + 1) * sr.width) / (2ULL * dr.width))) * channels;
+
+        for (uint32_t y = 0; y < dr.height; y++)
+        {
+            uint32_t sy = sr.top + (uint32_t) (((2ULL * y + 1) * sr.height) / (2ULL * dr.height));
+            const uint8_t *s = src + (size_t) sy * src_pitch;
+            uint8_t *d = dst + (size_t) (dr.top + y) * dst_pitch + dr.left * channels;
+
+            if (channels == 1)
+            {
+                for (uint32_t x = 0; x < dr.width; x++)
+                    d[x] = s[xmap[x]];
+            }
+            else
+            {
+                for (uint32_t x = 0; x < dr.width; x++, d += channels)
+                    memcpy(d, s + xmap[x], channels);
+            }
+        }
+        return;
+    }
+
+    /* xmap holds the left sample and its weight for each destination column */
+    for (uint32_t x = 0; x < dr.width; x++)
+    {
+        int64_t pos = (int64_t) (((2ULL * x + 1) * sr.width * 256) / (2ULL * dr.width)) - 128;
+        uint32_t x0 = pos < 0 ? 0 : (uint32_t) (pos >> 8);
+        uint32_t weight = pos < 0 ? 0 : (uint32_t) (pos & 255);
+
+        if (x0 >= sr.width - 1)
+        {
+            x0 = sr.width - 1;
+            weight = 0;
+        }
+        xmap[2 * x] = x0;
+        xmap[2 * x + 1] = weight;
+    }
+
+    for (uint32_t y = 0; y < dr.height; y++)
+    {
+        int64_t pos = (int64_t) (((2ULL * y + 1) * sr.height * 256) / (2ULL * dr.height)) - 128;
+        uint32_t y0 = pos < 0 ? 0 : (uint32_t) (pos >> 8);
+        uint32_t wy = pos < 0 ? 0 : (uint32_t) (pos & 255);
+        uint32_t y1;
+
+        if (y0 >= sr.height - 1)
+        {
+            y0 = sr.height - 1;
+            wy = 0;
+        }
+        y1 = min(y0 + 1, sr.height - 1);
+
+        const uint8_t *s0 = src + (size_t) (sr.top + y0) * src_pitch + sr.left * channels;
+        const uint8_t *s1 = src + (size_t) (sr.top + y1) * src_pitch + sr.left * channels;
+        uint8_t *d = dst + (size_t) (dr.top + y) * dst_pitch + dr.left * channels;
+
+        for (uint32_t x = 0; x < dr.width; x++)
+        {
+            uint32_t x0 = xmap[2 * x];
+            uint32_t x1 = min(x0 + 1, sr.width - 1);
+            uint32_t wx = xmap[2 * x + 1];
+
+            for (uint32_t c = 0; c < channels; c++)
+            {
+                uint32_t top = s0[x0 * channels + c] * (256 - wx) + s0[x1 * channels + c] * wx;
+                uint32_t bottom = s1[x0 * channels + c] * (256 - wx) + s1[x1 * channels + c] * wx;
+
+                *d++ = (uint8_t) ((top * (256 - wy) + bottom * wy + 32768) >> 16);
+            }
+        }
+    }
+}
+
+static bool
+rect_fits(const NvBufSurfTransformRect &rect, const NvBufSurfaceParams &surface)
+{
+    return rect.width > 0 && rect.height > 0 &&
+           rect.left + rect.width <= surface.width &&
+           rect.top + rect.height <= surface.height;
+}
+
+static bool
+is_supported(const NvBufSurfaceParams &surface)
+{
+    if (surface.colorFormat == NVBUF_COLOR_FORMAT_NV12)
+        return surface.mappedAddr.addr[0] && surface.mappedAddr.addr[1];
+    if (surface.colorFormat == NVBUF_COLOR_FORMAT_RGBA)
+        return surface.mappedAddr.addr[0] != NULL;
+    return false;
+}
+
+/* Scratch buffers of one transform call */
+typedef struct
+{
+    vector<uint32_t> xmap;
+    vector<uint8_t> plane0;
+    vector<uint8_t> plane1;
+} cpu_scratch;
+
+static void
+transform_one(const NvBufSurfaceParams &s, const NvBufSurfTransformRect &sr,
+              const NvBufSurfaceParams &d, const NvBufSurfTransformRect &dr,
+              bool bilinear, cpu_scratch &scratch)
+{
+    const NvBufSurfacePlaneParams &sp = s.planeParams;
+    const NvBufSurfacePlaneParams &dp = d.planeParams;
+    const uint8_t *src_y = (const uint8_t *) s.mappedAddr.addr[0];
+    const uint8_t *src_uv = (const uint8_t *) s.mappedAddr.addr[1];
+    uint8_t *dst_y = (uint8_t *) d.mappedAddr.addr[0];
+    uint8_t *dst_uv = (uint8_t *) d.mappedAddr.addr[1];
+    NvBufSurfTransformRect full = { 0, 0, dr.width, dr.height };
+    NvBufSurfTransformRect full_chroma = { 0, 0, (dr.width + 1) / 2, (dr.height + 1) / 2 };
+
+    if (s.colorFormat == d.colorFormat)
+    {
+        if (s.colorFormat == NVBUF_COLOR_FORMAT_RGBA)
+        {
+            scale_plane(src_y, sp.pitch[0], sr, dst_y, dp.pitch[0], dr, 4,
+                        bilinear, scratch.xmap);
+        }
+        else
+        {
+            scale_plane(src_y, sp.pitch[0], sr, dst_y, dp.pitch[0], dr, 1,
+                        bilinear, scratch.xmap);
+            scale_plane(src_uv, sp.pitch[1], chroma_rect(sr), dst_uv, dp.pitch[1],
+                        chroma_rect(dr), 2, bilinear, scratch.xmap);
+        }
+        return;
+    }
+
+    if (s.colorFormat == NVBUF_COLOR_FORMAT_NV12)
+    {
+        /* Scale the planes to the destination size, then convert */
+        uint32_t uv_pitch = full_chroma.width * 2;
+
+        scratch.plane0.resize((size_t) dr.width * dr.height);
+        scratch.plane1.resize((size_t) uv_pitch * full_chroma.height);
+        scale_plane(src_y, sp.pitch[0], sr, &scratch.plane0[0], dr.width, full, 1,
+                    bilinear, scratch.xmap);
+        scale_plane(src_uv, sp.pitch[1], chroma_rect(sr), &scratch.plane1[0], uv_pitch,
+                    full_chroma, 2, bilinear, scratch.xmap);
+
+        for (uint32_t y = 0; y < dr.height; y++)
+        {
+            const uint8_t *ys = &scratch.plane0[(size_t) y * dr.width];
+            const uint8_t *uvs = &scratch.plane1[(size_t) (y / 2) * uv_pitch];
+            uint8_t *out = dst_y + (size_t) (dr.top + y) * dp.pitch[0] + dr.left * 4;
+
+            for (uint32_t x = 0; x < dr.width; x++, out += 4)
+            {
+                int c = 298 * (ys[x] - 16);
+                int u = uvs[(x / 2) * 2] - 128;
+                int v = uvs[(x / 2) * 2 + 1] - 128;
+
+                out[0] = clamp_u8((c + 409 * v + 128) >> 8);
+                out[1] = clamp_u8((c - 100 * u - 208 * v + 128) >> 8);
+                out[2] = clamp_u8((c + 516 * u + 128) >> 8);
+                out[3] = 255;
+            }
+        }
+        return;
+    }
+
+    /* RGBA to NV12: scale to the destination size, then convert */
+    uint32_t rgba_pitch = dr.width * 4;
+    NvBufSurfTransformRect dc = chroma_rect(dr);
+
+    scratch.plane0.resize((size_t) rgba_pitch * dr.height);
+    scale_plane(src_y, sp.pitch[0], sr, &scratch.plane0[0], rgba_pitch, full, 4,
+                bilinear, scratch.xmap);
+
+    for (uint32_t y = 0; y < dr.height; y++)
+    {
+        const uint8_t *in = &scratch.plane0[(size_t) y * rgba_pitch];
+        uint8_t *out = dst_y + (size_t) (dr.top + y) * dp.pitch[0] + dr.left;
+
+        for (uint32_t x = 0; x < dr.width; x++, in += 4)
+            out[x] = (uint8_t) (((66 * in[0] + 129 * in[1] + 25 * in[2] + 128) >> 8) + 16);
+    }
+
+    /* Each chroma sample averages the luma pixels it covers inside the rectangle */
+    for (uint32_t cy = 0; cy < dc.height; cy++)
+    {
+        uint8_t *out = dst_uv + (size_t) (dc.top + cy) * dp.pitch[1] + dc.left * 2;
+
+        for (uint32_t cx = 0; cx < dc.width; cx++, out += 2)
+        {
+            int r = 0, g = 0, b = 0, n = 0;
+
+            for (uint32_t py = 2 * (dc.top + cy); py < 2 * (dc.top + cy) + 2; py++)
+            {
+                for (uint32_t px = 2 * (dc.left + cx); px < 2 * (dc.left + cx) + 2; px++)
+                {
+                    if (py < dr.top || py >= dr.top + dr.height ||
+                        px < dr.left || px >= dr.left + dr.width)
+                        continue;
+                    const uint8_t *in = &scratch.plane0[(size_t) (py - dr.top) * rgba_pitch +
+                                                        (px - dr.left) * 4];
+                    r += in[0];
+                    g += in[1];
+                    b += in[2];
+                    n++;
+                }
+            }
+            r /= n;
+            g /= n;
+            b /= n;
+            out[0] = (uint8_t) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            out[1] = (uint8_t) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+int
+NvBufSurfCpuTransform::transform(NvBufSurface *src, NvBufSurface *dst,
+                                 NvBufSurfTransformParams *params)
+{
+    cpu_scratch scratch;
+    bool bilinear;
+
+    if (!src || !dst || !params || src->numFilled != dst->numFilled)
+        return NvBufSurfTransformError_Invalid_Params;
+    if ((params->transform_flag & NVBUFSURF_TRANSFORM_FLIP) &&
+        params->transform_flip != NvBufSurfTransform_None)
+        return NvBufSurfTransformError_Unsupported;
+    if (params->transform_flag & NVBUFSURF_TRANSFORM_NORMALIZE)
+        return NvBufSurfTransformError_Unsupported;
+
+    /* Nearest unless another filter is asked for, as the hardware default */
+    bilinear = (params->transform_flag & NVBUFSURF_TRANSFORM_FILTER) &&
+               params->transform_filter != NvBufSurfTransformInter_Nearest &&
+               params->transform_filter != NvBufSurfTransformInter_Default;
+
+    /* Check the whole batch first, so that a bad job does not leave it half done */
+    for (uint32_t i = 0; i < src->numFilled; i++)
+    {
+        const NvBufSurfaceParams &s = src->surfaceList[i];
+        const NvBufSurfaceParams &d = dst->surfaceList[i];
+        NvBufSurfTransformRect sr = { 0, 0, s.width, s.height };
+        NvBufSurfTransformRect dr = { 0, 0, d.width, d.height };
+
+        if (!is_supported(s) || !is_supported(d))
+            return NvBufSurfTransformError_Unsupported;
+        if (params->transform_flag & NVBUFSURF_TRANSFORM_CROP_SRC)
+            sr = params->src_rect[i];
+        if (params->transform_flag & NVBUFSURF_TRANSFORM_CROP_DST)
+            dr = params->dst_rect[i];
+        if (!rect_fits(sr, s) || !rect_fits(dr, d))
+            return NvBufSurfTransformError_ROI_Error;
+    }
+
+    for (uint32_t i = 0; i < src->numFilled; i++)
+    {
+        const NvBufSurfaceParams &s = src->surfaceList[i];
+        const NvBufSurfaceParams &d = dst->surfaceList[i];
+        NvBufSurfTransformRect sr = { 0, 0, s.width, s.height };
+        NvBufSurfTransformRect dr = { 0, 0, d.width, d.height };
+
+        if (params->transform_flag & NVBUFSURF_TRANSFORM_CROP_SRC)
+            sr = params->src_rect[i];
+        if (params->transform_flag & NVBUFSURF_TRANSFORM_CROP_DST)
+            dr = params->dst_rect[i];
+        transform_one(s, sr, d, dr, bilinear, scratch);
+    }
+    return NvBufSurfTransformError_Success;
+}
+
+NvBufSurfCpuTransform::NvBufSurfCpuTransform(uint32_t lookup_usec, uint32_t call_usec)
+    : lookup_usec(lookup_usec)
+    , call_usec(call_usec)
+    , next_fd(FIRST_FD)
+{
+}
+
+NvBufSurfCpuTransform::~NvBufSurfCpuTransform()
+{
+    while (!buffers.empty())
+        destroy(buffers.begin()->first);
+}
+
+int
+NvBufSurfCpuTransform::allocate(NvBufSurf::NvCommonAllocateParams *allocateParams,
+                                uint32_t numBuffers, int *fd)
+{
+    if (numBuffers < 1 || allocateParams == NULL ||
+        allocateParams->width == 0 || allocateParams->height == 0)
+        return -1;
+    if (allocateParams->colorFormat != NVBUF_COLOR_FORMAT_NV12 &&
+        allocateParams->colorFormat != NVBUF_COLOR_FORMAT_RGBA)
+        return -1;
+
+    for (uint32_t index = 0; index < numBuffers; index++)
+    {
+        NvBufSurface *surface = new NvBufSurface;
+        NvBufSurfaceParams *params = new NvBufSurfaceParams;
+        NvBufSurfacePlaneParams &planes = params->planeParams;
+        uint32_t width = allocateParams->width;
+        uint32_t height = allocateParams->height;
+        uint32_t size = 0;
+        void *data = NULL;
+
+        memset(surface, 0, sizeof(*surface));
+        memset(params, 0, sizeof(*params));
+
+        if (allocateParams->colorFormat == NVBUF_COLOR_FORMAT_NV12)
+        {
+            planes.num_planes = 2;
+            planes.width[0] = width;
+            planes.height[0] = height;
+            planes.bytesPerPix[0] = 1;
+            planes.width[1] = (width + 1) / 2;
+            planes.height[1] = (height + 1) / 2;
+            planes.bytesPerPix[1] = 2;
+        }
+        else
+        {
+            planes.num_planes = 1;
+            planes.width[0] = width;
+            planes.height[0] = height;
+            planes.bytesPerPix[0] = 4;
+        }
+        for (uint32_t p = 0; p < planes.num_planes; p++)
+        {
+            planes.pitch[p] = align_up(planes.width[p] * planes.bytesPerPix[p], PITCH_ALIGN);
+            planes.offset[p] = size;
+            planes.psize[p] = planes.pitch[p] * planes.height[p];
+            size += planes.psize[p];
+        }
+
+        if (posix_memalign(&data, PITCH_ALIGN, size) != 0)
+        {
+            delete params;
+            delete surface;
+            return -1;
+        }
+        memset(data, 0, size);
+
+        params->width = width;
+        params->height = height;
+        params->pitch = planes.pitch[0];
+        params->colorFormat = allocateParams->colorFormat;
+        params->layout = NVBUF_LAYOUT_PITCH;
+        params->bufferDesc = next_fd;
+        params->dataSize = size;
+        params->dataPtr = data;
+        for (uint32_t p = 0; p < planes.num_planes; p++)
+            params->mappedAddr.addr[p] = (uint8_t *) data + planes.offset[p];
+
+        surface->batchSize = 1;
+        surface->numFilled = 1;
+        surface->memType = NVBUF_MEM_SYSTEM;
+        surface->surfaceList = params;
+
+        fd[index] = next_fd++;
+        buffers[fd[index]] = surface;
+    }
+    return 0;
+}
+
+int
+NvBufSurfCpuTransform::destroy(int fd)
+{
+    map<int, NvBufSurface *>::iterator it = buffers.find(fd);
+
+    if (it == buffers.end())
+        return -1;
+    free(it->second->surfaceList->dataPtr);
+    delete it->second->surfaceList;
+    delete it->second;
+    buffers.erase(it);
+    return 0;
+}
+
+NvBufSurface *
+NvBufSurfCpuTransform::getSurface(int fd)
+{
+    map<int, NvBufSurface *>::iterator it = buffers.find(fd);
+
+    return it == buffers.end() ? NULL : it->second;
+}
+
+int
+NvBufSurfCpuTransform::resolveCall(int fd, NvBufSurface **surface, void *arg)
+{
+    NvBufSurfCpuTransform *thiz = (NvBufSurfCpuTransform *) arg;
+
+    spend_usec(thiz->lookup_usec);
+    *surface = thiz->getSurface(fd);
+    return *surface ? 0 : -1;
+}
+
+int
+NvBufSurfCpuTransform::transformCall(NvBufSurface *src, NvBufSurface *dst,
+                                     NvBufSurfTransformParams *params,
+                                     NvBufSurfTransformSyncObj_t *sync_obj, void *arg)
+{
+    NvBufSurfCpuTransform *thiz = (NvBufSurfCpuTransform *) arg;
+
+    spend_usec(thiz->call_usec);
+    /* Complete before returning, there is nothing to wait for */
+    if (sync_obj)
+        *sync_obj = NULL;
+    return transform(src, dst, params);
+}
+
+int
+NvBufSurfCpuTransform::waitCall(NvBufSurfTransformSyncObj_t sync_obj,
+                                uint32_t timeout_ms, void *arg)
+{
+    return 0;
+}
+
+NvBufSurfBatchOps
+NvBufSurfCpuTransform::getOps()
+{
+    NvBufSurfBatchOps ops;
+
+    ops.resolve = resolveCall;
+    ops.transform = transformCall;
+    ops.wait = waitCall;
+    ops.arg = this;
+    return ops;
+}
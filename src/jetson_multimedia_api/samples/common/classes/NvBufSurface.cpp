@@ -8,6 +8,8 @@
  */
 
 #include "NvBufSurface.h"
+#include "NvBufSurfBatch.h"
+#include "NvRawFrameSink.h"
 
 using namespace std;
 
@@ -117,3 +119,91 @@ NvBufSurf::NvTransformAsync(NvCommonTransformParams *transformParams, NvBufSurfT
     return ret;
 }
 
+static int
+batch_resolve(int fd, NvBufSurface **surface, void *arg)
+{
+    return NvBufSurfaceFromFd(fd, (void**)surface);
+}
+
+static int
+batch_transform(NvBufSurface *src, NvBufSurface *dst,
+                NvBufSurfTransformParams *params,
+                NvBufSurfTransformSyncObj_t *sync_obj, void *arg)
+{
+    if (sync_obj)
+      return NvBufSurfTransformAsync(src, dst, params, sync_obj);
+    return NvBufSurfTransform(src, dst, params);
+}
+
+static int
+batch_wait(NvBufSurfTransformSyncObj_t sync_obj, uint32_t timeout_ms, void *arg)
+{
+    int ret = NvBufSurfTransformSyncObjWait(sync_obj, timeout_ms);
+
+    NvBufSurfTransformSyncObjDestroy(&sync_obj);
+    return ret;
+}
+
+/* Defined here with the other NvBufSurfTransform users, so that
+ * NvBufSurfBatch itself builds without the transform library. */
+NvBufSurfBatchOps
+NvBufSurfBatch::hardwareOps()
+{
+    NvBufSurfBatchOps ops;
+
+    ops.resolve = batch_resolve;
+    ops.transform = batch_transform;
+    ops.wait = batch_wait;
+    ops.arg = NULL;
+    return ops;
+}
+
+static int
+sink_map(int fd, NvRawFrameMapping *mapping, void *arg)
+{
+    NvBufSurface *nvbuf_surf = 0;
+
+    if (NvBufSurfaceFromFd(fd, (void**)(&nvbuf_surf)) || nvbuf_surf == NULL)
+      return -1;
+
+    NvBufSurfacePlaneParams &planes = nvbuf_surf->surfaceList[0].planeParams;
+    if (planes.num_planes > NV_RAW_FRAME_SINK_MAX_PLANES)
+      return -1;
+    if (NvBufSurfaceMap(nvbuf_surf, 0, -1, NVBUF_MAP_READ))
+      return -1;
+
+    mapping->num_planes = planes.num_planes;
+    for (uint32_t plane = 0; plane < planes.num_planes; plane++) {
+      mapping->planes[plane] =
+          (uint8_t *) nvbuf_surf->surfaceList[0].mappedAddr.addr[plane];
+      mapping->row_bytes[plane] = planes.width[plane] * planes.bytesPerPix[plane];
+      mapping->height[plane] = planes.height[plane];
+      mapping->pitch[plane] = planes.pitch[plane];
+    }
+    mapping->handle = nvbuf_surf;
+    return 0;
+}
+
+static int
+sink_sync(NvRawFrameMapping *mapping, void *arg)
+{
+    return NvBufSurfaceSyncForCpu((NvBufSurface *) mapping->handle, 0, -1);
+}
+
+static void
+sink_unmap(NvRawFrameMapping *mapping, void *arg)
+{
+    NvBufSurfaceUnMap((NvBufSurface *) mapping->handle, 0, -1);
+}
+
+NvRawFrameSinkOps
+NvRawFrameSink::hardwareOps()
+{
+    NvRawFrameSinkOps ops;
+
+    ops.map = sink_map;
+    ops.sync = sink_sync;
+    ops.unmap = sink_unmap;
+    ops.arg = NULL;
+    return ops;
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvBufferFanout.h"
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+NvBufferFanout::NvBufferFanout(const char *name, uint32_t num_buffers,
+                               RecycleCallback recycle, void *arg)
+    : name(name)
+    , recycle(recycle)
+    , arg(arg)
+    , refs(num_buffers, 0)
+    , num_in_flight(0)
+    , closed(false)
+    , aborted(false)
+{
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&work_cond, NULL);
+    pthread_cond_init(&space_cond, NULL);
+}
+
+NvBufferFanout::~NvBufferFanout()
+{
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&work_cond);
+    pthread_cond_destroy(&space_cond);
+}
+
+int
+NvBufferFanout::addBranch(const char *name, uint32_t depth, NvFanoutPolicy policy)
+{
+    Branch branch;
+    int id;
+
+    branch.name = name;
+    branch.depth = depth ? depth : 1;
+    branch.policy = policy;
+    memset(&branch.stats, 0, sizeof(branch.stats));
+
+    pthread_mutex_lock(&lock);
+    if (stats.num_published)
+    {
+        pthread_mutex_unlock(&lock);
+        cerr << "Cannot add branch " << name << " to " << this->name <<
+            " after the first publish" << endl;
+        return -1;
+    }
+    branches.push_back(branch);
+    id = branches.size() - 1;
+    pthread_mutex_unlock(&lock);
+
+    return id;
+}
+
+uint32_t
+NvBufferFanout::getNumBranches()
+{
+    uint32_t num_branches;
+
+    pthread_mutex_lock(&lock);
+    num_branches = branches.size();
+    pthread_mutex_unlock(&lock);
+
+    return num_branches;
+}
+
+int
+NvBufferFanout::setNumBuffers(uint32_t num_buffers)
+{
+    pthread_mutex_lock(&lock);
+    if (num_in_flight)
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+    refs.assign(num_buffers, 0);
+    pthread_mutex_unlock(&lock);
+
+    return 0;
+}
+
+bool
+NvBufferFanout::unref(uint32_t index)
+{
+    if (--refs[index])
+        return false;
+
+    num_in_flight--;
+    stats.num_recycled++;
+    pthread_cond_broadcast(&space_cond);
+    return true;
+}
+
+int
+NvBufferFanout::publish(uint32_t index)
+{
+    int queued = 0;
+    bool last;
+
+    pthread_mutex_lock(&lock);
+    if (aborted || closed || index >= refs.size() || refs[index])
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    /* Hold a reference while queueing, so that a branch releasing the
+       buffer early cannot recycle it before the other branches get it. */
+    refs[index] = 1;
+    num_in_flight++;
+    stats.num_published++;
+    if (num_in_flight > stats.max_in_flight)
+        stats.max_in_flight = num_in_flight;
+
+    for (size_t i = 0; i < branches.size() && !aborted; i++)
+    {
+        Branch &branch = branches[i];
+
+        if (branch.queue.size() >= branch.depth)
+        {
+            uint64_t wait_start, wait_usec;
+
+            if (branch.policy == NV_FANOUT_POLICY_DROP)
+            {
+                branch.stats.num_dropped++;
+                continue;
+            }
+
+            wait_start = get_time_usec();
+            stats.num_full_waits++;
+            while (branch.queue.size() >= branch.depth && !aborted)
+                pthread_cond_wait(&space_cond, &lock);
+            wait_usec = get_time_usec() - wait_start;
+            stats.full_wait_usec += wait_usec;
+            branch.stats.full_wait_usec += wait_usec;
+            if (aborted)
+                break;
+        }
+
+        branch.queue.push_back(index);
+        refs[index]++;
+        queued++;
+        branch.stats.num_delivered++;
+        if (branch.queue.size() > branch.stats.max_depth)
+            branch.stats.max_depth = branch.queue.size();
+        pthread_cond_broadcast(&work_cond);
+    }
+
+    last = unref(index);
+    if (aborted)
+        queued = -1;
+    pthread_mutex_unlock(&lock);
+
+    if (last && recycle)
+        recycle(index, arg);
+
+    return queued;
+}
+
+int
+NvBufferFanout::acquire(uint32_t branch, uint32_t &index)
+{
+    pthread_mutex_lock(&lock);
+    if (branch >= branches.size())
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    deque<uint32_t> &queue = branches[branch].queue;
+    while (queue.empty() && !closed && !aborted)
+        pthread_cond_wait(&work_cond, &lock);
+    if (queue.empty() || aborted)
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    index = queue.front();
+    queue.pop_front();
+    pthread_cond_broadcast(&space_cond);
+    pthread_mutex_unlock(&lock);
+
+    return 0;
+}
+
+int
+NvBufferFanout::release(uint32_t branch, uint32_t index)
+{
+    bool last;
+
+    pthread_mutex_lock(&lock);
+    if (branch >= branches.size() || index >= refs.size() || !refs[index])
+    {
+        pthread_mutex_unlock(&lock);
+        cerr << "Buffer " << index << " released by " << name <<
+            " branch " << branch << " holds no reference" << endl;
+        return -1;
+    }
+    last = unref(index);
+    pthread_mutex_unlock(&lock);
+
+    if (last && recycle)
+        recycle(index, arg);
+
+    return 0;
+}
+
+void
+NvBufferFanout::close()
+{
+    pthread_mutex_lock(&lock);
+    closed = true;
+    pthread_cond_broadcast(&work_cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvBufferFanout::abort()
+{
+    pthread_mutex_lock(&lock);
+    aborted = true;
+    pthread_cond_broadcast(&work_cond);
+    pthread_cond_broadcast(&space_cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvBufferFanout::waitIdle()
+{
+    pthread_mutex_lock(&lock);
+    while (num_in_flight && !aborted)
+        pthread_cond_wait(&space_cond, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+uint32_t
+NvBufferFanout::getNumInFlight()
+{
+    uint32_t in_flight;
+
+    pthread_mutex_lock(&lock);
+    in_flight = num_in_flight;
+    pthread_mutex_unlock(&lock);
+
+    return in_flight;
+}
+
+void
+NvBufferFanout::getStats(NvBufferFanoutStats &stats)
+{
+    pthread_mutex_lock(&lock);
+    stats = this->stats;
+    pthread_mutex_unlock(&lock);
+}
+
+int
+NvBufferFanout::getBranchStats(uint32_t branch, NvBufferFanoutBranchStats &stats)
+{
+    pthread_mutex_lock(&lock);
+    if (branch >= branches.size())
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+    stats = branches[branch].stats;
+    pthread_mutex_unlock(&lock);
+
+    return 0;
+}
+
+void
+NvBufferFanout::printStats(ostream &outstream)
+{
+    NvBufferFanoutStats fanout_stats;
+    deque<Branch> branch_copy;
+
+    pthread_mutex_lock(&lock);
+    fanout_stats = stats;
+    branch_copy = branches;
+    pthread_mutex_unlock(&lock);
+
+    outstream << "----------- " << name << " fan-out -----------" << endl;
+    outstream << "Buffers published: " << fanout_stats.num_published <<
+        ", recycled: " << fanout_stats.num_recycled <<
+        ", max in flight: " << fanout_stats.max_in_flight << endl;
+    outstream << "Producer waits on full branch: " << fanout_stats.num_full_waits <<
+        " (" << fanout_stats.full_wait_usec << " us)" << endl;
+    for (size_t i = 0; i < branch_copy.size(); i++)
+    {
+        const Branch &branch = branch_copy[i];
+
+        outstream << "Branch " << branch.name << " (" <<
+            (branch.policy == NV_FANOUT_POLICY_DROP ? "drop" : "block") <<
+            ", depth " << branch.depth << "): delivered " <<
+            branch.stats.num_delivered << ", dropped " << branch.stats.num_dropped <<
+            ", max depth " << branch.stats.max_depth << ", producer wait " <<
+            branch.stats.full_wait_usec << " us" << endl;
+    }
+    outstream << "-------------------------------------" << endl;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvDecoderCapturePool.h"
+#include <algorithm>
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+NvDecoderCapturePool::NvDecoderCapturePool(const char *name,
+                                           const NvDecoderCapturePoolOps &ops,
+                                           uint32_t max_width, uint32_t max_height,
+                                           uint32_t max_buffers)
+    : name(name)
+    , ops(ops)
+    , max_width(max_width)
+    , max_height(max_height)
+    , max_buffers(max_buffers)
+    , num_buffers(0)
+    , buffer_width(0)
+    , buffer_height(0)
+    , buffer_format(0)
+    , stream_width(0)
+    , stream_height(0)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+NvDecoderCapturePool::~NvDecoderCapturePool()
+{
+    clear();
+}
+
+int
+NvDecoderCapturePool::allocate(uint32_t count)
+{
+    size_t first = fds.size();
+
+    fds.resize(first + count, -1);
+    if (ops.allocate(buffer_width, buffer_height, buffer_format, count,
+                     &fds[first], ops.arg) < 0)
+    {
+        fds.resize(first);
+        return -1;
+    }
+    stats.num_allocated += count;
+    return 0;
+}
+
+int
+NvDecoderCapturePool::configure(uint32_t width, uint32_t height,
+                                uint32_t format, uint32_t count)
+{
+    uint64_t start = get_time_usec();
+    uint64_t elapsed;
+    int ret = 0;
+
+    if (count == 0 || count > max_buffers)
+        return -1;
+
+    stats.num_configures++;
+    if (!fds.empty() && format == buffer_format &&
+        width <= buffer_width && height <= buffer_height)
+    {
+        if (count <= fds.size())
+        {
+            stats.num_reuses++;
+        }
+        else
+        {
+            stats.num_grows++;
+            ret = allocate(count - fds.size());
+        }
+    }
+    else
+    {
+        /* Grow only: the buffers keep the largest size seen in this format */
+        if (!fds.empty())
+            stats.num_reallocations++;
+        clear();
+        buffer_width = max(max(width, max_width), buffer_width);
+        buffer_height = max(max(height, max_height), buffer_height);
+        buffer_format = format;
+        ret = allocate(count);
+    }
+
+    if (ret < 0)
+        clear();
+    num_buffers = ret < 0 ? 0 : count;
+    stream_width = width;
+    stream_height = height;
+
+    elapsed = get_time_usec() - start;
+    stats.switch_usec += elapsed;
+    if (elapsed > stats.max_switch_usec)
+        stats.max_switch_usec = elapsed;
+    return ret;
+}
+
+int
+NvDecoderCapturePool::getFd(uint32_t index)
+{
+    if (index >= num_buffers)
+        return -1;
+    return fds[index];
+}
+
+void
+NvDecoderCapturePool::clear()
+{
+    for (size_t i = 0; i < fds.size(); i++)
+    {
+        ops.destroy(fds[i], ops.arg);
+        stats.num_destroyed++;
+    }
+    fds.clear();
+    num_buffers = 0;
+}
+
+void
+NvDecoderCapturePool::getStats(NvDecoderCapturePoolStats *out)
+{
+    *out = stats;
+}
+
+void
+NvDecoderCapturePool::printStats(ostream &outstream)
+{
+    outstream << "----------- " << name << " capture pool -----------" << endl;
+    outstream << "Resolution changes: " << stats.num_configures <<
+        ", reused: " << stats.num_reuses <<
+        ", grown: " << stats.num_grows <<
+        ", reallocated: " << stats.num_reallocations << endl;
+    outstream << "Buffers allocated: " << stats.num_allocated <<
+        ", destroyed: " << stats.num_destroyed <<
+        ", size: " << buffer_width << "x" << buffer_height << endl;
+    if (stats.num_configures)
+        outstream << "Buffer setup time: avg " <<
+            stats.switch_usec / stats.num_configures << " us, max " <<
+            stats.max_switch_usec << " us" << endl;
+}
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvDrmMailbox.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+
+using namespace std;
+
+/* Plane properties set by each commit */
+enum
+{
+    PROP_FB_ID,
+    PROP_CRTC_ID,
+    PROP_SRC_X,
+    PROP_SRC_Y,
+    PROP_SRC_W,
+    PROP_SRC_H,
+    PROP_CRTC_X,
+    PROP_CRTC_Y,
+    PROP_CRTC_W,
+    PROP_CRTC_H,
+    PROP_COUNT
+};
+
+const char *NvDrmAtomicPlane::prop_names[] =
+{
+    "FB_ID", "CRTC_ID",
+    "SRC_X", "SRC_Y", "SRC_W", "SRC_H",
+    "CRTC_X", "CRTC_Y", "CRTC_W", "CRTC_H"
+};
+
+NvDrmMailbox::NvDrmMailbox()
+    : woken(false)
+    , pending(-1)
+    , pending_usec(0)
+    , flipping(-1)
+    , flipping_usec(0)
+    , displayed(-1)
+{
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+NvDrmMailbox::~NvDrmMailbox()
+{
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&cond);
+}
+
+int
+NvDrmMailbox::post(int buf, uint64_t post_usec)
+{
+    int superseded;
+
+    pthread_mutex_lock(&lock);
+    superseded = pending;
+    if (superseded != -1)
+        stats.num_skipped++;
+    pending = buf;
+    pending_usec = post_usec;
+    stats.num_posted++;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+
+    return superseded;
+}
+
+bool
+NvDrmMailbox::waitForFrame(uint32_t timeout_ms)
+{
+    struct timespec deadline;
+    bool ready;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+
+    pthread_mutex_lock(&lock);
+    while ((pending == -1 || flipping != -1) && !woken)
+    {
+        if (pthread_cond_timedwait(&cond, &lock, &deadline) == ETIMEDOUT)
+            break;
+    }
+    woken = false;
+    ready = pending != -1 && flipping == -1;
+    pthread_mutex_unlock(&lock);
+
+    return ready;
+}
+
+void
+NvDrmMailbox::wake()
+{
+    pthread_mutex_lock(&lock);
+    woken = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+int
+NvDrmMailbox::beginFlip()
+{
+    int buf = -1;
+
+    pthread_mutex_lock(&lock);
+    if (flipping == -1 && pending != -1)
+    {
+        buf = flipping = pending;
+        flipping_usec = pending_usec;
+        pending = -1;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return buf;
+}
+
+int
+NvDrmMailbox::abortFlip()
+{
+    int buf;
+
+    pthread_mutex_lock(&lock);
+    buf = flipping;
+    flipping = -1;
+    if (buf != -1)
+        stats.num_failed++;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+
+    return buf;
+}
+
+int
+NvDrmMailbox::endFlip(uint64_t flip_usec)
+{
+    int released = -1;
+    uint64_t latency;
+
+    pthread_mutex_lock(&lock);
+    if (flipping != -1)
+    {
+        /* A late event stamp before the post would only come from another clock */
+        latency = flip_usec > flipping_usec ? flip_usec - flipping_usec : 0;
+        if (stats.num_displayed == 0 || latency < stats.latency_min_usec)
+            stats.latency_min_usec = latency;
+        if (latency > stats.latency_max_usec)
+            stats.latency_max_usec = latency;
+        stats.latency_total_usec += latency;
+        stats.num_displayed++;
+
+        released = displayed;
+        displayed = flipping;
+        flipping = -1;
+        pthread_cond_signal(&cond);
+    }
+    pthread_mutex_unlock(&lock);
+
+    return released;
+}
+
+bool
+NvDrmMailbox::flipInFlight()
+{
+    bool in_flight;
+
+    pthread_mutex_lock(&lock);
+    in_flight = flipping != -1;
+    pthread_mutex_unlock(&lock);
+
+    return in_flight;
+}
+
+bool
+NvDrmMailbox::hasPending()
+{
+    bool has_pending;
+
+    pthread_mutex_lock(&lock);
+    has_pending = pending != -1;
+    pthread_mutex_unlock(&lock);
+
+    return has_pending;
+}
+
+void
+NvDrmMailbox::drain(int *pending_buf, int *displayed_buf)
+{
+    pthread_mutex_lock(&lock);
+    *pending_buf = pending;
+    *displayed_buf = displayed;
+    pending = displayed = -1;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvDrmMailbox::getStats(NvDrmPresentStats *out)
+{
+    pthread_mutex_lock(&lock);
+    *out = stats;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvDrmMailbox::printStats(const char *name, ostream &outstream)
+{
+    NvDrmPresentStats present_stats;
+
+    getStats(&present_stats);
+
+    outstream << "----------- " << name << " mailbox -----------" << endl;
+    outstream << "Frames posted: " << present_stats.num_posted <<
+        ", displayed: " << present_stats.num_displayed <<
+        ", skipped: " << present_stats.num_skipped <<
+        ", failed flips: " << present_stats.num_failed << endl;
+    if (present_stats.num_displayed)
+        outstream << "Post to scanout latency: avg " <<
+            present_stats.latency_total_usec / present_stats.num_displayed <<
+            " us, min " << present_stats.latency_min_usec <<
+            " us, max " << present_stats.latency_max_usec << " us" << endl;
+}
+
+NvDrmAtomicPlane::NvDrmAtomicPlane()
+    : drm_fd(-1)
+    , crtc_id(0)
+    , plane_id(0)
+{
+    memset(prop_ids, 0, sizeof(prop_ids));
+}
+
+NvDrmAtomicPlane::~NvDrmAtomicPlane()
+{
+}
+
+/* Returns the value of the "type" property of a plane, or -1 */
+static int64_t
+get_plane_type(int drm_fd, uint32_t plane_id)
+{
+    drmModeObjectProperties *props;
+    int64_t type = -1;
+
+    props = drmModeObjectGetProperties(drm_fd, plane_id, DRM_MODE_OBJECT_PLANE);
+    if (!props)
+        return -1;
+    for (uint32_t i = 0; i < props->count_props; i++)
+    {
+        drmModePropertyRes *prop = drmModeGetProperty(drm_fd, props->props[i]);
+
+        if (prop && !strcmp(prop->name, "type"))
+            type = props->prop_values[i];
+        drmModeFreeProperty(prop);
+    }
+    drmModeFreeObjectProperties(props);
+
+    return type;
+}
+
+NvDrmAtomicPlane *
+NvDrmAtomicPlane::create(int drm_fd, uint32_t crtc_id)
+{
+    NvDrmAtomicPlane *atomic_plane = NULL;
+    drmModeRes *res = NULL;
+    drmModePlaneRes *plane_res = NULL;
+    drmModeObjectProperties *props = NULL;
+    uint32_t plane_id = 0;
+    int crtc_index = -1;
+
+    if (drmSetClientCap(drm_fd, DRM_CLIENT_CAP_ATOMIC, 1))
+        return NULL;
+
+    res = drmModeGetResources(drm_fd);
+    plane_res = drmModeGetPlaneResources(drm_fd);
+    if (!res || !plane_res)
+        goto done;
+
+    for (int i = 0; i < res->count_crtcs; i++)
+    {
+        if (res->crtcs[i] == crtc_id)
+            crtc_index = i;
+    }
+    if (crtc_index < 0)
+        goto done;
+
+    for (uint32_t i = 0; i < plane_res->count_planes; i++)
+    {
+        drmModePlane *plane = drmModeGetPlane(drm_fd, plane_res->planes[i]);
+        bool usable = plane && (plane->possible_crtcs & (1 << crtc_index));
+
+        drmModeFreePlane(plane);
+        if (!usable)
+            continue;
+        if (get_plane_type(drm_fd, plane_res->planes[i]) == DRM_PLANE_TYPE_PRIMARY)
+        {
+            plane_id = plane_res->planes[i];
+            break;
+        }
+        if (!plane_id)
+            plane_id = plane_res->planes[i];
+    }
+    if (!plane_id)
+        goto done;
+
+    props = drmModeObjectGetProperties(drm_fd, plane_id, DRM_MODE_OBJECT_PLANE);
+    if (!props)
+        goto done;
+
+    atomic_plane = new NvDrmAtomicPlane();
+    atomic_plane->drm_fd = drm_fd;
+    atomic_plane->crtc_id = crtc_id;
+    atomic_plane->plane_id = plane_id;
+    for (uint32_t i = 0; i < props->count_props; i++)
+    {
+        drmModePropertyRes *prop = drmModeGetProperty(drm_fd, props->props[i]);
+
+        for (int j = 0; prop && j < PROP_COUNT; j++)
+        {
+            if (!strcmp(prop->name, prop_names[j]))
+                atomic_plane->prop_ids[j] = prop->prop_id;
+        }
+        drmModeFreeProperty(prop);
+    }
+    for (int j = 0; j < PROP_COUNT; j++)
+    {
+        if (!atomic_plane->prop_ids[j])
+        {
+            delete atomic_plane;
+            atomic_plane = NULL;
+            break;
+        }
+    }
+
+done:
+    if (props)
+        drmModeFreeObjectProperties(props);
+    if (plane_res)
+        drmModeFreePlaneResources(plane_res);
+    if (res)
+        drmModeFreeResources(res);
+    return atomic_plane;
+}
+
+int
+NvDrmAtomicPlane::flip(uint32_t fb_id, uint32_t src_w, uint32_t src_h,
+                       uint32_t crtc_w, uint32_t crtc_h, void *user_data)
+{
+    /* Source coordinates are 16.16 fixed point */
+    const uint64_t values[PROP_COUNT] =
+    {
+        fb_id, crtc_id,
+        0, 0, (uint64_t) src_w << 16, (uint64_t) src_h << 16,
+        0, 0, crtc_w, crtc_h
+    };
+    drmModeAtomicReq *req;
+    int ret = 0;
+
+    req = drmModeAtomicAlloc();
+    if (!req)
+        return -ENOMEM;
+
+    for (int i = 0; i < PROP_COUNT && ret >= 0; i++)
+        ret = drmModeAtomicAddProperty(req, plane_id, prop_ids[i], values[i]);
+    if (ret >= 0)
+        ret = drmModeAtomicCommit(drm_fd, req,
+                                  DRM_MODE_PAGE_FLIP_EVENT | DRM_MODE_ATOMIC_NONBLOCK,
+                                  user_data);
+    drmModeAtomicFree(req);
+
+    return ret < 0 ? ret : 0;
+}
@@ -9,6 +9,7 @@
 
 #include "NvDrmRenderer.h"
 #include "NvLogging.h"
+#include "NvThreadPolicy.h"
 #include "nvbufsurface.h"
 
 #include <sys/time.h>
@@ -194,6 +195,10 @@ NvDrmRenderer::NvDrmRenderer(const char *name, uint32_t w, uint32_t h,
   is_nvidia_drm = false;
   activeFd = flippedFd = -1;
   last_fb = 0;
+  present_mode = NvDrmPresentMode_Fifo;
+  mailbox = NULL;
+  atomic_plane = NULL;
+  mailbox_eos = false;
   int ret =0;
   log_level = LOG_LEVEL_ERROR;
   last_render_time.tv_sec = 0;
@@ -484,6 +489,8 @@ NvDrmRenderer::renderThread(void *arg)
   int ret;
   int timeout = 500; // 500ms
 
+  NvThreadPolicy::getInstance().applyToCurrentThread("render");
+
   memset(&fds, 0, sizeof(fds));
   fds.fd = renderer->drm_fd;
   fds.events = POLLIN;
@@ -534,6 +541,8 @@ NvDrmRenderer::renderThreadOrin(void *arg)
   NvDrmRenderer *renderer = (NvDrmRenderer *) arg;
   int ret;
 
+  NvThreadPolicy::getInstance().applyToCurrentThread("render");
+
   pthread_mutex_lock(&renderer->enqueue_lock);
   while (renderer->pendingBuffers.empty()) {
     if (renderer->stop_thread) {
@@ -560,6 +569,184 @@ NvDrmRenderer::renderThreadOrin(void *arg)
   return NULL;
 }
 
+static uint64_t
+get_time_usec()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void
+NvDrmRenderer::releaseBuffer(int fd)
+{
+  pthread_mutex_lock(&dequeue_lock);
+  freeBuffers.push(fd);
+  pthread_cond_signal(&dequeue_cond);
+  pthread_mutex_unlock(&dequeue_lock);
+}
+
+void NvDrmRenderer::mailbox_flip_handler(int drm_fd, unsigned int frame,
+                                         unsigned int sec, unsigned int usec, void *data)
+{
+  NvDrmRenderer *renderer = (NvDrmRenderer *) data;
+  int fd;
+
+  // The event time stamp is CLOCK_MONOTONIC, as is the time of the post.
+  fd = renderer->mailbox->endFlip((uint64_t) sec * 1000000 + usec);
+  if (fd != -1)
+    renderer->releaseBuffer(fd);
+}
+
+int
+NvDrmRenderer::flipMailbox()
+{
+  uint32_t fb;
+  int fd;
+  int ret;
+
+  fd = mailbox->beginFlip();
+  if (fd == -1)
+    return 0;
+
+  // The same buffers cycle through the mailbox, keep their FBs mapped
+  // until the renderer is destroyed.
+  auto map_entry = map_list.find (fd);
+  if (map_entry != map_list.end()) {
+    fb = (uint32_t) map_entry->second;
+  } else {
+    if (createFB(fd, &fb) < 0) {
+      mailbox->abortFlip();
+      releaseBuffer(fd);
+      return -1;
+    }
+    map_list.insert(std::make_pair(fd, fb));
+  }
+
+  ret = atomic_plane->flip(fb, width, height, width, height, this);
+  if (ret < 0) {
+    COMP_ERROR_MSG("Failed to commit flip: " << ret);
+    mailbox->abortFlip();
+    releaseBuffer(fd);
+    return -1;
+  }
+
+  profiler.finishProcessing(0, false);
+  return 0;
+}
+
+void *
+NvDrmRenderer::renderThreadMailbox(void *arg)
+{
+  NvDrmRenderer *renderer = (NvDrmRenderer *) arg;
+  NvDrmMailbox *mailbox = renderer->mailbox;
+  drmEventContext evctx;
+  struct pollfd fds;
+  int pending_fd, displayed_fd;
+  int ret;
+  int timeout = 500; // 500ms
+
+  NvThreadPolicy::getInstance().applyToCurrentThread("render");
+
+  memset(&fds, 0, sizeof(fds));
+  fds.fd = renderer->drm_fd;
+  fds.events = POLLIN;
+
+  memset(&evctx, 0, sizeof evctx);
+  evctx.version = DRM_EVENT_CONTEXT_VERSION;
+  evctx.page_flip_handler = mailbox_flip_handler;
+
+  while (!renderer->stop_thread) {
+    if (mailbox->flipInFlight()) {
+      ret = poll(&fds, 1, timeout);
+      if (ret > 0 && (fds.revents & POLLIN)) {
+        drmHandleEvent(renderer->drm_fd, &evctx);
+      } else if (ret < 0 && errno != EINTR) {
+        renderer->is_in_error = 1;
+        break;
+      }
+    } else if (renderer->mailbox_eos && !mailbox->hasPending()) {
+      // drmModeSetCrtc with a ZERO FD will walk through the path that
+      // disable the windows.
+      ret = drmModeSetCrtc(renderer->drm_fd, renderer->drm_crtc_id,
+              ZERO_FD, 0, 0, &renderer->drm_conn_id, 1, NULL);
+      if (ret)
+        std::cout << "Failed to disable windows before exiting" << std::endl;
+
+      // EOS buffer. Release the buffers held.
+      mailbox->drain(&pending_fd, &displayed_fd);
+      if (pending_fd != -1)
+        renderer->releaseBuffer(pending_fd);
+      if (displayed_fd != -1)
+        renderer->releaseBuffer(displayed_fd);
+
+      pthread_mutex_lock(&renderer->dequeue_lock);
+      renderer->stop_thread = true;
+      pthread_cond_broadcast(&renderer->dequeue_cond);
+      pthread_mutex_unlock(&renderer->dequeue_lock);
+      break;
+    } else if (mailbox->waitForFrame(timeout)) {
+      if (renderer->flipMailbox() < 0)
+        renderer->is_in_error = 1;
+    }
+  }
+  return NULL;
+}
+
+int
+NvDrmRenderer::setPresentMode(NvDrmPresentMode mode)
+{
+  if (mode == present_mode)
+    return 0;
+
+  pthread_mutex_lock(&enqueue_lock);
+  if (renderingStarted || !pendingBuffers.empty()) {
+    pthread_mutex_unlock(&enqueue_lock);
+    COMP_ERROR_MSG("Present mode must be set before the first buffer is enqueued");
+    return -1;
+  }
+  pthread_mutex_unlock(&enqueue_lock);
+
+  if (mode != NvDrmPresentMode_Mailbox) {
+    COMP_ERROR_MSG("Cannot switch back from the mailbox mode");
+    return -1;
+  }
+
+  atomic_plane = NvDrmAtomicPlane::create(drm_fd, drm_crtc_id);
+  if (!atomic_plane) {
+    COMP_WARN_MSG("No DRM atomic support, staying in FIFO mode");
+    return -1;
+  }
+
+  // Replace the FIFO render thread, which is still waiting for its first
+  // buffer.
+  pthread_mutex_lock(&enqueue_lock);
+  stop_thread = true;
+  pthread_cond_broadcast(&enqueue_cond);
+  pthread_mutex_unlock(&enqueue_lock);
+  pthread_join(render_thread, NULL);
+  stop_thread = false;
+
+  mailbox = new NvDrmMailbox();
+  present_mode = NvDrmPresentMode_Mailbox;
+  renderingStarted = true;
+
+  pthread_create(&render_thread, NULL, renderThreadMailbox, this);
+  pthread_setname_np(render_thread, "DrmRenderer");
+  return 0;
+}
+
+int
+NvDrmRenderer::getPresentStats(NvDrmPresentStats *stats)
+{
+  if (present_mode != NvDrmPresentMode_Mailbox)
+    return -1;
+
+  mailbox->getStats(stats);
+  return 0;
+}
+
 bool NvDrmRenderer::hdrSupported()
 {
     uint32_t i;
@@ -632,6 +819,8 @@ NvDrmRenderer::~NvDrmRenderer()
   pthread_mutex_lock(&enqueue_lock);
   pthread_cond_broadcast(&enqueue_cond);
   pthread_mutex_unlock(&enqueue_lock);
+  if (mailbox)
+    mailbox->wake();
   pthread_join(render_thread, NULL);
   pthread_mutex_destroy(&enqueue_lock);
   pthread_cond_destroy(&enqueue_cond);
@@ -653,6 +842,12 @@ NvDrmRenderer::~NvDrmRenderer()
   if(last_fb)
     drmModeRmFB(drm_fd, last_fb);
 
+  if (mailbox) {
+    mailbox->printStats(comp_name);
+    delete mailbox;
+    delete atomic_plane;
+  }
+
   if (hdrBlobCreated) {
       drmModeDestroyPropertyBlob(drm_fd, hdrBlobId);
       hdrBlobCreated = 0;
@@ -697,6 +892,20 @@ NvDrmRenderer::enqueBuffer(int fd)
   if (is_in_error)
     return ret;
 
+  if (present_mode == NvDrmPresentMode_Mailbox) {
+    if (fd == -1) {
+      // This is EOS; the render thread disables the windows once the
+      // flip in flight is done.
+      mailbox_eos = true;
+      mailbox->wake();
+      return 0;
+    }
+    tmpFd = mailbox->post(fd, get_time_usec());
+    if (tmpFd != -1)
+      releaseBuffer(tmpFd);
+    return 0;
+  }
+
   pthread_mutex_lock(&enqueue_lock);
   pendingBuffers.push(fd);
 
@@ -740,84 +949,105 @@ NvDrmRenderer::enqueBuffer(int fd)
 }
 
 int
-NvDrmRenderer::renderInternal(int fd)
+NvDrmRenderer::createFB(int fd, uint32_t *fb)
 {
   int ret;
   uint32_t i;
   uint32_t handle;
-  uint32_t fb;
   uint32_t bo_handles[4] = {0};
   uint32_t flags = 0;
-  bool frame_is_late = false;
 
   NvBufDrmParams dParams;
   struct drm_tegra_gem_set_tiling args;
-  auto map_entry = map_list.find (fd);
-  if (map_entry != map_list.end()) {
-    fb = (uint32_t) map_entry->second;
-  } else {
-    // Create a new FB.
-    NvBufSurface *nvbuf_surf = 0;
-    NvBufSurfaceFromFd(fd, (void**)(&nvbuf_surf));
-    if (nvbuf_surf == NULL) {
-      COMP_ERROR_MSG("NvBufSurfaceFromFd Failed ");
-      goto error;
-    }
+  NvBufSurface *nvbuf_surf = 0;
 
-    ret = NvBufGetDrmParams(nvbuf_surf, &dParams);
-    if (ret < 0) {
-      COMP_ERROR_MSG("Failed to convert to DRM params ");
+  NvBufSurfaceFromFd(fd, (void**)(&nvbuf_surf));
+  if (nvbuf_surf == NULL) {
+    COMP_ERROR_MSG("NvBufSurfaceFromFd Failed ");
+    return -1;
+  }
+
+  ret = NvBufGetDrmParams(nvbuf_surf, &dParams);
+  if (ret < 0) {
+    COMP_ERROR_MSG("Failed to convert to DRM params ");
+    return -1;
+  }
+
+  for (i = 0; i < dParams.num_planes; i++) {
+    ret = drmPrimeFDToHandle(drm_fd, fd, &handle);
+    if (ret)
+    {
+      COMP_ERROR_MSG("Failed to import buffer object. ");
       goto error;
     }
 
-   for (i = 0; i < dParams.num_planes; i++) {
-     ret = drmPrimeFDToHandle(drm_fd, fd, &handle);
-     if (ret)
-     {
-       COMP_ERROR_MSG("Failed to import buffer object. ");
-       goto error;
-     }
-
-     if (!is_nvidia_drm) {
-       memset(&args, 0, sizeof(args));
-       args.handle = handle;
-       args.mode = DRM_TEGRA_GEM_TILING_MODE_PITCH;
-       args.value = 1;
-
-       ret = drmIoctl(drm_fd, DRM_IOCTL_TEGRA_GEM_SET_TILING, &args);
-       if (ret < 0)
-       {
-         COMP_ERROR_MSG("Failed to set tiling parameters ");
-         goto error;
-       }
-     }
-     bo_handles[i] = handle;
-   }
-
-   if (is_nvidia_drm) {
-      static uint64_t modifiers[NVBUF_MAX_PLANES] = { 0 };
-      uint64_t hm = 0;
-      for (hm = 0; hm < dParams.num_planes; hm++) {
-        modifiers[hm] = DRM_FORMAT_MOD_LINEAR;
-        //modifiers[hm] = DRM_FORMAT_MOD_NVIDIA_BLOCK_LINEAR_2D(0, 1, 2, 0x06, 0x01);
-      }
-      if (drmModeAddFB2WithModifiers (drm_fd, width, height,
-              dParams.pixel_format, bo_handles, dParams.pitch, dParams.offset,
-              modifiers, &fb,
-              DRM_MODE_FB_MODIFIERS)) {
-        COMP_ERROR_MSG ("Failed to create frame buffer\n");
+    if (!is_nvidia_drm) {
+      memset(&args, 0, sizeof(args));
+      args.handle = handle;
+      args.mode = DRM_TEGRA_GEM_TILING_MODE_PITCH;
+      args.value = 1;
+
+      ret = drmIoctl(drm_fd, DRM_IOCTL_TEGRA_GEM_SET_TILING, &args);
+      if (ret < 0)
+      {
+        COMP_ERROR_MSG("Failed to set tiling parameters ");
         goto error;
       }
-   } else {
-     ret = drmModeAddFB2(drm_fd, width, height, dParams.pixel_format, bo_handles,
-                        dParams.pitch, dParams.offset, &fb, flags);
+    }
+    bo_handles[i] = handle;
+  }
 
+  if (is_nvidia_drm) {
+    static uint64_t modifiers[NVBUF_MAX_PLANES] = { 0 };
+    uint64_t hm = 0;
+    for (hm = 0; hm < dParams.num_planes; hm++) {
+      modifiers[hm] = DRM_FORMAT_MOD_LINEAR;
+      //modifiers[hm] = DRM_FORMAT_MOD_NVIDIA_BLOCK_LINEAR_2D(0, 1, 2, 0x06, 0x01);
+    }
+    if (drmModeAddFB2WithModifiers (drm_fd, width, height,
+            dParams.pixel_format, bo_handles, dParams.pitch, dParams.offset,
+            modifiers, fb,
+            DRM_MODE_FB_MODIFIERS)) {
+      COMP_ERROR_MSG ("Failed to create frame buffer\n");
+      goto error;
+    }
+  } else {
+    ret = drmModeAddFB2(drm_fd, width, height, dParams.pixel_format, bo_handles,
+                        dParams.pitch, dParams.offset, fb, flags);
     if (ret)
     {
       COMP_ERROR_MSG("Failed to create fb ");
       goto error;
     }
-   }
+  }
+
+  /* The framebuffer holds its own references to the buffer objects */
+  for (i = 0; i < dParams.num_planes; i++)
+    if (bo_handles[i])
+      drmUtilCloseGemBo(drm_fd, bo_handles[i]);
+  return 0;
+
+error:
+  for (i = 0; i < dParams.num_planes; i++)
+    if (bo_handles[i])
+      drmUtilCloseGemBo(drm_fd, bo_handles[i]);
+  return -1;
+}
+
+int
+NvDrmRenderer::renderInternal(int fd)
+{
+  int ret;
+  uint32_t fb;
+  bool frame_is_late = false;
+
+  auto map_entry = map_list.find (fd);
+  if (map_entry != map_list.end()) {
+    fb = (uint32_t) map_entry->second;
+  } else {
+    // Create a new FB.
+    if (createFB(fd, &fb) < 0)
+      goto error;
 
     ret = setPlane(0, fb, 0, 0, width, height, 0, 0, width << 16, height << 16);
     if(ret) {
@@ -884,11 +1114,6 @@ NvDrmRenderer::renderInternal(int fd)
    * We will do that once new FD for each frame from consumer is resolved.
    */
 
-  for (i = 0; i < dParams.num_planes; i++)
-  {
-    drmUtilCloseGemBo (drm_fd,bo_handles[i]);
-  }
-
    if(last_fb)
     drmModeRmFB(drm_fd, last_fb);
 
@@ -28,6 +28,7 @@
 
 #include "NvEglRenderer.h"
 #include "NvLogging.h"
+#include "NvThreadPolicy.h"
 #include "nvbufsurface.h"
 
 #include <cstring>
@@ -182,6 +183,8 @@ NvEglRenderer::renderThread(void *arg)
     NvEglRenderer *renderer = (NvEglRenderer *) arg;
     const char *comp_name = renderer->comp_name;
 
+    NvThreadPolicy::getInstance().applyToCurrentThread("render");
+
     static EGLint rgba8888[] = {
         EGL_RED_SIZE, 8,
         EGL_GREEN_SIZE, 8,
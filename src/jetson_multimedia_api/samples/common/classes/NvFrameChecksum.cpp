@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvFrameChecksum.h"
+#include "NvThreadPolicy.h"
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__aarch64__) && defined(__GNUC__) && !defined(__clang__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define CRC32C_HW_AARCH64
+#elif defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define CRC32C_HW_X86
+#endif
+
+using namespace std;
+
+typedef uint32_t (*crc32c_func)(uint32_t crc, const uint8_t *data, size_t len);
+
+/* Castagnoli polynomial, reflected. */
+#define CRC32C_POLY 0x82F63B78
+
+static uint32_t crc32c_table[8][256];
+
+static void
+crc32c_init_table(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (uint32_t j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+        crc32c_table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (uint32_t t = 1; t < 8; t++)
+            crc32c_table[t][i] = (crc32c_table[t - 1][i] >> 8) ^
+                crc32c_table[0][crc32c_table[t - 1][i] & 0xff];
+    }
+}
+
+/* Slice-by-8 fallback, processes eight bytes per table round. */
+static uint32_t
+crc32c_sw(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len && ((uintptr_t) data & 7))
+    {
+        crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *data++) & 0xff];
+        len--;
+    }
+    while (len >= 8)
+    {
+        uint32_t lo, hi;
+        memcpy(&lo, data, 4);
+        memcpy(&hi, data + 4, 4);
+        lo ^= crc;
+        crc = crc32c_table[7][lo & 0xff] ^
+              crc32c_table[6][(lo >> 8) & 0xff] ^
+              crc32c_table[5][(lo >> 16) & 0xff] ^
+              crc32c_table[4][lo >> 24] ^
+              crc32c_table[3][hi & 0xff] ^
+              crc32c_table[2][(hi >> 8) & 0xff] ^
+              crc32c_table[1][(hi >> 16) & 0xff] ^
+              crc32c_table[0][hi >> 24];
+        data += 8;
+        len -= 8;
+    }
+    while (len--)
+        crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *data++) & 0xff];
+    return crc;
+}
+
+#if defined(CRC32C_HW_AARCH64)
+__attribute__((target("+crc")))
+static uint32_t
+crc32c_hw(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len && ((uintptr_t) data & 7))
+    {
+        crc = __builtin_aarch64_crc32cb(crc, *data++);
+        len--;
+    }
+    while (len >= 8)
+    {
+        uint64_t value;
+        memcpy(&value, data, 8);
+        crc = __builtin_aarch64_crc32cx(crc, value);
+        data += 8;
+        len -= 8;
+    }
+    while (len--)
+        crc = __builtin_aarch64_crc32cb(crc, *data++);
+    return crc;
+}
+
+static bool
+crc32c_hw_supported(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+}
+#elif defined(CRC32C_HW_X86)
+__attribute__((target("sse4.2")))
+static uint32_t
+crc32c_hw(uint32_t crc, const uint8_t *data, size_t len)
+{
+    uint64_t crc64 = crc;
+    while (len && ((uintptr_t) data & 7))
+    {
+        crc64 = _mm_crc32_u8((uint32_t) crc64, *data++);
+        len--;
+    }
+    while (len >= 8)
+    {
+        uint64_t value;
+        memcpy(&value, data, 8);
+        crc64 = _mm_crc32_u64(crc64, value);
+        data += 8;
+        len -= 8;
+    }
+    while (len--)
+        crc64 = _mm_crc32_u8((uint32_t) crc64, *data++);
+    return (uint32_t) crc64;
+}
+
+static bool
+crc32c_hw_supported(void)
+{
+    return __builtin_cpu_supports("sse4.2");
+}
+#endif
+
+static crc32c_func
+crc32c_select(void)
+{
+#if defined(CRC32C_HW_AARCH64) || defined(CRC32C_HW_X86)
+    if (crc32c_hw_supported())
+        return crc32c_hw;
+#endif
+    crc32c_init_table();
+    return crc32c_sw;
+}
+
+uint32_t
+NvFrameChecksum::crc32c(uint32_t crc, const void *data, size_t len)
+{
+    static const crc32c_func update = crc32c_select();
+
+    return ~update(~crc, (const uint8_t *) data, len);
+}
+
+uint32_t
+NvFrameChecksum::hashPlane(const uint8_t *data, uint32_t row_bytes,
+                           uint32_t height, uint32_t pitch)
+{
+    uint32_t crc = 0;
+
+    /* Chain the rows so that the result equals the CRC of the packed plane. */
+    for (uint32_t i = 0; i < height; i++)
+        crc = crc32c(crc, data + (size_t) i * pitch, row_bytes);
+    return crc;
+}
+
+string
+NvFrameChecksum::formatEntry(const NvFrameChecksumEntry &entry)
+{
+    char line[32 + NV_FRAME_CHECKSUM_MAX_PLANES * 9];
+    int len;
+
+    len = snprintf(line, sizeof(line), "%llu", (unsigned long long) entry.frame);
+    for (uint32_t i = 0; i < entry.num_planes && i < NV_FRAME_CHECKSUM_MAX_PLANES; i++)
+        len += snprintf(line + len, sizeof(line) - len, " %08x", entry.crc[i]);
+    return string(line, len);
+}
+
+bool
+NvFrameChecksum::parseEntry(const string &line, NvFrameChecksumEntry &entry)
+{
+    const char *pos = line.c_str();
+    char *end;
+
+    while (*pos == ' ' || *pos == '\t')
+        pos++;
+    if (*pos == '\0' || *pos == '#' || *pos == '\r')
+        return false;
+
+    entry.frame = strtoull(pos, &end, 10);
+    if (end == pos)
+        return false;
+
+    entry.num_planes = 0;
+    pos = end;
+    while (entry.num_planes < NV_FRAME_CHECKSUM_MAX_PLANES)
+    {
+        unsigned long crc = strtoul(pos, &end, 16);
+        if (end == pos)
+            break;
+        entry.crc[entry.num_planes++] = crc;
+        pos = end;
+    }
+    return entry.num_planes > 0;
+}
+
+NvFrameChecksum::NvFrameChecksum(const NvFrameChecksumOps &ops)
+    : ops(ops)
+    , running(false)
+    , stop(false)
+    , busy(0)
+    , output(NULL)
+    , has_golden(false)
+    , frame_count(0)
+    , mismatch_count(0)
+{
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+NvFrameChecksum::~NvFrameChecksum()
+{
+    if (running || output)
+        close();
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&cond);
+}
+
+int
+NvFrameChecksum::open(const char *output_path, const char *golden_path)
+{
+    if (output_path)
+    {
+        output = new ofstream(output_path);
+        if (!output->is_open())
+        {
+            cerr << "Error opening checksum file " << output_path << endl;
+            delete output;
+            output = NULL;
+            return -1;
+        }
+        *output << "# frame crc32c(plane 0) crc32c(plane 1) ..." << endl;
+    }
+
+    if (golden_path)
+    {
+        ifstream golden_file(golden_path);
+        string line;
+        NvFrameChecksumEntry entry;
+
+        if (!golden_file.is_open())
+        {
+            cerr << "Error opening golden checksum file " << golden_path << endl;
+            return -1;
+        }
+        while (getline(golden_file, line))
+        {
+            if (!parseEntry(line, entry))
+                continue;
+            if (entry.frame != golden.size())
+            {
+                cerr << "Golden checksum file " << golden_path <<
+                    " is not in frame order at frame " << entry.frame << endl;
+                return -1;
+            }
+            golden.push_back(entry);
+        }
+        has_golden = true;
+    }
+
+    stop = false;
+    if (pthread_create(&worker, NULL, workerThread, this) != 0)
+    {
+        cerr << "Error creating checksum thread" << endl;
+        return -1;
+    }
+    pthread_setname_np(worker, "FrameChecksum");
+    running = true;
+
+    return 0;
+}
+
+int
+NvFrameChecksum::close()
+{
+    uint64_t missing = 0;
+
+    if (running)
+    {
+        pthread_mutex_lock(&lock);
+        stop = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+        pthread_join(worker, NULL);
+        running = false;
+    }
+    clearBuffers();
+
+    if (output)
+    {
+        output->close();
+        delete output;
+        output = NULL;
+    }
+
+    cout << "Frame checksum: " << frame_count << " frames";
+    if (has_golden)
+    {
+        if (frame_count < golden.size())
+            missing = golden.size() - frame_count;
+        cout << ", " << mismatch_count << " mismatches, " << missing <<
+            " golden frames not produced";
+    }
+    cout << endl;
+
+    return (mismatch_count || missing) ? -1 : 0;
+}
+
+void
+NvFrameChecksum::addBuffer(int dmabuf_fd)
+{
+    pthread_mutex_lock(&lock);
+    free_buffers.push_back(dmabuf_fd);
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvFrameChecksum::clearBuffers()
+{
+    waitIdle();
+
+    pthread_mutex_lock(&lock);
+    for (size_t i = 0; i < free_buffers.size(); i++)
+    {
+        if (ops.unmap)
+            ops.unmap(free_buffers[i], ops.arg);
+    }
+    free_buffers.clear();
+    pthread_mutex_unlock(&lock);
+}
+
+int
+NvFrameChecksum::getBuffer()
+{
+    int fd;
+
+    pthread_mutex_lock(&lock);
+    while (free_buffers.empty() && (!jobs.empty() || busy))
+        pthread_cond_wait(&cond, &lock);
+    if (free_buffers.empty())
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+    fd = free_buffers.back();
+    free_buffers.pop_back();
+    pthread_mutex_unlock(&lock);
+
+    return fd;
+}
+
+int
+NvFrameChecksum::queueBuffer(int dmabuf_fd, uint32_t num_planes)
+{
+    Job job;
+
+    if (!running || num_planes == 0 || num_planes > NV_FRAME_CHECKSUM_MAX_PLANES)
+        return -1;
+
+    job.fd = dmabuf_fd;
+    job.num_planes = num_planes;
+
+    pthread_mutex_lock(&lock);
+    jobs.push(job);
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+
+    return 0;
+}
+
+void
+NvFrameChecksum::waitIdle()
+{
+    pthread_mutex_lock(&lock);
+    while (!jobs.empty() || busy)
+        pthread_cond_wait(&cond, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+int
+NvFrameChecksum::processFrame(const uint8_t * const *planes, const uint32_t *row_bytes,
+                              const uint32_t *height, const uint32_t *pitch,
+                              uint32_t num_planes, NvFrameChecksumEntry *entry)
+{
+    NvFrameChecksumEntry frame_entry;
+    int ret;
+
+    if (num_planes == 0 || num_planes > NV_FRAME_CHECKSUM_MAX_PLANES)
+        return -1;
+
+    frame_entry.num_planes = num_planes;
+    for (uint32_t i = 0; i < num_planes; i++)
+        frame_entry.crc[i] = hashPlane(planes[i], row_bytes[i], height[i], pitch[i]);
+
+    ret = checkEntry(frame_entry);
+    if (entry)
+        *entry = frame_entry;
+    return ret;
+}
+
+uint64_t
+NvFrameChecksum::getFrameCount()
+{
+    uint64_t count;
+
+    pthread_mutex_lock(&lock);
+    count = frame_count;
+    pthread_mutex_unlock(&lock);
+    return count;
+}
+
+uint64_t
+NvFrameChecksum::getMismatchCount()
+{
+    uint64_t count;
+
+    pthread_mutex_lock(&lock);
+    count = mismatch_count;
+    pthread_mutex_unlock(&lock);
+    return count;
+}
+
+int
+NvFrameChecksum::checkEntry(NvFrameChecksumEntry &entry)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&lock);
+    entry.frame = frame_count++;
+
+    if (output)
+        *output << formatEntry(entry) << '\n';
+
+    if (has_golden)
+    {
+        if (entry.frame >= golden.size())
+        {
+            ret = -1;
+            if (mismatch_count < MaxReportedMismatches)
+                cerr << "Frame " << entry.frame << ": no golden checksum" << endl;
+        }
+        else
+        {
+            const NvFrameChecksumEntry &expected = golden[entry.frame];
+            if (expected.num_planes != entry.num_planes ||
+                memcmp(expected.crc, entry.crc, entry.num_planes * sizeof(entry.crc[0])))
+            {
+                ret = -1;
+                if (mismatch_count < MaxReportedMismatches)
+                    cerr << "Frame " << entry.frame << ": checksum mismatch, got " <<
+                        formatEntry(entry) << ", expected " << formatEntry(expected) << endl;
+            }
+        }
+        if (ret < 0)
+            mismatch_count++;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return ret;
+}
+
+int
+NvFrameChecksum::hashBuffer(int dmabuf_fd, uint32_t num_planes)
+{
+    NvFrameChecksumPlanes planes;
+    NvFrameChecksumEntry entry;
+
+    if (ops.map(dmabuf_fd, &planes, ops.arg) != 0)
+    {
+        cerr << "Error mapping checksum buffer " << dmabuf_fd << endl;
+        return -1;
+    }
+    if (num_planes > planes.num_planes)
+        num_planes = planes.num_planes;
+
+    entry.num_planes = num_planes;
+    for (uint32_t i = 0; i < num_planes; i++)
+        entry.crc[i] = hashPlane(planes.data[i], planes.row_bytes[i],
+                                 planes.height[i], planes.pitch[i]);
+
+    return checkEntry(entry);
+}
+
+void *
+NvFrameChecksum::workerThread(void *arg)
+{
+    NvFrameChecksum *checksum = (NvFrameChecksum *) arg;
+    Job job;
+
+    NvThreadPolicy::getInstance().applyToCurrentThread("checksum");
+
+    pthread_mutex_lock(&checksum->lock);
+    while (true)
+    {
+        while (checksum->jobs.empty() && !checksum->stop)
+            pthread_cond_wait(&checksum->cond, &checksum->lock);
+        if (checksum->jobs.empty())
+            break;
+
+        job = checksum->jobs.front();
+        checksum->jobs.pop();
+        checksum->busy++;
+        pthread_mutex_unlock(&checksum->lock);
+
+        checksum->hashBuffer(job.fd, job.num_planes);
+
+        pthread_mutex_lock(&checksum->lock);
+        checksum->busy--;
+        checksum->free_buffers.push_back(job.fd);
+        pthread_cond_broadcast(&checksum->cond);
+    }
+    pthread_mutex_unlock(&checksum->lock);
+
+    return NULL;
+}
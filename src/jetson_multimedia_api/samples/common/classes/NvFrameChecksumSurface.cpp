@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvFrameChecksum.h"
+#include "nvbufsurface.h"
+
+/* Kept apart from NvFrameChecksum.cpp, so that the checksum core builds
+ * without libnvbufsurface. */
+
+static int
+surface_map(int fd, NvFrameChecksumPlanes *planes, void *arg)
+{
+    NvBufSurface *nvbuf_surf = 0;
+    NvBufSurfaceParams *surf;
+
+    if (NvBufSurfaceFromFd(fd, (void**)(&nvbuf_surf)) != 0)
+        return -1;
+    surf = &nvbuf_surf->surfaceList[0];
+
+    /* Pool buffers stay mapped until clearBuffers(). */
+    if (!surf->mappedAddr.addr[0] &&
+        NvBufSurfaceMap(nvbuf_surf, 0, -1, NVBUF_MAP_READ) != 0)
+        return -1;
+    NvBufSurfaceSyncForCpu(nvbuf_surf, 0, -1);
+
+    planes->num_planes = surf->planeParams.num_planes;
+    if (planes->num_planes > NV_FRAME_CHECKSUM_MAX_PLANES)
+        planes->num_planes = NV_FRAME_CHECKSUM_MAX_PLANES;
+    for (uint32_t i = 0; i < planes->num_planes; i++)
+    {
+        planes->data[i] = (const uint8_t *) surf->mappedAddr.addr[i];
+        planes->row_bytes[i] = surf->planeParams.width[i] *
+            surf->planeParams.bytesPerPix[i];
+        planes->height[i] = surf->planeParams.height[i];
+        planes->pitch[i] = surf->planeParams.pitch[i];
+    }
+    return 0;
+}
+
+static void
+surface_unmap(int fd, void *arg)
+{
+    NvBufSurface *nvbuf_surf = 0;
+
+    if (NvBufSurfaceFromFd(fd, (void**)(&nvbuf_surf)) == 0 &&
+        nvbuf_surf->surfaceList[0].mappedAddr.addr[0])
+        NvBufSurfaceUnMap(nvbuf_surf, 0, -1);
+}
+
+NvFrameChecksumOps
+NvFrameChecksum::getSurfaceOps()
+{
+    NvFrameChecksumOps ops;
+
+    ops.map = surface_map;
+    ops.unmap = surface_unmap;
+    ops.arg = NULL;
+    return ops;
+}
@@ -27,7 +27,836 @@
  */
 
 #include "NvLogging.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
 
 int log_level = DEFAULT_LOG_LEVEL;
+int log_backend = LOG_BACKEND_SYNC;
+int log_component_max_level = -1;
 
-const char *log_level_name[] = {"INFO", "ERROR", "WARN", "DEBUG"};
\ No newline at end of file
+const char *log_level_name[] = {"INFO", "ERROR", "WARN", "DEBUG"};
+
+/* Number of records in each per-thread ring, must be a power of 2. */
+#define NVLOG_RING_SIZE 1024
+#define NVLOG_RECORD_SIZE 256
+
+#define NVLOG_BINARY_MAGIC "NVLOGBIN"
+#define NVLOG_BINARY_VERSION 2
+#define NVLOG_BINARY_SITE 1
+#define NVLOG_BINARY_MSG 2
+
+using namespace std;
+
+/**
+ * Holds one log message recorded by the asynchronous backends. The payload
+ * holds the arguments recorded by NvLogArgs, not yet formatted.
+ */
+struct NvLogRecord
+{
+    uint64_t timestamp_ns;
+    const NvLogSite *site;
+    uint32_t tid;
+    uint32_t suppressed;
+    uint16_t length;
+    uint8_t level;
+    uint8_t truncated;
+    char payload[NVLOG_RECORD_SIZE - 28];
+};
+
+/**
+ * Single-producer single-consumer ring of records. The producer is the
+ * owning thread; the consumer is whichever thread holds drain_lock.
+ *
+ * @c busy is set by the producer between NvLogBegin() and NvLogCommit(),
+ * so that NvLogSetBackend() can wait for the messages being recorded
+ * before stopping the writer. Messages begun while the backend switches
+ * are recorded into @c sync_record and written synchronously instead.
+ */
+struct NvLogRing
+{
+    NvLogRecord records[NVLOG_RING_SIZE];
+    NvLogRecord sync_record;
+    atomic<uint32_t> head;
+    atomic<uint32_t> tail;
+    atomic<bool> retired;
+    atomic<bool> busy;
+    uint32_t tid;
+    NvLogArgs args;
+    NvLogRecord *pending;
+
+    NvLogRing()
+        : head(0), tail(0), retired(false), busy(false), pending(NULL)
+    {
+        tid = syscall(SYS_gettid);
+    }
+};
+
+/**
+ * Retires the ring of a thread when the thread exits. The ring is freed
+ * by the writer once drained.
+ */
+struct NvLogRingHolder
+{
+    NvLogRing *ring;
+    ~NvLogRingHolder()
+    {
+        if (ring)
+            ring->retired.store(true, memory_order_release);
+    }
+};
+
+static thread_local NvLogRingHolder tls_ring;
+
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static vector<NvLogRing *> rings;
+
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *log_file = NULL;
+static bool log_file_binary = false;
+static map<const NvLogSite *, uint32_t> site_ids;
+
+static pthread_mutex_t backend_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t writer_thread;
+static atomic<bool> writer_running(false);
+/* Cleared by NvLogSetBackend() before the writer is stopped. */
+static atomic<bool> async_accepting(false);
+
+/* The writer sleeps on wake_cond while all the rings are empty. */
+static pthread_mutex_t wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond = PTHREAD_COND_INITIALIZER;
+static atomic<bool> writer_sleeping(false);
+
+static atomic<uint64_t> dropped_count(0);
+static uint32_t rate_limit = 0;
+
+static pthread_mutex_t comp_lock = PTHREAD_MUTEX_INITIALIZER;
+static map<string, int> comp_levels;
+/* Incremented under comp_lock whenever a component level changes. */
+static atomic<uint32_t> comp_generation(1);
+
+static inline uint64_t
+monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int
+NvLogGetComponentLevel(const char *comp)
+{
+    /* Each thread keeps a copy of the levels set, refreshed whenever a
+     * level changes. Names are compared by content: components may share
+     * a name without sharing the string, and a string may be freed and its
+     * address reused by another component. */
+    static thread_local uint32_t cache_generation = 0;
+    static thread_local vector<pair<string, int> > cache;
+
+    if (cache_generation != comp_generation.load(memory_order_acquire))
+    {
+        pthread_mutex_lock(&comp_lock);
+        cache.assign(comp_levels.begin(), comp_levels.end());
+        cache_generation = comp_generation.load(memory_order_relaxed);
+        pthread_mutex_unlock(&comp_lock);
+    }
+
+    for (size_t i = 0; i < cache.size(); i++)
+    {
+        if (!strcmp(cache[i].first.c_str(), comp))
+            return cache[i].second;
+    }
+    return log_level;
+}
+
+void
+NvLogSetComponentLevel(const char *comp, int level)
+{
+    int max_level = -1;
+
+    pthread_mutex_lock(&comp_lock);
+    if (level < 0)
+        comp_levels.erase(comp);
+    else
+        comp_levels[comp] = level;
+    for (map<string, int>::iterator it = comp_levels.begin();
+            it != comp_levels.end(); ++it)
+    {
+        max_level = max(max_level, it->second);
+    }
+    log_component_max_level = max_level;
+    comp_generation.fetch_add(1, memory_order_release);
+    pthread_mutex_unlock(&comp_lock);
+}
+
+void
+NvLogSetRateLimit(uint32_t msgs_per_sec)
+{
+    rate_limit = msgs_per_sec;
+}
+
+uint64_t
+NvLogGetDroppedCount()
+{
+    return dropped_count.load(memory_order_relaxed);
+}
+
+static void write_sync(const NvLogRecord &rec);
+
+NvLogArgs *
+NvLogBegin(NvLogSite *site, int level)
+{
+    NvLogRing *ring = tls_ring.ring;
+    uint64_t now = monotonic_ns();
+    uint32_t head, tail;
+    NvLogRecord *rec;
+
+    if (rate_limit)
+    {
+        uint32_t window = now / 1000000000ULL;
+        if (__atomic_load_n(&site->rate_window, __ATOMIC_RELAXED) != window)
+        {
+            __atomic_store_n(&site->rate_window, window, __ATOMIC_RELAXED);
+            __atomic_store_n(&site->rate_count, 0, __ATOMIC_RELAXED);
+        }
+        if (__atomic_add_fetch(&site->rate_count, 1, __ATOMIC_RELAXED) > rate_limit)
+        {
+            __atomic_add_fetch(&site->suppressed, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+    }
+
+    if (!ring)
+    {
+        ring = new NvLogRing();
+        pthread_mutex_lock(&rings_lock);
+        rings.push_back(ring);
+        pthread_mutex_unlock(&rings_lock);
+        tls_ring.ring = ring;
+    }
+
+    /* Pairs with NvLogSetBackend(): either the backend switch sees the
+     * ring busy and waits for the commit, or this thread sees the writer
+     * stopping and logs synchronously. */
+    ring->busy.store(true, memory_order_seq_cst);
+    if (async_accepting.load(memory_order_seq_cst))
+    {
+        head = ring->head.load(memory_order_relaxed);
+        tail = ring->tail.load(memory_order_acquire);
+        if (head - tail >= NVLOG_RING_SIZE)
+        {
+            /* Never block the logging thread; count the message as dropped. */
+            ring->busy.store(false, memory_order_release);
+            dropped_count.fetch_add(1, memory_order_relaxed);
+            return NULL;
+        }
+        rec = &ring->records[head & (NVLOG_RING_SIZE - 1)];
+    }
+    else
+    {
+        ring->busy.store(false, memory_order_release);
+        rec = &ring->sync_record;
+    }
+
+    rec->timestamp_ns = now;
+    rec->site = site;
+    rec->tid = ring->tid;
+    rec->level = level;
+    rec->suppressed = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED);
+
+    ring->args.reset(rec->payload, sizeof(rec->payload));
+    ring->pending = rec;
+
+    return &ring->args;
+}
+
+void
+NvLogCommit()
+{
+    NvLogRing *ring = tls_ring.ring;
+    NvLogRecord *rec = ring->pending;
+
+    rec->length = ring->args.length();
+    rec->truncated = ring->args.isTruncated();
+    ring->pending = NULL;
+    if (rec == &ring->sync_record)
+    {
+        write_sync(*rec);
+        return;
+    }
+
+    /* Pairs with writer_thread_func(): either the writer sees the new
+     * record before sleeping, or this thread sees it sleeping. */
+    ring->head.store(ring->head.load(memory_order_relaxed) + 1,
+            memory_order_seq_cst);
+    ring->busy.store(false, memory_order_release);
+    if (writer_sleeping.load(memory_order_seq_cst) &&
+            writer_sleeping.exchange(false, memory_order_seq_cst))
+    {
+        pthread_mutex_lock(&wake_lock);
+        pthread_cond_signal(&wake_cond);
+        pthread_mutex_unlock(&wake_lock);
+    }
+}
+
+/**
+ * Formats the arguments recorded by NvLogArgs.
+ *
+ * @return false if the payload is malformed.
+ */
+static bool
+format_args(ostream &ostr, const char *payload, uint32_t length)
+{
+    const char *pos = payload;
+    const char *end = payload + length;
+
+    ostr.flags(ios_base::dec | ios_base::skipws);
+    while (pos < end)
+    {
+        uint8_t tag = *pos++;
+        uint8_t size = 0;
+
+        if ((tag == NVLOG_ARG_SIGNED || tag == NVLOG_ARG_UNSIGNED) && pos < end)
+            size = *pos++;
+
+        switch (tag)
+        {
+            case NVLOG_ARG_SIGNED:
+            case NVLOG_ARG_UNSIGNED:
+            {
+                uint64_t raw = 0;
+                if ((size != 2 && size != 4 && size != 8) || end - pos < size)
+                    return false;
+                memcpy(&raw, pos, size);
+                pos += size;
+                /* Stream the original width so that hex output matches. */
+                if (tag == NVLOG_ARG_SIGNED && size == 2)
+                    ostr << (int16_t) raw;
+                else if (tag == NVLOG_ARG_SIGNED && size == 4)
+                    ostr << (int32_t) raw;
+                else if (tag == NVLOG_ARG_SIGNED)
+                    ostr << (int64_t) raw;
+                else if (size == 2)
+                    ostr << (uint16_t) raw;
+                else if (size == 4)
+                    ostr << (uint32_t) raw;
+                else
+                    ostr << raw;
+                break;
+            }
+            case NVLOG_ARG_CHAR:
+                if (end - pos < 1)
+                    return false;
+                ostr << *pos++;
+                break;
+            case NVLOG_ARG_BOOL:
+                if (end - pos < 1)
+                    return false;
+                ostr << (bool) *pos++;
+                break;
+            case NVLOG_ARG_DOUBLE:
+            {
+                double value;
+                if (end - pos < (ptrdiff_t) sizeof(value))
+                    return false;
+                memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                ostr << value;
+                break;
+            }
+            case NVLOG_ARG_POINTER:
+            {
+                uint64_t value;
+                if (end - pos < (ptrdiff_t) sizeof(value))
+                    return false;
+                memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                ostr << (const void *) (uintptr_t) value;
+                break;
+            }
+            case NVLOG_ARG_STRING:
+            {
+                uint16_t len;
+                if (end - pos < (ptrdiff_t) sizeof(len))
+                    return false;
+                memcpy(&len, pos, sizeof(len));
+                pos += sizeof(len);
+                if (end - pos < len)
+                    return false;
+                ostr.write(pos, len);
+                pos += len;
+                break;
+            }
+            case NVLOG_ARG_MANIP:
+                if (end - pos < 1)
+                    return false;
+                switch (*pos++)
+                {
+                    case NVLOG_MANIP_DEC:
+                        ostr << dec;
+                        break;
+                    case NVLOG_MANIP_HEX:
+                        ostr << hex;
+                        break;
+                    case NVLOG_MANIP_OCT:
+                        ostr << oct;
+                        break;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+static void
+write_text(FILE *fp, uint64_t timestamp_ns, uint32_t tid, int level,
+        const char *file, int line, const char *payload, uint32_t length,
+        bool truncated, uint32_t suppressed)
+{
+    fprintf(fp, "%llu.%09llu [%u] [%s] (%s:%d) %.*s%s",
+            (unsigned long long) (timestamp_ns / 1000000000ULL),
+            (unsigned long long) (timestamp_ns % 1000000000ULL), tid,
+            (level >= LOG_LEVEL_INFO && level <= LOG_LEVEL_DEBUG) ?
+                log_level_name[level] : "?",
+            file, line, (int) length, payload, truncated ? "..." : "");
+    if (suppressed)
+        fprintf(fp, " (%u messages suppressed)", suppressed);
+    fputc('\n', fp);
+}
+
+/**
+ * Writes a message the way the synchronous backend does.
+ */
+static void
+write_sync(const NvLogRecord &rec)
+{
+    ostringstream ostr;
+    bool ok;
+
+    ostr << "[" << log_level_name[rec.level] << "] (" << rec.site->file <<
+        ":" << rec.site->line << ") ";
+    ok = format_args(ostr, rec.payload, rec.length);
+    if (rec.truncated || !ok)
+        ostr << "...";
+    if (rec.suppressed)
+        ostr << " (" << rec.suppressed << " messages suppressed)";
+    ostr << endl;
+    cerr << ostr.str();
+}
+
+static void
+write_binary(FILE *fp, const NvLogRecord &rec)
+{
+    map<const NvLogSite *, uint32_t>::iterator it = site_ids.find(rec.site);
+    uint32_t site_id;
+
+    if (it == site_ids.end())
+    {
+        uint8_t type = NVLOG_BINARY_SITE;
+        uint16_t file_len = strlen(rec.site->file);
+        uint32_t line = rec.site->line;
+
+        site_id = site_ids.size() + 1;
+        site_ids[rec.site] = site_id;
+
+        fwrite(&type, sizeof(type), 1, fp);
+        fwrite(&file_len, sizeof(file_len), 1, fp);
+        fwrite(&site_id, sizeof(site_id), 1, fp);
+        fwrite(&line, sizeof(line), 1, fp);
+        fwrite(rec.site->file, file_len, 1, fp);
+    }
+    else
+    {
+        site_id = it->second;
+    }
+
+    uint8_t type = NVLOG_BINARY_MSG;
+    fwrite(&type, sizeof(type), 1, fp);
+    fwrite(&rec.level, sizeof(rec.level), 1, fp);
+    fwrite(&rec.truncated, sizeof(rec.truncated), 1, fp);
+    fwrite(&rec.length, sizeof(rec.length), 1, fp);
+    fwrite(&site_id, sizeof(site_id), 1, fp);
+    fwrite(&rec.tid, sizeof(rec.tid), 1, fp);
+    fwrite(&rec.suppressed, sizeof(rec.suppressed), 1, fp);
+    fwrite(&rec.timestamp_ns, sizeof(rec.timestamp_ns), 1, fp);
+    fwrite(rec.payload, rec.length, 1, fp);
+}
+
+static bool
+compare_records(const NvLogRecord &a, const NvLogRecord &b)
+{
+    return a.timestamp_ns < b.timestamp_ns;
+}
+
+/**
+ * Drains all rings, writes the records in timestamp order and frees the
+ * rings of exited threads. Must be called with drain_lock held.
+ */
+static void
+drain_rings()
+{
+    vector<NvLogRing *> cur_rings;
+    vector<NvLogRing *> retired_rings;
+    vector<NvLogRecord> batch;
+    ostringstream text;
+    FILE *fp = log_file ? log_file : stderr;
+
+    pthread_mutex_lock(&rings_lock);
+    cur_rings = rings;
+    pthread_mutex_unlock(&rings_lock);
+
+    for (size_t i = 0; i < cur_rings.size(); i++)
+    {
+        NvLogRing *ring = cur_rings[i];
+        bool retired = ring->retired.load(memory_order_acquire);
+        uint32_t head = ring->head.load(memory_order_acquire);
+        uint32_t tail = ring->tail.load(memory_order_relaxed);
+
+        for (; tail != head; tail++)
+            batch.push_back(ring->records[tail & (NVLOG_RING_SIZE - 1)]);
+        ring->tail.store(tail, memory_order_release);
+
+        if (retired)
+            retired_rings.push_back(ring);
+    }
+
+    /* The messages are formatted here, off the logging threads. */
+    stable_sort(batch.begin(), batch.end(), compare_records);
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        const NvLogRecord &rec = batch[i];
+        if (log_file_binary)
+        {
+            write_binary(fp, rec);
+        }
+        else
+        {
+            bool ok;
+            string msg;
+            text.str("");
+            ok = format_args(text, rec.payload, rec.length);
+            msg = text.str();
+            write_text(fp, rec.timestamp_ns, rec.tid, rec.level,
+                    rec.site->file, rec.site->line, msg.data(), msg.size(),
+                    rec.truncated || !ok, rec.suppressed);
+        }
+    }
+    if (!batch.empty())
+        fflush(fp);
+
+    if (!retired_rings.empty())
+    {
+        pthread_mutex_lock(&rings_lock);
+        for (size_t i = 0; i < retired_rings.size(); i++)
+        {
+            rings.erase(find(rings.begin(), rings.end(), retired_rings[i]));
+            delete retired_rings[i];
+        }
+        pthread_mutex_unlock(&rings_lock);
+    }
+}
+
+static bool
+rings_empty()
+{
+    bool empty = true;
+
+    pthread_mutex_lock(&rings_lock);
+    for (size_t i = 0; i < rings.size() && empty; i++)
+    {
+        empty = rings[i]->head.load(memory_order_seq_cst) ==
+            rings[i]->tail.load(memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&rings_lock);
+    return empty;
+}
+
+static void *
+writer_thread_func(void *arg)
+{
+    while (writer_running.load(memory_order_acquire))
+    {
+        pthread_mutex_lock(&drain_lock);
+        drain_rings();
+        pthread_mutex_unlock(&drain_lock);
+
+        /* Sleep until a producer commits a record. The first producer to
+         * see the writer sleeping clears the flag and signals. */
+        pthread_mutex_lock(&wake_lock);
+        while (writer_running.load(memory_order_acquire))
+        {
+            writer_sleeping.store(true, memory_order_seq_cst);
+            if (!rings_empty())
+                break;
+            pthread_cond_wait(&wake_cond, &wake_lock);
+        }
+        writer_sleeping.store(false, memory_order_relaxed);
+        pthread_mutex_unlock(&wake_lock);
+    }
+    return NULL;
+}
+
+void
+NvLogFlush()
+{
+    if (!writer_running.load(memory_order_acquire))
+        return;
+    pthread_mutex_lock(&drain_lock);
+    drain_rings();
+    pthread_mutex_unlock(&drain_lock);
+}
+
+int
+NvLogSetBackend(int backend, const char *file_path)
+{
+    int ret = 0;
+
+    if (backend < LOG_BACKEND_SYNC || backend > LOG_BACKEND_BINARY ||
+            (backend == LOG_BACKEND_BINARY && !file_path))
+    {
+        cerr << "Invalid logging backend " << backend << endl;
+        return -1;
+    }
+
+    pthread_mutex_lock(&backend_lock);
+
+    if (writer_running.load(memory_order_acquire))
+    {
+        __atomic_store_n(&log_backend, LOG_BACKEND_SYNC, __ATOMIC_RELAXED);
+        async_accepting.store(false, memory_order_seq_cst);
+
+        /* Wait for the messages being recorded; rings_lock keeps the
+         * writer from freeing the rings meanwhile. */
+        pthread_mutex_lock(&rings_lock);
+        for (size_t i = 0; i < rings.size(); i++)
+        {
+            while (rings[i]->busy.load(memory_order_seq_cst))
+                sched_yield();
+        }
+        pthread_mutex_unlock(&rings_lock);
+
+        pthread_mutex_lock(&wake_lock);
+        writer_running.store(false, memory_order_release);
+        pthread_cond_signal(&wake_cond);
+        pthread_mutex_unlock(&wake_lock);
+        pthread_join(writer_thread, NULL);
+
+        pthread_mutex_lock(&drain_lock);
+        drain_rings();
+        if (log_file)
+            fclose(log_file);
+        log_file = NULL;
+        site_ids.clear();
+        pthread_mutex_unlock(&drain_lock);
+    }
+
+    if (backend != LOG_BACKEND_SYNC)
+    {
+        pthread_mutex_lock(&drain_lock);
+        log_file_binary = (backend == LOG_BACKEND_BINARY);
+        if (file_path)
+        {
+            log_file = fopen(file_path, log_file_binary ? "wb" : "w");
+            if (!log_file)
+            {
+                cerr << "Could not open log file " << file_path << endl;
+                ret = -1;
+            }
+            else
+            {
+                setvbuf(log_file, NULL, _IOFBF, 1 << 20);
+            }
+        }
+        if (!ret && log_file_binary)
+        {
+            uint32_t version = NVLOG_BINARY_VERSION;
+            uint32_t reserved = 0;
+            fwrite(NVLOG_BINARY_MAGIC, 8, 1, log_file);
+            fwrite(&version, sizeof(version), 1, log_file);
+            fwrite(&reserved, sizeof(reserved), 1, log_file);
+        }
+        pthread_mutex_unlock(&drain_lock);
+
+        if (!ret)
+        {
+            writer_running.store(true, memory_order_release);
+            pthread_create(&writer_thread, NULL, writer_thread_func, NULL);
+            pthread_setname_np(writer_thread, "NvLogWriter");
+            async_accepting.store(true, memory_order_seq_cst);
+            __atomic_store_n(&log_backend, backend, __ATOMIC_RELAXED);
+        }
+    }
+
+    pthread_mutex_unlock(&backend_lock);
+    return ret;
+}
+
+int
+NvLogDecodeBinary(const char *file_path, std::ostream &outstream)
+{
+    FILE *fp = fopen(file_path, "rb");
+    map<uint32_t, pair<string, int> > sites;
+    ostringstream text;
+    char magic[8];
+    uint32_t version, reserved;
+    vector<char> payload;
+    int ret = 0;
+    uint8_t type;
+
+    if (!fp)
+    {
+        cerr << "Could not open " << file_path << endl;
+        return -1;
+    }
+
+    if (fread(magic, sizeof(magic), 1, fp) != 1 ||
+            memcmp(magic, NVLOG_BINARY_MAGIC, sizeof(magic)) ||
+            fread(&version, sizeof(version), 1, fp) != 1 ||
+            fread(&reserved, sizeof(reserved), 1, fp) != 1 ||
+            version != NVLOG_BINARY_VERSION)
+    {
+        cerr << file_path << " is not a binary log file" << endl;
+        fclose(fp);
+        return -1;
+    }
+
+    while (fread(&type, sizeof(type), 1, fp) == 1)
+    {
+        if (type == NVLOG_BINARY_SITE)
+        {
+            uint16_t file_len;
+            uint32_t site_id, line;
+
+            if (fread(&file_len, sizeof(file_len), 1, fp) != 1 ||
+                    fread(&site_id, sizeof(site_id), 1, fp) != 1 ||
+                    fread(&line, sizeof(line), 1, fp) != 1)
+            {
+                ret = -1;
+                break;
+            }
+            payload.resize(file_len);
+            if (file_len && fread(&payload[0], file_len, 1, fp) != 1)
+            {
+                ret = -1;
+                break;
+            }
+            sites[site_id] = make_pair(string(payload.begin(), payload.end()),
+                    (int) line);
+        }
+        else if (type == NVLOG_BINARY_MSG)
+        {
+            uint8_t level, truncated;
+            uint16_t length;
+            uint32_t site_id, tid, suppressed;
+            uint64_t timestamp_ns;
+            char *buf;
+            size_t size;
+
+            if (fread(&level, sizeof(level), 1, fp) != 1 ||
+                    fread(&truncated, sizeof(truncated), 1, fp) != 1 ||
+                    fread(&length, sizeof(length), 1, fp) != 1 ||
+                    fread(&site_id, sizeof(site_id), 1, fp) != 1 ||
+                    fread(&tid, sizeof(tid), 1, fp) != 1 ||
+                    fread(&suppressed, sizeof(suppressed), 1, fp) != 1 ||
+                    fread(&timestamp_ns, sizeof(timestamp_ns), 1, fp) != 1 ||
+                    sites.find(site_id) == sites.end())
+            {
+                ret = -1;
+                break;
+            }
+            payload.resize(length + 1);
+            if (length && fread(&payload[0], length, 1, fp) != 1)
+            {
+                ret = -1;
+                break;
+            }
+            text.str("");
+            if (!format_args(text, &payload[0], length))
+            {
+                ret = -1;
+                break;
+            }
+
+            string msg = text.str();
+            FILE *mem = open_memstream(&buf, &size);
+            write_text(mem, timestamp_ns, tid, level,
+                    sites[site_id].first.c_str(), sites[site_id].second,
+                    msg.data(), msg.size(), truncated, suppressed);
+            fclose(mem);
+            outstream.write(buf, size);
+            free(buf);
+        }
+        else
+        {
+            ret = -1;
+            break;
+        }
+    }
+
+    if (ret)
+        cerr << file_path << " is truncated or corrupted" << endl;
+    fclose(fp);
+    return ret;
+}
+
+/**
+ * Applies the NVLOG_* environment variables at startup and flushes the
+ * asynchronous backends at exit.
+ */
+static struct NvLogInit
+{
+    NvLogInit()
+    {
+        const char *env;
+
+        env = getenv("NVLOG_LEVELS");
+        if (env)
+        {
+            string levels(env);
+            size_t pos = 0;
+
+            while (pos < levels.size())
+            {
+                size_t end = levels.find(',', pos);
+                string entry = levels.substr(pos, end == string::npos ? string::npos : end - pos);
+                size_t eq = entry.find('=');
+
+                if (eq != string::npos)
+                    NvLogSetComponentLevel(entry.substr(0, eq).c_str(),
+                            atoi(entry.c_str() + eq + 1));
+                if (end == string::npos)
+                    break;
+                pos = end + 1;
+            }
+        }
+
+        env = getenv("NVLOG_RATE_LIMIT");
+        if (env)
+            NvLogSetRateLimit(atoi(env));
+
+        env = getenv("NVLOG_BACKEND");
+        if (env)
+        {
+            if (!strcmp(env, "async"))
+                NvLogSetBackend(LOG_BACKEND_ASYNC, getenv("NVLOG_FILE"));
+            else if (!strcmp(env, "binary"))
+                NvLogSetBackend(LOG_BACKEND_BINARY, getenv("NVLOG_FILE"));
+        }
+    }
+
+    ~NvLogInit()
+    {
+        NvLogSetBackend(LOG_BACKEND_SYNC);
+    }
+} nvlog_init;
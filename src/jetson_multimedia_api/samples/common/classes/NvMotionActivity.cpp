@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvMotionActivity.h"
+#include "NvThreadPolicy.h"
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+#define DEFAULT_MV_THRESHOLD 4
+#define DEFAULT_ON_FRACTION 0.05f
+#define DEFAULT_OFF_FRACTION 0.02f
+#define DEFAULT_ON_FRAMES 3
+#define DEFAULT_OFF_FRAMES 15
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+print_event(const NvMotionEvent &event, void *arg)
+{
+    cout << "Frame " << event.frame_num << ": motion " <<
+        (event.motion ? "start" : "end");
+    if (event.region < 0)
+        cout << " (frame";
+    else
+        cout << " (region " << event.region;
+    cout << ", " << (int) (event.moving_fraction * 100) << "% moving)" << endl;
+}
+
+NvMotionActivity::NvMotionActivity(uint32_t blocks_x, uint32_t blocks_y,
+                                   uint32_t regions_x, uint32_t regions_y,
+                                   uint32_t ring_frames)
+    : blocks_x(blocks_x ? blocks_x : 1)
+    , blocks_y(blocks_y ? blocks_y : 1)
+    , regions_x(regions_x ? regions_x : 1)
+    , regions_y(regions_y ? regions_y : 1)
+    , mv_threshold(DEFAULT_MV_THRESHOLD)
+    , on_fraction(DEFAULT_ON_FRACTION)
+    , off_fraction(DEFAULT_OFF_FRACTION)
+    , on_frames(DEFAULT_ON_FRAMES)
+    , off_frames(DEFAULT_OFF_FRAMES)
+    , event_callback(print_event)
+    , event_arg(NULL)
+    , export_file(NULL)
+    , ring_head(0)
+    , ring_count(0)
+    , running(false)
+    , stopping(false)
+{
+    if (this->regions_x > this->blocks_x)
+        this->regions_x = this->blocks_x;
+    if (this->regions_y > this->blocks_y)
+        this->regions_y = this->blocks_y;
+
+    /* Regions split the block grid as evenly as possible */
+    region_col_start.resize(this->regions_x + 1);
+    for (uint32_t i = 0; i <= this->regions_x; i++)
+        region_col_start[i] = i * this->blocks_x / this->regions_x;
+
+    region_blocks.assign(this->regions_x * this->regions_y, 0);
+    for (uint32_t ry = 0; ry < this->regions_y; ry++)
+    {
+        uint32_t rows = (ry + 1) * this->blocks_y / this->regions_y -
+            ry * this->blocks_y / this->regions_y;
+        for (uint32_t rx = 0; rx < this->regions_x; rx++)
+            region_blocks[ry * this->regions_x + rx] =
+                rows * (region_col_start[rx + 1] - region_col_start[rx]);
+    }
+
+    row_moving.assign(this->blocks_y, 0);
+    region_moving.assign(this->regions_x * this->regions_y, 0);
+    region_motion.assign(this->regions_x * this->regions_y, false);
+    Hysteresis idle = { 0, false };
+    region_state.assign(this->regions_x * this->regions_y, idle);
+    frame_motion = false;
+
+    ring.resize(ring_frames ? ring_frames : 1);
+    for (size_t i = 0; i < ring.size(); i++)
+        ring[i].mvs.reserve(this->blocks_x * this->blocks_y);
+
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+NvMotionActivity::~NvMotionActivity()
+{
+    stop();
+    delete export_file;
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&cond);
+}
+
+void
+NvMotionActivity::setThresholds(uint32_t mv_threshold, float on_fraction,
+                                float off_fraction, uint32_t on_frames,
+                                uint32_t off_frames)
+{
+    this->mv_threshold = mv_threshold;
+    this->on_fraction = on_fraction;
+    this->off_fraction = off_fraction;
+    this->on_frames = on_frames ? on_frames : 1;
+    this->off_frames = off_frames ? off_frames : 1;
+}
+
+void
+NvMotionActivity::setEventCallback(EventCallback callback, void *arg)
+{
+    event_callback = callback;
+    event_arg = arg;
+}
+
+int
+NvMotionActivity::openExport(const char *path)
+{
+    delete export_file;
+    export_file = new ofstream(path, ios::binary);
+    if (!export_file->is_open())
+    {
+        cerr << "Could not open motion vector file " << path << endl;
+        delete export_file;
+        export_file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int
+NvMotionActivity::start()
+{
+    if (running)
+        return 0;
+
+    stopping = false;
+    if (pthread_create(&worker, NULL, workerThread, this) != 0)
+    {
+        cerr << "Error creating motion activity thread" << endl;
+        return -1;
+    }
+    pthread_setname_np(worker, "MotionActivity");
+    running = true;
+
+    return 0;
+}
+
+int
+NvMotionActivity::push(uint32_t frame_num, const void *mvs, uint32_t num_mvs)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&lock);
+    stats.frames_pushed++;
+    if (ring_count == ring.size())
+    {
+        /* Never hold up the encoder, drop the frame instead */
+        stats.frames_dropped++;
+        ret = -1;
+    }
+    else
+    {
+        Slot &slot = ring[(ring_head + ring_count) % ring.size()];
+
+        /* The slot is not in use by the worker, copy outside of the lock */
+        pthread_mutex_unlock(&lock);
+        slot.header.magic = NV_MV_FRAME_MAGIC;
+        slot.header.frame_num = frame_num;
+        slot.header.blocks_x = blocks_x;
+        slot.header.blocks_y = blocks_y;
+        slot.header.num_mvs = num_mvs;
+        slot.mvs.resize(num_mvs);
+        if (num_mvs)
+            memcpy(&slot.mvs[0], mvs, num_mvs * sizeof(uint32_t));
+        pthread_mutex_lock(&lock);
+
+        ring_count++;
+        pthread_cond_signal(&cond);
+    }
+    pthread_mutex_unlock(&lock);
+
+    return ret;
+}
+
+void
+NvMotionActivity::stop()
+{
+    if (!running)
+        return;
+
+    pthread_mutex_lock(&lock);
+    stopping = true;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+
+    pthread_join(worker, NULL);
+    running = false;
+    if (export_file)
+        export_file->flush();
+}
+
+uint32_t
+NvMotionActivity::countMoving(const uint32_t *mvs, uint32_t count,
+                              uint32_t mv_threshold, uint32_t *magnitude_sum)
+{
+    uint32_t moving = 0;
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        /* mv_x is bits 0-15 and mv_y bits 16-29, both signed */
+        int32_t x = (int32_t) (mvs[i] << 16) >> 16;
+        int32_t y = (int32_t) (mvs[i] << 2) >> 18;
+        uint32_t magnitude = (x < 0 ? -x : x) + (y < 0 ? -y : y);
+
+        sum += magnitude;
+        moving += magnitude > mv_threshold;
+    }
+    if (magnitude_sum)
+        *magnitude_sum = sum;
+
+    return moving;
+}
+
+bool
+NvMotionActivity::updateHysteresis(Hysteresis &state, float moving_fraction)
+{
+    bool towards_change = state.motion ? (moving_fraction < off_fraction) :
+        (moving_fraction >= on_fraction);
+
+    state.count = towards_change ? state.count + 1 : 0;
+    if (state.count >= (state.motion ? off_frames : on_frames))
+    {
+        state.motion = !state.motion;
+        state.count = 0;
+        return true;
+    }
+    return false;
+}
+
+void
+NvMotionActivity::raiseEvent(uint32_t frame_num, int32_t region, bool motion,
+                             float moving_fraction)
+{
+    NvMotionEvent event;
+
+    event.frame_num = frame_num;
+    event.region = region;
+    event.motion = motion;
+    event.moving_fraction = moving_fraction;
+
+    pthread_mutex_lock(&lock);
+    stats.events++;
+    pthread_mutex_unlock(&lock);
+    if (event_callback)
+        event_callback(event, event_arg);
+}
+
+void
+NvMotionActivity::analyzeFrame(uint32_t frame_num, const uint32_t *mvs, uint32_t num_mvs)
+{
+    uint64_t start_usec = get_time_usec();
+    uint32_t total_moving = 0;
+    uint32_t rows = num_mvs / blocks_x;
+
+    if (rows > blocks_y)
+        rows = blocks_y;
+
+    region_moving.assign(region_moving.size(), 0);
+    for (uint32_t by = 0; by < rows; by++)
+    {
+        const uint32_t *row = mvs + by * blocks_x;
+        uint32_t ry = by * regions_y / blocks_y;
+
+        row_moving[by] = 0;
+        for (uint32_t rx = 0; rx < regions_x; rx++)
+        {
+            uint32_t moving = countMoving(row + region_col_start[rx],
+                    region_col_start[rx + 1] - region_col_start[rx], mv_threshold, NULL);
+
+            region_moving[ry * regions_x + rx] += moving;
+            row_moving[by] += moving;
+        }
+        total_moving += row_moving[by];
+    }
+    for (uint32_t by = rows; by < blocks_y; by++)
+        row_moving[by] = 0;
+
+    for (uint32_t i = 0; i < region_moving.size(); i++)
+    {
+        float fraction = region_blocks[i] ? (float) region_moving[i] / region_blocks[i] : 0;
+
+        if (updateHysteresis(region_state[i], fraction))
+        {
+            region_motion[i] = region_state[i].motion;
+            raiseEvent(frame_num, i, region_motion[i], fraction);
+        }
+    }
+
+    /* The frame is in motion while any of its regions is */
+    bool motion = false;
+    for (uint32_t i = 0; i < region_motion.size(); i++)
+        motion = motion || region_motion[i];
+    if (motion != frame_motion)
+    {
+        frame_motion = motion;
+        raiseEvent(frame_num, -1, frame_motion,
+                (float) total_moving / (blocks_x * blocks_y));
+    }
+
+    pthread_mutex_lock(&lock);
+    stats.frames_analyzed++;
+    stats.analyze_usec += get_time_usec() - start_usec;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvMotionActivity::getStats(NvMotionActivityStats &stats)
+{
+    pthread_mutex_lock(&lock);
+    stats = this->stats;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvMotionActivity::printStats(ostream &outstream)
+{
+    NvMotionActivityStats activity_stats;
+
+    getStats(activity_stats);
+
+    outstream << "----------- Motion activity -----------" << endl;
+    outstream << "Blocks: " << blocks_x << "x" << blocks_y << ", regions: " <<
+        regions_x << "x" << regions_y << endl;
+    outstream << "Frames: " << activity_stats.frames_analyzed << " analyzed, " <<
+        activity_stats.frames_dropped << " dropped" << endl;
+    outstream << "Motion events: " << activity_stats.events << endl;
+    if (activity_stats.frames_analyzed)
+        outstream << "Analysis time: " << (double) activity_stats.analyze_usec /
+            activity_stats.frames_analyzed << " us per frame" << endl;
+    outstream << "---------------------------------------" << endl;
+}
+
+int
+NvMotionActivity::readFrame(istream &stream, NvMotionVectorFrameHeader &header,
+                            vector<uint32_t> &mvs)
+{
+    if (!stream.read((char *) &header, sizeof(header)))
+        return -1;
+    if (header.magic != NV_MV_FRAME_MAGIC)
+    {
+        cerr << "Corrupt motion vector frame" << endl;
+        return -1;
+    }
+    mvs.resize(header.num_mvs);
+    if (header.num_mvs &&
+        !stream.read((char *) &mvs[0], header.num_mvs * sizeof(uint32_t)))
+        return -1;
+
+    return 0;
+}
+
+void *
+NvMotionActivity::workerThread(void *arg)
+{
+    NvMotionActivity *activity = (NvMotionActivity *) arg;
+
+    NvThreadPolicy::getInstance().applyToCurrentThread("analytics");
+
+    pthread_mutex_lock(&activity->lock);
+    while (true)
+    {
+        while (activity->ring_count == 0 && !activity->stopping)
+            pthread_cond_wait(&activity->cond, &activity->lock);
+        if (activity->ring_count == 0)
+            break;
+
+        /* The producer does not touch the oldest slot while it is counted */
+        Slot &slot = activity->ring[activity->ring_head];
+        pthread_mutex_unlock(&activity->lock);
+
+        if (activity->export_file)
+        {
+            activity->export_file->write((char *) &slot.header, sizeof(slot.header));
+            if (slot.header.num_mvs)
+                activity->export_file->write((char *) &slot.mvs[0],
+                        slot.header.num_mvs * sizeof(uint32_t));
+        }
+        activity->analyzeFrame(slot.header.frame_num,
+                slot.mvs.empty() ? NULL : &slot.mvs[0], slot.header.num_mvs);
+
+        pthread_mutex_lock(&activity->lock);
+        activity->ring_head = (activity->ring_head + 1) % activity->ring.size();
+        activity->ring_count--;
+    }
+    pthread_mutex_unlock(&activity->lock);
+
+    return NULL;
+}
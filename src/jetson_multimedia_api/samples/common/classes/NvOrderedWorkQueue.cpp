@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvOrderedWorkQueue.h"
+#include "NvThreadPolicy.h"
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+NvOrderedWorkQueue::NvOrderedWorkQueue(const char *name, uint32_t num_workers,
+                                       uint32_t capacity, ProcessCallback process,
+                                       CommitCallback commit, void *arg)
+    : name(name)
+    , num_workers(num_workers ? num_workers : 1)
+    , capacity(capacity ? capacity : 1)
+    , process(process)
+    , commit(commit)
+    , arg(arg)
+    , head_seq(0)
+    , claim_seq(0)
+    , committing(false)
+    , running(false)
+    , stopping(false)
+    , depth_sum(0)
+{
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&work_cond, NULL);
+    pthread_cond_init(&space_cond, NULL);
+}
+
+NvOrderedWorkQueue::~NvOrderedWorkQueue()
+{
+    stop();
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&work_cond);
+    pthread_cond_destroy(&space_cond);
+}
+
+int
+NvOrderedWorkQueue::start()
+{
+    if (running)
+        return 0;
+
+    stopping = false;
+    for (uint32_t i = 0; i < num_workers; i++)
+    {
+        pthread_t thread;
+        char thread_name[16];
+
+        if (pthread_create(&thread, NULL, workerThread, this) != 0)
+        {
+            cerr << "Error creating " << name << " worker thread" << endl;
+            running = true;
+            stop();
+            return -1;
+        }
+        snprintf(thread_name, sizeof(thread_name), "%.12sW%u", name.c_str(), i % 100);
+        pthread_setname_np(thread, thread_name);
+        workers.push_back(thread);
+    }
+    running = true;
+
+    return 0;
+}
+
+int
+NvOrderedWorkQueue::push(void *job)
+{
+    Entry entry;
+    uint64_t wait_start = 0;
+
+    entry.job = job;
+    entry.done = false;
+
+    pthread_mutex_lock(&lock);
+    if (!running || stopping)
+    {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    if (entries.size() >= capacity)
+    {
+        wait_start = get_time_usec();
+        stats.num_full_waits++;
+        while (entries.size() >= capacity)
+            pthread_cond_wait(&space_cond, &lock);
+        stats.full_wait_usec += get_time_usec() - wait_start;
+    }
+
+    entries.push_back(entry);
+    stats.num_jobs++;
+    depth_sum += entries.size();
+    if (entries.size() > stats.max_depth)
+        stats.max_depth = entries.size();
+    pthread_cond_signal(&work_cond);
+    pthread_mutex_unlock(&lock);
+
+    return 0;
+}
+
+void
+NvOrderedWorkQueue::waitIdle()
+{
+    pthread_mutex_lock(&lock);
+    while (!entries.empty())
+        pthread_cond_wait(&space_cond, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvOrderedWorkQueue::stop()
+{
+    if (!running)
+        return;
+
+    waitIdle();
+
+    pthread_mutex_lock(&lock);
+    stopping = true;
+    pthread_cond_broadcast(&work_cond);
+    pthread_mutex_unlock(&lock);
+
+    for (size_t i = 0; i < workers.size(); i++)
+        pthread_join(workers[i], NULL);
+    workers.clear();
+    running = false;
+}
+
+void
+NvOrderedWorkQueue::getStats(NvOrderedWorkQueueStats &stats)
+{
+    pthread_mutex_lock(&lock);
+    stats = this->stats;
+    stats.avg_depth = this->stats.num_jobs ?
+        (float) depth_sum / this->stats.num_jobs : 0;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvOrderedWorkQueue::printStats(ostream &outstream)
+{
+    NvOrderedWorkQueueStats queue_stats;
+
+    getStats(queue_stats);
+
+    outstream << "----------- " << name << " work queue -----------" << endl;
+    outstream << "Workers: " << num_workers << ", capacity: " << capacity << endl;
+    outstream << "Jobs: " << queue_stats.num_jobs << endl;
+    outstream << "Depth: avg " << queue_stats.avg_depth << ", max " <<
+        queue_stats.max_depth << endl;
+    outstream << "Producer waits on full queue: " << queue_stats.num_full_waits <<
+        " (" << queue_stats.full_wait_usec << " us)" << endl;
+    outstream << "-------------------------------------" << endl;
+}
+
+void *
+NvOrderedWorkQueue::workerThread(void *arg)
+{
+    NvOrderedWorkQueue *queue = (NvOrderedWorkQueue *) arg;
+
+    NvThreadPolicy::getInstance().applyToCurrentThread("worker");
+
+    pthread_mutex_lock(&queue->lock);
+    while (true)
+    {
+        Entry *entry;
+
+        while (queue->claim_seq == queue->head_seq + queue->entries.size() &&
+               !queue->stopping)
+            pthread_cond_wait(&queue->work_cond, &queue->lock);
+        if (queue->claim_seq == queue->head_seq + queue->entries.size())
+            break;
+
+        /* References to deque elements stay valid across push_back and
+           across pop_front of other elements. */
+        entry = &queue->entries[queue->claim_seq - queue->head_seq];
+        queue->claim_seq++;
+        pthread_mutex_unlock(&queue->lock);
+
+        if (queue->process)
+            queue->process(entry->job, queue->arg);
+
+        pthread_mutex_lock(&queue->lock);
+        entry->done = true;
+
+        /* The first worker to find the oldest job done commits all the
+           consecutive finished jobs; the others return to work. */
+        if (queue->committing)
+            continue;
+        queue->committing = true;
+        while (!queue->entries.empty() && queue->entries.front().done)
+        {
+            void *job = queue->entries.front().job;
+
+            queue->entries.pop_front();
+            queue->head_seq++;
+            pthread_mutex_unlock(&queue->lock);
+
+            queue->commit(job, queue->arg);
+
+            pthread_mutex_lock(&queue->lock);
+            pthread_cond_broadcast(&queue->space_cond);
+        }
+        queue->committing = false;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return NULL;
+}
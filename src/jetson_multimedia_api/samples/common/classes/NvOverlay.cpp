@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "NvOverlay.h"
+#include "nvbufsurface.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+
+static uint8_t
+to_u8(float value)
+{
+    return (uint8_t) (value <= 0.0f ? 0 : (value >= 1.0f ? 255 : value * 255.0f + 0.5f));
+}
+
+static void
+to_rgba(const NvOverlayColor &color, uint8_t *rgba)
+{
+    rgba[0] = to_u8(color.r);
+    rgba[1] = to_u8(color.g);
+    rgba[2] = to_u8(color.b);
+    rgba[3] = to_u8(color.a);
+}
+
+/* Rounded division by 255, exact up to 255 * 255 + 127, in 16 bits */
+static inline uint8_t
+div255(uint32_t value)
+{
+    return (uint8_t) ((value + 1 + (value >> 8)) >> 8);
+}
+
+/* Blends with GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA */
+static inline uint8_t
+blend(uint8_t dst, uint8_t src, uint32_t alpha)
+{
+    return div255(src * alpha + dst * (255 - alpha) + 127);
+}
+
+static NvOverlayQuad
+solid_quad(float x0, float y0, float x1, float y1)
+{
+    NvOverlayQuad quad;
+
+    memset(&quad, 0, sizeof(quad));
+    quad.x0 = x0;
+    quad.y0 = y0;
+    quad.x1 = x1;
+    quad.y1 = y1;
+    quad.u0 = quad.v0 = quad.u1 = quad.v1 = -1.0f;
+    return quad;
+}
+
+NvOverlay::NvOverlay(const NvOverlayFont &font, uint32_t max_layouts)
+    : font(font)
+    , max_layouts(max_layouts)
+    , width(0)
+    , height(0)
+    , vertices_valid(false)
+    , generation(0)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void
+NvOverlay::begin(uint32_t width, uint32_t height)
+{
+    this->width = width;
+    this->height = height;
+    previous.swap(quads);
+    quads.clear();
+    vertices_valid = false;
+}
+
+const NvOverlay::Layout &
+NvOverlay::getLayout(const char *text, float size)
+{
+    LayoutKey key(text, size);
+    map<LayoutKey, Layout>::iterator it = layouts.find(key);
+
+    if (it != layouts.end())
+    {
+        stats.layout_hits++;
+        it->second.last_used = stats.num_frames;
+        return it->second;
+    }
+    stats.layout_misses++;
+
+    Layout &layout = layouts[key];
+    const float glyph_width = size * (font.width / font.columns) / (font.height / font.rows);
+    /* Keep clear of the neighbouring cells, as GLContext::renderText() */
+    const float inset = 1.0f / font.columns / 32.0f;
+    const uint32_t num_chars = font.columns * font.rows;
+    float x = 0.0f;
+    float y = 0.0f;
+
+    layout.last_used = stats.num_frames;
+    for (const char *p = text; ; p++)
+    {
+        if (*p == '\n' || *p == '\0')
+        {
+            if (x > 0.0f)
+                layout.lines.push_back(solid_quad(0.0f, y, x, y + size));
+            if (*p == '\0')
+                break;
+            x = 0.0f;
+            y += size;
+            continue;
+        }
+
+        uint32_t index = (uint8_t) *p - font.first_char;
+
+        if ((uint8_t) *p >= font.first_char && index < num_chars && *p != ' ')
+        {
+            NvOverlayQuad glyph;
+            uint32_t col = index % font.columns;
+            uint32_t row = index / font.columns;
+
+            glyph.x0 = x;
+            glyph.y0 = y;
+            glyph.x1 = x + glyph_width;
+            glyph.y1 = y + size;
+            glyph.u0 = (float) col / font.columns + inset;
+            glyph.u1 = (float) (col + 1) / font.columns - inset;
+            glyph.v0 = (float) row / font.rows;
+            glyph.v1 = (float) (row + 1) / font.rows;
+            memset(glyph.color, 0, sizeof(glyph.color));
+            layout.glyphs.push_back(glyph);
+        }
+        x += glyph_width;
+    }
+    return layout;
+}
+
+void
+NvOverlay::addQuad(const NvOverlayQuad &quad, float x, float y, const uint8_t *color)
+{
+    NvOverlayQuad moved = quad;
+
+    moved.x0 += x;
+    moved.x1 += x;
+    moved.y0 += y;
+    moved.y1 += y;
+    memcpy(moved.color, color, sizeof(moved.color));
+    quads.push_back(moved);
+}
+
+void
+NvOverlay::addText(float x, float y, float size, const char *text,
+                   const NvOverlayColor &color, const NvOverlayColor *background)
+{
+    uint8_t rgba[4];
+
+    if (text == NULL || *text == '\0' || size <= 0.0f)
+        return;
+
+    const Layout &layout = getLayout(text, size);
+
+    stats.num_texts++;
+    vertices_valid = false;
+    if (background)
+    {
+        to_rgba(*background, rgba);
+        for (size_t i = 0; i < layout.lines.size(); i++)
+            addQuad(layout.lines[i], x, y, rgba);
+    }
+    to_rgba(color, rgba);
+    for (size_t i = 0; i < layout.glyphs.size(); i++)
+        addQuad(layout.glyphs[i], x, y, rgba);
+}
+
+void
+NvOverlay::addBox(float left, float top, float width, float height, float border,
+                  const NvOverlayColor &color)
+{
+    const float right = left + width;
+    const float bottom = top + height;
+    uint8_t rgba[4];
+
+    if (width <= 0.0f || height <= 0.0f)
+        return;
+
+    stats.num_boxes++;
+    vertices_valid = false;
+    to_rgba(color, rgba);
+    if (border <= 0.0f || 2 * border >= width || 2 * border >= height)
+    {
+        addQuad(solid_quad(left, top, right, bottom), 0, 0, rgba);
+        return;
+    }
+    addQuad(solid_quad(left, top, right, top + border), 0, 0, rgba);
+    addQuad(solid_quad(left, bottom - border, right, bottom), 0, 0, rgba);
+    addQuad(solid_quad(left, top + border, left + border, bottom - border), 0, 0, rgba);
+    addQuad(solid_quad(right - border, top + border, right, bottom - border), 0, 0, rgba);
+}
+
+bool
+NvOverlay::end()
+{
+    bool changed = quads.size() != previous.size() ||
+        (!quads.empty() &&
+         memcmp(&quads[0], &previous[0], quads.size() * sizeof(NvOverlayQuad)) != 0);
+
+    if (changed)
+    {
+        generation++;
+        stats.num_changes++;
+    }
+    stats.num_quads += quads.size();
+
+    // Evict the layouts not used by this frame
+    for (map<LayoutKey, Layout>::iterator it = layouts.begin();
+         layouts.size() > max_layouts && it != layouts.end(); )
+    {
+        if (it->second.last_used != stats.num_frames)
+        {
+            layouts.erase(it++);
+            stats.layout_evictions++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    stats.num_frames++;
+    return changed;
+}
+
+uint32_t
+NvOverlay::getWidth()
+{
+    return width;
+}
+
+uint32_t
+NvOverlay::getHeight()
+{
+    return height;
+}
+
+const vector<NvOverlayQuad> &
+NvOverlay::getQuads()
+{
+    return quads;
+}
+
+const vector<NvOverlayVertex> &
+NvOverlay::getVertices()
+{
+    if (vertices_valid)
+        return vertices;
+
+    vertices.resize(quads.size() * 6);
+    for (size_t i = 0; i < quads.size(); i++)
+    {
+        const NvOverlayQuad &q = quads[i];
+        const NvOverlayVertex corners[4] = {
+            { q.x0, q.y0, q.u0, q.v0, { q.color[0], q.color[1], q.color[2], q.color[3] } },
+            { q.x1, q.y0, q.u1, q.v0, { q.color[0], q.color[1], q.color[2], q.color[3] } },
+            { q.x0, q.y1, q.u0, q.v1, { q.color[0], q.color[1], q.color[2], q.color[3] } },
+            { q.x1, q.y1, q.u1, q.v1, { q.color[0], q.color[1], q.color[2], q.color[3] } },
+        };
+        NvOverlayVertex *v = &vertices[i * 6];
+
+        v[0] = corners[0];
+        v[1] = corners[2];
+        v[2] = corners[1];
+        v[3] = corners[1];
+        v[4] = corners[2];
+        v[5] = corners[3];
+    }
+    vertices_valid = true;
+    return vertices;
+}
+
+uint64_t
+NvOverlay::getGeneration()
+{
+    return generation;
+}
+
+/*
+ * Computes the alpha of the pixels [x0, x1) of row y covered by a quad,
+ * sampling the atlas at pixel centers with bilinear filtering and clamping
+ * to the edges, as GL_LINEAR and GL_CLAMP_TO_EDGE. The columns come from
+ * mapColumns().
+ */
+void
+NvOverlay::rasterize(const NvOverlayQuad &quad, int32_t x0, int32_t x1, int32_t y,
+                     uint8_t *out)
+{
+    const uint32_t alpha = quad.color[3];
+
+    if (quad.u0 < 0.0f)
+    {
+        memset(out, alpha, x1 - x0);
+        return;
+    }
+
+    const int32_t atlas_width = font.width;
+    const int32_t atlas_height = font.height;
+    float v = quad.v0 + (y + 0.5f - quad.y0) / (quad.y1 - quad.y0) * (quad.v1 - quad.v0);
+    float ty = v * atlas_height - 0.5f;
+    int32_t ty0 = (int32_t) floorf(ty);
+    uint32_t wy = (uint32_t) ((ty - ty0) * 256.0f);
+    const uint8_t *row0 = font.pixels + (size_t) min(max(ty0, 0), atlas_height - 1) * atlas_width;
+    const uint8_t *row1 = font.pixels + (size_t) min(max(ty0 + 1, 0), atlas_height - 1) * atlas_width;
+
+    for (int32_t x = 0; x < x1 - x0; x++)
+    {
+        uint32_t c0 = xmap[3 * x];
+        uint32_t c1 = xmap[3 * x + 1];
+        uint32_t wx = xmap[3 * x + 2];
+        uint32_t top = row0[c0] * (256 - wx) + row0[c1] * wx;
+        uint32_t bottom = row1[c0] * (256 - wx) + row1[c1] * wx;
+        uint32_t coverage;
+
+        /* Most of a glyph cell is empty */
+        if ((top | bottom) == 0)
+        {
+            *out++ = 0;
+            continue;
+        }
+        coverage = (top * (256 - wy) + bottom * wy + 32768) >> 16;
+        *out++ = div255(coverage * alpha + 127);
+    }
+}
+
+/* Atlas columns and weight of the pixels [x0, x1) of a glyph quad */
+void
+NvOverlay::mapColumns(const NvOverlayQuad &quad, int32_t x0, int32_t x1)
+{
+    const int32_t atlas_width = font.width;
+    const float du = (quad.u1 - quad.u0) / (quad.x1 - quad.x0) * atlas_width;
+    float tx = (quad.u0 + (x0 + 0.5f - quad.x0) / (quad.x1 - quad.x0) * (quad.u1 - quad.u0)) *
+        atlas_width - 0.5f;
+
+    xmap.resize((x1 - x0) * 3);
+    for (int32_t x = 0; x < x1 - x0; x++, tx += du)
+    {
+        int32_t tx0 = (int32_t) floorf(tx);
+
+        xmap[3 * x] = min(max(tx0, 0), atlas_width - 1);
+        xmap[3 * x + 1] = min(max(tx0 + 1, 0), atlas_width - 1);
+        xmap[3 * x + 2] = (uint32_t) ((tx - tx0) * 256.0f);
+    }
+}
+
+void
+NvOverlay::compositeQuad(const NvOverlayQuad &quad, NvBufSurfaceParams &params)
+{
+    /* Pixels whose center is inside the quad */
+    int32_t x0 = max((int32_t) ceilf(quad.x0 - 0.5f), 0);
+    int32_t x1 = min((int32_t) ceilf(quad.x1 - 0.5f), (int32_t) params.width);
+    int32_t y0 = max((int32_t) ceilf(quad.y0 - 0.5f), 0);
+    int32_t y1 = min((int32_t) ceilf(quad.y1 - 0.5f), (int32_t) params.height);
+    const uint8_t *c = quad.color;
+
+    if (x0 >= x1 || y0 >= y1 || c[3] == 0)
+        return;
+    if (quad.u0 >= 0.0f)
+        mapColumns(quad, x0, x1);
+
+    if (params.colorFormat == NVBUF_COLOR_FORMAT_RGBA && quad.u0 < 0.0f)
+    {
+        /* Solid quad: the same blend for every pixel */
+        const uint32_t a = c[3];
+        const uint32_t src[4] = { c[0] * a + 127, c[1] * a + 127, c[2] * a + 127, a * a + 127 };
+
+        for (int32_t y = y0; y < y1; y++)
+        {
+            uint8_t *out = (uint8_t *) params.mappedAddr.addr[0] +
+                (size_t) y * params.planeParams.pitch[0] + x0 * 4;
+
+            for (int32_t x = 0; x < (x1 - x0) * 4; x++)
+                out[x] = div255(out[x] * (255 - a) + src[x & 3]);
+        }
+        return;
+    }
+
+    if (params.colorFormat == NVBUF_COLOR_FORMAT_RGBA)
+    {
+        coverage.resize(x1 - x0);
+        for (int32_t y = y0; y < y1; y++)
+        {
+            uint8_t *out = (uint8_t *) params.mappedAddr.addr[0] +
+                (size_t) y * params.planeParams.pitch[0] + x0 * 4;
+
+            rasterize(quad, x0, x1, y, &coverage[0]);
+            for (int32_t x = 0; x < x1 - x0; x++, out += 4)
+            {
+                uint32_t a = coverage[x];
+
+                if (a == 0)
+                    continue;
+                out[0] = blend(out[0], c[0], a);
+                out[1] = blend(out[1], c[1], a);
+                out[2] = blend(out[2], c[2], a);
+                out[3] = blend(out[3], (uint8_t) a, a);
+            }
+        }
+        return;
+    }
+
+    /* NV12: BT.601 limited range, as NvBufSurfCpuTransform */
+    const uint8_t luma = (uint8_t) (((66 * c[0] + 129 * c[1] + 25 * c[2] + 128) >> 8) + 16);
+    const uint8_t cb = (uint8_t) (((-38 * c[0] - 74 * c[1] + 112 * c[2] + 128) >> 8) + 128);
+    const uint8_t cr = (uint8_t) (((112 * c[0] - 94 * c[1] - 18 * c[2] + 128) >> 8) + 128);
+    const int32_t cx0 = x0 / 2;
+    const int32_t cx1 = (x1 + 1) / 2;
+    const size_t row_size = (cx1 - cx0) * 2;
+
+    /* Two rows of coverage, padded to whole chroma samples */
+    coverage.resize(row_size * 2);
+    for (int32_t cy = y0 / 2; cy < (y1 + 1) / 2; cy++)
+    {
+        uint8_t *chroma = (uint8_t *) params.mappedAddr.addr[1] +
+            (size_t) cy * params.planeParams.pitch[1] + cx0 * 2;
+
+        memset(&coverage[0], 0, row_size * 2);
+        for (int32_t r = 0; r < 2; r++)
+        {
+            int32_t y = cy * 2 + r;
+            uint8_t *alpha = &coverage[r * row_size];
+            uint8_t *out;
+
+            if (y < y0 || y >= y1)
+                continue;
+            rasterize(quad, x0, x1, y, alpha + (x0 - cx0 * 2));
+            out = (uint8_t *) params.mappedAddr.addr[0] +
+                (size_t) y * params.planeParams.pitch[0] + cx0 * 2;
+            for (int32_t x = x0 - cx0 * 2; x < x1 - cx0 * 2; x++)
+            {
+                if (alpha[x])
+                    out[x] = blend(out[x], luma, alpha[x]);
+            }
+        }
+        for (int32_t x = 0; x < cx1 - cx0; x++, chroma += 2)
+        {
+            uint32_t a = (coverage[2 * x] + coverage[2 * x + 1] +
+                          coverage[row_size + 2 * x] + coverage[row_size + 2 * x + 1] + 2) >> 2;
+
+            if (a == 0)
+                continue;
+            chroma[0] = blend(chroma[0], cb, a);
+            chroma[1] = blend(chroma[1], cr, a);
+        }
+    }
+}
+
+int
+NvOverlay::composite(NvBufSurface *surface, uint32_t index)
+{
+    if (surface == NULL || index >= surface->numFilled)
+        return -1;
+
+    NvBufSurfaceParams &params = surface->surfaceList[index];
+
+    if (params.colorFormat == NVBUF_COLOR_FORMAT_NV12)
+    {
+        if (!params.mappedAddr.addr[0] || !params.mappedAddr.addr[1])
+            return -1;
+    }
+    else if (params.colorFormat == NVBUF_COLOR_FORMAT_RGBA)
+    {
+        if (!params.mappedAddr.addr[0])
+            return -1;
+    }
+    else
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < quads.size(); i++)
+        compositeQuad(quads[i], params);
+    return 0;
+}
+
+void
+NvOverlay::getStats(NvOverlayStats *stats)
+{
+    *stats = this->stats;
+}
+
+void
+NvOverlay::printStats(ostream &outstream)
+{
+    outstream << "----------- Overlay -----------" << endl;
+    outstream << "Frames: " << stats.num_frames <<
+        ", changed: " << stats.num_changes <<
+        ", strings: " << stats.num_texts <<
+        ", boxes: " << stats.num_boxes << endl;
+    if (stats.num_frames)
+        outstream << "Quads per frame: " << (double) stats.num_quads / stats.num_frames <<
+            ", layouts cached: " << stats.layout_hits <<
+            ", laid out: " << stats.layout_misses <<
+            ", evicted: " << stats.layout_evictions << endl;
+}
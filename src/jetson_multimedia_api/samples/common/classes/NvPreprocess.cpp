@@ -0,0 +1,445 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvPreprocess.h"
+#include "NvThreadPolicy.h"
+#include <unistd.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define PREPROCESS_NEON
+#elif defined(__x86_64__)
+#include <emmintrin.h>
+#define PREPROCESS_SSE2
+#endif
+
+using namespace std;
+
+/* Elements read past the end of a row by the SIMD loads */
+#define ROW_SLACK 16
+
+/**
+ * Vertical bilinear pass over @a count bytes of two source rows.
+ */
+static void
+lerp_rows(const uint8_t *row0, const uint8_t *row1, uint32_t weight,
+          uint16_t *out, uint32_t count, bool simd)
+{
+    uint32_t i = 0;
+
+#if defined(PREPROCESS_SSE2)
+    if (simd)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rounding = _mm_set1_epi32(8);
+        const __m128i weights = _mm_set1_epi32((int) ((weight << 16) |
+                                               (NV_PREPROCESS_WEIGHT_ONE - weight)));
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *) (row0 + i));
+            __m128i b = _mm_loadu_si128((const __m128i *) (row1 + i));
+            __m128i a_lo = _mm_unpacklo_epi8(a, zero);
+            __m128i b_lo = _mm_unpacklo_epi8(b, zero);
+            __m128i a_hi = _mm_unpackhi_epi8(a, zero);
+            __m128i b_hi = _mm_unpackhi_epi8(b, zero);
+            __m128i s0 = _mm_madd_epi16(_mm_unpacklo_epi16(a_lo, b_lo), weights);
+            __m128i s1 = _mm_madd_epi16(_mm_unpackhi_epi16(a_lo, b_lo), weights);
+            __m128i s2 = _mm_madd_epi16(_mm_unpacklo_epi16(a_hi, b_hi), weights);
+            __m128i s3 = _mm_madd_epi16(_mm_unpackhi_epi16(a_hi, b_hi), weights);
+
+            s0 = _mm_srai_epi32(_mm_add_epi32(s0, rounding), 4);
+            s1 = _mm_srai_epi32(_mm_add_epi32(s1, rounding), 4);
+            s2 = _mm_srai_epi32(_mm_add_epi32(s2, rounding), 4);
+            s3 = _mm_srai_epi32(_mm_add_epi32(s3, rounding), 4);
+            _mm_storeu_si128((__m128i *) (out + i), _mm_packs_epi32(s0, s1));
+            _mm_storeu_si128((__m128i *) (out + i + 8), _mm_packs_epi32(s2, s3));
+        }
+    }
+#elif defined(PREPROCESS_NEON)
+    if (simd)
+    {
+        const uint16_t w0 = (uint16_t) (NV_PREPROCESS_WEIGHT_ONE - weight);
+        const uint16_t w1 = (uint16_t) weight;
+
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t a = vld1q_u8(row0 + i);
+            uint8x16_t b = vld1q_u8(row1 + i);
+            uint16x8_t a_lo = vmovl_u8(vget_low_u8(a));
+            uint16x8_t b_lo = vmovl_u8(vget_low_u8(b));
+            uint16x8_t a_hi = vmovl_u8(vget_high_u8(a));
+            uint16x8_t b_hi = vmovl_u8(vget_high_u8(b));
+            uint32x4_t s0 = vmlal_n_u16(vmull_n_u16(vget_low_u16(a_lo), w0), vget_low_u16(b_lo), w1);
+            uint32x4_t s1 = vmlal_n_u16(vmull_n_u16(vget_high_u16(a_lo), w0), vget_high_u16(b_lo), w1);
+            uint32x4_t s2 = vmlal_n_u16(vmull_n_u16(vget_low_u16(a_hi), w0), vget_low_u16(b_hi), w1);
+            uint32x4_t s3 = vmlal_n_u16(vmull_n_u16(vget_high_u16(a_hi), w0), vget_high_u16(b_hi), w1);
+
+            vst1q_u16(out + i, vcombine_u16(vrshrn_n_u32(s0, 4), vrshrn_n_u32(s1, 4)));
+            vst1q_u16(out + i + 8, vcombine_u16(vrshrn_n_u32(s2, 4), vrshrn_n_u32(s3, 4)));
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        out[i] = (uint16_t) NvPreprocessLerpRows(row0[i], row1[i], weight);
+}
+
+/**
+ * Horizontal bilinear pass of one pixel: blends the first four channels of
+ * two pixels of the vertical pass.
+ */
+static inline void
+lerp_columns(const uint16_t *a, const uint16_t *b, uint32_t weight,
+             uint8_t *out, bool simd)
+{
+#if defined(PREPROCESS_SSE2)
+    if (simd)
+    {
+        __m128i pairs = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) a),
+                                           _mm_loadl_epi64((const __m128i *) b));
+        __m128i sum = _mm_madd_epi16(pairs, _mm_set1_epi32((int) ((weight << 16) |
+                                     (NV_PREPROCESS_WEIGHT_ONE - weight))));
+
+        sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << 17)), 18);
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_packus_epi16(sum, sum);
+        uint32_t packed = (uint32_t) _mm_cvtsi128_si32(sum);
+        memcpy(out, &packed, sizeof(packed));
+        return;
+    }
+#elif defined(PREPROCESS_NEON)
+    if (simd)
+    {
+        uint32x4_t sum = vmull_n_u16(vld1_u16(a), (uint16_t) (NV_PREPROCESS_WEIGHT_ONE - weight));
+        uint16x4_t narrow;
+
+        sum = vmlal_n_u16(sum, vld1_u16(b), (uint16_t) weight);
+        narrow = vmovn_u32(vrshrq_n_u32(sum, 18));
+        uint32_t packed = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(narrow, narrow))), 0);
+        memcpy(out, &packed, sizeof(packed));
+        return;
+    }
+#endif
+
+    for (uint32_t c = 0; c < 4; c++)
+        out[c] = (uint8_t) NvPreprocessLerpColumns(a[c], b[c], weight);
+}
+
+NvPreprocessCpu::NvPreprocessCpu(uint32_t num_threads)
+    : num_threads(num_threads), simd(true), generation(0), pending(0), stop(false),
+      params(NULL), src(NULL), dst(NULL)
+{
+    if (this->num_threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        this->num_threads = cpus > 0 ? (uint32_t) cpus : 1;
+    }
+
+    memset(&geometry, 0, sizeof(geometry));
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+
+    scratch.resize(this->num_threads);
+    worker_args.resize(this->num_threads);
+    for (uint32_t band = 1; band < this->num_threads; band++)
+    {
+        pthread_t thread;
+
+        worker_args[band].owner = this;
+        worker_args[band].band = band;
+        if (pthread_create(&thread, NULL, workerThread, &worker_args[band]) != 0)
+        {
+            /* Run with the threads created so far */
+            this->num_threads = band;
+            break;
+        }
+        workers.push_back(thread);
+    }
+}
+
+NvPreprocessCpu::~NvPreprocessCpu()
+{
+    pthread_mutex_lock(&lock);
+    stop = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+
+    for (size_t i = 0; i < workers.size(); i++)
+        pthread_join(workers[i], NULL);
+
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+void
+NvPreprocessCpu::setSimd(bool enable)
+{
+    simd = enable;
+}
+
+uint32_t
+NvPreprocessCpu::getNumThreads()
+{
+    return num_threads;
+}
+
+int
+NvPreprocessCpu::process(const NvPreprocessParams *params, const uint8_t *src, void *dst)
+{
+    if (params == NULL || src == NULL || dst == NULL ||
+        NvPreprocessGetGeometry(params, &geometry) < 0)
+        return -1;
+
+    this->params = params;
+    this->src = src;
+    this->dst = dst;
+    prepare();
+
+    if (num_threads == 1)
+    {
+        processBand(0);
+        return 0;
+    }
+
+    pthread_mutex_lock(&lock);
+    generation++;
+    pending = num_threads - 1;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+
+    processBand(0);
+
+    pthread_mutex_lock(&lock);
+    while (pending)
+        pthread_cond_wait(&cond, &lock);
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+/**
+ * Computes the column mapping and the conversion tables of the job, once
+ * per image on the calling thread.
+ */
+void
+NvPreprocessCpu::prepare()
+{
+    uint32_t width = geometry.width;
+
+    x0.resize(width);
+    x1.resize(width);
+    wx.resize(width);
+    for (uint32_t x = 0; x < width; x++)
+    {
+        if (params->filter == NV_PREPROCESS_FILTER_BILINEAR)
+        {
+            NvPreprocessMapLinear(x, width, geometry.crop_width, &x0[x], &x1[x], &wx[x]);
+        }
+        else
+        {
+            x0[x] = NvPreprocessMapNearest(x, width, geometry.crop_width);
+            x1[x] = x0[x];
+            wx[x] = 0;
+        }
+    }
+
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        for (uint32_t v = 0; v < 256; v++)
+        {
+            float value = NvPreprocessNormalize(v, params->mean[c], params->scale[c]);
+
+            switch (params->data_type)
+            {
+                case NV_PREPROCESS_TYPE_FP32:
+                    lut_fp32[c][v] = value;
+                    break;
+                case NV_PREPROCESS_TYPE_FP16:
+                    lut_fp16[c][v] = NvPreprocessFloatToHalf(value);
+                    break;
+                case NV_PREPROCESS_TYPE_INT8:
+                    lut_int8[c][v] = NvPreprocessFloatToInt8(value);
+                    break;
+            }
+        }
+    }
+}
+
+/**
+ * Computes the 8-bit samples of one tensor row, in tensor channel order.
+ */
+void
+NvPreprocessCpu::scaleRow(uint32_t y, Scratch &s)
+{
+    uint32_t bpp = NvPreprocessBytesPerPixel(params->src_format);
+    uint32_t dst_width = params->dst_width;
+    uint32_t channel[3];
+    uint8_t *samples = &s.samples[0];
+
+    for (uint32_t c = 0; c < 3; c++)
+        channel[c] = NvPreprocessSourceChannel(params->src_format, params->dst_bgr, c);
+
+    if (y < geometry.top || y >= geometry.top + geometry.height ||
+        geometry.width < dst_width)
+    {
+        for (uint32_t x = 0; x < dst_width; x++)
+            memcpy(samples + x * 3, params->pad, 3);
+        if (y < geometry.top || y >= geometry.top + geometry.height)
+            return;
+    }
+
+    uint32_t row = y - geometry.top;
+    uint8_t *out = samples + geometry.left * 3;
+    const uint8_t *crop = src + geometry.crop_left * bpp;
+
+    if (params->filter != NV_PREPROCESS_FILTER_BILINEAR)
+    {
+        const uint8_t *line = crop + (size_t) (geometry.crop_top +
+            NvPreprocessMapNearest(row, geometry.height, geometry.crop_height)) * params->src_pitch;
+
+        for (uint32_t x = 0; x < geometry.width; x++)
+        {
+            const uint8_t *px = line + x0[x] * bpp;
+
+            out[x * 3] = px[channel[0]];
+            out[x * 3 + 1] = px[channel[1]];
+            out[x * 3 + 2] = px[channel[2]];
+        }
+        return;
+    }
+
+    uint32_t y0;
+    uint32_t y1;
+    uint32_t wy;
+    uint8_t px[4];
+    const uint16_t *rows = &s.rows[0];
+
+    NvPreprocessMapLinear(row, geometry.height, geometry.crop_height, &y0, &y1, &wy);
+    lerp_rows(crop + (size_t) (geometry.crop_top + y0) * params->src_pitch,
+              crop + (size_t) (geometry.crop_top + y1) * params->src_pitch,
+              wy, &s.rows[0], geometry.crop_width * bpp, simd);
+
+    for (uint32_t x = 0; x < geometry.width; x++)
+    {
+        lerp_columns(rows + x0[x] * bpp, rows + x1[x] * bpp, wx[x], px, simd);
+        out[x * 3] = px[channel[0]];
+        out[x * 3 + 1] = px[channel[1]];
+        out[x * 3 + 2] = px[channel[2]];
+    }
+}
+
+template <typename T>
+void
+NvPreprocessCpu::storeRow(uint32_t y, const uint8_t *samples, const T lut[3][256])
+{
+    uint32_t width = params->dst_width;
+
+    if (params->layout == NV_PREPROCESS_LAYOUT_NHWC)
+    {
+        T *out = (T *) dst + (size_t) y * width * 3;
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            out[x * 3] = lut[0][samples[x * 3]];
+            out[x * 3 + 1] = lut[1][samples[x * 3 + 1]];
+            out[x * 3 + 2] = lut[2][samples[x * 3 + 2]];
+        }
+        return;
+    }
+
+    size_t plane = (size_t) width * params->dst_height;
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        T *out = (T *) dst + c * plane + (size_t) y * width;
+
+        for (uint32_t x = 0; x < width; x++)
+            out[x] = lut[c][samples[x * 3 + c]];
+    }
+}
+
+void
+NvPreprocessCpu::processBand(uint32_t band)
+{
+    Scratch &s = scratch[band];
+    uint32_t height = params->dst_height;
+    uint32_t first = (uint32_t) ((uint64_t) height * band / num_threads);
+    uint32_t last = (uint32_t) ((uint64_t) height * (band + 1) / num_threads);
+    size_t row_size = (size_t) geometry.crop_width * NvPreprocessBytesPerPixel(params->src_format);
+
+    /* Grows only, the scratch rows are reused across images */
+    if (s.rows.size() < row_size + ROW_SLACK)
+        s.rows.resize(row_size + ROW_SLACK);
+    if (s.samples.size() < (size_t) params->dst_width * 3 + ROW_SLACK)
+        s.samples.resize((size_t) params->dst_width * 3 + ROW_SLACK);
+
+    for (uint32_t y = first; y < last; y++)
+    {
+        scaleRow(y, s);
+        switch (params->data_type)
+        {
+            case NV_PREPROCESS_TYPE_FP32:
+                storeRow<float>(y, &s.samples[0], lut_fp32);
+                break;
+            case NV_PREPROCESS_TYPE_FP16:
+                storeRow<uint16_t>(y, &s.samples[0], lut_fp16);
+                break;
+            case NV_PREPROCESS_TYPE_INT8:
+                storeRow<int8_t>(y, &s.samples[0], lut_int8);
+                break;
+        }
+    }
+}
+
+void *
+NvPreprocessCpu::workerThread(void *arg)
+{
+    WorkerArg *worker = (WorkerArg *) arg;
+    NvPreprocessCpu *owner = worker->owner;
+    uint64_t seen = 0;
+
+    NvThreadPolicy::getInstance().applyToCurrentThread("preprocess");
+
+    pthread_mutex_lock(&owner->lock);
+    while (true)
+    {
+        while (!owner->stop && owner->generation == seen)
+            pthread_cond_wait(&owner->cond, &owner->lock);
+        if (owner->stop)
+            break;
+        seen = owner->generation;
+        pthread_mutex_unlock(&owner->lock);
+
+        owner->processBand(worker->band);
+
+        pthread_mutex_lock(&owner->lock);
+        if (--owner->pending == 0)
+            pthread_cond_broadcast(&owner->cond);
+    }
+    pthread_mutex_unlock(&owner->lock);
+    return NULL;
+}
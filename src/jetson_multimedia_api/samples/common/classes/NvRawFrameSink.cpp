@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvRawFrameSink.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+using namespace std;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Writes a whole block, retrying partial writes. Keeps errno on failure. */
+static int
+write_all(int fd, const uint8_t *data, size_t length, uint64_t *num_writes)
+{
+    while (length)
+    {
+        ssize_t written = write(fd, data, length);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        (*num_writes)++;
+        data += written;
+        length -= written;
+    }
+    return 0;
+}
+
+NvRawFrameSink::NvRawFrameSink(const NvRawFrameSinkOps &ops)
+    : ops(ops)
+    , fd(-1)
+    , direct(false)
+    , staging(NULL)
+    , staging_used(0)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+NvRawFrameSink::~NvRawFrameSink()
+{
+    close();
+}
+
+int
+NvRawFrameSink::open(const char *path, bool direct_io)
+{
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+    if (fd >= 0)
+        close();
+
+    if (direct_io)
+    {
+        fd = ::open(path, flags | O_DIRECT, 0644);
+        if (fd >= 0)
+            direct = true;
+        else if (errno == EINVAL)
+            cerr << "O_DIRECT is not supported for " << path <<
+                ", using buffered writes" << endl;
+    }
+    if (fd < 0)
+        fd = ::open(path, flags, 0644);
+    if (fd < 0)
+    {
+        cerr << "Could not open " << path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    if (direct)
+    {
+        void *buffer = NULL;
+
+        if (posix_memalign(&buffer, DirectAlignment, DirectChunkSize))
+        {
+            cerr << "Could not allocate the direct I/O staging buffer" << endl;
+            disableDirect();
+        }
+        staging = (uint8_t *) buffer;
+    }
+    staging_used = 0;
+    return 0;
+}
+
+int
+NvRawFrameSink::close()
+{
+    int ret = 0;
+
+    clearCache();
+
+    if (fd >= 0)
+    {
+        /* The tail is not a multiple of the block size */
+        if (staging_used && (disableDirect() < 0 || flushStaging() < 0))
+            ret = -1;
+        if (::close(fd))
+            ret = -1;
+        fd = -1;
+    }
+
+    direct = false;
+    free(staging);
+    staging = NULL;
+    staging_used = 0;
+    return ret;
+}
+
+NvRawFrameMapping *
+NvRawFrameSink::lookup(int buffer_fd)
+{
+    map<int, NvRawFrameMapping>::iterator it = mappings.find(buffer_fd);
+    NvRawFrameMapping mapping;
+
+    if (it != mappings.end())
+        return &it->second;
+
+    memset(&mapping, 0, sizeof(mapping));
+    if (ops.map(buffer_fd, &mapping, ops.arg) < 0)
+        return NULL;
+    if (mapping.num_planes == 0 || mapping.num_planes > NV_RAW_FRAME_SINK_MAX_PLANES)
+    {
+        ops.unmap(&mapping, ops.arg);
+        return NULL;
+    }
+
+    stats.num_maps++;
+    return &(mappings[buffer_fd] = mapping);
+}
+
+int
+NvRawFrameSink::writeFrame(int buffer_fd)
+{
+    uint64_t start = get_time_usec();
+    NvRawFrameMapping *mapping;
+    uint64_t bytes = 0;
+    int ret;
+
+    if (fd < 0)
+        return -1;
+
+    mapping = lookup(buffer_fd);
+    if (mapping == NULL)
+    {
+        cerr << "Could not map buffer " << buffer_fd << endl;
+        return -1;
+    }
+    if (ops.sync && ops.sync(mapping, ops.arg) < 0)
+    {
+        cerr << "Could not sync buffer " << buffer_fd << endl;
+        return -1;
+    }
+
+    /* One entry per row, rows that follow each other in memory are merged */
+    iov.clear();
+    for (uint32_t p = 0; p < mapping->num_planes; p++)
+    {
+        const uint32_t row_bytes = mapping->row_bytes[p];
+
+        if (row_bytes == 0)
+            continue;
+        for (uint32_t y = 0; y < mapping->height[p]; y++)
+        {
+            uint8_t *row = mapping->planes[p] + (size_t) y * mapping->pitch[p];
+
+            if (!iov.empty() &&
+                (uint8_t *) iov.back().iov_base + iov.back().iov_len == row)
+            {
+                iov.back().iov_len += row_bytes;
+            }
+            else
+            {
+                struct iovec entry;
+
+                entry.iov_base = row;
+                entry.iov_len = row_bytes;
+                iov.push_back(entry);
+            }
+            bytes += row_bytes;
+        }
+    }
+
+    ret = direct ? writeDirect() : writeVectored();
+    if (ret == 0)
+    {
+        stats.num_frames++;
+        stats.num_bytes += bytes;
+    }
+    stats.write_usec += get_time_usec() - start;
+    return ret;
+}
+
+int
+NvRawFrameSink::writeVectored()
+{
+    size_t first = 0;
+
+    while (first < iov.size())
+    {
+        int count = iov.size() - first < IOV_MAX ? iov.size() - first : IOV_MAX;
+        ssize_t written = writev(fd, &iov[first], count);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            cerr << "Write failed: " << strerror(errno) << endl;
+            return -1;
+        }
+        stats.num_writes++;
+
+        /* Skip the entries written, and resume a partially written one */
+        while (first < iov.size() && (size_t) written >= iov[first].iov_len)
+        {
+            written -= iov[first].iov_len;
+            first++;
+        }
+        if (written)
+        {
+            iov[first].iov_base = (uint8_t *) iov[first].iov_base + written;
+            iov[first].iov_len -= written;
+        }
+    }
+    return 0;
+}
+
+int
+NvRawFrameSink::writeDirect()
+{
+    for (size_t i = 0; i < iov.size(); i++)
+    {
+        const uint8_t *data = (const uint8_t *) iov[i].iov_base;
+        size_t length = iov[i].iov_len;
+
+        while (length)
+        {
+            size_t chunk = DirectChunkSize - staging_used;
+
+            if (chunk > length)
+                chunk = length;
+            memcpy(staging + staging_used, data, chunk);
+            staging_used += chunk;
+            data += chunk;
+            length -= chunk;
+
+            if (staging_used == DirectChunkSize && flushStaging() < 0)
+                return -1;
+        }
+    }
+
+    /* Direct I/O was turned off by a failed write, keep the file in order */
+    if (!direct && staging_used)
+        return flushStaging();
+    return 0;
+}
+
+int
+NvRawFrameSink::flushStaging()
+{
+    int ret = write_all(fd, staging, staging_used, &stats.num_writes);
+
+    /* Some file systems accept O_DIRECT on open but not on write */
+    if (ret < 0 && errno == EINVAL && direct)
+    {
+        cerr << "O_DIRECT write failed, using buffered writes" << endl;
+        if (disableDirect() == 0)
+            ret = write_all(fd, staging, staging_used, &stats.num_writes);
+    }
+    if (ret < 0)
+    {
+        cerr << "Write failed: " << strerror(errno) << endl;
+        return -1;
+    }
+    staging_used = 0;
+    return 0;
+}
+
+int
+NvRawFrameSink::disableDirect()
+{
+    int flags;
+
+    if (!direct)
+        return 0;
+    direct = false;
+
+    flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags & ~O_DIRECT) < 0)
+    {
+        cerr << "Could not disable O_DIRECT: " << strerror(errno) << endl;
+        return -1;
+    }
+    return 0;
+}
+
+void
+NvRawFrameSink::forget(int buffer_fd)
+{
+    map<int, NvRawFrameMapping>::iterator it = mappings.find(buffer_fd);
+
+    if (it == mappings.end())
+        return;
+    ops.unmap(&it->second, ops.arg);
+    mappings.erase(it);
+}
+
+void
+NvRawFrameSink::clearCache()
+{
+    for (map<int, NvRawFrameMapping>::iterator it = mappings.begin();
+         it != mappings.end(); ++it)
+        ops.unmap(&it->second, ops.arg);
+    mappings.clear();
+}
+
+bool
+NvRawFrameSink::isDirect()
+{
+    return direct;
+}
+
+void
+NvRawFrameSink::getStats(NvRawFrameSinkStats *stats)
+{
+    *stats = this->stats;
+}
+
+void
+NvRawFrameSink::printStats(ostream &outstream)
+{
+    outstream << "----------- Raw frame sink -----------" << endl;
+    outstream << "Frames: " << stats.num_frames <<
+        ", bytes: " << stats.num_bytes <<
+        ", buffers mapped: " << stats.num_maps <<
+        ", write calls: " << stats.num_writes << endl;
+    if (stats.num_frames && stats.write_usec)
+        outstream << "Time per frame: " <<
+            (double) stats.write_usec / stats.num_frames << " us, " <<
+            (double) stats.num_bytes / stats.write_usec << " MB/s" << endl;
+}
@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvThreadPolicy.h"
+#include <errno.h>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define POLICY_ENV "NV_THREAD_POLICY"
+#define POLICY_FILE_ENV "NV_THREAD_POLICY_FILE"
+#define POLICY_MLOCK_ENV "NV_THREAD_POLICY_MLOCK"
+#define DEFAULT_ROLE "*"
+#define MAX_RESULTS 256
+
+using namespace std;
+
+static const char *
+sched_policy_name(int policy)
+{
+    switch (policy)
+    {
+        case SCHED_OTHER:
+            return "other";
+        case SCHED_FIFO:
+            return "fifo";
+        case SCHED_RR:
+            return "rr";
+        default:
+            return "unchanged";
+    }
+}
+
+static string
+cpu_set_to_string(const cpu_set_t &cpus)
+{
+    ostringstream str;
+    int cpu, last = -2, start = -1;
+
+    for (cpu = 0; cpu <= CPU_SETSIZE; cpu++)
+    {
+        bool set = cpu < CPU_SETSIZE && CPU_ISSET(cpu, &cpus);
+        if (set && start < 0)
+        {
+            start = cpu;
+        }
+        else if (!set && start >= 0)
+        {
+            if (last >= 0)
+                str << ",";
+            str << start;
+            if (cpu - 1 > start)
+                str << "-" << cpu - 1;
+            last = cpu - 1;
+            start = -1;
+        }
+    }
+    return str.str();
+}
+
+static int
+parse_cpu_list(const string &list, cpu_set_t &cpus)
+{
+    istringstream str(list);
+    string range;
+
+    CPU_ZERO(&cpus);
+    while (getline(str, range, ','))
+    {
+        int first, last;
+        char dash;
+        istringstream range_str(range);
+
+        if (!(range_str >> first))
+            return -1;
+        last = first;
+        if (range_str >> dash)
+        {
+            if (dash != '-' || !(range_str >> last))
+                return -1;
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE)
+            return -1;
+        for (int cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, &cpus);
+    }
+    return CPU_COUNT(&cpus) ? 0 : -1;
+}
+
+NvThreadPolicy::NvThreadPolicy()
+{
+    const char *env;
+
+    pthread_mutex_init(&lock, NULL);
+    memory_locked = false;
+
+    env = getenv(POLICY_FILE_ENV);
+    if (env)
+        loadConfigFile(env);
+
+    env = getenv(POLICY_ENV);
+    if (env)
+        loadConfig(env);
+
+    env = getenv(POLICY_MLOCK_ENV);
+    if (env && atoi(env))
+        lockMemory();
+}
+
+NvThreadPolicy&
+NvThreadPolicy::getInstance()
+{
+    static NvThreadPolicy policy;
+    return policy;
+}
+
+int
+NvThreadPolicy::parseRole(const string &spec, NvThreadRolePolicy &policy)
+{
+    size_t colon = spec.find(':');
+    vector<string> settings;
+    istringstream str;
+    string token;
+
+    policy.role = spec.substr(0, colon);
+    policy.has_cpus = false;
+    CPU_ZERO(&policy.cpus);
+    policy.sched_policy = -1;
+    policy.priority = 0;
+    policy.has_nice = false;
+    policy.nice = 0;
+
+    if (policy.role.empty() || colon == string::npos)
+        return -1;
+
+    /* The CPU list is itself comma separated, so a token without '=' continues
+     * the value of the previous setting. */
+    str.str(spec.substr(colon + 1));
+    while (getline(str, token, ','))
+    {
+        if (token.find('=') == string::npos && !settings.empty())
+            settings.back().append(",").append(token);
+        else
+            settings.push_back(token);
+    }
+
+    for (size_t i = 0; i < settings.size(); i++)
+    {
+        size_t eq = settings[i].find('=');
+        string key, value;
+
+        if (eq == string::npos)
+            return -1;
+        key = settings[i].substr(0, eq);
+        value = settings[i].substr(eq + 1);
+
+        if (key == "cpus")
+        {
+            if (parse_cpu_list(value, policy.cpus) < 0)
+                return -1;
+            policy.has_cpus = true;
+        }
+        else if (key == "policy")
+        {
+            if (value == "other")
+                policy.sched_policy = SCHED_OTHER;
+            else if (value == "fifo")
+                policy.sched_policy = SCHED_FIFO;
+            else if (value == "rr")
+                policy.sched_policy = SCHED_RR;
+            else
+                return -1;
+        }
+        else if (key == "priority")
+        {
+            policy.priority = atoi(value.c_str());
+        }
+        else if (key == "nice")
+        {
+            policy.nice = atoi(value.c_str());
+            policy.has_nice = true;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    if (policy.sched_policy == SCHED_FIFO || policy.sched_policy == SCHED_RR)
+    {
+        if (policy.priority < sched_get_priority_min(policy.sched_policy) ||
+                policy.priority > sched_get_priority_max(policy.sched_policy))
+            return -1;
+    }
+
+    return 0;
+}
+
+int
+NvThreadPolicy::loadConfig(const char *spec)
+{
+    istringstream str(spec);
+    string role_spec;
+    int ret = 0;
+
+    while (getline(str, role_spec, ';'))
+    {
+        NvThreadRolePolicy policy;
+        size_t i;
+
+        role_spec.erase(0, role_spec.find_first_not_of(" \t"));
+        role_spec.erase(role_spec.find_last_not_of(" \t\r") + 1);
+        if (role_spec.empty() || role_spec[0] == '#')
+            continue;
+
+        if (parseRole(role_spec, policy) < 0)
+        {
+            cerr << "Invalid thread policy \"" << role_spec << "\"" << endl;
+            ret = -1;
+            continue;
+        }
+
+        pthread_mutex_lock(&lock);
+        for (i = 0; i < policies.size(); i++)
+        {
+            if (policies[i].role == policy.role)
+                break;
+        }
+        if (i < policies.size())
+            policies[i] = policy;
+        else
+            policies.push_back(policy);
+        pthread_mutex_unlock(&lock);
+    }
+
+    return ret;
+}
+
+int
+NvThreadPolicy::loadConfigFile(const char *path)
+{
+    ifstream file(path);
+    string line;
+    int ret = 0;
+
+    if (!file.is_open())
+    {
+        cerr << "Could not open thread policy file " << path << endl;
+        return -1;
+    }
+
+    while (getline(file, line))
+    {
+        if (loadConfig(line.c_str()) < 0)
+            ret = -1;
+    }
+    return ret;
+}
+
+void
+NvThreadPolicy::clear()
+{
+    pthread_mutex_lock(&lock);
+    policies.clear();
+    pthread_mutex_unlock(&lock);
+}
+
+bool
+NvThreadPolicy::isConfigured()
+{
+    bool configured;
+
+    pthread_mutex_lock(&lock);
+    configured = !policies.empty();
+    pthread_mutex_unlock(&lock);
+
+    return configured;
+}
+
+int
+NvThreadPolicy::lockMemory()
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+    {
+        cerr << "Failed to lock memory: " << strerror(errno) << endl;
+        return -1;
+    }
+    memory_locked = true;
+    return 0;
+}
+
+bool
+NvThreadPolicy::getRolePolicy(const char *role, NvThreadRolePolicy &policy)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&lock);
+    for (size_t i = 0; i < policies.size(); i++)
+    {
+        if (policies[i].role == role)
+        {
+            policy = policies[i];
+            found = true;
+            break;
+        }
+        if (policies[i].role == DEFAULT_ROLE)
+        {
+            policy = policies[i];
+            found = true;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    return found;
+}
+
+int
+NvThreadPolicy::applyToCurrentThread(const char *role)
+{
+    NvThreadRolePolicy policy;
+    NvThreadPolicyResult result;
+    struct sched_param param;
+
+    if (!getRolePolicy(role, policy))
+        return 0;
+
+    result.tid = syscall(SYS_gettid);
+    result.role = role;
+    result.policy_role = policy.role;
+    result.error = 0;
+
+    if (policy.has_cpus &&
+            pthread_setaffinity_np(pthread_self(), sizeof(policy.cpus), &policy.cpus))
+    {
+        result.error = EINVAL;
+    }
+
+    if (policy.sched_policy >= 0)
+    {
+        memset(&param, 0, sizeof(param));
+        if (policy.sched_policy != SCHED_OTHER)
+            param.sched_priority = policy.priority;
+        int err = pthread_setschedparam(pthread_self(), policy.sched_policy, &param);
+        if (err && !result.error)
+            result.error = err;
+    }
+
+    /* The nice value is per thread on Linux, set it through the TID. */
+    if (policy.has_nice &&
+            setpriority(PRIO_PROCESS, result.tid, policy.nice) < 0 && !result.error)
+    {
+        result.error = errno;
+    }
+
+    CPU_ZERO(&result.cpus);
+    pthread_getaffinity_np(pthread_self(), sizeof(result.cpus), &result.cpus);
+    pthread_getschedparam(pthread_self(), &result.sched_policy, &param);
+    result.priority = param.sched_priority;
+    errno = 0;
+    result.nice = getpriority(PRIO_PROCESS, result.tid);
+
+    if (result.error)
+    {
+        cerr << "Thread policy for role " << role << " partially applied: " <<
+            strerror(result.error) << endl;
+    }
+
+    /* Keep one result per thread, and drop the oldest threads when short
+     * lived ones keep coming. */
+    pthread_mutex_lock(&lock);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i].tid == result.tid)
+        {
+            results.erase(results.begin() + i);
+            break;
+        }
+    }
+    if (results.size() >= MAX_RESULTS)
+        results.erase(results.begin());
+    results.push_back(result);
+    pthread_mutex_unlock(&lock);
+
+    return result.error ? -1 : 0;
+}
+
+void
+NvThreadPolicy::getResults(std::vector<NvThreadPolicyResult> &out_results)
+{
+    pthread_mutex_lock(&lock);
+    out_results = results;
+    pthread_mutex_unlock(&lock);
+}
+
+void
+NvThreadPolicy::printPolicy(std::ostream &outstream)
+{
+    pthread_mutex_lock(&lock);
+    outstream << "************************************" << endl;
+    outstream << "Memory locked = " << (memory_locked ? "yes" : "no") << endl;
+    for (size_t i = 0; i < policies.size(); i++)
+    {
+        const NvThreadRolePolicy &policy = policies[i];
+        outstream << "Role " << policy.role << ": cpus=" <<
+            (policy.has_cpus ? cpu_set_to_string(policy.cpus) : "unchanged") <<
+            " policy=" << sched_policy_name(policy.sched_policy);
+        if (policy.sched_policy == SCHED_FIFO || policy.sched_policy == SCHED_RR)
+            outstream << " priority=" << policy.priority;
+        if (policy.has_nice)
+            outstream << " nice=" << policy.nice;
+        outstream << endl;
+    }
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const NvThreadPolicyResult &result = results[i];
+        outstream << "Thread " << result.tid << " [" << result.role << " -> " <<
+            result.policy_role << "]: cpus=" << cpu_set_to_string(result.cpus) <<
+            " policy=" << sched_policy_name(result.sched_policy) <<
+            " priority=" << result.priority << " nice=" << result.nice;
+        if (result.error)
+            outstream << " (" << strerror(result.error) << ")";
+        outstream << endl;
+    }
+    outstream << "************************************" << endl;
+    pthread_mutex_unlock(&lock);
+}
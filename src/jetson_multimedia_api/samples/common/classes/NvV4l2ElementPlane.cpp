@@ -28,6 +28,7 @@
 
 #include "NvV4l2ElementPlane.h"
 #include "NvLogging.h"
+#include "NvThreadPolicy.h"
 
 #include <cstring>
 #include <errno.h>
@@ -812,6 +813,7 @@ NvV4l2ElementPlane::dqThread(void *data)
 
     PLANE_DEBUG_MSG("Starting DQthread");
     prctl (PR_SET_NAME, plane_name, 0, 0, 0);
+    NvThreadPolicy::getInstance().applyToCurrentThread("dq");
     plane->stop_dqthread = false;
     while (!plane->stop_dqthread)
     {
@@ -36,6 +36,7 @@
 #include "Error.h"
 #include "NvCudaProc.h"
 #include "NvEglRenderer.h"
+#include "NvThreadPolicy.h"
 
 #define TIMESPEC_DIFF_USEC(timespec1, timespec2) \
     (((timespec1)->tv_sec - (timespec2)->tv_sec) * 1000000L + \
@@ -201,6 +202,8 @@ bool TRTStreamConsumer::RenderThreadProc()
 {
     Log("Render thread started.\n");
 
+    NvThreadPolicy::getInstance().applyToCurrentThread("render");
+
     // Start profiling
     if (m_eglRenderer)
         m_eglRenderer->enableProfiling();
@@ -294,6 +297,8 @@ bool TRTStreamConsumer::TRTThreadProc()
 {
     Log("TRT thread started.\n");
 
+    NvThreadPolicy::getInstance().applyToCurrentThread("trt");
+
     unsigned bufNumInBatch = 0;
     int class_num = 0;
     int classCnt = m_TRTContext.getModelClassCnt();
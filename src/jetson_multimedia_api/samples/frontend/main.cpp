@@ -38,6 +38,7 @@
 #endif
 #include "Error.h"
 #include "NvEglRenderer.h"
+#include "NvThreadPolicy.h"
 
 //
 // This demo creates four camera input streams of different resolutions.
@@ -363,5 +364,8 @@ int main(int argc, char **argv)
     if (g_eglRenderer)
         delete g_eglRenderer;
 
+    if (NvThreadPolicy::getInstance().isConfigured())
+        NvThreadPolicy::getInstance().printPolicy();
+
     return 0;
 }
@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./argus_replay_sample [-f <fps>] [-n <frames>] [-s <width>x<height>]
+ * Example:
+ * ./argus_replay_sample
+ * ./argus_replay_sample -f 120 -s 1920x1080
+**/
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "argus_replay_unit_sample.hpp"
+
+/**
+ * Software CameraProvider.
+ *
+ * libargusreplay implements the CameraProvider, CaptureSession and
+ * FrameConsumer subset used by the Argus samples and plays a test pattern
+ * or a raw YUV file at the sensor frame rate, so consumer code can be run
+ * and profiled on a host without a camera or a GPU.
+ *
+ * This sample runs consumer loops against it and checks:
+ * ## FIFO streams deliver every frame, in order, with metadata
+ * ## A consumer holding every buffer stalls the capture, which resumes
+ * ## Mailbox streams replace frames a slow consumer did not acquire
+ * ## Injected sensor drops leave gaps and raise error events
+ * ## capture() snapshots the request, and the metadata reports it
+ * ## stopRepeat() reports the repeated captures
+ * ## Frames of a replay file are scaled to the stream resolution
+ *
+ * The consumer time per frame is the CPU time of the consumer loop,
+ * so it excludes the time spent waiting for frames.
+**/
+
+using namespace Argus;
+using namespace ArgusSamples;
+
+#define DEFAULT_FPS 500
+#define DEFAULT_FRAMES 200
+#define DEFAULT_WIDTH 640
+#define DEFAULT_HEIGHT 480
+#define FRAME_TIMEOUT 1000000000ull
+
+static uint64_t
+get_cpu_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Options of a test, independent of the ARGUS_REPLAY_* environment */
+static Replay::Options
+test_options(uint32_t fps, const Size2D<uint32_t> &resolution)
+{
+    Replay::Options options;
+
+    options.file.clear();
+    options.resolution = resolution;
+    options.frameDuration = 1000000000ull / fps;
+    options.jitter = 0;
+    options.dropInterval = 0;
+    options.dropRate = 0.0f;
+    options.numDevices = 1;
+    options.stallWarning = 50000000;
+    options.printStats = false;
+    return options;
+}
+
+static bool
+open_context(replay_context &ctx, const Replay::Options &options, const EGLStreamMode &mode,
+             uint32_t fifo_length, const Size2D<uint32_t> &resolution)
+{
+    vector<CameraDevice *> devices;
+    vector<EventType> event_types;
+
+    memset(&ctx, 0, sizeof(ctx));
+    Replay::setOptions(options);
+    Replay::resetStats();
+
+    ctx.provider = CameraProvider::create();
+    ICameraProvider *iProvider = interface_cast<ICameraProvider>(ctx.provider);
+    if (!iProvider || iProvider->getCameraDevices(&devices) != STATUS_OK || devices.empty())
+        return false;
+
+    ctx.session = iProvider->createCaptureSession(devices[0]);
+    ICaptureSession *iSession = interface_cast<ICaptureSession>(ctx.session);
+    if (!iSession)
+        return false;
+
+    OutputStreamSettings *settings = iSession->createOutputStreamSettings(STREAM_TYPE_EGL);
+    IEGLOutputStreamSettings *iSettings = interface_cast<IEGLOutputStreamSettings>(settings);
+    if (!iSettings)
+        return false;
+    iSettings->setPixelFormat(PIXEL_FMT_YCbCr_420_888);
+    iSettings->setResolution(resolution);
+    iSettings->setMode(mode);
+    iSettings->setFifoLength(fifo_length);
+    iSettings->setMetadataEnable(true);
+    ctx.stream = iSession->createOutputStream(settings);
+    settings->destroy();
+    if (!ctx.stream)
+        return false;
+
+    ctx.consumer = EGLStream::FrameConsumer::create(ctx.stream);
+    if (!ctx.consumer ||
+        interface_cast<IEGLOutputStream>(ctx.stream)->waitUntilConnected() != STATUS_OK)
+        return false;
+
+    ctx.request = iSession->createRequest();
+    IRequest *iRequest = interface_cast<IRequest>(ctx.request);
+    if (!iRequest || iRequest->enableOutputStream(ctx.stream) != STATUS_OK)
+        return false;
+
+    event_types.push_back(EVENT_TYPE_CAPTURE_COMPLETE);
+    event_types.push_back(EVENT_TYPE_ERROR);
+    ctx.queue = interface_cast<IEventProvider>(ctx.session)->createEventQueue(event_types);
+    return ctx.queue != NULL;
+}
+
+static void
+close_context(replay_context &ctx)
+{
+    ICaptureSession *iSession = interface_cast<ICaptureSession>(ctx.session);
+
+    if (iSession)
+    {
+        iSession->stopRepeat();
+        iSession->cancelRequests();
+        iSession->waitForIdle();
+    }
+    if (ctx.queue)
+        ctx.queue->destroy();
+    if (ctx.request)
+        ctx.request->destroy();
+    if (ctx.stream)
+        ctx.stream->destroy();
+    if (ctx.consumer)
+        ctx.consumer->destroy();
+    if (ctx.session)
+        ctx.session->destroy();
+    if (ctx.provider)
+        ctx.provider->destroy();
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+/* Reads the frame like a CPU consumer: every 64th luma byte of each row */
+static uint8_t
+read_frame(EGLStream::Frame *frame, uint32_t &checksum)
+{
+    EGLStream::IImage *iImage =
+        interface_cast<EGLStream::IImage>(interface_cast<EGLStream::IFrame>(frame)->getImage());
+    EGLStream::IImage2D *iImage2D =
+        interface_cast<EGLStream::IImage2D>(interface_cast<EGLStream::IFrame>(frame)->getImage());
+    const uint8_t *luma = (const uint8_t *) iImage->mapBuffer((uint32_t) 0);
+    Size2D<uint32_t> size = iImage2D->getSize(0);
+    uint32_t stride = iImage2D->getStride(0);
+
+    for (uint32_t y = 0; y < size.height(); y++)
+        for (uint32_t x = 0; x < size.width(); x += 64)
+            checksum += luma[y * stride + x];
+    return luma[0];
+}
+
+static bool
+consume_frames(replay_context &ctx, uint32_t num_frames, uint32_t work_usec,
+               consumed_frames &frames)
+{
+    EGLStream::IFrameConsumer *iConsumer = interface_cast<EGLStream::IFrameConsumer>(ctx.consumer);
+    uint64_t cpu_start = get_cpu_usec();
+    uint32_t checksum = 0;
+
+    frames.metadata_mismatches = 0;
+    for (uint32_t i = 0; i < num_frames; i++)
+    {
+        EGLStream::Frame *frame = iConsumer->acquireFrame(FRAME_TIMEOUT);
+        EGLStream::IFrame *iFrame = interface_cast<EGLStream::IFrame>(frame);
+        if (!iFrame)
+            return false;
+
+        EGLStream::IArgusCaptureMetadata *iArgusMetadata =
+            interface_cast<EGLStream::IArgusCaptureMetadata>(frame);
+        ICaptureMetadata *iMetadata = iArgusMetadata ?
+            interface_cast<ICaptureMetadata>(iArgusMetadata->getMetadata()) : NULL;
+        if (!iMetadata || iMetadata->getCaptureId() != iFrame->getNumber())
+            frames.metadata_mismatches++;
+
+        frames.numbers.push_back(iFrame->getNumber());
+        frames.timestamps.push_back(iFrame->getTime());
+        frames.lumas.push_back(read_frame(frame, checksum));
+
+        if (work_usec)
+            usleep(work_usec);
+        frame->destroy();
+    }
+    frames.cpu_usec = get_cpu_usec() - cpu_start;
+    return true;
+}
+
+static bool
+numbers_consecutive(const vector<uint64_t> &numbers)
+{
+    for (size_t i = 1; i < numbers.size(); i++)
+        if (numbers[i] != numbers[i - 1] + 1)
+            return false;
+    return true;
+}
+
+static bool
+numbers_increasing(const vector<uint64_t> &numbers, uint32_t &gaps)
+{
+    gaps = 0;
+    for (size_t i = 1; i < numbers.size(); i++)
+    {
+        if (numbers[i] <= numbers[i - 1])
+            return false;
+        if (numbers[i] != numbers[i - 1] + 1)
+            gaps++;
+    }
+    return true;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const consumed_frames &frames, bool ok)
+{
+    const Replay::Stats stats = Replay::getStats();
+
+    table.row(name, ok) << frames.numbers.size() << stats.dropped << stats.overwritten <<
+        stats.stalls << stats.stallTime / 1e6 <<
+        (frames.numbers.empty() ? 0.0 : (double) frames.cpu_usec / frames.numbers.size());
+}
+
+/* Collects the events of the captures that completed so far */
+static void
+collect_events(replay_context &ctx, vector<const Event *> &events)
+{
+    IEventProvider *iEventProvider = interface_cast<IEventProvider>(ctx.session);
+    IEventQueue *iQueue = interface_cast<IEventQueue>(ctx.queue);
+
+    events.clear();
+    iEventProvider->waitForEvents(ctx.queue, 0);
+    for (uint32_t i = 0; i < iQueue->getSize(); i++)
+        events.push_back(iQueue->getEvent(i));
+}
+
+/* Mean luma of a capture according to its histogram */
+static double
+histogram_mean(const CaptureMetadata *metadata, uint32_t &samples)
+{
+    const IBayerHistogram *iHistogram = interface_cast<const IBayerHistogram>(
+        interface_cast<const ICaptureMetadata>(metadata)->getBayerHistogram());
+    vector< BayerTuple<uint32_t> > histogram;
+    double sum = 0.0;
+
+    samples = 0;
+    if (!iHistogram || iHistogram->getHistogram(&histogram) != STATUS_OK)
+        return 0.0;
+    for (size_t i = 0; i < histogram.size(); i++)
+    {
+        sum += (double) i * histogram[i].gEven();
+        samples += histogram[i].gEven();
+    }
+    return samples ? sum / samples : 0.0;
+}
+
+static bool
+write_replay_file(const char *path, const Size2D<uint32_t> &size, const uint8_t *lumas,
+                  uint32_t num_frames)
+{
+    FILE *file = fopen(path, "wb");
+    vector<uint8_t> luma(size.area());
+    vector<uint8_t> chroma(size.area() / 4);
+    bool ok = file != NULL;
+
+    for (uint32_t i = 0; ok && i < num_frames; i++)
+    {
+        memset(luma.data(), lumas[i], luma.size());
+        ok = fwrite(luma.data(), 1, luma.size(), file) == luma.size();
+        /* I420: Cb plane then Cr plane */
+        memset(chroma.data(), 100, chroma.size());
+        ok = ok && fwrite(chroma.data(), 1, chroma.size(), file) == chroma.size();
+        memset(chroma.data(), 150, chroma.size());
+        ok = ok && fwrite(chroma.data(), 1, chroma.size(), file) == chroma.size();
+    }
+    if (file)
+        ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./argus_replay_sample");
+    ostringstream default_size;
+    uint32_t fps = DEFAULT_FPS;
+    uint32_t num_frames = DEFAULT_FRAMES;
+    Size2D<uint32_t> resolution(DEFAULT_WIDTH, DEFAULT_HEIGHT);
+    uint64_t frame_duration;
+    int opt;
+
+    default_size << DEFAULT_WIDTH << "x" << DEFAULT_HEIGHT;
+    args.option('f', "<fps>", "Sensor frame rate", DEFAULT_FPS)
+        .option('n', "<frames>", "Frames consumed by the FIFO test", DEFAULT_FRAMES)
+        .option('s', "<w>x<h>", "Sensor and stream resolution", default_size.str());
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'f':
+                fps = atoi(optarg);
+                break;
+            case 'n':
+                num_frames = atoi(optarg);
+                break;
+            case 's':
+                if (!UnitSampleArgs::parseSize(optarg, &resolution.width(),
+                                               &resolution.height()))
+                    resolution = Size2D<uint32_t>(0, 0);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (fps == 0 || num_frames < 2 || resolution.width() < 64 || resolution.height() < 64)
+    {
+        args.printHelp();
+        return -1;
+    }
+    frame_duration = 1000000000ull / fps;
+
+    table.column("frames", 8).column("dropped", 9).column("replaced", 10).column("stalls", 8)
+        .column("stall ms", 11, 1).column("us/frame", 11, 1);
+
+    /* FIFO: every frame, in order, at the sensor rate */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        bool ok;
+
+        ok = open_context(ctx, test_options(fps, resolution), EGL_STREAM_MODE_FIFO, 4,
+                          resolution);
+        ok = ok && interface_cast<ICaptureSession>(ctx.session)->repeat(ctx.request) == STATUS_OK;
+        ok = ok && consume_frames(ctx, num_frames, 0, frames);
+        ok = ok && numbers_consecutive(frames.numbers) && frames.metadata_mismatches == 0;
+        for (size_t i = 1; ok && i < frames.timestamps.size(); i++)
+            ok = frames.timestamps[i] - frames.timestamps[i - 1] >= frame_duration;
+        close_context(ctx);
+        add_result(table, "fifo", frames, ok);
+    }
+
+    /* A consumer holding every buffer stalls the capture */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        vector<EGLStream::Frame *> held;
+        bool ok;
+
+        ok = open_context(ctx, test_options(fps, resolution), EGL_STREAM_MODE_FIFO, 2,
+                          resolution);
+        ok = ok && interface_cast<ICaptureSession>(ctx.session)->repeat(ctx.request) == STATUS_OK;
+        /* FIFO length plus the two buffers in flight */
+        for (uint32_t i = 0; ok && i < 4; i++)
+        {
+            EGLStream::Frame *frame =
+                interface_cast<EGLStream::IFrameConsumer>(ctx.consumer)->acquireFrame(FRAME_TIMEOUT);
+            ok = frame != NULL;
+            if (frame)
+            {
+                frames.numbers.push_back(interface_cast<EGLStream::IFrame>(frame)->getNumber());
+                held.push_back(frame);
+            }
+        }
+        /* Longer than the stall report delay of 50 ms */
+        usleep(150000);
+        for (size_t i = 0; i < held.size(); i++)
+            held[i]->destroy();
+        ok = ok && consume_frames(ctx, 8, 0, frames);
+        ok = ok && numbers_consecutive(frames.numbers);
+        close_context(ctx);
+        ok = ok && Replay::getStats().stalls >= 1 &&
+            Replay::getStats().stallTime >= 100000000ull;
+        add_result(table, "stall", frames, ok);
+    }
+
+    /* Mailbox: a slow consumer sees the latest frame, the others are replaced */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        uint32_t gaps = 0;
+        bool ok;
+
+        ok = open_context(ctx, test_options(fps, resolution), EGL_STREAM_MODE_MAILBOX, 1,
+                          resolution);
+        ok = ok && interface_cast<ICaptureSession>(ctx.session)->repeat(ctx.request) == STATUS_OK;
+        ok = ok && consume_frames(ctx, 20, max<uint64_t>(3 * frame_duration / 1000, 20000), frames);
+        ok = ok && numbers_increasing(frames.numbers, gaps) && gaps > 0;
+        close_context(ctx);
+        ok = ok && Replay::getStats().overwritten > 0 && Replay::getStats().stalls == 0;
+        add_result(table, "mailbox", frames, ok);
+    }
+
+    /* Injected drops: every 4th sensor frame is lost and reported */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        vector<const Event *> events;
+        Replay::Options options = test_options(fps, resolution);
+        uint32_t errors = 0;
+        bool ok;
+
+        options.dropInterval = 4;
+        ok = open_context(ctx, options, EGL_STREAM_MODE_FIFO, 4, resolution);
+        ok = ok && interface_cast<ICaptureSession>(ctx.session)->repeat(ctx.request) == STATUS_OK;
+        ok = ok && consume_frames(ctx, 30, 0, frames);
+        interface_cast<ICaptureSession>(ctx.session)->stopRepeat();
+        interface_cast<ICaptureSession>(ctx.session)->waitForIdle();
+        /* Repeated captures are numbered from 1, one per sensor frame */
+        for (size_t i = 0; ok && i < frames.numbers.size(); i++)
+            ok = frames.numbers[i] % 4 != 0 &&
+                (i == 0 || frames.numbers[i] - frames.numbers[i - 1] ==
+                 (frames.numbers[i] % 4 == 1 ? 2u : 1u));
+        collect_events(ctx, events);
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            const IEvent *iEvent = interface_cast<const IEvent>(events[i]);
+            if (iEvent->getEventType() == EVENT_TYPE_ERROR)
+            {
+                errors++;
+                ok = ok && iEvent->getCaptureId() % 4 == 0 &&
+                    interface_cast<const IEventError>(events[i])->getStatus() == STATUS_CANCELLED;
+            }
+        }
+        close_context(ctx);
+        ok = ok && errors > 0 && errors == Replay::getStats().dropped;
+        add_result(table, "drops", frames, ok);
+    }
+
+    /* capture() snapshots the request; the metadata reports its settings */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        vector<const Event *> events;
+        uint32_t ids[3] = { 0, 0, 0 };
+        double means[3] = { 0.0, 0.0, 0.0 };
+        uint32_t completed = 0;
+        bool ok;
+
+        ok = open_context(ctx, test_options(fps, resolution), EGL_STREAM_MODE_FIFO, 4,
+                          resolution);
+        if (ok)
+        {
+            ICaptureSession *iSession = interface_cast<ICaptureSession>(ctx.session);
+            IRequest *iRequest = interface_cast<IRequest>(ctx.request);
+            ISourceSettings *iSource = interface_cast<ISourceSettings>(iRequest->getSourceSettings());
+            IAutoControlSettings *iAutoControl =
+                interface_cast<IAutoControlSettings>(iRequest->getAutoControlSettings());
+
+            ids[0] = iSession->capture(ctx.request);
+            /* Auto exposure targets 10 ms, limited by the frame duration; double it */
+            iSource->setFrameDurationRange(Range<uint64_t>(40000000));
+            iSource->setExposureTimeRange(Range<uint64_t>(20000000));
+            iSource->setGainRange(Range<float>(1.0f));
+            iAutoControl->setIspDigitalGainRange(Range<float>(1.0f));
+            ids[1] = iSession->capture(ctx.request);
+            iRequest->setClientData(7);
+            ids[2] = iSession->capture(ctx.request);
+            ok = ids[0] && ids[1] == ids[0] + 1 && ids[2] == ids[1] + 1 &&
+                iSession->waitForIdle(FRAME_TIMEOUT) == STATUS_OK;
+        }
+        ok = ok && consume_frames(ctx, 3, 0, frames) && frames.lumas[1] > frames.lumas[0];
+        if (ok)
+        {
+            collect_events(ctx, events);
+            for (size_t i = 0; i < events.size(); i++)
+            {
+                const IEventCaptureComplete *iComplete =
+                    interface_cast<const IEventCaptureComplete>(events[i]);
+                const ICaptureMetadata *iMetadata = iComplete ?
+                    interface_cast<const ICaptureMetadata>(iComplete->getMetadata()) : NULL;
+                uint32_t index = interface_cast<const IEvent>(events[i])->getCaptureId() - ids[0];
+                uint32_t samples;
+
+                if (!iMetadata || index > 2)
+                {
+                    ok = false;
+                    continue;
+                }
+                completed++;
+                means[index] = histogram_mean(iComplete->getMetadata(), samples);
+                ok = ok && samples == 128 * 72 &&
+                    iMetadata->getClientData() == (index == 2 ? 7u : 0u) &&
+                    iMetadata->getSensorExposureTime() ==
+                    (index == 0 ? min<uint64_t>(frame_duration, 10000000) : 20000000ull) &&
+                    (index == 0 || iMetadata->getFrameDuration() == 40000000ull);
+            }
+        }
+        ok = ok && completed == 3 && means[1] > means[0];
+        close_context(ctx);
+        add_result(table, "capture", frames, ok);
+    }
+
+    /* stopRepeat() returns the ids of the repeated captures */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        bool ok;
+
+        ok = open_context(ctx, test_options(fps, resolution), EGL_STREAM_MODE_MAILBOX, 1,
+                          resolution);
+        if (ok)
+        {
+            ICaptureSession *iSession = interface_cast<ICaptureSession>(ctx.session);
+            Range<uint32_t> ids;
+
+            ok = iSession->repeat(ctx.request) == STATUS_OK && iSession->isRepeating();
+            ok = ok && consume_frames(ctx, 5, 0, frames);
+            ids = iSession->stopRepeat();
+            ok = ok && !iSession->isRepeating() &&
+                iSession->waitForIdle(FRAME_TIMEOUT) == STATUS_OK;
+            ok = ok && ids.min() == frames.numbers[0] && ids.max() >= frames.numbers.back();
+            /* Unless it was consumed already, the mailbox holds the last capture */
+            if (ok && ids.max() > frames.numbers.back())
+                ok = consume_frames(ctx, 1, 0, frames) && ids.max() == frames.numbers.back();
+            ok = ok && !interface_cast<EGLStream::IFrameConsumer>(ctx.consumer)->acquireFrame(0);
+        }
+        close_context(ctx);
+        add_result(table, "repeat", frames, ok);
+    }
+
+    /* Replay file frames, scaled to half resolution */
+    {
+        replay_context ctx;
+        consumed_frames frames;
+        const char *path = "argus_replay_sample.i420";
+        const uint8_t lumas[3] = { 40, 80, 120 };
+        Replay::Options options = test_options(fps, Size2D<uint32_t>(128, 96));
+        bool ok;
+
+        options.file = path;
+        options.fileFormat = Replay::FILE_FORMAT_I420;
+        ok = write_replay_file(path, options.resolution, lumas, 3);
+        ok = ok && open_context(ctx, options, EGL_STREAM_MODE_FIFO, 4, Size2D<uint32_t>(64, 48));
+        ok = ok && interface_cast<ICaptureSession>(ctx.session)->repeat(ctx.request) == STATUS_OK;
+        ok = ok && consume_frames(ctx, 6, 0, frames) && numbers_consecutive(frames.numbers);
+        for (size_t i = 0; ok && i < frames.numbers.size(); i++)
+            ok = frames.lumas[i] == lumas[(frames.numbers[i] - 1) % 3];
+        if (ok)
+        {
+            EGLStream::Frame *frame = interface_cast<EGLStream::IFrameConsumer>(ctx.consumer)->
+                acquireFrame(FRAME_TIMEOUT);
+            EGLStream::Image *image = frame ?
+                interface_cast<EGLStream::IFrame>(frame)->getImage() : NULL;
+            EGLStream::IImage2D *iImage2D = interface_cast<EGLStream::IImage2D>(image);
+            EGLStream::IImageHeaderlessFile *iFile =
+                interface_cast<EGLStream::IImageHeaderlessFile>(image);
+            const uint8_t *chroma = iImage2D ?
+                (const uint8_t *) interface_cast<EGLStream::IImage>(image)->mapBuffer((uint32_t) 1) : NULL;
+            struct stat st;
+
+            ok = chroma && iImage2D->getSize(1).width() == 32 && iImage2D->getStride(0) >= 64 &&
+                chroma[0] == 100 && chroma[1] == 150 && iFile &&
+                iFile->writeHeaderlessFile("argus_replay_sample.nv12") == STATUS_OK &&
+                stat("argus_replay_sample.nv12", &st) == 0 && st.st_size == 64 * 48 * 3 / 2;
+            if (frame)
+                frame->destroy();
+            unlink("argus_replay_sample.nv12");
+        }
+        close_context(ctx);
+        unlink(path);
+        add_result(table, "file", frames, ok);
+    }
+
+    cout << "Sensor " << resolution.width() << "x" << resolution.height() << " at " << fps <<
+        " fps" << endl;
+    return table.print() ? 0 : -1;
+}
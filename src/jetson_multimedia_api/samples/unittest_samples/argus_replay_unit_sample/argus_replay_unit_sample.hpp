@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Argus/Argus.h>
+#include <EGLStream/EGLStream.h>
+
+#include "ArgusReplay.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the Argus objects of one replay capture.
+ */
+typedef struct
+{
+    /** Replay camera provider. */
+    Argus::CameraProvider *provider;
+    /** Capture session of the first device. */
+    Argus::CaptureSession *session;
+    /** Output stream of the session. */
+    Argus::OutputStream *stream;
+    /** Consumer of the output stream. */
+    EGLStream::FrameConsumer *consumer;
+    /** Request with the output stream enabled. */
+    Argus::Request *request;
+    /** Queue receiving the capture complete and error events. */
+    Argus::EventQueue *queue;
+} replay_context;
+
+/**
+ * Holds the frames received by a consumer loop.
+ */
+typedef struct
+{
+    /** Frame numbers, in acquisition order. */
+    std::vector<uint64_t> numbers;
+    /** Sensor timestamps, in acquisition order. */
+    std::vector<uint64_t> timestamps;
+    /** Luma of the first pixel, in acquisition order. */
+    std::vector<uint8_t> lumas;
+    /** Frames whose capture id in the metadata did not match the frame number. */
+    uint32_t metadata_mismatches;
+    /** Consumer thread CPU time, in microseconds. */
+    uint64_t cpu_usec;
+} consumed_frames;
+
+/**
+ * @brief Creates a replay session with one output stream and its consumer.
+ *
+ * @param[out] ctx Replay objects
+ * @param[in] options Replay options used to create the provider
+ * @param[in] mode Mode of the output stream
+ * @param[in] fifo_length FIFO length of the output stream
+ * @param[in] resolution Resolution of the output stream
+ * @return true if every object was created
+ */
+static bool open_context(replay_context &ctx, const ArgusSamples::Replay::Options &options,
+                         const Argus::EGLStreamMode &mode, uint32_t fifo_length,
+                         const Argus::Size2D<uint32_t> &resolution);
+
+/**
+ * @brief Stops the captures and destroys the replay objects.
+ *
+ * @param[in] ctx Replay objects
+ */
+static void close_context(replay_context &ctx);
+
+/**
+ * @brief Acquires, reads and releases frames like a sample consumer thread.
+ *
+ * @param[in] ctx Replay objects
+ * @param[in] num_frames Frames to consume
+ * @param[in] work_usec Time spent on each frame while holding it
+ * @param[out] frames Frames received
+ * @return true if all frames were acquired
+ */
+static bool consume_frames(replay_context &ctx, uint32_t num_frames, uint32_t work_usec,
+                           consumed_frames &frames);
@@ -0,0 +1,520 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./batch_transform_sample [-s <streams>] [-n <frames>] [-l <usec>] [-c <usec>]
+ * Example:
+ * ./batch_transform_sample
+ * ./batch_transform_sample -s 32 -l 0 -c 0
+**/
+
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "batch_transform_unit_sample.hpp"
+
+/**
+ * Batched buffer transforms with surface caching.
+ *
+ * NvBufSurf::NvTransform() resolves both FDs and submits one transform per
+ * call. NvBufSurfBatch caches the surfaces and submits runs of compatible
+ * jobs as one batched call. This sample uses the CPU backend,
+ * NvBufSurfCpuTransform, and checks:
+ * ## Nearest crop and 2x downscale of NV12 picks the expected pixels
+ * ## Bilinear at the same size copies the pixels unchanged
+ * ## NV12 to RGBA and back keeps a flat color
+ * ## A batch produces the same pixels as one call per job
+ * ## Jobs are split into calls on filter changes and at the maximum batch size
+ * ## FDs are resolved once, forget() resolves again, an unknown FD fails the
+ *    batch before anything is submitted
+ * ## A rectangle outside the buffer fails
+ *
+ * It then compares one call per job with batches for one small crop and
+ * scale per stream and frame. The FD lookup and call costs of the hardware
+ * path are emulated by the backend with -l and -c.
+**/
+
+#define DEFAULT_STREAMS 16
+#define DEFAULT_FRAMES 100
+#define DEFAULT_LOOKUP_USEC 5
+#define DEFAULT_CALL_USEC 100
+#define MAX_BATCH_SIZE 64
+#define SRC_WIDTH 1920
+#define SRC_HEIGHT 1080
+#define CROP_SIZE 256
+#define TILE_SIZE 64
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int
+allocate_buffer(NvBufSurfCpuTransform &cpu, uint32_t width, uint32_t height,
+                NvBufSurfaceColorFormat format)
+{
+    NvBufSurf::NvCommonAllocateParams params;
+    int fd = -1;
+
+    memset(&params, 0, sizeof(params));
+    params.width = width;
+    params.height = height;
+    params.colorFormat = format;
+    params.layout = NVBUF_LAYOUT_PITCH;
+    params.memType = NVBUF_MEM_SYSTEM;
+    if (cpu.allocate(&params, 1, &fd) < 0)
+        return -1;
+    return fd;
+}
+
+static uint8_t
+luma_at(uint32_t x, uint32_t y, uint32_t seed)
+{
+    return (uint8_t) (x * 3 + y * 7 + seed * 11);
+}
+
+static void
+fill_nv12(NvBufSurfCpuTransform &cpu, int fd, uint32_t seed)
+{
+    NvBufSurfaceParams &s = cpu.getSurface(fd)->surfaceList[0];
+    NvBufSurfacePlaneParams &p = s.planeParams;
+
+    for (uint32_t y = 0; y < p.height[0]; y++)
+    {
+        uint8_t *row = (uint8_t *) s.mappedAddr.addr[0] + y * p.pitch[0];
+        for (uint32_t x = 0; x < p.width[0]; x++)
+            row[x] = luma_at(x, y, seed);
+    }
+    for (uint32_t y = 0; y < p.height[1]; y++)
+    {
+        uint8_t *row = (uint8_t *) s.mappedAddr.addr[1] + y * p.pitch[1];
+        for (uint32_t x = 0; x < p.width[1]; x++)
+        {
+            row[2 * x] = (uint8_t) (x * 5 + seed);
+            row[2 * x + 1] = (uint8_t) (y * 5 + seed);
+        }
+    }
+}
+
+static void
+fill_flat_nv12(NvBufSurfCpuTransform &cpu, int fd, uint8_t y_value,
+               uint8_t u_value, uint8_t v_value)
+{
+    NvBufSurfaceParams &s = cpu.getSurface(fd)->surfaceList[0];
+    NvBufSurfacePlaneParams &p = s.planeParams;
+
+    for (uint32_t y = 0; y < p.height[0]; y++)
+        memset((uint8_t *) s.mappedAddr.addr[0] + y * p.pitch[0], y_value, p.width[0]);
+    for (uint32_t y = 0; y < p.height[1]; y++)
+    {
+        uint8_t *row = (uint8_t *) s.mappedAddr.addr[1] + y * p.pitch[1];
+        for (uint32_t x = 0; x < p.width[1]; x++)
+        {
+            row[2 * x] = u_value;
+            row[2 * x + 1] = v_value;
+        }
+    }
+}
+
+static bool
+same_pixels(NvBufSurfCpuTransform &cpu, int fd_a, int fd_b)
+{
+    NvBufSurfaceParams &a = cpu.getSurface(fd_a)->surfaceList[0];
+    NvBufSurfaceParams &b = cpu.getSurface(fd_b)->surfaceList[0];
+    NvBufSurfacePlaneParams &p = a.planeParams;
+
+    if (a.width != b.width || a.height != b.height || a.colorFormat != b.colorFormat)
+        return false;
+    for (uint32_t plane = 0; plane < p.num_planes; plane++)
+    {
+        for (uint32_t y = 0; y < p.height[plane]; y++)
+        {
+            if (memcmp((uint8_t *) a.mappedAddr.addr[plane] + y * p.pitch[plane],
+                       (uint8_t *) b.mappedAddr.addr[plane] + y * p.pitch[plane],
+                       p.width[plane] * p.bytesPerPix[plane]))
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool
+near(int value, int expected, int tolerance)
+{
+    return value >= expected - tolerance && value <= expected + tolerance;
+}
+
+static NvBufSurfBatchJob
+crop_job(int src_fd, int dst_fd, uint32_t left, uint32_t top,
+         uint32_t width, uint32_t height, uint32_t dst_width,
+         uint32_t dst_height, NvBufSurfTransform_Inter filter)
+{
+    NvBufSurfBatchJob job;
+
+    memset(&job, 0, sizeof(job));
+    job.src_fd = src_fd;
+    job.dst_fd = dst_fd;
+    job.params.src_left = left;
+    job.params.src_top = top;
+    job.params.src_width = width;
+    job.params.src_height = height;
+    job.params.dst_width = dst_width;
+    job.params.dst_height = dst_height;
+    job.params.flag = (NvBufSurfTransform_Transform_Flag)
+        (NVBUFSURF_TRANSFORM_CROP_SRC | NVBUFSURF_TRANSFORM_CROP_DST |
+         NVBUFSURF_TRANSFORM_FILTER);
+    job.params.flip = NvBufSurfTransform_None;
+    job.params.filter = filter;
+    return job;
+}
+
+static UnitSampleTable::Row &
+add_result(UnitSampleTable &table, const char *name, NvBufSurfBatch &batch, bool ok)
+{
+    NvBufSurfBatchStats stats;
+
+    batch.getStats(&stats);
+    return table.row(name, ok) << stats.num_jobs << stats.num_calls << stats.num_lookups;
+}
+
+/**
+ * Runs the frames of the benchmark, one crop and scale per stream and frame,
+ * either as one batch per frame or as one call per job without the cache.
+ */
+static double
+run_frames(NvBufSurfCpuTransform &cpu, const vector<NvBufSurfBatchJob> &jobs,
+           uint32_t frames, bool batched, UnitSampleTable &table)
+{
+    NvBufSurfBatch batch(batched ? "batched" : "per-call", cpu.getOps(),
+                         batched ? MAX_BATCH_SIZE : 1);
+    NvBufSurfBatchFence fence;
+    uint64_t start = get_time_usec();
+    bool ok = true;
+
+    for (uint32_t frame = 0; frame < frames && ok; frame++)
+    {
+        if (batched)
+        {
+            ok = batch.submit(&jobs[0], jobs.size(), &fence) == 0;
+            ok = batch.wait(&fence, 1000) == 0 && ok;
+            continue;
+        }
+        for (size_t i = 0; i < jobs.size() && ok; i++)
+        {
+            /* As NvBufSurf::NvTransformAsync(): resolve both FDs, one call */
+            batch.clearCache();
+            ok = batch.submit(&jobs[i], 1, &fence) == 0;
+            ok = batch.wait(&fence, 1000) == 0 && ok;
+        }
+    }
+
+    double usec_per_job = (double) (get_time_usec() - start) / (frames * jobs.size());
+    add_result(table, batched ? "batched" : "per-call", batch, ok) << usec_per_job;
+    batch.printStats();
+    return usec_per_job;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t streams = DEFAULT_STREAMS;
+    uint32_t frames = DEFAULT_FRAMES;
+    uint32_t lookup_usec = DEFAULT_LOOKUP_USEC;
+    uint32_t call_usec = DEFAULT_CALL_USEC;
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./batch_transform_sample");
+    int opt;
+
+    args.option('s', "<streams>", "Streams, one crop and scale each per frame", DEFAULT_STREAMS)
+        .option('n', "<frames>", "Frames of the benchmark", DEFAULT_FRAMES)
+        .option('l', "<usec>", "Emulated time per FD lookup", DEFAULT_LOOKUP_USEC)
+        .option('c', "<usec>", "Emulated time per transform call", DEFAULT_CALL_USEC);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                streams = atoi(optarg);
+                break;
+            case 'n':
+                frames = atoi(optarg);
+                break;
+            case 'l':
+                lookup_usec = atoi(optarg);
+                break;
+            case 'c':
+                call_usec = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (streams == 0 || frames == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("jobs", 10).column("calls", 10).column("lookups", 10).column("us/job", 12, 1);
+
+    /* Nearest crop and 2x downscale of NV12 picks the expected pixels */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("nearest", cpu.getOps(), MAX_BATCH_SIZE);
+        int src = allocate_buffer(cpu, 64, 48, NVBUF_COLOR_FORMAT_NV12);
+        int dst = allocate_buffer(cpu, 16, 12, NVBUF_COLOR_FORMAT_NV12);
+        NvBufSurfBatchJob job = crop_job(src, dst, 8, 4, 32, 24, 16, 12,
+                                         NvBufSurfTransformInter_Nearest);
+        bool ok;
+
+        fill_nv12(cpu, src, 1);
+        ok = batch.submit(&job, 1, NULL) == 0;
+
+        NvBufSurfaceParams &d = cpu.getSurface(dst)->surfaceList[0];
+        for (uint32_t y = 0; y < 12 && ok; y++)
+        {
+            const uint8_t *row = (const uint8_t *) d.mappedAddr.addr[0] + y * d.planeParams.pitch[0];
+            for (uint32_t x = 0; x < 16 && ok; x++)
+                ok = row[x] == luma_at(8 + 2 * x + 1, 4 + 2 * y + 1, 1);
+        }
+        add_result(table, "nearest", batch, ok);
+    }
+
+    /* Bilinear at the same size copies the pixels unchanged */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("bilinear", cpu.getOps(), MAX_BATCH_SIZE);
+        int src = allocate_buffer(cpu, 70, 38, NVBUF_COLOR_FORMAT_NV12);
+        int dst = allocate_buffer(cpu, 70, 38, NVBUF_COLOR_FORMAT_NV12);
+        NvBufSurfBatchJob job = crop_job(src, dst, 0, 0, 70, 38, 70, 38,
+                                         NvBufSurfTransformInter_Bilinear);
+        bool ok;
+
+        fill_nv12(cpu, src, 2);
+        ok = batch.submit(&job, 1, NULL) == 0 && same_pixels(cpu, src, dst);
+        add_result(table, "bilinear", batch, ok);
+    }
+
+    /* NV12 to RGBA and back keeps a flat color */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("convert", cpu.getOps(), MAX_BATCH_SIZE);
+        int nv12 = allocate_buffer(cpu, 64, 32, NVBUF_COLOR_FORMAT_NV12);
+        int rgba = allocate_buffer(cpu, 32, 16, NVBUF_COLOR_FORMAT_RGBA);
+        int back = allocate_buffer(cpu, 32, 16, NVBUF_COLOR_FORMAT_NV12);
+        NvBufSurfBatchJob jobs[2];
+        bool ok;
+
+        /* BT.601 limited range red */
+        fill_flat_nv12(cpu, nv12, 81, 90, 240);
+        jobs[0] = crop_job(nv12, rgba, 0, 0, 64, 32, 32, 16, NvBufSurfTransformInter_Bilinear);
+        jobs[1] = crop_job(rgba, back, 0, 0, 32, 16, 32, 16, NvBufSurfTransformInter_Bilinear);
+        ok = batch.submit(&jobs[0], 1, NULL) == 0;
+        ok = batch.submit(&jobs[1], 1, NULL) == 0 && ok;
+
+        NvBufSurfaceParams &r = cpu.getSurface(rgba)->surfaceList[0];
+        NvBufSurfaceParams &b = cpu.getSurface(back)->surfaceList[0];
+        for (uint32_t y = 0; y < 16 && ok; y++)
+        {
+            const uint8_t *px = (const uint8_t *) r.mappedAddr.addr[0] + y * r.planeParams.pitch[0];
+            const uint8_t *ys = (const uint8_t *) b.mappedAddr.addr[0] + y * b.planeParams.pitch[0];
+            const uint8_t *uvs = (const uint8_t *) b.mappedAddr.addr[1] + (y / 2) * b.planeParams.pitch[1];
+            for (uint32_t x = 0; x < 32 && ok; x++)
+            {
+                ok = near(px[4 * x], 255, 2) && near(px[4 * x + 1], 0, 2) &&
+                     near(px[4 * x + 2], 0, 2) && px[4 * x + 3] == 255;
+                ok = ok && near(ys[x], 81, 2) && near(uvs[(x / 2) * 2], 90, 2) &&
+                     near(uvs[(x / 2) * 2 + 1], 240, 2);
+            }
+        }
+        add_result(table, "convert", batch, ok);
+    }
+
+    /* A batch produces the same pixels as one call per job */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("same", cpu.getOps(), MAX_BATCH_SIZE);
+        vector<NvBufSurfBatchJob> jobs;
+        vector<int> single_dst;
+        NvBufSurfBatchStats stats;
+        bool ok = true;
+
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            int src = allocate_buffer(cpu, 320, 240, NVBUF_COLOR_FORMAT_NV12);
+            int dst = allocate_buffer(cpu, 48 + i * 4, 40, (i & 1) ? NVBUF_COLOR_FORMAT_RGBA :
+                                      NVBUF_COLOR_FORMAT_NV12);
+            int ref = allocate_buffer(cpu, 48 + i * 4, 40, (i & 1) ? NVBUF_COLOR_FORMAT_RGBA :
+                                      NVBUF_COLOR_FORMAT_NV12);
+
+            fill_nv12(cpu, src, i);
+            jobs.push_back(crop_job(src, dst, i * 10, i * 6, 100 + i * 7, 90, 48 + i * 4, 40,
+                                    NvBufSurfTransformInter_Bilinear));
+            single_dst.push_back(ref);
+        }
+
+        NvBufSurfBatchFence fence;
+        ok = batch.submit(&jobs[0], jobs.size(), &fence) == 0 && ok;
+        ok = batch.wait(&fence, 1000) == 0 && ok;
+        batch.getStats(&stats);
+        ok = ok && stats.num_calls == 1;
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            NvBufSurfBatchJob job = jobs[i];
+            NvBufSurf::NvCommonTransformParams params = job.params;
+            NvBufSurface *src_surface = cpu.getSurface(job.src_fd);
+            NvBufSurface *dst_surface = cpu.getSurface(single_dst[i]);
+            NvBufSurfTransformRect src_rect = { params.src_top, params.src_left,
+                                                params.src_width, params.src_height };
+            NvBufSurfTransformRect dst_rect = { params.dst_top, params.dst_left,
+                                                params.dst_width, params.dst_height };
+            NvBufSurfTransformParams transform_params;
+
+            memset(&transform_params, 0, sizeof(transform_params));
+            transform_params.transform_flag = params.flag;
+            transform_params.transform_flip = params.flip;
+            transform_params.transform_filter = params.filter;
+            transform_params.src_rect = &src_rect;
+            transform_params.dst_rect = &dst_rect;
+            ok = NvBufSurfCpuTransform::transform(src_surface, dst_surface, &transform_params) == 0 && ok;
+            ok = same_pixels(cpu, job.dst_fd, single_dst[i]) && ok;
+        }
+        add_result(table, "same", batch, ok);
+    }
+
+    /* Jobs are split into calls on filter changes and at the maximum batch size */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("runs", cpu.getOps(), 4);
+        int src = allocate_buffer(cpu, 128, 128, NVBUF_COLOR_FORMAT_NV12);
+        int dst = allocate_buffer(cpu, 32, 32, NVBUF_COLOR_FORMAT_RGBA);
+        vector<NvBufSurfBatchJob> jobs;
+        NvBufSurfBatchStats stats;
+        bool ok;
+
+        /* 10 bilinear jobs: calls of 4, 4 and 2 */
+        for (uint32_t i = 0; i < 10; i++)
+            jobs.push_back(crop_job(src, dst, i, i, 64, 64, 32, 32,
+                                    NvBufSurfTransformInter_Bilinear));
+        ok = batch.submit(&jobs[0], jobs.size(), NULL) == 0;
+        batch.getStats(&stats);
+        ok = ok && stats.num_calls == 3;
+
+        /* Alternating filters: one call per job */
+        for (uint32_t i = 0; i < jobs.size(); i++)
+            jobs[i].params.filter = (i & 1) ? NvBufSurfTransformInter_Nearest :
+                NvBufSurfTransformInter_Bilinear;
+        ok = batch.submit(&jobs[0], jobs.size(), NULL) == 0 && ok;
+        batch.getStats(&stats);
+        ok = ok && stats.num_calls == 3 + jobs.size();
+        add_result(table, "runs", batch, ok);
+    }
+
+    /* FDs resolved once, forget() resolves again, unknown FD fails first */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("cache", cpu.getOps(), MAX_BATCH_SIZE);
+        int src = allocate_buffer(cpu, 64, 64, NVBUF_COLOR_FORMAT_NV12);
+        int dst = allocate_buffer(cpu, 32, 32, NVBUF_COLOR_FORMAT_NV12);
+        NvBufSurfBatchJob job = crop_job(src, dst, 0, 0, 64, 64, 32, 32,
+                                         NvBufSurfTransformInter_Nearest);
+        NvBufSurfBatchJob jobs[2] = { job, job };
+        NvBufSurfBatchStats stats;
+        bool ok = true;
+
+        for (uint32_t i = 0; i < 5; i++)
+            ok = batch.submit(&job, 1, NULL) == 0 && ok;
+        batch.getStats(&stats);
+        ok = ok && stats.num_lookups == 2 && stats.num_cache_hits == 8;
+
+        batch.forget(dst);
+        ok = batch.submit(&job, 1, NULL) == 0 && ok;
+        batch.getStats(&stats);
+        ok = ok && stats.num_lookups == 3;
+
+        jobs[1].dst_fd = -1;
+        uint64_t calls = stats.num_calls;
+        ok = batch.submit(jobs, 2, NULL) < 0 && ok;
+        batch.getStats(&stats);
+        ok = ok && stats.num_calls == calls;
+        add_result(table, "cache", batch, ok);
+    }
+
+    /* A rectangle outside the buffer fails */
+    {
+        NvBufSurfCpuTransform cpu;
+        NvBufSurfBatch batch("roi", cpu.getOps(), MAX_BATCH_SIZE);
+        int src = allocate_buffer(cpu, 64, 64, NVBUF_COLOR_FORMAT_NV12);
+        int dst = allocate_buffer(cpu, 32, 32, NVBUF_COLOR_FORMAT_NV12);
+        NvBufSurfBatchJob job = crop_job(src, dst, 40, 0, 32, 32, 32, 32,
+                                         NvBufSurfTransformInter_Nearest);
+        bool ok;
+
+        ok = batch.submit(&job, 1, NULL) < 0;
+        job = crop_job(src, dst, 0, 0, 32, 32, 0, 32, NvBufSurfTransformInter_Nearest);
+        ok = batch.submit(&job, 1, NULL) < 0 && ok;
+        add_result(table, "roi", batch, ok);
+    }
+
+    /* One crop and scale per stream and frame, one call per job vs batches */
+    {
+        NvBufSurfCpuTransform cpu(lookup_usec, call_usec);
+        vector<NvBufSurfBatchJob> jobs;
+
+        for (uint32_t i = 0; i < streams; i++)
+        {
+            int src = allocate_buffer(cpu, SRC_WIDTH, SRC_HEIGHT, NVBUF_COLOR_FORMAT_NV12);
+            int dst = allocate_buffer(cpu, TILE_SIZE, TILE_SIZE, NVBUF_COLOR_FORMAT_RGBA);
+
+            fill_nv12(cpu, src, i);
+            jobs.push_back(crop_job(src, dst, (i * 97) % (SRC_WIDTH - CROP_SIZE),
+                                    (i * 53) % (SRC_HEIGHT - CROP_SIZE), CROP_SIZE, CROP_SIZE,
+                                    TILE_SIZE, TILE_SIZE, NvBufSurfTransformInter_Bilinear));
+        }
+
+        run_frames(cpu, jobs, frames, false, table);
+        run_frames(cpu, jobs, frames, true, table);
+    }
+
+    cout << "Streams " << streams << ", frames " << frames << ", emulated lookup " <<
+        lookup_usec << " us, call " << call_usec << " us" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvBufSurfBatch.h"
+#include "NvBufSurfCpuTransform.h"
+#include "unit_sample.hpp"
+
+/**
+ * @brief Allocates one buffer of the CPU backend.
+ *
+ * @param[in] cpu CPU backend
+ * @param[in] width Width of the buffer
+ * @param[in] height Height of the buffer
+ * @param[in] format NVBUF_COLOR_FORMAT_NV12 or NVBUF_COLOR_FORMAT_RGBA
+ * @return FD of the buffer, or -1
+ */
+static int
+allocate_buffer(NvBufSurfCpuTransform &cpu, uint32_t width, uint32_t height,
+                NvBufSurfaceColorFormat format);
+
+/**
+ * @brief Fills an NV12 buffer with a pattern depending on the position.
+ *
+ * @param[in] cpu CPU backend
+ * @param[in] fd FD of the buffer
+ * @param[in] seed Value mixed into the pattern
+ */
+static void
+fill_nv12(NvBufSurfCpuTransform &cpu, int fd, uint32_t seed);
+
+/**
+ * @brief Compares the planes of two buffers of the same size and format.
+ *
+ * @param[in] cpu CPU backend
+ * @param[in] fd_a FD of the first buffer
+ * @param[in] fd_b FD of the second buffer
+ * @return true if all the pixels are equal
+ */
+static bool
+same_pixels(NvBufSurfCpuTransform &cpu, int fd_a, int fd_b);
+
+/**
+ * @brief Builds a job cropping @a src and scaling it into @a dst.
+ *
+ * @param[in] src_fd FD of the source buffer
+ * @param[in] dst_fd FD of the destination buffer
+ * @param[in] left Left of the source rectangle
+ * @param[in] top Top of the source rectangle
+ * @param[in] width Width of the source rectangle
+ * @param[in] height Height of the source rectangle
+ * @param[in] dst_width Width of the destination rectangle, at 0,0
+ * @param[in] dst_height Height of the destination rectangle, at 0,0
+ * @param[in] filter Transform filter
+ * @return The job
+ */
+static NvBufSurfBatchJob
+crop_job(int src_fd, int dst_fd, uint32_t left, uint32_t top,
+         uint32_t width, uint32_t height, uint32_t dst_width,
+         uint32_t dst_height, NvBufSurfTransform_Inter filter);
@@ -40,6 +40,8 @@
 #include <errno.h>
 #include <fstream>
 #include <signal.h>
+#include <stdint.h>
+#include <time.h>
 #include <libv4l2.h>
 #include <linux/videodev2.h>
 #include <linux/v4l2-controls.h>
@@ -124,6 +126,23 @@ using namespace std;
  * The capture thread blocks on the DQ buffer call, which returns either after
  * a successful DQ or after a specific timeout.
  *
+ * ## Capture Loop
+ * Every buffer index has a descriptor set up once per session, holding the
+ * v4l2_buffer it is queued with. MMAP buffers are mapped once and stay
+ * mapped until the end of the session. The DQ thread only dequeues,
+ * timestamps the descriptor and hands the index to a consumer thread
+ * through a single-producer single-consumer ring; the consumer writes or
+ * renders the frame and queues the buffer again. No memory is allocated
+ * and no lock is taken per frame. The latency from DQBUF to the consumer
+ * is printed at the end of the run.
+ *
+ * The loop can be run without a camera on the vivid virtual capture
+ * driver, loaded in multiplanar mode:
+ *     modprobe vivid multiplanar=2
+ *     ./camera_sample -sid <N> -nr --mem-type 1
+ * where /dev/video<N> is the vivid capture node. The Argus controls do not
+ * apply to vivid and must not be set.
+ *
  * ## EOS Handling
  * For sending EOS to the camera, the application should
  * - Stop queueing empty buffers on capture plane.
@@ -598,7 +617,7 @@ q_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer * buffer,
     int ret_val;
     uint32_t j;
 
-    pthread_mutex_lock (&ctx->queue_lock);
+    /* No lock: the caller owns the buffer index until it is queued */
     v4l2_buf.type = buf_type;
     v4l2_buf.memory = memory_type;
     v4l2_buf.length = num_planes;
@@ -615,8 +634,6 @@ q_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer * buffer,
         case V4L2_MEMORY_DMABUF:
             break;
         default:
-            pthread_cond_broadcast (&ctx->queue_cond);
-            pthread_mutex_unlock (&ctx->queue_lock);
             return -1;
     }
 
@@ -627,14 +644,13 @@ q_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer * buffer,
         switch (v4l2_buf.type)
         {
             case V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE:
-                ctx->capplane.num_queued_buffers++;
+                __atomic_add_fetch(&ctx->capplane.num_queued_buffers, 1,
+                        __ATOMIC_RELAXED);
                 break;
             default:
                 cerr << "Buffer Type not supported" << endl;
         }
-        pthread_cond_broadcast (&ctx->queue_cond);
     }
-    pthread_mutex_unlock (&ctx->queue_lock);
 
     return ret_val;
 }
@@ -657,7 +673,7 @@ dq_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer ** buffer,
             if (ctx->enable_metadata)
                 get_metadata(ctx->fd, v4l2_buf.index);
 
-            pthread_mutex_lock(&ctx->queue_lock);
+            /* The dequeued index is owned by this thread, no lock needed */
             switch(v4l2_buf.memory)
             {
                 case V4L2_MEMORY_MMAP:
@@ -668,16 +684,16 @@ dq_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer ** buffer,
                         ctx->capplane.buffers[v4l2_buf.index]->planes[j].bytesused =
                         v4l2_buf.m.planes[j].bytesused;
                     }
-                    ctx->capplane.num_queued_buffers--;
+                    __atomic_sub_fetch(&ctx->capplane.num_queued_buffers, 1,
+                            __ATOMIC_RELAXED);
                     break;
                 case V4L2_MEMORY_DMABUF:
-                    ctx->capplane.num_queued_buffers--;
+                    __atomic_sub_fetch(&ctx->capplane.num_queued_buffers, 1,
+                            __ATOMIC_RELAXED);
                     break;
                 default:
                     cout << "Invaild memory type" << endl;
             }
-            pthread_cond_broadcast(&ctx->queue_cond);
-            pthread_mutex_unlock(&ctx->queue_lock);
         }
         else if (errno == EAGAIN)
         {
@@ -708,6 +724,67 @@ dq_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer ** buffer,
     return ret_val;
 }
 
+static uint64_t
+get_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void
+ring_push(frame_ring *ring, uint32_t index)
+{
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+    ring->slots[head % FRAME_RING_SIZE] = index;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    sem_post(&ring->filled);
+}
+
+static uint32_t
+ring_pop(frame_ring *ring)
+{
+    uint32_t tail;
+    uint32_t index;
+
+    while (sem_wait(&ring->filled) == -1 && errno == EINTR)
+        ;
+    /* Pairs with the release store of head in ring_push() */
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail)
+        return FRAME_RING_STOP;
+    tail = ring->tail;
+    index = ring->slots[tail % FRAME_RING_SIZE];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return index;
+}
+
+void
+init_frame_descs(context_t *ctx)
+{
+    for (uint32_t i = 0; i < ctx->capplane.num_buffers; ++i)
+    {
+        frame_desc *frame = &ctx->frames[i];
+
+        memset(frame, 0, sizeof (frame_desc));
+        frame->buffer = (ctx->capplane.mem_type == V4L2_MEMORY_DMABUF) ?
+            NULL : ctx->capplane.buffers[i];
+        frame->v4l2_buf.index = i;
+        frame->v4l2_buf.type = ctx->capplane.buf_type;
+        frame->v4l2_buf.memory = ctx->capplane.mem_type;
+        frame->v4l2_buf.m.planes = frame->planes;
+        frame->v4l2_buf.length = ctx->capplane.num_planes;
+        if (ctx->capplane.mem_type == V4L2_MEMORY_DMABUF)
+            frame->planes[0].m.fd = ctx->dmabuffers_fd[i];
+    }
+
+    memset(&ctx->ring, 0, sizeof (frame_ring));
+    sem_init(&ctx->ring.filled, 0, 0);
+    ctx->ring_initialized = true;
+    memset(&ctx->latency, 0, sizeof (latency_stats));
+}
+
 void *
 dq_thread(void *arg)
 {
@@ -716,53 +793,44 @@ dq_thread(void *arg)
 
     while (ctx->dqthread_running && !quit_capture)
     {
-        bool ret_val;
         struct v4l2_buffer v4l2_buf;
         struct v4l2_plane planes[MAX_PLANES];
-        Buffer *buffer = NULL;
+        frame_desc *frame;
 
         if (ctx->dq_buffer_count == 0)
             break;
 
-        if (ctx->capplane.mem_type != V4L2_MEMORY_DMABUF)
-        {
-            buffer = new Buffer(ctx->capplane.buf_type,
-                ctx->capplane.mem_type, 0);
-        }
-
         memset(&v4l2_buf, 0, sizeof (struct v4l2_buffer));
         memset(planes, 0, MAX_PLANES * sizeof (struct v4l2_plane));
         v4l2_buf.m.planes = planes;
         v4l2_buf.length = ctx->capplane.num_planes;
 
-        if (dq_buffer(ctx, v4l2_buf, &buffer, ctx->capplane.buf_type,
+        if (dq_buffer(ctx, v4l2_buf, NULL, ctx->capplane.buf_type,
                 ctx->capplane.mem_type, -1) < 0)
         {
-            if (errno != EAGAIN)
+            if (ctx->capplane.streamon)
             {
-                ctx->in_error = true;
-                ret_val = capture_plane_callback(NULL, NULL, ctx);
+                cout << "Error while DQing buffer from capture plane" << endl;
+                ctx->in_error = 1;
             }
+            break;
+        }
 
-            if (errno == EAGAIN || ctx->capplane.streamon)
-                ret_val = capture_plane_callback(NULL, NULL, ctx);
+        frame = &ctx->frames[v4l2_buf.index];
+        frame->dq_time_ns = get_time_ns();
+        frame->sequence = v4l2_buf.sequence;
+        for (uint32_t j = 0; j < ctx->capplane.num_planes; j++)
+            frame->planes[j].bytesused = v4l2_buf.m.planes[j].bytesused;
+        ring_push(&ctx->ring, v4l2_buf.index);
+        ctx->dq_buffer_count--;
 
-            if (!ctx->capplane.streamon)
-            {
-                break;
-            }
-        }
-        else
-        {
-            ret_val = capture_plane_callback(&v4l2_buf, buffer, ctx);
-            ctx->dq_buffer_count--;
-        }
-        if (!ret_val)
-        {
+        /* End of stream, the consumer stops on the empty buffer */
+        if (v4l2_buf.m.planes[0].bytesused == 0)
             break;
-        }
     }
 
+    ring_push(&ctx->ring, FRAME_RING_STOP);
+
     pthread_mutex_lock(&ctx->queue_lock);
     ctx->dqthread_running = false;
     pthread_cond_broadcast(&ctx->queue_cond);
@@ -771,6 +839,89 @@ dq_thread(void *arg)
     return NULL;
 }
 
+static void
+record_latency(latency_stats *stats, const frame_desc *frame, uint64_t latency_ns)
+{
+    uint64_t bucket = latency_ns / (LATENCY_BUCKET_US * 1000);
+
+    if (stats->frames && frame->sequence > stats->last_sequence + 1)
+        stats->dropped_sequences += frame->sequence - stats->last_sequence - 1;
+    stats->last_sequence = frame->sequence;
+
+    if (stats->frames == 0 || latency_ns < stats->min_ns)
+        stats->min_ns = latency_ns;
+    if (latency_ns > stats->max_ns)
+        stats->max_ns = latency_ns;
+    stats->total_ns += latency_ns;
+    stats->frames++;
+    stats->histogram[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+}
+
+void *
+consumer_thread(void *arg)
+{
+    context_t *ctx = (context_t *)arg;
+
+    while (true)
+    {
+        uint32_t index = ring_pop(&ctx->ring);
+        frame_desc *frame;
+
+        if (index == FRAME_RING_STOP)
+            break;
+
+        frame = &ctx->frames[index];
+        record_latency(&ctx->latency, frame, get_time_ns() - frame->dq_time_ns);
+
+        if (!capture_plane_callback(&frame->v4l2_buf, frame->buffer, ctx))
+        {
+            /* Wakes up the DQ thread if it waits for a buffer */
+            pthread_mutex_lock(&ctx->queue_lock);
+            ctx->capplane.streamon = 0;
+            pthread_mutex_unlock(&ctx->queue_lock);
+            v4l2_ioctl(ctx->fd, VIDIOC_STREAMOFF, &ctx->capplane.buf_type);
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/* Upper bound of the histogram bucket holding the given fraction of frames */
+static double
+latency_percentile_us(const latency_stats &stats, double fraction)
+{
+    uint64_t target = (uint64_t) (stats.frames * fraction);
+    uint64_t count = 0;
+
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        count += stats.histogram[i];
+        if (count > target)
+            return (double) (i + 1) * LATENCY_BUCKET_US;
+    }
+    return (double) LATENCY_BUCKETS * LATENCY_BUCKET_US;
+}
+
+void
+print_latency_stats(context_t& ctx)
+{
+    const latency_stats &stats = ctx.latency;
+
+    if (stats.frames == 0)
+        return;
+
+    cout << "----------- Capture latency -----------" << endl;
+    cout << "Frames: " << stats.frames << ", skipped by the driver: " <<
+        stats.dropped_sequences << endl;
+    cout << "DQBUF to consumer: min " << stats.min_ns / 1000.0 << " us, avg " <<
+        stats.total_ns / 1000.0 / stats.frames << " us, max " <<
+        stats.max_ns / 1000.0 << " us" << endl;
+    cout << "Percentiles (" << LATENCY_BUCKET_US << " us buckets): p50 <= " <<
+        latency_percentile_us(stats, 0.5) << " us, p99 <= " <<
+        latency_percentile_us(stats, 0.99) << " us" << endl;
+}
+
 int dump_dmabuffers(ofstream *stream, int dmabuf_fd)
 {
     int ret = 0;
@@ -1206,6 +1357,11 @@ int capture_proc (context_t &ctx, int argc, char const *argv[])
         }
     }
 
+    /* Set up the descriptors used to queue each buffer index
+    ** for the whole session.
+    */
+    init_frame_descs(&ctx);
+
     /* Set streaming on plane
     ** Start stream processing on capture
     ** plane by setting the streaming status ON.
@@ -1217,49 +1373,17 @@ int capture_proc (context_t &ctx, int argc, char const *argv[])
     ctx.capplane.streamon = 1;
 
     /* Enqueue all the empty buffers on capture plane. */
-    if (ctx.capplane.mem_type != V4L2_MEMORY_DMABUF)
-    {
-        for (uint32_t i = 0; i < ctx.capplane.num_buffers; ++i)
-        {
-            struct v4l2_buffer queue_cap_v4l2_buf;
-            struct v4l2_plane queue_cap_planes[MAX_PLANES];
-            Buffer *buffer;
-
-            memset(&queue_cap_v4l2_buf, 0, sizeof (struct v4l2_buffer));
-            memset(queue_cap_planes, 0, MAX_PLANES * sizeof (struct v4l2_plane));
-
-            buffer = ctx.capplane.buffers[i];
-            queue_cap_v4l2_buf.index = i;
-            queue_cap_v4l2_buf.m.planes = queue_cap_planes;
-
-            ret = q_buffer(&ctx, queue_cap_v4l2_buf, buffer, ctx.capplane.buf_type,
-                    ctx.capplane.mem_type, ctx.capplane.num_planes);
-            CHECK_ERROR(ret, "Error while queueing buffer on capture plane", cleanup);
-        }
-    }
-    else
+    for (uint32_t i = 0; i < ctx.capplane.num_buffers; ++i)
     {
-        for (uint32_t i = 0; i < ctx.capplane.num_buffers; ++i)
-        {
-            struct v4l2_buffer queue_cap_v4l2_buf;
-            struct v4l2_plane queue_cap_planes[MAX_PLANES];
-
-            memset(&queue_cap_v4l2_buf, 0, sizeof (struct v4l2_buffer));
-            memset(queue_cap_planes, 0, MAX_PLANES * sizeof (struct v4l2_plane));
-
-            queue_cap_v4l2_buf.index = i;
-            queue_cap_v4l2_buf.m.planes = queue_cap_planes;
-            queue_cap_v4l2_buf.m.planes[0].m.fd = ctx.dmabuffers_fd[i];
-
-            ret = q_buffer(&ctx, queue_cap_v4l2_buf, NULL, ctx.capplane.buf_type,
-                    ctx.capplane.mem_type, ctx.capplane.num_planes);
-            CHECK_ERROR(ret, "Error while queueing buffer on capture plane", cleanup);
-        }
+        ret = q_buffer(&ctx, ctx.frames[i].v4l2_buf, ctx.frames[i].buffer,
+                ctx.capplane.buf_type, ctx.capplane.mem_type, ctx.capplane.num_planes);
+        CHECK_ERROR(ret, "Error while queueing buffer on capture plane", cleanup);
     }
 
     /* Create DQ Capture loop thread
     ** and set the callback function to dq_thread.
     */
+    pthread_create(&ctx.consumer_thread, NULL, consumer_thread, &ctx);
     pthread_mutex_lock(&ctx.queue_lock);
     ctx.dqthread_running = true;
     pthread_create(&ctx.cam_dq_thread, NULL, dq_thread, &ctx);
@@ -1270,6 +1394,11 @@ int capture_proc (context_t &ctx, int argc, char const *argv[])
     */
     wait_for_dqthread(ctx, -1);
 
+    /* The DQ thread queues the stop marker before exiting */
+    pthread_join(ctx.consumer_thread, NULL);
+    ctx.consumer_thread = 0;
+    print_latency_stats(ctx);
+
     /* Cleanup and exit. */
 
 cleanup:
@@ -1309,6 +1438,12 @@ cleanup:
 
     }
 
+    if (ctx.ring_initialized)
+    {
+        sem_destroy(&ctx.ring.filled);
+        ctx.ring_initialized = false;
+    }
+
     if (ctx.output_file)
     {
         ctx.output_file->close();
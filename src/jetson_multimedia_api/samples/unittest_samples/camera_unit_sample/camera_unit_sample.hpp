@@ -28,6 +28,7 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <semaphore.h>
 #include <libv4l2.h>
 #include <linux/videodev2.h>
 #include <linux/v4l2-controls.h>
@@ -47,6 +48,25 @@
  */
 #define MAX_CAPTURE_BUFFFERS 32
 
+/**
+ * Specifies the number of entries of the frame ring, a power of two larger
+ * than the number of capture buffers plus the stop marker.
+ */
+#define FRAME_RING_SIZE 64
+
+/**
+ * Specifies the ring entry that stops the consumer thread.
+ */
+#define FRAME_RING_STOP 0xffffffff
+
+/**
+ * Specifies the width of the buckets of the latency histogram, in
+ * microseconds, and their number. The last bucket holds all longer
+ * latencies.
+ */
+#define LATENCY_BUCKET_US 10
+#define LATENCY_BUCKETS 1000
+
 /* Defaults */
 #define DEFAULT_ARGUS_SENSOR_ID                 0
 #define DEFAULT_ARGUS_SENSOR_MODE               -1
@@ -220,6 +240,45 @@ typedef struct
     bool format_set;
 } capture_plane;
 
+/**
+ * Descriptor of one V4L2 buffer index, set up once for the session.
+ * The dequeue thread fills in the per-frame fields and the consumer thread
+ * re-queues the buffer with @a v4l2_buf.
+ */
+typedef struct
+{
+    Buffer *buffer;                         /* MMAP buffer, NULL for DMABUF */
+    struct v4l2_buffer v4l2_buf;            /* Queued as is, planes in @a planes */
+    struct v4l2_plane planes[MAX_PLANES];
+    uint32_t sequence;                      /* Driver sequence number of the frame */
+    uint64_t dq_time_ns;                    /* CLOCK_MONOTONIC when DQBUF returned */
+} frame_desc;
+
+/**
+ * Single-producer single-consumer ring of dequeued buffer indexes. Each
+ * index is in the ring at most once, so it cannot overflow. The consumer
+ * sleeps on @a filled when the ring is empty.
+ */
+typedef struct
+{
+    uint32_t slots[FRAME_RING_SIZE];
+    uint32_t head;                          /* Written by the dequeue thread */
+    uint32_t tail;                          /* Written by the consumer thread */
+    sem_t filled;
+} frame_ring;
+
+/** DQBUF-to-consumer latency, updated by the consumer thread only */
+typedef struct
+{
+    uint64_t frames;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t dropped_sequences;             /* Frames the driver skipped */
+    uint32_t last_sequence;
+    uint32_t histogram[LATENCY_BUCKETS];
+} latency_stats;
+
 /**
  * @brief Struct defining the camera context.
  * The video camera device node is `/dev/video0`.
@@ -238,6 +297,7 @@ typedef struct
     pthread_mutex_t queue_lock;
     pthread_cond_t queue_cond;
     pthread_t cam_dq_thread;
+    pthread_t consumer_thread;
 
     argus_controls ctrls;
     display_settings display;
@@ -267,6 +327,11 @@ typedef struct
     int32_t dq_buffer_count;
     int32_t dmabuffers_fd[MAX_CAPTURE_BUFFFERS];
     int32_t fd;
+
+    frame_desc frames[MAX_CAPTURE_BUFFFERS];
+    frame_ring ring;
+    bool ring_initialized;
+    latency_stats latency;
 } context_t;
 
 /**
@@ -375,7 +440,9 @@ int dq_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer ** buffer,
  * This is a callback function of the capture loop thread created.
  * The function runs infinitely until signaled to stop, or error
  * is encountered. On successful dequeue of a buffer from the plane,
- * the method calls capture_plane_callback.
+ * the method timestamps the descriptor of the buffer index and hands the
+ * index to consumer_thread through the frame ring, without allocating or
+ * locking.
  *
  * Setting the stream to off automatically stops the thread.
  *
@@ -383,6 +450,36 @@ int dq_buffer(context_t * ctx, struct v4l2_buffer &v4l2_buf, Buffer ** buffer,
  */
 void * dq_thread(void *arg);
 
+/**
+ * @brief Consumer thread of the dequeued frames.
+ *
+ * Takes the frames handed over by dq_thread through the frame ring,
+ * records their DQBUF-to-consumer latency and calls capture_plane_callback,
+ * which writes or renders the frame and re-queues the buffer. The thread
+ * exits on the #FRAME_RING_STOP entry queued by dq_thread when it stops.
+ *
+ * @param[in] arg A pointer to the application data.
+ */
+void * consumer_thread(void *arg);
+
+/**
+ * @brief Sets up the descriptor of every capture buffer index.
+ *
+ * Called once the buffers are requested, and mapped or allocated. The
+ * descriptors hold the v4l2_buffer used to queue each buffer for the
+ * whole session, so the capture loop allocates nothing.
+ *
+ * @param[in] ctx Pointer to the camera context struct created.
+ */
+void init_frame_descs(context_t *ctx);
+
+/**
+ * @brief Prints the DQBUF-to-consumer latency of the session.
+ *
+ * @param[in] ctx Reference to the camera context struct created.
+ */
+void print_latency_stats(context_t& ctx);
+
 /**
  * @brief Writes NvBuffer data to a file.
  *
@@ -397,8 +494,8 @@ int dump_dmabuffers(ofstream *stream, int fd);
 /**
  * @brief DQ callback function.
  *
- * This is a callback function type method that is called by the DQ Thread when
- * it successfully dequeues a buffer from the plane.
+ * This is a callback function type method that is called by the consumer
+ * thread for each buffer dequeued from the plane.
  *
  * Setting the stream to off automatically stops the thread.
  *
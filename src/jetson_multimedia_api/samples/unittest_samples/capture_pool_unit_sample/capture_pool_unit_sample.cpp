@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./capture_pool_sample [-a <usec>] [-b <buffers>] [-n <changes>]
+ * Example:
+ * ./capture_pool_sample
+ * ./capture_pool_sample -a 2000 -n 100
+**/
+
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "capture_pool_unit_sample.hpp"
+
+/**
+ * Decoder capture buffer reuse across resolution changes.
+ *
+ * On a resolution change the video decode samples release the decoder
+ * capture plane and set it up again. Without NvDecoderCapturePool they
+ * also destroy and allocate all the capture buffers, which stalls
+ * adaptive-bitrate and camera-switching streams for several frames.
+ *
+ * This sample drives the pool with a mocked allocator whose allocations
+ * take a time proportional to the buffer size, and checks:
+ * ## An adaptive-bitrate ladder, reallocating on every change as before
+ * ## The same ladder with a pool sized for the largest rung
+ * ## A stream larger than the pool grows the buffers, which never shrink
+ * ## More buffers only allocates the missing ones
+ * ## A new buffer format reallocates at the largest size seen
+ * ## After a resolution drop, --stats rendering presents the stream size
+ * ## A failed allocation leaves the pool empty and usable
+ *
+ * The mocked allocator fails a test if a buffer is destroyed twice or
+ * buffers are left at exit.
+**/
+
+#define DEFAULT_ALLOC_USEC 500
+#define DEFAULT_BUFFERS 8
+#define DEFAULT_CHANGES 40
+#define MAX_BUFFERS 32
+#define FORMAT_NV12_BL 0x10006
+#define FORMAT_P010_BL 0x10007
+
+static const resolution ladder[] =
+{
+    { 1920, 1080 },
+    { 1280, 720 },
+    { 854, 480 },
+    { 640, 360 },
+};
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int
+mock_allocate(uint32_t width, uint32_t height, uint32_t format,
+              uint32_t count, int *fds, void *arg)
+{
+    mock_allocator *alloc = (mock_allocator *) arg;
+
+    if (alloc->fail_after == 0)
+        return -1;
+    if (alloc->fail_after > 0)
+        alloc->fail_after--;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        mock_buffer buffer = { width, height, format };
+
+        usleep((uint64_t) alloc->alloc_usec_per_mpixel * width * height / 1000000);
+        fds[i] = alloc->next_fd++;
+        alloc->live[fds[i]] = buffer;
+        alloc->allocations++;
+    }
+    return 0;
+}
+
+static int
+mock_destroy(int fd, void *arg)
+{
+    mock_allocator *alloc = (mock_allocator *) arg;
+
+    if (!alloc->live.erase(fd))
+    {
+        cerr << "FAIL: buffer " << fd << " destroyed while not allocated" << endl;
+        alloc->error = true;
+        return -1;
+    }
+    return 0;
+}
+
+static void
+init_allocator(mock_allocator &alloc, uint32_t alloc_usec)
+{
+    alloc.alloc_usec_per_mpixel = alloc_usec;
+    alloc.fail_after = -1;
+    alloc.live.clear();
+    alloc.next_fd = 100;
+    alloc.allocations = 0;
+    alloc.error = false;
+}
+
+static NvDecoderCapturePoolOps
+mock_ops(mock_allocator &alloc)
+{
+    NvDecoderCapturePoolOps ops;
+
+    ops.allocate = mock_allocate;
+    ops.destroy = mock_destroy;
+    ops.arg = &alloc;
+    return ops;
+}
+
+static bool
+check_buffer(mock_allocator &alloc, int fd, const resolution &res, uint32_t format)
+{
+    map<int, mock_buffer>::iterator it = alloc.live.find(fd);
+
+    if (it == alloc.live.end() || it->second.width < res.width ||
+        it->second.height < res.height || it->second.format != format)
+    {
+        cerr << "FAIL: buffer " << fd << " does not fit " << res.width << "x" <<
+            res.height << endl;
+        return false;
+    }
+    return true;
+}
+
+static bool
+play_changes(mock_allocator &alloc, NvDecoderCapturePool *pool,
+             const vector<resolution> &changes, uint32_t count,
+             uint32_t format, change_counts &counts)
+{
+    NvDecoderCapturePoolOps ops = mock_ops(alloc);
+    NvDecoderCapturePoolStats stats;
+    vector<int> fds;
+    uint64_t start = get_time_usec();
+    bool ok = true;
+
+    for (size_t i = 0; i < changes.size(); i++)
+    {
+        if (pool)
+        {
+            if (pool->configure(changes[i].width, changes[i].height, format, count) < 0)
+                return false;
+            fds.resize(pool->getNumBuffers());
+            for (uint32_t j = 0; j < pool->getNumBuffers(); j++)
+                fds[j] = pool->getFd(j);
+        }
+        else
+        {
+            for (size_t j = 0; j < fds.size(); j++)
+                ops.destroy(fds[j], ops.arg);
+            fds.resize(count);
+            if (ops.allocate(changes[i].width, changes[i].height, format, count,
+                             &fds[0], ops.arg) < 0)
+                return false;
+            if (i > 0)
+                counts.reallocations++;
+        }
+
+        ok = fds.size() == count && ok;
+        for (size_t j = 0; j < fds.size(); j++)
+            ok = check_buffer(alloc, fds[j], changes[i], format) && ok;
+    }
+
+    counts.changes += changes.size();
+    counts.usec_per_change = (double) (get_time_usec() - start) / changes.size();
+    if (pool)
+    {
+        pool->getStats(&stats);
+        counts.reallocations = stats.num_reallocations;
+    }
+    else
+    {
+        for (size_t j = 0; j < fds.size(); j++)
+            ops.destroy(fds[j], ops.arg);
+    }
+    return ok;
+}
+
+/* Size the decode samples present with --stats: the capture buffer when it
+ * matches the stream, else the transform to the stream size. */
+static resolution
+presented_size(NvDecoderCapturePool &pool, const resolution &stream)
+{
+    resolution size = { pool.getBufferWidth(), pool.getBufferHeight() };
+
+    return pool.isPadded() ? stream : size;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const change_counts &counts,
+           const mock_allocator &alloc, bool ok)
+{
+    table.row(name, ok && !alloc.error && alloc.live.empty()) << counts.changes <<
+        alloc.allocations << counts.reallocations << counts.usec_per_change;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(12);
+    UnitSampleArgs args("./capture_pool_sample");
+    vector<resolution> abr;
+    uint32_t alloc_usec = DEFAULT_ALLOC_USEC;
+    uint32_t num_buffers = DEFAULT_BUFFERS;
+    uint32_t num_changes = DEFAULT_CHANGES;
+    const uint32_t ladder_size = sizeof(ladder) / sizeof(ladder[0]);
+    int opt;
+
+    args.option('a', "<usec>", "Mocked allocation time per buffer and megapixel",
+                DEFAULT_ALLOC_USEC)
+        .option('b', "<buffers>", "Capture buffers", DEFAULT_BUFFERS)
+        .option('n', "<changes>", "Resolution changes of the ladder test", DEFAULT_CHANGES);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'a':
+                alloc_usec = atoi(optarg);
+                break;
+            case 'b':
+                num_buffers = atoi(optarg);
+                break;
+            case 'n':
+                num_changes = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (num_buffers == 0 || num_buffers > MAX_BUFFERS / 2 || num_changes == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("changes", 10).column("allocs", 10).column("reallocs", 10)
+        .column("us/change", 14, 1);
+
+    /* The bitrate walks down and up the ladder */
+    for (uint32_t i = 0; i < num_changes; i++)
+    {
+        uint32_t step = i % (2 * ladder_size - 2);
+
+        abr.push_back(ladder[step < ladder_size ? step : 2 * ladder_size - 2 - step]);
+    }
+
+    /* Reallocate on every change, as without the pool */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        bool ok;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, alloc_usec);
+        ok = play_changes(alloc, NULL, abr, num_buffers, FORMAT_NV12_BL, counts);
+        add_result(table, "realloc", counts, alloc,
+                   ok && alloc.allocations == (uint64_t) num_changes * num_buffers);
+    }
+
+    /* Pool sized for the largest rung: one allocation for the whole stream */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        NvDecoderCapturePoolStats stats;
+        bool ok;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, alloc_usec);
+        {
+            NvDecoderCapturePool pool("abr", mock_ops(alloc), 1920, 1080, MAX_BUFFERS);
+
+            ok = play_changes(alloc, &pool, abr, num_buffers, FORMAT_NV12_BL, counts);
+            pool.getStats(&stats);
+            ok = ok && stats.num_configures == num_changes &&
+                stats.num_reuses == num_changes - 1 && stats.num_reallocations == 0;
+        }
+        add_result(table, "pool", counts, alloc, ok && alloc.allocations == num_buffers);
+    }
+
+    /* A stream larger than the pool grows it, and it never shrinks */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        vector<resolution> changes;
+        resolution uhd = { 3840, 2160 };
+        bool ok;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, 0);
+        changes.push_back(ladder[1]);
+        changes.push_back(ladder[0]);
+        changes.push_back(uhd);
+        changes.push_back(ladder[2]);
+        changes.push_back(ladder[0]);
+        {
+            NvDecoderCapturePool pool("grow", mock_ops(alloc), 0, 0, MAX_BUFFERS);
+
+            ok = play_changes(alloc, &pool, changes, num_buffers, FORMAT_NV12_BL, counts);
+            ok = ok && pool.getBufferWidth() == uhd.width &&
+                pool.getBufferHeight() == uhd.height && counts.reallocations == 2;
+        }
+        add_result(table, "grow", counts, alloc, ok && alloc.allocations == 3 * num_buffers);
+    }
+
+    /* More buffers only allocates the missing ones */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        NvDecoderCapturePoolStats stats;
+        bool ok = true;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, 0);
+        {
+            NvDecoderCapturePool pool("count", mock_ops(alloc), 1920, 1080, MAX_BUFFERS);
+            int first_fd;
+
+            ok = pool.configure(1280, 720, FORMAT_NV12_BL, num_buffers) == 0 && ok;
+            first_fd = pool.getFd(0);
+            ok = pool.configure(1920, 1080, FORMAT_NV12_BL, num_buffers * 2) == 0 && ok;
+            ok = pool.getNumBuffers() == num_buffers * 2 && pool.getFd(0) == first_fd && ok;
+            ok = pool.configure(854, 480, FORMAT_NV12_BL, num_buffers) == 0 && ok;
+            ok = pool.getNumBuffers() == num_buffers && pool.getFd(num_buffers) == -1 && ok;
+            pool.getStats(&stats);
+            ok = stats.num_grows == 1 && stats.num_reuses == 1 && ok;
+            counts.changes = stats.num_configures;
+            counts.reallocations = stats.num_reallocations;
+        }
+        add_result(table, "count", counts, alloc, ok && alloc.allocations == num_buffers * 2);
+    }
+
+    /* A new format reallocates at the largest size seen */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        bool ok = true;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, 0);
+        {
+            NvDecoderCapturePool pool("format", mock_ops(alloc), 0, 0, MAX_BUFFERS);
+
+            ok = pool.configure(1920, 1080, FORMAT_NV12_BL, num_buffers) == 0 && ok;
+            ok = pool.configure(1280, 720, FORMAT_P010_BL, num_buffers) == 0 && ok;
+            ok = check_buffer(alloc, pool.getFd(0), ladder[0], FORMAT_P010_BL) && ok;
+            ok = pool.configure(1920, 1080, FORMAT_P010_BL, num_buffers) == 0 && ok;
+            counts.changes = 3;
+            counts.reallocations = 1;
+        }
+        add_result(table, "format", counts, alloc, ok && alloc.allocations == num_buffers * 2);
+    }
+
+    /* A resolution drop keeps the larger buffers, which are not presented */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        bool ok = true;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, 0);
+        {
+            NvDecoderCapturePool pool("present", mock_ops(alloc), 0, 0, MAX_BUFFERS);
+
+            for (uint32_t i = 0; i < ladder_size; i++)
+            {
+                resolution size;
+
+                ok = pool.configure(ladder[i].width, ladder[i].height,
+                                    FORMAT_NV12_BL, num_buffers) == 0 && ok;
+                size = presented_size(pool, ladder[i]);
+                ok = size.width == ladder[i].width && size.height == ladder[i].height && ok;
+                ok = pool.isPadded() == (i > 0) && ok;
+            }
+            ok = pool.configure(ladder[0].width, ladder[0].height,
+                                FORMAT_NV12_BL, num_buffers) == 0 && !pool.isPadded() && ok;
+            counts.changes = ladder_size + 1;
+        }
+        add_result(table, "present", counts, alloc, ok && alloc.allocations == num_buffers);
+    }
+
+    /* A failed allocation leaves the pool empty and usable */
+    {
+        change_counts counts;
+        mock_allocator alloc;
+        bool ok = true;
+
+        memset(&counts, 0, sizeof(counts));
+        init_allocator(alloc, 0);
+        {
+            NvDecoderCapturePool pool("failure", mock_ops(alloc), 0, 0, MAX_BUFFERS);
+
+            ok = pool.configure(1280, 720, FORMAT_NV12_BL, num_buffers) == 0 && ok;
+            alloc.fail_after = 0;
+            ok = pool.configure(1920, 1080, FORMAT_NV12_BL, num_buffers) < 0 && ok;
+            ok = pool.getNumBuffers() == 0 && pool.getFd(0) == -1 && alloc.live.empty() && ok;
+            alloc.fail_after = -1;
+            ok = pool.configure(1920, 1080, FORMAT_NV12_BL, num_buffers) == 0 && ok;
+            ok = pool.configure(1920, 1080, FORMAT_NV12_BL, MAX_BUFFERS + 1) < 0 && ok;
+            counts.changes = 4;
+        }
+        add_result(table, "failure", counts, alloc, ok && alloc.allocations == num_buffers * 2);
+    }
+
+    cout << "Buffers " << num_buffers << ", allocation " << alloc_usec << " us per megapixel" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvDecoderCapturePool.h"
+#include "unit_sample.hpp"
+
+/**
+ * Describes one buffer of the mocked allocator.
+ */
+typedef struct
+{
+    /** Width of the buffer. */
+    uint32_t width;
+    /** Height of the buffer. */
+    uint32_t height;
+    /** Format of the buffer. */
+    uint32_t format;
+} mock_buffer;
+
+/**
+ * Holds the state of the mocked allocator.
+ */
+typedef struct
+{
+    /** Allocation time per buffer and megapixel, in microseconds. */
+    uint32_t alloc_usec_per_mpixel;
+    /** Number of allocate calls left before one fails, or -1. */
+    int fail_after;
+    /** Live buffers, by fd. */
+    std::map<int, mock_buffer> live;
+    /** Next fd handed out. */
+    int next_fd;
+    /** Buffers allocated. */
+    uint64_t allocations;
+    /** Set when an unknown fd is destroyed. */
+    bool error;
+} mock_allocator;
+
+/**
+ * Describes one resolution of the stream.
+ */
+typedef struct
+{
+    /** Width of the stream. */
+    uint32_t width;
+    /** Height of the stream. */
+    uint32_t height;
+} resolution;
+
+/**
+ * Holds the resolution changes played by one test.
+ */
+typedef struct
+{
+    /** Resolution changes. */
+    uint64_t changes;
+    /** configure() calls that reallocated all the buffers. */
+    uint64_t reallocations;
+    /** Buffer setup time per resolution change, in microseconds. */
+    double usec_per_change;
+} change_counts;
+
+/**
+ * @brief Plays a list of resolution changes on a pool.
+ *
+ * After each change, checks that the buffers handed out are live, large
+ * enough for the stream and of the requested format.
+ *
+ * @param[in] alloc Mocked allocator
+ * @param[in] pool Pool, or NULL to destroy and allocate the buffers on
+ *                 every change, as without the pool
+ * @param[in] changes Resolutions of the stream
+ * @param[in] count Buffers per change
+ * @param[in] format Buffer format
+ * @param[in,out] counts Counts of the run, added to
+ * @return true if the checks passed
+ */
+static bool
+play_changes(mock_allocator &alloc, NvDecoderCapturePool *pool,
+             const std::vector<resolution> &changes, uint32_t count,
+             uint32_t format, change_counts &counts);
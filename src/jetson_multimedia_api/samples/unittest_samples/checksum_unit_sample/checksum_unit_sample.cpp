@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./checksum_sample [-b [width] [height] [iterations]]
+ * Example:
+ * ./checksum_sample
+ * ./checksum_sample -b 3840 2160 200
+**/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+#include "checksum_unit_sample.hpp"
+
+/**
+ * Frame checksums with NvFrameChecksum.
+ *
+ * Decoder samples can verify their output with --frame-checksum instead of
+ * writing raw YUV: each frame is reduced to one CRC32C per plane over the
+ * visible region, written as one line per frame and compared against a
+ * golden checksum file.
+ *
+ * This sample checks the hashing and comparison core on synthetic NV12
+ * frames, without a decoder:
+ * ## CRC32C of a known test vector.
+ * ## Pitch padding does not change the plane checksum.
+ * ## A checksum file read back as golden file matches every frame.
+ * ## A single changed pixel is reported as a mismatch.
+ * ## Pool buffers put back after a failed conversion, a failed queueing or
+ *    a failed mapping stay usable, and queued buffers hash like the frames.
+ *
+ * The pool buffers are mocked, mapped through NvFrameChecksumOps.
+ *
+ * With -b it measures the hashing throughput.
+**/
+
+#define CHECK(cond, msg) if (!(cond)) { \
+                             cerr << "FAILED: " << msg << endl; \
+                             return -1; }
+
+static void
+alloc_frame(synthetic_frame &frame, uint32_t width, uint32_t height, uint32_t pitch)
+{
+    frame.num_planes = 2;
+    frame.row_bytes[0] = width;
+    frame.height[0] = height;
+    frame.row_bytes[1] = width;
+    frame.height[1] = height / 2;
+    for (uint32_t i = 0; i < frame.num_planes; i++)
+    {
+        frame.pitch[i] = pitch;
+        frame.planes[i] = new uint8_t[(size_t) pitch * frame.height[i]];
+    }
+}
+
+static void
+free_frame(synthetic_frame &frame)
+{
+    for (uint32_t i = 0; i < frame.num_planes; i++)
+        delete[] frame.planes[i];
+}
+
+static void
+fill_frame(synthetic_frame &frame, uint32_t index)
+{
+    for (uint32_t i = 0; i < frame.num_planes; i++)
+    {
+        for (uint32_t y = 0; y < frame.height[i]; y++)
+        {
+            uint8_t *row = frame.planes[i] + (size_t) y * frame.pitch[i];
+            for (uint32_t x = 0; x < frame.row_bytes[i]; x++)
+                row[x] = (uint8_t) (x * 3 + y * 7 + index * 13 + i);
+            for (uint32_t x = frame.row_bytes[i]; x < frame.pitch[i]; x++)
+                row[x] = (uint8_t) rand();
+        }
+    }
+}
+
+static int
+process(NvFrameChecksum &checksum, synthetic_frame &frame, NvFrameChecksumEntry *entry = NULL)
+{
+    return checksum.processFrame(frame.planes, frame.row_bytes, frame.height,
+                                 frame.pitch, frame.num_planes, entry);
+}
+
+static int
+mock_map(int fd, NvFrameChecksumPlanes *planes, void *arg)
+{
+    mock_pool *pool = (mock_pool *) arg;
+    synthetic_frame &frame = pool->frames[fd - POOL_FIRST_FD];
+
+    pool->maps++;
+    if (fd == pool->fail_fd)
+        return -1;
+    planes->num_planes = frame.num_planes;
+    for (uint32_t i = 0; i < frame.num_planes; i++)
+    {
+        planes->data[i] = frame.planes[i];
+        planes->row_bytes[i] = frame.row_bytes[i];
+        planes->height[i] = frame.height[i];
+        planes->pitch[i] = frame.pitch[i];
+    }
+    return 0;
+}
+
+static void
+mock_unmap(int fd, void *arg)
+{
+    mock_pool *pool = (mock_pool *) arg;
+
+    pool->unmaps++;
+}
+
+static NvFrameChecksumOps
+mock_ops(mock_pool *pool)
+{
+    NvFrameChecksumOps ops;
+
+    ops.map = mock_map;
+    ops.unmap = mock_unmap;
+    ops.arg = pool;
+    return ops;
+}
+
+static int
+check_pool(const char *golden_path)
+{
+    mock_pool pool;
+    uint32_t queued = 0;
+    int fd, fds[POOL_BUFFERS];
+
+    pool.fail_fd = -1;
+    pool.maps = 0;
+    pool.unmaps = 0;
+    for (uint32_t i = 0; i < POOL_BUFFERS; i++)
+        alloc_frame(pool.frames[i], 640, 360, 768);
+
+    {
+        NvFrameChecksum checksum(mock_ops(&pool));
+
+        CHECK(checksum.open(NULL, golden_path) == 0, "open golden file");
+        CHECK(checksum.getBuffer() == -1, "empty pool does not return -1");
+        for (uint32_t i = 0; i < POOL_BUFFERS; i++)
+            checksum.addBuffer(POOL_FIRST_FD + i);
+
+        /* Every third buffer fails to convert and every third one fails to
+         * queue; both are put back, so the pool never runs dry. */
+        for (uint32_t i = 0; i < 12; i++)
+        {
+            fd = checksum.getBuffer();
+            CHECK(fd >= POOL_FIRST_FD, "pool ran dry at iteration " << i);
+            if (i % 3 == 1)
+            {
+                checksum.addBuffer(fd);
+                continue;
+            }
+            fill_frame(pool.frames[fd - POOL_FIRST_FD], queued);
+            if (i % 3 == 2)
+            {
+                CHECK(checksum.queueBuffer(fd, 0) < 0, "queueing 0 planes");
+                checksum.addBuffer(fd);
+                continue;
+            }
+            CHECK(checksum.queueBuffer(fd, 2) == 0, "queue buffer");
+            queued++;
+        }
+        checksum.waitIdle();
+        CHECK(checksum.getFrameCount() == queued, "queued frames not hashed");
+        CHECK(checksum.getMismatchCount() == 0, "queued frames do not match golden");
+
+        /* A buffer whose mapping fails still returns to the pool. */
+        fd = checksum.getBuffer();
+        pool.fail_fd = fd;
+        CHECK(checksum.queueBuffer(fd, 2) == 0, "queue unmappable buffer");
+        checksum.waitIdle();
+        CHECK(checksum.getFrameCount() == queued, "unmapped frame counted");
+
+        for (uint32_t i = 0; i < POOL_BUFFERS; i++)
+            fds[i] = checksum.getBuffer();
+        CHECK(checksum.getBuffer() == -1, "pool has more buffers than added");
+        CHECK(fds[0] != fds[1] && fds[0] >= 0 && fds[1] >= 0,
+              "buffers lost from the pool");
+        for (uint32_t i = 0; i < POOL_BUFFERS; i++)
+            checksum.addBuffer(fds[i]);
+
+        /* The golden file has more frames than were queued, so close()
+         * fails; only the unmapping is checked. */
+        checksum.close();
+        CHECK(pool.unmaps == POOL_BUFFERS, "pool buffers not unmapped");
+        CHECK(pool.maps == queued + 1, "map calls");
+    }
+
+    for (uint32_t i = 0; i < POOL_BUFFERS; i++)
+        free_frame(pool.frames[i]);
+    return 0;
+}
+
+static int
+check_crc(void)
+{
+    /* Known answer from RFC 3720. */
+    CHECK(NvFrameChecksum::crc32c(0, "123456789", 9) == 0xE3069283,
+          "CRC32C test vector");
+    CHECK(NvFrameChecksum::crc32c(NvFrameChecksum::crc32c(0, "1234", 4), "56789", 5) ==
+          0xE3069283, "CRC32C chaining");
+    return 0;
+}
+
+static int
+check_golden(const char *path)
+{
+    const uint32_t num_frames = 8;
+    synthetic_frame padded, packed;
+    NvFrameChecksumEntry entry_padded, entry_packed, parsed;
+
+    alloc_frame(padded, 640, 360, 768);
+    alloc_frame(packed, 640, 360, 640);
+
+    {
+        NvFrameChecksum checksum(mock_ops(NULL));
+        fill_frame(padded, 0);
+        fill_frame(packed, 0);
+        process(checksum, padded, &entry_padded);
+        process(checksum, packed, &entry_packed);
+        CHECK(!memcmp(entry_padded.crc, entry_packed.crc, sizeof(entry_packed.crc[0]) * 2),
+              "pitch padding changes the checksum");
+        CHECK(NvFrameChecksum::parseEntry(NvFrameChecksum::formatEntry(entry_padded), parsed) &&
+              parsed.num_planes == 2 && parsed.crc[1] == entry_padded.crc[1],
+              "checksum line round trip");
+    }
+
+    {
+        NvFrameChecksum checksum(mock_ops(NULL));
+        CHECK(checksum.open(path, NULL) == 0, "open checksum file");
+        for (uint32_t i = 0; i < num_frames; i++)
+        {
+            fill_frame(padded, i);
+            process(checksum, padded);
+        }
+        CHECK(checksum.close() == 0, "write checksum file");
+    }
+
+    {
+        NvFrameChecksum checksum(mock_ops(NULL));
+        CHECK(checksum.open(NULL, path) == 0, "open golden file");
+        for (uint32_t i = 0; i < num_frames; i++)
+        {
+            fill_frame(padded, i);
+            CHECK(process(checksum, padded) == 0, "frame " << i << " does not match golden");
+        }
+        CHECK(checksum.close() == 0, "golden comparison");
+    }
+
+    {
+        NvFrameChecksum checksum(mock_ops(NULL));
+        CHECK(checksum.open(NULL, path) == 0, "open golden file");
+        for (uint32_t i = 0; i < num_frames; i++)
+        {
+            fill_frame(padded, i);
+            if (i == 5)
+                padded.planes[1][padded.pitch[1] * 100 + 321] ^= 1;
+            process(checksum, padded);
+        }
+        CHECK(checksum.getMismatchCount() == 1, "changed pixel not detected");
+        checksum.close();
+    }
+
+    free_frame(padded);
+    free_frame(packed);
+    return 0;
+}
+
+static void
+run_benchmark(uint32_t width, uint32_t height, uint32_t iterations)
+{
+    NvFrameChecksum checksum(mock_ops(NULL));
+    synthetic_frame frame;
+    struct timespec start, stop;
+    double sec, bytes;
+
+    alloc_frame(frame, width, height, (width + 255) & ~255);
+    fill_frame(frame, 0);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < iterations; i++)
+        process(checksum, frame);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    sec = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+    bytes = (double) width * height * 3 / 2 * iterations;
+    cout << "Hashed " << iterations << " NV12 " << width << "x" << height <<
+        " frames: " << sec * 1000 / iterations << " ms/frame, " <<
+        bytes / sec / 1e9 << " GB/s" << endl;
+
+    free_frame(frame);
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t width = 3840, height = 2160, iterations = 100;
+    char path[] = "/tmp/checksum_sample_XXXXXX";
+    UnitSampleTable table;
+    UnitSampleArgs args("./checksum_sample");
+    int fd;
+
+    args.usage("", "Run the checks on synthetic frames")
+        .usage("-b [width] [height] [iterations]",
+               "Measure hashing throughput [Default = 3840 2160 100]");
+
+    if (argc < 2)
+    {
+        fd = mkstemp(path);
+        if (fd < 0)
+        {
+            cerr << "Could not create temporary file" << endl;
+            return -1;
+        }
+        close(fd);
+
+        table.row("crc32c", check_crc() == 0);
+        /* The pool compares against the file written by check_golden(). */
+        table.row("golden", check_golden(path) == 0);
+        table.row("pool", check_pool(path) == 0);
+        unlink(path);
+        return table.print() ? 0 : -1;
+    }
+
+    if (strcmp(argv[1], "-b"))
+    {
+        args.printHelp();
+        return strcmp(argv[1], "-h") && strcmp(argv[1], "--help") ? -1 : 0;
+    }
+    if (argc >= 3)
+        width = atoi(argv[2]);
+    if (argc >= 4)
+        height = atoi(argv[3]);
+    if (argc >= 5)
+        iterations = atoi(argv[4]);
+    if (width == 0 || height == 0 || iterations == 0)
+    {
+        cerr << "Width, height and iterations should be positive integers" << endl;
+        return -1;
+    }
+
+    run_benchmark(width, height, iterations);
+    return 0;
+}
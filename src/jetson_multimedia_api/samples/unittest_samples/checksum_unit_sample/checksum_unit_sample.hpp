@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvFrameChecksum.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds a synthetic frame in system memory.
+ */
+typedef struct
+{
+    /** Number of planes. */
+    uint32_t num_planes;
+    /** Start of each plane. */
+    uint8_t *planes[NV_FRAME_CHECKSUM_MAX_PLANES];
+    /** Visible bytes per row of each plane. */
+    uint32_t row_bytes[NV_FRAME_CHECKSUM_MAX_PLANES];
+    /** Number of rows of each plane. */
+    uint32_t height[NV_FRAME_CHECKSUM_MAX_PLANES];
+    /** Bytes between the starts of two rows of each plane. */
+    uint32_t pitch[NV_FRAME_CHECKSUM_MAX_PLANES];
+} synthetic_frame;
+
+/** Number of buffers of the mocked checksum pool. */
+#define POOL_BUFFERS 2
+/** FD of the first buffer of the mocked checksum pool. */
+#define POOL_FIRST_FD 100
+
+/**
+ * Holds the buffers of the mocked checksum pool, read through
+ * NvFrameChecksumOps instead of NvBufSurface.
+ */
+typedef struct
+{
+    /** Frame of each buffer, FD POOL_FIRST_FD + index. */
+    synthetic_frame frames[POOL_BUFFERS];
+    /** FD whose mapping fails, or -1. */
+    int fail_fd;
+    /** Number of map calls. */
+    uint32_t maps;
+    /** Number of unmap calls. */
+    uint32_t unmaps;
+} mock_pool;
+
+/**
+ * @brief Allocates a synthetic NV12 frame with padded rows.
+ *
+ * @param[out] frame Frame to allocate
+ * @param[in] width Width of the frame in pixels
+ * @param[in] height Height of the frame in pixels
+ * @param[in] pitch Row pitch in bytes, at least @a width
+ */
+static void
+alloc_frame(synthetic_frame &frame, uint32_t width, uint32_t height, uint32_t pitch);
+
+/**
+ * @brief Fills the visible region of a synthetic frame with a pattern
+ * that depends on the frame index, and the padding with garbage.
+ *
+ * @param[in] frame Frame to fill
+ * @param[in] index Frame index
+ */
+static void
+fill_frame(synthetic_frame &frame, uint32_t index);
+
+/**
+ * @brief Checks the buffer pool the way the decoder samples use it,
+ * including the buffers put back after a failed conversion or queueing.
+ *
+ * @param[in] golden_path Golden file of the frames filled by fill_frame()
+ * @return 0 if all checks pass, -1 otherwise
+ */
+static int
+check_pool(const char *golden_path);
+
+/**
+ * @brief Checks CRC32C against known answers.
+ *
+ * @return 0 if all checks pass, -1 otherwise
+ */
+static int
+check_crc(void);
+
+/**
+ * @brief Checks writing a checksum file and comparing frames against it.
+ *
+ * @param[in] golden_path File to write, then read back as golden file
+ * @return 0 if all checks pass, -1 otherwise
+ */
+static int
+check_golden(const char *golden_path);
+
+/**
+ * @brief Measures the hashing throughput on a synthetic frame.
+ *
+ * @param[in] width Width of the frame in pixels
+ * @param[in] height Height of the frame in pixels
+ * @param[in] iterations Number of frames hashed
+ */
+static void
+run_benchmark(uint32_t width, uint32_t height, uint32_t iterations);
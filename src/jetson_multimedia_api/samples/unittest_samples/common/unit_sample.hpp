@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Command line and result table shared by the unit samples.
+ *
+ * Each unit sample describes its options with UnitSampleArgs, which prints
+ * the help and parses them with getopt(), and reports its tests with
+ * UnitSampleTable, one row per test ending with a PASS, FAIL or SKIP column.
+**/
+
+#ifndef __UNIT_SAMPLE_HPP__
+#define __UNIT_SAMPLE_HPP__
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Describes the command line of a unit sample.
+ */
+class UnitSampleArgs
+{
+public:
+    /**
+     * @param[in] app Command of the sample, e.g. "./log_sample".
+     */
+    UnitSampleArgs(const char *app)
+        : app(app), about(NULL)
+    {
+    }
+
+    /**
+     * Adds a usage line, for samples taking other arguments than options.
+     * Without usage lines, one is made from the options.
+     *
+     * @param[in] args Arguments following the command.
+     * @param[in] help Description of the usage.
+     */
+    UnitSampleArgs &usage(const char *args, const char *help)
+    {
+        usages.push_back(Usage(args, help));
+        return *this;
+    }
+
+    /**
+     * Sets the description printed below the command line made from the
+     * options.
+     */
+    UnitSampleArgs &description(const char *text)
+    {
+        about = text;
+        return *this;
+    }
+
+    /**
+     * Adds an option.
+     *
+     * @param[in] name Option character.
+     * @param[in] arg Name of the argument of the option, or NULL for a flag.
+     * @param[in] help Description of the option.
+     * @param[in] default_value Value used without the option, printed with
+     *                          the help.
+     */
+    template<typename T>
+    UnitSampleArgs &option(char name, const char *arg, const char *help,
+                           const T &default_value)
+    {
+        std::ostringstream value;
+
+        value << default_value;
+        options.push_back(Option(name, arg, help, value.str()));
+        return *this;
+    }
+
+    UnitSampleArgs &option(char name, const char *arg, const char *help)
+    {
+        options.push_back(Option(name, arg, help, ""));
+        return *this;
+    }
+
+    /**
+     * Prints the help.
+     */
+    void printHelp() const
+    {
+        std::cout << "Help:" << std::endl;
+        std::cout << "Execution cmd:" << std::endl;
+        if (usages.empty())
+        {
+            std::string line = app;
+
+            for (size_t i = 0; i < options.size(); i++)
+            {
+                std::string option = std::string(" [-") + options[i].name;
+                if (options[i].arg)
+                    option += std::string(" ") + options[i].arg;
+                option += "]";
+                /* Wrap long command lines below the first option */
+                if (line.size() + option.size() > 80 && i > 0)
+                {
+                    std::cout << line << std::endl;
+                    line = std::string(strlen(app), ' ');
+                }
+                line += option;
+            }
+            std::cout << line << std::endl;
+            if (about)
+                std::cout << "\t" << about << std::endl;
+        }
+        for (size_t i = 0; i < usages.size(); i++)
+        {
+            std::cout << app;
+            if (*usages[i].args)
+                std::cout << " " << usages[i].args;
+            std::cout << std::endl << "\t" << usages[i].help << std::endl;
+        }
+        for (size_t i = 0; i < options.size(); i++)
+        {
+            std::string flag = std::string("-") + options[i].name;
+            if (options[i].arg)
+                flag += std::string(" ") + options[i].arg;
+            std::cout << "\t" << std::left << std::setw(16) << flag <<
+                std::right << options[i].help;
+            if (!options[i].default_value.empty())
+                std::cout << " [Default = " << options[i].default_value << "]";
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * Gets the next option with getopt(); its argument is in @c optarg.
+     *
+     * @return The option character, '?' for an unknown option, -1 at the
+     *         end of the options.
+     */
+    int next(int argc, char const *argv[])
+    {
+        if (optstring.empty())
+        {
+            for (size_t i = 0; i < options.size(); i++)
+            {
+                optstring += options[i].name;
+                if (options[i].arg)
+                    optstring += ':';
+            }
+            optstring += 'h';
+        }
+        return getopt(argc, (char **) argv, optstring.c_str());
+    }
+
+    /**
+     * Prints the help for -h or an unknown option.
+     *
+     * @return The exit code of the sample: 0 for -h, -1 otherwise.
+     */
+    int exitHelp(int opt) const
+    {
+        printHelp();
+        return opt == 'h' ? 0 : -1;
+    }
+
+    /**
+     * Parses a size given as <width>x<height>.
+     *
+     * @return True if both dimensions are positive.
+     */
+    static bool parseSize(const char *arg, uint32_t *width, uint32_t *height)
+    {
+        char *end;
+
+        *width = strtoul(arg, &end, 10);
+        if (*end != 'x')
+            return false;
+        *height = strtoul(end + 1, &end, 10);
+        return *end == '\0' && *width > 0 && *height > 0;
+    }
+
+private:
+    struct Usage
+    {
+        Usage(const char *args, const char *help)
+            : args(args), help(help)
+        {
+        }
+        const char *args;
+        const char *help;
+    };
+
+    struct Option
+    {
+        Option(char name, const char *arg, const char *help,
+               const std::string &default_value)
+            : name(name), arg(arg), help(help), default_value(default_value)
+        {
+        }
+        char name;
+        const char *arg;
+        const char *help;
+        std::string default_value;
+    };
+
+    const char *app;
+    const char *about;
+    std::vector<Usage> usages;
+    std::vector<Option> options;
+    std::string optstring;
+};
+
+/**
+ * Table of the test results of a unit sample.
+ *
+ * Columns are declared with column(), then every test adds a row and
+ * streams its values into the columns in order:
+ * @code
+ * table.row("warm start", ok) << stats.builds << stats.hits;
+ * @endcode
+ */
+class UnitSampleTable
+{
+public:
+    /**
+     * Holds one row; values streamed into it fill the next column.
+     */
+    class Row
+    {
+    public:
+        template<typename T>
+        Row &operator<<(const T &value)
+        {
+            std::ostringstream cell;
+
+            if (cells.size() < table->columns.size() &&
+                table->columns[cells.size()].precision >= 0)
+                cell << std::fixed <<
+                    std::setprecision(table->columns[cells.size()].precision);
+            cell << value;
+            cells.push_back(cell.str());
+            return *this;
+        }
+
+    private:
+        friend class UnitSampleTable;
+
+        Row(const UnitSampleTable *table, const std::string &name, bool ok)
+            : table(table), name(name), ok(ok), skipped(false)
+        {
+        }
+
+        const UnitSampleTable *table;
+        std::string name;
+        bool ok;
+        bool skipped;
+        std::vector<std::string> cells;
+    };
+
+    /**
+     * @param[in] name_width Width of the test name column.
+     */
+    UnitSampleTable(int name_width = 14)
+        : name_width(name_width)
+    {
+    }
+
+    /**
+     * Adds a column.
+     *
+     * @param[in] header Header of the column.
+     * @param[in] width Width of the column, right aligned.
+     * @param[in] precision Digits after the decimal point of floating
+     *                      point values, or -1 for the stream default.
+     */
+    UnitSampleTable &column(const char *header, int width, int precision = -1)
+    {
+        columns.push_back(Column(header, width, precision));
+        return *this;
+    }
+
+    /**
+     * Adds the row of a test.
+     *
+     * @param[in] name Name of the test.
+     * @param[in] ok True if the checks of the test passed.
+     * @return The row, to stream the values of the columns into.
+     */
+    Row &row(const std::string &name, bool ok)
+    {
+        rows.push_back(Row(this, name, ok));
+        return rows.back();
+    }
+
+    /**
+     * Adds the row of a test that could not run on this system. It counts
+     * as passed.
+     *
+     * @param[in] name Name of the test.
+     */
+    Row &skip(const std::string &name)
+    {
+        rows.push_back(Row(this, name, true));
+        rows.back().skipped = true;
+        return rows.back();
+    }
+
+    /**
+     * @return True if the checks of every test passed.
+     */
+    bool passed() const
+    {
+        for (size_t i = 0; i < rows.size(); i++)
+        {
+            if (!rows[i].ok)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Prints the table.
+     *
+     * @return True if the checks of every test passed.
+     */
+    bool print() const
+    {
+        std::cout << std::left << std::setw(name_width) << "test" << std::right;
+        for (size_t i = 0; i < columns.size(); i++)
+            std::cout << std::setw(columns[i].width) << columns[i].header;
+        std::cout << std::setw(8) << "check" << std::endl;
+
+        for (size_t i = 0; i < rows.size(); i++)
+        {
+            std::cout << std::left << std::setw(name_width) << rows[i].name <<
+                std::right;
+            for (size_t j = 0; j < columns.size(); j++)
+                std::cout << std::setw(columns[j].width) <<
+                    (j < rows[i].cells.size() ? rows[i].cells[j] : "-");
+            std::cout << std::setw(8) <<
+                (rows[i].skipped ? "SKIP" : rows[i].ok ? "PASS" : "FAIL") << std::endl;
+        }
+        return passed();
+    }
+
+private:
+    struct Column
+    {
+        Column(const char *header, int width, int precision)
+            : header(header), width(width), precision(precision)
+        {
+        }
+        const char *header;
+        int width;
+        int precision;
+    };
+
+    int name_width;
+    std::vector<Column> columns;
+    std::vector<Row> rows;
+};
+
+#endif
@@ -0,0 +1,511 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./cuda_executor_sample [-n <jobs>] [-s <streams>] [-t <threads>] [-w <usec>]
+ * Example:
+ * ./cuda_executor_sample
+ * ./cuda_executor_sample -s 2 -w 5000
+**/
+
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "cuda_executor_unit_sample.hpp"
+
+/**
+ * Shared CUDA stream executor.
+ *
+ * NvCudaProc and the CUDA samples submit their work to one
+ * NvCudaExecutor, which spreads it over a pool of streams per priority
+ * level and orders dependent jobs with events instead of synchronizing
+ * the device.
+ *
+ * This sample runs the executor on NvCpuStreams, which executes the
+ * streams on threads with the ordering rules of CUDA streams, and checks:
+ * ## A random graph of jobs runs every job once, after its dependencies
+ * ## Independent jobs run concurrently on the streams of a level
+ * ## A chain of jobs stays on one stream without event waits
+ * ## A join waits with events only for the inputs on other streams
+ * ## Jobs only run on the streams of their priority level
+ * ## run() reports the time of the job
+ * ## Threads submitting and waiting concurrently
+**/
+
+#define DEFAULT_JOBS 200
+#define DEFAULT_STREAMS 4
+#define DEFAULT_THREADS 4
+#define DEFAULT_WORK_USEC 10000
+#define MAX_DEPS 3
+#define NUM_LEVELS 2
+
+static const int priorities[NUM_LEVELS] = { 0, 1 };
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Job body: records when it starts and ends in the order of the graph. */
+static void
+run_job(void *stream, void *user)
+{
+    graph_job *job = (graph_job *) user;
+    job_graph *graph = job->graph;
+
+    pthread_mutex_lock(&graph->lock);
+    job->start = ++graph->sequence;
+    job->stream = stream;
+    job->runs++;
+    pthread_mutex_unlock(&graph->lock);
+
+    if (job->work_usec)
+        usleep(job->work_usec);
+
+    pthread_mutex_lock(&graph->lock);
+    job->end = ++graph->sequence;
+    pthread_mutex_unlock(&graph->lock);
+}
+
+static void
+add_job(vector<graph_job> &jobs, job_graph *graph, uint32_t work_usec, uint32_t level)
+{
+    graph_job job;
+
+    job.graph = graph;
+    job.work_usec = work_usec;
+    job.level = level;
+    job.id = 0;
+    job.start = 0;
+    job.end = 0;
+    job.stream = NULL;
+    job.runs = 0;
+    jobs.push_back(job);
+}
+
+static bool
+submit_graph(NvCudaExecutor &executor, vector<graph_job> &jobs)
+{
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        vector<NvCudaJob> deps;
+
+        for (size_t j = 0; j < jobs[i].deps.size(); j++)
+            deps.push_back(jobs[jobs[i].deps[j]].id);
+        jobs[i].id = executor.submit(run_job, &jobs[i], jobs[i].level,
+                deps.empty() ? NULL : &deps[0], deps.size());
+        if (jobs[i].id == 0)
+            return false;
+    }
+    return true;
+}
+
+static bool
+check_graph(const vector<graph_job> &jobs)
+{
+    bool ok = true;
+
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i].runs != 1)
+        {
+            cerr << "FAIL: job " << i << " ran " << jobs[i].runs << " times" << endl;
+            ok = false;
+            continue;
+        }
+        for (size_t j = 0; j < jobs[i].deps.size(); j++)
+        {
+            const graph_job &dep = jobs[jobs[i].deps[j]];
+
+            if (dep.end > jobs[i].start)
+            {
+                cerr << "FAIL: job " << i << " started before its dependency " <<
+                    jobs[i].deps[j] << " ended" << endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+static void
+init_graph(job_graph *graph)
+{
+    pthread_mutex_init(&graph->lock, NULL);
+    graph->sequence = 0;
+}
+
+static void
+get_counts(executor_counts &counts, NvCudaExecutor &executor, uint64_t start)
+{
+    counts.jobs = 0;
+    counts.event_waits = 0;
+    for (uint32_t i = 0; i < executor.getNumStreams(); i++)
+    {
+        NvCudaStreamStats stats = executor.getStreamStats(i);
+
+        counts.jobs += stats.jobs;
+        counts.event_waits += stats.event_waits;
+    }
+    counts.msec = (get_time_usec() - start) / 1000.0;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const executor_counts &counts, bool ok)
+{
+    table.row(name, ok) << counts.jobs << counts.event_waits << counts.msec;
+}
+
+/* Jobs of level 0 run on the first streams, as created by the executor. */
+static uint64_t
+level_jobs(NvCudaExecutor &executor, uint32_t level, uint32_t num_streams)
+{
+    uint64_t jobs = 0;
+
+    for (uint32_t i = 0; i < num_streams; i++)
+        jobs += executor.getStreamStats(level * num_streams + i).jobs;
+    return jobs;
+}
+
+/* Submits a chain with joins on earlier jobs, waiting on some jobs. */
+static void *
+submit_thread_func(void *arg)
+{
+    submit_thread *thread = (submit_thread *) arg;
+    vector<graph_job> &jobs = thread->jobs;
+    unsigned int seed = (uintptr_t) thread;
+
+    thread->ok = true;
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        vector<NvCudaJob> deps;
+
+        if (i > 0)
+            jobs[i].deps.push_back(i - 1);
+        if (i > 4)
+            jobs[i].deps.push_back(rand_r(&seed) % (i - 1));
+        for (size_t j = 0; j < jobs[i].deps.size(); j++)
+            deps.push_back(jobs[jobs[i].deps[j]].id);
+
+        jobs[i].id = thread->executor->submit(run_job, &jobs[i], jobs[i].level,
+                deps.empty() ? NULL : &deps[0], deps.size());
+        if (jobs[i].id == 0)
+        {
+            thread->ok = false;
+            return NULL;
+        }
+        if (i % 10 == 9 && thread->executor->wait(jobs[i - 5].id) < 0)
+            thread->ok = false;
+    }
+    if (!jobs.empty() && thread->executor->wait(jobs.back().id) < 0)
+        thread->ok = false;
+    return NULL;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(12);
+    UnitSampleArgs args("./cuda_executor_sample");
+    uint32_t num_jobs = DEFAULT_JOBS;
+    uint32_t num_streams = DEFAULT_STREAMS;
+    uint32_t num_threads = DEFAULT_THREADS;
+    uint32_t work_usec = DEFAULT_WORK_USEC;
+    int opt;
+
+    args.option('n', "<jobs>", "Jobs in the random graph", DEFAULT_JOBS)
+        .option('s', "<streams>", "Streams per priority level", DEFAULT_STREAMS)
+        .option('t', "<threads>", "Threads in the concurrent test", DEFAULT_THREADS)
+        .option('w', "<usec>", "Time of one job", DEFAULT_WORK_USEC);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                num_jobs = atoi(optarg);
+                break;
+            case 's':
+                num_streams = atoi(optarg);
+                break;
+            case 't':
+                num_threads = atoi(optarg);
+                break;
+            case 'w':
+                work_usec = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (num_jobs == 0 || num_streams == 0 || num_threads == 0 || work_usec < 1000)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("jobs", 10).column("event waits", 14).column("ms", 12, 1);
+
+    /* Random graph over both levels */
+    {
+        NvCpuStreams cpu;
+        NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, num_streams);
+        vector<graph_job> jobs;
+        job_graph graph;
+        unsigned int seed = 1;
+        executor_counts counts;
+        uint64_t start;
+        bool ok;
+
+        init_graph(&graph);
+        for (uint32_t i = 0; i < num_jobs; i++)
+        {
+            uint32_t num_deps = i ? rand_r(&seed) % (MAX_DEPS + 1) : 0;
+
+            add_job(jobs, &graph, rand_r(&seed) % (work_usec / 4), rand_r(&seed) % NUM_LEVELS);
+            for (uint32_t j = 0; j < num_deps; j++)
+                jobs[i].deps.push_back(i - 1 - rand_r(&seed) % min(i, 8u));
+        }
+
+        start = get_time_usec();
+        ok = submit_graph(executor, jobs);
+        ok = executor.waitAll() == 0 && ok;
+        ok = check_graph(jobs) && ok;
+        get_counts(counts, executor, start);
+        ok = ok && counts.jobs == num_jobs;
+        add_result(table, "graph", counts, ok);
+        pthread_mutex_destroy(&graph.lock);
+    }
+
+    /* Independent jobs on one stream, then on all the streams of the level */
+    {
+        const uint32_t count = 4 * num_streams;
+        double serial_msec = 0;
+
+        for (uint32_t pass = 0; pass < 2; pass++)
+        {
+            uint32_t streams = pass ? num_streams : 1;
+            NvCpuStreams cpu;
+            NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, streams);
+            vector<graph_job> jobs;
+            job_graph graph;
+            executor_counts counts;
+            uint64_t start;
+            bool ok;
+
+            init_graph(&graph);
+            for (uint32_t i = 0; i < count; i++)
+                add_job(jobs, &graph, work_usec, 0);
+
+            start = get_time_usec();
+            ok = submit_graph(executor, jobs);
+            ok = executor.waitAll() == 0 && ok;
+            ok = check_graph(jobs) && ok;
+            ok = cpu.getMaxConcurrency() == streams && ok;
+            get_counts(counts, executor, start);
+            if (pass == 0)
+                serial_msec = counts.msec;
+            else if (num_streams > 1)
+                ok = ok && counts.msec < serial_msec * 0.75;
+            add_result(table, pass ? "parallel" : "serial", counts, ok);
+            pthread_mutex_destroy(&graph.lock);
+        }
+    }
+
+    /* A chain stays on the stream of its first job */
+    {
+        NvCpuStreams cpu;
+        NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, num_streams);
+        vector<graph_job> jobs;
+        job_graph graph;
+        executor_counts counts;
+        uint64_t chained = 0;
+        uint64_t start;
+        bool ok;
+
+        init_graph(&graph);
+        for (uint32_t i = 0; i < 20; i++)
+        {
+            add_job(jobs, &graph, work_usec / 10, 1);
+            if (i)
+                jobs[i].deps.push_back(i - 1);
+        }
+
+        start = get_time_usec();
+        ok = submit_graph(executor, jobs);
+        ok = executor.waitAll() == 0 && ok;
+        ok = check_graph(jobs) && ok;
+        for (size_t i = 1; i < jobs.size(); i++)
+            ok = ok && jobs[i].stream == jobs[0].stream;
+        for (uint32_t i = 0; i < executor.getNumStreams(); i++)
+            chained += executor.getStreamStats(i).chained;
+        get_counts(counts, executor, start);
+        ok = ok && chained == jobs.size() - 1 && counts.event_waits == 0;
+        add_result(table, "chain", counts, ok);
+        pthread_mutex_destroy(&graph.lock);
+    }
+
+    /* A join of independent jobs waits for the ones on other streams */
+    {
+        NvCpuStreams cpu;
+        NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, num_streams);
+        vector<graph_job> jobs;
+        job_graph graph;
+        executor_counts counts;
+        uint64_t expected = 0;
+        uint64_t start;
+        bool ok;
+
+        init_graph(&graph);
+        for (uint32_t i = 0; i < 2 * num_streams; i++)
+            add_job(jobs, &graph, work_usec, 0);
+        add_job(jobs, &graph, 0, 0);
+        for (uint32_t i = 0; i < 2 * num_streams; i++)
+            jobs.back().deps.push_back(i);
+
+        start = get_time_usec();
+        ok = submit_graph(executor, jobs);
+        ok = executor.waitAll() == 0 && ok;
+        ok = check_graph(jobs) && ok;
+        for (uint32_t i = 0; i < 2 * num_streams; i++)
+        {
+            if (jobs[i].stream != jobs.back().stream)
+                expected++;
+        }
+        get_counts(counts, executor, start);
+        ok = ok && counts.event_waits == expected;
+        add_result(table, "join", counts, ok);
+        pthread_mutex_destroy(&graph.lock);
+    }
+
+    /* Jobs of one level leave the streams of the other level idle */
+    {
+        NvCpuStreams cpu;
+        NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, num_streams);
+        vector<graph_job> jobs;
+        job_graph graph;
+        executor_counts counts;
+        uint64_t start;
+        bool ok;
+
+        init_graph(&graph);
+        for (uint32_t i = 0; i < 4 * num_streams; i++)
+            add_job(jobs, &graph, work_usec / 10, 0);
+
+        start = get_time_usec();
+        ok = submit_graph(executor, jobs);
+        ok = executor.waitAll() == 0 && ok;
+        ok = check_graph(jobs) && ok;
+        ok = level_jobs(executor, 0, num_streams) == jobs.size() &&
+            level_jobs(executor, 1, num_streams) == 0 && ok;
+        for (uint32_t i = 0; i < executor.getNumStreams(); i++)
+            ok = executor.getStreamStats(i).priority == priorities[i / num_streams] && ok;
+        get_counts(counts, executor, start);
+        add_result(table, "levels", counts, ok);
+        pthread_mutex_destroy(&graph.lock);
+    }
+
+    /* run() waits for the job and returns its time */
+    {
+        NvCpuStreams cpu;
+        NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, num_streams);
+        vector<graph_job> jobs;
+        job_graph graph;
+        executor_counts counts;
+        float msec = 0;
+        uint64_t start;
+        bool ok;
+
+        init_graph(&graph);
+        add_job(jobs, &graph, work_usec, 1);
+        add_job(jobs, &graph, work_usec, 1);
+
+        start = get_time_usec();
+        ok = executor.run(run_job, &jobs[0], 1, &msec) == 0;
+        ok = jobs[0].runs == 1 && jobs[0].end != 0 && ok;
+        ok = msec >= work_usec / 1000.0 * 0.9 && msec < work_usec / 1000.0 + 50 && ok;
+        jobs[1].id = executor.submit(run_job, &jobs[1], 1);
+        ok = executor.wait(jobs[1].id, &msec) == 0 && ok;
+        ok = jobs[1].end != 0 && msec >= work_usec / 1000.0 * 0.9 && ok;
+        /* A retired job is complete, with no time left to report */
+        ok = executor.wait(jobs[1].id, &msec) == 0 && msec == 0 && ok;
+        ok = executor.wait(jobs[1].id + 1) < 0 && ok;
+        get_counts(counts, executor, start);
+        add_result(table, "timing", counts, ok);
+        pthread_mutex_destroy(&graph.lock);
+    }
+
+    /* Threads submitting graphs and waiting concurrently */
+    {
+        NvCpuStreams cpu;
+        NvCudaExecutor executor(cpu.getOps(), priorities, NUM_LEVELS, num_streams);
+        vector<submit_thread> threads(num_threads);
+        vector<pthread_t> tids(num_threads);
+        job_graph graph;
+        executor_counts counts;
+        uint64_t start;
+        bool ok = true;
+
+        init_graph(&graph);
+        for (uint32_t t = 0; t < num_threads; t++)
+        {
+            threads[t].executor = &executor;
+            for (uint32_t i = 0; i < num_jobs / num_threads + 1; i++)
+                add_job(threads[t].jobs, &graph, (i * 37 + t * 11) % (work_usec / 10), t % NUM_LEVELS);
+        }
+
+        start = get_time_usec();
+        for (uint32_t t = 0; t < num_threads; t++)
+            pthread_create(&tids[t], NULL, submit_thread_func, &threads[t]);
+        for (uint32_t t = 0; t < num_threads; t++)
+            pthread_join(tids[t], NULL);
+        ok = executor.waitAll() == 0 && ok;
+        for (uint32_t t = 0; t < num_threads; t++)
+            ok = threads[t].ok && check_graph(threads[t].jobs) && ok;
+        get_counts(counts, executor, start);
+        ok = ok && counts.jobs == (uint64_t) num_threads * (num_jobs / num_threads + 1);
+        add_result(table, "threads", counts, ok);
+        pthread_mutex_destroy(&graph.lock);
+    }
+
+    cout << "Streams per level " << num_streams << ", job " << work_usec << " us" << endl;
+    return table.print() ? 0 : -1;
+}
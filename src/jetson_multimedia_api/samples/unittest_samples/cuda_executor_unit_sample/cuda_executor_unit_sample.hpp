@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "NvCpuStreams.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the state shared by the jobs of a graph.
+ */
+typedef struct
+{
+    /** Protects the sequence counter and the job records. */
+    pthread_mutex_t lock;
+    /** Counter ordering the start and the end of all the jobs. */
+    uint64_t sequence;
+} job_graph;
+
+/**
+ * Holds one job of a graph and what happened when it ran.
+ */
+typedef struct
+{
+    /** Graph of the job. */
+    job_graph *graph;
+    /** Time the job runs, in microseconds. */
+    uint32_t work_usec;
+    /** Priority level the job is submitted at. */
+    uint32_t level;
+    /** Indices of the jobs it depends on, all lower than its own. */
+    std::vector<uint32_t> deps;
+    /** Identifier returned by the executor. */
+    NvCudaJob id;
+    /** Sequence number of the start of the job. */
+    uint64_t start;
+    /** Sequence number of the end of the job. */
+    uint64_t end;
+    /** Stream the job ran on. */
+    void *stream;
+    /** Number of times the job ran. */
+    uint32_t runs;
+} graph_job;
+
+/**
+ * Holds one thread of the concurrent test.
+ */
+typedef struct
+{
+    /** Executor shared by the threads. */
+    NvCudaExecutor *executor;
+    /** Jobs the thread submits. */
+    std::vector<graph_job> jobs;
+    /** True if every submission and wait succeeded. */
+    bool ok;
+} submit_thread;
+
+/**
+ * Holds the work of the executor over one test.
+ */
+typedef struct
+{
+    /** Jobs run. */
+    uint64_t jobs;
+    /** Dependencies waited for on another stream. */
+    uint64_t event_waits;
+    /** Wall clock time of the test, in milliseconds. */
+    double msec;
+} executor_counts;
+
+/**
+ * @brief Submits the jobs of a graph in order, with their dependencies.
+ *
+ * @param[in] executor Executor to submit to
+ * @param[in] jobs Jobs of the graph
+ * @return true if every job was accepted
+ */
+static bool
+submit_graph(NvCudaExecutor &executor, std::vector<graph_job> &jobs);
+
+/**
+ * @brief Checks that every job ran once, after all its dependencies.
+ *
+ * @param[in] jobs Jobs of the graph, after NvCudaExecutor::waitAll()
+ * @return true if the order is valid
+ */
+static bool
+check_graph(const std::vector<graph_job> &jobs);
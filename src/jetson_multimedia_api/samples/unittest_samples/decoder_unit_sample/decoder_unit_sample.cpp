@@ -28,7 +28,8 @@
 
 /**
  * Execution command:
- * ./decode_sample elementary_h264file.264 output_raw_file.yuv
+ * ./decode_sample elementary_h264file.264 output_raw_file.yuv [--direct-io]
+ * ./decode_sample elementary_h264file.264 --frame-checksum checksum_file [golden_checksum_file]
 **/
 
 #include <iostream>
@@ -51,6 +52,8 @@
 #include "nvbufsurface.h"
 #include "nvbufsurftransform.h"
 #include "v4l2_nv_extensions.h"
+#include "NvFrameChecksum.h"
+#include "NvRawFrameSink.h"
 
 using namespace std;
 
@@ -310,83 +313,6 @@ read_input_chunk(ifstream * stream, Buffer * buffer)
     }
 }
 
-/**
- * This function writes the video frame from the HW buffer
- * exported as FD into the destination file.
- * Using the FD, HW buffer parameters are filled by calling
- * NvBufSurfaceFromFd. The parameters received from the buffer are
- * then used to read the planar stream from the HW buffer into the
- * output filestream.
- *
- * For reading from the HW buffer:
- * A void data-pointer is created which stores the memory-mapped
- * virtual addresses of the planes.
- * For each plane, NvBufSurfaceMap is called which gets the
- * memory-mapped virtual address of the plane with the access
- * pointed by the flag.
- * Before the mapped memory is accessed, a call to NvBufSurfaceSyncForCpu()
- * must be present before any access is made by the CPU to the buffer.
- *
- * After reading the data, the memory-mapped virtual address of the
- * plane is unmapped.
- */
-static int
-dump_raw_dmabuf(int dmabuf_fd, unsigned int plane, ofstream * stream)
-{
-    if (dmabuf_fd <= 0)
-    {
-        return -1;
-    }
-
-    int ret_val;
-    NvBufSurface *nvbuf_surf = 0;
-
-    ret_val = NvBufSurfaceFromFd (dmabuf_fd, (void**)(&nvbuf_surf));
-    if (ret_val != 0)
-    {
-        cerr << "NvBufSurfaceFromFd failed\n" << endl;
-        return -1;
-    }
-
-    void *psrc_data;
-
-    ret_val = NvBufSurfaceMap(nvbuf_surf, 0, plane, NVBUF_MAP_READ_WRITE);
-    if (ret_val == 0)
-    {
-        unsigned int i = 0;
-        psrc_data = (void*)nvbuf_surf->surfaceList[0].mappedAddr.addr[plane];
-
-        NvBufSurfaceSyncForCpu (nvbuf_surf, 0, plane);
-
-        for (i = 0; i < nvbuf_surf->surfaceList[0].planeParams.height[plane]; ++i)
-        {
-            // For semiplanar format, UV plane has twice the bpp requirement.
-            if ((nvbuf_surf->surfaceList[0].colorFormat == NVBUF_COLOR_FORMAT_NV12) && plane == 1)
-            {
-                stream->write((char *)psrc_data + i * nvbuf_surf->surfaceList[0].planeParams.pitch[plane],
-                                nvbuf_surf->surfaceList[0].planeParams.width[plane] * 2);
-                if (!stream->good())
-                    return -1;
-            }
-            else
-            {
-                stream->write((char *)psrc_data + i * nvbuf_surf->surfaceList[0].planeParams.pitch[plane],
-                                nvbuf_surf->surfaceList[0].planeParams.width[plane]);
-                if (!stream->good())
-                    return -1;
-            }
-        }
-        NvBufSurfaceUnMap(nvbuf_surf, 0, plane);
-    }
-    else
-    {
-        cout << "NvBufSurfaceMap failed \n";
-        return -1;
-    }
-
-    return 0;
-}
-
 static int
 set_capture_plane_format(context_t * ctx, uint32_t pixfmt,
     uint32_t width, uint32_t height)
@@ -479,6 +405,10 @@ query_set_capture(context_t * ctx)
 
     if (ctx->dst_dma_fd != -1)
     {
+        // The sink keeps the buffer mapped, release it first.
+        if (ctx->out_sink)
+            ctx->out_sink->forget(ctx->dst_dma_fd);
+
         ret_val = NvBufSurfaceFromFd((int)ctx->dst_dma_fd,
                                      (void**)(&dst_nvbuf_surf));
         if (ret_val) {
@@ -514,6 +444,42 @@ query_set_capture(context_t * ctx)
     dst_nvbuf_surf->numFilled = 1;
     ctx->dst_dma_fd = dst_nvbuf_surf->surfaceList[0].bufferDesc;
 
+    /* In checksum mode, frames are converted into a pool of buffers
+    ** with the same parameters, which the checksum thread hashes while
+    ** decoding continues.
+    */
+    if (ctx->checksum)
+    {
+        ctx->checksum->clearBuffers();
+        for (uint32_t i = 0; i < CHECKSUM_BUFFERS; i++)
+        {
+            if (ctx->checksum_dma_fd[i] != -1)
+            {
+                ret_val = NvBufSurfaceFromFd(ctx->checksum_dma_fd[i],
+                                             (void**)(&dst_nvbuf_surf));
+                if (ret_val == 0)
+                    ret_val = NvBufSurfaceDestroy(dst_nvbuf_surf);
+                if (ret_val)
+                {
+                    cerr << "Failed to destroy NvBufSurface" << endl;
+                    ctx->in_error = 1;
+                }
+                ctx->checksum_dma_fd[i] = -1;
+            }
+
+            ret_val = NvBufSurfaceAllocate(&dst_nvbuf_surf, 1, &dstParams);
+            if (ret_val)
+            {
+                cerr << "Creation of dmabuf failed" << endl;
+                ctx->in_error = 1;
+                break;
+            }
+            dst_nvbuf_surf->numFilled = 1;
+            ctx->checksum_dma_fd[i] = dst_nvbuf_surf->surfaceList[0].bufferDesc;
+            ctx->checksum->addBuffer(ctx->checksum_dma_fd[i]);
+        }
+    }
+
     // Stop streaming and unmap all buffers.
 
     pthread_mutex_lock(&ctx->queue_lock);
@@ -802,10 +768,18 @@ capture_thread(void *arg)
                 }
                 break;
             }
-            if (!ctx->out_file_path.empty())
+            if (!ctx->out_file_path.empty() || ctx->checksum)
             {
                 NvBufSurface *decoded_nvbuf_surf = 0;
                 NvBufSurface *dst_nvbuf_surf = 0;
+                int dst_fd = ctx->checksum ? ctx->checksum->getBuffer() : ctx->dst_dma_fd;
+
+                if (dst_fd < 0)
+                {
+                    ctx->in_error = 1;
+                    cerr << "No checksum buffer available" << endl;
+                    break;
+                }
 
                 /* Transformation parameters are defined
                 ** which are passed to the NvBufSurfTransform
@@ -843,14 +817,18 @@ capture_thread(void *arg)
                 ret_val = NvBufSurfaceFromFd (decoded_buffer->planes[0].fd, (void**)(&decoded_nvbuf_surf));
                 if (ret_val)
                 {
+                    if (ctx->checksum)
+                        ctx->checksum->addBuffer(dst_fd);
                     ctx->in_error = 1;
                     cerr << "NvBufSurfaceFromFd failed" << endl;
                     break;
                 }
 
-                ret_val = NvBufSurfaceFromFd (ctx->dst_dma_fd, (void**)(&dst_nvbuf_surf));
+                ret_val = NvBufSurfaceFromFd (dst_fd, (void**)(&dst_nvbuf_surf));
                 if (ret_val)
                 {
+                    if (ctx->checksum)
+                        ctx->checksum->addBuffer(dst_fd);
                     ctx->in_error = 1;
                     cerr << "NvBufSurfaceFromFd failed" << endl;
                     break;
@@ -862,15 +840,36 @@ capture_thread(void *arg)
                 ret_val = NvBufSurfTransform(decoded_nvbuf_surf, dst_nvbuf_surf, &transform_params);
                 if (ret_val)
                 {
+                    if (ctx->checksum)
+                        ctx->checksum->addBuffer(dst_fd);
                     ctx->in_error = 1;
                     cerr << "Transform failed" << endl;
                     break;
                 }
 
-                // Write raw decoded buffer data to a file.
-                for (uint32_t j = 0; j < ctx->cp_num_planes; ++j)
+                if (ctx->checksum)
+                {
+                    // Hash the frame on the checksum thread.
+                    if (ctx->checksum->queueBuffer(dst_fd, ctx->out_pixfmt == 1 ? 2 : 3) < 0)
+                    {
+                        ctx->checksum->addBuffer(dst_fd);
+                        ctx->in_error = 1;
+                        cerr << "Error queueing checksum buffer" << endl;
+                        break;
+                    }
+                }
+                else
                 {
-                    dump_raw_dmabuf(ctx->dst_dma_fd, j, ctx->out_file);
+                    /* Write raw decoded buffer data to a file. The buffer
+                    ** stays mapped in the sink, and all the rows of all
+                    ** the planes are written with a single call.
+                    */
+                    if (ctx->out_sink->writeFrame(ctx->dst_dma_fd))
+                    {
+                        ctx->in_error = 1;
+                        cerr << "Error writing decoded frame" << endl;
+                        break;
+                    }
                 }
 
                 if (ctx->cp_mem_type == V4L2_MEMORY_DMABUF)
@@ -1293,15 +1292,19 @@ main(int argc, char *argv[])
     ctx.cp_buf_type = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
     ctx.fd = -1;
     ctx.dst_dma_fd = -1;
+    for (idx = 0; idx < CHECKSUM_BUFFERS; idx++)
+        ctx.checksum_dma_fd[idx] = -1;
     ctx.num_queued_op_buffers = 0;
     ctx.op_buffers = NULL;
     ctx.cp_buffers = NULL;
     pthread_mutex_init(&ctx.queue_lock, NULL);
     pthread_cond_init(&ctx.queue_cond, NULL);
 
-    assert(argc == 3);
+    assert(argc == 3 || ((argc == 4 || argc == 5) && !strcmp(argv[2], "--frame-checksum")) ||
+           (argc == 4 && !strcmp(argv[3], "--direct-io")));
     ctx.in_file_path = argv[1];
-    ctx.out_file_path = argv[2];
+    if (strcmp(argv[2], "--frame-checksum"))
+        ctx.out_file_path = argv[2];
 
     // I/O file operations.
 
@@ -1312,12 +1315,26 @@ main(int argc, char *argv[])
         ctx.in_error = 1;
         goto cleanup;
     }
-    ctx.out_file = new ofstream (ctx.out_file_path);
-    if (!ctx.out_file->is_open())
+    if (ctx.out_file_path.empty())
     {
-        cerr << "Error opening output file" << endl;
-        ctx.in_error = 1;
-        goto cleanup;
+        // Checksum mode: hash the frames instead of writing them.
+        ctx.checksum = new NvFrameChecksum(NvFrameChecksum::getSurfaceOps());
+        if (ctx.checksum->open(argv[3], argc == 5 ? argv[4] : NULL))
+        {
+            cerr << "Error opening checksum files" << endl;
+            ctx.in_error = 1;
+            goto cleanup;
+        }
+    }
+    else
+    {
+        ctx.out_sink = new NvRawFrameSink(NvRawFrameSink::hardwareOps());
+        if (ctx.out_sink->open(ctx.out_file_path.c_str(), argc == 4))
+        {
+            cerr << "Error opening output file" << endl;
+            ctx.in_error = 1;
+            goto cleanup;
+        }
     }
 
     /* The call creates a new V4L2 Video Decoder object
@@ -1637,6 +1654,9 @@ cleanup:
         {
             NvBufSurface *nvbuf_surf = NULL;
 
+            if (ctx.out_sink)
+                ctx.out_sink->forget(ctx.dst_dma_fd);
+
             ret = NvBufSurfaceFromFd((int)ctx.dst_dma_fd,
                                      (void**)(&nvbuf_surf));
             if (ret)
@@ -1649,6 +1669,27 @@ cleanup:
             ctx.dst_dma_fd = -1;
         }
 
+        if (ctx.checksum)
+        {
+            // Wait for the pending frames and report the golden comparison.
+            if (ctx.checksum->close())
+                ctx.in_error = 1;
+            for (idx = 0; idx < CHECKSUM_BUFFERS; idx++)
+            {
+                NvBufSurface *nvbuf_surf = NULL;
+
+                if (ctx.checksum_dma_fd[idx] == -1)
+                    continue;
+                ret = NvBufSurfaceFromFd(ctx.checksum_dma_fd[idx],
+                                         (void**)(&nvbuf_surf));
+                if (ret == 0)
+                    ret = NvBufSurfaceDestroy(nvbuf_surf);
+                if (ret)
+                    cerr << "Failed to destroy NvBufSurface" << endl;
+                ctx.checksum_dma_fd[idx] = -1;
+            }
+        }
+
         // Close the opened V4L2 device.
 
         ret = v4l2_close(ctx.fd);
@@ -1660,10 +1701,19 @@ cleanup:
     }
 
     ctx.in_file->close();
-    ctx.out_file->close();
+    if (ctx.out_sink)
+    {
+        if (ctx.out_sink->close())
+        {
+            cerr << "Error writing output file" << endl;
+            ctx.in_error = 1;
+        }
+        ctx.out_sink->printStats();
+    }
 
     delete ctx.in_file;
-    delete ctx.out_file;
+    delete ctx.out_sink;
+    delete ctx.checksum;
 
     // Report application run status on exit.
     if (ctx.in_error)
@@ -31,6 +31,10 @@
  */
 #define DECODER_DEV "/dev/nvhost-nvdec"
 #define MAX_BUFFERS 32
+/**
+ * Specifies the number of buffers hashed concurrently in checksum mode.
+ */
+#define CHECKSUM_BUFFERS 4
 #define CHUNK_SIZE 4000000
 /**
  * Specifies the maximum number of planes a buffer can contain.
@@ -166,7 +170,10 @@ typedef struct
     ifstream *in_file;
 
     string out_file_path;
-    ofstream *out_file;
+    NvRawFrameSink *out_sink;
+
+    NvFrameChecksum *checksum;
+    int checksum_dma_fd[CHECKSUM_BUFFERS];
 
     pthread_mutex_t queue_lock;
     pthread_cond_t queue_cond;
@@ -192,18 +199,6 @@ typedef struct
  */
 static void read_input_chunk(ifstream * stream, Buffer * buffer);
 
-/**
- * @brief Writes a plane data of the buffer to a file.
- *
- * This function writes data into the file from a plane of the DMA buffer.
- *
- * @param[in] dmabuf_fd DMABUF FD of buffer.
- * @param[in] plane video frame plane.
- * @param[in] stream A pointer to the output file stream.
- * @return 0 for success, -1 otherwise.
- */
-static int dump_raw_dmabuf(int dmabuf_fd, unsigned int plane, ofstream * stream);
-
 /**
  * @brief Sets the format on the decoder capture plane.
  *
@@ -0,0 +1,721 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./drm_mailbox_sample [-n <frames>] [-b <buffers>] [-p <usec>] [-v <usec>]
+ * Example:
+ * ./drm_mailbox_sample
+ * ./drm_mailbox_sample -p 5000 -v 16667
+**/
+
+#include <iostream>
+#include <deque>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include <drm_fourcc.h>
+
+using namespace std;
+
+#include "drm_mailbox_unit_sample.hpp"
+
+/**
+ * Mailbox presentation for NvDrmRenderer.
+ *
+ * In FIFO mode NvDrmRenderer flips every enqueued buffer in order. When the
+ * producer is faster than the display, the queue fills up and each frame
+ * waits for the frames before it, so the latency grows to the depth of the
+ * queue. In mailbox mode a new frame supersedes the one waiting for a flip,
+ * and each vblank shows the newest frame.
+ *
+ * This sample checks NvDrmMailbox and compares both modes:
+ * ## Mailbox bookkeeping: superseded and released frames, statistics
+ * ## FIFO and mailbox presentation of a 2x faster producer, on a virtual clock
+ * ## A producer thread and a display thread sharing a mailbox
+ * ## Atomic flips of dumb buffers on a VKMS device, when one is available
+ *
+ * It reports the frames displayed and skipped and the post-to-scanout
+ * latency of each, and checks that no buffer is given back to the producer
+ * while it is displayed or waiting for a flip.
+**/
+
+#define DEFAULT_FRAMES 120
+#define DEFAULT_BUFFERS 4
+#define DEFAULT_VBLANK_USEC 16667
+#define MAX_DRM_CARDS 16
+
+enum
+{
+    BUFFER_FREE,
+    BUFFER_PRODUCER,
+    BUFFER_MAILBOX,
+};
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+sleep_until(uint64_t usec)
+{
+    uint64_t now = get_time_usec();
+
+    if (usec > now)
+        usleep(usec - now);
+}
+
+static void
+init_pool(buffer_pool &pool, int first, int count)
+{
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.cond, NULL);
+    pool.owner.assign(first + count, BUFFER_FREE);
+    pool.free_buffers.clear();
+    for (int i = first; i < first + count; i++)
+        pool.free_buffers.push_back(i);
+    pool.error = false;
+}
+
+static void
+destroy_pool(buffer_pool &pool)
+{
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.cond);
+}
+
+/* Returns a buffer to the producer; -1 is ignored. */
+static void
+release_buffer(buffer_pool &pool, int buf)
+{
+    if (buf == -1)
+        return;
+
+    pthread_mutex_lock(&pool.lock);
+    if (pool.owner[buf] != BUFFER_MAILBOX)
+    {
+        cerr << "FAIL: buffer " << buf << " released while not posted" << endl;
+        pool.error = true;
+    }
+    pool.owner[buf] = BUFFER_FREE;
+    pool.free_buffers.push_back(buf);
+    pthread_cond_signal(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+}
+
+static int
+acquire_buffer(buffer_pool &pool)
+{
+    int buf;
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.free_buffers.empty())
+        pthread_cond_wait(&pool.cond, &pool.lock);
+    buf = pool.free_buffers.front();
+    pool.free_buffers.erase(pool.free_buffers.begin());
+    if (pool.owner[buf] != BUFFER_FREE)
+    {
+        cerr << "FAIL: buffer " << buf << " handed out twice" << endl;
+        pool.error = true;
+    }
+    pool.owner[buf] = BUFFER_PRODUCER;
+    pthread_mutex_unlock(&pool.lock);
+
+    return buf;
+}
+
+static void
+post_buffer(producer_context *ctx, int buf)
+{
+    pthread_mutex_lock(&ctx->pool->lock);
+    ctx->pool->owner[buf] = BUFFER_MAILBOX;
+    pthread_mutex_unlock(&ctx->pool->lock);
+
+    release_buffer(*ctx->pool, ctx->mailbox->post(buf, get_time_usec()));
+}
+
+static void *
+producer_thread(void *arg)
+{
+    producer_context *ctx = (producer_context *) arg;
+    uint64_t next = get_time_usec();
+
+    for (uint32_t i = 0; i < ctx->params->num_frames; i++)
+    {
+        int buf = acquire_buffer(*ctx->pool);
+
+        if (ctx->maps)
+            memset((*ctx->maps)[buf], (i * 16) & 0xff, ctx->map_size);
+        next += ctx->params->produce_usec;
+        sleep_until(next);
+        post_buffer(ctx, buf);
+    }
+
+    pthread_mutex_lock(&ctx->pool->lock);
+    ctx->done = true;
+    pthread_mutex_unlock(&ctx->pool->lock);
+    ctx->mailbox->wake();
+    return NULL;
+}
+
+static bool
+producer_done(producer_context *ctx)
+{
+    bool done;
+
+    pthread_mutex_lock(&ctx->pool->lock);
+    done = ctx->done;
+    pthread_mutex_unlock(&ctx->pool->lock);
+
+    return done;
+}
+
+static bool
+check_stats(const NvDrmPresentStats &stats, uint64_t posted)
+{
+    return stats.num_posted == posted &&
+        stats.num_displayed + stats.num_skipped == posted &&
+        stats.num_failed == 0 &&
+        (stats.num_displayed == 0 ||
+         (stats.latency_min_usec <= stats.latency_max_usec &&
+          stats.latency_total_usec >= stats.latency_min_usec * stats.num_displayed &&
+          stats.latency_total_usec <= stats.latency_max_usec * stats.num_displayed));
+}
+
+static bool
+simulate_display(const display_params &params, bool use_mailbox, NvDrmPresentStats &stats)
+{
+    NvDrmMailbox mailbox;
+    deque<pair<int, uint64_t> > fifo;
+    vector<int> free_buffers;
+    uint64_t next_post = 0;
+    uint64_t vblank = params.vblank_usec;
+    uint32_t posted = 0;
+    int displayed = -1;
+    int pending, on_screen;
+    bool ok = true;
+
+    memset(&stats, 0, sizeof(stats));
+    for (uint32_t i = 0; i < params.num_buffers; i++)
+        free_buffers.push_back(i);
+
+    while (posted < params.num_frames || !fifo.empty() ||
+           mailbox.flipInFlight() || mailbox.hasPending())
+    {
+        /* Frames produced before the vblank */
+        while (posted < params.num_frames && next_post < vblank)
+        {
+            int buf;
+
+            if (free_buffers.empty())
+            {
+                /* Back-pressure: the producer resumes when the vblank frees a buffer */
+                next_post = vblank;
+                break;
+            }
+            buf = free_buffers.back();
+            free_buffers.pop_back();
+
+            if (use_mailbox)
+            {
+                int superseded = mailbox.post(buf, next_post);
+
+                if (superseded != -1)
+                    free_buffers.push_back(superseded);
+                /* The render thread commits at once when no flip is in flight */
+                mailbox.beginFlip();
+            }
+            else
+            {
+                fifo.push_back(make_pair(buf, next_post));
+            }
+            posted++;
+            next_post += params.produce_usec;
+        }
+
+        /* The committed flip scans out at the vblank */
+        if (use_mailbox)
+        {
+            int released = mailbox.endFlip(vblank);
+
+            if (released != -1)
+                free_buffers.push_back(released);
+            mailbox.beginFlip();
+        }
+        else if (!fifo.empty())
+        {
+            uint64_t latency = vblank - fifo.front().second;
+
+            if (stats.num_displayed == 0 || latency < stats.latency_min_usec)
+                stats.latency_min_usec = latency;
+            if (latency > stats.latency_max_usec)
+                stats.latency_max_usec = latency;
+            stats.latency_total_usec += latency;
+            stats.num_displayed++;
+            stats.num_posted++;
+
+            if (displayed != -1)
+                free_buffers.push_back(displayed);
+            displayed = fifo.front().first;
+            fifo.pop_front();
+        }
+        vblank += params.vblank_usec;
+    }
+
+    if (use_mailbox)
+    {
+        mailbox.getStats(&stats);
+        mailbox.drain(&pending, &on_screen);
+        ok = pending == -1;
+        displayed = on_screen;
+    }
+    if (displayed != -1)
+        free_buffers.push_back(displayed);
+
+    return ok && check_stats(stats, params.num_frames) &&
+        free_buffers.size() == params.num_buffers;
+}
+
+static bool
+run_threads(const display_params &params, NvDrmPresentStats &stats)
+{
+    NvDrmMailbox mailbox;
+    buffer_pool pool;
+    producer_context ctx;
+    pthread_t producer;
+    uint64_t start;
+    int pending, displayed;
+    bool ok;
+
+    init_pool(pool, 0, params.num_buffers);
+
+    ctx.mailbox = &mailbox;
+    ctx.pool = &pool;
+    ctx.params = &params;
+    ctx.maps = NULL;
+    ctx.map_size = 0;
+    ctx.done = false;
+
+    start = get_time_usec();
+    pthread_create(&producer, NULL, producer_thread, &ctx);
+
+    /* Display thread: a flip committed between two vblanks shows at the second */
+    while (!(producer_done(&ctx) && !mailbox.hasPending()))
+    {
+        uint64_t next_vblank;
+
+        if (!mailbox.waitForFrame(params.vblank_usec / 1000 + 1))
+            continue;
+        mailbox.beginFlip();
+        next_vblank = get_time_usec() - start;
+        next_vblank = start + (next_vblank / params.vblank_usec + 1) * params.vblank_usec;
+        sleep_until(next_vblank);
+        release_buffer(pool, mailbox.endFlip(get_time_usec()));
+    }
+    pthread_join(producer, NULL);
+
+    mailbox.getStats(&stats);
+    mailbox.drain(&pending, &displayed);
+    release_buffer(pool, pending);
+    release_buffer(pool, displayed);
+
+    ok = !pool.error && pending == -1 &&
+        pool.free_buffers.size() == params.num_buffers &&
+        check_stats(stats, params.num_frames);
+    destroy_pool(pool);
+    return ok;
+}
+
+/* Opens the first VKMS card, or returns -1 */
+static int
+open_vkms(void)
+{
+    char path[32];
+
+    for (int i = 0; i < MAX_DRM_CARDS; i++)
+    {
+        drmVersion *version;
+        bool vkms;
+        int fd;
+
+        snprintf(path, sizeof(path), "/dev/dri/card%d", i);
+        fd = open(path, O_RDWR | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        version = drmGetVersion(fd);
+        vkms = version && !strcmp(version->name, "vkms");
+        drmFreeVersion(version);
+        if (vkms)
+            return fd;
+        close(fd);
+    }
+    return -1;
+}
+
+typedef struct
+{
+    NvDrmMailbox *mailbox;
+    buffer_pool *pool;
+} vkms_flip_context;
+
+static void
+vkms_flip_handler(int fd, unsigned int frame, unsigned int sec,
+                  unsigned int usec, void *data)
+{
+    vkms_flip_context *ctx = (vkms_flip_context *) data;
+
+    release_buffer(*ctx->pool, ctx->mailbox->endFlip((uint64_t) sec * 1000000 + usec));
+}
+
+static bool
+run_vkms(const display_params &params, NvDrmPresentStats &stats, bool &skipped)
+{
+    drmModeRes *res = NULL;
+    drmModeConnector *conn = NULL;
+    NvDrmAtomicPlane *plane = NULL;
+    uint32_t num_buffers = params.num_buffers + 1;
+    vector<uint32_t> handles(num_buffers, 0);
+    vector<uint32_t> fbs(num_buffers, 0);
+    vector<uint8_t *> maps(num_buffers, (uint8_t *) MAP_FAILED);
+    size_t map_size = 0;
+    uint32_t crtc_id, width, height;
+    bool ok = false;
+    int drm_fd;
+
+    memset(&stats, 0, sizeof(stats));
+    skipped = true;
+
+    drm_fd = open_vkms();
+    if (drm_fd < 0)
+        return false;
+
+    res = drmModeGetResources(drm_fd);
+    for (int i = 0; res && i < res->count_connectors && !conn; i++)
+    {
+        conn = drmModeGetConnector(drm_fd, res->connectors[i]);
+        if (conn && (conn->connection != DRM_MODE_CONNECTED || conn->count_modes == 0))
+        {
+            drmModeFreeConnector(conn);
+            conn = NULL;
+        }
+    }
+    if (!conn || res->count_crtcs == 0)
+        goto cleanup;
+    crtc_id = res->crtcs[0];
+    width = conn->modes[0].hdisplay;
+    height = conn->modes[0].vdisplay;
+
+    /* Buffer 0 is scanned out by the mode set and not given to the producer */
+    for (uint32_t i = 0; i < num_buffers; i++)
+    {
+        struct drm_mode_create_dumb creq;
+        struct drm_mode_map_dumb mreq;
+        uint32_t bo_handles[4] = {0};
+        uint32_t pitches[4] = {0};
+        uint32_t offsets[4] = {0};
+
+        memset(&creq, 0, sizeof(creq));
+        creq.width = width;
+        creq.height = height;
+        creq.bpp = 32;
+        if (drmIoctl(drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &creq))
+            goto cleanup;
+        handles[i] = creq.handle;
+        map_size = creq.size;
+
+        bo_handles[0] = creq.handle;
+        pitches[0] = creq.pitch;
+        if (drmModeAddFB2(drm_fd, creq.width, creq.height, DRM_FORMAT_XRGB8888,
+                          bo_handles, pitches, offsets, &fbs[i], 0))
+            goto cleanup;
+
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.handle = creq.handle;
+        if (drmIoctl(drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &mreq))
+            goto cleanup;
+        maps[i] = (uint8_t *) mmap(0, map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                   drm_fd, mreq.offset);
+        if (maps[i] == MAP_FAILED)
+            goto cleanup;
+    }
+
+    /* Fails without DRM master, for example under a running compositor */
+    if (drmModeSetCrtc(drm_fd, crtc_id, fbs[0], 0, 0, &conn->connector_id, 1,
+                       &conn->modes[0]))
+        goto cleanup;
+
+    plane = NvDrmAtomicPlane::create(drm_fd, crtc_id);
+    if (!plane)
+        goto cleanup;
+    skipped = false;
+
+    {
+        NvDrmMailbox mailbox;
+        buffer_pool pool;
+        producer_context ctx;
+        vkms_flip_context flip_ctx;
+        drmEventContext evctx;
+        struct pollfd fds;
+        pthread_t producer;
+        int pending, displayed;
+
+        ok = true;
+        init_pool(pool, 1, params.num_buffers);
+        ctx.mailbox = &mailbox;
+        ctx.pool = &pool;
+        ctx.params = &params;
+        ctx.maps = &maps;
+        ctx.map_size = map_size;
+        ctx.done = false;
+        flip_ctx.mailbox = &mailbox;
+        flip_ctx.pool = &pool;
+
+        memset(&evctx, 0, sizeof(evctx));
+        evctx.version = DRM_EVENT_CONTEXT_VERSION;
+        evctx.page_flip_handler = vkms_flip_handler;
+        memset(&fds, 0, sizeof(fds));
+        fds.fd = drm_fd;
+        fds.events = POLLIN;
+
+        pthread_create(&producer, NULL, producer_thread, &ctx);
+        while (ok)
+        {
+            if (mailbox.flipInFlight())
+            {
+                int ret = poll(&fds, 1, 500);
+
+                if (ret > 0 && (fds.revents & POLLIN))
+                    drmHandleEvent(drm_fd, &evctx);
+                else if (ret == 0)
+                {
+                    cerr << "FAIL: no flip-done event" << endl;
+                    ok = false;
+                }
+            }
+            else if (producer_done(&ctx) && !mailbox.hasPending())
+            {
+                break;
+            }
+            else if (mailbox.waitForFrame(50))
+            {
+                int buf = mailbox.beginFlip();
+                int ret = plane->flip(fbs[buf], width, height, width, height, &flip_ctx);
+
+                if (ret < 0)
+                {
+                    cerr << "FAIL: atomic commit: " << strerror(-ret) << endl;
+                    release_buffer(pool, mailbox.abortFlip());
+                    ok = false;
+                }
+            }
+        }
+        pthread_join(producer, NULL);
+
+        mailbox.getStats(&stats);
+        mailbox.drain(&pending, &displayed);
+        release_buffer(pool, pending);
+        release_buffer(pool, displayed);
+        ok = ok && !pool.error && check_stats(stats, params.num_frames);
+        destroy_pool(pool);
+    }
+
+cleanup:
+    delete plane;
+    for (uint32_t i = 0; i < num_buffers; i++)
+    {
+        struct drm_mode_destroy_dumb dreq;
+
+        if (maps[i] != MAP_FAILED)
+            munmap(maps[i], map_size);
+        if (fbs[i])
+            drmModeRmFB(drm_fd, fbs[i]);
+        if (handles[i])
+        {
+            memset(&dreq, 0, sizeof(dreq));
+            dreq.handle = handles[i];
+            drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &dreq);
+        }
+    }
+    drmModeFreeConnector(conn);
+    drmModeFreeResources(res);
+    close(drm_fd);
+    return ok;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const NvDrmPresentStats &stats, bool ok)
+{
+    table.row(name, ok) << stats.num_posted << stats.num_displayed << stats.num_skipped <<
+        (stats.num_displayed ? stats.latency_total_usec / stats.num_displayed : 0) <<
+        stats.latency_max_usec;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table;
+    UnitSampleArgs args("./drm_mailbox_sample");
+    display_params params;
+    int opt;
+
+    params.num_frames = DEFAULT_FRAMES;
+    params.num_buffers = DEFAULT_BUFFERS;
+    params.vblank_usec = DEFAULT_VBLANK_USEC;
+    params.produce_usec = 0;
+
+    args.option('n', "<frames>", "Frames to produce", DEFAULT_FRAMES)
+        .option('b', "<buffers>", "Buffers of the producer, at least 3", DEFAULT_BUFFERS)
+        .option('p', "<usec>", "Time between two frames", "half the vblank")
+        .option('v', "<usec>", "Simulated vblank period", DEFAULT_VBLANK_USEC);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                params.num_frames = atoi(optarg);
+                break;
+            case 'b':
+                params.num_buffers = atoi(optarg);
+                break;
+            case 'p':
+                params.produce_usec = atoi(optarg);
+                break;
+            case 'v':
+                params.vblank_usec = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (params.produce_usec == 0)
+        params.produce_usec = params.vblank_usec / 2;
+    if (params.num_frames == 0 || params.num_buffers < 3 ||
+        params.produce_usec == 0 || params.vblank_usec == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("posted", 10).column("shown", 10).column("skipped", 10).column("avg us", 12)
+        .column("max us", 12);
+
+    /* Mailbox bookkeeping */
+    {
+        NvDrmMailbox mailbox;
+        NvDrmPresentStats stats;
+        int pending, displayed;
+        bool ok = true;
+
+        ok = mailbox.beginFlip() == -1 && mailbox.endFlip(0) == -1 && ok;
+        ok = mailbox.post(1, 1000) == -1 && mailbox.hasPending() && ok;
+        /* A newer frame supersedes the one waiting */
+        ok = mailbox.post(2, 2000) == 1 && ok;
+        ok = mailbox.waitForFrame(0) && mailbox.beginFlip() == 2 && ok;
+        /* One flip at a time; frames posted meanwhile wait for it */
+        ok = mailbox.post(3, 3000) == -1 && !mailbox.waitForFrame(0) && ok;
+        ok = mailbox.beginFlip() == -1 && mailbox.flipInFlight() && ok;
+        ok = mailbox.endFlip(6000) == -1 && ok;
+        ok = mailbox.beginFlip() == 3 && ok;
+        /* A failed flip gives its frame back and leaves the screen as is */
+        ok = mailbox.abortFlip() == 3 && !mailbox.flipInFlight() && ok;
+        ok = mailbox.post(4, 7000) == -1 && mailbox.beginFlip() == 4 && ok;
+        /* The frame leaving the screen is released */
+        ok = mailbox.endFlip(8000) == 2 && ok;
+        ok = mailbox.post(5, 9000) == -1 && ok;
+        mailbox.getStats(&stats);
+        mailbox.drain(&pending, &displayed);
+        ok = pending == 5 && displayed == 4 && ok;
+
+        ok = stats.num_posted == 5 && stats.num_displayed == 2 &&
+            stats.num_skipped == 1 && stats.num_failed == 1 &&
+            stats.latency_min_usec == 1000 && stats.latency_max_usec == 4000 &&
+            stats.latency_total_usec == 5000 && ok;
+
+        /* wake() ends a wait without a frame */
+        mailbox.wake();
+        ok = !mailbox.waitForFrame(1000) && ok;
+
+        add_result(table, "mailbox", stats, ok);
+    }
+
+    /* FIFO and mailbox with a faster producer, on a virtual clock */
+    {
+        NvDrmPresentStats fifo, mailbox;
+        bool fifo_ok = simulate_display(params, false, fifo);
+        bool mailbox_ok = simulate_display(params, true, mailbox);
+
+        /* A frame posted right after a vblank scans out at most two vblanks later */
+        mailbox_ok = mailbox_ok && mailbox.num_displayed &&
+            mailbox.latency_max_usec <= 2 * params.vblank_usec;
+        if (params.produce_usec < params.vblank_usec)
+            mailbox_ok = mailbox_ok && mailbox.num_skipped > 0 &&
+                mailbox.latency_total_usec / mailbox.num_displayed <
+                fifo.latency_total_usec / fifo.num_displayed;
+        fifo_ok = fifo_ok && fifo.num_skipped == 0;
+        add_result(table, "fifo-sim", fifo, fifo_ok);
+        add_result(table, "mailbox-sim", mailbox, mailbox_ok);
+    }
+
+    {
+        NvDrmPresentStats stats;
+        bool ok = run_threads(params, stats);
+
+        add_result(table, "threads", stats, ok);
+    }
+
+    {
+        NvDrmPresentStats stats;
+        bool skipped;
+        bool ok = run_vkms(params, stats, skipped);
+
+        if (skipped)
+            table.skip("vkms");
+        else
+            add_result(table, "vkms", stats, ok);
+    }
+
+    cout << "Producer every " << params.produce_usec << " us, vblank every " <<
+        params.vblank_usec << " us, " << params.num_buffers << " buffers" << endl;
+    return table.print() ? 0 : -1;
+}
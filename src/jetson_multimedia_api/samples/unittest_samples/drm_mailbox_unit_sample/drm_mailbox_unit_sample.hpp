@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvDrmMailbox.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the timing of a simulated or real display.
+ */
+typedef struct
+{
+    /** Frames produced. */
+    uint32_t num_frames;
+    /** Buffers the producer renders into. */
+    uint32_t num_buffers;
+    /** Time between two frames of the producer, in microseconds. */
+    uint32_t produce_usec;
+    /** Time between two vblanks, in microseconds. */
+    uint32_t vblank_usec;
+} display_params;
+
+/**
+ * Holds the buffers shared by a producer thread and the display.
+ */
+typedef struct
+{
+    /** Protects the fields below. */
+    pthread_mutex_t lock;
+    /** Signalled when a buffer is released. */
+    pthread_cond_t cond;
+    /** Buffers the producer can render into. */
+    std::vector<int> free_buffers;
+    /** Owner of each buffer, one of the BUFFER_* values. */
+    std::vector<int> owner;
+    /** Set when a buffer is released twice or reused while displayed. */
+    bool error;
+} buffer_pool;
+
+/**
+ * Holds the state of a producer thread posting to a mailbox.
+ */
+typedef struct
+{
+    /** Mailbox the frames are posted to. */
+    NvDrmMailbox *mailbox;
+    /** Buffers of the frames. */
+    buffer_pool *pool;
+    /** Timing of the producer. */
+    const display_params *params;
+    /** Mapped buffers filled on each frame, or NULL. */
+    std::vector<uint8_t *> *maps;
+    /** Size of each mapped buffer. */
+    size_t map_size;
+    /** Set when all the frames are posted, under the lock of the pool. */
+    bool done;
+} producer_context;
+
+/**
+ * @brief Simulates a display on a virtual clock.
+ *
+ * Frames are produced every @a produce_usec and a flip committed before
+ * a vblank scans out at that vblank. In FIFO mode every frame is queued
+ * and the producer waits for a free buffer; in mailbox mode only the
+ * newest frame is flipped.
+ *
+ * @param[in] params Timing of the simulation
+ * @param[in] use_mailbox Simulate the mailbox mode rather than FIFO
+ * @param[out] stats Presentation statistics
+ * @return true if the checks of the simulation passed
+ */
+static bool
+simulate_display(const display_params &params, bool use_mailbox, NvDrmPresentStats &stats);
+
+/**
+ * @brief Drives a mailbox with a producer thread and a display thread
+ *        sleeping until each vblank.
+ *
+ * @param[in] params Timing of the threads
+ * @param[out] stats Presentation statistics
+ * @return true if the checks of the test passed
+ */
+static bool
+run_threads(const display_params &params, NvDrmPresentStats &stats);
+
+/**
+ * @brief Drives a mailbox on a VKMS device with atomic flips of dumb
+ *        buffers, if the system has one.
+ *
+ * @param[in] params Timing of the producer; the vblank rate is the
+ *                   mode refresh of the device.
+ * @param[out] stats Presentation statistics
+ * @param[out] skipped Set without VKMS or DRM master access
+ * @return true if the checks of the test passed
+ */
+static bool
+run_vkms(const display_params &params, NvDrmPresentStats &stats, bool &skipped);
@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./egl_cache_sample [-b <buffers>] [-n <frames>] [-r <usec>] [-t <threads>]
+ * Example:
+ * ./egl_cache_sample
+ * ./egl_cache_sample -b 10 -r 1000
+**/
+
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "egl_cache_unit_sample.hpp"
+
+/**
+ * CUDA registration cache for EGLImages.
+ *
+ * NvCudaProc registers the EGLImage of a buffer with CUDA to run a kernel
+ * on it. Decoders and cameras recycle a fixed set of buffers, so
+ * NvEglRegistrationCache keeps the registration of each buffer, keyed by
+ * its dmabuf fd, until the buffer owner invalidates it.
+ *
+ * This sample drives the cache with a mocked CUDA driver whose
+ * registrations take a configurable time, and checks:
+ * ## Registering on every frame, as before, against the cache
+ * ## A buffer mapped to a new EGLImage is registered again
+ * ## Invalidating a registration in use defers the unregistration
+ * ## Idle registrations over the limit are evicted
+ * ## Threads using and invalidating registrations concurrently
+ *
+ * The mocked driver fails a test if a registration is unregistered while
+ * a frame uses it, or if registrations are left at exit.
+**/
+
+#define DEFAULT_BUFFERS 6
+#define DEFAULT_FRAMES 300
+#define DEFAULT_REGISTER_USEC 300
+#define DEFAULT_WORK_USEC 50
+#define DEFAULT_THREADS 4
+#define MAX_ENTRIES 16
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Fake EGLImage of a buffer; a new mapping of the buffer gets a new one. */
+static void *
+egl_image(int fd, uint32_t generation)
+{
+    return (void *) (uintptr_t) (0x10000 + fd * 0x100 + generation * 8);
+}
+
+static void *
+mock_register(void *image, void *arg)
+{
+    mock_driver *driver = (mock_driver *) arg;
+    mock_registration *reg = new mock_registration;
+
+    usleep(driver->register_usec);
+    reg->image = image;
+    reg->users = 0;
+
+    pthread_mutex_lock(&driver->lock);
+    driver->live++;
+    driver->registrations++;
+    pthread_mutex_unlock(&driver->lock);
+    return reg;
+}
+
+static void
+mock_unregister(void *handle, void *arg)
+{
+    mock_driver *driver = (mock_driver *) arg;
+    mock_registration *reg = (mock_registration *) handle;
+
+    usleep(driver->unregister_usec);
+
+    pthread_mutex_lock(&driver->lock);
+    if (reg->users)
+    {
+        cerr << "FAIL: registration unregistered while in use" << endl;
+        driver->error = true;
+    }
+    driver->live--;
+    pthread_mutex_unlock(&driver->lock);
+    delete reg;
+}
+
+static void
+init_driver(mock_driver &driver, uint32_t register_usec)
+{
+    pthread_mutex_init(&driver.lock, NULL);
+    driver.register_usec = register_usec;
+    driver.unregister_usec = register_usec / 3;
+    driver.live = 0;
+    driver.registrations = 0;
+    driver.error = false;
+}
+
+static NvEglRegistrationOps
+mock_ops(mock_driver &driver)
+{
+    NvEglRegistrationOps ops;
+
+    ops.registerImage = mock_register;
+    ops.unregisterImage = mock_unregister;
+    ops.arg = &driver;
+    return ops;
+}
+
+/* Runs a frame on a registration: marks it in use for work_usec. */
+static bool
+run_frame(mock_driver &driver, mock_registration *reg, void *image, uint32_t work_usec)
+{
+    bool ok;
+
+    pthread_mutex_lock(&driver.lock);
+    reg->users++;
+    ok = reg->image == image;
+    pthread_mutex_unlock(&driver.lock);
+
+    usleep(work_usec);
+
+    pthread_mutex_lock(&driver.lock);
+    reg->users--;
+    pthread_mutex_unlock(&driver.lock);
+
+    if (!ok)
+        cerr << "FAIL: registration of another EGLImage returned" << endl;
+    return ok;
+}
+
+static bool
+process_frames(mock_driver &driver, NvEglRegistrationCache *cache,
+               uint32_t num_buffers, int first_fd, uint32_t num_frames,
+               uint32_t work_usec)
+{
+    NvEglRegistrationOps ops = mock_ops(driver);
+    bool ok = true;
+
+    for (uint32_t i = 0; i < num_frames; i++)
+    {
+        int fd = first_fd + i % num_buffers;
+        void *image = egl_image(fd, 0);
+        mock_registration *reg;
+
+        if (cache)
+            reg = (mock_registration *) cache->acquire(fd, image);
+        else
+            reg = (mock_registration *) ops.registerImage(image, ops.arg);
+        if (!reg)
+            return false;
+
+        ok = run_frame(driver, reg, image, work_usec) && ok;
+
+        if (cache)
+            cache->release(fd, reg);
+        else
+            ops.unregisterImage(reg, ops.arg);
+    }
+    return ok;
+}
+
+typedef struct
+{
+    mock_driver *driver;
+    NvEglRegistrationCache *cache;
+    uint32_t thread_id;
+    uint32_t num_buffers;
+    uint32_t num_frames;
+    bool ok;
+} thread_context;
+
+/* Worker using its own buffers; every 16 frames it remaps one buffer. */
+static void *
+worker_thread(void *arg)
+{
+    thread_context *tctx = (thread_context *) arg;
+    int first_fd = 100 + tctx->thread_id * tctx->num_buffers;
+    vector<uint32_t> generation(tctx->num_buffers, 0);
+
+    tctx->ok = true;
+    for (uint32_t i = 0; i < tctx->num_frames; i++)
+    {
+        uint32_t index = i % tctx->num_buffers;
+        int fd = first_fd + index;
+        mock_registration *reg;
+        void *image;
+
+        if (i % 16 == 15)
+        {
+            /* The owner invalidates before unmapping the EGLImage */
+            tctx->cache->invalidate(fd);
+            generation[index]++;
+        }
+        image = egl_image(fd, generation[index]);
+
+        reg = (mock_registration *) tctx->cache->acquire(fd, image);
+        if (!reg)
+        {
+            tctx->ok = false;
+            break;
+        }
+        tctx->ok = run_frame(*tctx->driver, reg, image, 20) && tctx->ok;
+        tctx->cache->release(fd, reg);
+    }
+    return NULL;
+}
+
+/* Invalidates random fds of the workers, like buffers being destroyed. */
+static void *
+invalidate_thread(void *arg)
+{
+    thread_context *tctx = (thread_context *) arg;
+    uint32_t num_fds = tctx->thread_id * tctx->num_buffers;
+    unsigned int seed = 1;
+
+    for (uint32_t i = 0; i < tctx->num_frames; i++)
+    {
+        tctx->cache->invalidate(100 + rand_r(&seed) % num_fds);
+        usleep(100);
+    }
+    tctx->ok = true;
+    return NULL;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, uint64_t frames,
+           const mock_driver &driver, uint64_t usec, bool ok)
+{
+    table.row(name, ok && !driver.error && driver.live == 0) << frames <<
+        driver.registrations << (frames ? (double) usec / frames : 0);
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(12);
+    UnitSampleArgs args("./egl_cache_sample");
+    uint32_t num_buffers = DEFAULT_BUFFERS;
+    uint32_t num_frames = DEFAULT_FRAMES;
+    uint32_t register_usec = DEFAULT_REGISTER_USEC;
+    uint32_t num_threads = DEFAULT_THREADS;
+    int opt;
+
+    args.option('b', "<buffers>", "Buffers recycled by the pipeline", DEFAULT_BUFFERS)
+        .option('n', "<frames>", "Frames to process", DEFAULT_FRAMES)
+        .option('r', "<usec>", "Time of one registration", DEFAULT_REGISTER_USEC)
+        .option('t', "<threads>", "Threads in the concurrent test", DEFAULT_THREADS);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'b':
+                num_buffers = atoi(optarg);
+                break;
+            case 'n':
+                num_frames = atoi(optarg);
+                break;
+            case 'r':
+                register_usec = atoi(optarg);
+                break;
+            case 't':
+                num_threads = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (num_buffers == 0 || num_buffers > MAX_ENTRIES || num_frames == 0 ||
+        num_threads == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("frames", 10).column("register", 10).column("us/frame", 14, 1);
+
+    /* Register on every frame, as without the cache */
+    {
+        mock_driver driver;
+        uint64_t start;
+        bool ok;
+
+        init_driver(driver, register_usec);
+        start = get_time_usec();
+        ok = process_frames(driver, NULL, num_buffers, 3, num_frames, DEFAULT_WORK_USEC);
+        add_result(table, "uncached", num_frames, driver, get_time_usec() - start,
+                   ok && driver.registrations == num_frames);
+    }
+
+    /* Register once per buffer */
+    {
+        mock_driver driver;
+        NvEglRegistrationStats stats;
+        uint64_t start;
+        bool ok;
+
+        init_driver(driver, register_usec);
+        {
+            NvEglRegistrationCache cache(mock_ops(driver), MAX_ENTRIES);
+
+            start = get_time_usec();
+            ok = process_frames(driver, &cache, num_buffers, 3, num_frames, DEFAULT_WORK_USEC);
+            start = get_time_usec() - start;
+            stats = cache.getStats();
+            ok = ok && stats.hits == num_frames - min(num_buffers, num_frames) &&
+                cache.getNumEntries() == min(num_buffers, num_frames);
+        }
+        add_result(table, "cached", num_frames, driver, start,
+                   ok && driver.registrations == min(num_buffers, num_frames));
+    }
+
+    /* A remapped buffer is registered again */
+    {
+        mock_driver driver;
+        bool ok = true;
+
+        init_driver(driver, 0);
+        {
+            NvEglRegistrationCache cache(mock_ops(driver), MAX_ENTRIES);
+            void *reg;
+
+            reg = cache.acquire(7, egl_image(7, 0));
+            ok = reg && run_frame(driver, (mock_registration *) reg, egl_image(7, 0), 0) && ok;
+            cache.release(7, reg);
+
+            reg = cache.acquire(7, egl_image(7, 1));
+            ok = reg && run_frame(driver, (mock_registration *) reg, egl_image(7, 1), 0) && ok;
+            cache.release(7, reg);
+
+            ok = ok && cache.getStats().stale == 1 && cache.getNumEntries() == 1 &&
+                driver.live == 1;
+        }
+        add_result(table, "remap", 2, driver, 0, ok && driver.registrations == 2);
+    }
+
+    /* Invalidation of a registration in use is deferred to its release */
+    {
+        mock_driver driver;
+        bool ok = true;
+
+        init_driver(driver, 0);
+        {
+            NvEglRegistrationCache cache(mock_ops(driver), MAX_ENTRIES);
+            mock_registration *reg;
+            void *next;
+
+            reg = (mock_registration *) cache.acquire(9, egl_image(9, 0));
+            ok = reg != NULL;
+            if (reg)
+            {
+                reg->users++;
+                cache.invalidate(9);
+                /* Still registered, and not returned anymore */
+                ok = driver.live == 1 && ok;
+                next = cache.acquire(9, egl_image(9, 0));
+                ok = next != NULL && next != reg && driver.live == 2 && ok;
+                cache.release(9, next);
+                reg->users--;
+                cache.release(9, reg);
+                ok = driver.live == 1 && ok;
+            }
+            cache.invalidate(9);
+            ok = driver.live == 0 && cache.getNumEntries() == 0 && ok;
+        }
+        add_result(table, "invalidate", 2, driver, 0, ok);
+    }
+
+    /* Idle registrations over the limit are evicted */
+    {
+        mock_driver driver;
+        bool ok;
+
+        init_driver(driver, 0);
+        {
+            NvEglRegistrationCache cache(mock_ops(driver), MAX_ENTRIES);
+
+            ok = process_frames(driver, &cache, MAX_ENTRIES * 2, 200, MAX_ENTRIES * 4, 0);
+            ok = ok && cache.getNumEntries() == MAX_ENTRIES &&
+                cache.getStats().evictions == MAX_ENTRIES * 3;
+        }
+        add_result(table, "eviction", MAX_ENTRIES * 4, driver, 0, ok);
+    }
+
+    /* Concurrent use, remapping and invalidation */
+    {
+        mock_driver driver;
+        vector<thread_context> tctx(num_threads + 1);
+        vector<pthread_t> threads(num_threads + 1);
+        uint32_t per_thread = max(1u, MAX_ENTRIES / num_threads);
+        uint64_t start;
+        bool ok = true;
+
+        init_driver(driver, register_usec / 10);
+        {
+            NvEglRegistrationCache cache(mock_ops(driver), MAX_ENTRIES);
+
+            start = get_time_usec();
+            for (uint32_t i = 0; i <= num_threads; i++)
+            {
+                tctx[i].driver = &driver;
+                tctx[i].cache = &cache;
+                tctx[i].thread_id = i;
+                tctx[i].num_buffers = per_thread;
+                tctx[i].num_frames = num_frames;
+                tctx[i].ok = false;
+                pthread_create(&threads[i], NULL,
+                               i < num_threads ? worker_thread : invalidate_thread, &tctx[i]);
+            }
+            for (uint32_t i = 0; i <= num_threads; i++)
+            {
+                pthread_join(threads[i], NULL);
+                ok = tctx[i].ok && ok;
+            }
+            start = get_time_usec() - start;
+        }
+        add_result(table, "threads", (uint64_t) num_frames * num_threads, driver, start, ok);
+    }
+
+    cout << "Buffers " << num_buffers << ", registration " << register_usec << " us" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvEglRegistrationCache.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds one registration of the mocked CUDA driver.
+ */
+typedef struct
+{
+    /** EGLImage the registration is for. */
+    void *image;
+    /** Number of frames using the registration. */
+    uint32_t users;
+} mock_registration;
+
+/**
+ * Holds the state of the mocked CUDA driver.
+ */
+typedef struct
+{
+    /** Protects the fields below. */
+    pthread_mutex_t lock;
+    /** Time taken by a registration, in microseconds. */
+    uint32_t register_usec;
+    /** Time taken by an unregistration, in microseconds. */
+    uint32_t unregister_usec;
+    /** Registrations not unregistered yet. */
+    uint64_t live;
+    /** Registrations made. */
+    uint64_t registrations;
+    /** Set when a registration in use is unregistered. */
+    bool error;
+} mock_driver;
+
+/**
+ * @brief Processes frames from a recycled set of buffers.
+ *
+ * Each frame acquires the registration of its buffer, marks it in use for
+ * @a work_usec and releases it. Without a cache, each frame registers and
+ * unregisters its EGLImage, like NvCudaProc did before.
+ *
+ * @param[in] driver Mocked driver
+ * @param[in] cache Registration cache, or NULL for no cache
+ * @param[in] num_buffers Number of buffers, with fds from @a first_fd
+ * @param[in] first_fd fd of the first buffer
+ * @param[in] num_frames Number of frames
+ * @param[in] work_usec Time a frame uses its registration
+ * @return true if every registration succeeded
+ */
+static bool
+process_frames(mock_driver &driver, NvEglRegistrationCache *cache,
+               uint32_t num_buffers, int first_fd, uint32_t num_frames,
+               uint32_t work_usec);
@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./engine_cache_sample [-d <dir>] [-s <bytes>] [-b <msec>] [-p <procs>]
+ * Example:
+ * ./engine_cache_sample
+ * ./engine_cache_sample -d /tmp/cache -p 8
+**/
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+#include "engine_cache_unit_sample.hpp"
+
+/**
+ * Serialized TensorRT engine cache.
+ *
+ * Building a TensorRT engine takes from seconds to minutes, so the TRT
+ * samples cache the serialized engine with TRT_EngineCache. The cache is
+ * independent of TensorRT; this sample drives it with a fake builder that
+ * sleeps for the build time and returns an engine derived from its key:
+ * ## Cold start builds the engine, warm start loads it
+ * ## Changing any key field (model, batch, mode, target, TensorRT
+ *    version, options) builds a new engine
+ * ## A corrupted, truncated or foreign cache file is rejected and rebuilt
+ * ## The least recently used engines are evicted over the size limit
+ * ## Old locks of removed engines are removed only when nobody holds them
+ * ## Processes starting at once with the same key build it only once
+**/
+
+#define DEFAULT_ENGINE_SIZE (256 * 1024)
+#define DEFAULT_BUILD_MSEC 200
+#define DEFAULT_PROCS 4
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void
+fill_engine(vector<char> &blob, const fake_builder &builder)
+{
+    uint32_t seed = 2166136261u;
+
+    for (size_t i = 0; i < builder.key.size(); i++)
+        seed = (seed ^ (uint8_t) builder.key[i]) * 16777619u;
+
+    blob.resize(builder.engine_size);
+    for (size_t i = 0; i < blob.size(); i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        blob[i] = (char) (seed >> 16);
+    }
+}
+
+static bool
+check_engine(const vector<char> &blob, const fake_builder &builder)
+{
+    vector<char> expected;
+
+    fill_engine(expected, builder);
+    return blob == expected;
+}
+
+static bool
+fake_build(vector<char> &blob, void *arg)
+{
+    fake_builder *builder = (fake_builder *) arg;
+    int fd;
+
+    usleep(builder->build_msec * 1000);
+    fill_engine(blob, *builder);
+
+    fd = open(builder->build_log.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd >= 0)
+    {
+        if (write(fd, "b", 1) != 1)
+            cerr << "Could not write the build log" << endl;
+        close(fd);
+    }
+    return true;
+}
+
+static uint64_t
+count_builds(const string &build_log)
+{
+    struct stat st;
+
+    if (stat(build_log.c_str(), &st) < 0)
+        return 0;
+    return st.st_size;
+}
+
+static bool
+write_file(const string &path, const char *data)
+{
+    FILE *file = fopen(path.c_str(), "w");
+
+    if (!file)
+        return false;
+    fputs(data, file);
+    fclose(file);
+    return true;
+}
+
+static void
+remove_dir(const string &dir)
+{
+    struct dirent *ent;
+    DIR *d = opendir(dir.c_str());
+
+    if (!d)
+        return;
+    while ((ent = readdir(d)) != NULL)
+    {
+        if (strcmp(ent->d_name, ".") && strcmp(ent->d_name, ".."))
+            unlink((dir + "/" + ent->d_name).c_str());
+    }
+    closedir(d);
+    rmdir(dir.c_str());
+}
+
+/* Gets the engine of key and checks it; sets *from_cache. */
+static bool
+get_engine(TRT_EngineCache &cache, const TRT_EngineCacheKey &key,
+           fake_builder &builder, bool *from_cache)
+{
+    vector<char> blob;
+
+    builder.key = key.toString();
+    if (!cache.getOrBuild(key, blob, fake_build, &builder, from_cache))
+        return false;
+    return check_engine(blob, builder);
+}
+
+static bool
+run_concurrent(const string &dir, const TRT_EngineCacheKey &key,
+               fake_builder &builder, uint32_t num_procs, uint64_t &builds)
+{
+    uint64_t builds_before = count_builds(builder.build_log);
+    vector<pid_t> pids;
+    bool ok = true;
+
+    for (uint32_t i = 0; i < num_procs; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            TRT_EngineCache cache(dir, 0);
+            bool from_cache;
+
+            _exit(get_engine(cache, key, builder, &from_cache) ? 0 : 1);
+        }
+        if (pid < 0)
+        {
+            cerr << "fork failed" << endl;
+            ok = false;
+            break;
+        }
+        pids.push_back(pid);
+    }
+
+    for (size_t i = 0; i < pids.size(); i++)
+    {
+        int status;
+
+        if (waitpid(pids[i], &status, 0) < 0 ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            ok = false;
+    }
+
+    builds = count_builds(builder.build_log) - builds_before;
+    return ok;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const TRT_EngineCache &cache, bool ok)
+{
+    TRT_EngineCacheStats stats = cache.getStats();
+
+    table.row(name, ok) << stats.builds << stats.hits << stats.invalid;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    fake_builder builder;
+    TRT_EngineCacheKey base;
+    UnitSampleTable table;
+    UnitSampleArgs args("./engine_cache_sample");
+    string dir;
+    string model_file;
+    uint32_t num_procs = DEFAULT_PROCS;
+    uint64_t cold_usec = 0;
+    uint64_t warm_usec = 0;
+    int opt;
+
+    builder.engine_size = DEFAULT_ENGINE_SIZE;
+    builder.build_msec = DEFAULT_BUILD_MSEC;
+
+    args.option('d', "<dir>", "Cache directory, removed at exit",
+                "/tmp/engine_cache_sample.<pid>")
+        .option('s', "<bytes>", "Size of the fake engine", DEFAULT_ENGINE_SIZE)
+        .option('b', "<msec>", "Build time of the fake engine", DEFAULT_BUILD_MSEC)
+        .option('p', "<procs>", "Processes in the concurrent test", DEFAULT_PROCS);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'd':
+                dir = optarg;
+                break;
+            case 's':
+                builder.engine_size = atoi(optarg);
+                break;
+            case 'b':
+                builder.build_msec = atoi(optarg);
+                break;
+            case 'p':
+                num_procs = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (dir.empty())
+        dir = "/tmp/engine_cache_sample." + to_string(getpid());
+    if (builder.engine_size == 0 || num_procs == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    model_file = dir + ".model";
+    builder.build_log = dir + ".builds";
+    unlink(builder.build_log.c_str());
+    if (!write_file(model_file, "fake model, version 1"))
+    {
+        cerr << "Could not write " << model_file << endl;
+        return -1;
+    }
+
+    base.model_hash = TRT_EngineCache::hashFiles(vector<string>(1, model_file));
+    base.batch_size = 1;
+    base.mode = 0;
+    base.target = "GPU:fake:sm_87";
+    base.trt_version = "8.6.2";
+    base.options = "onnx,workspace=115343360";
+
+    table.column("builds", 10).column("hits", 10).column("invalid", 10);
+
+    /* Cold start builds, warm start loads. */
+    {
+        bool from_cache[2] = { true, false };
+        bool ok;
+        uint64_t start;
+
+        TRT_EngineCache cold(dir, 0);
+        start = get_time_usec();
+        ok = get_engine(cold, base, builder, &from_cache[0]);
+        cold_usec = get_time_usec() - start;
+
+        TRT_EngineCache warm(dir, 0);
+        start = get_time_usec();
+        ok = get_engine(warm, base, builder, &from_cache[1]) && ok;
+        warm_usec = get_time_usec() - start;
+
+        ok = ok && !from_cache[0] && from_cache[1] &&
+            cold.getStats().builds == 1 && warm.getStats().builds == 0;
+        add_result(table, "cold start", cold, ok);
+        add_result(table, "warm start", warm, ok);
+    }
+
+    /* Every key field is part of the key. */
+    {
+        TRT_EngineCache cache(dir, 0);
+        TRT_EngineCacheKey keys[6];
+        bool from_cache;
+        bool ok = true;
+
+        for (int i = 0; i < 6; i++)
+            keys[i] = base;
+        write_file(model_file, "fake model, version 2");
+        keys[0].model_hash = TRT_EngineCache::hashFiles(vector<string>(1, model_file));
+        keys[1].batch_size = 4;
+        keys[2].mode = 2;
+        keys[3].target = "GPU:fake:sm_72";
+        keys[4].trt_version = "10.3.0";
+        keys[5].options = "caffe,workspace=115343360";
+
+        for (int i = 0; i < 6; i++)
+        {
+            ok = get_engine(cache, keys[i], builder, &from_cache) && !from_cache && ok;
+            ok = keys[i].fileName() != base.fileName() && ok;
+        }
+        /* The base engine is still cached */
+        ok = get_engine(cache, base, builder, &from_cache) && from_cache && ok;
+        ok = ok && cache.getStats().builds == 6;
+        add_result(table, "key fields", cache, ok);
+    }
+
+    /* Damaged and foreign cache files are rejected. */
+    {
+        TRT_EngineCache cache(dir, 0);
+        TRT_EngineCacheKey other = base;
+        string file = dir + "/" + base.fileName();
+        string other_file;
+        vector<char> blob;
+        struct stat st;
+        bool from_cache;
+        bool ok = true;
+        int fd;
+
+        /* Flip one byte of the payload */
+        fd = open(file.c_str(), O_RDWR);
+        ok = fd >= 0 && fstat(fd, &st) == 0 && ok;
+        if (fd >= 0)
+        {
+            char c = 0;
+            ok = pread(fd, &c, 1, st.st_size / 2) == 1 && ok;
+            c ^= 0x5a;
+            ok = pwrite(fd, &c, 1, st.st_size / 2) == 1 && ok;
+            close(fd);
+        }
+        ok = !cache.load(base, blob) && ok;
+        ok = get_engine(cache, base, builder, &from_cache) && !from_cache && ok;
+
+        /* Truncate the engine */
+        ok = truncate(file.c_str(), st.st_size - 100) == 0 && ok;
+        ok = get_engine(cache, base, builder, &from_cache) && !from_cache && ok;
+
+        /* Replace the file with the engine of another key */
+        other.batch_size = 8;
+        other_file = dir + "/" + other.fileName();
+        ok = get_engine(cache, other, builder, &from_cache) && ok;
+        ok = rename(other_file.c_str(), file.c_str()) == 0 && ok;
+        ok = get_engine(cache, base, builder, &from_cache) && !from_cache && ok;
+
+        /* The rebuilt engine is valid */
+        ok = get_engine(cache, base, builder, &from_cache) && from_cache && ok;
+        ok = ok && cache.getStats().invalid == 3;
+        add_result(table, "corruption", cache, ok);
+    }
+
+    /* Least recently used engines are evicted. */
+    {
+        TRT_EngineCacheKey keys[3];
+        vector<char> blob;
+        bool from_cache;
+        bool ok = true;
+
+        TRT_EngineCache cleaner(dir, 0);
+        cleaner.evict(0);
+
+        /* Room for two engines */
+        TRT_EngineCache cache(dir, builder.engine_size * 5 / 2);
+        for (int i = 0; i < 3; i++)
+        {
+            keys[i] = base;
+            keys[i].batch_size = 16 + i;
+        }
+        ok = get_engine(cache, keys[0], builder, &from_cache) && ok;
+        ok = get_engine(cache, keys[1], builder, &from_cache) && ok;
+        /* Use keys[0] so that keys[1] is the least recently used */
+        ok = cache.load(keys[0], blob) && ok;
+        ok = get_engine(cache, keys[2], builder, &from_cache) && ok;
+
+        ok = cache.getSize() <= builder.engine_size * 5 / 2 && ok;
+        ok = cache.load(keys[0], blob) && ok;
+        ok = !cache.load(keys[1], blob) && ok;
+        ok = cache.load(keys[2], blob) && ok;
+        ok = ok && cache.getStats().evictions == 1;
+        /* A builder of the evicted engine may still hold its lock */
+        ok = access((dir + "/" + keys[1].fileName() + ".lock").c_str(), F_OK) == 0 && ok;
+        add_result(table, "eviction", cache, ok);
+    }
+
+    /* Old locks of removed engines go, unless a builder holds them. */
+    {
+        string held = dir + "/held.engine.lock";
+        string unheld = dir + "/unheld.engine.lock";
+        struct timespec times[2];
+        int held_fd;
+        bool ok;
+
+        ok = write_file(held, "") && write_file(unheld, "");
+        clock_gettime(CLOCK_REALTIME, &times[0]);
+        times[0].tv_sec -= 3600;
+        times[1] = times[0];
+        utimensat(AT_FDCWD, held.c_str(), times, 0);
+        utimensat(AT_FDCWD, unheld.c_str(), times, 0);
+
+        held_fd = open(held.c_str(), O_RDWR);
+        ok = held_fd >= 0 && flock(held_fd, LOCK_EX) == 0 && ok;
+
+        TRT_EngineCache cache(dir, 0);
+        cache.evict(UINT64_MAX);
+        ok = access(held.c_str(), F_OK) == 0 && ok;
+        ok = access(unheld.c_str(), F_OK) < 0 && ok;
+
+        if (held_fd >= 0)
+            close(held_fd);
+        cache.evict(UINT64_MAX);
+        ok = access(held.c_str(), F_OK) < 0 && ok;
+        add_result(table, "locks", cache, ok);
+    }
+
+    /* Concurrent processes build once. */
+    {
+        TRT_EngineCacheKey key = base;
+        uint64_t builds = 0;
+        bool ok;
+
+        key.batch_size = 32;
+        ok = run_concurrent(dir, key, builder, num_procs, builds);
+        table.row("concurrent", ok && builds == 1) << builds << num_procs - builds << 0;
+    }
+
+    remove_dir(dir);
+    unlink(model_file.c_str());
+    unlink(builder.build_log.c_str());
+
+    cout << "Engine size " << builder.engine_size << " bytes, build time " <<
+        builder.build_msec << " ms" << endl;
+    cout << "Cold start " << cold_usec / 1000.0 << " ms, warm start " <<
+        warm_usec / 1000.0 << " ms" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "trt_engine_cache.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the parameters of the fake engine builder.
+ */
+typedef struct
+{
+    /** Key the engine is built for, written into the engine. */
+    std::string key;
+    /** Size of the engine in bytes. */
+    uint32_t engine_size;
+    /** Build time in milliseconds. */
+    uint32_t build_msec;
+    /** File to which each build appends one byte, shared by processes. */
+    std::string build_log;
+} fake_builder;
+
+/**
+ * @brief Builds a fake serialized engine.
+ *
+ * The engine content is derived from the key, so that an engine returned
+ * for the wrong key is detected. Sleeps for the build time and appends a
+ * byte to the build log.
+ *
+ * @param[out] blob Serialized engine
+ * @param[in] arg Pointer to a fake_builder
+ * @return true for success
+ */
+static bool fake_build(std::vector<char> &blob, void *arg);
+
+/**
+ * @brief Runs getOrBuild in several processes at once.
+ *
+ * Each child process opens its own TRT_EngineCache on @a dir and gets the
+ * engine of @a key. The builds of all the processes are counted through
+ * the build log.
+ *
+ * @param[in] dir Cache directory
+ * @param[in] key Key of the engine
+ * @param[in] builder Fake builder
+ * @param[in] num_procs Number of processes
+ * @param[out] builds Number of builds over all the processes
+ * @return true if every process got the right engine
+ */
+static bool
+run_concurrent(const std::string &dir, const TRT_EngineCacheKey &key,
+               fake_builder &builder, uint32_t num_procs, uint64_t &builds);
@@ -0,0 +1,716 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./exposure_fusion_sample [-s <width>x<height>] [-n <exposures>] [-t <threads>] [-r <runs>]
+ *                          [-f <fps>] [-i <file>] [-o <file>]
+ * Example:
+ * ./exposure_fusion_sample
+ * ./exposure_fusion_sample -s 1280x720 -n 3 -i bracket_1280x720.nv12 -o fused_1280x720.nv12
+**/
+
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#include "exposure_fusion_unit_sample.hpp"
+
+/**
+ * Exposure fusion.
+ *
+ * ExposureFusion merges a burst of differently exposed NV12 images into one
+ * image, weighting the pixels by contrast, saturation and well-exposedness
+ * and blending Laplacian pyramids. This sample checks:
+ * ## A burst of identical images fuses to the same image
+ * ## The result matches a straightforward reference implementation, with
+ *    and without SIMD, at sizes which give odd sized pyramid levels
+ * ## The SIMD code paths give the same result as the scalar ones
+ * ## The result does not depend on the number of threads
+ * ## A fused synthetic bracket has less clipped pixels than its middle
+ *    exposure
+ *
+ * It then benchmarks the fusion of a synthetic bracket, or of the bursts of
+ * a recorded headerless NV12 file holding the exposures of each burst one
+ * after the other, single threaded without and with SIMD and on all threads.
+ * It prints the time spent in each stage, the PSNR against the reference
+ * implementation and whether the fusion fits into the time a burst takes.
+**/
+
+using namespace ArgusSamples;
+
+#define DEFAULT_WIDTH 1920
+#define DEFAULT_HEIGHT 1080
+#define DEFAULT_EXPOSURES 3
+#define DEFAULT_RUNS 10
+#define DEFAULT_FPS 30
+#define MIN_PSNR 45.0
+#define MSEC 1000000.0
+
+static nv12_image
+new_image(uint32_t width, uint32_t height)
+{
+    nv12_image image;
+
+    image.width = width;
+    image.height = height;
+    image.data.resize(width * height * 3 / 2);
+    return image;
+}
+
+static uint8_t
+to_u8(float value)
+{
+    return (uint8_t) (min(max(value, 0.0f), 255.0f) + 0.5f);
+}
+
+static vector<nv12_image>
+make_bracket(uint32_t width, uint32_t height, uint32_t count)
+{
+    vector<nv12_image> images;
+
+    for (uint32_t k = 0; k < count; k++)
+    {
+        const float gain = powf(2.0f, -2.0f + 4.0f * k / (count - 1));
+        nv12_image image = new_image(width, height);
+        uint8_t *chroma = &image.data[width * height];
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                const float fx = (float) x / (width - 1);
+                const float fy = (float) y / (height - 1);
+                /* radiance from 0.02 to 8 from left to right, with some texture */
+                float texture = 1.0f + 0.3f * sinf(x * 0.35f) * sinf(y * 0.27f);
+                if (fy > 0.5f)
+                    texture += (((x / 16) + (y / 16)) & 1) ? 0.2f : -0.2f;
+                const float linear = min(0.02f * powf(400.0f, fx) * texture * gain, 1.0f);
+
+                image.data[y * width + x] = to_u8(16.0f + 219.0f * powf(linear, 1.0f / 2.2f));
+                if (((x | y) & 1) == 0)
+                {
+                    /* colors fade out in the shadows and highlights */
+                    const float saturation = 4.0f * linear * (1.0f - linear);
+                    uint8_t *cbcr = chroma + (y / 2) * width + x;
+
+                    cbcr[0] = to_u8(128.0f + 112.0f * 0.35f * sinf(fx * 12.6f) * saturation);
+                    cbcr[1] = to_u8(128.0f + 112.0f * 0.35f * cosf(fy * 9.4f) * saturation);
+                }
+            }
+        }
+        images.push_back(image);
+    }
+    return images;
+}
+
+static bool
+read_frames(const char *file_name, uint32_t width, uint32_t height, vector<nv12_image> &frames)
+{
+    FILE *file = fopen(file_name, "rb");
+    if (!file)
+    {
+        cerr << "Could not open " << file_name << endl;
+        return false;
+    }
+
+    nv12_image frame = new_image(width, height);
+    while (fread(frame.data.data(), frame.data.size(), 1, file) == 1)
+        frames.push_back(frame);
+    fclose(file);
+
+    return !frames.empty();
+}
+
+static bool
+write_frame(const char *file_name, const nv12_image &frame)
+{
+    FILE *file = fopen(file_name, "wb");
+    if (!file)
+        return false;
+
+    bool ok = fwrite(frame.data.data(), frame.data.size(), 1, file) == 1;
+    fclose(file);
+    return ok;
+}
+
+static bool
+fuse(ExposureFusion &fusion, const nv12_image *images, uint32_t count, nv12_image &output,
+     ExposureFusion::Timings &timings)
+{
+    vector<ExposureFusion::Image> inputs;
+    ExposureFusion::Image out;
+    ExposureFusion::Timings run;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        ExposureFusion::Image image;
+        uint8_t *data = (uint8_t *) images[i].data.data();
+
+        image.luma.data = data;
+        image.luma.pitch = images[i].width;
+        image.chroma.data = data + images[i].width * images[i].height;
+        image.chroma.pitch = images[i].width;
+        inputs.push_back(image);
+    }
+    out.luma.data = output.data.data();
+    out.luma.pitch = output.width;
+    out.chroma.data = output.data.data() + output.width * output.height;
+    out.chroma.pitch = output.width;
+
+    if (!fusion.fuse(inputs.data(), out, &run))
+        return false;
+
+    timings.weights += run.weights;
+    timings.pyramid += run.pyramid;
+    timings.collapse += run.collapse;
+    timings.total += run.total;
+    return true;
+}
+
+static int32_t
+ref_mirror(int32_t i, int32_t n)
+{
+    if (i < 0)
+        i = -i;
+    if (i >= n)
+        i = 2 * n - 2 - i;
+    return min(max(i, 0), n - 1);
+}
+
+static ref_plane
+ref_new(int32_t width, int32_t height)
+{
+    ref_plane plane;
+
+    plane.width = width;
+    plane.height = height;
+    plane.data.assign(width * height, 0.0f);
+    return plane;
+}
+
+static float
+ref_get(const ref_plane &plane, int32_t x, int32_t y)
+{
+    return plane.data[ref_mirror(y, plane.height) * plane.width + ref_mirror(x, plane.width)];
+}
+
+/* 5x5 binomial blur, keeping every other sample */
+static ref_plane
+ref_reduce(const ref_plane &in)
+{
+    static const float k[5] = { 1.0f, 4.0f, 6.0f, 4.0f, 1.0f };
+    ref_plane out = ref_new((in.width + 1) / 2, (in.height + 1) / 2);
+
+    for (int32_t y = 0; y < out.height; y++)
+    {
+        for (int32_t x = 0; x < out.width; x++)
+        {
+            float sum = 0.0f;
+            for (int32_t j = 0; j < 5; j++)
+                for (int32_t i = 0; i < 5; i++)
+                    sum += k[j] * k[i] * ref_get(in, 2 * x + i - 2, 2 * y + j - 2);
+            out.data[y * out.width + x] = sum / 256.0f;
+        }
+    }
+    return out;
+}
+
+/* the coarse samples contributing to a fine sample and their weights */
+static int32_t
+ref_taps(int32_t fine, int32_t *index, float *weight)
+{
+    if ((fine & 1) == 0)
+    {
+        index[0] = fine / 2 - 1;
+        index[1] = fine / 2;
+        index[2] = fine / 2 + 1;
+        weight[0] = 1.0f / 8.0f;
+        weight[1] = 6.0f / 8.0f;
+        weight[2] = 1.0f / 8.0f;
+        return 3;
+    }
+    index[0] = fine / 2;
+    index[1] = fine / 2 + 1;
+    weight[0] = weight[1] = 0.5f;
+    return 2;
+}
+
+static ref_plane
+ref_expand(const ref_plane &in, int32_t width, int32_t height)
+{
+    ref_plane out = ref_new(width, height);
+
+    for (int32_t y = 0; y < height; y++)
+    {
+        for (int32_t x = 0; x < width; x++)
+        {
+            int32_t ix[3], iy[3];
+            float wx[3], wy[3];
+            const int32_t nx = ref_taps(x, ix, wx);
+            const int32_t ny = ref_taps(y, iy, wy);
+            float sum = 0.0f;
+
+            for (int32_t j = 0; j < ny; j++)
+                for (int32_t i = 0; i < nx; i++)
+                    sum += wy[j] * wx[i] * ref_get(in, ix[i], iy[j]);
+            out.data[y * width + x] = sum;
+        }
+    }
+    return out;
+}
+
+/* blend the Laplacian pyramid of 'in' with the Gaussian pyramid of 'weight' into 'blend' */
+static void
+ref_blend(const ref_plane &in, const vector<ref_plane> &weight, uint32_t first,
+          vector<ref_plane> &blend)
+{
+    ref_plane current = in;
+
+    for (uint32_t level = 0; level < blend.size(); level++)
+    {
+        const ref_plane &w = weight[first + level];
+        ref_plane laplacian = current;
+        ref_plane next = ref_new(0, 0);
+
+        if (level + 1 < blend.size())
+        {
+            next = ref_reduce(current);
+            const ref_plane up = ref_expand(next, current.width, current.height);
+            for (size_t i = 0; i < laplacian.data.size(); i++)
+                laplacian.data[i] -= up.data[i];
+        }
+        for (size_t i = 0; i < laplacian.data.size(); i++)
+            blend[level].data[i] += w.data[i] * laplacian.data[i];
+        current = next;
+    }
+}
+
+static ref_plane
+ref_collapse(const vector<ref_plane> &blend)
+{
+    ref_plane current = blend.back();
+
+    for (size_t level = blend.size() - 1; level-- > 0;)
+    {
+        ref_plane up = ref_expand(current, blend[level].width, blend[level].height);
+        for (size_t i = 0; i < up.data.size(); i++)
+            up.data[i] += blend[level].data[i];
+        current = up;
+    }
+    return current;
+}
+
+static nv12_image
+reference_fuse(const nv12_image *images, uint32_t count, uint32_t levels, float sigma)
+{
+    const int32_t width = images[0].width;
+    const int32_t height = images[0].height;
+    vector<ref_plane> weights;
+    ref_plane sum = ref_new(width, height);
+
+    /* contrast, saturation and well-exposedness, the first two floored at one code value */
+    for (uint32_t k = 0; k < count; k++)
+    {
+        const uint8_t *luma = images[k].data.data();
+        const uint8_t *chroma = luma + width * height;
+        ref_plane w = ref_new(width, height);
+
+        for (int32_t y = 0; y < height; y++)
+        {
+            for (int32_t x = 0; x < width; x++)
+            {
+                const int32_t c = luma[y * width + x];
+                const int32_t laplacian = 4 * c -
+                    luma[ref_mirror(y - 1, height) * width + x] -
+                    luma[ref_mirror(y + 1, height) * width + x] -
+                    luma[y * width + ref_mirror(x - 1, width)] -
+                    luma[y * width + ref_mirror(x + 1, width)];
+                const uint8_t *cbcr = chroma + (y / 2) * width + (x / 2) * 2;
+                const float contrast = (abs(laplacian) + 1) / 255.0f;
+                const float saturation = (abs(cbcr[0] - 128) + abs(cbcr[1] - 128) + 1) / 255.0f;
+                const float offset = c / 255.0f - 0.5f;
+                const float exposedness = expf(-(offset * offset) / (2.0f * sigma * sigma));
+
+                w.data[y * width + x] = contrast * saturation * exposedness;
+                sum.data[y * width + x] += w.data[y * width + x];
+            }
+        }
+        weights.push_back(w);
+    }
+
+    vector<ref_plane> luma_blend, cb_blend, cr_blend;
+    int32_t level_width = width;
+    int32_t level_height = height;
+    for (uint32_t level = 0; level < levels; level++)
+    {
+        luma_blend.push_back(ref_new(level_width, level_height));
+        if (level > 0)
+        {
+            cb_blend.push_back(ref_new(level_width, level_height));
+            cr_blend.push_back(ref_new(level_width, level_height));
+        }
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+
+    for (uint32_t k = 0; k < count; k++)
+    {
+        const uint8_t *luma = images[k].data.data();
+        const uint8_t *chroma = luma + width * height;
+        vector<ref_plane> weight(1, weights[k]);
+        ref_plane y = ref_new(width, height);
+        ref_plane cb = ref_new(width / 2, height / 2);
+        ref_plane cr = ref_new(width / 2, height / 2);
+
+        for (size_t i = 0; i < weight[0].data.size(); i++)
+            weight[0].data[i] /= sum.data[i];
+        for (uint32_t level = 1; level < levels; level++)
+            weight.push_back(ref_reduce(weight.back()));
+
+        for (int32_t i = 0; i < width * height; i++)
+            y.data[i] = luma[i];
+        for (int32_t i = 0; i < width * height / 4; i++)
+        {
+            cb.data[i] = chroma[2 * i];
+            cr.data[i] = chroma[2 * i + 1];
+        }
+
+        /* chroma is blended with the weights of the luma level of the same size */
+        ref_blend(y, weight, 0, luma_blend);
+        ref_blend(cb, weight, 1, cb_blend);
+        ref_blend(cr, weight, 1, cr_blend);
+    }
+
+    const ref_plane y = ref_collapse(luma_blend);
+    const ref_plane cb = ref_collapse(cb_blend);
+    const ref_plane cr = ref_collapse(cr_blend);
+    nv12_image output = new_image(width, height);
+
+    for (int32_t i = 0; i < width * height; i++)
+        output.data[i] = to_u8(y.data[i]);
+    for (int32_t i = 0; i < width * height / 4; i++)
+    {
+        output.data[width * height + 2 * i] = to_u8(cb.data[i]);
+        output.data[width * height + 2 * i + 1] = to_u8(cr.data[i]);
+    }
+    return output;
+}
+
+static double
+psnr(const nv12_image &a, const nv12_image &b)
+{
+    double error = 0.0;
+
+    for (size_t i = 0; i < a.data.size(); i++)
+    {
+        const double diff = (double) a.data[i] - b.data[i];
+        error += diff * diff;
+    }
+    if (error == 0.0)
+        return 99.0;
+    return 10.0 * log10(255.0 * 255.0 * a.data.size() / error);
+}
+
+static uint32_t
+max_difference(const nv12_image &a, const nv12_image &b)
+{
+    uint32_t diff = 0;
+
+    for (size_t i = 0; i < a.data.size(); i++)
+        diff = max(diff, (uint32_t) abs(a.data[i] - b.data[i]));
+    return diff;
+}
+
+/* fraction of the luma samples within two code values of black or white */
+static double
+clipped(const nv12_image &image)
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < image.width * image.height; i++)
+        count += (image.data[i] <= 18 || image.data[i] >= 233) ? 1 : 0;
+    return (double) count / (image.width * image.height);
+}
+
+static fusion_run
+new_run(uint32_t width, uint32_t height, uint32_t threads, bool simd)
+{
+    fusion_run run = { width, height, threads, simd, ExposureFusion::Timings(), -1.0 };
+    return run;
+}
+
+/* 'budget' is the time budget of a fusion in milliseconds, or negative if not checked */
+static void
+add_result(UnitSampleTable &table, const char *name, const fusion_run &run, double budget, bool ok)
+{
+    ostringstream size;
+
+    size << run.width << "x" << run.height;
+    UnitSampleTable::Row &row = table.row(name, ok) << size.str() << run.threads <<
+        (run.simd ? "yes" : "no") <<
+        run.timings.weights / MSEC << run.timings.pyramid / MSEC <<
+        run.timings.collapse / MSEC << run.timings.total / MSEC <<
+        ((budget < 0) ? "-" : (run.timings.total / MSEC <= budget ? "yes" : "no"));
+    if (run.psnr >= 0)
+        row << run.psnr;
+}
+
+/* fuses 'count' images with the given configuration */
+static bool
+run_fusion(const vector<nv12_image> &images, uint32_t threads, bool simd, nv12_image &output,
+           ExposureFusion::Timings &timings)
+{
+    ExposureFusion fusion;
+
+    fusion.setSimd(simd);
+    output = new_image(images[0].width, images[0].height);
+    return fusion.initialize(images[0].width, images[0].height, images.size(),
+                             ExposureFusion::Params(), threads) &&
+        fuse(fusion, images.data(), images.size(), output, timings) &&
+        fusion.shutdown();
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t width = DEFAULT_WIDTH;
+    uint32_t height = DEFAULT_HEIGHT;
+    uint32_t exposures = DEFAULT_EXPOSURES;
+    uint32_t threads = 0;
+    uint32_t runs = DEFAULT_RUNS;
+    uint32_t fps = DEFAULT_FPS;
+    const char *input_file = NULL;
+    const char *output_file = NULL;
+    const float sigma = ExposureFusion::Params().sigma;
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./exposure_fusion_sample");
+    ostringstream default_size;
+    int opt;
+
+    default_size << DEFAULT_WIDTH << "x" << DEFAULT_HEIGHT;
+    args.option('s', "<w>x<h>", "Benchmark image size", default_size.str())
+        .option('n', "<exposures>", "Exposures per burst", DEFAULT_EXPOSURES)
+        .option('t', "<threads>", "Threads of the benchmark, 0 for one per CPU", 0)
+        .option('r', "<runs>", "Fusions per benchmark", DEFAULT_RUNS)
+        .option('f', "<fps>", "Sensor frame rate, for the time budget", DEFAULT_FPS)
+        .option('i', "<file>", "Recorded NV12 bursts to benchmark instead of a synthetic one")
+        .option('o', "<file>", "Write the fused first burst of the benchmark as NV12");
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                if (!UnitSampleArgs::parseSize(optarg, &width, &height))
+                    width = 0;
+                break;
+            case 'n':
+                exposures = atoi(optarg);
+                break;
+            case 't':
+                threads = atoi(optarg);
+                break;
+            case 'r':
+                runs = atoi(optarg);
+                break;
+            case 'f':
+                fps = atoi(optarg);
+                break;
+            case 'i':
+                input_file = optarg;
+                break;
+            case 'o':
+                output_file = optarg;
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (width < 8 || height < 8 || (width & 1) || (height & 1) || exposures < 2 ||
+        exposures > 8 || runs == 0 || fps == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    /* a burst of 'exposures' frames has to be fused while the next one is captured */
+    const double budget = exposures * 1000.0 / fps;
+
+    table.column("size", 11).column("threads", 8).column("simd", 6)
+        .column("weights", 10, 2).column("pyramid", 10, 2).column("collapse", 10, 2)
+        .column("total ms", 10, 2).column("budget", 8).column("PSNR", 8, 1);
+
+    /* Identical images */
+    {
+        fusion_run run = new_run(130, 98, 2, true);
+        vector<nv12_image> images(3, make_bracket(130, 98, 3)[1]);
+        nv12_image output;
+        bool ok;
+
+        ok = run_fusion(images, run.threads, run.simd, output, run.timings);
+        run.psnr = psnr(output, images[0]);
+        ok = ok && max_difference(output, images[0]) <= 1;
+        add_result(table, "identity", run, -1, ok);
+    }
+
+    /* Reference implementation, odd sized levels */
+    for (uint32_t simd = 0; simd < 2; simd++)
+    {
+        fusion_run run = new_run(322, 186, 2, simd);
+        const vector<nv12_image> images = make_bracket(322, 186, exposures);
+        ExposureFusion fusion;
+        nv12_image output = new_image(322, 186);
+        bool ok;
+
+        fusion.setSimd(simd);
+        ok = fusion.initialize(322, 186, exposures, ExposureFusion::Params(), 2) &&
+            fuse(fusion, images.data(), exposures, output, run.timings);
+        run.psnr = psnr(output,
+            reference_fuse(images.data(), exposures, fusion.getLevels(), sigma));
+        ok = ok && run.psnr >= MIN_PSNR;
+        fusion.shutdown();
+        add_result(table, "reference", run, -1, ok);
+    }
+
+    /* SIMD against scalar */
+    {
+        fusion_run run = new_run(322, 186, 1, true);
+        const vector<nv12_image> images = make_bracket(322, 186, exposures);
+        nv12_image scalar, vector;
+        bool ok;
+
+        ok = run_fusion(images, 1, false, scalar, run.timings) &&
+            run_fusion(images, 1, true, vector, run.timings);
+        run.psnr = psnr(scalar, vector);
+        ok = ok && max_difference(scalar, vector) <= 1;
+        add_result(table, "simd", run, -1, ok);
+    }
+
+    /* Thread count */
+    {
+        fusion_run run = new_run(640, 480, 4, true);
+        const vector<nv12_image> images = make_bracket(640, 480, exposures);
+        nv12_image single, multi;
+        bool ok;
+
+        ok = run_fusion(images, 1, true, single, run.timings) &&
+            run_fusion(images, 4, true, multi, run.timings);
+        run.psnr = psnr(single, multi);
+        ok = ok && single.data == multi.data;
+        add_result(table, "threads", run, -1, ok);
+    }
+
+    /* Less clipping than the middle exposure */
+    {
+        fusion_run run = new_run(640, 480, 0, true);
+        const vector<nv12_image> images = make_bracket(640, 480, exposures);
+        nv12_image output;
+        bool ok;
+
+        ok = run_fusion(images, 0, true, output, run.timings);
+        cout << "Clipped luma: middle exposure " << fixed << setprecision(1) <<
+            clipped(images[exposures / 2]) * 100.0 << "%, fused " <<
+            clipped(output) * 100.0 << "%" << endl;
+        ok = ok && clipped(output) < clipped(images[exposures / 2]);
+        add_result(table, "exposure", run, -1, ok);
+    }
+
+    /* Benchmark */
+    vector<nv12_image> frames;
+    if (input_file)
+    {
+        if (!read_frames(input_file, width, height, frames) || frames.size() < exposures)
+        {
+            cerr << "Need at least " << exposures << " " << width << "x" << height <<
+                " frames in " << input_file << endl;
+            return -1;
+        }
+    }
+    else
+    {
+        frames = make_bracket(width, height, exposures);
+    }
+
+    const uint32_t bursts = frames.size() / exposures;
+    vector<nv12_image> references;
+    ExposureFusion::Params params;
+
+    for (uint32_t config = 0; config < 3; config++)
+    {
+        const uint32_t config_threads = (config < 2) ? 1 : threads;
+        fusion_run run = new_run(width, height, config_threads, config > 0);
+        ExposureFusion fusion;
+        nv12_image output = new_image(width, height);
+        bool ok;
+
+        fusion.setSimd(run.simd);
+        ok = fusion.initialize(width, height, exposures, params, config_threads);
+        run.threads = fusion.getNumThreads();
+        if (references.empty())
+        {
+            for (uint32_t burst = 0; burst < bursts; burst++)
+            {
+                references.push_back(reference_fuse(&frames[burst * exposures], exposures,
+                                                    fusion.getLevels(), sigma));
+            }
+        }
+
+        /* the first fusion of each burst is checked, the others are timed */
+        for (uint32_t burst = 0; burst < bursts && ok; burst++)
+        {
+            ExposureFusion::Timings ignored;
+            ok = fuse(fusion, &frames[burst * exposures], exposures, output, ignored);
+            const double burst_psnr = psnr(output, references[burst]);
+            run.psnr = (burst == 0) ? burst_psnr : min(run.psnr, burst_psnr);
+            if (burst == 0 && output_file && config == 2)
+                ok = ok && write_frame(output_file, output);
+        }
+        for (uint32_t i = 0; i < runs && ok; i++)
+            ok = fuse(fusion, &frames[(i % bursts) * exposures], exposures, output, run.timings);
+        run.timings.weights /= runs;
+        run.timings.pyramid /= runs;
+        run.timings.collapse /= runs;
+        run.timings.total /= runs;
+        ok = ok && run.psnr >= MIN_PSNR;
+        fusion.shutdown();
+        add_result(table, "bench", run, budget, ok);
+    }
+
+    cout << "Bursts of " << exposures << " exposures, " << bursts << " benchmarked, " <<
+        runs << " runs, budget " << fixed << setprecision(1) << budget << " ms at " <<
+        fps << " fps" << endl;
+    return table.print() ? 0 : -1;
+}
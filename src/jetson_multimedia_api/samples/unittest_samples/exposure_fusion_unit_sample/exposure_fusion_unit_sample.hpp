@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ExposureFusion.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds an NV12 image, the chroma plane follows the luma plane.
+ */
+typedef struct
+{
+    /** Width, in pixels. */
+    uint32_t width;
+    /** Height, in pixels. */
+    uint32_t height;
+    /** Luma and interleaved chroma samples, without padding. */
+    std::vector<uint8_t> data;
+} nv12_image;
+
+/**
+ * Holds a plane of the reference implementation.
+ */
+typedef struct
+{
+    /** Width, in samples. */
+    int32_t width;
+    /** Height, in samples. */
+    int32_t height;
+    /** Samples. */
+    std::vector<float> data;
+} ref_plane;
+
+/**
+ * Holds the configuration and the measurements of the fusions of one test.
+ */
+typedef struct
+{
+    /** Image width. */
+    uint32_t width;
+    /** Image height. */
+    uint32_t height;
+    /** Threads working on a fusion. */
+    uint32_t threads;
+    /** True if the SIMD code paths were used. */
+    bool simd;
+    /** Average time spent in the fusion stages. */
+    ArgusSamples::ExposureFusion::Timings timings;
+    /** PSNR against the reference implementation in dB, or negative if not measured. */
+    double psnr;
+} fusion_run;
+
+/**
+ * @brief Renders a synthetic high dynamic range scene at several exposures.
+ *
+ * @param[in] width Image width
+ * @param[in] height Image height
+ * @param[in] count Number of exposures, spread evenly from -2 to +2 EV
+ * @return The bracketed images, darkest first
+ */
+static std::vector<nv12_image> make_bracket(uint32_t width, uint32_t height, uint32_t count);
+
+/**
+ * @brief Reads bracketed NV12 frames from a headerless file.
+ *
+ * @param[in] file_name File name
+ * @param[in] width Image width
+ * @param[in] height Image height
+ * @param[out] frames All frames of the file
+ * @return true if at least one frame was read
+ */
+static bool read_frames(const char *file_name, uint32_t width, uint32_t height,
+                        std::vector<nv12_image> &frames);
+
+/**
+ * @brief Fuses images with ExposureFusion.
+ *
+ * @param[in] fusion Initialized fusion
+ * @param[in] images Input images
+ * @param[in] count Number of images
+ * @param[out] output Output image
+ * @param[inout] timings Time spent in the stages, added
+ * @return true on success
+ */
+static bool fuse(ArgusSamples::ExposureFusion &fusion, const nv12_image *images, uint32_t count,
+                 nv12_image &output, ArgusSamples::ExposureFusion::Timings &timings);
+
+/**
+ * @brief Fuses images with the straightforward reference implementation.
+ *
+ * @param[in] images Input images
+ * @param[in] count Number of images
+ * @param[in] levels Luma pyramid levels
+ * @param[in] sigma Width of the well-exposedness curve
+ * @return The fused image
+ */
+static nv12_image reference_fuse(const nv12_image *images, uint32_t count, uint32_t levels,
+                                 float sigma);
+
+/**
+ * @brief Computes the peak signal to noise ratio of two images.
+ *
+ * @param[in] a First image
+ * @param[in] b Second image
+ * @return PSNR over luma and chroma in dB, 99 for identical images
+ */
+static double psnr(const nv12_image &a, const nv12_image &b);
@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./fanout_sample [-n <frames>] [-r <renditions>] [-s <usec>]
+ * Example:
+ * ./fanout_sample
+ * ./fanout_sample -r 2 -e 8000
+**/
+
+#include <iostream>
+#include <iomanip>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "fanout_unit_sample.hpp"
+
+/**
+ * Decode-once, encode-many with NvBufferFanout.
+ *
+ * An ABR ladder transcode decodes the input once and shares each decoded
+ * buffer between one scaler and encoder per rendition. The decoder buffer
+ * holds one reference per rendition and is queued back to the decoder only
+ * when the last scaler has read it.
+ *
+ * This sample drives NvBufferFanout with mocked decoder capture planes and
+ * mocked decoder, scaler and encoder engines, and compares:
+ * ## N independent transcodes of the same input
+ * ## One ladder transcode with N renditions
+ * ## The ladder with a slow last rendition, block policy (back-pressure)
+ * ## The ladder with a slow last rendition, drop policy on that rendition
+ *
+ * For each run it reports the decoded and encoded frame rates and the
+ * dropped frames, and checks that no buffer is recycled while a rendition
+ * still reads it, that every buffer is recycled exactly once and that each
+ * rendition sees the frames in order.
+**/
+
+#define DEFAULT_FRAMES 120
+#define DEFAULT_BUFFERS 8
+#define DEFAULT_DEPTH 2
+#define DEFAULT_DECODE_USEC 4000
+#define DEFAULT_SCALE_USEC 600
+#define DEFAULT_ENCODE_USEC 5000
+#define DEFAULT_SLOW_SINK_USEC 20000
+#define MAX_RENDITIONS 3
+
+enum
+{
+    ENGINE_DECODER,
+    ENGINE_SCALER,
+    ENGINE_ENCODER,
+    NUM_ENGINES
+};
+
+static const rendition_desc ladder_renditions[MAX_RENDITIONS] =
+{
+    { 1920, 1080 },
+    { 1280, 720 },
+    { 854, 480 },
+};
+
+static pthread_mutex_t engine_lock[NUM_ENGINES] =
+{
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+};
+
+typedef struct pipeline_context pipeline_context;
+
+typedef struct
+{
+    pipeline_context *pipe;
+    const rendition_desc *desc;
+    uint32_t branch_id;
+    NvFanoutPolicy policy;
+    bool slow;
+    uint32_t next_frame;    /* Lowest frame number expected next */
+    uint64_t encoded_frames;
+    pthread_t thread;
+} branch_context;
+
+struct pipeline_context
+{
+    NvBufferFanout *fanout;
+    const mock_costs *costs;
+    uint32_t num_frames;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    vector<uint32_t> free_buffers;  /* Buffers queued to the mocked decoder */
+    vector<uint32_t> buffer_frame;  /* Frame decoded into each buffer */
+    vector<uint32_t> holders;       /* Branches reading each buffer, as a bitmask */
+    vector<bool> in_flight;         /* Buffers published and not yet recycled */
+    uint64_t decoded_frames;
+    bool ok;
+
+    vector<branch_context> branches;
+    pthread_t decoder_thread;
+};
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Simulates a job on a hardware engine shared by all the pipelines. */
+static void
+run_on_engine(int engine, uint32_t usec)
+{
+    pthread_mutex_lock(&engine_lock[engine]);
+    usleep(usec);
+    pthread_mutex_unlock(&engine_lock[engine]);
+}
+
+static uint32_t
+scale_cost(uint32_t usec_1080p, const rendition_desc *desc)
+{
+    return (uint64_t) usec_1080p * desc->width * desc->height / (1920 * 1080);
+}
+
+static void
+fail(pipeline_context *pipe, const char *msg, uint32_t index)
+{
+    cerr << "FAIL: " << msg << " (buffer " << index << ")" << endl;
+    pipe->ok = false;
+}
+
+/* Plays the decoder capture plane qBuffer done by the transcoder. */
+static void
+recycle_buffer(uint32_t index, void *arg)
+{
+    pipeline_context *pipe = (pipeline_context *) arg;
+
+    pthread_mutex_lock(&pipe->lock);
+    if (pipe->holders[index])
+        fail(pipe, "buffer recycled while a rendition reads it", index);
+    if (!pipe->in_flight[index])
+        fail(pipe, "buffer recycled twice", index);
+    pipe->in_flight[index] = false;
+    pipe->free_buffers.push_back(index);
+    pthread_cond_broadcast(&pipe->cond);
+    pthread_mutex_unlock(&pipe->lock);
+}
+
+static void *
+decoder_thread(void *arg)
+{
+    pipeline_context *pipe = (pipeline_context *) arg;
+
+    for (uint32_t frame = 0; frame < pipe->num_frames; frame++)
+    {
+        uint32_t index;
+
+        /* Dequeue a buffer from the mocked capture plane */
+        pthread_mutex_lock(&pipe->lock);
+        while (pipe->free_buffers.empty())
+            pthread_cond_wait(&pipe->cond, &pipe->lock);
+        index = pipe->free_buffers.front();
+        pipe->free_buffers.erase(pipe->free_buffers.begin());
+        pthread_mutex_unlock(&pipe->lock);
+
+        run_on_engine(ENGINE_DECODER, pipe->costs->decode_usec);
+
+        pthread_mutex_lock(&pipe->lock);
+        pipe->buffer_frame[index] = frame;
+        pipe->in_flight[index] = true;
+        pipe->decoded_frames++;
+        pthread_mutex_unlock(&pipe->lock);
+
+        if (pipe->fanout->publish(index) < 0)
+        {
+            fail(pipe, "publish failed", index);
+            break;
+        }
+    }
+    pipe->fanout->close();
+
+    return NULL;
+}
+
+static void *
+branch_thread(void *arg)
+{
+    branch_context *branch = (branch_context *) arg;
+    pipeline_context *pipe = branch->pipe;
+    const mock_costs *costs = pipe->costs;
+    uint32_t index;
+
+    while (pipe->fanout->acquire(branch->branch_id, index) == 0)
+    {
+        uint32_t bit = 1 << branch->branch_id;
+        uint32_t frame;
+
+        pthread_mutex_lock(&pipe->lock);
+        if (pipe->holders[index] & bit)
+            fail(pipe, "buffer delivered twice to a rendition", index);
+        pipe->holders[index] |= bit;
+        frame = pipe->buffer_frame[index];
+        pthread_mutex_unlock(&pipe->lock);
+
+        if (frame < branch->next_frame ||
+            (branch->policy == NV_FANOUT_POLICY_BLOCK && frame != branch->next_frame))
+            fail(pipe, "frame out of order", index);
+        branch->next_frame = frame + 1;
+
+        run_on_engine(ENGINE_SCALER, scale_cost(costs->scale_usec, branch->desc));
+
+        /* The decoder must not have reused the buffer while it was scaled */
+        pthread_mutex_lock(&pipe->lock);
+        if (pipe->buffer_frame[index] != frame)
+            fail(pipe, "buffer overwritten while a rendition reads it", index);
+        pipe->holders[index] &= ~bit;
+        pthread_mutex_unlock(&pipe->lock);
+        pipe->fanout->release(branch->branch_id, index);
+
+        run_on_engine(ENGINE_ENCODER, scale_cost(costs->encode_usec, branch->desc));
+        if (branch->slow)
+            usleep(costs->slow_sink_usec);
+        branch->encoded_frames++;
+    }
+
+    return NULL;
+}
+
+static int
+start_pipeline(pipeline_context *pipe, const rendition_desc *renditions,
+               uint32_t num_renditions, bool slow_last, uint32_t num_frames,
+               uint32_t num_buffers, uint32_t depth, NvFanoutPolicy slow_policy,
+               const mock_costs &costs)
+{
+    pipe->costs = &costs;
+    pipe->num_frames = num_frames;
+    pthread_mutex_init(&pipe->lock, NULL);
+    pthread_cond_init(&pipe->cond, NULL);
+    for (uint32_t i = 0; i < num_buffers; i++)
+        pipe->free_buffers.push_back(i);
+    pipe->buffer_frame.assign(num_buffers, 0);
+    pipe->holders.assign(num_buffers, 0);
+    pipe->in_flight.assign(num_buffers, false);
+    pipe->decoded_frames = 0;
+    pipe->ok = true;
+
+    pipe->fanout = new NvBufferFanout("Mock", num_buffers, recycle_buffer, pipe);
+    pipe->branches.resize(num_renditions);
+    for (uint32_t i = 0; i < num_renditions; i++)
+    {
+        branch_context *branch = &pipe->branches[i];
+        char name[32];
+        int id;
+
+        snprintf(name, sizeof(name), "%ux%u", renditions[i].width, renditions[i].height);
+        branch->pipe = pipe;
+        branch->desc = &renditions[i];
+        branch->slow = slow_last && (i == num_renditions - 1);
+        branch->policy = branch->slow ? slow_policy : NV_FANOUT_POLICY_BLOCK;
+        branch->next_frame = 0;
+        branch->encoded_frames = 0;
+        id = pipe->fanout->addBranch(name, depth, branch->policy);
+        if (id < 0)
+            return -1;
+        branch->branch_id = id;
+    }
+
+    /* Add all the branches before any branch thread starts acquiring. */
+    for (uint32_t i = 0; i < num_renditions; i++)
+    {
+        if (pthread_create(&pipe->branches[i].thread, NULL, branch_thread,
+                           &pipe->branches[i]) != 0)
+            return -1;
+    }
+
+    if (pthread_create(&pipe->decoder_thread, NULL, decoder_thread, pipe) != 0)
+        return -1;
+
+    return 0;
+}
+
+static void
+finish_pipeline(pipeline_context *pipe, run_result &result)
+{
+    NvBufferFanoutStats stats;
+
+    pthread_join(pipe->decoder_thread, NULL);
+    for (size_t i = 0; i < pipe->branches.size(); i++)
+        pthread_join(pipe->branches[i].thread, NULL);
+
+    pipe->fanout->getStats(stats);
+    if (stats.num_published != pipe->num_frames ||
+        stats.num_recycled != stats.num_published ||
+        pipe->free_buffers.size() != pipe->buffer_frame.size())
+        fail(pipe, "buffers leaked", 0);
+
+    for (size_t i = 0; i < pipe->branches.size(); i++)
+    {
+        NvBufferFanoutBranchStats branch_stats;
+
+        pipe->fanout->getBranchStats(pipe->branches[i].branch_id, branch_stats);
+        if (pipe->branches[i].encoded_frames + branch_stats.num_dropped != pipe->num_frames)
+            fail(pipe, "frames lost", i);
+        if (pipe->branches[i].policy == NV_FANOUT_POLICY_BLOCK && branch_stats.num_dropped)
+            fail(pipe, "frames dropped with block policy", i);
+        result.encoded_frames += pipe->branches[i].encoded_frames;
+        result.dropped_frames += branch_stats.num_dropped;
+    }
+    result.decoded_frames += pipe->decoded_frames;
+    result.ok = result.ok && pipe->ok;
+
+    delete pipe->fanout;
+    pthread_cond_destroy(&pipe->cond);
+    pthread_mutex_destroy(&pipe->lock);
+}
+
+static int
+run_pipelines(const rendition_desc *renditions, uint32_t num_renditions,
+              bool ladder, bool slow_last, uint32_t num_frames,
+              uint32_t num_buffers, uint32_t depth, NvFanoutPolicy slow_policy,
+              const mock_costs &costs, run_result &result)
+{
+    uint32_t num_pipes = ladder ? 1 : num_renditions;
+    vector<pipeline_context> pipes(num_pipes);
+    uint64_t start_usec = get_time_usec();
+    int ret = 0;
+
+    memset(&result, 0, sizeof(result));
+    result.ok = true;
+
+    for (uint32_t i = 0; i < num_pipes && ret == 0; i++)
+    {
+        if (ladder)
+            ret = start_pipeline(&pipes[i], renditions, num_renditions, slow_last,
+                                 num_frames, num_buffers, depth, slow_policy, costs);
+        else
+            ret = start_pipeline(&pipes[i], &renditions[i], 1,
+                                 slow_last && (i == num_renditions - 1),
+                                 num_frames, num_buffers, depth, slow_policy, costs);
+    }
+    if (ret < 0)
+    {
+        cerr << "Error creating pipeline threads" << endl;
+        exit(-1);
+    }
+
+    for (uint32_t i = 0; i < num_pipes; i++)
+        finish_pipeline(&pipes[i], result);
+    result.seconds = (get_time_usec() - start_usec) / 1000000.0;
+
+    return 0;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t num_frames = DEFAULT_FRAMES;
+    uint32_t num_renditions = MAX_RENDITIONS;
+    uint32_t num_buffers = DEFAULT_BUFFERS;
+    uint32_t depth = DEFAULT_DEPTH;
+    mock_costs costs;
+    UnitSampleTable table;
+    UnitSampleArgs args("./fanout_sample");
+    int opt;
+
+    costs.decode_usec = DEFAULT_DECODE_USEC;
+    costs.scale_usec = DEFAULT_SCALE_USEC;
+    costs.encode_usec = DEFAULT_ENCODE_USEC;
+    costs.slow_sink_usec = DEFAULT_SLOW_SINK_USEC;
+
+    args.option('n', "<frames>", "Frames to decode", DEFAULT_FRAMES)
+        .option('r', "<num>", "Renditions, 1080p/720p/480p", MAX_RENDITIONS)
+        .option('b', "<buffers>", "Decoder capture buffers", DEFAULT_BUFFERS)
+        .option('q', "<depth>", "Branch queue depth", DEFAULT_DEPTH)
+        .option('d', "<usec>", "1080p decode time", DEFAULT_DECODE_USEC)
+        .option('c', "<usec>", "1080p scale time", DEFAULT_SCALE_USEC)
+        .option('e', "<usec>", "1080p encode time", DEFAULT_ENCODE_USEC)
+        .option('s', "<usec>", "Extra time per frame of the slow rendition",
+                DEFAULT_SLOW_SINK_USEC);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                num_frames = atoi(optarg);
+                break;
+            case 'r':
+                num_renditions = atoi(optarg);
+                break;
+            case 'b':
+                num_buffers = atoi(optarg);
+                break;
+            case 'q':
+                depth = atoi(optarg);
+                break;
+            case 'd':
+                costs.decode_usec = atoi(optarg);
+                break;
+            case 'c':
+                costs.scale_usec = atoi(optarg);
+                break;
+            case 'e':
+                costs.encode_usec = atoi(optarg);
+                break;
+            case 's':
+                costs.slow_sink_usec = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (num_frames == 0 || num_buffers == 0 || depth == 0 ||
+        num_renditions == 0 || num_renditions > MAX_RENDITIONS)
+    {
+        cerr << "Frames, buffers and depth should be positive integers, "
+                "renditions between 1 and " << MAX_RENDITIONS << endl;
+        return -1;
+    }
+
+    cout << "Transcoding " << num_frames << " frames to " << num_renditions <<
+        " renditions, " << num_buffers << " decoder buffers, branch depth " <<
+        depth << endl;
+
+    const struct
+    {
+        const char *name;
+        bool ladder;
+        bool slow_last;
+        NvFanoutPolicy slow_policy;
+    } runs[] =
+    {
+        { "independent", false, false, NV_FANOUT_POLICY_BLOCK },
+        { "ladder", true, false, NV_FANOUT_POLICY_BLOCK },
+        { "slow block", true, true, NV_FANOUT_POLICY_BLOCK },
+        { "slow drop", true, true, NV_FANOUT_POLICY_DROP },
+    };
+    const uint32_t num_runs = sizeof(runs) / sizeof(runs[0]);
+    run_result results[num_runs];
+
+    for (uint32_t i = 0; i < num_runs; i++)
+    {
+        run_pipelines(ladder_renditions, num_renditions, runs[i].ladder,
+                      runs[i].slow_last, num_frames, num_buffers, depth,
+                      runs[i].slow_policy, costs, results[i]);
+    }
+
+    table.column("decoded", 10).column("encoded", 10).column("dropped", 10)
+        .column("dec fps", 10, 1).column("enc fps", 10, 1);
+    for (uint32_t i = 0; i < num_runs; i++)
+        table.row(runs[i].name, results[i].ok) << results[i].decoded_frames <<
+            results[i].encoded_frames << results[i].dropped_frames <<
+            results[i].decoded_frames / results[i].seconds <<
+            results[i].encoded_frames / results[i].seconds;
+
+    const bool all_ok = table.print();
+
+    cout << "Ladder throughput: " << fixed << setprecision(2) <<
+        (results[1].encoded_frames / results[1].seconds) /
+        (results[0].encoded_frames / results[0].seconds) <<
+        "x of independent transcodes" << endl;
+
+    return all_ok ? 0 : -1;
+}
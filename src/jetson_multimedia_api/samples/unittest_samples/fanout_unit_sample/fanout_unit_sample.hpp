@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvBufferFanout.h"
+#include "unit_sample.hpp"
+
+/**
+ * Describes one rendition of the mocked ladder.
+ */
+typedef struct
+{
+    /** Width of the rendition. */
+    uint32_t width;
+    /** Height of the rendition. */
+    uint32_t height;
+} rendition_desc;
+
+/**
+ * Holds the mocked per-frame costs, in microseconds at 1920x1080.
+ */
+typedef struct
+{
+    /** Decode time, serialized on the mocked decoder engine. */
+    uint32_t decode_usec;
+    /** Scale time, serialized on the mocked scaler engine. */
+    uint32_t scale_usec;
+    /** Encode time, serialized on the mocked encoder engine. */
+    uint32_t encode_usec;
+    /** Extra time per frame in the last rendition, outside the engines. */
+    uint32_t slow_sink_usec;
+} mock_costs;
+
+/**
+ * Holds the result of one run.
+ */
+typedef struct
+{
+    /** Wall time of the run in seconds. */
+    double seconds;
+    /** Number of frames decoded. */
+    uint64_t decoded_frames;
+    /** Number of frames encoded over all the renditions. */
+    uint64_t encoded_frames;
+    /** Number of frames dropped over all the renditions. */
+    uint64_t dropped_frames;
+    /** True if the buffer references and frame order checks passed. */
+    bool ok;
+} run_result;
+
+/**
+ * @brief Runs decode pipelines over mocked planes.
+ *
+ * Each pipeline has a mocked decoder capture plane with @a num_buffers
+ * buffers, whose buffers are fanned out with an NvBufferFanout to one
+ * scaler and encoder branch per rendition. Engine time is simulated by
+ * holding one lock per engine type for the mocked cost, scaled by the
+ * rendition area.
+ *
+ * With @a ladder set, one pipeline feeds all the renditions. Otherwise one
+ * pipeline is run per rendition, like independent transcodes of the same
+ * input.
+ *
+ * @param[in] renditions Renditions to encode
+ * @param[in] num_renditions Number of renditions
+ * @param[in] ladder Decode once for all renditions
+ * @param[in] slow_last Slow down the last rendition
+ * @param[in] num_frames Number of frames to decode
+ * @param[in] num_buffers Number of decoder capture buffers
+ * @param[in] depth Depth of each branch queue
+ * @param[in] slow_policy Policy of the slow rendition, the others block
+ * @param[in] costs Mocked costs
+ * @param[out] result Result of the run
+ * @return 0 for success, -1 otherwise
+ */
+static int
+run_pipelines(const rendition_desc *renditions, uint32_t num_renditions,
+              bool ladder, bool slow_last, uint32_t num_frames,
+              uint32_t num_buffers, uint32_t depth, NvFanoutPolicy slow_policy,
+              const mock_costs &costs, run_result &result);
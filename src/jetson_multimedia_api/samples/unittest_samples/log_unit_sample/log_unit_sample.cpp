@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./log_sample -b [iterations] [threads]
+ * ./log_sample -d binary_log_file
+ * Example:
+ * ./log_sample -b 1000000 4
+ * NVLOG_BACKEND=binary NVLOG_FILE=dec.nvlog ./video_decode ... ; ./log_sample -d dec.nvlog
+**/
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+#include "log_unit_sample.hpp"
+
+/**
+ * Asynchronous logging with NvLogging.
+ *
+ * The logging macros of NvLogging.h format and write each message on the
+ * calling thread by default. With LOG_BACKEND_ASYNC or LOG_BACKEND_BINARY
+ * the arguments of the message are recorded into a per-thread ring buffer,
+ * and formatted and written out by a background thread.
+ *
+ * This sample checks that the asynchronous backends format messages like
+ * the synchronous one, that no message is lost when switching backend
+ * while threads are logging and that component levels match by name, then
+ * measures the cost of a logging call for each backend:
+ * ## Messages filtered out by the log level.
+ * ## LOG_BACKEND_SYNC, with stderr redirected to /dev/null.
+ * ## LOG_BACKEND_ASYNC, writing text to /dev/null.
+ * ## LOG_BACKEND_BINARY, writing to a temporary file.
+ *
+ * Messages are logged in bursts that fit in the ring buffer, which is
+ * drained between the bursts outside of the timed sections, so that every
+ * message is accepted. The run fails if any message is dropped.
+ *
+ * It also decodes log files written by LOG_BACKEND_BINARY.
+**/
+
+#define CAT_NAME "LogSample"
+
+/* Messages per timed burst, well below the per-thread ring size. */
+#define BENCH_BURST 256
+/* Threads logging while the backend switches. */
+#define SWITCH_THREADS 4
+
+static uint32_t bench_iterations;
+
+static void *
+bench_thread(void *arg)
+{
+    double *ns = (double *) arg;
+    struct timespec start, stop;
+    uint32_t value = 0;
+    uint32_t i = 0;
+
+    *ns = 0;
+    while (i < bench_iterations)
+    {
+        uint32_t burst_end = min(i + BENCH_BURST, bench_iterations);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (; i < burst_end; i++)
+        {
+            CAT_DEBUG_MSG("Benchmark message " << i << " value " << value);
+            value += i;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        *ns += (stop.tv_sec - start.tv_sec) * 1e9 +
+            (stop.tv_nsec - start.tv_nsec);
+
+        /* Drain the ring before the next burst, untimed. */
+        NvLogFlush();
+    }
+    return NULL;
+}
+
+static double
+run_benchmark(uint32_t iterations, uint32_t num_threads)
+{
+    pthread_t threads[num_threads];
+    double thread_ns[num_threads];
+    double total_ns = 0;
+
+    bench_iterations = iterations;
+
+    for (uint32_t i = 0; i < num_threads; i++)
+        pthread_create(&threads[i], NULL, bench_thread, &thread_ns[i]);
+    for (uint32_t i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+        total_ns += thread_ns[i];
+    }
+
+    return total_ns / ((double) iterations * num_threads);
+}
+
+enum check_value
+{
+    CHECK_VALUE_A = 3,
+    CHECK_VALUE_B = 42,
+};
+
+/* Logs messages covering the argument types recorded by NvLogArgs. */
+static void
+log_check_messages()
+{
+    std::string str("string");
+    char comp_name[] = "LogCheck";
+
+    ERROR_MSG("ints " << -5 << " " << 7u << " " << (short) -2 << " " <<
+        (int64_t) -9000000000LL << " " << (uint64_t) 18000000000ULL);
+    ERROR_MSG("hex " << hex << 255 << " " << (short) -1 << " " << -1 <<
+        dec << " dec " << 255 << " oct " << oct << 8 << dec);
+    ERROR_MSG("chars " << 'x' << (unsigned char) 'y' << " bool " << true <<
+        " " << false);
+    ERROR_MSG("floats " << 1.5 << " " << 0.1f << " " << 1e20 << " " <<
+        3.14159265358979);
+    ERROR_MSG("strings " << str << " " << comp_name <<
+        " " << std::string(300, 'z').substr(0, 3));
+    ERROR_MSG("enum " << CHECK_VALUE_B << " " << CHECK_VALUE_A);
+    ERROR_MSG("endl" << std::endl << "next line");
+}
+
+/* Reads a log file and strips the timestamp and thread ID of each message,
+ * which the synchronous backend does not print. */
+static bool
+read_messages(const char *path, std::string &messages)
+{
+    std::ifstream file(path);
+    std::string line;
+
+    if (!file)
+        return false;
+    messages.clear();
+    while (getline(file, line))
+    {
+        size_t pos = line.find("] [");
+        if (line.compare(0, 1, "[") && pos != std::string::npos)
+            line = line.substr(pos + 2);
+        messages += line + "\n";
+    }
+    return true;
+}
+
+static bool
+check_formatting(const char *tmp_path)
+{
+    std::string expected, text, decoded;
+    std::ostringstream decode_out;
+    int saved_stderr, fd;
+    bool ok = true;
+
+    /* Reference output of the synchronous backend. */
+    fd = open(tmp_path, O_WRONLY | O_TRUNC);
+    saved_stderr = dup(STDERR_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+    log_check_messages();
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stderr);
+    ok = read_messages(tmp_path, expected);
+
+    if (ok && NvLogSetBackend(LOG_BACKEND_ASYNC, tmp_path) == 0)
+    {
+        log_check_messages();
+        NvLogSetBackend(LOG_BACKEND_SYNC);
+        ok = read_messages(tmp_path, text) && text == expected;
+        if (!ok)
+            cerr << "Async output differs:\n" << text << "expected:\n" << expected;
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if (ok && NvLogSetBackend(LOG_BACKEND_BINARY, tmp_path) == 0)
+    {
+        log_check_messages();
+        NvLogSetBackend(LOG_BACKEND_SYNC);
+        ok = NvLogDecodeBinary(tmp_path, decode_out) == 0;
+        std::ofstream(tmp_path) << decode_out.str();
+        ok = ok && read_messages(tmp_path, decoded) && decoded == expected;
+        if (!ok)
+            cerr << "Binary output differs:\n" << decoded << "expected:\n" << expected;
+    }
+    else
+    {
+        ok = false;
+    }
+
+    return ok;
+}
+
+/* First message of a new thread, so that its ring is allocated while the
+ * message is being logged. */
+static void *
+sys_error_thread(void *arg)
+{
+    errno = EACCES;
+    SYS_ERROR_MSG("errno check");
+    return NULL;
+}
+
+static bool
+check_sys_error(const char *tmp_path)
+{
+    std::string text;
+    pthread_t thread;
+    bool ok;
+
+    if (NvLogSetBackend(LOG_BACKEND_ASYNC, tmp_path) < 0)
+        return false;
+    ok = pthread_create(&thread, NULL, sys_error_thread, NULL) == 0;
+    if (ok)
+        pthread_join(thread, NULL);
+    NvLogSetBackend(LOG_BACKEND_SYNC);
+
+    ok = ok && read_messages(tmp_path, text) &&
+        text.find(std::string("errno check: ") + strerror(EACCES)) !=
+            std::string::npos;
+    if (!ok)
+        cerr << "System error message differs:\n" << text;
+    return ok;
+}
+
+static atomic<bool> switch_done;
+
+static void *
+switch_thread(void *arg)
+{
+    uint32_t *count = (uint32_t *) arg;
+
+    for (*count = 0; !switch_done.load(); (*count)++)
+        CAT_ERROR_MSG("Switch message " << *count);
+    return NULL;
+}
+
+static uint32_t
+count_lines(const char *path, const char *str)
+{
+    std::ifstream file(path);
+    std::string line;
+    uint32_t count = 0;
+
+    while (getline(file, line))
+    {
+        if (line.find(str) != std::string::npos)
+            count++;
+    }
+    return count;
+}
+
+/* Switches back to the synchronous backend while threads are logging.
+ * Each message must end up either in the log file or on stderr. */
+static bool
+check_backend_switch(const char *tmp_path)
+{
+    char sync_path[] = "/tmp/log_sample_sync_XXXXXX";
+    pthread_t threads[SWITCH_THREADS];
+    uint32_t counts[SWITCH_THREADS];
+    uint64_t dropped, logged = 0;
+    int saved_stderr, fd;
+    bool ok;
+
+    fd = mkstemp(sync_path);
+    if (fd < 0)
+        return false;
+    if (NvLogSetBackend(LOG_BACKEND_ASYNC, tmp_path) < 0)
+    {
+        close(fd);
+        unlink(sync_path);
+        return false;
+    }
+    saved_stderr = dup(STDERR_FILENO);
+    dup2(fd, STDERR_FILENO);
+    close(fd);
+
+    dropped = NvLogGetDroppedCount();
+    switch_done = false;
+    for (uint32_t i = 0; i < SWITCH_THREADS; i++)
+        pthread_create(&threads[i], NULL, switch_thread, &counts[i]);
+    usleep(10000);
+    NvLogSetBackend(LOG_BACKEND_SYNC);
+    switch_done = true;
+    for (uint32_t i = 0; i < SWITCH_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        logged += counts[i];
+    }
+    dropped = NvLogGetDroppedCount() - dropped;
+
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stderr);
+
+    ok = count_lines(tmp_path, "Switch message") +
+        count_lines(sync_path, "Switch message") + dropped == logged;
+    if (!ok)
+        cerr << "Messages lost while switching backend" << endl;
+    unlink(sync_path);
+    return ok;
+}
+
+static bool
+check_component_levels()
+{
+    /* Same name in two different buffers, as with two components. */
+    char name_a[] = "CompCheck";
+    char name_b[] = "CompCheck";
+    bool ok;
+
+    NvLogSetComponentLevel(name_a, LOG_LEVEL_DEBUG);
+    ok = NvLogGetComponentLevel(name_a) == LOG_LEVEL_DEBUG &&
+        NvLogGetComponentLevel(name_b) == LOG_LEVEL_DEBUG &&
+        NvLogGetComponentLevel("Other") == log_level;
+    NvLogSetComponentLevel(name_b, -1);
+    ok = ok && NvLogGetComponentLevel(name_a) == log_level;
+    return ok;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t iterations = 1000000;
+    uint32_t num_threads = 1;
+    char bin_path[] = "/tmp/log_sample_XXXXXX";
+    int saved_stderr, null_fd, bin_fd;
+    double ns_filtered, ns_sync, ns_async, ns_binary;
+    uint64_t dropped;
+    UnitSampleTable table(20);
+    UnitSampleArgs args("./log_sample");
+
+    args.usage("-b [iterations] [threads]",
+               "Benchmark the logging backends [Default = 1000000 iterations, 1 thread]")
+        .usage("-d binary_log_file",
+               "Decode a log file written by the binary backend");
+
+    if (argc < 2 || !strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))
+    {
+        args.printHelp();
+        return 0;
+    }
+
+    if (!strcmp(argv[1], "-d"))
+    {
+        if (argc < 3)
+        {
+            args.printHelp();
+            return -1;
+        }
+        return NvLogDecodeBinary(argv[2], cout);
+    }
+
+    if (strcmp(argv[1], "-b"))
+    {
+        args.printHelp();
+        return -1;
+    }
+    if (argc >= 3)
+        iterations = atoi(argv[2]);
+    if (argc >= 4)
+        num_threads = atoi(argv[3]);
+    if (iterations == 0 || num_threads == 0)
+    {
+        cerr << "Iterations and threads should be positive integers" << endl;
+        return -1;
+    }
+
+    bin_fd = mkstemp(bin_path);
+    if (bin_fd < 0)
+    {
+        cerr << "Could not create temporary file" << endl;
+        return -1;
+    }
+    close(bin_fd);
+
+    log_level = LOG_LEVEL_ERROR;
+    NvLogSetRateLimit(0);
+    table.column("dropped", 10);
+    table.row("async formatting", check_formatting(bin_path));
+    table.row("system errors", check_sys_error(bin_path));
+    table.row("backend switch", check_backend_switch(bin_path));
+    table.row("component levels", check_component_levels());
+
+    dropped = NvLogGetDroppedCount();
+    ns_filtered = run_benchmark(iterations, num_threads);
+
+    log_level = LOG_LEVEL_DEBUG;
+
+    /* The synchronous backend writes to stderr; discard it. */
+    saved_stderr = dup(STDERR_FILENO);
+    null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDERR_FILENO);
+    ns_sync = run_benchmark(iterations, num_threads);
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stderr);
+    close(null_fd);
+
+    if (NvLogSetBackend(LOG_BACKEND_ASYNC, "/dev/null") < 0)
+        return -1;
+    ns_async = run_benchmark(iterations, num_threads);
+    NvLogSetBackend(LOG_BACKEND_SYNC);
+
+    if (NvLogSetBackend(LOG_BACKEND_BINARY, bin_path) < 0)
+        return -1;
+    ns_binary = run_benchmark(iterations, num_threads);
+    NvLogSetBackend(LOG_BACKEND_SYNC);
+    unlink(bin_path);
+
+    log_level = DEFAULT_LOG_LEVEL;
+
+    cout << "Logging cost per call (" << iterations << " iterations, " <<
+        num_threads << " threads):" << endl;
+    cout << "Filtered by log level = " << ns_filtered << " ns" << endl;
+    cout << "Sync backend          = " << ns_sync << " ns" << endl;
+    cout << "Async backend         = " << ns_async << " ns" << endl;
+    cout << "Binary backend        = " << ns_binary << " ns" << endl;
+    dropped = NvLogGetDroppedCount() - dropped;
+    /* A dropped message means the cost of the drop path was measured. */
+    table.row("benchmark", dropped == 0) << dropped;
+
+    return table.print() ? 0 : -1;
+}
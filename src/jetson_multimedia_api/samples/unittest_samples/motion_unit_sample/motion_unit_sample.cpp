@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./motion_sample [-i <file.mv>] [-b]
+ * Example:
+ * ./motion_sample
+ * ./motion_sample -b
+ * ./motion_sample -i motion.mv
+**/
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "motion_unit_sample.hpp"
+
+/**
+ * Motion analytics on encoder motion vectors with NvMotionActivity.
+ *
+ * 01_video_encode --mv-export <file.mv> writes the motion vectors of each
+ * encoded frame to a binary file, and --motion-detect reports motion events
+ * computed from them. This sample runs the same analysis without an encoder:
+ * ## Synthetic sequence: checks the frame and region motion events and
+ *    the binary file round trip
+ * ## Replay (-i): prints the motion events of a recorded binary file
+ * ## Benchmark (-b): measures the analysis throughput for 1080p and 4K
+**/
+
+#define SYNTH_BLOCKS_X 120
+#define SYNTH_BLOCKS_Y 68
+#define SYNTH_FRAMES 150
+#define MOVING_START 30
+#define MOVING_END 90
+#define OBJECT_W 16
+#define OBJECT_H 12
+#define OBJECT_ROW 28
+#define BENCH_FRAMES 2000
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t
+pack_mv(int32_t x, int32_t y)
+{
+    return ((uint32_t) x & 0xffff) | (((uint32_t) y & 0x3fff) << 16);
+}
+
+static void
+generate_frame(uint32_t frame_num, uint32_t blocks_x, uint32_t blocks_y,
+               vector<uint32_t> &mvs)
+{
+    uint32_t seed = frame_num * 7919 + 1;
+    uint32_t object_x = (frame_num - MOVING_START) * (blocks_x - OBJECT_W) /
+        (MOVING_END - MOVING_START);
+
+    mvs.resize(blocks_x * blocks_y);
+    for (uint32_t by = 0; by < blocks_y; by++)
+    {
+        for (uint32_t bx = 0; bx < blocks_x; bx++)
+        {
+            /* Sensor noise and encoder search noise */
+            int32_t x = (int32_t) (rand_r(&seed) % 5) - 2;
+            int32_t y = (int32_t) (rand_r(&seed) % 3) - 1;
+
+            if (frame_num >= MOVING_START && frame_num < MOVING_END &&
+                bx >= object_x && bx < object_x + OBJECT_W &&
+                by >= OBJECT_ROW && by < OBJECT_ROW + OBJECT_H)
+            {
+                x = -24;
+                y = 3;
+            }
+            mvs[by * blocks_x + bx] = pack_mv(x, y);
+        }
+    }
+}
+
+static void
+log_event(const NvMotionEvent &event, void *arg)
+{
+    ((event_log *) arg)->events.push_back(event);
+}
+
+static void
+run_synthetic_check(const char *export_path, UnitSampleTable &table)
+{
+    NvMotionActivity *activity = new NvMotionActivity(SYNTH_BLOCKS_X, SYNTH_BLOCKS_Y);
+    event_log log;
+    vector<uint32_t> mvs;
+    bool file_ok = true;
+
+    /* Through the ring and the worker, as the encoder does */
+    activity->setEventCallback(log_event, &log);
+    if (activity->openExport(export_path) < 0 || activity->start() < 0)
+    {
+        delete activity;
+        table.row("events", false);
+        return;
+    }
+    for (uint32_t i = 0; i < SYNTH_FRAMES; i++)
+    {
+        generate_frame(i, SYNTH_BLOCKS_X, SYNTH_BLOCKS_Y, mvs);
+        /* Retry on a full ring so that no frame is dropped for the check */
+        while (activity->push(i, &mvs[0], mvs.size()) < 0)
+            usleep(100);
+    }
+    activity->stop();
+    activity->printStats(cout);
+    delete activity;
+
+    bool frame_start = false, frame_end = false;
+    uint32_t region_starts = 0;
+    for (size_t i = 0; i < log.events.size(); i++)
+    {
+        const NvMotionEvent &event = log.events[i];
+
+        cout << "Frame " << event.frame_num << ": motion " <<
+            (event.motion ? "start" : "end") << " region " << event.region << endl;
+        if (event.region < 0 && event.motion)
+            frame_start = (event.frame_num >= MOVING_START &&
+                           event.frame_num < MOVING_START + 5);
+        else if (event.region < 0)
+            frame_end = (event.frame_num >= MOVING_END &&
+                         event.frame_num < MOVING_END + 20);
+        else if (event.motion)
+            region_starts++;
+    }
+    /* The object moves through the 4 region columns of its region rows */
+    table.row("events", frame_start && frame_end && region_starts >= 4) <<
+        log.events.size() << "-";
+
+    /* Read the binary file back */
+    ifstream file(export_path, ios::binary);
+    NvMotionVectorFrameHeader header;
+    vector<uint32_t> read_mvs;
+    uint32_t frames = 0;
+
+    while (NvMotionActivity::readFrame(file, header, read_mvs) == 0)
+    {
+        generate_frame(header.frame_num, SYNTH_BLOCKS_X, SYNTH_BLOCKS_Y, mvs);
+        if (header.frame_num != frames || header.blocks_x != SYNTH_BLOCKS_X ||
+            header.blocks_y != SYNTH_BLOCKS_Y || read_mvs != mvs)
+        {
+            cerr << "Binary motion vector file mismatch at frame " << frames << endl;
+            file_ok = false;
+            break;
+        }
+        frames++;
+    }
+    if (frames != SYNTH_FRAMES)
+    {
+        cerr << "Read " << frames << " of " << SYNTH_FRAMES << " frames" << endl;
+        file_ok = false;
+    }
+    table.row("mv file", file_ok) << "-" << frames;
+}
+
+static int
+run_replay(const char *path)
+{
+    ifstream file(path, ios::binary);
+    NvMotionVectorFrameHeader header;
+    vector<uint32_t> mvs;
+    NvMotionActivity *activity = NULL;
+
+    if (!file.is_open())
+    {
+        cerr << "Could not open " << path << endl;
+        return -1;
+    }
+
+    while (NvMotionActivity::readFrame(file, header, mvs) == 0)
+    {
+        if (!activity)
+            activity = new NvMotionActivity(header.blocks_x, header.blocks_y);
+        activity->analyzeFrame(header.frame_num, mvs.empty() ? NULL : &mvs[0], mvs.size());
+    }
+    if (!activity)
+    {
+        cerr << "No motion vector frames in " << path << endl;
+        return -1;
+    }
+    activity->printStats(cout);
+    delete activity;
+
+    return 0;
+}
+
+static void
+run_benchmark(uint32_t width, uint32_t height, uint32_t block_size)
+{
+    uint32_t blocks_x = (width + block_size - 1) / block_size;
+    uint32_t blocks_y = (height + block_size - 1) / block_size;
+    NvMotionActivity activity(blocks_x, blocks_y);
+    vector<uint32_t> mvs;
+    uint64_t start_usec, usec;
+
+    activity.setEventCallback(NULL, NULL);
+    generate_frame(MOVING_START + 10, blocks_x, blocks_y, mvs);
+
+    start_usec = get_time_usec();
+    for (uint32_t i = 0; i < BENCH_FRAMES; i++)
+        activity.analyzeFrame(i, &mvs[0], mvs.size());
+    usec = get_time_usec() - start_usec;
+    if (usec == 0)
+        usec = 1;
+
+    cout << width << "x" << height << " (" << blocks_x << "x" << blocks_y <<
+        " blocks): " << fixed << setprecision(2) <<
+        (double) usec / BENCH_FRAMES << " us per frame, " <<
+        (double) BENCH_FRAMES * blocks_x * blocks_y / usec << " M motion vectors/s" << endl;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    const char *in_path = NULL;
+    bool benchmark = false;
+    UnitSampleTable table;
+    UnitSampleArgs args("./motion_sample");
+    int opt;
+
+    args.description("Without options, check the analysis on a synthetic sequence")
+        .option('i', "<file.mv>",
+                "Replay a binary motion vector file (01_video_encode --mv-export)")
+        .option('b', NULL, "Benchmark the analysis throughput");
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                in_path = optarg;
+                break;
+            case 'b':
+                benchmark = true;
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+
+    if (in_path)
+        return run_replay(in_path);
+
+    if (benchmark)
+    {
+        run_benchmark(1920, 1080, 16);
+        run_benchmark(3840, 2160, 16);
+        run_benchmark(3840, 2160, 32);
+        return 0;
+    }
+
+    table.column("events", 8).column("frames", 8);
+    run_synthetic_check("motion_sample.mv", table);
+    return table.print() ? 0 : -1;
+}
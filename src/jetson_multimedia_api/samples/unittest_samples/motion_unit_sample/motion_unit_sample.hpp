@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvMotionActivity.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the events collected from an NvMotionActivity.
+ */
+typedef struct
+{
+    /** Events in the order they were raised. */
+    std::vector<NvMotionEvent> events;
+} event_log;
+
+/**
+ * @brief Generates the motion vectors of a synthetic frame.
+ *
+ * Every block has a small random motion vector. Between frames
+ * MOVING_START and MOVING_END an object of OBJECT_W x OBJECT_H blocks
+ * moves from left to right with a large motion vector.
+ *
+ * @param[in] frame_num Frame number
+ * @param[in] blocks_x Number of blocks in a row
+ * @param[in] blocks_y Number of block rows
+ * @param[out] mvs Motion vector words (MVInfo packing)
+ */
+static void
+generate_frame(uint32_t frame_num, uint32_t blocks_x, uint32_t blocks_y,
+               std::vector<uint32_t> &mvs);
+
+/**
+ * @brief Checks the motion events of the synthetic sequence and the binary
+ * motion vector file round trip.
+ *
+ * @param[in] export_path Path of the binary file to write and read back
+ * @param[out] table Result table the rows of the checks are added to
+ */
+static void
+run_synthetic_check(const char *export_path, UnitSampleTable &table);
+
+/**
+ * @brief Replays a binary motion vector file and prints its motion events.
+ *
+ * @param[in] path Path of the binary motion vector file
+ * @return 0 for success, -1 otherwise
+ */
+static int
+run_replay(const char *path);
+
+/**
+ * @brief Measures the analysis throughput for a frame size.
+ *
+ * @param[in] width Width of the frame in pixels
+ * @param[in] height Height of the frame in pixels
+ * @param[in] block_size Block size of the motion vectors in pixels
+ */
+static void
+run_benchmark(uint32_t width, uint32_t height, uint32_t block_size);
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./multistream_unit_sample [-f <sensor fps>] [-n <frames>]
+ * Example:
+ * ./multistream_unit_sample
+ * ./multistream_unit_sample -f 60 -n 600
+**/
+
+#include <iostream>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "multistream_unit_sample.hpp"
+
+/**
+ * nvarguscamerasrc request pads.
+ *
+ * Each aux_src_%u request pad of nvarguscamerasrc gets an Argus output
+ * stream of its own, created in the capture session of the always pad and
+ * enabled in its request, so that one capture feeds every resolution.
+ * NvArgusStreamSet tracks those streams and decimates the frames of a pad
+ * negotiated at a lower frame rate than the sensor.
+ *
+ * This sample drives the set with a fake provider and checks:
+ * ## Pads are added up to the limit, and only while the set is stopped
+ * ## start() creates and enables a stream per configured pad, at its size
+ * ## A failed create or enable destroys the streams created so far
+ * ## Each pad gets one in every round(sensor fps / pad fps) frames
+ * ## stop() destroys every stream
+**/
+
+#define DEFAULT_SENSOR_FPS 30
+#define DEFAULT_FRAMES 300
+#define MAX_STREAMS 3
+
+fake_provider::fake_provider()
+    : fail_create(-1)
+    , fail_enable(-1)
+    , created(0)
+    , enabled(0)
+    , destroyed(0)
+{
+}
+
+fake_provider::~fake_provider()
+{
+    for (size_t i = 0; i < live.size(); i++)
+        delete live[i];
+}
+
+void *
+fake_provider::createStream(unsigned int width, unsigned int height)
+{
+    fake_stream *stream;
+
+    if (created++ == fail_create)
+        return NULL;
+
+    stream = new fake_stream;
+    stream->width = width;
+    stream->height = height;
+    stream->enabled = false;
+    live.push_back(stream);
+    return stream;
+}
+
+bool
+fake_provider::enableStream(void *stream)
+{
+    if (enabled++ == fail_enable)
+        return false;
+
+    ((fake_stream *) stream)->enabled = true;
+    return true;
+}
+
+void
+fake_provider::destroyStream(void *stream)
+{
+    for (size_t i = 0; i < live.size(); i++)
+    {
+        if (live[i] == stream)
+        {
+            live.erase(live.begin() + i);
+            break;
+        }
+    }
+    delete (fake_stream *) stream;
+    destroyed++;
+}
+
+typedef struct
+{
+    NvArgusStreamSet *streams;
+    int id;
+    uint32_t num_frames;
+    uint64_t delivered;
+} capture_context;
+
+static void *
+capture_thread(void *arg)
+{
+    capture_context *ctx = (capture_context *) arg;
+
+    for (uint32_t i = 0; i < ctx->num_frames; i++)
+    {
+        if (ctx->streams->getStream(ctx->id) && ctx->streams->onFrame(ctx->id))
+            ctx->delivered++;
+    }
+    return NULL;
+}
+
+static void
+capture_frames(NvArgusStreamSet &streams, uint32_t num_frames, vector<uint64_t> &delivered)
+{
+    vector<int> ids = streams.getStartedIds();
+    vector<capture_context> contexts(ids.size());
+    vector<pthread_t> threads(ids.size());
+
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        contexts[i].streams = &streams;
+        contexts[i].id = ids[i];
+        contexts[i].num_frames = num_frames;
+        contexts[i].delivered = 0;
+        pthread_create(&threads[i], NULL, capture_thread, &contexts[i]);
+    }
+    delivered.clear();
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        pthread_join(threads[i], NULL);
+        delivered.push_back(contexts[i].delivered);
+    }
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const stream_counts &counts, bool ok)
+{
+    table.row(name, ok) << counts.streams << counts.frames << counts.delivered <<
+        counts.decimated;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./multistream_unit_sample");
+    stream_options options;
+    int opt;
+
+    options.sensor_fps = DEFAULT_SENSOR_FPS;
+    options.num_frames = DEFAULT_FRAMES;
+
+    args.option('f', "<fps>", "Sensor frame rate", DEFAULT_SENSOR_FPS)
+        .option('n', "<frames>", "Frames captured", DEFAULT_FRAMES);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'f':
+                options.sensor_fps = atoi(optarg);
+                break;
+            case 'n':
+                options.num_frames = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (options.sensor_fps == 0 || options.num_frames == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("streams", 9).column("frames", 8).column("delivered", 11)
+        .column("skipped", 9);
+
+    /* Pads are added up to the limit; ids are not reused */
+    {
+        stream_counts counts = stream_counts();
+        NvArgusStreamSet streams(MAX_STREAMS);
+        bool ok = true;
+
+        for (int i = 0; i < MAX_STREAMS; i++)
+            ok = ok && streams.addStream() == i;
+        ok = ok && streams.addStream() == -1;
+        ok = ok && streams.removeStream(1) && !streams.removeStream(1);
+        ok = ok && streams.addStream() == MAX_STREAMS;
+        ok = ok && !streams.isConfigured();
+        ok = ok && !streams.configure(1, 640, 480, 30, 1);
+        ok = ok && !streams.configure(0, 0, 480, 30, 1);
+        ok = ok && streams.configure(0, 640, 480, 30, 1) &&
+            streams.configure(2, 640, 480, 30, 1) &&
+            streams.configure(MAX_STREAMS, 640, 480, 30, 1);
+        ok = ok && streams.isConfigured();
+        streams.unconfigure();
+        ok = ok && !streams.isConfigured();
+        add_result(table, "pads", counts, ok);
+    }
+
+    /* One stream per configured pad, at its size and rate */
+    {
+        stream_counts counts = stream_counts();
+        NvArgusStreamSet streams(MAX_STREAMS);
+        fake_provider provider;
+        const uint32_t fps = options.sensor_fps;
+        /* Full rate, half rate and an unconfigured pad */
+        int full = streams.addStream();
+        int half = streams.addStream();
+        int idle = streams.addStream();
+        vector<uint64_t> delivered;
+        bool ok;
+
+        ok = streams.configure(full, 1280, 720, fps, 1) &&
+            streams.configure(half, 640, 480, fps, 2);
+        ok = ok && streams.start(&provider, fps, 1);
+        ok = ok && provider.created == 2 && provider.live.size() == 2 &&
+            provider.live[0]->width == 1280 && provider.live[0]->height == 720 &&
+            provider.live[0]->enabled &&
+            provider.live[1]->width == 640 && provider.live[1]->height == 480 &&
+            provider.live[1]->enabled;
+        ok = ok && streams.getStream(full) == provider.live[0] &&
+            streams.getStream(idle) == NULL && streams.getStartedIds().size() == 2;
+        ok = ok && streams.getDecimation(full) == 1 && streams.getDecimation(half) == 2;
+        /* Nothing changes while started */
+        ok = ok && streams.addStream() == -1 && !streams.removeStream(idle) &&
+            !streams.configure(idle, 320, 240, fps, 1) &&
+            !streams.start(&provider, fps, 1) && provider.created == 2;
+
+        if (ok)
+        {
+            capture_frames(streams, options.num_frames, delivered);
+            counts.frames = options.num_frames;
+            for (size_t i = 0; i < delivered.size(); i++)
+            {
+                NvArgusStreamStats stats = streams.getStats(streams.getStartedIds()[i]);
+                counts.delivered += stats.delivered;
+                counts.decimated += stats.decimated;
+                ok = ok && stats.delivered == delivered[i] &&
+                    stats.captured == options.num_frames &&
+                    stats.delivered + stats.decimated == stats.captured;
+            }
+            ok = ok && delivered.size() == 2 && delivered[0] == options.num_frames &&
+                delivered[1] == (options.num_frames + 1) / 2;
+        }
+
+        streams.stop(&provider);
+        counts.streams = provider.created;
+        add_result(table, "start", counts,
+                   ok && provider.destroyed == 2 && provider.live.empty() &&
+                   streams.getStartedIds().empty() && streams.removeStream(idle));
+    }
+
+    /* A failed create or enable leaves no stream behind */
+    {
+        stream_counts counts = stream_counts();
+        NvArgusStreamSet streams(MAX_STREAMS);
+        fake_provider create_fails;
+        fake_provider enable_fails;
+        fake_provider provider;
+        bool ok = true;
+
+        for (int i = 0; i < MAX_STREAMS; i++)
+            ok = ok && streams.configure(streams.addStream(), 640, 480, 30, 1);
+
+        create_fails.fail_create = 1;
+        ok = ok && !streams.start(&create_fails, 30, 1) &&
+            create_fails.created == 2 && create_fails.destroyed == 1 &&
+            create_fails.live.empty() && streams.getStartedIds().empty();
+
+        enable_fails.fail_enable = 2;
+        ok = ok && !streams.start(&enable_fails, 30, 1) &&
+            enable_fails.created == 3 && enable_fails.destroyed == 3 &&
+            enable_fails.live.empty() && streams.getStartedIds().empty();
+
+        /* The set is still stopped, and starts once the provider works */
+        ok = ok && streams.start(&provider, 30, 1) && provider.live.size() == MAX_STREAMS;
+        streams.stop(&provider);
+        counts.streams = create_fails.created + enable_fails.created + provider.created;
+        add_result(table, "rollback", counts, ok && provider.live.empty());
+    }
+
+    /* Each pad gets one in every round(sensor fps / pad fps) frames */
+    {
+        stream_counts counts = stream_counts();
+        NvArgusStreamSet streams(MAX_STREAMS);
+        fake_provider provider;
+        const uint32_t fps = options.sensor_fps;
+        /* Pad rates: a third, about a seventh, and none given */
+        const int fps_n[MAX_STREAMS] = { (int) fps, (int) fps * 1001, 0 };
+        const int fps_d[MAX_STREAMS] = { 3, 7000, 1 };
+        vector<uint64_t> delivered;
+        bool ok = true;
+
+        for (int i = 0; i < MAX_STREAMS; i++)
+            ok = ok && streams.configure(streams.addStream(), 320, 240, fps_n[i], fps_d[i]);
+        ok = ok && streams.start(&provider, fps, 1);
+        ok = ok && streams.getDecimation(0) == 3 && streams.getDecimation(1) == 7 &&
+            streams.getDecimation(2) == 1;
+
+        if (ok)
+        {
+            capture_frames(streams, options.num_frames, delivered);
+            counts.frames = options.num_frames;
+            for (int i = 0; i < MAX_STREAMS; i++)
+            {
+                uint32_t decimation = streams.getDecimation(i);
+                NvArgusStreamStats stats = streams.getStats(i);
+
+                /* The first frame, then every 'decimation' frames */
+                ok = ok && delivered[i] == (options.num_frames + decimation - 1) / decimation;
+                counts.delivered += stats.delivered;
+                counts.decimated += stats.decimated;
+            }
+
+            /* A frame no buffer was free for counts as dropped */
+            streams.onDrop(2);
+            NvArgusStreamStats stats = streams.getStats(2);
+            ok = ok && stats.dropped == 1 && stats.delivered == options.num_frames - 1;
+        }
+        streams.stop(&provider);
+
+        /* A later start counts from zero */
+        ok = ok && streams.start(&provider, fps, 1) && streams.getStats(0).captured == 0 &&
+            streams.onFrame(0) && !streams.onFrame(0);
+        streams.stop(&provider);
+        counts.streams = provider.created;
+        add_result(table, "decimate", counts, ok && provider.live.empty());
+    }
+
+    cout << "Request pads of a " << options.sensor_fps << " fps sensor, " << options.num_frames <<
+        " frames captured" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "gstnvarguscamera_streams.h"
+#include "unit_sample.hpp"
+
+/**
+ * Options of the sample.
+ */
+typedef struct
+{
+    /** Sensor frame rate, in frames per second. */
+    uint32_t sensor_fps;
+    /** Frames captured by the fake session. */
+    uint32_t num_frames;
+} stream_options;
+
+/**
+ * Output stream of the fake provider.
+ */
+typedef struct
+{
+    /** Resolution the stream was created with. */
+    unsigned int width;
+    unsigned int height;
+    /** True once enabled in the request. */
+    bool enabled;
+} fake_stream;
+
+/**
+ * Fake provider standing in for the capture session and its request.
+ */
+class fake_provider : public NvArgusStreamProvider
+{
+public:
+    fake_provider();
+    ~fake_provider();
+
+    virtual void *createStream(unsigned int width, unsigned int height);
+    virtual bool enableStream(void *stream);
+    virtual void destroyStream(void *stream);
+
+    /** Index of the createStream call that fails, or -1. */
+    int fail_create;
+    /** Index of the enableStream call that fails, or -1. */
+    int fail_enable;
+    /** Calls made so far. */
+    int created;
+    int enabled;
+    int destroyed;
+    /** Streams not destroyed yet. */
+    std::vector<fake_stream *> live;
+};
+
+/**
+ * Holds the frame counts of one test.
+ */
+typedef struct
+{
+    /** Output streams started. */
+    uint32_t streams;
+    /** Frames captured per stream. */
+    uint64_t frames;
+    /** Frames delivered, over all streams. */
+    uint64_t delivered;
+    /** Frames skipped by decimation, over all streams. */
+    uint64_t decimated;
+} stream_counts;
+
+/**
+ * @brief Feeds frames to every started stream of a set, a thread per stream.
+ *
+ * Each thread stands for the consumer of a request pad, acquiring every frame
+ * of its stream and counting the ones decimation delivers.
+ *
+ * @param[in] streams Started stream set
+ * @param[in] num_frames Frames captured per stream
+ * @param[out] delivered Frames delivered per stream, in getStartedIds() order
+ */
+static void capture_frames(NvArgusStreamSet &streams, uint32_t num_frames,
+                           std::vector<uint64_t> &delivered);
@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./overlay_sample [-l <labels>] [-n <frames>] [-s <size>]
+ * Example:
+ * ./overlay_sample
+ * ./overlay_sample -l 1024 -s 16
+**/
+
+#include <iostream>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "overlay_unit_sample.hpp"
+#include "Courier16x24.h"
+
+/**
+ * Batched text and box overlay.
+ *
+ * GLContext::renderText() used one draw call per character and the
+ * samples drew their boxes separately. NvOverlay collects all the text and
+ * boxes of a frame into one list of quads, drawn by
+ * GLContext::renderOverlay() from one vertex buffer with one draw call, or
+ * blended into a buffer on the CPU by NvOverlay::composite().
+ *
+ * This sample uses the CPU path with the font of GLContext, and checks:
+ * ## Unchanged strings reuse their layout, unused layouts are evicted
+ * ## A frame is one list of six vertices per quad, flagged when it changes
+ * ## Filled and outlined boxes in RGBA, with pixel center coverage
+ * ## Blending in NV12, with chroma from the coverage of its four pixels
+ * ## A glyph drawn at the font size matches the font atlas
+ * ## The time to build and composite frames with more and more labels
+**/
+
+#define DEFAULT_LABELS 256
+#define DEFAULT_FRAMES 30
+#define DEFAULT_SIZE 24
+#define FRAME_WIDTH 1920
+#define FRAME_HEIGHT 1080
+
+static const NvOverlayColor white = { 1.0f, 1.0f, 1.0f, 1.0f };
+static const NvOverlayColor shade = { 0.0f, 0.0f, 0.0f, 0.5f };
+static const NvOverlayColor red = { 1.0f, 0.0f, 0.0f, 1.0f };
+static const NvOverlayColor green = { 0.0f, 1.0f, 0.0f, 1.0f };
+static const NvOverlayColor blue = { 0.0f, 0.0f, 1.0f, 0.5f };
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static NvOverlayFont
+courier_font(void)
+{
+    NvOverlayFont font;
+
+    font.pixels = courier16x24;
+    font.width = 256;
+    font.height = 144;
+    font.columns = 16;
+    font.rows = 6;
+    font.first_char = ' ';
+    return font;
+}
+
+static int
+allocate_buffer(NvBufSurfCpuTransform &cpu, uint32_t width, uint32_t height,
+                NvBufSurfaceColorFormat format)
+{
+    NvBufSurf::NvCommonAllocateParams params;
+    int fd = -1;
+
+    memset(&params, 0, sizeof(params));
+    params.width = width;
+    params.height = height;
+    params.colorFormat = format;
+    params.layout = NVBUF_LAYOUT_PITCH;
+    params.memType = NVBUF_MEM_SYSTEM;
+    if (cpu.allocate(&params, 1, &fd) < 0)
+        return -1;
+    return fd;
+}
+
+/* Fills a plane with a repeated pixel value of 'bytes' bytes */
+static void
+fill_plane(NvBufSurfaceParams &s, uint32_t plane, const uint8_t *value, uint32_t bytes)
+{
+    const NvBufSurfacePlaneParams &p = s.planeParams;
+
+    for (uint32_t y = 0; y < p.height[plane]; y++)
+    {
+        uint8_t *row = (uint8_t *) s.mappedAddr.addr[plane] + (size_t) y * p.pitch[plane];
+
+        for (uint32_t x = 0; x < p.width[plane]; x++)
+            memcpy(row + x * bytes, value, bytes);
+    }
+}
+
+static uint8_t *
+pixel_at(NvBufSurfaceParams &s, uint32_t plane, uint32_t x, uint32_t y, uint32_t bytes)
+{
+    return (uint8_t *) s.mappedAddr.addr[plane] + (size_t) y * s.planeParams.pitch[plane] +
+        x * bytes;
+}
+
+static uint8_t
+expected_blend(uint8_t dst, uint8_t src, uint32_t alpha)
+{
+    return (uint8_t) ((src * alpha + dst * (255 - alpha) + 127) / 255);
+}
+
+static uint32_t
+add_labels(NvOverlay &overlay, uint32_t labels, uint32_t frame, float size)
+{
+    uint32_t columns = (uint32_t) ceil(sqrt((double) labels));
+    uint32_t rows = (labels + columns - 1) / columns;
+    float tile_width = (float) overlay.getWidth() / columns;
+    float tile_height = (float) overlay.getHeight() / rows;
+    uint32_t chars = 0;
+    char text[64];
+
+    for (uint32_t i = 0; i < labels; i++)
+    {
+        float x = (i % columns) * tile_width;
+        float y = (i / columns) * tile_height;
+        float fps = 30.0f;
+
+        if (i == frame % labels)
+            fps -= (frame % 20) * 0.1f;
+        snprintf(text, sizeof(text), "cam%03u %4.1f fps", i, fps);
+        overlay.addText(x + 4, y + 4, size, text, white, &shade);
+        chars += strlen(text);
+
+        overlay.addBox(x + tile_width / 4, y + tile_height / 4,
+                       tile_width / 2, tile_height / 2, 2, red);
+        overlay.addText(x + tile_width / 4, y + tile_height / 4 - size * 0.75f,
+                        size * 0.75f, "person 0.87", red);
+        chars += strlen("person 0.87");
+    }
+    return chars;
+}
+
+/* The benchmark adds the draws before batching and the time per frame */
+static UnitSampleTable::Row &
+add_result(UnitSampleTable &table, const char *name, uint32_t labels, uint64_t quads, bool ok)
+{
+    return table.row(name, ok) << labels << quads;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(12);
+    UnitSampleArgs args("./overlay_sample");
+    uint32_t max_labels = DEFAULT_LABELS;
+    uint32_t num_frames = DEFAULT_FRAMES;
+    float size = DEFAULT_SIZE;
+    NvOverlayFont font = courier_font();
+    int opt;
+
+    args.option('l', "<labels>", "Most streams labelled in the benchmark", DEFAULT_LABELS)
+        .option('n', "<frames>", "Frames per benchmark", DEFAULT_FRAMES)
+        .option('s', "<size>", "Text size in pixels", DEFAULT_SIZE);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'l':
+                max_labels = atoi(optarg);
+                break;
+            case 'n':
+                num_frames = atoi(optarg);
+                break;
+            case 's':
+                size = atof(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (max_labels == 0 || num_frames == 0 || size < 4)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("labels", 8).column("quads", 10).column("draws before", 14)
+        .column("us/frame", 14, 1);
+
+    /* Layouts are reused while a string is drawn and evicted when unused */
+    {
+        const uint32_t strings = 20;
+        const uint32_t frames = 10;
+        NvOverlay overlay(font, strings + 2);
+        NvOverlayStats stats;
+        char text[32];
+        bool ok;
+
+        for (uint32_t f = 0; f < frames; f++)
+        {
+            overlay.begin(640, 480);
+            for (uint32_t i = 0; i < strings; i++)
+            {
+                snprintf(text, sizeof(text), "label %u", i);
+                overlay.addText(0, i * 20.0f, 16, text, white);
+            }
+            snprintf(text, sizeof(text), "frame %u", f);
+            overlay.addText(320, 0, 16, text, white);
+            overlay.end();
+        }
+        overlay.getStats(&stats);
+        /* Each frame string is laid out once; the cache evicts the old ones */
+        ok = stats.layout_misses == strings + frames &&
+            stats.layout_hits == strings * (frames - 1) &&
+            stats.layout_evictions == frames - 2;
+
+        /* A new set of strings evicts all the previous ones */
+        overlay.begin(640, 480);
+        for (uint32_t i = 0; i < strings + 2; i++)
+        {
+            snprintf(text, sizeof(text), "other %u", i);
+            overlay.addText(0, i * 20.0f, 16, text, white);
+        }
+        overlay.end();
+        overlay.getStats(&stats);
+        ok = ok && stats.layout_evictions == frames - 2 + strings + 2;
+
+        add_result(table, "layout", strings + 1, stats.num_quads / stats.num_frames, ok);
+    }
+
+    /* A frame is one vertex list, flagged when it changes */
+    {
+        const uint32_t labels = 16;
+        NvOverlay overlay(font);
+        uint32_t chars;
+        uint64_t glyphs = 0;
+        bool ok = true;
+
+        overlay.begin(FRAME_WIDTH, FRAME_HEIGHT);
+        chars = add_labels(overlay, labels, 0, size);
+        ok = overlay.end() && overlay.getGeneration() == 1;
+
+        const vector<NvOverlayQuad> &quads = overlay.getQuads();
+        for (size_t i = 0; i < quads.size(); i++)
+            glyphs += quads[i].u0 >= 0.0f;
+        /* Glyphs for all but the spaces, one background, and four box sides */
+        ok = ok && glyphs == chars - 3 * labels &&
+            quads.size() == glyphs + labels + 4 * labels &&
+            overlay.getVertices().size() == 6 * quads.size();
+
+        const NvOverlayVertex *v = &overlay.getVertices()[0];
+        ok = ok && v[0].x == quads[0].x0 && v[0].y == quads[0].y0 &&
+            v[5].x == quads[0].x1 && v[5].y == quads[0].y1 &&
+            memcmp(v[5].color, quads[0].color, 4) == 0;
+
+        /* The same frame again is unchanged, another frame rate is not */
+        overlay.begin(FRAME_WIDTH, FRAME_HEIGHT);
+        add_labels(overlay, labels, 0, size);
+        ok = !overlay.end() && overlay.getGeneration() == 1 && ok;
+        overlay.begin(FRAME_WIDTH, FRAME_HEIGHT);
+        add_labels(overlay, labels, 1, size);
+        ok = overlay.end() && overlay.getGeneration() == 2 && ok;
+
+        add_result(table, "batch", labels * 3, overlay.getQuads().size(), ok);
+    }
+
+    /* Boxes in RGBA: pixels whose center is inside, outlines leave the inside */
+    {
+        NvBufSurfCpuTransform cpu;
+        int fd = allocate_buffer(cpu, 64, 48, NVBUF_COLOR_FORMAT_RGBA);
+        NvOverlay overlay(font);
+        const uint8_t gray[4] = { 50, 60, 70, 255 };
+        bool ok = fd >= 0;
+
+        if (ok)
+        {
+            NvBufSurfaceParams &s = cpu.getSurface(fd)->surfaceList[0];
+
+            fill_plane(s, 0, gray, 4);
+            overlay.begin(64, 48);
+            overlay.addBox(10.4f, 8.0f, 10.2f, 12.0f, 0, red);
+            overlay.addBox(30.0f, 10.0f, 20.0f, 20.0f, 3, green);
+            /* Clipped to the buffer */
+            overlay.addBox(-5.0f, 40.0f, 10.0f, 20.0f, 0, red);
+            overlay.end();
+            ok = overlay.composite(cpu.getSurface(fd)) == 0;
+
+            for (uint32_t y = 0; y < 48; y++)
+            {
+                for (uint32_t x = 0; x < 64; x++)
+                {
+                    const uint8_t *p = pixel_at(s, 0, x, y, 4);
+                    bool in_red = (x >= 10 && x <= 20 && y >= 8 && y < 20) ||
+                        (x < 5 && y >= 40);
+                    bool in_green = x >= 30 && x < 50 && y >= 10 && y < 30 &&
+                        !(x >= 33 && x < 47 && y >= 13 && y < 27);
+                    uint8_t want[4];
+
+                    memcpy(want, gray, 4);
+                    if (in_red)
+                        want[0] = 255, want[1] = 0, want[2] = 0;
+                    if (in_green)
+                        want[0] = 0, want[1] = 255, want[2] = 0;
+                    if (memcmp(p, want, 4) != 0)
+                    {
+                        cerr << "FAIL: RGBA pixel " << x << "," << y << " is " <<
+                            (int) p[0] << "," << (int) p[1] << "," << (int) p[2] << endl;
+                        ok = false;
+                        y = 48;
+                        break;
+                    }
+                }
+            }
+            cpu.destroy(fd);
+        }
+
+        add_result(table, "rgba box", 3, overlay.getQuads().size(), ok);
+    }
+
+    /* Blending in NV12: luma per pixel, chroma from four pixels */
+    {
+        NvBufSurfCpuTransform cpu;
+        int fd = allocate_buffer(cpu, 64, 48, NVBUF_COLOR_FORMAT_NV12);
+        NvOverlay overlay(font);
+        const uint8_t luma = 100;
+        const uint8_t chroma[2] = { 128, 128 };
+        /* Blue at half alpha, BT.601 limited range */
+        const uint8_t alpha = 128;
+        const uint8_t y_blue = ((25 * 255 + 128) >> 8) + 16;
+        const uint8_t u_blue = ((112 * 255 + 128) >> 8) + 128;
+        const uint8_t v_blue = ((-18 * 255 + 128) >> 8) + 128;
+        bool ok = fd >= 0;
+
+        if (ok)
+        {
+            NvBufSurfaceParams &s = cpu.getSurface(fd)->surfaceList[0];
+
+            fill_plane(s, 0, &luma, 1);
+            fill_plane(s, 1, chroma, 2);
+            /* Pixels 9 to 23, rows 6 to 17: the first chroma column is half covered */
+            overlay.begin(64, 48);
+            overlay.addBox(9.0f, 6.0f, 15.0f, 12.0f, 0, blue);
+            overlay.end();
+            ok = overlay.composite(cpu.getSurface(fd)) == 0;
+
+            for (uint32_t y = 0; y < 48 && ok; y++)
+            {
+                for (uint32_t x = 0; x < 64; x++)
+                {
+                    bool inside = x >= 9 && x < 24 && y >= 6 && y < 18;
+                    uint8_t want = inside ? expected_blend(luma, y_blue, alpha) : luma;
+
+                    if (*pixel_at(s, 0, x, y, 1) != want)
+                    {
+                        cerr << "FAIL: luma " << x << "," << y << " is " <<
+                            (int) *pixel_at(s, 0, x, y, 1) << ", not " << (int) want << endl;
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+            for (uint32_t y = 0; y < 24 && ok; y++)
+            {
+                for (uint32_t x = 0; x < 32; x++)
+                {
+                    const uint8_t *p = pixel_at(s, 1, x, y, 2);
+                    uint32_t a = 0;
+
+                    if (y >= 3 && y < 9 && x >= 4 && x < 12)
+                        a = x == 4 ? (alpha + alpha + 2) >> 2 : alpha;
+                    if (p[0] != (a ? expected_blend(128, u_blue, a) : 128) ||
+                        p[1] != (a ? expected_blend(128, v_blue, a) : 128))
+                    {
+                        cerr << "FAIL: chroma " << x << "," << y << " is " <<
+                            (int) p[0] << "," << (int) p[1] << endl;
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+            cpu.destroy(fd);
+        }
+
+        add_result(table, "nv12 blend", 1, overlay.getQuads().size(), ok);
+    }
+
+    /* A glyph at the font size covers its cell with the coverage of the atlas */
+    {
+        NvBufSurfCpuTransform cpu;
+        int fd = allocate_buffer(cpu, 64, 48, NVBUF_COLOR_FORMAT_RGBA);
+        NvOverlay overlay(font);
+        const uint8_t black[4] = { 0, 0, 0, 255 };
+        /* 'A' is in column 1 of the third row of 16x24 cells */
+        const uint32_t cell_x = ('A' - ' ') % 16 * 16;
+        const uint32_t cell_y = ('A' - ' ') / 16 * 24;
+        uint64_t atlas_sum = 0;
+        uint64_t drawn_sum = 0;
+        bool ok = fd >= 0;
+
+        if (ok)
+        {
+            NvBufSurfaceParams &s = cpu.getSurface(fd)->surfaceList[0];
+
+            fill_plane(s, 0, black, 4);
+            overlay.begin(64, 48);
+            overlay.addText(8.0f, 8.0f, 24.0f, "A", white);
+            overlay.end();
+            ok = overlay.composite(cpu.getSurface(fd)) == 0;
+
+            for (uint32_t y = 0; y < 24; y++)
+            {
+                for (uint32_t x = 0; x < 16; x++)
+                    atlas_sum += courier16x24[(cell_y + y) * 256 + cell_x + x];
+            }
+            for (uint32_t y = 0; y < 48; y++)
+            {
+                for (uint32_t x = 0; x < 64; x++)
+                {
+                    const uint8_t *p = pixel_at(s, 0, x, y, 4);
+                    bool in_cell = x >= 8 && x < 24 && y >= 8 && y < 32;
+
+                    if (!in_cell && p[0] != 0)
+                        ok = false;
+                    drawn_sum += p[0];
+                }
+            }
+            /* The cell is sampled with an inset, so the sums differ slightly */
+            ok = ok && atlas_sum > 0 &&
+                fabs((double) drawn_sum - atlas_sum) < 0.1 * atlas_sum;
+            cpu.destroy(fd);
+        }
+
+        add_result(table, "glyph", 1, overlay.getQuads().size(), ok);
+    }
+
+    /* Time to build and composite frames with more and more labels */
+    {
+        NvBufSurfCpuTransform cpu;
+        int fd_nv12 = allocate_buffer(cpu, FRAME_WIDTH, FRAME_HEIGHT, NVBUF_COLOR_FORMAT_NV12);
+        int fd_rgba = allocate_buffer(cpu, FRAME_WIDTH, FRAME_HEIGHT, NVBUF_COLOR_FORMAT_RGBA);
+        vector<uint32_t> counts;
+
+        for (uint32_t labels = 16; labels < max_labels; labels *= 4)
+            counts.push_back(labels);
+        counts.push_back(max_labels);
+
+        for (size_t c = 0; c < counts.size() && fd_nv12 >= 0 && fd_rgba >= 0; c++)
+        {
+            uint32_t labels = counts[c];
+            /* Room for the strings of a frame and the ones that change */
+            NvOverlay overlay(font, 2 * labels);
+            NvOverlayStats stats;
+            uint64_t build_usec = 0;
+            uint64_t nv12_usec = 0;
+            uint64_t rgba_usec = 0;
+            uint64_t chars = 0;
+            bool build_ok = true;
+            bool nv12_ok = true;
+            bool rgba_ok = true;
+
+            for (uint32_t f = 0; f < num_frames; f++)
+            {
+                uint64_t start = get_time_usec();
+
+                overlay.begin(FRAME_WIDTH, FRAME_HEIGHT);
+                chars = add_labels(overlay, labels, f, size);
+                /* One frame rate changes in every frame */
+                build_ok = (overlay.end() || f % 20 == 0) && build_ok;
+                build_usec += get_time_usec() - start;
+
+                start = get_time_usec();
+                nv12_ok = overlay.composite(cpu.getSurface(fd_nv12)) == 0 && nv12_ok;
+                nv12_usec += get_time_usec() - start;
+
+                start = get_time_usec();
+                rgba_ok = overlay.composite(cpu.getSurface(fd_rgba)) == 0 && rgba_ok;
+                rgba_usec += get_time_usec() - start;
+            }
+            overlay.getStats(&stats);
+            /* After the first frame, only the changing frame rate is laid out */
+            build_ok = build_ok && stats.layout_misses <= labels + 1 + num_frames;
+
+            /* Before, one draw per character and one box call per frame */
+            add_result(table, "build", labels * 3, stats.num_quads / num_frames, build_ok) <<
+                chars + 1 << (double) build_usec / num_frames;
+            add_result(table, "nv12", labels * 3, stats.num_quads / num_frames, nv12_ok) <<
+                chars + 1 << (double) nv12_usec / num_frames;
+            add_result(table, "rgba", labels * 3, stats.num_quads / num_frames, rgba_ok) <<
+                chars + 1 << (double) rgba_usec / num_frames;
+        }
+        if (fd_nv12 < 0 || fd_rgba < 0)
+            table.row("bench", false);
+        if (fd_nv12 >= 0)
+            cpu.destroy(fd_nv12);
+        if (fd_rgba >= 0)
+            cpu.destroy(fd_rgba);
+    }
+
+    cout << "Frame " << FRAME_WIDTH << "x" << FRAME_HEIGHT << ", text " << size << " px" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./passthrough_unit_sample [-s <width>x<height>] [-n <frames>] [-b <buffers>] [-k <held>]
+ * Example:
+ * ./passthrough_unit_sample
+ * ./passthrough_unit_sample -s 3840x2160 -k 6
+**/
+
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <condition_variable>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "passthrough_unit_sample.hpp"
+
+/**
+ * nvarguscamerasrc passthrough buffers.
+ *
+ * When downstream takes NVMM NV12 at the stream size, nvarguscamerasrc
+ * pushes the surfaces Argus copies its frames into, instead of transforming
+ * each one into a pool buffer. NvArgusBufferRing holds those surfaces and
+ * lends each one to the GstBuffer wrapping it until downstream frees it.
+ *
+ * This sample drives the ring with a fake producer backed by system memory
+ * and checks:
+ * ## A surface is not handed out again while downstream holds it
+ * ## The producer waits, then resumes, when downstream holds every surface
+ * ## shutdown() wakes the producer and frees the surfaces once the last
+ *    lent buffer comes back
+ * ## A failed allocation frees the surfaces already allocated
+ *
+ * It also times the CPU copy of a frame, the copy that passthrough saves.
+**/
+
+#define DEFAULT_WIDTH 1920
+#define DEFAULT_HEIGHT 1080
+#define DEFAULT_FRAMES 120
+#define DEFAULT_BUFFERS 8
+#define DEFAULT_HOLD 3
+#define DEFAULT_WORK_USEC 5000
+#define ACQUIRE_TIMEOUT_USEC 1000000
+
+static atomic<uint32_t> g_allocs(0);
+static atomic<uint32_t> g_frees(0);
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *
+fake_alloc(void *user_data, unsigned int index, int *fd)
+{
+    fake_producer *producer = (fake_producer *) user_data;
+    void *surface;
+
+    if ((int) index == producer->fail_index)
+        return NULL;
+
+    surface = calloc(1, producer->size);
+    if (surface)
+    {
+        *fd = 100 + index;
+        g_allocs++;
+    }
+    return surface;
+}
+
+static void
+fake_free(void *surface)
+{
+    free(surface);
+    g_frees++;
+}
+
+static NvArgusBufferRing *
+create_ring(fake_producer &producer, uint32_t num_buffers, size_t size, int fail_index)
+{
+    NvArgusBufferRingOps ops;
+
+    producer.size = size;
+    producer.fail_index = fail_index;
+    ops.alloc = fake_alloc;
+    ops.free = fake_free;
+    ops.user_data = &producer;
+    g_allocs = 0;
+    g_frees = 0;
+    return NvArgusBufferRing::create(num_buffers, ops);
+}
+
+/* Writes the frame number over the surface, like a frame copy would */
+static void
+stamp_surface(void *surface, size_t size, uint64_t number)
+{
+    uint64_t *words = (uint64_t *) surface;
+
+    for (size_t i = 0; i < size / sizeof(uint64_t); i++)
+        words[i] = number;
+}
+
+static bool
+check_surface(const void *surface, size_t size, uint64_t number)
+{
+    const uint64_t *words = (const uint64_t *) surface;
+
+    /* First, middle and last words; a reuse overwrites all of them */
+    return words[0] == number && words[size / sizeof(uint64_t) / 2] == number &&
+        words[size / sizeof(uint64_t) - 1] == number;
+}
+
+/**
+ * Lent buffer as a GstBuffer would carry it.
+ */
+typedef struct
+{
+    void *surface;
+    void *release_data;
+    uint64_t number;
+} lent_buffer;
+
+/**
+ * Queue between the producer and the fake downstream, as nvmm_buffers.
+ */
+typedef struct
+{
+    mutex lock;
+    condition_variable cond;
+    deque<lent_buffer> buffers;
+    bool eos;
+} buffer_queue;
+
+typedef struct
+{
+    const ring_options *options;
+    buffer_queue *queue;
+    size_t size;
+    uint64_t received;
+    uint64_t corrupted;
+    uint64_t out_of_order;
+} downstream_context;
+
+static void *
+downstream_thread(void *arg)
+{
+    downstream_context *ctx = (downstream_context *) arg;
+    deque<lent_buffer> held;
+    uint64_t expected = 0;
+
+    while (true)
+    {
+        lent_buffer buffer;
+        {
+            unique_lock<mutex> lock(ctx->queue->lock);
+            while (ctx->queue->buffers.empty() && !ctx->queue->eos)
+                ctx->queue->cond.wait(lock);
+            if (ctx->queue->buffers.empty())
+                break;
+            buffer = ctx->queue->buffers.front();
+            ctx->queue->buffers.pop_front();
+        }
+
+        if (buffer.number != expected++)
+            ctx->out_of_order++;
+        ctx->received++;
+        held.push_back(buffer);
+        if (ctx->options->work_usec)
+            usleep(ctx->options->work_usec);
+
+        while (held.size() > ctx->options->hold)
+        {
+            if (!check_surface(held.front().surface, ctx->size, held.front().number))
+                ctx->corrupted++;
+            NvArgusBufferRing::release(held.front().release_data);
+            held.pop_front();
+        }
+    }
+
+    while (!held.empty())
+    {
+        if (!check_surface(held.front().surface, ctx->size, held.front().number))
+            ctx->corrupted++;
+        NvArgusBufferRing::release(held.front().release_data);
+        held.pop_front();
+    }
+    return NULL;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, uint64_t frames,
+           const NvArgusBufferRingStats &stats, double usec_per_frame, bool ok)
+{
+    table.row(name, ok) << frames << stats.stalls << stats.stallTimeUs / 1000.0 <<
+        stats.maxLent << usec_per_frame;
+}
+
+static void
+stream_frames(const ring_options &options, UnitSampleTable &table)
+{
+    fake_producer producer;
+    buffer_queue queue;
+    downstream_context ctx;
+    size_t size = (size_t) options.width * options.height * 3 / 2;
+    NvArgusBufferRing *ring = create_ring(producer, options.num_buffers, size, -1);
+    pthread_t thread;
+    NvArgusBufferRingStats stats;
+    uint64_t lent = 0;
+    uint64_t start;
+    double usec_per_frame;
+
+    if (!ring)
+    {
+        table.row("stream", false);
+        return;
+    }
+
+    queue.eos = false;
+    ctx.options = &options;
+    ctx.queue = &queue;
+    ctx.size = size;
+    ctx.received = 0;
+    ctx.corrupted = 0;
+    ctx.out_of_order = 0;
+    pthread_create(&thread, NULL, downstream_thread, &ctx);
+
+    start = get_time_usec();
+    for (uint64_t number = 0; number < options.num_frames; number++)
+    {
+        int slot = ring->acquire(ACQUIRE_TIMEOUT_USEC);
+        if (slot < 0)
+            break;
+
+        stamp_surface(ring->getSurface(slot), size, number);
+        lent_buffer buffer = { ring->getSurface(slot), ring->lend(slot), number };
+        lent++;
+
+        unique_lock<mutex> lock(queue.lock);
+        queue.buffers.push_back(buffer);
+        queue.cond.notify_one();
+    }
+    usec_per_frame = lent ? (double) (get_time_usec() - start) / lent : 0.0;
+    stats = ring->getStats();
+    ring->shutdown();
+
+    {
+        unique_lock<mutex> lock(queue.lock);
+        queue.eos = true;
+        queue.cond.notify_one();
+    }
+    pthread_join(thread, NULL);
+
+    add_result(table, "stream", lent, stats, usec_per_frame,
+               lent == options.num_frames && ctx.received == lent && ctx.corrupted == 0 &&
+               ctx.out_of_order == 0 && stats.maxLent <= options.num_buffers &&
+               g_frees == options.num_buffers);
+}
+
+/* Measures the frame copy that passthrough avoids */
+static double
+copy_usec_per_frame(size_t size, uint32_t num_frames)
+{
+    vector<uint8_t> src(size, 0x80);
+    vector<uint8_t> dst(size);
+    volatile uint8_t sink = 0;
+    uint64_t start = get_time_usec();
+
+    for (uint32_t i = 0; i < num_frames; i++)
+    {
+        src[i % size] = (uint8_t) i;
+        memcpy(dst.data(), src.data(), size);
+        sink = sink + dst[i % size];
+    }
+    return (double) (get_time_usec() - start) / num_frames;
+}
+
+typedef struct
+{
+    NvArgusBufferRing *ring;
+    int slot;
+    uint64_t usec;
+} blocked_acquire;
+
+static void *
+blocked_acquire_thread(void *arg)
+{
+    blocked_acquire *acquire = (blocked_acquire *) arg;
+    uint64_t start = get_time_usec();
+
+    acquire->slot = acquire->ring->acquire(5 * ACQUIRE_TIMEOUT_USEC);
+    acquire->usec = get_time_usec() - start;
+    return NULL;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./passthrough_unit_sample");
+    ostringstream default_size;
+    ring_options options;
+    int opt;
+
+    options.width = DEFAULT_WIDTH;
+    options.height = DEFAULT_HEIGHT;
+    options.num_frames = DEFAULT_FRAMES;
+    options.num_buffers = DEFAULT_BUFFERS;
+    options.hold = DEFAULT_HOLD;
+    options.work_usec = DEFAULT_WORK_USEC;
+
+    default_size << DEFAULT_WIDTH << "x" << DEFAULT_HEIGHT;
+    args.option('s', "<w>x<h>", "Frame size", default_size.str())
+        .option('n', "<frames>", "Frames streamed", DEFAULT_FRAMES)
+        .option('b', "<buffers>", "Surfaces in the ring", DEFAULT_BUFFERS)
+        .option('k', "<held>", "Buffers held by downstream", DEFAULT_HOLD);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                if (!UnitSampleArgs::parseSize(optarg, &options.width, &options.height))
+                    options.width = 0;
+                break;
+            case 'n':
+                options.num_frames = atoi(optarg);
+                break;
+            case 'b':
+                options.num_buffers = atoi(optarg);
+                break;
+            case 'k':
+                options.hold = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (options.width < 16 || options.height < 16 || options.num_frames == 0 ||
+        options.hold == 0 || options.num_buffers <= options.hold)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("frames", 8).column("stalls", 8).column("stall ms", 11, 1).column("held", 8)
+        .column("us/frame", 11, 1);
+
+    /* Downstream slower than the producer, holding a few buffers */
+    stream_frames(options, table);
+
+    /* The producer waits while every surface is lent, and resumes on release */
+    {
+        NvArgusBufferRingStats stats = NvArgusBufferRingStats();
+        fake_producer producer;
+        NvArgusBufferRing *ring = create_ring(producer, 4, 64, -1);
+        vector<void *> release_data;
+        vector<int> slots;
+        bool ok = ring != NULL;
+
+        for (int i = 0; ok && i < 4; i++)
+        {
+            int slot = ring->acquire(0);
+            ok = slot >= 0 && ring->getFd(slot) == 100 + slot;
+            if (ok)
+            {
+                slots.push_back(slot);
+                release_data.push_back(ring->lend(slot));
+            }
+        }
+        ok = ok && ring->acquire(10000) == -1 && ring->getStats().stalls == 1;
+        if (ok)
+        {
+            NvArgusBufferRing::release(release_data[2]);
+            release_data[2] = NULL;
+            /* The released surface is the only free one, cancelling returns it */
+            int slot = ring->acquire(0);
+            ok = slot == slots[2];
+            if (ok)
+            {
+                ring->cancel(slot);
+                slot = ring->acquire(0);
+                ok = slot == slots[2];
+            }
+            if (ok)
+                release_data[2] = ring->lend(slot);
+        }
+        if (ring)
+        {
+            stats = ring->getStats();
+            ring->shutdown();
+        }
+        for (size_t i = 0; i < release_data.size(); i++)
+            if (release_data[i])
+                NvArgusBufferRing::release(release_data[i]);
+        add_result(table, "stall", stats.lent, stats, 0.0,
+                   ok && stats.lent == 5 && stats.returned == 1 && stats.maxLent == 4 &&
+                   g_frees == 4);
+    }
+
+    /* shutdown() wakes the producer; the surfaces outlive it until released */
+    {
+        NvArgusBufferRingStats stats = NvArgusBufferRingStats();
+        fake_producer producer;
+        NvArgusBufferRing *ring = create_ring(producer, 3, 64, -1);
+        vector<void *> release_data;
+        blocked_acquire acquire;
+        pthread_t thread;
+        bool ok = ring != NULL;
+
+        for (int i = 0; ok && i < 3; i++)
+            release_data.push_back(ring->lend(ring->acquire(0)));
+        if (ok)
+        {
+            acquire.ring = ring;
+            acquire.slot = 0;
+            acquire.usec = 0;
+            pthread_create(&thread, NULL, blocked_acquire_thread, &acquire);
+            usleep(20000);
+            stats = ring->getStats();
+            ring->shutdown();
+            pthread_join(thread, NULL);
+            ok = acquire.slot == -1 && acquire.usec < ACQUIRE_TIMEOUT_USEC;
+        }
+        for (size_t i = 0; i < release_data.size(); i++)
+        {
+            ok = ok && g_frees == 0;
+            NvArgusBufferRing::release(release_data[i]);
+        }
+        add_result(table, "shutdown", release_data.size(), stats, 0.0, ok && g_frees == 3);
+    }
+
+    /* A failed allocation leaves nothing behind */
+    {
+        fake_producer producer;
+        NvArgusBufferRing *ring = create_ring(producer, 4, 64, 2);
+
+        add_result(table, "alloc", 0, NvArgusBufferRingStats(), 0.0,
+                   ring == NULL && g_allocs == 2 && g_frees == 2);
+    }
+
+    size_t frame_size = (size_t) options.width * options.height * 3 / 2;
+    double copy_usec = copy_usec_per_frame(frame_size, 100);
+
+    cout << "Streaming " << options.num_frames << " " << options.width << "x" << options.height <<
+        " NV12 frames through " << options.num_buffers << " surfaces, " << options.hold <<
+        " held downstream" << endl;
+    const bool all_ok = table.print();
+    cout << "Copy avoided per frame: " << fixed << setprecision(2) <<
+        2.0 * frame_size / (1024 * 1024) << " MB of memory traffic, " << setprecision(1) <<
+        copy_usec << " us as a CPU memcpy (copied at " <<
+        (copy_usec > 0.0 ? frame_size / copy_usec / 1000.0 : 0.0) << " GB/s)" << endl;
+
+    return all_ok ? 0 : -1;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gstnvarguscamera_ring.h"
+#include "unit_sample.hpp"
+
+/**
+ * Options of the sample.
+ */
+typedef struct
+{
+    /** Frame width. */
+    uint32_t width;
+    /** Frame height. */
+    uint32_t height;
+    /** Frames delivered by the fake producer. */
+    uint32_t num_frames;
+    /** Surfaces in the ring. */
+    uint32_t num_buffers;
+    /** Buffers the fake downstream holds before releasing the oldest. */
+    uint32_t hold;
+    /** Time the fake downstream spends on each buffer, in microseconds. */
+    uint32_t work_usec;
+} ring_options;
+
+/**
+ * Fake producer backing the ring surfaces with system memory.
+ */
+typedef struct
+{
+    /** Bytes per surface. */
+    size_t size;
+    /** Index at which alloc fails, or -1. */
+    int fail_index;
+} fake_producer;
+
+/**
+ * @brief Streams frames through a ring from a producer to a downstream thread.
+ *
+ * The producer stamps each frame number over its surface, as copyToNvBuffer
+ * would write a frame. Downstream holds a few buffers like an encoder does
+ * and checks, before releasing each buffer, that its surface still holds
+ * the frame it was given.
+ *
+ * @param[in] options Sample options
+ * @param[out] table Result table the row of the run is added to
+ */
+static void stream_frames(const ring_options &options, UnitSampleTable &table);
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./preprocess_sample [-n <frames>] [-t <threads>]
+ * Example:
+ * ./preprocess_sample
+ * ./preprocess_sample -n 50 -t 4
+**/
+
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "preprocess_unit_sample.hpp"
+
+/**
+ * Fused inference preprocessing on the CPU.
+ *
+ * NvPreprocessCpu crops, scales, letterboxes, normalizes and converts an
+ * image into a tensor in one pass. This sample checks:
+ * ## Scaling to the same size copies the samples, with both filters
+ * ## Every element of odd sized tensors, upscaled and downscaled, matches a
+ *    per-pixel implementation written as the CUDA kernel, in all formats,
+ *    layouts, types and fitting modes, without writing past the tensor
+ * ## The SIMD and scalar paths, and one and several threads, are identical
+ * ## Letterboxing places the image and the padding as expected
+ * ## FP16 conversion rounds to nearest even, INT8 conversion rounds to
+ *    nearest even and saturates
+ * ## Invalid crops and pitches are rejected
+ *
+ * It then compares separate resize, letterbox and normalize passes with the
+ * fused pass, for a 1080p RGBA frame into a 640x640 FP32 NCHW tensor.
+**/
+
+#define DEFAULT_FRAMES 20
+#define BENCH_SRC_WIDTH 1920
+#define BENCH_SRC_HEIGHT 1080
+#define BENCH_DST_SIZE 640
+#define CANARY 0xa5
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static test_image
+make_image(uint32_t width, uint32_t height, NvPreprocessFormat format, uint32_t seed)
+{
+    test_image image;
+    uint32_t bpp = NvPreprocessBytesPerPixel(format);
+
+    image.width = width;
+    image.height = height;
+    image.pitch = width * bpp + 13;
+    image.format = format;
+    image.data.resize((size_t) image.pitch * height);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < image.pitch; x++)
+            image.data[(size_t) y * image.pitch + x] =
+                (uint8_t) ((x * 7 + y * 13 + seed * 29) ^ (x * y + seed));
+    }
+    return image;
+}
+
+static NvPreprocessParams
+make_params(const test_image &image, uint32_t dst_width, uint32_t dst_height)
+{
+    NvPreprocessParams params;
+
+    memset(&params, 0, sizeof(params));
+    params.src_width = image.width;
+    params.src_height = image.height;
+    params.src_pitch = image.pitch;
+    params.src_format = image.format;
+    params.dst_width = dst_width;
+    params.dst_height = dst_height;
+    params.resize = NV_PREPROCESS_RESIZE_STRETCH;
+    params.filter = NV_PREPROCESS_FILTER_BILINEAR;
+    params.layout = NV_PREPROCESS_LAYOUT_NCHW;
+    params.data_type = NV_PREPROCESS_TYPE_FP32;
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        params.mean[c] = 0.0f;
+        params.scale[c] = 1.0f;
+        params.pad[c] = 0;
+    }
+    return params;
+}
+
+static int
+reference_process(const NvPreprocessParams &params, const uint8_t *src, void *dst)
+{
+    NvPreprocessGeometry g;
+    uint32_t bpp = NvPreprocessBytesPerPixel(params.src_format);
+
+    if (NvPreprocessGetGeometry(&params, &g) < 0)
+        return -1;
+
+    for (uint32_t y = 0; y < params.dst_height; y++)
+    {
+        for (uint32_t x = 0; x < params.dst_width; x++)
+        {
+            uint32_t v[3];
+
+            if (x < g.left || x >= g.left + g.width || y < g.top || y >= g.top + g.height)
+            {
+                for (uint32_t c = 0; c < 3; c++)
+                    v[c] = params.pad[c];
+            }
+            else if (params.filter != NV_PREPROCESS_FILTER_BILINEAR)
+            {
+                uint32_t sx = g.crop_left + NvPreprocessMapNearest(x - g.left, g.width, g.crop_width);
+                uint32_t sy = g.crop_top + NvPreprocessMapNearest(y - g.top, g.height, g.crop_height);
+                const uint8_t *px = src + (size_t) sy * params.src_pitch + sx * bpp;
+
+                for (uint32_t c = 0; c < 3; c++)
+                    v[c] = px[NvPreprocessSourceChannel(params.src_format, params.dst_bgr, c)];
+            }
+            else
+            {
+                uint32_t x0, x1, wx, y0, y1, wy;
+
+                NvPreprocessMapLinear(x - g.left, g.width, g.crop_width, &x0, &x1, &wx);
+                NvPreprocessMapLinear(y - g.top, g.height, g.crop_height, &y0, &y1, &wy);
+                const uint8_t *row0 = src + (size_t) (g.crop_top + y0) * params.src_pitch + g.crop_left * bpp;
+                const uint8_t *row1 = src + (size_t) (g.crop_top + y1) * params.src_pitch + g.crop_left * bpp;
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    uint32_t sc = NvPreprocessSourceChannel(params.src_format, params.dst_bgr, c);
+                    uint32_t t0 = NvPreprocessLerpRows(row0[x0 * bpp + sc], row1[x0 * bpp + sc], wy);
+                    uint32_t t1 = NvPreprocessLerpRows(row0[x1 * bpp + sc], row1[x1 * bpp + sc], wy);
+
+                    v[c] = NvPreprocessLerpColumns(t0, t1, wx);
+                }
+            }
+
+            size_t pixel = (size_t) y * params.dst_width + x;
+            size_t plane = (size_t) params.dst_width * params.dst_height;
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                float value = NvPreprocessNormalize(v[c], params.mean[c], params.scale[c]);
+                size_t index = params.layout == NV_PREPROCESS_LAYOUT_NCHW ?
+                               c * plane + pixel : pixel * 3 + c;
+
+                if (params.data_type == NV_PREPROCESS_TYPE_FP32)
+                    ((float *) dst)[index] = value;
+                else if (params.data_type == NV_PREPROCESS_TYPE_FP16)
+                    ((uint16_t *) dst)[index] = NvPreprocessFloatToHalf(value);
+                else
+                    ((int8_t *) dst)[index] = NvPreprocessFloatToInt8(value);
+            }
+        }
+    }
+    return 0;
+}
+
+static size_t
+tensor_size(const NvPreprocessParams &params)
+{
+    return (size_t) params.dst_width * params.dst_height * 3 *
+        NvPreprocessElementSize(params.data_type);
+}
+
+/**
+ * Runs the CPU implementation into a tensor followed by canary bytes, and
+ * compares it with the per-pixel implementation.
+ */
+static bool
+matches_reference(NvPreprocessCpu &cpu, const NvPreprocessParams &params, const test_image &image)
+{
+    size_t size = tensor_size(params);
+    vector<uint8_t> out(size + 64, CANARY);
+    vector<uint8_t> ref(size, 0);
+
+    if (cpu.process(&params, &image.data[0], &out[0]) < 0 ||
+        reference_process(params, &image.data[0], &ref[0]) < 0)
+        return false;
+    for (size_t i = size; i < out.size(); i++)
+    {
+        if (out[i] != CANARY)
+            return false;
+    }
+    return memcmp(&out[0], &ref[0], size) == 0;
+}
+
+/**
+ * Separate passes, as resizing, letterboxing and convertIntToFloat() do:
+ * bilinear resize into an RGBA image, copy into the padded canvas, then
+ * normalize into planar FP32.
+ */
+static void
+separate_passes(const NvPreprocessParams &params, const uint8_t *src,
+                vector<uint8_t> &resized, vector<uint8_t> &canvas, float *dst)
+{
+    NvPreprocessGeometry g;
+    uint32_t w = params.dst_width;
+    uint32_t h = params.dst_height;
+
+    if (NvPreprocessGetGeometry(&params, &g) < 0)
+        return;
+    resized.resize((size_t) g.width * g.height * 4);
+    canvas.resize((size_t) w * h * 4);
+
+    for (uint32_t y = 0; y < g.height; y++)
+    {
+        uint32_t y0, y1, wy;
+
+        NvPreprocessMapLinear(y, g.height, g.crop_height, &y0, &y1, &wy);
+        for (uint32_t x = 0; x < g.width; x++)
+        {
+            uint32_t x0, x1, wx;
+
+            NvPreprocessMapLinear(x, g.width, g.crop_width, &x0, &x1, &wx);
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                const uint8_t *row0 = src + (size_t) (g.crop_top + y0) * params.src_pitch;
+                const uint8_t *row1 = src + (size_t) (g.crop_top + y1) * params.src_pitch;
+                uint32_t t0 = NvPreprocessLerpRows(row0[(g.crop_left + x0) * 4 + c],
+                                                   row1[(g.crop_left + x0) * 4 + c], wy);
+                uint32_t t1 = NvPreprocessLerpRows(row0[(g.crop_left + x1) * 4 + c],
+                                                   row1[(g.crop_left + x1) * 4 + c], wy);
+
+                resized[((size_t) y * g.width + x) * 4 + c] =
+                    (uint8_t) NvPreprocessLerpColumns(t0, t1, wx);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < (size_t) w * h; i++)
+    {
+        canvas[i * 4] = params.pad[0];
+        canvas[i * 4 + 1] = params.pad[1];
+        canvas[i * 4 + 2] = params.pad[2];
+        canvas[i * 4 + 3] = 0;
+    }
+    for (uint32_t y = 0; y < g.height; y++)
+        memcpy(&canvas[((size_t) (g.top + y) * w + g.left) * 4],
+               &resized[(size_t) y * g.width * 4], (size_t) g.width * 4);
+
+    for (size_t i = 0; i < (size_t) w * h; i++)
+    {
+        for (uint32_t c = 0; c < 3; c++)
+            dst[c * (size_t) w * h + i] =
+                NvPreprocessNormalize(canvas[i * 4 + c], params.mean[c], params.scale[c]);
+    }
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t frames = DEFAULT_FRAMES;
+    uint32_t threads = 0;
+    UnitSampleTable table(12);
+    UnitSampleArgs args("./preprocess_sample");
+    int opt;
+
+    args.option('n', "<frames>", "Frames of the benchmark", DEFAULT_FRAMES)
+        .option('t', "<threads>", "Threads of the multithreaded runs", "online CPUs");
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                frames = atoi(optarg);
+                break;
+            case 't':
+                threads = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (frames == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("ms/image", 12, 2);
+
+    NvPreprocessCpu single(1);
+    NvPreprocessCpu multi(threads);
+
+    /* Scaling to the same size copies the samples, with both filters */
+    {
+        bool ok = true;
+        test_image image = make_image(33, 17, NV_PREPROCESS_FORMAT_RGBA, 1);
+        NvPreprocessParams params = make_params(image, 33, 17);
+        vector<float> out(33 * 17 * 3);
+
+        for (uint32_t filter = 0; filter < 2 && ok; filter++)
+        {
+            params.filter = filter ? NV_PREPROCESS_FILTER_BILINEAR : NV_PREPROCESS_FILTER_NEAREST;
+            ok = single.process(&params, &image.data[0], &out[0]) == 0;
+            for (uint32_t y = 0; y < 17 && ok; y++)
+            {
+                for (uint32_t x = 0; x < 33 && ok; x++)
+                {
+                    for (uint32_t c = 0; c < 3; c++)
+                        ok = ok && out[c * 33 * 17 + y * 33 + x] ==
+                            (float) image.data[y * image.pitch + x * 4 + c];
+                }
+            }
+        }
+        table.row("identity", ok);
+    }
+
+    /* Every element matches the per-pixel implementation */
+    {
+        bool ok = true;
+        const uint32_t sizes[][4] = {
+            /* source width, height, tensor width, height */
+            { 37, 23, 13, 7 },
+            { 5, 3, 41, 29 },
+            { 64, 48, 64, 48 },
+            { 101, 67, 33, 95 },
+            { 1, 1, 7, 5 },
+        };
+
+        for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            for (uint32_t format = 0; format < 4; format++)
+            {
+                test_image image = make_image(sizes[s][0], sizes[s][1],
+                                              (NvPreprocessFormat) format, s + format);
+                NvPreprocessParams params = make_params(image, sizes[s][2], sizes[s][3]);
+
+                params.mean[0] = 123.675f;
+                params.mean[1] = 116.28f;
+                params.mean[2] = 103.53f;
+                params.scale[0] = 1.0f / 58.395f;
+                params.scale[1] = 1.0f / 57.12f;
+                params.scale[2] = 1.0f / 57.375f;
+                params.pad[0] = 114;
+                params.pad[1] = 115;
+                params.pad[2] = 116;
+                for (uint32_t mode = 0; mode < 48; mode++)
+                {
+                    params.filter = (NvPreprocessFilter) (mode & 1);
+                    params.layout = (NvPreprocessLayout) ((mode >> 1) & 1);
+                    params.dst_bgr = (mode >> 2) & 1;
+                    params.resize = (NvPreprocessResize) ((mode >> 3) % 3);
+                    params.data_type = (NvPreprocessDataType) (mode / 24 + (mode & 2 ? 1 : 0));
+                    ok = matches_reference(single, params, image) &&
+                        matches_reference(multi, params, image) && ok;
+                }
+                if (sizes[s][0] > 8)
+                {
+                    params.crop_left = 3;
+                    params.crop_top = 2;
+                    params.crop_width = sizes[s][0] - 5;
+                    params.crop_height = sizes[s][1] - 3;
+                    params.resize = NV_PREPROCESS_RESIZE_LETTERBOX_CENTER;
+                    ok = matches_reference(multi, params, image) && ok;
+                }
+            }
+        }
+        table.row("reference", ok);
+    }
+
+    /* The SIMD and scalar paths, one and several threads, are identical */
+    {
+        bool ok = true;
+        NvPreprocessCpu scalar(1);
+
+        scalar.setSimd(false);
+        for (uint32_t format = 0; format < 4; format++)
+        {
+            test_image image = make_image(317, 211, (NvPreprocessFormat) format, format);
+            NvPreprocessParams params = make_params(image, 160, 96);
+            vector<float> a(160 * 96 * 3);
+            vector<float> b(160 * 96 * 3);
+
+            params.crop_left = 7;
+            params.crop_top = 5;
+            params.crop_width = 300;
+            params.crop_height = 200;
+            ok = scalar.process(&params, &image.data[0], &a[0]) == 0 &&
+                multi.process(&params, &image.data[0], &b[0]) == 0 &&
+                memcmp(&a[0], &b[0], a.size() * sizeof(float)) == 0 && ok;
+        }
+        table.row("simd", ok);
+    }
+
+    /* Letterboxing places the image and the padding as expected */
+    {
+        bool ok = true;
+        test_image image = make_image(200, 100, NV_PREPROCESS_FORMAT_RGB, 3);
+        NvPreprocessParams params = make_params(image, 64, 64);
+        NvPreprocessGeometry g;
+        vector<float> out(64 * 64 * 3);
+
+        for (size_t i = 0; i < image.data.size(); i++)
+            image.data[i] = 200;
+        params.resize = NV_PREPROCESS_RESIZE_LETTERBOX_CENTER;
+        params.pad[0] = params.pad[1] = params.pad[2] = 10;
+        ok = NvPreprocessGetGeometry(&params, &g) == 0 &&
+            g.left == 0 && g.top == 16 && g.width == 64 && g.height == 32 &&
+            multi.process(&params, &image.data[0], &out[0]) == 0;
+        for (uint32_t y = 0; y < 64 && ok; y++)
+        {
+            float expected = (y < 16 || y >= 48) ? 10.0f : 200.0f;
+
+            for (uint32_t i = 0; i < 64 * 3; i++)
+                ok = ok && out[(i / 64) * 64 * 64 + y * 64 + i % 64] == expected;
+        }
+
+        params.resize = NV_PREPROCESS_RESIZE_LETTERBOX;
+        params.crop_width = 50;
+        params.crop_height = 100;
+        ok = ok && NvPreprocessGetGeometry(&params, &g) == 0 &&
+            g.left == 0 && g.top == 0 && g.width == 32 && g.height == 64 &&
+            multi.process(&params, &image.data[0], &out[0]) == 0 &&
+            out[5 * 64 + 31] == 200.0f && out[5 * 64 + 32] == 10.0f;
+        table.row("letterbox", ok);
+    }
+
+    /* FP16 and INT8 rounding */
+    {
+        bool ok = true;
+        const struct
+        {
+            float value;
+            uint16_t half;
+        } halves[] = {
+            { 1.0f, 0x3c00 }, { -2.0f, 0xc000 }, { 0.5f, 0x3800 },
+            { 65504.0f, 0x7bff }, { 65520.0f, 0x7c00 }, { 1.0f / 3.0f, 0x3555 },
+            { 1.0f + 1.0f / 2048.0f, 0x3c00 }, { 1.0f + 3.0f / 2048.0f, 0x3c02 },
+            { 5.9604645e-8f, 0x0001 }, { 2.9802322e-8f, 0x0000 },
+            { 8.940697e-8f, 0x0002 }, { 6.097555e-5f, 0x03ff }, { 0.0f, 0x0000 },
+        };
+        const struct
+        {
+            float value;
+            int8_t quantized;
+        } int8s[] = {
+            { 2.5f, 2 }, { 3.5f, 4 }, { -2.5f, -2 }, { -0.4f, 0 },
+            { 127.6f, 127 }, { -200.0f, -128 }, { 1000.0f, 127 },
+        };
+
+        for (size_t i = 0; i < sizeof(halves) / sizeof(halves[0]); i++)
+            ok = ok && NvPreprocessFloatToHalf(halves[i].value) == halves[i].half;
+        for (size_t i = 0; i < sizeof(int8s) / sizeof(int8s[0]); i++)
+            ok = ok && NvPreprocessFloatToInt8(int8s[i].value) == int8s[i].quantized;
+        table.row("convert", ok);
+    }
+
+    /* Invalid crops and pitches are rejected */
+    {
+        bool ok = true;
+        test_image image = make_image(64, 64, NV_PREPROCESS_FORMAT_RGBA, 0);
+        NvPreprocessParams params = make_params(image, 32, 32);
+        vector<float> out(32 * 32 * 3);
+
+        params.crop_left = 40;
+        params.crop_width = 32;
+        params.crop_height = 32;
+        ok = multi.process(&params, &image.data[0], &out[0]) < 0;
+        params = make_params(image, 32, 32);
+        params.src_pitch = 64 * 4 - 1;
+        ok = multi.process(&params, &image.data[0], &out[0]) < 0 && ok;
+        params = make_params(image, 0, 32);
+        ok = multi.process(&params, &image.data[0], &out[0]) < 0 && ok;
+        table.row("invalid", ok);
+    }
+
+    /* Separate passes against the fused pass */
+    {
+        test_image image = make_image(BENCH_SRC_WIDTH, BENCH_SRC_HEIGHT, NV_PREPROCESS_FORMAT_RGBA, 5);
+        NvPreprocessParams params = make_params(image, BENCH_DST_SIZE, BENCH_DST_SIZE);
+        vector<float> reference(BENCH_DST_SIZE * BENCH_DST_SIZE * 3);
+        vector<float> out(reference.size());
+        vector<uint8_t> resized;
+        vector<uint8_t> canvas;
+        NvPreprocessCpu scalar(1);
+        NvPreprocessCpu *runs[] = { &scalar, &single, &multi };
+        const char *names[] = { "fused-1", "simd-1", "simd-N" };
+        uint64_t start;
+
+        params.resize = NV_PREPROCESS_RESIZE_LETTERBOX_CENTER;
+        params.pad[0] = params.pad[1] = params.pad[2] = 114;
+        for (uint32_t c = 0; c < 3; c++)
+            params.scale[c] = 1.0f / 255.0f;
+        scalar.setSimd(false);
+
+        start = get_time_usec();
+        for (uint32_t i = 0; i < frames; i++)
+            separate_passes(params, &image.data[0], resized, canvas, &reference[0]);
+        table.row("separate", true) << (get_time_usec() - start) / 1000.0 / frames;
+
+        for (uint32_t r = 0; r < 3; r++)
+        {
+            bool ok = true;
+
+            start = get_time_usec();
+            for (uint32_t i = 0; i < frames; i++)
+                ok = runs[r]->process(&params, &image.data[0], &out[0]) == 0 && ok;
+            double msec_per_image = (get_time_usec() - start) / 1000.0 / frames;
+
+            ok = ok && memcmp(&out[0], &reference[0], out.size() * sizeof(float)) == 0;
+            table.row(names[r], ok) << msec_per_image;
+        }
+    }
+
+    cout << "Frames " << frames << ", " << BENCH_SRC_WIDTH << "x" << BENCH_SRC_HEIGHT <<
+        " RGBA to " << BENCH_DST_SIZE << "x" << BENCH_DST_SIZE << " FP32 NCHW, " <<
+        multi.getNumThreads() << " threads for simd-N" << endl;
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvPreprocess.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds a source image.
+ */
+typedef struct
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;
+    NvPreprocessFormat format;
+    std::vector<uint8_t> data;
+} test_image;
+
+/**
+ * @brief Creates a source image filled with a pattern depending on the
+ *        position, with a pitch larger than the visible row.
+ *
+ * @param[in] width Width of the image
+ * @param[in] height Height of the image
+ * @param[in] format Pixel format
+ * @param[in] seed Value mixed into the pattern
+ * @return The image
+ */
+static test_image
+make_image(uint32_t width, uint32_t height, NvPreprocessFormat format, uint32_t seed);
+
+/**
+ * @brief Builds parameters processing the whole image into a tensor.
+ *
+ * @param[in] image Source image
+ * @param[in] dst_width Width of the tensor
+ * @param[in] dst_height Height of the tensor
+ * @return The parameters
+ */
+static NvPreprocessParams
+make_params(const test_image &image, uint32_t dst_width, uint32_t dst_height);
+
+/**
+ * @brief Preprocesses one image pixel by pixel, as the CUDA kernel does.
+ *
+ * @param[in] params Parameters of the pass
+ * @param[in] src Source image
+ * @param[out] dst Tensor
+ * @return 0 on success, -1 if the parameters are invalid
+ */
+static int
+reference_process(const NvPreprocessParams &params, const uint8_t *src, void *dst);
@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./raw_frame_sink_sample [-d dir] [-b [width] [height] [frames] [-a]]
+ * Example:
+ * ./raw_frame_sink_sample
+ * ./raw_frame_sink_sample -d /data -b 3840 2160 200
+**/
+
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "raw_frame_sink_unit_sample.hpp"
+
+/**
+ * Raw frame dumps with NvRawFrameSink.
+ *
+ * The decoder sample writes its output through NvRawFrameSink: each buffer
+ * is mapped once and kept mapped, and all the rows of a frame go out in a
+ * single vectored write, or through an aligned staging buffer with
+ * O_DIRECT.
+ *
+ * This sample checks the sink on synthetic NV12 buffers held in memfds or
+ * anonymous memory, without NvBufSurface:
+ * ## The output is byte identical to writing the rows through a stream.
+ * ## Each buffer is mapped once, and again after forget().
+ * ## A frame without pitch padding is written with a single call.
+ * ## Direct I/O, or its buffered fallback, gives the same output.
+ *
+ * With -b it compares the throughput of the three write paths.
+**/
+
+#define CHECK(cond, msg) if (!(cond)) { \
+                             cerr << "FAILED: " << msg << endl; \
+                             return -1; }
+
+/* Buffers and frames of the checks */
+#define CHECK_BUFFERS 3
+#define CHECK_FRAMES 12
+
+static size_t
+page_align(size_t size)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+
+    return (size + page - 1) / page * page;
+}
+
+static test_buffer *
+find_buffer(test_memory &memory, int id)
+{
+    for (size_t i = 0; i < memory.buffers.size(); i++)
+        if (memory.buffers[i].id == id)
+            return &memory.buffers[i];
+    return NULL;
+}
+
+static int
+alloc_buffer(test_memory &memory, uint32_t width, uint32_t height,
+             uint32_t pitch, bool use_memfd)
+{
+    test_buffer buffer;
+
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.id = 1000 + memory.buffers.size();
+    buffer.memfd = -1;
+    buffer.num_planes = 2;
+    buffer.row_bytes[0] = width;
+    buffer.height[0] = height;
+    buffer.row_bytes[1] = width;
+    buffer.height[1] = height / 2;
+    for (uint32_t i = 0; i < buffer.num_planes; i++)
+    {
+        buffer.pitch[i] = pitch;
+        buffer.offset[i] = buffer.size;
+        buffer.size += page_align((size_t) pitch * buffer.height[i]);
+    }
+
+    if (use_memfd)
+    {
+        buffer.memfd = memfd_create("raw_frame_sink_sample", 0);
+        if (buffer.memfd < 0 || ftruncate(buffer.memfd, buffer.size) < 0)
+        {
+            cerr << "Could not create memfd: " << strerror(errno) << endl;
+            return -1;
+        }
+    }
+    else
+    {
+        void *base = mmap(NULL, buffer.size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            cerr << "Could not allocate buffer: " << strerror(errno) << endl;
+            return -1;
+        }
+        buffer.base = (uint8_t *) base;
+    }
+
+    memory.buffers.push_back(buffer);
+    return buffer.id;
+}
+
+static void
+free_buffers(test_memory &memory)
+{
+    for (size_t i = 0; i < memory.buffers.size(); i++)
+    {
+        if (memory.buffers[i].memfd >= 0)
+            close(memory.buffers[i].memfd);
+        else
+            munmap(memory.buffers[i].base, memory.buffers[i].size);
+    }
+    memory.buffers.clear();
+}
+
+static uint8_t *
+map_range(const test_buffer &buffer, size_t offset, size_t size)
+{
+    void *data;
+
+    if (buffer.memfd < 0)
+        return buffer.base + offset;
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, buffer.memfd, offset);
+    return data == MAP_FAILED ? NULL : (uint8_t *) data;
+}
+
+static void
+unmap_range(const test_buffer &buffer, uint8_t *data, size_t size)
+{
+    if (buffer.memfd >= 0)
+        munmap(data, size);
+}
+
+/* Fills the visible region with a pattern depending on the frame index,
+ * and the padding with garbage that must not reach the file. */
+static int
+fill_buffer(test_buffer &buffer, uint32_t index)
+{
+    uint8_t *data = map_range(buffer, 0, buffer.size);
+
+    if (data == NULL)
+        return -1;
+    for (uint32_t i = 0; i < buffer.num_planes; i++)
+    {
+        for (uint32_t y = 0; y < buffer.height[i]; y++)
+        {
+            uint8_t *row = data + buffer.offset[i] + (size_t) y * buffer.pitch[i];
+            for (uint32_t x = 0; x < buffer.row_bytes[i]; x++)
+                row[x] = (uint8_t) (x * 3 + y * 7 + index * 13 + i);
+            for (uint32_t x = buffer.row_bytes[i]; x < buffer.pitch[i]; x++)
+                row[x] = (uint8_t) rand();
+        }
+    }
+    unmap_range(buffer, data, buffer.size);
+    return 0;
+}
+
+static int
+memory_map(int fd, NvRawFrameMapping *mapping, void *arg)
+{
+    test_memory *memory = (test_memory *) arg;
+    test_buffer *buffer = find_buffer(*memory, fd);
+    uint8_t *data;
+
+    if (buffer == NULL || (data = map_range(*buffer, 0, buffer->size)) == NULL)
+        return -1;
+
+    mapping->num_planes = buffer->num_planes;
+    for (uint32_t i = 0; i < buffer->num_planes; i++)
+    {
+        mapping->planes[i] = data + buffer->offset[i];
+        mapping->row_bytes[i] = buffer->row_bytes[i];
+        mapping->height[i] = buffer->height[i];
+        mapping->pitch[i] = buffer->pitch[i];
+    }
+    mapping->handle = buffer;
+    memory->num_maps++;
+    return 0;
+}
+
+static void
+memory_unmap(NvRawFrameMapping *mapping, void *arg)
+{
+    test_memory *memory = (test_memory *) arg;
+    test_buffer *buffer = (test_buffer *) mapping->handle;
+
+    unmap_range(*buffer, mapping->planes[0] - buffer->offset[0], buffer->size);
+    memory->num_unmaps++;
+}
+
+static NvRawFrameSinkOps
+memory_ops(test_memory &memory)
+{
+    NvRawFrameSinkOps ops;
+
+    /* System memory is coherent, there is nothing to sync */
+    ops.map = memory_map;
+    ops.sync = NULL;
+    ops.unmap = memory_unmap;
+    ops.arg = &memory;
+    return ops;
+}
+
+static int
+write_frame_rows(const test_buffer &buffer, ofstream &stream)
+{
+    for (uint32_t i = 0; i < buffer.num_planes; i++)
+    {
+        size_t size = (size_t) buffer.pitch[i] * buffer.height[i];
+        uint8_t *data = map_range(buffer, buffer.offset[i], size);
+
+        if (data == NULL)
+            return -1;
+        for (uint32_t y = 0; y < buffer.height[i]; y++)
+        {
+            stream.write((char *) data + (size_t) y * buffer.pitch[i], buffer.row_bytes[i]);
+            if (!stream.good())
+                break;
+        }
+        unmap_range(buffer, data, size);
+        if (!stream.good())
+            return -1;
+    }
+    return 0;
+}
+
+static bool
+same_files(const char *path_a, const char *path_b)
+{
+    ifstream a(path_a, ios::binary);
+    ifstream b(path_b, ios::binary);
+    vector<char> buf_a(1 << 16), buf_b(1 << 16);
+
+    if (!a.is_open() || !b.is_open())
+        return false;
+    while (a && b)
+    {
+        a.read(&buf_a[0], buf_a.size());
+        b.read(&buf_b[0], buf_b.size());
+        if (a.gcount() != b.gcount() ||
+            memcmp(&buf_a[0], &buf_b[0], a.gcount()))
+            return false;
+    }
+    return a.eof() && b.eof();
+}
+
+static int
+write_reference(test_memory &memory, int *ids, const string &ref_path)
+{
+    ofstream ref;
+
+    for (uint32_t i = 0; i < CHECK_BUFFERS; i++)
+    {
+        /* Odd sizes, so that frames do not end on a block boundary */
+        ids[i] = alloc_buffer(memory, 722, 406, 768, i != 1);
+        CHECK(ids[i] >= 0, "could not allocate buffers");
+    }
+
+    ref.open(ref_path.c_str(), ios::binary);
+    CHECK(ref.is_open(), "could not create " << ref_path);
+    for (uint32_t i = 0; i < CHECK_FRAMES; i++)
+    {
+        test_buffer *buffer = find_buffer(memory, ids[i % CHECK_BUFFERS]);
+        CHECK(fill_buffer(*buffer, i) == 0, "could not fill buffer");
+        CHECK(write_frame_rows(*buffer, ref) == 0, "could not write reference");
+    }
+    return 0;
+}
+
+static int
+check_sink(test_memory &memory, const int *ids, const char *dir,
+           const string &ref_path, const string &out_path, bool direct)
+{
+    NvRawFrameSink sink(memory_ops(memory));
+    NvRawFrameSinkStats stats;
+
+    memory.num_maps = 0;
+    memory.num_unmaps = 0;
+    CHECK(sink.open(out_path.c_str(), direct) == 0, "open " << out_path);
+    for (uint32_t i = 0; i < CHECK_FRAMES; i++)
+    {
+        test_buffer *buffer = find_buffer(memory, ids[i % CHECK_BUFFERS]);
+        CHECK(fill_buffer(*buffer, i) == 0, "could not fill buffer");
+        CHECK(sink.writeFrame(buffer->id) == 0, "write frame " << i);
+        if (i == CHECK_FRAMES / 2)
+            sink.forget(buffer->id);
+    }
+    sink.getStats(&stats);
+    CHECK(stats.num_frames == CHECK_FRAMES, "frame count");
+    CHECK(stats.num_maps == CHECK_BUFFERS + 1, "buffers mapped " <<
+          stats.num_maps << " times instead of " << CHECK_BUFFERS + 1);
+    if (!direct)
+        CHECK(stats.num_writes == CHECK_FRAMES, "one write per frame, got " <<
+              stats.num_writes);
+    if (direct)
+        cout << "Direct I/O " << (sink.isDirect() ? "in use" : "not supported") <<
+            " in " << dir << endl;
+    CHECK(sink.close() == 0, "close sink");
+    CHECK(memory.num_maps == memory.num_unmaps, "mappings left after close");
+    CHECK(same_files(ref_path.c_str(), out_path.c_str()),
+          (direct ? "direct" : "vectored") << " output differs from the reference");
+    return 0;
+}
+
+static int
+check_packed(test_memory &memory, const string &out_path)
+{
+    NvRawFrameSink sink(memory_ops(memory));
+    NvRawFrameSinkStats stats;
+    int packed;
+
+    /* Without padding, all the rows and planes merge into one entry */
+    packed = alloc_buffer(memory, 1024, 64, 1024, true);
+    CHECK(packed >= 0, "could not allocate buffers");
+    CHECK(sink.open(out_path.c_str()) == 0, "open " << out_path);
+    CHECK(sink.writeFrame(packed) == 0, "write packed frame");
+    CHECK(sink.writeFrame(12345) == -1, "unknown buffer accepted");
+    sink.getStats(&stats);
+    CHECK(stats.num_writes == 1 && stats.num_bytes == 1024 * 64 * 3 / 2,
+          "packed frame written with " << stats.num_writes << " calls");
+    CHECK(sink.close() == 0, "close sink");
+    return 0;
+}
+
+static void
+run_checks(const char *dir, UnitSampleTable &table)
+{
+    string ref_path = string(dir) + "/raw_frame_sink_ref.yuv";
+    string out_path = string(dir) + "/raw_frame_sink_out.yuv";
+    test_memory memory;
+    int ids[CHECK_BUFFERS];
+    bool reference;
+
+    memory.num_maps = 0;
+    memory.num_unmaps = 0;
+    reference = write_reference(memory, ids, ref_path) == 0;
+    table.row("reference", reference);
+    /* The sink output is compared against the reference */
+    if (reference)
+    {
+        table.row("vectored", check_sink(memory, ids, dir, ref_path, out_path, false) == 0);
+        table.row("direct", check_sink(memory, ids, dir, ref_path, out_path, true) == 0);
+    }
+    else
+    {
+        table.skip("vectored");
+        table.skip("direct");
+    }
+    table.row("packed", check_packed(memory, out_path) == 0);
+
+    unlink(ref_path.c_str());
+    unlink(out_path.c_str());
+    free_buffers(memory);
+}
+
+static double
+elapsed_sec(const struct timespec &start)
+{
+    struct timespec stop;
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    return (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static void
+print_result(const char *name, double sec, uint32_t frames, double bytes)
+{
+    cout << "  " << name << ": " << sec * 1000 / frames << " ms/frame, " <<
+        bytes / sec / 1e6 << " MB/s" << endl;
+}
+
+static void
+run_benchmark(const char *dir, uint32_t width, uint32_t height,
+              uint32_t frames, bool use_memfd)
+{
+    const uint32_t num_buffers = 4;
+    string path = string(dir) + "/raw_frame_sink_bench.yuv";
+    test_memory memory;
+    struct timespec start;
+    double bytes = (double) width * (height / 2 * 3) * frames;
+    int ids[num_buffers];
+
+    memory.num_maps = 0;
+    memory.num_unmaps = 0;
+    for (uint32_t i = 0; i < num_buffers; i++)
+    {
+        ids[i] = alloc_buffer(memory, width, height, (width + 255) & ~255, use_memfd);
+        if (ids[i] < 0 || fill_buffer(*find_buffer(memory, ids[i]), i))
+            return;
+    }
+
+    cout << "Writing " << frames << " NV12 " << width << "x" << height <<
+        " frames from " << (use_memfd ? "memfd" : "anonymous") <<
+        " buffers to " << dir << endl;
+
+    {
+        ofstream stream(path.c_str(), ios::binary);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < frames; i++)
+            write_frame_rows(*find_buffer(memory, ids[i % num_buffers]), stream);
+        stream.close();
+        print_result("rows, map per plane", elapsed_sec(start), frames, bytes);
+    }
+
+    for (uint32_t pass = 0; pass < 2; pass++)
+    {
+        NvRawFrameSink sink(memory_ops(memory));
+        bool direct;
+
+        if (sink.open(path.c_str(), pass == 1))
+            break;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < frames; i++)
+            sink.writeFrame(ids[i % num_buffers]);
+        direct = sink.isDirect();
+        sink.close();
+        print_result(pass == 0 ? "sink, vectored" :
+                     direct ? "sink, direct I/O" : "sink, direct I/O fallback",
+                     elapsed_sec(start), frames, bytes);
+    }
+
+    unlink(path.c_str());
+    free_buffers(memory);
+}
+
+int
+main(int argc, char const *argv[])
+{
+    const char *dir = "/tmp";
+    uint32_t width = 1920, height = 1080, frames = 300;
+    bool use_memfd = true;
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./raw_frame_sink_sample");
+    int arg = 1;
+
+    args.usage("[-d dir]", "Run the checks")
+        .usage("[-d dir] -b [width] [height] [frames] [-a]",
+               "Measure write throughput [Default = 1920 1080 300]")
+        .option('d', "<dir>", "Directory of the temporary files", dir)
+        .option('a', NULL, "Use anonymous memory instead of memfd buffers");
+
+    if (argc >= 3 && !strcmp(argv[1], "-d"))
+    {
+        dir = argv[2];
+        arg = 3;
+    }
+    if (arg == argc)
+    {
+        run_checks(dir, table);
+        return table.print() ? 0 : -1;
+    }
+
+    if (strcmp(argv[arg], "-b"))
+    {
+        args.printHelp();
+        return strcmp(argv[arg], "-h") && strcmp(argv[arg], "--help") ? -1 : 0;
+    }
+    if (argc > arg + 1 && !strcmp(argv[argc - 1], "-a"))
+    {
+        use_memfd = false;
+        argc--;
+    }
+    if (argc > arg + 1)
+        width = atoi(argv[arg + 1]);
+    if (argc > arg + 2)
+        height = atoi(argv[arg + 2]);
+    if (argc > arg + 3)
+        frames = atoi(argv[arg + 3]);
+    if (width == 0 || height == 0 || frames == 0)
+    {
+        cerr << "Width, height and frames should be positive integers" << endl;
+        return -1;
+    }
+
+    run_benchmark(dir, width, height, frames, use_memfd);
+    return 0;
+}
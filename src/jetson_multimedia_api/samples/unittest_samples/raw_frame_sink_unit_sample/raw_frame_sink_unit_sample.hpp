@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "NvRawFrameSink.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds a synthetic NV12 buffer in system memory.
+ */
+typedef struct
+{
+    /** Identifier of the buffer, used as its FD by the sink. */
+    int id;
+    /** memfd holding the buffer, or -1 for anonymous memory. */
+    int memfd;
+    /** Anonymous memory of the buffer, or NULL for a memfd. */
+    uint8_t *base;
+    /** Size of the buffer in bytes. */
+    size_t size;
+    /** Number of planes. */
+    uint32_t num_planes;
+    /** Offset of each plane, page aligned. */
+    size_t offset[2];
+    /** Visible bytes per row of each plane. */
+    uint32_t row_bytes[2];
+    /** Number of rows of each plane. */
+    uint32_t height[2];
+    /** Bytes between the starts of two rows of each plane. */
+    uint32_t pitch[2];
+} test_buffer;
+
+/**
+ * Holds the buffers known to the memory mapping calls.
+ */
+typedef struct
+{
+    /** Buffers, looked up by id. */
+    std::vector<test_buffer> buffers;
+    /** Number of map calls. */
+    uint32_t num_maps;
+    /** Number of unmap calls. */
+    uint32_t num_unmaps;
+} test_memory;
+
+/**
+ * @brief Allocates a synthetic NV12 buffer with padded rows.
+ *
+ * @param[in] memory Buffers to add the new one to
+ * @param[in] width Width of the frame in pixels
+ * @param[in] height Height of the frame in pixels
+ * @param[in] pitch Row pitch in bytes, at least @a width
+ * @param[in] use_memfd True to back the buffer with a memfd
+ * @return Identifier of the buffer, -1 on failure
+ */
+static int
+alloc_buffer(test_memory &memory, uint32_t width, uint32_t height,
+             uint32_t pitch, bool use_memfd);
+
+/**
+ * @brief Gets the mapping calls of NvRawFrameSink for the synthetic buffers.
+ *
+ * memfd buffers are mapped with mmap() on every map call, anonymous
+ * buffers are returned as they are.
+ *
+ * @param[in] memory Buffers
+ * @return Mapping calls
+ */
+static NvRawFrameSinkOps
+memory_ops(test_memory &memory);
+
+/**
+ * @brief Writes a frame the way the decoder sample used to: maps each
+ * plane, writes it row by row through a stream, and unmaps it.
+ *
+ * @param[in] buffer Buffer to write
+ * @param[in] stream Output stream
+ * @return 0 for success, -1 otherwise
+ */
+static int
+write_frame_rows(const test_buffer &buffer, std::ofstream &stream);
+
+/**
+ * @brief Allocates the buffers of the checks and writes their frames row by
+ * row as the reference output.
+ *
+ * @param[in] memory Buffers to add the new ones to
+ * @param[out] ids IDs of the CHECK_BUFFERS new buffers
+ * @param[in] ref_path Reference file
+ * @return 0 on success, -1 otherwise
+ */
+static int
+write_reference(test_memory &memory, int *ids, const std::string &ref_path);
+
+/**
+ * @brief Checks that NvRawFrameSink maps each buffer once and writes the
+ * same output as the reference.
+ *
+ * @param[in] memory Buffers of the checks
+ * @param[in] ids IDs of the buffers written by write_reference()
+ * @param[in] dir Directory of the temporary files
+ * @param[in] ref_path Reference file
+ * @param[in] out_path Output file
+ * @param[in] direct Whether to open the sink for direct I/O
+ * @return 0 if all checks pass, -1 otherwise
+ */
+static int
+check_sink(test_memory &memory, const int *ids, const char *dir,
+           const std::string &ref_path, const std::string &out_path, bool direct);
+
+/**
+ * @brief Checks that a frame without pitch padding is written with a single
+ * call.
+ *
+ * @param[in] memory Buffers to add the packed one to
+ * @param[in] out_path Output file
+ * @return 0 if all checks pass, -1 otherwise
+ */
+static int
+check_packed(test_memory &memory, const std::string &out_path);
+
+/**
+ * @brief Runs the functional checks of NvRawFrameSink.
+ *
+ * @param[in] dir Directory of the temporary files
+ * @param[in] table Table to add the results to
+ */
+static void
+run_checks(const char *dir, UnitSampleTable &table);
+
+/**
+ * @brief Measures the write throughput of the row by row path and of
+ * NvRawFrameSink with buffered and direct I/O.
+ *
+ * @param[in] dir Directory of the output files
+ * @param[in] width Width of the frames in pixels
+ * @param[in] height Height of the frames in pixels
+ * @param[in] frames Number of frames written
+ * @param[in] use_memfd True for memfd buffers, false for anonymous memory
+ */
+static void
+run_benchmark(const char *dir, uint32_t width, uint32_t height,
+              uint32_t frames, bool use_memfd);
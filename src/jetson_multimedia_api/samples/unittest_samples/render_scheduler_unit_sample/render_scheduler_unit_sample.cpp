@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./render_scheduler_sample [-d <seconds>]
+ * Example:
+ * ./render_scheduler_sample
+ * ./render_scheduler_sample -d 20
+**/
+
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#include "ConditionVariable.h"
+#include "Mutex.h"
+#include "render_scheduler_unit_sample.hpp"
+
+/**
+ * Render scheduling of the camera app composer.
+ *
+ * RenderScheduler decides when the composer latches the stream frames and
+ * renders. This sample drives it like the composer thread does, with
+ * simulated producer streams and a simulated display in simulated time,
+ * and checks:
+ * ## The vsync period is learned from the swaps when the nominal period is
+ *    wrong, and the swaps stay on the vsync grid
+ * ## Frames are shown at the first vsync whose latch point they arrived
+ *    before
+ * ## Frames of several streams arriving within a vsync are coalesced into
+ *    one render, and no more than one render happens per vsync
+ * ## With latest frame wins the newest frame is shown and the others are
+ *    skipped, without it a faster producer queues up and the shown frames
+ *    lag behind
+ * ## Without producer signals the streams are checked once per vsync
+ * ## Without streams the composer sleeps until woken up
+ *
+ * It also checks that a timed wait of the condition variable, which paces
+ * the composer, times out after the timeout on the monotonic clock.
+**/
+
+using namespace ArgusSamples;
+
+#define DEFAULT_SECONDS 10
+#define MSEC 1000000ull
+#define USEC 1000ull
+/* Simulated time starts here, zero is not a valid time for the scheduler */
+#define START_NSEC (1000 * MSEC)
+/* Frames shown or latched before this are not checked */
+#define WARMUP_NSEC (1000 * MSEC)
+/* Capture latency reported with the producer signals */
+#define CAPTURE_LATENCY (20 * MSEC)
+#define REFRESH_PERIOD 16666667ull
+#define LATCH_MARGIN (3 * MSEC)
+/* Time the composer takes to acquire the stream frames */
+#define ACQUIRE_NSEC (50 * USEC)
+/* A frame arriving this close before the latch point may miss it */
+#define LATCH_TOLERANCE (500 * USEC)
+
+static sim_stream
+make_stream(uint64_t period, uint64_t phase, bool signalled, bool latest)
+{
+    sim_stream stream;
+
+    stream.period = period;
+    stream.phase = phase;
+    stream.signalled = signalled;
+    stream.latest = latest;
+    stream.next = 0;
+    stream.skipped = 0;
+
+    return stream;
+}
+
+static uint64_t
+vsync_time(const sim_display &display, uint64_t vsync)
+{
+    return START_NSEC + display.phase + vsync * display.period;
+}
+
+static uint64_t
+arrival_time(const sim_stream &stream, uint64_t frame)
+{
+    return START_NSEC + stream.phase + frame * stream.period;
+}
+
+static bool
+next_arrival(const vector<sim_stream> &streams, uint64_t &time, uint32_t &index)
+{
+    bool found = false;
+
+    for (uint32_t i = 0; i < streams.size(); i++)
+    {
+        const uint64_t arrival = arrival_time(streams[i], streams[i].next);
+        if (!found || arrival < time)
+        {
+            time = arrival;
+            index = i;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Queues the next arriving frame and signals it.
+ * Returns true if the producer signalled the frame.
+ */
+static bool
+deliver_next(RenderScheduler &scheduler, vector<sim_stream> &streams, uint32_t index)
+{
+    sim_stream &stream = streams[index];
+    const uint64_t arrival = arrival_time(stream, stream.next);
+
+    stream.queue.push_back(stream.next++);
+    if (stream.signalled)
+        scheduler.onFrameSignalled(TimeValue::fromNSec(arrival),
+                                   TimeValue::fromNSec(CAPTURE_LATENCY));
+
+    return stream.signalled;
+}
+
+/**
+ * Delivers all frames arriving up to a time, e.g. while rendering.
+ */
+static void
+deliver_until(RenderScheduler &scheduler, vector<sim_stream> &streams, uint64_t time)
+{
+    uint64_t arrival;
+    uint32_t index;
+
+    while (next_arrival(streams, arrival, index) && (arrival <= time))
+        deliver_next(scheduler, streams, index);
+}
+
+/**
+ * Waits like Composer::waitForWork() until the wakeup time or a signal.
+ * Returns false if the end of the simulation was reached.
+ */
+static bool
+wait_for_work(RenderScheduler &scheduler, vector<sim_stream> &streams, uint64_t &now,
+              uint64_t end)
+{
+    for (;;)
+    {
+        const TimeValue wakeupTime = scheduler.getWakeupTime(TimeValue::fromNSec(now),
+            static_cast<uint32_t>(streams.size()));
+        const uint64_t wakeup = (wakeupTime == TimeValue::infinite()) ?
+            end : wakeupTime.toNSec();
+
+        if (wakeup <= now)
+            return true;
+
+        // frames arriving before the wakeup time, a signal wakes the composer up early
+        bool signalled = false;
+        uint64_t arrival;
+        uint32_t index;
+        while (!signalled && next_arrival(streams, arrival, index) && (arrival < wakeup))
+        {
+            signalled = deliver_next(scheduler, streams, index);
+            now = arrival;
+        }
+        if (!signalled)
+            now = wakeup;
+        if (now >= end)
+            return false;
+        if (!signalled)
+            return true;
+    }
+}
+
+static void
+simulate(RenderScheduler &scheduler, sim_display &display, vector<sim_stream> &streams,
+         uint64_t warmup, uint64_t duration, vector<shown_frame> &shown, sim_result &result)
+{
+    const uint64_t end = START_NSEC + duration;
+    uint64_t now = START_NSEC;
+    uint64_t first_vsync = 0;
+    uint64_t last_vsync = 0;
+    bool warm = false;
+
+    scheduler.reset();
+    scheduler.setLatchMargin(TimeValue::fromNSec(LATCH_MARGIN));
+
+    while (wait_for_work(scheduler, streams, now, end))
+    {
+        // restart the statistics at a latch so that they cover whole frames
+        if (!warm && (now >= START_NSEC + warmup))
+        {
+            scheduler.getStats();
+            first_vsync = (now - START_NSEC - display.phase) / display.period + 1;
+            warm = true;
+        }
+
+        // acquire like StreamConsumer::acquire()
+        vector<shown_frame> latched;
+        for (uint32_t i = 0; i < streams.size(); i++)
+        {
+            sim_stream &stream = streams[i];
+            if (stream.queue.empty())
+                continue;
+
+            shown_frame frame;
+            frame.stream = i;
+            frame.frame = stream.queue.front();
+            frame.newest = stream.next - 1;
+            stream.queue.pop_front();
+            while (stream.latest && !stream.queue.empty())
+            {
+                frame.frame = stream.queue.front();
+                stream.queue.pop_front();
+                stream.skipped++;
+            }
+            frame.arrival = arrival_time(stream, frame.frame);
+            latched.push_back(frame);
+        }
+        deliver_until(scheduler, streams, now + ACQUIRE_NSEC);
+        now += ACQUIRE_NSEC;
+
+        if (!scheduler.onLatch(TimeValue::fromNSec(now), static_cast<uint32_t>(latched.size())))
+            continue;
+
+        // render, the swap returns at the first vsync after rendering finished
+        const uint64_t done = now + display.render;
+        uint64_t vsync = 0;
+        if (done > vsync_time(display, 0))
+            vsync = (done - vsync_time(display, 0) + display.period - 1) / display.period;
+        display.seed = display.seed * 1103515245 + 12345;
+        const uint64_t swap = vsync_time(display, vsync) +
+            (display.seed >> 8) % (display.jitter + 1);
+
+        deliver_until(scheduler, streams, swap);
+        now = swap;
+        scheduler.onSwap(TimeValue::fromNSec(swap));
+
+        if (warm)
+        {
+            for (size_t i = 0; i < latched.size(); i++)
+            {
+                latched[i].vsync = vsync;
+                shown.push_back(latched[i]);
+            }
+            last_vsync = vsync;
+        }
+    }
+
+    result.stats = scheduler.getStats();
+    result.vsyncs = warm ? last_vsync - first_vsync + 1 : 0;
+    result.shown = shown.size();
+}
+
+static uint64_t
+count_late(const sim_display &display, const vector<shown_frame> &shown, uint64_t margin,
+           uint64_t tolerance)
+{
+    uint64_t late = 0;
+
+    for (size_t i = 0; i < shown.size(); i++)
+    {
+        // the first vsync whose latch point is at or after the arrival
+        const uint64_t latch = shown[i].arrival + margin;
+        uint64_t ideal = 0;
+        if (latch > vsync_time(display, 0))
+            ideal = (latch - vsync_time(display, 0) + display.period - 1) / display.period;
+
+        if (shown[i].vsync <= ideal)
+            continue;
+        if ((shown[i].vsync == ideal + 1) &&
+            (vsync_time(display, ideal) - margin - shown[i].arrival < tolerance))
+            continue;
+        late++;
+    }
+
+    return late;
+}
+
+static bool
+check_timed_wait(uint32_t timeout_usec, uint64_t &elapsed_usec)
+{
+    Mutex mutex;
+    ConditionVariable cond;
+    bool timed_out = false;
+    bool ok = mutex.initialize() && cond.initialize();
+
+    if (ok)
+    {
+        const TimeValue start = getCurrentTime();
+
+        ok = mutex.lock() &&
+            cond.timedWait(mutex, TimeValue::fromUSec(timeout_usec), &timed_out);
+        elapsed_usec = (getCurrentTime() - start).toUSec();
+        mutex.unlock();
+    }
+    cond.shutdown();
+    mutex.shutdown();
+
+    return ok && timed_out && (elapsed_usec >= timeout_usec) &&
+        (elapsed_usec < timeout_usec + 100000);
+}
+
+static bool
+near(uint64_t value, uint64_t expected, uint64_t tolerance)
+{
+    return (value + tolerance >= expected) && (value <= expected + tolerance);
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const sim_result &result, bool ok)
+{
+    const RenderScheduler::Stats &stats = result.stats;
+    const double latency = stats.latencyCount ?
+        stats.latencySum.toNSec() / 1e6 / stats.latencyCount : 0.0;
+
+    table.row(name, ok) << result.vsyncs << stats.framesRendered << stats.framesCoalesced <<
+        stats.wakeups << result.shown << result.late << stats.refreshPeriod.toNSec() / 1e6 <<
+        stats.jitterMax.toNSec() / 1e3 << latency;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint64_t duration = DEFAULT_SECONDS * 1000 * MSEC;
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./render_scheduler_sample");
+    int opt;
+
+    args.option('d', "<seconds>", "Simulated time of each test", DEFAULT_SECONDS);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        if (opt != 'd')
+            return args.exitHelp(opt);
+        duration = strtoul(optarg, NULL, 10) * 1000 * MSEC;
+    }
+    if (duration <= 2 * WARMUP_NSEC)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    const double seconds = (duration - WARMUP_NSEC) / 1e9;
+    sim_display display_template;
+
+    table.column("vsyncs", 8).column("renders", 8).column("coalesced", 10).column("wakeups", 9)
+        .column("shown", 8).column("late", 6).column("period ms", 11, 3)
+        .column("jitter us", 11, 0).column("latency ms", 12, 2);
+
+    display_template.period = REFRESH_PERIOD;
+    display_template.phase = 5300 * USEC;
+    display_template.jitter = 200 * USEC;
+    display_template.render = 1 * MSEC;
+    display_template.seed = 1;
+
+    /* Nominal period 4% off, a producer faster than the display */
+    {
+        sim_result result;
+        RenderScheduler scheduler;
+        sim_display display = display_template;
+        vector<sim_stream> streams;
+        vector<shown_frame> shown;
+
+        scheduler.setRefreshPeriod(TimeValue::fromUSec(16000));
+        streams.push_back(make_stream(10 * MSEC, 700 * USEC, true, true));
+        simulate(scheduler, display, streams, WARMUP_NSEC, duration, shown, result);
+
+        result.late = count_late(display, shown, LATCH_MARGIN, LATCH_TOLERANCE);
+        const bool ok = near(result.stats.refreshPeriod.toNSec(), display.period, 50 * USEC) &&
+            (result.stats.jitterMax.toNSec() <= display.jitter + 100 * USEC) &&
+            (result.stats.framesRendered == result.vsyncs) &&
+            (result.late == 0);
+        add_result(table, "vsync", result, ok);
+    }
+
+    /* Four 30 fps streams with spread phases */
+    {
+        sim_result result;
+        RenderScheduler scheduler;
+        sim_display display = display_template;
+        vector<sim_stream> streams;
+        vector<shown_frame> shown;
+
+        scheduler.setRefreshPeriod(TimeValue::fromNSec(REFRESH_PERIOD));
+        for (uint32_t i = 0; i < 4; i++)
+            streams.push_back(make_stream(33333333, i * 8 * MSEC + 1100 * USEC, true, false));
+        simulate(scheduler, display, streams, WARMUP_NSEC, duration, shown, result);
+
+        result.late = count_late(display, shown, LATCH_MARGIN, LATCH_TOLERANCE);
+        // 120 stream updates per second are rendered in at most one frame per vsync
+        const bool ok = (result.stats.framesRendered <= result.vsyncs) &&
+            (result.stats.framesCoalesced > 0) &&
+            (result.stats.framesRendered + result.stats.framesCoalesced == result.shown) &&
+            near(result.shown, static_cast<uint64_t>(seconds * 120), 8) &&
+            (result.stats.latencyMax.toNSec() <=
+                CAPTURE_LATENCY + display.period + LATCH_MARGIN + display.jitter) &&
+            (result.late == 0);
+        add_result(table, "coalesce", result, ok);
+    }
+
+    /* 120 fps producer, latest frame wins */
+    {
+        sim_result result;
+        RenderScheduler scheduler;
+        sim_display display = display_template;
+        vector<sim_stream> streams;
+        vector<shown_frame> shown;
+        bool newest = true;
+
+        scheduler.setRefreshPeriod(TimeValue::fromNSec(REFRESH_PERIOD));
+        streams.push_back(make_stream(8300 * USEC, 2 * MSEC, true, true));
+        simulate(scheduler, display, streams, WARMUP_NSEC, duration, shown, result);
+
+        for (size_t i = 0; i < shown.size(); i++)
+            newest = newest && (shown[i].frame == shown[i].newest);
+        result.late = count_late(display, shown, LATCH_MARGIN, LATCH_TOLERANCE);
+        const bool ok = newest &&
+            (result.stats.framesRendered == result.vsyncs) &&
+            (streams[0].skipped * 10 >= streams[0].next * 4) &&
+            (streams[0].skipped * 10 <= streams[0].next * 6) &&
+            (result.late == 0);
+        add_result(table, "latest", result, ok);
+    }
+
+    /* 120 fps producer, FIFO */
+    {
+        sim_result result;
+        RenderScheduler scheduler;
+        sim_display display = display_template;
+        vector<sim_stream> streams;
+        vector<shown_frame> shown;
+
+        scheduler.setRefreshPeriod(TimeValue::fromNSec(REFRESH_PERIOD));
+        streams.push_back(make_stream(8300 * USEC, 2 * MSEC, true, false));
+        simulate(scheduler, display, streams, WARMUP_NSEC, duration, shown, result);
+
+        // one frame is consumed per vsync, the queue grows by about 60 frames per second
+        const uint64_t lag = shown.empty() ? 0 : shown.back().newest - shown.back().frame;
+        result.late = count_late(display, shown, LATCH_MARGIN, LATCH_TOLERANCE);
+        const bool ok = (streams[0].skipped == 0) &&
+            (result.stats.framesRendered == result.vsyncs) &&
+            (lag >= static_cast<uint64_t>(seconds * 50));
+        add_result(table, "fifo", result, ok);
+    }
+
+    /* 30 fps producer without signals */
+    {
+        sim_result result;
+        RenderScheduler scheduler;
+        sim_display display = display_template;
+        vector<sim_stream> streams;
+        vector<shown_frame> shown;
+
+        scheduler.setRefreshPeriod(TimeValue::fromNSec(REFRESH_PERIOD));
+        streams.push_back(make_stream(33333333, 4 * MSEC, false, false));
+        simulate(scheduler, display, streams, WARMUP_NSEC, duration, shown, result);
+
+        result.late = count_late(display, shown, LATCH_MARGIN, LATCH_TOLERANCE);
+        const bool ok = near(result.stats.wakeups, result.vsyncs, 2) &&
+            near(result.shown, static_cast<uint64_t>(seconds * 30), 2) &&
+            (result.late == 0);
+        add_result(table, "nosignal", result, ok);
+    }
+
+    /* No streams */
+    {
+        sim_result result;
+        RenderScheduler scheduler;
+        sim_display display = display_template;
+        vector<sim_stream> streams;
+        vector<shown_frame> shown;
+
+        scheduler.setRefreshPeriod(TimeValue::fromNSec(REFRESH_PERIOD));
+        simulate(scheduler, display, streams, WARMUP_NSEC, duration, shown, result);
+
+        result.late = 0;
+        const bool ok = (result.stats.wakeups == 0) &&
+            (scheduler.getWakeupTime(TimeValue::fromNSec(START_NSEC), 0) ==
+                TimeValue::infinite());
+        add_result(table, "idle", result, ok);
+    }
+
+    cout << "Simulated " << setprecision(3) << seconds << " s per test, display at " <<
+        1e9 / REFRESH_PERIOD << " Hz" << endl;
+    uint64_t elapsed_usec = 0;
+    const bool wait_ok = check_timed_wait(20000, elapsed_usec);
+
+    table.row("wait", wait_ok);
+
+    const bool all_ok = table.print();
+
+    cout << "Timed wait of 20 ms took " << fixed << setprecision(2) << elapsed_usec / 1e3 <<
+        " ms" << endl;
+    return all_ok ? 0 : -1;
+}
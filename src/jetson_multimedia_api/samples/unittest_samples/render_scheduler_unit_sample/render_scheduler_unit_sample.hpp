@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RenderScheduler.h"
+#include "unit_sample.hpp"
+
+/**
+ * Simulated display. Vsyncs are at phase + k * period, a swap returns at
+ * the first vsync after rendering finished, delayed by up to jitter.
+ */
+typedef struct
+{
+    /** Vsync period, in nanoseconds. */
+    uint64_t period;
+    /** Time of the first vsync, in nanoseconds. */
+    uint64_t phase;
+    /** Maximum delay of a swap after the vsync, in nanoseconds. */
+    uint64_t jitter;
+    /** Render time, in nanoseconds. */
+    uint64_t render;
+    /** State of the jitter generator. */
+    uint32_t seed;
+} sim_display;
+
+/**
+ * Simulated producer stream. Frames arrive at phase + i * period and are
+ * queued like in a FIFO mode EGL stream until the composer acquires them.
+ */
+typedef struct
+{
+    /** Frame period, in nanoseconds. */
+    uint64_t period;
+    /** Arrival time of the first frame, in nanoseconds. */
+    uint64_t phase;
+    /** True if the producer signals new frames to the scheduler. */
+    bool signalled;
+    /** True if an acquire skips to the newest queued frame. */
+    bool latest;
+    /** Index of the next frame to arrive. */
+    uint64_t next;
+    /** Indices of the frames arrived but not yet acquired. */
+    std::deque<uint64_t> queue;
+    /** Number of frames skipped by latest frame wins. */
+    uint64_t skipped;
+} sim_stream;
+
+/**
+ * A stream frame shown by a swap.
+ */
+typedef struct
+{
+    /** Index of the stream. */
+    uint32_t stream;
+    /** Index of the frame. */
+    uint64_t frame;
+    /** Index of the newest frame of the stream arrived at the latch. */
+    uint64_t newest;
+    /** Arrival time of the frame, in nanoseconds. */
+    uint64_t arrival;
+    /** Index of the vsync the frame was shown at. */
+    uint64_t vsync;
+} shown_frame;
+
+/**
+ * Holds the statistics of one simulated test.
+ */
+typedef struct
+{
+    /** Scheduler statistics after the warm up. */
+    ArgusSamples::RenderScheduler::Stats stats;
+    /** Number of vsyncs after the warm up. */
+    uint64_t vsyncs;
+    /** Number of frames shown after the warm up. */
+    uint64_t shown;
+    /** Number of frames shown later than the first vsync reachable after their arrival. */
+    uint64_t late;
+} sim_result;
+
+/**
+ * @brief Creates a simulated stream.
+ *
+ * @param[in] period Frame period, in nanoseconds
+ * @param[in] phase Arrival time of the first frame after the start, in nanoseconds
+ * @param[in] signalled True if the producer signals new frames
+ * @param[in] latest True for latest frame wins
+ * @return Stream state
+ */
+static sim_stream make_stream(uint64_t period, uint64_t phase, bool signalled, bool latest);
+
+/**
+ * @brief Drives a scheduler like the composer thread does, with simulated
+ *        streams and a simulated display.
+ *
+ * @param[in] scheduler Scheduler
+ * @param[in] display Display state
+ * @param[in] streams Stream states
+ * @param[in] warmup Time before the statistics are reset, in nanoseconds
+ * @param[in] duration Simulated time, in nanoseconds
+ * @param[out] shown Frames shown after the warm up
+ * @param[out] result Statistics and vsync count after the warm up
+ */
+static void simulate(ArgusSamples::RenderScheduler &scheduler, sim_display &display,
+                     std::vector<sim_stream> &streams, uint64_t warmup, uint64_t duration,
+                     std::vector<shown_frame> &shown, sim_result &result);
+
+/**
+ * @brief Counts the frames shown later than the first vsync whose latch
+ *        point they arrived before. Frames which arrived within the
+ *        tolerance before the latch point may be shown one vsync later.
+ *
+ * @param[in] display Display state
+ * @param[in] shown Shown frames
+ * @param[in] margin Latch margin, in nanoseconds
+ * @param[in] tolerance Tolerance, in nanoseconds
+ * @return Number of late frames
+ */
+static uint64_t count_late(const sim_display &display, const std::vector<shown_frame> &shown,
+                           uint64_t margin, uint64_t tolerance);
+
+/**
+ * @brief Checks that a timed wait on a condition variable times out after
+ *        the timeout measured with the monotonic clock.
+ *
+ * @param[in] timeout_usec Timeout, in microseconds
+ * @param[out] elapsed_usec Time the wait took, in microseconds
+ * @return true if the wait timed out in time
+ */
+static bool check_timed_wait(uint32_t timeout_usec, uint64_t &elapsed_usec);
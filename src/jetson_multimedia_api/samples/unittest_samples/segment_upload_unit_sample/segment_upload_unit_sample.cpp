@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./segment_upload_sample [-n <segments>] [-s <KB>] [-p <streams>]
+ * Example:
+ * ./segment_upload_sample
+ * ./segment_upload_sample -n 16 -s 16384 -p 4
+**/
+
+#include <dirent.h>
+#include <iostream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "segment_upload_unit_sample.hpp"
+
+/**
+ * Segment upload for argus_gstvideoencode remote file writes.
+ *
+ * argus_gstvideoencode used to copy each finished part with scp, one
+ * process and SSH handshake per part, only after the part was closed.
+ * SegmentUploader streams the parts over a shared SSH connection while
+ * they are written.
+ *
+ * This sample runs the transfer commands with the local shell instead of
+ * SSH, copying to a local directory, and checks:
+ * ## Parts queued once closed, as before, arrive intact
+ * ## Parts streamed while written arrive intact, and the local copies are deleted
+ * ## Finished parts are sent in parallel
+ * ## A destination which is not there yet is retried with backoff
+ * ## A part lost in the middle of its transfer is sent again as a whole
+ * ## A part is given up after the last retry and kept locally
+ *
+ * The time from closing a part to the confirmation of the copy is
+ * reported for the closed and streamed runs.
+**/
+
+#define DEFAULT_SEGMENTS 8
+#define DEFAULT_SEGMENT_KB 4096
+#define DEFAULT_STREAMS 2
+#define WRITE_SIZE (64 * 1024)
+#define WRITE_USEC 500
+#define RETRIES 8
+
+static uint8_t
+pattern_byte(uint32_t index, uint64_t offset)
+{
+    return (uint8_t) (((offset * 2654435761u) >> 13) ^ (index * 31));
+}
+
+static bool
+write_pattern(FILE *file, uint32_t index, uint64_t offset, uint64_t size)
+{
+    vector<uint8_t> data(size);
+
+    for (uint64_t i = 0; i < size; i++)
+        data[i] = pattern_byte(index, offset + i);
+    return fwrite(data.data(), 1, size, file) == size;
+}
+
+static bool
+write_segment(SegmentUploader &uploader, const std::string &file_name,
+              uint32_t index, const writer_config &config)
+{
+    FILE *file = fopen(file_name.c_str(), "w");
+    uint32_t id = 0;
+    uint64_t offset = 0;
+
+    if (!file)
+        return false;
+    if (config.streamed)
+        id = uploader.beginSegment(file_name);
+
+    while (offset < config.segment_size)
+    {
+        uint64_t size = min<uint64_t>(config.write_size, config.segment_size - offset);
+
+        if (!write_pattern(file, index, offset, size) || fflush(file) != 0)
+        {
+            fclose(file);
+            return false;
+        }
+        offset += size;
+        if (config.streamed)
+            uploader.segmentProgress(id, offset);
+        if (config.write_usec)
+            usleep(config.write_usec);
+    }
+    fclose(file);
+
+    if (config.streamed)
+        uploader.finishSegment(id, offset);
+    else
+        uploader.sendFile(file_name);
+    return true;
+}
+
+static bool
+check_segment(const std::string &file_name, uint32_t index, uint64_t size)
+{
+    FILE *file = fopen(file_name.c_str(), "r");
+    vector<uint8_t> data(WRITE_SIZE);
+    uint64_t offset = 0;
+    bool ok = (file != NULL);
+
+    while (ok)
+    {
+        size_t ret = fread(data.data(), 1, data.size(), file);
+
+        if (ret == 0)
+            break;
+        for (size_t i = 0; i < ret && ok; i++)
+            ok = data[i] == pattern_byte(index, offset + i);
+        offset += ret;
+    }
+    if (file)
+        fclose(file);
+
+    if (!ok || offset != size)
+    {
+        cerr << "FAIL: " << file_name << " is corrupt or incomplete (" << offset <<
+            " of " << size << " bytes)" << endl;
+        return false;
+    }
+    return true;
+}
+
+static bool
+file_exists(const std::string &file_name)
+{
+    struct stat st;
+
+    return stat(file_name.c_str(), &st) == 0;
+}
+
+static std::string
+segment_name(const char *test, uint32_t index)
+{
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s_%06u.h265", test, index);
+    return name;
+}
+
+static void
+remove_directory(const std::string &path)
+{
+    DIR *dir = opendir(path.c_str());
+    struct dirent *entry;
+
+    if (!dir)
+        return;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+            unlink((path + entry->d_name).c_str());
+    }
+    closedir(dir);
+    rmdir(path.c_str());
+}
+
+/**
+ * Writes the segments of a test with one uploader and checks the received copies.
+ */
+static bool
+run_writer(const char *test, const std::string &src, const std::string &dst,
+           uint32_t streams, bool keep_local, const writer_config &config,
+           SegmentUploadStats &stats)
+{
+    SegmentUploader uploader("", "", dst, streams, RETRIES, keep_local);
+    bool ok = uploader.initialize();
+
+    for (uint32_t i = 0; i < config.segments && ok; i++)
+        ok = write_segment(uploader, src + segment_name(test, i), i, config);
+    ok = uploader.shutdown() && ok;
+    uploader.getStats(&stats);
+    uploader.printStats();
+
+    for (uint32_t i = 0; i < config.segments && ok; i++)
+    {
+        ok = check_segment(dst + segment_name(test, i), i, config.segment_size);
+        ok = ok && (file_exists(src + segment_name(test, i)) == keep_local);
+    }
+    return ok && stats.segments == config.segments && stats.failed == 0;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const SegmentUploadStats &stats, bool ok)
+{
+    table.row(name, ok) << stats.segments << stats.failed << stats.retries <<
+        (stats.segments ? stats.totalLatencyUs / 1000.0 / stats.segments : 0.0) <<
+        stats.maxLatencyUs / 1000.0 <<
+        (stats.totalBusyUs ? (double) stats.bytes / stats.totalBusyUs : 0.0);
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t segments = DEFAULT_SEGMENTS;
+    uint64_t segment_size = DEFAULT_SEGMENT_KB * 1024ULL;
+    uint32_t streams = DEFAULT_STREAMS;
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./segment_upload_sample");
+    int opt;
+
+    args.option('n', "<segments>", "Segments per test", DEFAULT_SEGMENTS)
+        .option('s', "<KB>", "Segment size", DEFAULT_SEGMENT_KB)
+        .option('p', "<streams>", "Parallel streams of the parallel test", DEFAULT_STREAMS);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                segments = atoi(optarg);
+                break;
+            case 's':
+                segment_size = atoi(optarg) * 1024ULL;
+                break;
+            case 'p':
+                streams = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (segments == 0 || segment_size == 0 || streams == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    char root_template[] = "/tmp/segment_upload_XXXXXX";
+    if (!mkdtemp(root_template))
+    {
+        cerr << "Failed to create a temporary directory" << endl;
+        return -1;
+    }
+    const std::string root = std::string(root_template) + "/";
+    const std::string src = root + "src/";
+    const std::string dst = root + "dst/";
+    mkdir(src.c_str(), 0755);
+    mkdir(dst.c_str(), 0755);
+
+    writer_config config;
+    config.segments = segments;
+    config.segment_size = segment_size;
+    config.write_size = WRITE_SIZE;
+    config.write_usec = WRITE_USEC;
+
+    table.column("sent", 6).column("failed", 8).column("retries", 9).column("ms/close", 14, 1)
+        .column("max ms/close", 14, 1).column("MB/s", 10, 1);
+
+    /* Parts queued once closed, as before */
+    {
+        SegmentUploadStats stats;
+
+        memset(&stats, 0, sizeof(stats));
+        config.streamed = false;
+        add_result(table, "closed", stats, run_writer("closed", src, dst, 1, true, config, stats));
+    }
+
+    /* Parts streamed while written, local copies deleted */
+    {
+        SegmentUploadStats stats;
+
+        memset(&stats, 0, sizeof(stats));
+        config.streamed = true;
+        add_result(table, "streamed", stats, run_writer("streamed", src, dst, 1, false, config, stats));
+    }
+
+    /* Finished parts in parallel */
+    {
+        SegmentUploadStats stats;
+        writer_config parallel = config;
+
+        memset(&stats, 0, sizeof(stats));
+        parallel.segments = max(segments, streams * 4);
+        parallel.write_usec = 0;
+        parallel.streamed = false;
+        add_result(table, "parallel", stats, run_writer("parallel", src, dst, streams, true, parallel, stats));
+    }
+
+    /* A destination which is not there yet is retried with backoff */
+    {
+        SegmentUploadStats stats;
+        writer_config single = config;
+        const std::string late = root + "late/";
+        bool ok = true;
+
+        memset(&stats, 0, sizeof(stats));
+        single.segments = 1;
+        single.write_usec = 0;
+        single.streamed = false;
+        {
+            SegmentUploader uploader("", "", late, 1, RETRIES, true);
+
+            ok = uploader.initialize() && ok;
+            ok = write_segment(uploader, src + segment_name("retry", 0), 0, single) && ok;
+            usleep(400 * 1000);
+            ok = mkdir(late.c_str(), 0755) == 0 && ok;
+            ok = uploader.shutdown() && ok;
+            uploader.getStats(&stats);
+        }
+        ok = check_segment(late + segment_name("retry", 0), 0, single.segment_size) && ok;
+        remove_directory(late);
+        add_result(table, "retry", stats, ok && stats.segments == 1 && stats.retries > 0);
+    }
+
+    /* A part lost in the middle of its transfer is sent again as a whole */
+    {
+        SegmentUploadStats stats;
+        const std::string file_name = src + segment_name("restart", 0);
+        const std::string lost = root + "lost/";
+        const uint64_t half = segment_size / 2;
+        bool ok = true;
+
+        memset(&stats, 0, sizeof(stats));
+        {
+            SegmentUploader uploader("", "", dst, 1, RETRIES, true);
+            FILE *file = fopen(file_name.c_str(), "w");
+
+            ok = uploader.initialize() && file;
+            uint32_t id = uploader.beginSegment(file_name);
+            ok = ok && write_pattern(file, 0, 0, half) && fflush(file) == 0;
+            uploader.segmentProgress(id, half);
+            usleep(200 * 1000);
+
+            /* The '.part' file moves away with the directory, so the attempt fails */
+            ok = rename(dst.c_str(), lost.c_str()) == 0 && ok;
+            ok = mkdir(dst.c_str(), 0755) == 0 && ok;
+
+            ok = ok && write_pattern(file, 0, half, segment_size - half) && fflush(file) == 0;
+            if (file)
+                fclose(file);
+            uploader.finishSegment(id, segment_size);
+            ok = uploader.shutdown() && ok;
+            uploader.getStats(&stats);
+        }
+        ok = check_segment(dst + segment_name("restart", 0), 0, segment_size) && ok;
+        remove_directory(lost);
+        add_result(table, "restart", stats, ok && stats.segments == 1 && stats.retries > 0);
+    }
+
+    /* A part is given up after the last retry and kept locally */
+    {
+        SegmentUploadStats stats;
+        writer_config single = config;
+
+        memset(&stats, 0, sizeof(stats));
+        single.segments = 1;
+        single.write_usec = 0;
+        single.streamed = false;
+        bool ok = true;
+        {
+            SegmentUploader uploader("", "", root + "missing/", 1, 3, false);
+
+            ok = uploader.initialize() && ok;
+            ok = write_segment(uploader, src + segment_name("giveup", 0), 0, single) && ok;
+            ok = uploader.shutdown() && ok;
+            uploader.getStats(&stats);
+        }
+        ok = file_exists(src + segment_name("giveup", 0)) && ok;
+        ok = !file_exists(root + "missing/" + segment_name("giveup", 0)) && ok;
+        add_result(table, "giveup", stats, ok && stats.failed == 1 && stats.retries == 2);
+    }
+
+    remove_directory(dst);
+    remove_directory(src);
+    remove_directory(root);
+
+    cout << "Segments " << segments << " x " << segment_size / 1024 << " KB" << endl;
+    return table.print() ? 0 : -1;
+}
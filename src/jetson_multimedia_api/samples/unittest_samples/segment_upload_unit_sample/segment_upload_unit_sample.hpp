@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SegmentUploader.h"
+#include "unit_sample.hpp"
+
+using namespace ArgusSamples;
+
+/**
+ * Describes how a test writes its segments.
+ */
+typedef struct
+{
+    /** Number of segments. */
+    uint32_t segments;
+    /** Size of each segment, in bytes. */
+    uint64_t segment_size;
+    /** Bytes written between two progress reports. */
+    uint32_t write_size;
+    /** Delay after each write, in microseconds, to pace the writer like an encoder. */
+    uint32_t write_usec;
+    /** True to report progress while writing, false to queue each segment once closed. */
+    bool streamed;
+} writer_config;
+
+/**
+ * @brief Writes one segment and reports it to the uploader.
+ *
+ * The content is a pattern derived from the segment index, so that
+ * check_segment() can verify the received copy.
+ *
+ * @param[in] uploader Uploader
+ * @param[in] file_name Local file to write
+ * @param[in] index Segment index
+ * @param[in] config Writer configuration
+ * @return true if the segment was written
+ */
+static bool
+write_segment(SegmentUploader &uploader, const std::string &file_name,
+              uint32_t index, const writer_config &config);
+
+/**
+ * @brief Checks that a received segment matches the written pattern.
+ *
+ * @param[in] file_name Received file
+ * @param[in] index Segment index
+ * @param[in] size Expected size
+ * @return true if the file is complete and intact
+ */
+static bool
+check_segment(const std::string &file_name, uint32_t index, uint64_t size);
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./thread_policy_sample [iterations] [load_threads]
+ * Example:
+ * ./thread_policy_sample 5000 4
+ * sudo ./thread_policy_sample 5000 4
+**/
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "thread_policy_unit_sample.hpp"
+
+/**
+ * Thread placement and scheduling with NvThreadPolicy.
+ *
+ * Threads of the samples and framework classes call
+ * NvThreadPolicy::applyToCurrentThread() with their role name, so their
+ * CPU set, scheduling class and priority can be configured without code
+ * changes through NV_THREAD_POLICY, NV_THREAD_POLICY_FILE or the
+ * --threadpolicy option of the Argus samples.
+ *
+ * This sample measures the wakeup-to-run latency of a thread that wakes up
+ * every millisecond, the way a DQ or capture thread waits for a buffer,
+ * with each of these policies:
+ * ## SCHED_OTHER
+ * ## SCHED_OTHER with nice -10
+ * ## SCHED_FIFO priority 50
+ * ## SCHED_FIFO priority 50 pinned to the last CPU
+ *
+ * Optional load threads spin on all CPUs to show the effect of contention.
+ * SCHED_FIFO and negative nice values need CAP_SYS_NICE (run as root);
+ * without it the run is reported as not permitted.
+**/
+
+#define PERIOD_USEC 1000
+
+static volatile bool load_running;
+
+typedef struct
+{
+    uint32_t iterations;
+    uint32_t period_usec;
+    vector<int64_t> lateness_nsec;
+    int policy_error;
+} bench_context;
+
+static int64_t
+timespec_nsec(const struct timespec &ts)
+{
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void *
+load_thread(void *arg)
+{
+    volatile uint64_t count = 0;
+    while (load_running)
+        count++;
+    return NULL;
+}
+
+static void *
+bench_thread(void *arg)
+{
+    bench_context *ctx = (bench_context *) arg;
+    struct timespec deadline, now;
+
+    ctx->policy_error = NvThreadPolicy::getInstance().applyToCurrentThread("bench");
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    for (uint32_t i = 0; i < ctx->iterations; i++)
+    {
+        deadline.tv_nsec += ctx->period_usec * 1000;
+        while (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_nsec -= 1000000000;
+            deadline.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ctx->lateness_nsec.push_back(timespec_nsec(now) - timespec_nsec(deadline));
+    }
+    return NULL;
+}
+
+static int
+run_latency(const char *spec, uint32_t iterations, uint32_t period_usec,
+            latency_stats &stats)
+{
+    NvThreadPolicy &policy = NvThreadPolicy::getInstance();
+    bench_context ctx;
+    pthread_t thread;
+    double sum = 0;
+
+    policy.clear();
+    if (policy.loadConfig(spec) != 0)
+        return -1;
+
+    ctx.iterations = iterations;
+    ctx.period_usec = period_usec;
+    ctx.lateness_nsec.reserve(iterations);
+    ctx.policy_error = 0;
+
+    if (pthread_create(&thread, NULL, bench_thread, &ctx) != 0)
+        return -1;
+    pthread_join(thread, NULL);
+
+    sort(ctx.lateness_nsec.begin(), ctx.lateness_nsec.end());
+    for (size_t i = 0; i < ctx.lateness_nsec.size(); i++)
+        sum += ctx.lateness_nsec[i];
+
+    stats.min_usec = ctx.lateness_nsec.front() / 1000.0;
+    stats.avg_usec = sum / ctx.lateness_nsec.size() / 1000.0;
+    stats.p99_usec = ctx.lateness_nsec[(ctx.lateness_nsec.size() - 1) * 99 / 100] / 1000.0;
+    stats.max_usec = ctx.lateness_nsec.back() / 1000.0;
+    stats.policy_error = ctx.policy_error;
+
+    return 0;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t iterations = 5000;
+    uint32_t num_load = 0;
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    char pinned_spec[64];
+    vector<pthread_t> load_threads;
+    int ret = 0;
+    UnitSampleArgs args("./thread_policy_sample");
+
+    args.usage("[iterations] [load_threads]",
+               "Measure wakeup latency for each thread policy "
+               "[Default = 5000 iterations of 1 ms, 0 load threads]");
+
+    if (argc >= 2 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")))
+    {
+        args.printHelp();
+        return 0;
+    }
+    if (argc >= 2)
+        iterations = atoi(argv[1]);
+    if (argc >= 3)
+        num_load = atoi(argv[2]);
+    if (iterations == 0)
+    {
+        cerr << "Iterations should be a positive integer" << endl;
+        return -1;
+    }
+
+    snprintf(pinned_spec, sizeof(pinned_spec),
+             "bench:cpus=%ld,policy=fifo,priority=50", num_cpus - 1);
+
+    const char *names[] = { "other", "nice -10", "fifo 50", "fifo 50 + affinity" };
+    const char *specs[] = { "bench:policy=other",
+                            "bench:policy=other,nice=-10",
+                            "bench:policy=fifo,priority=50",
+                            pinned_spec };
+
+    load_running = true;
+    for (uint32_t i = 0; i < num_load; i++)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, load_thread, NULL) == 0)
+            load_threads.push_back(thread);
+    }
+
+    cout << "Wakeup latency (" << iterations << " x " << PERIOD_USEC <<
+        " us, " << num_load << " load threads, " << num_cpus << " CPUs):" << endl;
+    cout << left << setw(20) << "policy" << right << setw(10) << "min us" <<
+        setw(10) << "avg us" << setw(10) << "p99 us" << setw(10) << "max us" << endl;
+
+    for (uint32_t i = 0; i < sizeof(specs) / sizeof(specs[0]); i++)
+    {
+        latency_stats stats;
+
+        if (run_latency(specs[i], iterations, PERIOD_USEC, stats) < 0)
+        {
+            cerr << "Benchmark failed for policy " << names[i] << endl;
+            ret = -1;
+            break;
+        }
+        cout << left << setw(20) << names[i] << right << fixed << setprecision(1);
+        if (stats.policy_error)
+            cout << "   (not permitted, ran with default policy)" << endl;
+        else
+            cout << setw(10) << stats.min_usec << setw(10) << stats.avg_usec <<
+                setw(10) << stats.p99_usec << setw(10) << stats.max_usec << endl;
+    }
+
+    load_running = false;
+    for (size_t i = 0; i < load_threads.size(); i++)
+        pthread_join(load_threads[i], NULL);
+
+    NvThreadPolicy::getInstance().clear();
+    return ret;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvThreadPolicy.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the wakeup latency statistics of one benchmark run.
+ */
+typedef struct
+{
+    /** Minimum lateness in microseconds. */
+    double min_usec;
+    /** Average lateness in microseconds. */
+    double avg_usec;
+    /** 99th percentile lateness in microseconds. */
+    double p99_usec;
+    /** Maximum lateness in microseconds. */
+    double max_usec;
+    /** 0 if the policy was applied, -1 otherwise. */
+    int policy_error;
+} latency_stats;
+
+/**
+ * @brief Measures the wakeup-to-run latency of a periodic thread.
+ *
+ * Starts a thread with role "bench", applies @a spec to it through
+ * NvThreadPolicy and lets it sleep until absolute deadlines @a period_usec
+ * apart. The lateness of each wakeup is measured against its deadline.
+ *
+ * @param[in] spec Thread policy specification for the "bench" role
+ * @param[in] iterations Number of wakeups to measure
+ * @param[in] period_usec Period between deadlines in microseconds
+ * @param[out] stats Latency statistics of the run
+ * @return 0 for success, -1 otherwise
+ */
+static int
+run_latency(const char *spec, uint32_t iterations, uint32_t period_usec,
+            latency_stats &stats);
@@ -0,0 +1,60 @@
+###############################################################################
+#
+# Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+###############################################################################
+
+
+# Rules shared by the unit samples.
+#
+# A unit sample Makefile includes ../../Rules.mk, sets APP and SRCS, and
+# UNIT_SAMPLE_LIBS if it links other libraries than those of Rules.mk,
+# then includes this file. Sources outside of $(CLASS_DIR) are compiled
+# here, so that a sample builds without the dependencies of the directory
+# its sources come from.
+
+UNIT_SAMPLE_LIBS ?= $(LDFLAGS)
+
+OBJS := $(SRCS:.cpp=.o)
+
+CPPFLAGS += -I"$(TOP_DIR)/samples/unittest_samples/common"
+
+all: $(APP)
+
+$(CLASS_DIR)/%.o: $(CLASS_DIR)/%.cpp
+	$(AT)$(MAKE) -C $(CLASS_DIR)
+
+%.o: %.cpp
+	@echo "Compiling: $<"
+	$(CPP) $(CPPFLAGS) -c $< -o $@
+
+$(APP): $(OBJS)
+	@echo "Linking: $@"
+	$(CPP) -o $@ $(OBJS) $(CPPFLAGS) $(UNIT_SAMPLE_LIBS)
+
+clean:
+	$(AT)rm -rf $(APP) $(OBJS)
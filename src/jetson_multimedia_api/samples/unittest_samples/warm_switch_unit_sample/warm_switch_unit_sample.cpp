@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./warm_switch_sample [-f <fps>] [-d <devices>] [-n <switches>] [-o <open ms>] [-s <start ms>]
+ * Example:
+ * ./warm_switch_sample
+ * ./warm_switch_sample -f 60 -d 4 -n 12 -o 200 -s 300
+**/
+
+#include <iostream>
+#include <iomanip>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "warm_switch_unit_sample.hpp"
+
+/**
+ * Warm camera switch.
+ *
+ * WarmSwitch switches the preview between camera sources. In warm mode
+ * all sources keep capturing and a switch only redirects the preview, in
+ * cold mode a switch closes the shown source and opens the new one.
+ * Simulated devices, which take time to open and to deliver their first
+ * frame, report timestamped frames to a simulated preview, and this
+ * sample checks:
+ * ## Warm switches open every device once, route only the new device to
+ *    the preview and deliver its first frame
+ * ## Cold switches close and open a device per switch, and their switch
+ *    to first frame latency covers the open and the sensor start
+ * ## After a switch no frame of an earlier device is shown, and the
+ *    timestamps of the shown frames of a device increase
+ * ## A switch to the shown device does nothing
+ * ## A device failing to open keeps the old device shown, and a failed
+ *    start releases the devices opened so far
+ *
+ * It then compares the switch to first frame latency of both modes.
+**/
+
+using namespace ArgusSamples;
+
+#define DEFAULT_FPS 30
+#define DEFAULT_DEVICES 3
+#define DEFAULT_SWITCHES 6
+#define DEFAULT_OPEN_MS 60
+#define DEFAULT_START_MS 100
+#define DWELL_FRAMES 3
+#define MSEC 1000000ull
+
+sim_device::sim_device(uint32_t index, sim_preview *preview, uint32_t fps, uint32_t open_usec,
+                       uint32_t start_usec, bool fail)
+    : prepares(0)
+    , releases(0)
+    , index(index)
+    , preview(preview)
+    , frame_duration(1000000000ull / fps)
+    , delivery_usec(frame_duration / 2000)
+    , open_usec(open_usec)
+    , start_usec(start_usec)
+    , fail(fail)
+    , running(false)
+    , stop(false)
+    , active(false)
+{
+}
+
+sim_device::~sim_device()
+{
+    if (running)
+    {
+        __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+        pthread_join(thread, NULL);
+    }
+}
+
+void *
+sim_device::sensor_thread(void *arg)
+{
+    sim_device *device = (sim_device *) arg;
+    uint64_t next = WarmSwitch::getTime() + device->start_usec * 1000ull;
+
+    while (!__atomic_load_n(&device->stop, __ATOMIC_ACQUIRE))
+    {
+        uint64_t now = WarmSwitch::getTime();
+        uint64_t timestamp;
+        bool show = false;
+
+        /* The frame is delivered some time after its readout started */
+        if (now < next)
+            usleep((next - now) / 1000);
+        timestamp = next - device->delivery_usec * 1000ull;
+        next += device->frame_duration;
+
+        pthread_mutex_lock(&device->preview->lock);
+        if (device->preview->warm_switch->onFrame(device->index, timestamp, &show) && show)
+        {
+            preview_entry entry = { device->index, timestamp, false };
+            device->preview->entries.push_back(entry);
+        }
+        pthread_mutex_unlock(&device->preview->lock);
+    }
+    return NULL;
+}
+
+bool
+sim_device::prepare()
+{
+    prepares++;
+
+    /* Open the session and create the request and stream */
+    usleep(open_usec);
+    if (fail)
+        return false;
+
+    __atomic_store_n(&stop, false, __ATOMIC_RELEASE);
+    running = pthread_create(&thread, NULL, sensor_thread, this) == 0;
+    return running;
+}
+
+bool
+sim_device::setPreview(bool active)
+{
+    __atomic_store_n(&this->active, active, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool
+sim_device::release()
+{
+    releases++;
+    if (running)
+    {
+        __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+        pthread_join(thread, NULL);
+        running = false;
+    }
+    /* Close the session */
+    usleep(open_usec / 2);
+    return true;
+}
+
+bool
+sim_device::routed() const
+{
+    return __atomic_load_n(&active, __ATOMIC_ACQUIRE);
+}
+
+static bool
+check_preview(sim_preview &preview, uint32_t first)
+{
+    vector<uint32_t> targets;
+    vector<uint64_t> last;
+    uint32_t current = first;
+    size_t next = 0;
+
+    pthread_mutex_lock(&preview.lock);
+    for (size_t i = 0; i < preview.entries.size(); i++)
+    {
+        if (preview.entries[i].marker)
+            targets.push_back(preview.entries[i].source);
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < preview.entries.size() && ok; i++)
+    {
+        const preview_entry &entry = preview.entries[i];
+
+        if (entry.marker)
+        {
+            current = entry.source;
+            next++;
+            continue;
+        }
+        /* The next switch may have redirected the preview before its marker */
+        ok = entry.source == current ||
+            (next < targets.size() && entry.source == targets[next]);
+        if (entry.source >= last.size())
+            last.resize(entry.source + 1, 0);
+        ok = ok && entry.timestamp > last[entry.source];
+        last[entry.source] = entry.timestamp;
+    }
+    pthread_mutex_unlock(&preview.lock);
+    return ok;
+}
+
+static bool
+run_switches(vector<sim_device *> &devices, sim_preview &preview, bool warm, uint32_t switches,
+             uint32_t dwell_usec, WarmSwitch::Stats &stats)
+{
+    WarmSwitch warm_switch;
+    vector<IWarmSource *> sources(devices.begin(), devices.end());
+    const TimeValue timeout = TimeValue::fromMSec(2000);
+    bool switched = false;
+    bool ok;
+
+    pthread_mutex_lock(&preview.lock);
+    preview.warm_switch = &warm_switch;
+    preview.entries.clear();
+    pthread_mutex_unlock(&preview.lock);
+
+    ok = warm_switch.initialize(sources, 0, warm) &&
+        warm_switch.waitSwitched(timeout, &switched) && switched;
+    for (uint32_t i = 0; i < switches && ok; i++)
+    {
+        uint32_t target = (i + 1) % devices.size();
+        uint32_t active = 0;
+
+        ok = warm_switch.switchTo(target) && warm_switch.getActive(&active) && active == target;
+
+        pthread_mutex_lock(&preview.lock);
+        preview_entry entry = { target, 0, true };
+        preview.entries.push_back(entry);
+        pthread_mutex_unlock(&preview.lock);
+
+        /* Only the new device is routed to the preview */
+        for (uint32_t j = 0; j < devices.size() && ok; j++)
+            ok = devices[j]->routed() == (j == target);
+
+        ok = ok && warm_switch.waitSwitched(timeout, &switched) && switched;
+        usleep(dwell_usec);
+    }
+    ok = ok && warm_switch.getStats(&stats);
+    warm_switch.shutdown();
+
+    ok = ok && stats.switches == switches && stats.completed == switches &&
+        stats.failed == 0 && stats.firstFrameAge.count == switches;
+    ok = ok && check_preview(preview, 0);
+    return ok;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const WarmSwitch::Stats &stats, bool ok)
+{
+    table.row(name, ok) << stats.switches << stats.failed << stats.shown << stats.hidden <<
+        stats.switchCall.average() / 1e6 << stats.switchToFrame.average() / 1e6 <<
+        stats.switchToFrame.max / 1e6;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t fps = DEFAULT_FPS;
+    uint32_t device_count = DEFAULT_DEVICES;
+    uint32_t switches = DEFAULT_SWITCHES;
+    uint32_t open_usec = DEFAULT_OPEN_MS * 1000;
+    uint32_t start_usec = DEFAULT_START_MS * 1000;
+    uint64_t warm_to_frame = 0;
+    uint64_t cold_to_frame = 0;
+    sim_preview preview;
+    UnitSampleTable table(9);
+    UnitSampleArgs args("./warm_switch_sample");
+    int opt;
+
+    args.option('f', "<fps>", "Sensor frame rate", DEFAULT_FPS)
+        .option('d', "<devices>", "Simulated devices, at least 3", DEFAULT_DEVICES)
+        .option('n', "<switches>", "Switches per mode", DEFAULT_SWITCHES)
+        .option('o', "<ms>", "Time to open a device", DEFAULT_OPEN_MS)
+        .option('s', "<ms>", "Time from the sensor start to the first frame", DEFAULT_START_MS);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'f':
+                fps = atoi(optarg);
+                break;
+            case 'd':
+                device_count = atoi(optarg);
+                break;
+            case 'n':
+                switches = atoi(optarg);
+                break;
+            case 'o':
+                open_usec = atoi(optarg) * 1000;
+                break;
+            case 's':
+                start_usec = atoi(optarg) * 1000;
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    /* With two devices a late frame of the old device can't be told apart */
+    if (fps == 0 || device_count < 3 || switches == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("switches", 10).column("failed", 8).column("shown", 8).column("hidden", 8)
+        .column("call ms", 10, 2).column("frame ms", 11, 2).column("max ms", 9, 2);
+
+    const uint64_t frame_duration = 1000000000ull / fps;
+    const uint32_t dwell_usec = DWELL_FRAMES * frame_duration / 1000;
+
+    preview.warm_switch = NULL;
+    pthread_mutex_init(&preview.lock, NULL);
+
+    /* Warm switches */
+    {
+        WarmSwitch::Stats stats;
+        vector<sim_device *> devices;
+        bool ok;
+
+        for (uint32_t i = 0; i < device_count; i++)
+            devices.push_back(new sim_device(i, &preview, fps, open_usec, start_usec, false));
+
+        ok = run_switches(devices, preview, true, switches, dwell_usec, stats);
+        for (uint32_t i = 0; i < device_count; i++)
+        {
+            ok = ok && devices[i]->prepares == 1 && devices[i]->releases == 1;
+            delete devices[i];
+        }
+        /* The other devices keep capturing, and the switch waits for the next frame at most */
+        ok = ok && stats.hidden > 0 &&
+            stats.firstFrameAge.min >= frame_duration / 2 &&
+            stats.switchToFrame.min < open_usec * 1000ull;
+        add_result(table, "warm", stats, ok);
+        warm_to_frame = stats.switchToFrame.average();
+    }
+
+    /* Cold switches */
+    {
+        WarmSwitch::Stats stats;
+        vector<sim_device *> devices;
+        bool ok;
+
+        for (uint32_t i = 0; i < device_count; i++)
+            devices.push_back(new sim_device(i, &preview, fps, open_usec, start_usec, false));
+
+        ok = run_switches(devices, preview, false, switches, dwell_usec, stats);
+        uint32_t prepares = 0;
+        uint32_t releases = 0;
+        for (uint32_t i = 0; i < device_count; i++)
+        {
+            prepares += devices[i]->prepares;
+            releases += devices[i]->releases;
+            delete devices[i];
+        }
+        /* Every switch closes a device, opens the next one and starts its sensor */
+        ok = ok && prepares == switches + 1 && releases == switches + 1 &&
+            stats.switchToFrame.min >= (uint64_t) (open_usec + start_usec) * 1000;
+        add_result(table, "cold", stats, ok);
+        cold_to_frame = stats.switchToFrame.average();
+    }
+
+    /* A switch to the shown device */
+    {
+        WarmSwitch::Stats stats;
+        WarmSwitch warm_switch;
+        sim_device device(0, &preview, fps, 0, 0, false);
+        vector<IWarmSource *> sources(1, &device);
+        bool ok;
+
+        preview.warm_switch = &warm_switch;
+        ok = warm_switch.initialize(sources, 0, true) && warm_switch.switchTo(0) &&
+            warm_switch.getStats(&stats);
+        warm_switch.shutdown();
+        ok = ok && stats.switches == 0 && device.prepares == 1 &&
+            device.releases == 1;
+        add_result(table, "same", stats, ok);
+    }
+
+    /* A device failing to open */
+    {
+        WarmSwitch::Stats stats;
+        WarmSwitch warm_switch;
+        sim_device good(0, &preview, fps, 0, 0, false);
+        sim_device bad(1, &preview, fps, 0, 0, true);
+        vector<IWarmSource *> sources;
+        uint32_t active = 1;
+        bool switched = false;
+        bool ok;
+
+        sources.push_back(&good);
+        sources.push_back(&bad);
+        preview.warm_switch = &warm_switch;
+        preview.entries.clear();
+        ok = warm_switch.initialize(sources, 0, false);
+        cout << "Expecting an error:" << endl;
+        ok = ok && !warm_switch.switchTo(1) &&
+            warm_switch.getActive(&active) && active == 0 && good.routed() && !bad.routed();
+
+        /* The old device was opened again and shows frames after the failed switch */
+        pthread_mutex_lock(&preview.lock);
+        preview.entries.clear();
+        pthread_mutex_unlock(&preview.lock);
+        ok = ok && warm_switch.waitSwitched(TimeValue::fromMSec(2000), &switched) &&
+            switched;
+        usleep(dwell_usec);
+        ok = ok && warm_switch.getStats(&stats);
+        warm_switch.shutdown();
+        pthread_mutex_lock(&preview.lock);
+        ok = ok && !preview.entries.empty();
+        for (size_t i = 0; i < preview.entries.size(); i++)
+            ok = ok && preview.entries[i].source == 0;
+        pthread_mutex_unlock(&preview.lock);
+        ok = ok && stats.switches == 1 && stats.failed == 1 &&
+            good.prepares == 2 && good.releases == 2 && bad.prepares == 1 && bad.releases == 1;
+        add_result(table, "failure", stats, ok);
+    }
+
+    /* A device failing to open at the start of the warm mode */
+    {
+        WarmSwitch::Stats stats;
+        WarmSwitch warm_switch;
+        vector<sim_device *> devices;
+        bool ok;
+
+        for (uint32_t i = 0; i < device_count; i++)
+            devices.push_back(new sim_device(i, &preview, fps, 0, 0, i == device_count - 1));
+        vector<IWarmSource *> sources(devices.begin(), devices.end());
+
+        preview.warm_switch = &warm_switch;
+        cout << "Expecting an error:" << endl;
+        ok = !warm_switch.initialize(sources, 0, true);
+        for (uint32_t i = 0; i < device_count; i++)
+        {
+            ok = ok && devices[i]->prepares == 1 && devices[i]->releases == 1 &&
+                !devices[i]->routed();
+            delete devices[i];
+        }
+        add_result(table, "start", stats, ok);
+    }
+
+    pthread_mutex_destroy(&preview.lock);
+
+    cout << "Sensor at " << fps << " fps, " << device_count << " devices, open " <<
+        open_usec / 1000 << " ms, first frame " << start_usec / 1000 << " ms" << endl;
+    /* The warm switch only waits for the next frame of a running device */
+    cout << "Warm switch to first frame " << fixed << setprecision(2) << warm_to_frame / 1e6 <<
+        " ms, cold " << cold_to_frame / 1e6 << " ms" << endl;
+    table.row("faster", warm_to_frame < cold_to_frame);
+
+    return table.print() ? 0 : -1;
+}
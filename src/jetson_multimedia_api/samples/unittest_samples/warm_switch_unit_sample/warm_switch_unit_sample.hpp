@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "WarmSwitch.h"
+#include "unit_sample.hpp"
+
+/**
+ * An entry of the simulated preview.
+ */
+typedef struct
+{
+    /** Source of the frame, or the target of the switch for a marker. */
+    uint32_t source;
+    /** Sensor timestamp of the frame. */
+    uint64_t timestamp;
+    /** True if the entry marks a completed switch rather than a shown frame. */
+    bool marker;
+} preview_entry;
+
+/**
+ * Holds the frames shown by the simulated preview.
+ */
+typedef struct
+{
+    /** The switch deciding which frames are shown. */
+    ArgusSamples::WarmSwitch *warm_switch;
+    /** Protects the members below, held while a frame is reported. */
+    pthread_mutex_t lock;
+    /** Shown frames and completed switches, in order. */
+    std::vector<preview_entry> entries;
+} sim_preview;
+
+/**
+ * Simulated camera device. Opening a session takes some time, the
+ * sensor then delivers timestamped frames on its own thread and reports
+ * them to the preview.
+ */
+class sim_device : public ArgusSamples::IWarmSource
+{
+public:
+    sim_device(uint32_t index, sim_preview *preview, uint32_t fps, uint32_t open_usec,
+               uint32_t start_usec, bool fail);
+    virtual ~sim_device();
+
+    virtual bool prepare();
+    virtual bool setPreview(bool active);
+    virtual bool release();
+
+    /** True if the device is routed to the preview. */
+    bool routed() const;
+
+    /** Calls of prepare(). */
+    uint32_t prepares;
+    /** Calls of release(). */
+    uint32_t releases;
+
+private:
+    uint32_t index;
+    sim_preview *preview;
+    uint64_t frame_duration;
+    uint32_t delivery_usec;
+    uint32_t open_usec;
+    uint32_t start_usec;
+    bool fail;
+    bool running;
+    bool stop;
+    bool active;
+    pthread_t thread;
+
+    static void *sensor_thread(void *arg);
+};
+
+/**
+ * @brief Checks that no frame of an earlier source is shown after a switch.
+ *
+ * Frames following the marker of a switch have to be from its target, or
+ * from the target of the next switch which may already have started.
+ *
+ * @param[in] preview Preview holding the shown frames
+ * @param[in] first Source shown before the first switch
+ * @return true if the order of the frames is correct
+ */
+static bool check_preview(sim_preview &preview, uint32_t first);
+
+/**
+ * @brief Switches the preview through the devices.
+ *
+ * Shows the first device, switches to the next device for each switch and
+ * waits for the first frame of the new device and a few more frames.
+ *
+ * @param[in] devices Simulated devices
+ * @param[in] preview Simulated preview
+ * @param[in] warm True to keep all devices capturing
+ * @param[in] switches Number of switches
+ * @param[in] dwell_usec Time to show each device, in microseconds
+ * @param[out] stats Statistics of the switches
+ * @return true if all switches completed and the preview is correct
+ */
+static bool run_switches(std::vector<sim_device *> &devices, sim_preview &preview, bool warm,
+                         uint32_t switches, uint32_t dwell_usec,
+                         ArgusSamples::WarmSwitch::Stats &stats);
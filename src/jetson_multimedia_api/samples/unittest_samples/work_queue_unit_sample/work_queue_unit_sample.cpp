@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./work_queue_sample [-i <stream.264>] [-w <workers>] [-t <work_usec>]
+ * Example:
+ * ./work_queue_sample
+ * ./work_queue_sample -i ../../../data/Video/sample_outdoor_car_1080p_10fps.h264 -w 4
+**/
+
+#include <fstream>
+#include <iostream>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "work_queue_unit_sample.hpp"
+
+/**
+ * Ordered asynchronous output with NvOrderedWorkQueue.
+ *
+ * The encoder samples write, checksum and report each access unit in the
+ * capture plane DQ callback, and the capture buffer is only queued back
+ * once that is done. When the post-processing takes longer than a frame,
+ * the encoder runs out of capture buffers and stalls.
+ *
+ * This sample replays recorded (Annex-B stream) or synthetic access units
+ * through a mocked capture plane and compares:
+ * ## Synchronous output on the DQ thread
+ * ## Output on NvOrderedWorkQueue workers, the DQ thread only copies
+ *
+ * For each mode it reports the throughput, the time the producer stalled on
+ * a full capture plane and the minimum number of buffers left queued, and
+ * checks that the output equals the input in order and byte for byte.
+**/
+
+#define DEFAULT_UNITS 300
+#define DEFAULT_BUFFERS 6
+#define DEFAULT_WORKERS 4
+#define DEFAULT_PERIOD_USEC 1000
+#define DEFAULT_WORK_USEC 2500
+#define OUTPUT_QUEUE_CAPACITY 32
+
+typedef struct
+{
+    const vector<string> *units;
+    uint32_t num_buffers;
+    uint32_t period_usec;
+    uint32_t work_usec;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    vector<uint32_t> free_slots;    /* Buffers queued to the mocked encoder */
+    vector<uint32_t> filled_slots;  /* Buffers ready to be dequeued */
+    vector<uint32_t> slot_unit;     /* Access unit held by each buffer */
+    bool producer_done;
+
+    uint64_t stall_usec;
+    uint32_t min_queued;
+
+    uint32_t crc;
+    string output;
+} replay_context;
+
+typedef struct
+{
+    string data;
+} output_job;
+
+static uint64_t
+get_time_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t
+update_crc(uint32_t crc, const string &data)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        crc ^= (uint8_t) data[i];
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static int
+load_annexb_units(const char *path, vector<string> &units)
+{
+    ifstream file(path, ios::binary);
+    string stream;
+    size_t start = 0;
+
+    if (!file.is_open())
+    {
+        cerr << "Could not open " << path << endl;
+        return -1;
+    }
+    stream.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+    for (size_t i = 1; i + 3 <= stream.size(); i++)
+    {
+        if (stream[i] == 0 && stream[i + 1] == 0 && stream[i + 2] == 1)
+        {
+            /* Keep the leading zero of a 4 byte start code with the next unit */
+            size_t end = (stream[i - 1] == 0) ? i - 1 : i;
+            if (end > start)
+            {
+                units.push_back(stream.substr(start, end - start));
+                start = end;
+            }
+            i += 2;
+        }
+    }
+    if (start < stream.size())
+        units.push_back(stream.substr(start));
+
+    return units.empty() ? -1 : 0;
+}
+
+static void
+generate_units(uint32_t count, vector<string> &units)
+{
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        /* Key frames every 30 units are larger */
+        size_t size = (i % 30 == 0) ? 60000 : 4000 + (rand_r(&seed) % 12000);
+        string unit(size, 0);
+
+        unit[2] = 1;
+        for (size_t j = 3; j < size; j++)
+            unit[j] = (char) rand_r(&seed);
+        units.push_back(unit);
+    }
+}
+
+/* Simulates the time spent formatting and analysing one access unit. */
+static void
+post_process(const replay_context *ctx)
+{
+    usleep(ctx->work_usec);
+}
+
+static void
+process_output_job(void *job, void *arg)
+{
+    post_process((replay_context *) arg);
+}
+
+static void
+commit_output_job(void *job, void *arg)
+{
+    replay_context *ctx = (replay_context *) arg;
+    output_job *out = (output_job *) job;
+
+    ctx->crc = update_crc(ctx->crc, out->data);
+    ctx->output += out->data;
+    delete out;
+}
+
+static void *
+producer_thread(void *arg)
+{
+    replay_context *ctx = (replay_context *) arg;
+    uint64_t next = get_time_usec();
+
+    for (uint32_t i = 0; i < ctx->units->size(); i++)
+    {
+        uint64_t now = get_time_usec();
+        uint64_t wait_start;
+        uint32_t slot;
+
+        if (next > now)
+            usleep(next - now);
+        next += ctx->period_usec;
+
+        pthread_mutex_lock(&ctx->lock);
+        wait_start = get_time_usec();
+        while (ctx->free_slots.empty())
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+        ctx->stall_usec += get_time_usec() - wait_start;
+
+        slot = ctx->free_slots.front();
+        ctx->free_slots.erase(ctx->free_slots.begin());
+        ctx->slot_unit[slot] = i;
+        ctx->filled_slots.push_back(slot);
+        pthread_cond_broadcast(&ctx->cond);
+        pthread_mutex_unlock(&ctx->lock);
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    ctx->producer_done = true;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+}
+
+static int
+run_replay(const vector<string> &units, uint32_t num_buffers,
+           uint32_t num_workers, uint32_t period_usec, uint32_t work_usec,
+           replay_result &result)
+{
+    replay_context ctx;
+    NvOrderedWorkQueue *queue = NULL;
+    string expected;
+    pthread_t producer;
+    uint64_t start_usec;
+
+    ctx.units = &units;
+    ctx.num_buffers = num_buffers;
+    ctx.period_usec = period_usec;
+    ctx.work_usec = work_usec;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cond, NULL);
+    for (uint32_t i = 0; i < num_buffers; i++)
+        ctx.free_slots.push_back(i);
+    ctx.slot_unit.resize(num_buffers);
+    ctx.producer_done = false;
+    ctx.stall_usec = 0;
+    ctx.min_queued = num_buffers;
+    ctx.crc = 0;
+
+    if (num_workers)
+    {
+        queue = new NvOrderedWorkQueue("ReplayOut", num_workers, OUTPUT_QUEUE_CAPACITY,
+                                       process_output_job, commit_output_job, &ctx);
+        if (queue->start() < 0)
+        {
+            delete queue;
+            return -1;
+        }
+    }
+
+    start_usec = get_time_usec();
+    if (pthread_create(&producer, NULL, producer_thread, &ctx) != 0)
+    {
+        delete queue;
+        return -1;
+    }
+
+    /* The calling thread plays the capture plane DQ thread */
+    while (true)
+    {
+        uint32_t slot;
+
+        pthread_mutex_lock(&ctx.lock);
+        while (ctx.filled_slots.empty() && !ctx.producer_done)
+            pthread_cond_wait(&ctx.cond, &ctx.lock);
+        if (ctx.filled_slots.empty())
+        {
+            pthread_mutex_unlock(&ctx.lock);
+            break;
+        }
+        slot = ctx.filled_slots.front();
+        ctx.filled_slots.erase(ctx.filled_slots.begin());
+        pthread_mutex_unlock(&ctx.lock);
+
+        const string &unit = units[ctx.slot_unit[slot]];
+        if (queue)
+        {
+            output_job *job = new output_job;
+            job->data = unit;
+            queue->push(job);
+        }
+        else
+        {
+            output_job *job = new output_job;
+            job->data = unit;
+            post_process(&ctx);
+            commit_output_job(job, &ctx);
+        }
+
+        /* Queue the buffer back */
+        pthread_mutex_lock(&ctx.lock);
+        ctx.free_slots.push_back(slot);
+        if (ctx.free_slots.size() < ctx.min_queued)
+            ctx.min_queued = ctx.free_slots.size();
+        pthread_cond_broadcast(&ctx.cond);
+        pthread_mutex_unlock(&ctx.lock);
+    }
+    pthread_join(producer, NULL);
+
+    if (queue)
+    {
+        queue->stop();
+        queue->printStats(cout);
+        delete queue;
+    }
+
+    result.seconds = (get_time_usec() - start_usec) / 1000000.0;
+    result.fps = units.size() / result.seconds;
+    result.stall_usec = ctx.stall_usec;
+    result.min_queued = ctx.min_queued;
+
+    for (size_t i = 0; i < units.size(); i++)
+        expected += units[i];
+    result.output_ok = (ctx.output == expected) &&
+        (ctx.crc == update_crc(0, expected)) &&
+        (ctx.free_slots.size() == num_buffers);
+
+    pthread_cond_destroy(&ctx.cond);
+    pthread_mutex_destroy(&ctx.lock);
+    return 0;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    const char *in_path = NULL;
+    uint32_t num_buffers = DEFAULT_BUFFERS;
+    uint32_t num_workers = DEFAULT_WORKERS;
+    uint32_t period_usec = DEFAULT_PERIOD_USEC;
+    uint32_t work_usec = DEFAULT_WORK_USEC;
+    vector<string> units;
+    UnitSampleTable table(12);
+    UnitSampleArgs args("./work_queue_sample");
+    int opt;
+
+    args.option('i', "<stream>", "Annex-B elementary stream to replay", "synthetic")
+        .option('b', "<buffers>", "Capture plane buffers", DEFAULT_BUFFERS)
+        .option('w', "<workers>", "Output workers", DEFAULT_WORKERS)
+        .option('p', "<usec>", "Frame period", DEFAULT_PERIOD_USEC)
+        .option('t', "<usec>", "Post-processing time per frame", DEFAULT_WORK_USEC);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                in_path = optarg;
+                break;
+            case 'b':
+                num_buffers = atoi(optarg);
+                break;
+            case 'w':
+                num_workers = atoi(optarg);
+                break;
+            case 'p':
+                period_usec = atoi(optarg);
+                break;
+            case 't':
+                work_usec = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (num_buffers == 0 || num_workers == 0)
+    {
+        cerr << "Buffers and workers should be positive integers" << endl;
+        return -1;
+    }
+
+    if (in_path)
+    {
+        if (load_annexb_units(in_path, units) < 0)
+            return -1;
+    }
+    else
+    {
+        generate_units(DEFAULT_UNITS, units);
+    }
+
+    cout << "Replaying " << units.size() << " access units, " << num_buffers <<
+        " capture buffers, " << period_usec << " us period, " << work_usec <<
+        " us post-processing" << endl;
+
+    const char *names[] = { "sync", "async" };
+    const uint32_t workers[] = { 0, num_workers };
+    replay_result results[2];
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        if (run_replay(units, num_buffers, workers[i], period_usec, work_usec,
+                       results[i]) < 0)
+        {
+            cerr << "Replay failed" << endl;
+            return -1;
+        }
+    }
+
+    table.column("fps", 10, 1).column("stall ms", 14, 1).column("min queued", 12);
+    for (uint32_t i = 0; i < 2; i++)
+        table.row(names[i], results[i].output_ok) << results[i].fps <<
+            results[i].stall_usec / 1000.0 << results[i].min_queued;
+
+    return table.print() ? 0 : -1;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NvOrderedWorkQueue.h"
+#include "unit_sample.hpp"
+
+/**
+ * Holds the result of one replay of the mocked capture plane.
+ */
+typedef struct
+{
+    /** Wall time of the replay in seconds. */
+    double seconds;
+    /** Access units per second handled by the DQ thread. */
+    double fps;
+    /** Time the producer waited for a free capture buffer, in microseconds. */
+    uint64_t stall_usec;
+    /** Minimum number of capture buffers queued after a requeue. */
+    uint32_t min_queued;
+    /** True if the output matches the input byte for byte. */
+    bool output_ok;
+} replay_result;
+
+/**
+ * @brief Splits an Annex-B elementary stream into access units.
+ *
+ * The stream is split before each 3 or 4 byte start code.
+ *
+ * @param[in] path Path of the elementary stream
+ * @param[out] units Access units of the stream
+ * @return 0 for success, -1 otherwise
+ */
+static int
+load_annexb_units(const char *path, std::vector<std::string> &units);
+
+/**
+ * @brief Generates pseudo-random access units.
+ *
+ * @param[in] count Number of access units
+ * @param[out] units Access units
+ */
+static void
+generate_units(uint32_t count, std::vector<std::string> &units);
+
+/**
+ * @brief Replays access units through a mocked encoder capture plane.
+ *
+ * A producer thread fills @a num_buffers capture buffers at the frame
+ * period, and a DQ thread dequeues them. With @a num_workers set to 0 the DQ
+ * thread post-processes each buffer before it is queued back; otherwise it
+ * copies the buffer, pushes it to an NvOrderedWorkQueue and queues it back
+ * at once.
+ *
+ * @param[in] units Access units to replay
+ * @param[in] num_buffers Number of capture buffers
+ * @param[in] num_workers Number of output workers, 0 for synchronous output
+ * @param[in] period_usec Frame period of the producer in microseconds
+ * @param[in] work_usec Post-processing time per access unit in microseconds
+ * @param[out] result Result of the replay
+ * @return 0 for success, -1 otherwise
+ */
+static int
+run_replay(const std::vector<std::string> &units, uint32_t num_buffers,
+           uint32_t num_workers, uint32_t period_usec, uint32_t work_usec,
+           replay_result &result);
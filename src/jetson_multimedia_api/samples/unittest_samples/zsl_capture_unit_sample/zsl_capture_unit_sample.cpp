@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Execution command
+ * ./zsl_capture_sample [-f <fps>] [-e <encode ms>] [-n <shots>] [-r <frames>]
+ * Example:
+ * ./zsl_capture_sample
+ * ./zsl_capture_sample -f 60 -e 80 -n 20
+**/
+
+#include <iostream>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+#include "zsl_capture_unit_sample.hpp"
+
+/**
+ * Zero shutter lag still capture.
+ *
+ * ZslCapture holds the most recent frames of a persistent stream, picks
+ * the frame closest to a shutter press and writes it on a writer thread.
+ * A simulated sensor delivers timestamped frames to it, and this sample
+ * checks:
+ * ## The frame closest to the shutter press is picked, the earlier one on
+ *    a tie, and the oldest frames leave a full ring
+ * ## Frame timestamps in another time base than the shutter press, like
+ *    sensor timestamps, are placed at the time the frames arrived
+ * ## A press newer than the last frame waits for the next frame
+ * ## A press without frames fails after the maximum wait
+ * ## Presses taken at a running sensor pick the closest frame and return
+ *    before the image is written, the files are written in order
+ * ## Back to back presses pick distinct frames and every file is written
+ * ## Failed writes are counted, and no frame is leaked
+ *
+ * It then compares the shutter to frame and shutter to file latency with
+ * an emulated per shot capture, which sets up a stream, waits for the next
+ * frame and encodes on the calling thread.
+**/
+
+using namespace ArgusSamples;
+
+#define DEFAULT_FPS 30
+#define DEFAULT_ENCODE_MS 40
+#define DEFAULT_SHOTS 10
+#define DEFAULT_RING 4
+#define SETUP_USEC 60000
+#define MSEC 1000000ull
+/* The sensor clock of the simulated sensor runs an hour ahead of CLOCK_MONOTONIC */
+#define SENSOR_CLOCK_OFFSET (3600000 * MSEC)
+/* Scheduling delay allowed between a frame delivery and the push */
+#define ARRIVAL_TOLERANCE (2 * MSEC)
+
+uint32_t sim_frame::alive = 0;
+
+sim_frame::sim_frame(uint64_t timestamp, uint32_t encode_usec, bool fail)
+    : timestamp(timestamp)
+    , encode_usec(encode_usec)
+    , fail(fail)
+{
+    __atomic_add_fetch(&alive, 1, __ATOMIC_RELAXED);
+}
+
+sim_frame::~sim_frame()
+{
+    __atomic_sub_fetch(&alive, 1, __ATOMIC_RELAXED);
+}
+
+uint64_t
+sim_frame::getTimestamp() const
+{
+    return timestamp;
+}
+
+bool
+sim_frame::write(const char *fileName, StillFileType fileType)
+{
+    FILE *file;
+
+    usleep(encode_usec);
+    if (fail)
+        return false;
+
+    file = fopen(fileName, "w");
+    if (!file)
+        return false;
+    fprintf(file, "%llu\n", (unsigned long long) timestamp);
+    fclose(file);
+    return true;
+}
+
+static void *
+sensor_thread(void *arg)
+{
+    sim_sensor *sensor = (sim_sensor *) arg;
+    uint64_t next = ZslCapture::getTime() + sensor->frame_duration;
+
+    for (;;)
+    {
+        uint64_t now = ZslCapture::getTime();
+        uint64_t timestamp;
+        bool stop;
+
+        /* The frame is delivered some time after its readout started */
+        if (now < next)
+            usleep((next - now) / 1000);
+        timestamp = next - sensor->delivery_usec * 1000ull + sensor->clock_offset;
+        next += sensor->frame_duration;
+
+        pthread_mutex_lock(&sensor->lock);
+        stop = sensor->stop;
+        if (!stop)
+            sensor->timestamps.push_back(timestamp);
+        pthread_mutex_unlock(&sensor->lock);
+
+        if (stop ||
+            !sensor->zsl->pushFrame(new sim_frame(timestamp, sensor->encode_usec, false)))
+            break;
+    }
+    return NULL;
+}
+
+static bool
+start_sensor(sim_sensor &sensor, ZslCapture *zsl, uint32_t fps, uint32_t encode_usec)
+{
+    sensor.zsl = zsl;
+    sensor.frame_duration = 1000000000ull / fps;
+    sensor.delivery_usec = sensor.frame_duration / 2000;
+    sensor.encode_usec = encode_usec;
+    sensor.clock_offset = SENSOR_CLOCK_OFFSET;
+    sensor.stop = false;
+    sensor.timestamps.clear();
+    pthread_mutex_init(&sensor.lock, NULL);
+    return pthread_create(&sensor.thread, NULL, sensor_thread, &sensor) == 0;
+}
+
+static void
+stop_sensor(sim_sensor &sensor)
+{
+    pthread_mutex_lock(&sensor.lock);
+    sensor.stop = true;
+    pthread_mutex_unlock(&sensor.lock);
+    pthread_join(sensor.thread, NULL);
+    pthread_mutex_destroy(&sensor.lock);
+}
+
+static uint64_t
+delivery_offset(sim_sensor &sensor, uint64_t timestamp, uint64_t time, uint64_t *delivery)
+{
+    uint64_t closest_offset = UINT64_MAX;
+
+    pthread_mutex_lock(&sensor.lock);
+    for (size_t i = 0; i < sensor.timestamps.size(); i++)
+    {
+        uint64_t frame_delivery = sensor.timestamps[i] - sensor.clock_offset +
+            sensor.delivery_usec * 1000ull;
+        uint64_t offset = frame_delivery > time ? frame_delivery - time : time - frame_delivery;
+
+        if ((timestamp == 0 || sensor.timestamps[i] == timestamp) && offset < closest_offset)
+        {
+            closest_offset = offset;
+            if (delivery)
+                *delivery = frame_delivery;
+        }
+    }
+    pthread_mutex_unlock(&sensor.lock);
+    return closest_offset;
+}
+
+static bool
+per_shot_capture(sim_sensor &sensor, uint32_t setup_usec, const char *file_name,
+                 ZslCapture::Stats &stats)
+{
+    uint64_t shutter_time = ZslCapture::getTime();
+    uint64_t frame_time = 0;
+    bool written;
+
+    stats.shots++;
+
+    /* Create the stream and consumer, then issue the capture */
+    usleep(setup_usec);
+    uint64_t capture_time = ZslCapture::getTime();
+    while (!frame_time)
+    {
+        pthread_mutex_lock(&sensor.lock);
+        if (!sensor.timestamps.empty() &&
+            sensor.timestamps.back() - sensor.clock_offset >= capture_time)
+            frame_time = sensor.timestamps.back() - sensor.clock_offset;
+        pthread_mutex_unlock(&sensor.lock);
+        if (!frame_time)
+            usleep(500);
+    }
+    stats.shutterToFrame.add(ZslCapture::getTime() - shutter_time);
+    stats.frameOffset.add(frame_time - shutter_time);
+
+    sim_frame frame(frame_time, sensor.encode_usec, false);
+    written = frame.write(file_name, STILL_FILE_TYPE_JPG);
+    if (written)
+    {
+        stats.written++;
+        stats.shutterToFile.add(ZslCapture::getTime() - shutter_time);
+    }
+    else
+    {
+        stats.failed++;
+    }
+    return written;
+}
+
+/* Reads back the timestamp written by sim_frame::write */
+static uint64_t
+read_file(const char *file_name)
+{
+    unsigned long long timestamp = 0;
+    FILE *file = fopen(file_name, "r");
+
+    if (!file)
+        return 0;
+    if (fscanf(file, "%llu", &timestamp) != 1)
+        timestamp = 0;
+    fclose(file);
+    return timestamp;
+}
+
+static const char *
+file_name(char *buf, size_t size, uint32_t index)
+{
+    snprintf(buf, size, "zsl_capture_sample_%04u.txt", index);
+    return buf;
+}
+
+static void
+add_result(UnitSampleTable &table, const char *name, const ZslCapture::Stats &stats, bool ok)
+{
+    table.row(name, ok) << stats.shots << stats.written << stats.failed <<
+        stats.shutterToFrame.average() / 1e6 << stats.shutterToFile.average() / 1e6 <<
+        stats.frameOffset.average() / 1e6;
+}
+
+int
+main(int argc, char const *argv[])
+{
+    uint32_t fps = DEFAULT_FPS;
+    uint32_t encode_usec = DEFAULT_ENCODE_MS * 1000;
+    uint32_t shots = DEFAULT_SHOTS;
+    uint32_t ring = DEFAULT_RING;
+    UnitSampleTable table(10);
+    UnitSampleArgs args("./zsl_capture_sample");
+    char name[64];
+    int opt;
+
+    args.option('f', "<fps>", "Sensor frame rate", DEFAULT_FPS)
+        .option('e', "<ms>", "Encode and write time per image", DEFAULT_ENCODE_MS)
+        .option('n', "<shots>", "Shots of the timed tests", DEFAULT_SHOTS)
+        .option('r', "<frames>", "Frames held by the ring", DEFAULT_RING);
+
+    while ((opt = args.next(argc, argv)) != -1)
+    {
+        switch (opt)
+        {
+            case 'f':
+                fps = atoi(optarg);
+                break;
+            case 'e':
+                encode_usec = atoi(optarg) * 1000;
+                break;
+            case 'n':
+                shots = atoi(optarg);
+                break;
+            case 'r':
+                ring = atoi(optarg);
+                break;
+            default:
+                return args.exitHelp(opt);
+        }
+    }
+    if (fps == 0 || shots == 0 || ring == 0)
+    {
+        args.printHelp();
+        return -1;
+    }
+
+    table.column("shots", 7).column("written", 9).column("failed", 8)
+        .column("frame ms", 12, 2).column("file ms", 12, 2).column("offset ms", 12, 2);
+
+    const uint64_t frame_duration = 1000000000ull / fps;
+    const TimeValue max_wait = TimeValue::fromMSec(200);
+
+    /* Closest frame, ties and eviction, with frames pushed by hand */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        uint64_t frame_time = 0;
+        /* Timestamps of a clock started a second ago, the frames arrive at once */
+        const uint64_t sensor_base = 1000 * MSEC;
+        const uint64_t offsets[6] = { 0, 33, 66, 100, 133, 166 };
+        uint64_t base;
+
+        ok = zsl.initialize(4, max_wait);
+        for (uint32_t i = 0; i < 6 && ok; i++)
+            ok = zsl.pushFrame(new sim_frame(sensor_base + offsets[i] * MSEC, 0, false));
+        ok = ok && sim_frame::alive == 4;
+
+        /* The newest frame is placed at its arrival */
+        base = ZslCapture::getTime() - 166 * MSEC;
+
+        /* 0 and 33 were evicted, 66 is the oldest frame held */
+        ok = ok &&
+            zsl.shutter(base + 10 * MSEC, file_name(name, sizeof(name), 0),
+                        STILL_FILE_TYPE_JPG, &frame_time) &&
+            frame_time <= base + 66 * MSEC && frame_time + ARRIVAL_TOLERANCE > base + 66 * MSEC;
+        /* The frames keep their distances */
+        base = frame_time - 66 * MSEC;
+        ok = ok &&
+            zsl.shutter(base + 120 * MSEC, file_name(name, sizeof(name), 1),
+                        STILL_FILE_TYPE_JPG, &frame_time) &&
+            frame_time == base + 133 * MSEC;
+        /* 100 and 166 are 33 ms away from 133, the earlier one is picked */
+        ok = ok &&
+            zsl.shutter(base + 133 * MSEC, file_name(name, sizeof(name), 2),
+                        STILL_FILE_TYPE_JPG, &frame_time) &&
+            frame_time == base + 100 * MSEC;
+        ok = ok && zsl.waitIdle() && zsl.getStats(&stats);
+        ok = ok && stats.written == 3 && sim_frame::alive == 1 &&
+            read_file(file_name(name, sizeof(name), 2)) == sensor_base + 100 * MSEC;
+        zsl.shutdown();
+        ok = ok && sim_frame::alive == 0;
+        for (uint32_t i = 0; i < 3; i++)
+            unlink(file_name(name, sizeof(name), i));
+        add_result(table, "closest", stats, ok);
+    }
+
+    /* A press newer than the last frame waits for the next one */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        uint64_t frame_time = 0;
+        uint64_t shutter_time;
+        sim_sensor sensor;
+        bool started = false;
+
+        ok = zsl.initialize(ring, TimeValue::fromMSec(500));
+        ok = ok &&
+            zsl.pushFrame(new sim_frame(ZslCapture::getTime() + SENSOR_CLOCK_OFFSET, 0, false));
+        usleep(2 * frame_duration / 1000);
+        shutter_time = ZslCapture::getTime();
+        /* The sensor delivers its first frame one frame duration after the press */
+        started = ok && start_sensor(sensor, &zsl, fps, 0);
+        ok = started &&
+            zsl.shutter(shutter_time, file_name(name, sizeof(name), 0),
+                        STILL_FILE_TYPE_JPG, &frame_time) &&
+            frame_time >= shutter_time;
+        if (started)
+            stop_sensor(sensor);
+        ok = ok && zsl.getStats(&stats) &&
+            stats.shutterToFrame.max >= frame_duration / 2;
+        zsl.shutdown();
+        unlink(file_name(name, sizeof(name), 0));
+        add_result(table, "wait", stats, ok);
+    }
+
+    /* Without frames a press fails after the maximum wait */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        uint64_t start;
+
+        ok = zsl.initialize(ring, TimeValue::fromMSec(20));
+        start = ZslCapture::getTime();
+        cout << "Expecting an error:" << endl;
+        ok = ok &&
+            !zsl.shutter(start, file_name(name, sizeof(name), 0), STILL_FILE_TYPE_JPG);
+        ok = ok && ZslCapture::getTime() - start >= 20 * MSEC &&
+            zsl.getStats(&stats) && stats.failed == 1;
+        zsl.shutdown();
+        add_result(table, "timeout", stats, ok);
+    }
+
+    /* Presses at a running sensor */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        sim_sensor sensor;
+        vector<uint64_t> shutter_times;
+        vector<uint64_t> picked;
+
+        bool started = zsl.initialize(ring, max_wait) &&
+            start_sensor(sensor, &zsl, fps, encode_usec);
+
+        ok = started;
+        usleep(frame_duration * ring / 1000);
+        for (uint32_t i = 0; i < shots && ok; i++)
+        {
+            uint64_t shutter_time = ZslCapture::getTime();
+            uint64_t frame_time = 0;
+
+            ok = zsl.shutter(shutter_time, file_name(name, sizeof(name), i),
+                             STILL_FILE_TYPE_JPG, &frame_time);
+            /* The image is written after the press returned */
+            ok = ok &&
+                (encode_usec == 0 || access(file_name(name, sizeof(name), i), F_OK) != 0);
+            shutter_times.push_back(shutter_time);
+            picked.push_back(frame_time);
+            usleep(encode_usec + (rand() % 1000) * frame_duration / 1000000);
+        }
+        ok = ok && zsl.waitIdle() && zsl.getStats(&stats);
+        ok = ok && stats.written == shots &&
+            stats.shutterToFile.min >= (uint64_t) encode_usec * 1000;
+        for (uint32_t i = 0; i < picked.size(); i++)
+        {
+            uint64_t timestamp = read_file(file_name(name, sizeof(name), i));
+            uint64_t delivery = 0;
+
+            /* Shots are further apart than a frame, the closest frame is always free. The
+               frames are placed at their delivery, up to the scheduling delay. */
+            ok = ok &&
+                delivery_offset(sensor, timestamp, shutter_times[i], &delivery) <=
+                    delivery_offset(sensor, 0, shutter_times[i]) + ARRIVAL_TOLERANCE &&
+                picked[i] + ARRIVAL_TOLERANCE > delivery &&
+                picked[i] < delivery + ARRIVAL_TOLERANCE;
+            unlink(file_name(name, sizeof(name), i));
+        }
+        if (started)
+            stop_sensor(sensor);
+        zsl.shutdown();
+        ok = ok && sim_frame::alive == 0;
+        add_result(table, "zsl", stats, ok);
+    }
+
+    /* Back to back presses */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        sim_sensor sensor;
+        vector<uint64_t> picked;
+
+        bool started = zsl.initialize(ring, max_wait) &&
+            start_sensor(sensor, &zsl, fps, encode_usec);
+
+        ok = started;
+        usleep(frame_duration * ring / 1000);
+        for (uint32_t i = 0; i < shots && ok; i++)
+            ok = zsl.shutter(ZslCapture::getTime(), file_name(name, sizeof(name), i),
+                             STILL_FILE_TYPE_JPG);
+        if (started)
+            stop_sensor(sensor);
+        ok = ok && zsl.waitIdle() && zsl.getStats(&stats) &&
+            stats.written == shots;
+        zsl.shutdown();
+        for (uint32_t i = 0; i < shots; i++)
+        {
+            uint64_t timestamp = read_file(file_name(name, sizeof(name), i));
+
+            for (size_t j = 0; j < picked.size(); j++)
+                ok = ok && picked[j] != timestamp;
+            picked.push_back(timestamp);
+            unlink(file_name(name, sizeof(name), i));
+        }
+        ok = ok && sim_frame::alive == 0;
+        add_result(table, "burst", stats, ok);
+    }
+
+    /* Failed writes */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        uint64_t now = ZslCapture::getTime();
+
+        ok = zsl.initialize(ring, max_wait) &&
+            zsl.pushFrame(new sim_frame(now, 0, true)) &&
+            zsl.pushFrame(new sim_frame(now + 1, 0, false));
+        cout << "Expecting an error:" << endl;
+        ok = ok &&
+            zsl.shutter(now, file_name(name, sizeof(name), 0), STILL_FILE_TYPE_JPG) &&
+            zsl.shutter(now + 1, file_name(name, sizeof(name), 1), STILL_FILE_TYPE_JPG) &&
+            zsl.waitIdle() && zsl.getStats(&stats);
+        ok = ok && stats.failed == 1 && stats.written == 1 &&
+            sim_frame::alive == 0;
+        zsl.shutdown();
+        unlink(file_name(name, sizeof(name), 1));
+        add_result(table, "failure", stats, ok);
+    }
+
+    /* Per shot capture, for comparison */
+    {
+        ZslCapture::Stats stats;
+        bool ok = true;
+        ZslCapture zsl;
+        sim_sensor sensor;
+
+        bool started = zsl.initialize(1, max_wait) &&
+            start_sensor(sensor, &zsl, fps, encode_usec);
+
+        ok = started;
+        for (uint32_t i = 0; i < shots && ok; i++)
+        {
+            ok = per_shot_capture(sensor, SETUP_USEC, file_name(name, sizeof(name), i),
+                                  stats);
+            unlink(file_name(name, sizeof(name), i));
+        }
+        if (started)
+            stop_sensor(sensor);
+        zsl.shutdown();
+        add_result(table, "per shot", stats, ok);
+    }
+
+    cout << "Sensor at " << fps << " fps, " << encode_usec / 1000 << " ms encode, ring of " <<
+        ring << " frames" << endl;
+    return table.print() ? 0 : -1;
+}
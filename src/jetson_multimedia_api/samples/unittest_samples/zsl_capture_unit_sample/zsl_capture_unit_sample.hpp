@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ZslCapture.h"
+#include "unit_sample.hpp"
+
+/**
+ * Simulated frame, written as a small text file after the encode time.
+ */
+class sim_frame : public ArgusSamples::IZslFrame
+{
+public:
+    sim_frame(uint64_t timestamp, uint32_t encode_usec, bool fail);
+    virtual ~sim_frame();
+
+    virtual uint64_t getTimestamp() const;
+    virtual bool write(const char *fileName, ArgusSamples::StillFileType fileType);
+
+    /** Number of frames alive. */
+    static uint32_t alive;
+
+private:
+    uint64_t timestamp;
+    uint32_t encode_usec;
+    bool fail;
+};
+
+/**
+ * Holds the state of the simulated sensor.
+ */
+typedef struct
+{
+    /** Frame ring fed by the sensor. */
+    ArgusSamples::ZslCapture *zsl;
+    /** Sensor thread. */
+    pthread_t thread;
+    /** Frame duration, in nanoseconds. */
+    uint64_t frame_duration;
+    /** Time from the sensor timestamp until the frame is delivered, in microseconds. */
+    uint32_t delivery_usec;
+    /** Encode time of the frames, in microseconds. */
+    uint32_t encode_usec;
+    /** Sensor clock minus CLOCK_MONOTONIC, in nanoseconds. */
+    uint64_t clock_offset;
+    /** Protects stop and timestamps. */
+    pthread_mutex_t lock;
+    /** Set to stop the sensor thread. */
+    bool stop;
+    /** Sensor timestamps of all delivered frames. */
+    std::vector<uint64_t> timestamps;
+} sim_sensor;
+
+/**
+ * @brief Starts a sensor thread delivering frames to a frame ring.
+ *
+ * @param[out] sensor Sensor state
+ * @param[in] zsl Frame ring
+ * @param[in] fps Frame rate
+ * @param[in] encode_usec Encode time of the frames, in microseconds
+ * @return true if the thread was started
+ */
+static bool start_sensor(sim_sensor &sensor, ArgusSamples::ZslCapture *zsl, uint32_t fps,
+                         uint32_t encode_usec);
+
+/**
+ * @brief Stops the sensor thread.
+ *
+ * @param[in] sensor Sensor state
+ */
+static void stop_sensor(sim_sensor &sensor);
+
+/**
+ * @brief Gets the distance of a time from the nominal delivery time of a
+ *        frame, the readout start plus the delivery time.
+ *
+ * @param[in] sensor Sensor state
+ * @param[in] timestamp Sensor timestamp of the frame, 0 for the frame delivered closest to the time
+ * @param[in] time CLOCK_MONOTONIC time, in nanoseconds
+ * @param[out] delivery Optional, nominal delivery time of the frame
+ * @return Distance in nanoseconds, UINT64_MAX if there is no such frame
+ */
+static uint64_t delivery_offset(sim_sensor &sensor, uint64_t timestamp, uint64_t time,
+                                uint64_t *delivery = NULL);
+
+/**
+ * @brief Emulates a per shot capture: stream setup, the next frame and a blocking encode.
+ *
+ * @param[in] sensor Sensor state
+ * @param[in] setup_usec Stream and consumer setup time, in microseconds
+ * @param[in] file_name File name
+ * @param[inout] stats Statistics
+ * @return true if the image was written
+ */
+static bool per_shot_capture(sim_sensor &sensor, uint32_t setup_usec, const char *file_name,
+                             ArgusSamples::ZslCapture::Stats &stats);